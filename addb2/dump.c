@@ -45,6 +45,7 @@
 #include "lib/varr.h"
 #include "lib/getopts.h"
 #include "lib/uuid.h"                  /* m0_node_uuid_string_set */
+#include "lib/lockprof.h"              /* M0_LPK_MUTEX */
 
 #include "rpc/item.h"                  /* m0_rpc_item_type_lookup */
 #include "rpc/rpc_opcodes_xc.h"        /* m0_xc_M0_RPC_OPCODES_enum */
@@ -957,6 +958,20 @@ static void stob_io_req_state(struct m0_addb2__context *ctx,
 				    id, buf));
 }
 
+static void lock_kind(struct m0_addb2__context *ctx, const uint64_t *v,
+		      char *buf)
+{
+	static const char *name[] = {
+		[M0_LPK_MUTEX] = "mutex",
+		[M0_LPK_READ]  = "read",
+		[M0_LPK_WRITE] = "write",
+		[M0_LPK_NR]    = "other"
+	};
+
+	sprintf(buf, json_output ? "\"%s\"" : "%s",
+		v[0] < ARRAY_SIZE(name) ? name[v[0]] : "?");
+}
+
 static void attr(struct m0_addb2__context *ctx, const uint64_t *v, char *buf)
 {
 	/**
@@ -1077,6 +1092,10 @@ static void attr(struct m0_addb2__context *ctx, const uint64_t *v, char *buf)
 
 #define COUNTER  &counter, &skip, &skip, &skip, &skip, &skip, &skip
 #define FID &fid, &skip
+#define LOCK_PROF_HIST &dec, &dec, &dec, &dec, &dec, &dec,	\
+		       &dec, &dec, &dec, &dec, &dec, &dec
+#define LOCK_PROF_HIST_NAMES "<1us", "<4us", "<16us", "<64us", "<256us",	\
+		"<1ms", "<4ms", "<16ms", "<66ms", "<262ms", "<1s", ">=1s"
 #define TIMED &duration, &sym
 #define HIST &hist, &skip, &skip, &skip, &skip, &skip, &skip, &skip, &skip, \
 		&skip, &skip, &skip, &skip, &skip, &skip
@@ -1100,6 +1119,16 @@ struct m0_addb2__id_intrp ids[] = {
 	  .ii_spec   = &fom_state_counter },
 	{ M0_AVI_ALLOC,           "alloc",           { &dec, &ptr },
 	  { "size", "addr" } },
+	{ M0_AVI_LOCK_PROF,       "lock-prof",       { &sym, &lock_kind,
+						       &dec, &dec,
+						       &duration, &duration,
+						       &duration, &duration },
+	  { "site", "kind", "acquired", "contended",
+	    "wait", "wait_max", "hold", "hold_max" } },
+	{ M0_AVI_LOCK_PROF_WAIT,  "lock-prof-wait",  { &sym, LOCK_PROF_HIST },
+	  { "site", LOCK_PROF_HIST_NAMES } },
+	{ M0_AVI_LOCK_PROF_HOLD,  "lock-prof-hold",  { &sym, LOCK_PROF_HIST },
+	  { "site", LOCK_PROF_HIST_NAMES } },
 	{ M0_AVI_FOM_DESCR,       "fom-descr",       { FID, &hex0x, &rpcop,
 						       &rpcop, &bol, &dec,
 						       &dec, &dec },
@@ -1174,6 +1203,9 @@ struct m0_addb2__id_intrp ids[] = {
 	  .ii_spec   = &beop_state_counter },
 	{ M0_AVI_BE_TX_TO_GROUP,  "tx-to-gr", { &dec, &dec, &dec },
 	  { "tx_id", "gr_id", "inout" } },
+	{ M0_AVI_BE_GROUP_LOGGED, "gr-logged", { &dec, &dec, &dec, &dec,
+						 &duration, &duration },
+	  { "gr_id", "tx_nr", "tx_nr_max", "payload", "commit", "log" } },
 	{ M0_AVI_NET_BUF,         "net-buf",         { &ptr, &dec, &_clock,
 						       &duration, &dec, &dec },
 	  { "buf", "qtype", "time", "duration", "status", "len" } },
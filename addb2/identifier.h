@@ -103,6 +103,12 @@ enum m0_addb2_value_id {
 	M0_AVI_LIB_RANGE_START     = 0x3000,
 	/** Measurement: memory allocation. */
 	M0_AVI_ALLOC,
+	/** Lock profiler: call site statistics, see lib/lockprof.h. */
+	M0_AVI_LOCK_PROF,
+	/** Lock profiler: histogram of wait times at a call site. */
+	M0_AVI_LOCK_PROF_WAIT,
+	/** Lock profiler: histogram of hold times at a call site. */
+	M0_AVI_LOCK_PROF_HOLD,
 
 	M0_AVI_RM_RANGE_START      = 0x4000,
 	M0_AVI_M0T1FS_RANGE_START  = 0x5000,
@@ -38,6 +38,9 @@
 #include "lib/memory.h"
 #include "lib/byteorder.h" /* m0_byteorder_cpu_to_be64() */
 #include "lib/locality.h"  /* m0_locality0_get */
+#include "lib/finject.h"   /* M0_FI_ENABLED */
+#include "lib/thread_pool.h" /* m0_parallel_pool */
+#include "lib/atomic.h"
 #include "balloc.h"
 #include "motr/magic.h"
 
@@ -539,6 +542,178 @@ static int balloc_group_info_load(struct m0_balloc *bal)
 	return M0_RC(rc);
 }
 
+enum {
+	/** Threads loading group extents in background. */
+	BALLOC_PREFETCH_THREADS = 4,
+	/** Groups handed to the thread pool at once. */
+	BALLOC_PREFETCH_BATCH   = 256,
+};
+
+/**
+ * Background loading of group extents.
+ *
+ * Without it, extents of a group are loaded from the btree on the first
+ * allocation or free in the group, by the fom doing it, under the group lock.
+ * After a restart on a large device the first allocations stall on these
+ * loads.
+ *
+ * On mount, a thread hands all groups to a parallel pool which loads their
+ * extents. Groups are loaded in the order the allocator scans them: from the
+ * group of m0_balloc::cb_last on, wrapping around. A group is loaded under its
+ * lock, exactly as on demand, so whoever comes first loads it and the other
+ * finds it loaded. A group locked by somebody else is skipped: the lock
+ * holder is already working with its extents.
+ *
+ * The allocator skips locked groups too. While the prefetch is running, it
+ * scans the groups again with blocking locks before it returns -ENOSPC, see
+ * balloc_regular_allocator().
+ */
+struct balloc_prefetch_job {
+	struct balloc_prefetch      *pj_bp;
+	struct m0_balloc_group_info *pj_grp;
+};
+
+struct balloc_prefetch {
+	struct m0_balloc           *bp_bal;
+	struct m0_thread            bp_thread;
+	struct m0_parallel_pool     bp_pool;
+	/** A job per group, in the order of loading. */
+	struct balloc_prefetch_job *bp_jobs;
+	bool                        bp_stop;
+	/** All jobs are done or the prefetch is stopped. */
+	bool                        bp_done;
+	struct m0_atomic64          bp_loaded;
+	struct m0_atomic64          bp_skipped;
+};
+
+static int balloc_prefetch_job(void *arg)
+{
+	struct balloc_prefetch_job  *job = arg;
+	struct balloc_prefetch      *bp  = job->pj_bp;
+	struct m0_balloc_group_info *grp = job->pj_grp;
+	struct m0_balloc            *bal = bp->bp_bal;
+	int                          rc;
+
+	if (bp->bp_stop)
+		return 0;
+	if (m0_balloc_trylock_group(grp) != 0) {
+		m0_atomic64_inc(&bp->bp_skipped);
+		return 0;
+	}
+	/* UT: keep the group locked as a slow load would. */
+	if (M0_FI_ENABLED("slow_load"))
+		m0_nanosleep(m0_time(0, 100 * M0_TIME_ONE_MSEC), NULL);
+	if (!grp->bgi_extents_loaded) {
+		rc = m0_balloc_load_extents(bal, grp);
+		if (rc == 0)
+			m0_atomic64_inc(&bp->bp_loaded);
+		else
+			/* It will be retried on demand. */
+			M0_LOG(M0_WARN, "group=%"PRIu64" rc=%d",
+			       grp->bgi_groupno, rc);
+	}
+	m0_balloc_unlock_group(grp);
+	return 0;
+}
+
+static void balloc_prefetch_thread(struct balloc_prefetch *bp)
+{
+	struct m0_balloc *bal   = bp->bp_bal;
+	m0_bcount_t       nr    = bal->cb_sb.bsb_groupcount;
+	m0_time_t         start = m0_time_now();
+	m0_bcount_t       i;
+	int               rc;
+
+	for (i = 0; i < nr && !bp->bp_stop; ) {
+		for (rc = 0; i < nr && rc == 0; ) {
+			rc = m0_parallel_pool_job_add(&bp->bp_pool,
+						      &bp->bp_jobs[i]);
+			if (rc == 0)
+				++i;
+		}
+		M0_ASSERT(M0_IN(rc, (0, -EFBIG)));
+		m0_parallel_pool_start(&bp->bp_pool, &balloc_prefetch_job);
+		(void)m0_parallel_pool_wait(&bp->bp_pool);
+	}
+	bp->bp_done = true;
+	M0_LOG(M0_NOTICE, "balloc=%p groups=%"PRIu64" loaded=%"PRIi64
+	       " skipped=%"PRIi64" stopped=%d in %"PRIu64" ms", bal, nr,
+	       m0_atomic64_get(&bp->bp_loaded),
+	       m0_atomic64_get(&bp->bp_skipped), !!bp->bp_stop,
+	       m0_time_sub(m0_time_now(), start) / M0_TIME_ONE_MSEC);
+}
+
+/**
+ * Starts background loading of group extents. Failure to start it is not
+ * fatal: extents are loaded on demand anyway.
+ */
+static void balloc_prefetch_start(struct m0_balloc *bal)
+{
+	struct balloc_prefetch *bp;
+	m0_bcount_t             nr = bal->cb_sb.bsb_groupcount;
+	m0_bcount_t             first;
+	m0_bcount_t             i;
+	int                     rc;
+
+	M0_PRE(bal->cb_prefetch == NULL);
+
+	M0_ALLOC_PTR(bp);
+	if (bp == NULL)
+		return;
+	M0_ALLOC_ARR(bp->bp_jobs, nr);
+	if (bp->bp_jobs == NULL) {
+		m0_free(bp);
+		return;
+	}
+	first = balloc_bn2gn(bal->cb_last, bal);
+	for (i = 0; i < nr; ++i) {
+		bp->bp_jobs[i].pj_bp  = bp;
+		bp->bp_jobs[i].pj_grp = &bal->cb_group_info[(first + i) % nr];
+	}
+	bp->bp_bal = bal;
+	m0_atomic64_set(&bp->bp_loaded, 0);
+	m0_atomic64_set(&bp->bp_skipped, 0);
+	rc = m0_parallel_pool_init(&bp->bp_pool, BALLOC_PREFETCH_THREADS,
+				   BALLOC_PREFETCH_BATCH);
+	if (rc == 0) {
+		bal->cb_prefetch = bp;
+		rc = M0_THREAD_INIT(&bp->bp_thread, struct balloc_prefetch *,
+				    NULL, &balloc_prefetch_thread, bp,
+				    "balloc_prefetch");
+		if (rc != 0) {
+			bal->cb_prefetch = NULL;
+			m0_parallel_pool_terminate_wait(&bp->bp_pool);
+			m0_parallel_pool_fini(&bp->bp_pool);
+		}
+	}
+	if (rc != 0) {
+		M0_LOG(M0_WARN, "Cannot start prefetch: rc=%d", rc);
+		m0_free(bp->bp_jobs);
+		m0_free(bp);
+	}
+}
+
+static bool balloc_prefetch_is_running(const struct m0_balloc *bal)
+{
+	return bal->cb_prefetch != NULL && !bal->cb_prefetch->bp_done;
+}
+
+static void balloc_prefetch_stop(struct m0_balloc *bal)
+{
+	struct balloc_prefetch *bp = bal->cb_prefetch;
+
+	if (bp == NULL)
+		return;
+	bp->bp_stop = true;
+	m0_thread_join(&bp->bp_thread);
+	m0_thread_fini(&bp->bp_thread);
+	m0_parallel_pool_terminate_wait(&bp->bp_pool);
+	m0_parallel_pool_fini(&bp->bp_pool);
+	bal->cb_prefetch = NULL;
+	m0_free(bp->bp_jobs);
+	m0_free(bp);
+}
+
 /**
    finalization of the balloc environment.
  */
@@ -550,6 +725,8 @@ static void balloc_fini_internal(struct m0_balloc *bal)
 
 	M0_ENTRY();
 
+	balloc_prefetch_stop(bal);
+
 	if (bal->cb_group_info != NULL) {
 		for (i = 0 ; i < bal->cb_sb.bsb_groupcount; i++) {
 			gi = &bal->cb_group_info[i];
@@ -1056,6 +1233,7 @@ static int balloc_init_internal(struct m0_balloc *bal,
 
 	bal->cb_be_seg = seg;
 	bal->cb_group_info = NULL;
+	bal->cb_prefetch = NULL;
 	m0_mutex_init(&bal->cb_sb_mutex.bm_u.mutex);
 
 	M0_ALLOC_PTR(bal->cb_db_group_desc);
@@ -1112,6 +1290,8 @@ static int balloc_init_internal(struct m0_balloc *bal,
 			m0_free0(&bal->cb_group_info);
 	}
 	rc = rc ?: sb_mount(bal, grp);
+	if (rc == 0)
+		balloc_prefetch_start(bal);
 out:
 	if (rc != 0)
 		balloc_fini_internal(bal);
@@ -2518,6 +2698,10 @@ balloc_regular_allocator(struct balloc_allocation_context *bac)
 	m0_bcount_t len;
 	int         cr;
 	int         rc = 0;
+	/* Groups are locked without trylock. */
+	bool        wait = false;
+	/* A group was skipped while the prefetch was running. */
+	bool        busy = false;
 
 	ngroups = bac->bac_ctxt->cb_sb.bsb_groupcount;
 	len = m0_ext_length(&bac->bac_goal);
@@ -2569,10 +2753,16 @@ repeat:
 			// m0_balloc_debug_dump_group("searching group ...",
 			//			 grp);
 
-			rc = m0_balloc_trylock_group(grp);
+			if (wait) {
+				m0_balloc_lock_group(grp);
+				rc = 0;
+			} else
+				rc = m0_balloc_trylock_group(grp);
 			if (rc != 0) {
 				M0_LOG(M0_DEBUG, "grp=%d is busy", (int)group);
 				/* This group is under processing by others. */
+				if (balloc_prefetch_is_running(bac->bac_ctxt))
+					busy = true;
 				continue;
 			}
 
@@ -2643,6 +2833,17 @@ repeat:
 			goto repeat;
 		}
 	}
+	if (bac->bac_status != M0_BALLOC_AC_FOUND && busy && !wait) {
+		/*
+		 * Some groups were skipped while the prefetch was loading
+		 * them, so they might have the space. Wait for them.
+		 */
+		M0_LOG(M0_DEBUG, "Let's wait for busy groups");
+		bac->bac_status = M0_BALLOC_AC_CONTINUE;
+		cr = bac->bac_order2 ? 0 : 1;
+		wait = true;
+		goto repeat;
+	}
 out:
 	M0_LEAVE();
 	if (rc == 0 && bac->bac_status != M0_BALLOC_AC_FOUND) {
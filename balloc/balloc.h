@@ -43,6 +43,8 @@
    @{
 */
 
+struct balloc_prefetch;
+
 /**
    On-disk data structure for group, stored in db.
 
@@ -273,6 +275,8 @@ struct m0_balloc {
 	/** super block lock */
 	struct m0_be_mutex           cb_sb_mutex;
 	struct m0_be_seg            *cb_be_seg;
+	/** Background loading of group extents, NULL if it wasn't started. */
+	struct balloc_prefetch      *cb_prefetch;
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 enum m0_balloc_format_version {
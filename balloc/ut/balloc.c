@@ -33,6 +33,7 @@
 #include "lib/memory.h"
 #include "lib/thread.h"
 #include "lib/getopts.h"
+#include "lib/finject.h"  /* m0_fi_enable */
 #include "dtm/dtm.h"      /* m0_dtx */
 #include "motr/magic.h"
 #include "ut/ut.h"
@@ -300,6 +301,101 @@ void test_reserve_extent()
 	m0_be_ut_backend_fini(&ut_be);
 }
 
+enum {
+	/** Groups of the balloc mounted with prefetch. */
+	PREFETCH_GROUP_NR = 4,
+	/** How long the prefetch is waited for, in 10ms steps. */
+	PREFETCH_WAIT_NR  = 1000,
+};
+
+static bool prefetch_all_loaded(struct m0_balloc *bal)
+{
+	struct m0_balloc_group_info *grp;
+	m0_bcount_t                  i;
+	bool                         loaded = true;
+
+	for (i = 0; i < bal->cb_sb.bsb_groupcount && loaded; ++i) {
+		grp = m0_balloc_gn2info(bal, i);
+		m0_balloc_lock_group(grp);
+		loaded = grp->bgi_extents_loaded;
+		m0_balloc_unlock_group(grp);
+	}
+	return loaded;
+}
+
+/**
+ * Mounts a balloc with the background loading of group extents. Every group
+ * is kept locked by the prefetch for a while, so that an allocation right
+ * after the mount finds all of them busy. It must wait for them instead of
+ * failing with -ENOSPC. All groups end up loaded.
+ */
+void test_prefetch()
+{
+	struct m0_be_ut_backend  ut_be;
+	struct m0_be_ut_seg      ut_seg;
+	struct m0_sm_group      *grp;
+	struct m0_balloc        *bal;
+	struct m0_ad_balloc     *ballroom;
+	struct m0_dtx            dtx = {};
+	struct m0_be_tx         *tx  = &dtx.tx_betx;
+	struct m0_be_tx_credit   cred = {};
+	struct m0_ext            ext = {};
+	int                      i;
+	int                      rc;
+
+	M0_SET0(&ut_be);
+	m0_be_ut_backend_init(&ut_be);
+	m0_be_ut_seg_init(&ut_seg, &ut_be, 1ULL << 24);
+	grp = m0_be_ut_backend_sm_group_lookup(&ut_be);
+	rc = m0_balloc_create(0, ut_seg.bus_seg, grp, &bal,
+			      &M0_FID_INIT(0, 1));
+	M0_UT_ASSERT(rc == 0);
+	ballroom = &bal->cb_ballroom;
+	ballroom->ab_ops->bo_fini(ballroom);
+
+	/* Format, then mount. */
+	for (i = 0; i < 2; ++i) {
+		if (i == 1) {
+			ballroom->ab_ops->bo_fini(ballroom);
+			m0_fi_enable("balloc_prefetch_job", "slow_load");
+		}
+		rc = ballroom->ab_ops->bo_init(ballroom, ut_seg.bus_seg,
+				BALLOC_DEF_BLOCK_SHIFT,
+				PREFETCH_GROUP_NR * BALLOC_DEF_BLOCKS_PER_GROUP
+				<< BALLOC_DEF_BLOCK_SHIFT,
+				BALLOC_DEF_BLOCKS_PER_GROUP,
+				m0_stob_ad_spares_calc(
+					BALLOC_DEF_BLOCKS_PER_GROUP));
+		M0_UT_ASSERT(rc == 0);
+	}
+	M0_UT_ASSERT(bal->cb_sb.bsb_groupcount == PREFETCH_GROUP_NR);
+	M0_UT_ASSERT(bal->cb_prefetch != NULL);
+
+	ballroom->ab_ops->bo_alloc_credit(ballroom, 1, &cred);
+	m0_ut_be_tx_begin(tx, &ut_be, &cred);
+	rc = ballroom->ab_ops->bo_alloc(ballroom, &dtx, 100, &ext,
+					M0_BALLOC_NORMAL_ZONE);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_ext_length(&ext) > 0);
+	m0_ut_be_tx_end(tx);
+
+	for (i = 0; i < PREFETCH_WAIT_NR && !prefetch_all_loaded(bal); ++i)
+		m0_nanosleep(m0_time(0, 10 * M0_TIME_ONE_MSEC), NULL);
+	M0_UT_ASSERT(prefetch_all_loaded(bal));
+	m0_fi_disable("balloc_prefetch_job", "slow_load");
+
+	cred = M0_BE_TX_CREDIT(0, 0);
+	ballroom->ab_ops->bo_free_credit(ballroom, 1, &cred);
+	m0_ut_be_tx_begin(tx, &ut_be, &cred);
+	rc = ballroom->ab_ops->bo_free(ballroom, &dtx, &ext);
+	M0_UT_ASSERT(rc == 0);
+	m0_ut_be_tx_end(tx);
+
+	ballroom->ab_ops->bo_fini(ballroom);
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&ut_be);
+}
+
 static int test_balloc_ut_suite_init(void)
 {
 	m0_btree_glob_init();
@@ -319,6 +415,7 @@ struct m0_ut_suite balloc_ut = {
         .ts_tests = {
 		{ "balloc", test_balloc},
 		{ "reserve blocks for extmap", test_reserve_extent},
+		{ "prefetch", test_prefetch},
 		{ NULL, NULL }
         }
 };
@@ -29,6 +29,9 @@
 #include "lib/errno.h"          /* ENOMEM */
 #include "lib/misc.h"           /* m0_forall */
 #include "lib/time.h"           /* m0_time_now */
+#include "addb2/addb2.h"        /* M0_ADDB2_ADD */
+
+#include "be/addb2.h"           /* M0_AVI_BE_GROUP_LOGGED */
 
 #include "be/tx_service.h"      /* m0_be_tx_service_init */
 #include "be/tx_group.h"        /* m0_be_tx_group */
@@ -86,6 +89,22 @@ static void be_engine_tx_group_state_move(struct m0_be_engine       *en,
 		egr_tlist_length(&en->eng_groups[M0_BGS_FROZEN]) <= 1);
 }
 
+enum {
+	/** More ranges than threads to even out the merge time of ranges. */
+	BE_ENGINE_MERGE_PARTS_PER_THREAD = 2,
+};
+
+static bool be_engine_merge_is_parallel(const struct m0_be_engine *en)
+{
+	return en->eng_cfg->bec_group_merge_thread_nr > 1;
+}
+
+static int be_engine_merge_part_nr(const struct m0_be_engine *en)
+{
+	return en->eng_cfg->bec_group_merge_thread_nr *
+		BE_ENGINE_MERGE_PARTS_PER_THREAD;
+}
+
 static int be_engine_cfg_validate(struct m0_be_engine_cfg *en_cfg)
 {
 	M0_ASSERT_INFO(m0_be_tx_credit_le(&en_cfg->bec_tx_size_max,
@@ -131,6 +150,10 @@ M0_INTERNAL int m0_be_engine_init(struct m0_be_engine     *en,
 	rc = m0_be_tx_service_init(en, en_cfg->bec_reqh);
 	if (rc != 0)
 		goto err_free;
+	if (be_engine_merge_is_parallel(en))
+		rc = m0_parallel_pool_init(&en->eng_merge_pool,
+					   en_cfg->bec_group_merge_thread_nr,
+					   be_engine_merge_part_nr(en));
 	if (rc != 0)
 		goto err_service_fini;
 	for (i = 0; i < en->eng_group_nr; ++i) {
@@ -144,6 +167,10 @@ M0_INTERNAL int m0_be_engine_init(struct m0_be_engine     *en,
 		gr_cfg->tgc_log_discard = en_cfg->bec_log_discard;
 		gr_cfg->tgc_pd = en_cfg->bec_pd;
 		gr_cfg->tgc_reqh   = en_cfg->bec_reqh;
+		if (be_engine_merge_is_parallel(en)) {
+			gr_cfg->tgc_merge_pool    = &en->eng_merge_pool;
+			gr_cfg->tgc_merge_part_nr = be_engine_merge_part_nr(en);
+		}
 
 		rc = m0_be_tx_group_init(gr, gr_cfg);
 		M0_ASSERT(rc == 0);
@@ -194,6 +221,10 @@ M0_INTERNAL void m0_be_engine_fini(struct m0_be_engine *en)
 		m0_sm_timer_fini(&en->eng_group[i].tg_close_timer);
 		m0_be_tx_group_fini(&en->eng_group[i]);
 	}
+	if (be_engine_merge_is_parallel(en)) {
+		m0_parallel_pool_terminate_wait(&en->eng_merge_pool);
+		m0_parallel_pool_fini(&en->eng_merge_pool);
+	}
 	m0_be_tx_service_fini(en);
 	m0_forall(i, ARRAY_SIZE(en->eng_groups),
 		  (egr_tlist_fini(&en->eng_groups[i]), true));
@@ -398,6 +429,7 @@ static void be_engine_group_tryclose(struct m0_be_engine   *en,
 
 	if (gr->tg_nr_unclosed == 0 && gr->tg_state == M0_BGS_FROZEN) {
 		be_engine_tx_group_state_move(en, gr, M0_BGS_CLOSED);
+		gr->tg_close_time = m0_time_now();
 		m0_be_tx_group_close(gr);
 		gr->tg_close_timer_disarm.sa_cb = &be_engine_group_timer_disarm;
 		m0_sm_ast_post(m0_be_tx_group__sm_group(gr),
@@ -417,6 +449,80 @@ static void be_engine_group_tryclose(struct m0_be_engine   *en,
 	}
 }
 
+static bool be_engine_is_adaptive(const struct m0_be_engine *en)
+{
+	return en->eng_cfg->bec_group_commit_latency_target != 0;
+}
+
+/** Exponentially weighted moving average with 1/8 weight of the sample. */
+static m0_time_t be_engine_ewma(m0_time_t avg, m0_time_t sample)
+{
+	return avg == 0 ? sample : avg - avg / 8 + sample / 8;
+}
+
+static void be_engine_tx_arrived(struct m0_be_engine *en, struct m0_be_tx *tx)
+{
+	m0_time_t now;
+	m0_time_t gap;
+
+	M0_PRE(be_engine_is_locked(en));
+
+	if (!be_engine_is_adaptive(en) || m0_be_tx__is_recovering(tx))
+		return;
+	now = m0_time_now();
+	if (en->eng_tx_arrival_last != 0) {
+		/*
+		 * Idle periods longer than the target don't tell anything
+		 * about the next burst, don't let them dominate the average.
+		 */
+		gap = min64u(m0_time_sub(now, en->eng_tx_arrival_last),
+			     en->eng_cfg->bec_group_commit_latency_target);
+		en->eng_tx_interarrival = be_engine_ewma(
+					en->eng_tx_interarrival, gap);
+	}
+	en->eng_tx_arrival_last = now;
+}
+
+/**
+ * Adaptive group close policy.
+ *
+ * A tx waits for its group to be closed and then for the group to be
+ * logged. The time left from bec_group_commit_latency_target after the
+ * expected log write is spent on collecting txs which are expected to arrive
+ * at the recent rate. The group is frozen when the expected number of txs
+ * has joined it or when the time is up, whichever comes first. If no tx is
+ * expected to arrive in time, the group is closed after the minimal timeout
+ * instead of waiting for txs that will not come.
+ *
+ * @param gap         average interval between tx opens.
+ * @param log_latency average group log write latency.
+ * @param queued      number of txs waiting for a group, including the first
+ *                    tx of the group.
+ * @param tx_nr       the number of txs at which the group is frozen.
+ * @return delay before the group is frozen.
+ */
+M0_INTERNAL m0_time_t
+m0_be_engine__group_adapt(const struct m0_be_engine_cfg *cfg,
+			  m0_time_t                      gap,
+			  m0_time_t                      log_latency,
+			  uint64_t                       queued,
+			  uint64_t                      *tx_nr)
+{
+	uint64_t  nr_max = cfg->bec_group_cfg.tgc_tx_nr_max;
+	m0_time_t target = cfg->bec_group_commit_latency_target;
+	m0_time_t budget;
+	uint64_t  expected;
+
+	M0_PRE(queued > 0 && queued <= nr_max);
+
+	budget = target > log_latency ? target - log_latency : 0;
+	expected = gap == 0 ? nr_max : budget / gap;
+	expected = min64u(expected, nr_max - queued);
+	*tx_nr = queued + expected;
+	return max64u(gap == 0 ? budget : expected * gap,
+		      cfg->bec_group_freeze_timeout_min);
+}
+
 static void be_engine_group_timeout_arm(struct m0_be_engine   *en,
                                         struct m0_be_tx_group *gr)
 {
@@ -434,7 +540,15 @@ static void be_engine_group_timeout_arm(struct m0_be_engine   *en,
 	M0_ASSERT(grouping_q_length > 0);
 	tx_per_group_max = en->eng_cfg->bec_group_cfg.tgc_tx_nr_max;
 	grouping_q_length = min_check(grouping_q_length, tx_per_group_max);
-	delay = t_min + (t_max - t_min) * grouping_q_length / tx_per_group_max;
+	if (be_engine_is_adaptive(en))
+		delay = m0_be_engine__group_adapt(en->eng_cfg,
+						  en->eng_tx_interarrival,
+						  en->eng_group_log_latency,
+						  grouping_q_length,
+						  &gr->tg_tx_nr_target);
+	else
+		delay = t_min + (t_max - t_min) * grouping_q_length /
+			tx_per_group_max;
 	delay = min_check(delay, en->eng_cfg->bec_group_freeze_timeout_limit);
 	gr->tg_close_deadline = m0_time_now() + delay;
 	gr->tg_close_timer_arm.sa_cb = &be_engine_group_timer_arm;
@@ -477,6 +591,8 @@ static int be_engine_tx_trygroup(struct m0_be_engine *en,
 			if (rc == 0)
 				m0_be_tx__group_assign(tx, gr);
 		}
+		if (rc == 0 && m0_be_tx_group_tx_nr(gr) == 1)
+			gr->tg_open_time = m0_time_now();
 		if (rc == -EXFULL ||
 		    m0_be_tx__is_fast(tx) ||
 		    m0_be_tx__is_exclusive(tx)) {
@@ -484,6 +600,9 @@ static int be_engine_tx_trygroup(struct m0_be_engine *en,
 		} else if (rc == 0 && m0_be_tx_group_tx_nr(gr) == 1) {
 			be_engine_group_timeout_arm(en, gr);
 		}
+		if (rc == 0 && be_engine_is_adaptive(en) &&
+		    m0_be_tx_group_tx_nr(gr) >= gr->tg_tx_nr_target)
+			be_engine_group_freeze(en, gr);
 		if (M0_IN(rc, (-EBUSY, -EXFULL)))
 			be_engine_group_tryclose(en, gr);
 		if (M0_IN(rc, (0, -ENOSPC)))
@@ -657,6 +776,7 @@ M0_INTERNAL void m0_be_engine__tx_state_set(struct m0_be_engine *en,
 		M0_LOG(M0_DEBUG, "tx=%p t_id=%"PRIu64, tx, tx->t_id);
 		break;
 	case M0_BTS_OPENING:
+		be_engine_tx_arrived(en, tx);
 		be_engine_got_tx_open(en, tx);
 		break;
 	case M0_BTS_GROUPING:
@@ -751,6 +871,27 @@ M0_INTERNAL void m0_be_engine__tx_group_ready(struct m0_be_engine   *en,
 	M0_LEAVE();
 }
 
+M0_INTERNAL void m0_be_engine__tx_group_logged(struct m0_be_engine   *en,
+					       struct m0_be_tx_group *gr)
+{
+	m0_time_t now = m0_time_now();
+	m0_time_t commit_latency;
+	m0_time_t log_latency;
+
+	if (m0_be_tx_group_is_recovering(gr))
+		return;
+	be_engine_lock(en);
+	commit_latency = m0_time_sub(now, gr->tg_open_time);
+	log_latency    = m0_time_sub(now, gr->tg_close_time);
+	en->eng_group_log_latency = be_engine_ewma(en->eng_group_log_latency,
+						   log_latency);
+	M0_ADDB2_ADD(M0_AVI_BE_GROUP_LOGGED,
+		     m0_sm_id_get(&gr->tg_fom.tgf_gen.fo_sm_phase),
+		     m0_be_tx_group_tx_nr(gr), gr->tg_cfg.tgc_tx_nr_max,
+		     gr->tg_payload_prepared, commit_latency, log_latency);
+	be_engine_unlock(en);
+}
+
 static void be_engine_group_stop_nr(struct m0_be_engine *en, size_t nr)
 {
 	size_t i;
@@ -30,6 +30,7 @@
 #include "lib/mutex.h"          /* m0_mutex */
 #include "lib/tlist.h"          /* m0_tl */
 #include "lib/semaphore.h"      /* m0_semaphore */
+#include "lib/thread_pool.h"    /* m0_parallel_pool */
 
 #include "be/log.h"             /* m0_be_log */
 #include "be/tx.h"              /* m0_be_tx */
@@ -80,6 +81,18 @@ struct m0_be_engine_cfg {
 	m0_time_t		   bec_group_freeze_timeout_min;
 	m0_time_t		   bec_group_freeze_timeout_max;
 	m0_time_t                  bec_group_freeze_timeout_limit;
+	/**
+	 * Commit latency the adaptive group close policy aims at: time from
+	 * the moment the first tx joins a group until the group is logged.
+	 * 0 selects the static policy driven by the freeze timeouts above.
+	 * @see be_engine_group_adapt().
+	 */
+	m0_time_t                  bec_group_commit_latency_target;
+	/**
+	 * Number of threads merging reg_areas of txs when a group is closed.
+	 * 0 or 1 means the merge is done by the thread closing the group.
+	 */
+	uint32_t                   bec_group_merge_thread_nr;
 	/** Request handler for group foms and engine timeouts */
 	struct m0_reqh		  *bec_reqh;
 	/** Wait in m0_be_engine_start() until recovery is finished. */
@@ -118,6 +131,21 @@ struct m0_be_engine {
 	struct m0_be_domain       *eng_domain;
 	struct m0_semaphore        eng_recovery_wait_sem;
 	bool                       eng_recovery_finished;
+	/*
+	 * The following fields are used by the adaptive group close policy.
+	 * The averages are exponentially weighted.
+	 */
+	/** When the last regular tx was opened. */
+	m0_time_t                  eng_tx_arrival_last;
+	/** Average interval between tx opens. */
+	m0_time_t                  eng_tx_interarrival;
+	/** Average time from group close to the group being logged. */
+	m0_time_t                  eng_group_log_latency;
+	/**
+	 * Shared by the groups, used under the engine lock only.
+	 * @see m0_be_engine_cfg::bec_group_merge_thread_nr.
+	 */
+	struct m0_parallel_pool    eng_merge_pool;
 };
 
 M0_INTERNAL bool m0_be_engine__invariant(struct m0_be_engine *en);
@@ -150,6 +178,9 @@ M0_INTERNAL void m0_be_engine__tx_force(struct m0_be_engine *en,
 
 M0_INTERNAL void m0_be_engine__tx_group_ready(struct m0_be_engine   *en,
 					      struct m0_be_tx_group *gr);
+/** Called when the group has been written to the log. */
+M0_INTERNAL void m0_be_engine__tx_group_logged(struct m0_be_engine   *en,
+					       struct m0_be_tx_group *gr);
 M0_INTERNAL void m0_be_engine__tx_group_discard(struct m0_be_engine   *en,
 						struct m0_be_tx_group *gr);
 
@@ -170,6 +201,17 @@ M0_INTERNAL void m0_be_engine__group_limits(struct m0_be_engine *en,
                                             uint32_t            *group_nr,
                                             uint32_t            *tx_per_group);
 
+/**
+ * Adaptive group close policy: returns the group freeze delay and sets
+ * @tx_nr to the number of txs at which the group is frozen.
+ */
+M0_INTERNAL m0_time_t
+m0_be_engine__group_adapt(const struct m0_be_engine_cfg *cfg,
+			  m0_time_t                      gap,
+			  m0_time_t                      log_latency,
+			  uint64_t                       queued,
+			  uint64_t                      *tx_nr);
+
 /** @} end of be group */
 #endif /* __MOTR_BE_ENGINE_H__ */
 
@@ -744,6 +744,63 @@ M0_INTERNAL bool m0_be_io_intersect(const struct m0_be_io *bio1,
 	return false;
 }
 
+/* Extents are sorted by offset and don't overlap. */
+static bool be_io_part_is_sorted(const struct m0_be_io_part *bip)
+{
+	const struct m0_indexvec *iv = &bip->bip_sio.si_stob;
+	uint32_t                  i;
+
+	for (i = 1; i < iv->iv_vec.v_nr; ++i) {
+		if (iv->iv_index[i - 1] + iv->iv_vec.v_count[i - 1] >
+		    iv->iv_index[i])
+			return false;
+	}
+	return true;
+}
+
+static bool be_io_part_stob_intersect(const struct m0_be_io_part *bip1,
+				      const struct m0_be_io_part *bip2)
+{
+	const struct m0_indexvec *iv1 = &bip1->bip_sio.si_stob;
+	const struct m0_indexvec *iv2 = &bip2->bip_sio.si_stob;
+	m0_bindex_t               end1;
+	m0_bindex_t               end2;
+	uint32_t                  i = 0;
+	uint32_t                  j = 0;
+
+	if (!be_io_part_is_sorted(bip1) || !be_io_part_is_sorted(bip2))
+		return true;
+	/* Offsets are packed with the same block shift: the stob is the same */
+	while (i < iv1->iv_vec.v_nr && j < iv2->iv_vec.v_nr) {
+		end1 = iv1->iv_index[i] + iv1->iv_vec.v_count[i];
+		end2 = iv2->iv_index[j] + iv2->iv_vec.v_count[j];
+		if (iv1->iv_index[i] < end2 && iv2->iv_index[j] < end1)
+			return true;
+		if (end1 <= end2)
+			++i;
+		else
+			++j;
+	}
+	return false;
+}
+
+M0_INTERNAL bool m0_be_io_stob_intersect(const struct m0_be_io *bio1,
+					 const struct m0_be_io *bio2)
+{
+	int i;
+	int j;
+
+	for (i = 0; i < bio1->bio_stob_nr; ++i)
+		for (j = 0; j < bio2->bio_stob_nr; ++j) {
+			if (bio1->bio_part[i].bip_stob ==
+			    bio2->bio_part[j].bip_stob &&
+			    be_io_part_stob_intersect(&bio1->bio_part[i],
+						      &bio2->bio_part[j]))
+				return true;
+		}
+	return false;
+}
+
 /** @note only one part and only one buffer in bufvec is supported atm. */
 M0_INTERNAL bool m0_be_io_ptr_user_is_eq(const struct m0_be_io *bio1,
 					 const struct m0_be_io *bio2)
@@ -121,6 +121,8 @@ struct m0_be_io {
 	/** The op passed to m0_be_io_sched_add() */
 	struct m0_be_op        *bio_sched_op_user;
 	struct m0_ext           bio_ext;
+	bool                    bio_sched_launched;
+	bool                    bio_sched_done;
 };
 
 M0_INTERNAL int m0_be_io_init(struct m0_be_io *bio);
@@ -188,6 +190,14 @@ M0_INTERNAL int m0_be_io_single(struct m0_stob         *stob,
 				m0_bindex_t             offset_stob,
 				m0_bcount_t             size);
 
+/**
+ * Checks whether bio1 and bio2 have overlapping extents of the same stob.
+ *
+ * It is linear in the number of extents if they are sorted by stob offset
+ * in each part, as they are for segment I/O. Otherwise it returns true.
+ */
+M0_INTERNAL bool m0_be_io_stob_intersect(const struct m0_be_io *bio1,
+					 const struct m0_be_io *bio2);
 M0_INTERNAL bool m0_be_io_intersect(const struct m0_be_io *bio1,
 				    const struct m0_be_io *bio2);
 
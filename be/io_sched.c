@@ -33,6 +33,7 @@
 #include "be/io_sched.h"
 
 #include "lib/ext.h"            /* m0_ext */
+#include "lib/arith.h"          /* max32u */
 
 #include "be/op.h"              /* m0_be_op */
 #include "be/io.h"              /* m0_be_io_launch */
@@ -55,7 +56,8 @@ M0_INTERNAL int m0_be_io_sched_init(struct m0_be_io_sched     *sched,
 		sched->bis_cfg = *cfg;
 	m0_mutex_init(&sched->bis_lock);
 	sched_io_tlist_init(&sched->bis_ios);
-	sched->bis_io_in_progress = false;
+	sched->bis_io_nr = 0;
+	sched->bis_completing = false;
 	sched->bis_pos = sched->bis_cfg.bisc_pos_start;
 
 	return 0;
@@ -90,36 +92,61 @@ static bool be_io_sched_invariant(struct m0_be_io_sched *sched)
 		    sched_io_tlist_next(&sched->bis_ios, io)->bio_ext.e_start);
 }
 
+static bool be_io_sched_io_is_write(struct m0_be_io *io)
+{
+	return m0_be_io_is_empty(io) || m0_be_io_opcode(io) == SIO_WRITE;
+}
+
+/*
+ * Checks whether io may be launched while the I/Os before it are in progress.
+ * Writes to the same place of a stob are not reordered: the newest data is
+ * written last.
+ */
+static bool be_io_sched_may_launch(struct m0_be_io_sched *sched,
+				   struct m0_be_io       *io)
+{
+	struct m0_be_io *prev;
+
+	if (sched->bis_io_nr == 0)
+		return true;
+	if (sched->bis_io_nr >= max32u(sched->bis_cfg.bisc_ios_max, 1) ||
+	    !be_io_sched_io_is_write(io))
+		return false;
+	for (prev = sched_io_tlist_head(&sched->bis_ios); prev != io;
+	     prev = sched_io_tlist_next(&sched->bis_ios, prev)) {
+		if (!prev->bio_sched_done &&
+		    (!be_io_sched_io_is_write(prev) ||
+		     m0_be_io_stob_intersect(prev, io)))
+			return false;
+	}
+	return true;
+}
+
 static void be_io_sched_launch_next(struct m0_be_io_sched *sched)
 {
 	struct m0_be_io *io;
+	m0_bcount_t      pos = sched->bis_pos;
 
 	M0_PRE(m0_be_io_sched_is_locked(sched));
 
-	if (!sched->bis_io_in_progress) {
-		io = sched_io_tlist_head(&sched->bis_ios);
-		M0_ASSERT(ergo(io != NULL,
-			       sched->bis_pos <= io->bio_ext.e_start));
-		if (io != NULL) {
-			M0_LOG(M0_DEBUG, "bis_pos=%" PRIu64 " "
-			       "io->bio_ext.e_start=%"PRIu64,
-			       sched->bis_pos, io->bio_ext.e_start);
-		}
-		if (io != NULL && io->bio_ext.e_start == sched->bis_pos) {
-			sched->bis_io_in_progress = true;
-			M0_LOG(M0_DEBUG, "sched=%p io=%p pos=%"PRId64,
-			       sched, io, sched->bis_pos);
+	m0_tl_for(sched_io, &sched->bis_ios, io) {
+		M0_ASSERT(pos <= io->bio_ext.e_start);
+		M0_LOG(M0_DEBUG, "pos=%" PRIu64 " io->bio_ext.e_start=%"PRIu64,
+		       pos, io->bio_ext.e_start);
+		if (io->bio_ext.e_start != pos)
+			break;
+		if (!io->bio_sched_launched) {
+			if (!be_io_sched_may_launch(sched, io))
+				break;
+			io->bio_sched_launched = true;
+			++sched->bis_io_nr;
+			M0_LOG(M0_DEBUG, "sched=%p io=%p pos=%"PRId64" "
+			       "nr=%"PRIu32, sched, io, pos, sched->bis_io_nr);
 			m0_be_op_active(io->bio_sched_op_user);
 			m0_be_io_launch(io, &io->bio_sched_op);
 		}
-	}
-}
-
-static void be_io_sched_launch_next_locked(struct m0_be_io_sched *sched)
-{
-	m0_be_io_sched_lock(sched);
-	be_io_sched_launch_next(sched);
-	m0_be_io_sched_unlock(sched);
+		pos = io->bio_ext.e_end;
+	} m0_tl_endfor;
 }
 
 static void be_io_sched_cb(struct m0_be_op *op, void *param)
@@ -129,17 +156,30 @@ static void be_io_sched_cb(struct m0_be_op *op, void *param)
 
 	M0_LOG(M0_DEBUG, "sched=%p io=%p", sched, io);
 
-	M0_PRE(io->bio_ext.e_start == sched->bis_pos);
-
 	m0_be_io_sched_lock(sched);
-	sched_io_tlink_del_fini(io);
+	M0_PRE(io->bio_sched_launched && !io->bio_sched_done);
 	m0_be_op_fini(&io->bio_sched_op);
-	sched->bis_io_in_progress = false;
-	sched->bis_pos = io->bio_ext.e_end;
+	io->bio_sched_done = true;
+	/*
+	 * Completion is reported in the queue order by one thread at a time.
+	 * The lock is released for the user callbacks.
+	 */
+	if (!sched->bis_completing) {
+		sched->bis_completing = true;
+		while ((io = sched_io_tlist_head(&sched->bis_ios)) != NULL &&
+		       io->bio_sched_done) {
+			M0_ASSERT(io->bio_ext.e_start == sched->bis_pos);
+			sched_io_tlink_del_fini(io);
+			--sched->bis_io_nr;
+			sched->bis_pos = io->bio_ext.e_end;
+			m0_be_io_sched_unlock(sched);
+			m0_be_op_done(io->bio_sched_op_user);
+			m0_be_io_sched_lock(sched);
+		}
+		sched->bis_completing = false;
+	}
+	be_io_sched_launch_next(sched);
 	m0_be_io_sched_unlock(sched);
-
-	m0_be_op_done(io->bio_sched_op_user);
-	be_io_sched_launch_next_locked(sched);
 }
 
 static void be_io_sched_insert(struct m0_be_io_sched *sched,
@@ -189,6 +229,8 @@ M0_INTERNAL void m0_be_io_sched_add(struct m0_be_io_sched *sched,
 		    ext == NULL));
 
 	io->bio_sched = sched;
+	io->bio_sched_launched = false;
+	io->bio_sched_done = false;
 	if (!m0_be_io_is_empty(io) && m0_be_io_opcode(io) == SIO_READ) {
 		io_last = sched_io_tlist_tail(&sched->bis_ios);
 		io->bio_ext.e_start = io_last == NULL ? sched->bis_pos :
@@ -42,6 +42,11 @@ struct m0_ext;
 struct m0_be_io_sched_cfg {
 	/** start position for m0_be_io_sched::bis_pos */
 	m0_bcount_t bisc_pos_start;
+	/**
+	 * Maximal number of I/Os in progress at the same time. 0 means 1.
+	 * @see m0_be_io_sched
+	 */
+	uint32_t    bisc_ios_max;
 };
 
 /*
@@ -56,18 +61,27 @@ struct m0_be_io_sched_cfg {
  *   - I/Os are launched in the m0_ext increasing order, without gaps. If there
  *     is no such I/O in the queue at the scheduler's current position then I/O
  *     after the gap is not launched until another I/O is added to fill the gap;
+ *   - up to m0_be_io_sched_cfg::bisc_ios_max write I/Os are in progress at
+ *     the same time, if they don't write to the same place of a stob. An I/O
+ *     which intersects with one in progress waits for it to finish;
+ *   - completion is reported in the m0_ext increasing order, even if stob
+ *     I/Os finish in a different order;
  * - read I/O:
  *   - doesn't have m0_ext assigned (subject to change);
  *   - is launched after the last write I/O (at the time the read I/O is added
- *     to the scheduler's queue) from the queue is finished.
+ *     to the scheduler's queue) from the queue is finished;
+ *   - nothing is launched while it is in progress.
  */
 struct m0_be_io_sched {
 	struct m0_be_io_sched_cfg bis_cfg;
 	/** list of m0_be_io-s under scheduler's control */
 	struct m0_tl              bis_ios;
 	struct m0_mutex           bis_lock;
-	bool                      bis_io_in_progress;
-	/** position for the next I/O */
+	/** number of launched I/Os which are still in bis_ios */
+	uint32_t                  bis_io_nr;
+	/** a thread reports completion of finished I/Os */
+	bool                      bis_completing;
+	/** end of the last I/O reported as finished */
 	m0_bcount_t               bis_pos;
 };
 
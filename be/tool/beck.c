@@ -2267,6 +2267,11 @@ static void be_cfg_update(struct m0_be_domain_cfg *cfg,
 		else if (m0_streq(str_key, "bec_group_freeze_timeout_limit"))
 			cfg->bc_engine.bec_group_freeze_timeout_limit =
 								value1_64;
+		else if (m0_streq(str_key, "bec_group_commit_latency_target"))
+			cfg->bc_engine.bec_group_commit_latency_target =
+								value1_64;
+		else if (m0_streq(str_key, "bec_group_merge_thread_nr"))
+			cfg->bc_engine.bec_group_merge_thread_nr = value1_64;
 		else if (m0_streq(str_key, "lc_full_threshold"))
 			cfg->bc_log.lc_full_threshold = value1_64;
 		else if (m0_streq(str_key, "ldsc_sync_timeout"))
@@ -235,6 +235,12 @@ M0_INTERNAL int m0_be_tx_group_init(struct m0_be_tx_group     *gr,
 	M0_ASSERT(rc == 0);	/* XXX */
 	rc = m0_be_reg_area_merger_init(&gr->tg_merger, gr_cfg->tgc_tx_nr_max);
 	M0_ASSERT(rc == 0);     /* XXX */
+	if (gr_cfg->tgc_merge_pool != NULL) {
+		rc = m0_be_reg_area_merger_parallel_init(&gr->tg_merger,
+						gr_cfg->tgc_merge_pool,
+						gr_cfg->tgc_merge_part_nr);
+		M0_ASSERT(rc == 0);     /* XXX */
+	}
 	M0_ALLOC_ARR(gr->tg_rtxs, gr->tg_cfg.tgc_tx_nr_max);
 	M0_ASSERT(gr->tg_rtxs != NULL); /* XXX */
 	for (i = 0; i < gr->tg_cfg.tgc_tx_nr_max; ++i) {
@@ -450,6 +456,8 @@ m0_be_tx_group__tx_state_post(struct m0_be_tx_group *gr,
 
 	M0_ASSERT(m0_be_tx_group_tx_nr(gr) > 0);
 
+	if (state == M0_BTS_LOGGED)
+		m0_be_engine__tx_group_logged(gr->tg_engine, gr);
 	M0_BE_TX_GROUP_TX_FORALL(gr, tx) {
 		if (del_tx_from_group)
 			m0_be_tx_group_tx_del(gr, tx);
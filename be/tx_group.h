@@ -37,6 +37,7 @@ struct m0_be_domain;
 struct m0_be_tx;
 struct be_recovering_tx;
 struct m0_be_op;
+struct m0_parallel_pool;
 
 /**
  * @defgroup be Meta-data back-end
@@ -74,6 +75,14 @@ struct m0_be_tx_group_cfg {
 	struct m0_be_pd               *tgc_pd;
 	/** reqh for the group fom. */
 	struct m0_reqh		      *tgc_reqh;
+	/**
+	 * Pool for merging reg_areas of the group txs, NULL if the merge is
+	 * done by the thread closing the group.
+	 * @see m0_be_reg_area_merger_parallel_init().
+	 */
+	struct m0_parallel_pool       *tgc_merge_pool;
+	/** Number of address ranges the merge is split into. */
+	int                            tgc_merge_part_nr;
 	/** Group format configuration. Is set by the group. */
 	struct m0_be_group_format_cfg  tgc_format;
 };
@@ -142,6 +151,12 @@ struct m0_be_tx_group {
 	struct m0_sm_ast           tg_close_timer_arm;
 	struct m0_sm_ast           tg_close_timer_disarm;
 	m0_time_t                  tg_close_deadline;
+	/** When the first tx was added to the group. */
+	m0_time_t                  tg_open_time;
+	/** When the group was closed. */
+	m0_time_t                  tg_close_time;
+	/** The adaptive close policy freezes the group at this many txs. */
+	uint64_t                   tg_tx_nr_target;
 	/** Group state. Is used and set by the engine. */
 	enum m0_be_tx_group_state  tg_state;
 };
@@ -34,6 +34,7 @@
 #include "lib/assert.h" /* M0_POST */
 #include "lib/misc.h"   /* M0_SET0 */
 #include "lib/arith.h"  /* max_check */
+#include "lib/thread_pool.h" /* m0_parallel_pool */
 
 /**
  * @addtogroup be
@@ -822,6 +823,28 @@ m0_be_reg_area_next(struct m0_be_reg_area *ra, struct m0_be_reg_d *prev)
 	return m0_be_regmap_next(&ra->bra_map, prev);
 }
 
+enum {
+	/**
+	 * The merge is split between the threads of the pool only if sources
+	 * have at least this many regions in total. Smaller merges are
+	 * cheaper than waking up the pool.
+	 */
+	BE_REG_AREA_MERGER_PARALLEL_MIN = 0x400,
+};
+
+/** Address range of the sources, merged by one job of the parallel pool. */
+struct m0_be_reg_area_merger_part {
+	struct m0_be_reg_area_merger  *brmp_merger;
+	/** The range is [brmp_start, brmp_end), NULL brmp_end is unbounded. */
+	void                          *brmp_start;
+	void                          *brmp_end;
+	/** Per-source positions, like m0_be_reg_area_merger::brm_pos. */
+	struct m0_be_reg_d           **brmp_pos;
+	struct m0_be_reg_d            *brmp_out;
+	size_t                         brmp_out_nr;
+	size_t                         brmp_out_nr_max;
+};
+
 M0_INTERNAL int
 m0_be_reg_area_merger_init(struct m0_be_reg_area_merger *brm,
                            int                           reg_area_nr_max)
@@ -830,6 +853,12 @@ m0_be_reg_area_merger_init(struct m0_be_reg_area_merger *brm,
 
 	brm->brm_reg_area_nr_max = reg_area_nr_max;
 	brm->brm_reg_area_nr     = 0;
+	brm->brm_pool            = NULL;
+	brm->brm_part_nr         = 0;
+	brm->brm_parts           = NULL;
+	brm->brm_out             = NULL;
+	brm->brm_out_nr_max      = 0;
+	brm->brm_parallel_nr     = 0;
 
 	M0_ALLOC_ARR(brm->brm_reg_areas, brm->brm_reg_area_nr_max);
 	M0_ALLOC_ARR(brm->brm_pos,       brm->brm_reg_area_nr_max);
@@ -843,8 +872,48 @@ m0_be_reg_area_merger_init(struct m0_be_reg_area_merger *brm,
 	return rc;
 }
 
+static void be_reg_area_merger_parts_free(struct m0_be_reg_area_merger *brm)
+{
+	int i;
+
+	for (i = 0; brm->brm_parts != NULL && i < brm->brm_part_nr; ++i)
+		m0_free(brm->brm_parts[i].brmp_pos);
+	m0_free0(&brm->brm_parts);
+	m0_free0(&brm->brm_out);
+	brm->brm_out_nr_max = 0;
+}
+
+M0_INTERNAL int
+m0_be_reg_area_merger_parallel_init(struct m0_be_reg_area_merger *brm,
+				    struct m0_parallel_pool      *pool,
+				    int                           part_nr)
+{
+	struct m0_be_reg_area_merger_part *part;
+	int                                i;
+
+	M0_PRE(brm->brm_pool == NULL);
+	M0_PRE(part_nr > 1);
+
+	brm->brm_part_nr = part_nr;
+	M0_ALLOC_ARR(brm->brm_parts, part_nr);
+	if (brm->brm_parts == NULL)
+		return M0_ERR(-ENOMEM);
+	for (i = 0; i < part_nr; ++i) {
+		part = &brm->brm_parts[i];
+		part->brmp_merger = brm;
+		M0_ALLOC_ARR(part->brmp_pos, brm->brm_reg_area_nr_max);
+		if (part->brmp_pos == NULL) {
+			be_reg_area_merger_parts_free(brm);
+			return M0_ERR(-ENOMEM);
+		}
+	}
+	brm->brm_pool = pool;
+	return 0;
+}
+
 M0_INTERNAL void m0_be_reg_area_merger_fini(struct m0_be_reg_area_merger *brm)
 {
+	be_reg_area_merger_parts_free(brm);
 	m0_free(brm->brm_pos);
 	m0_free(brm->brm_reg_areas);
 }
@@ -862,10 +931,11 @@ M0_INTERNAL void m0_be_reg_area_merger_add(struct m0_be_reg_area_merger *brm,
 	brm->brm_reg_areas[brm->brm_reg_area_nr++] = ra;
 }
 
-static void be_reg_area_merger_max_gen_idx(struct m0_be_reg_area_merger *brm,
-                                           void                         *addr,
-                                           m0_bcount_t                   size,
-                                           struct m0_be_reg_d           *rd_new)
+static void be_reg_area_merger_max_gen_idx(struct m0_be_reg_d **pos,
+                                           int                  nr,
+                                           void                *addr,
+                                           m0_bcount_t          size,
+                                           struct m0_be_reg_d  *rd_new)
 {
 	struct m0_be_reg_d *rd;
 	int                 i;
@@ -873,8 +943,8 @@ static void be_reg_area_merger_max_gen_idx(struct m0_be_reg_area_merger *brm,
 
 	*rd_new = M0_BE_REG_D(M0_BE_REG(NULL, size, addr), NULL);
 	max_i = -1;
-	for (i = 0; i < brm->brm_reg_area_nr; ++i) {
-		rd = brm->brm_pos[i];
+	for (i = 0; i < nr; ++i) {
+		rd = pos[i];
 		M0_ASSERT(rd == NULL ||
 			  be_reg_d_is_partof(rd, rd_new) ||
 		          !be_reg_d_are_overlapping(rd, rd_new));
@@ -887,7 +957,156 @@ static void be_reg_area_merger_max_gen_idx(struct m0_be_reg_area_merger *brm,
 		}
 	}
 	M0_ASSERT(max_i != -1);
-	be_reg_d_sub_make(brm->brm_pos[max_i], rd_new);
+	be_reg_d_sub_make(pos[max_i], rd_new);
+}
+
+/**
+ * Sets the position of source @i to its first region in the range of @part.
+ *
+ * @return upper bound of the number of source regions in the range.
+ */
+static size_t
+be_reg_area_merger_part_pos(struct m0_be_reg_area_merger_part *part, int i)
+{
+	struct m0_be_reg_area_merger *brm = part->brmp_merger;
+	struct m0_be_reg_d_tree      *rdt;
+	size_t                        size;
+	size_t                        first;
+	size_t                        last;
+
+	rdt   = &brm->brm_reg_areas[i]->bra_map.br_rdt;
+	size  = m0_be_rdt_size(rdt);
+	first = be_rdt_find_i(rdt, part->brmp_start);
+	last  = part->brmp_end == NULL ? size :
+	       be_rdt_find_i(rdt, part->brmp_end);
+	/* the region containing brmp_end is partially in the range */
+	if (last < size && be_reg_d_fb(&rdt->brt_r[last]) < part->brmp_end)
+		++last;
+	part->brmp_pos[i] = first < last ? &rdt->brt_r[first] : NULL;
+	return first < last ? last - first : 0;
+}
+
+/* m0_parallel_pool job: the same as the loop in merge_to(), for one range. */
+static int be_reg_area_merger_part_merge(void *job)
+{
+	struct m0_be_reg_area_merger_part *part = job;
+	struct m0_be_reg_area_merger      *brm  = part->brmp_merger;
+	struct m0_be_reg_d               **pos  = part->brmp_pos;
+	struct m0_be_reg_d                *rd;
+	void                              *end  = part->brmp_end;
+	void                              *addr = part->brmp_start;
+	m0_bcount_t                        size;
+	int                                nr   = brm->brm_reg_area_nr;
+	int                                i;
+
+	while (m0_exists(j, nr, pos[j] != NULL)) {
+		be_reg_d_arr_first_subreg(pos, nr, addr, &addr, &size);
+		if (end != NULL)
+			size = min_check(size, (m0_bcount_t)(end - addr));
+		M0_ASSERT(part->brmp_out_nr < part->brmp_out_nr_max);
+		be_reg_area_merger_max_gen_idx(pos, nr, addr, size,
+				&part->brmp_out[part->brmp_out_nr++]);
+		addr += size;
+		if (addr == end)
+			break;
+		for (i = 0; i < nr; ++i) {
+			rd = pos[i];
+			if (rd != NULL && be_reg_d_lb1(rd) == addr) {
+				rd = m0_be_reg_area_next(
+				        brm->brm_reg_areas[i], rd);
+				if (rd != NULL && end != NULL &&
+				    be_reg_d_fb(rd) >= end)
+					rd = NULL;
+				pos[i] = rd;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * Merges the sources in parallel if it's worth it.
+ *
+ * Boundaries of the ranges are taken at the quantiles of region addresses of
+ * the largest source, so the ranges have roughly the same number of regions
+ * when the sources touch the same areas of the segment.
+ *
+ * @return false if the sources should be merged sequentially.
+ */
+static bool be_reg_area_merger_parallel(struct m0_be_reg_area_merger *brm,
+					struct m0_be_reg_area        *ra)
+{
+	struct m0_be_reg_area_merger_part *part;
+	struct m0_be_reg_d_tree           *largest = NULL;
+	struct m0_be_reg_d_tree           *rdt;
+	struct m0_be_reg_d                *out;
+	size_t                             total = 0;
+	size_t                             out_nr = 0;
+	size_t                             k;
+	int                                part_nr = brm->brm_part_nr;
+	int                                i;
+	int                                j;
+	int                                rc;
+
+	for (i = 0; i < brm->brm_reg_area_nr; ++i) {
+		rdt = &brm->brm_reg_areas[i]->bra_map.br_rdt;
+		total += m0_be_rdt_size(rdt);
+		if (largest == NULL ||
+		    m0_be_rdt_size(rdt) > m0_be_rdt_size(largest))
+			largest = rdt;
+	}
+	/*
+	 * Range boundaries may split regions, don't go parallel if @ra may
+	 * run out of the prepared credit because of that.
+	 */
+	if (total < BE_REG_AREA_MERGER_PARALLEL_MIN ||
+	    m0_be_rdt_size(largest) < part_nr ||
+	    ra->bra_prepared.tc_reg_nr <
+	    ra->bra_captured.tc_reg_nr + total + part_nr)
+		return false;
+
+	for (j = 0; j < part_nr; ++j) {
+		k = j * m0_be_rdt_size(largest) / part_nr;
+		brm->brm_parts[j].brmp_start = j == 0 ? NULL :
+					       be_reg_d_fb(&largest->brt_r[k]);
+	}
+	for (j = 0; j < part_nr; ++j) {
+		part = &brm->brm_parts[j];
+		part->brmp_end = j == part_nr - 1 ? NULL :
+				 brm->brm_parts[j + 1].brmp_start;
+		/* each region adds at most 2 boundaries to the range */
+		part->brmp_out_nr_max = 1;
+		for (i = 0; i < brm->brm_reg_area_nr; ++i)
+			part->brmp_out_nr_max +=
+				2 * be_reg_area_merger_part_pos(part, i);
+		out_nr += part->brmp_out_nr_max;
+	}
+	if (out_nr > brm->brm_out_nr_max) {
+		m0_free(brm->brm_out);
+		M0_ALLOC_ARR(brm->brm_out, out_nr);
+		brm->brm_out_nr_max = brm->brm_out == NULL ? 0 : out_nr;
+		if (brm->brm_out == NULL)
+			return false;
+	}
+	out = brm->brm_out;
+	for (j = 0; j < part_nr; ++j) {
+		part = &brm->brm_parts[j];
+		part->brmp_out    = out;
+		part->brmp_out_nr = 0;
+		out += part->brmp_out_nr_max;
+		rc = m0_parallel_pool_job_add(brm->brm_pool, part);
+		M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
+	}
+	m0_parallel_pool_start(brm->brm_pool, &be_reg_area_merger_part_merge);
+	rc = m0_parallel_pool_wait(brm->brm_pool);
+	M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
+
+	for (j = 0; j < part_nr; ++j) {
+		part = &brm->brm_parts[j];
+		for (k = 0; k < part->brmp_out_nr; ++k)
+			m0_be_reg_area_capture(ra, &part->brmp_out[k]);
+	}
+	return true;
 }
 
 M0_INTERNAL void
@@ -900,13 +1119,19 @@ m0_be_reg_area_merger_merge_to(struct m0_be_reg_area_merger *brm,
 	void               *addr;
 	int                 i;
 
+	if (brm->brm_pool != NULL && be_reg_area_merger_parallel(brm, ra)) {
+		++brm->brm_parallel_nr;
+		return;
+	}
 	for (i = 0; i < brm->brm_reg_area_nr; ++i)
 		brm->brm_pos[i] = m0_be_reg_area_first(brm->brm_reg_areas[i]);
 	addr = NULL;
 	while (m0_exists(j, brm->brm_reg_area_nr, brm->brm_pos[j] != NULL)) {
 		be_reg_d_arr_first_subreg(brm->brm_pos, brm->brm_reg_area_nr,
 		                          addr, &addr, &size);
-		be_reg_area_merger_max_gen_idx(brm, addr, size, &rd_new);
+		be_reg_area_merger_max_gen_idx(brm->brm_pos,
+					       brm->brm_reg_area_nr,
+					       addr, size, &rd_new);
 		m0_be_reg_area_capture(ra, &rd_new);
 		addr += size;
 		/* pass by all stale regions by @addr */
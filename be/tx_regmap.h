@@ -32,6 +32,8 @@
 struct m0_ext;
 struct m0_be_op;
 struct m0_be_io;
+struct m0_parallel_pool;
+struct m0_be_reg_area_merger_part;
 
 /**
  * @defgroup be Meta-data back-end
@@ -308,18 +310,44 @@ m0_be_reg_area_next(struct m0_be_reg_area *ra, struct m0_be_reg_d *prev);
  *   destination reg_area;
  * - destination reg_area contains regions with largest generation index among
  *   all source reg_areas.
+ *
+ * If m0_be_reg_area_merger_parallel_init() was called, large merges are split
+ * into address ranges which are merged by the threads of a parallel pool.
+ * Regions of the destination are then captured in address order by the
+ * caller, so the result is the same except that regions may be split at the
+ * range boundaries.
  */
 struct m0_be_reg_area_merger {
-	int                     brm_reg_area_nr_max;
-	int                     brm_reg_area_nr;
-	struct m0_be_reg_area **brm_reg_areas;
-	struct m0_be_reg_d    **brm_pos;
+	int                                brm_reg_area_nr_max;
+	int                                brm_reg_area_nr;
+	struct m0_be_reg_area            **brm_reg_areas;
+	struct m0_be_reg_d               **brm_pos;
+	/** NULL if the merge is done by the caller only. */
+	struct m0_parallel_pool           *brm_pool;
+	int                                brm_part_nr;
+	struct m0_be_reg_area_merger_part *brm_parts;
+	/** Merged regions of all ranges, the ranges take consecutive slices. */
+	struct m0_be_reg_d                *brm_out;
+	size_t                             brm_out_nr_max;
+	/** Number of merges done by the parallel pool. */
+	uint64_t                           brm_parallel_nr;
 };
 
 M0_INTERNAL int
 m0_be_reg_area_merger_init(struct m0_be_reg_area_merger *brm,
                            int                           reg_area_nr_max);
 M0_INTERNAL void m0_be_reg_area_merger_fini(struct m0_be_reg_area_merger *brm);
+/**
+ * Lets the merger use @pool for merges of @part_nr address ranges.
+ *
+ * @pool should have at least @part_nr job slots. It's used only from
+ * m0_be_reg_area_merger_merge_to(), callers have to serialise merges of all
+ * mergers sharing the pool.
+ */
+M0_INTERNAL int
+m0_be_reg_area_merger_parallel_init(struct m0_be_reg_area_merger *brm,
+				    struct m0_parallel_pool      *pool,
+				    int                           part_nr);
 M0_INTERNAL void m0_be_reg_area_merger_reset(struct m0_be_reg_area_merger *brm);
 
 M0_INTERNAL void m0_be_reg_area_merger_add(struct m0_be_reg_area_merger *brm,
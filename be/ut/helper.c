@@ -289,6 +289,7 @@ void m0_be_ut_backend_cfg_default(struct m0_be_domain_cfg *cfg)
 		.bec_group_freeze_timeout_min   =     1ULL * M0_TIME_ONE_MSEC,
 		.bec_group_freeze_timeout_max   =    50ULL * M0_TIME_ONE_MSEC,
 		.bec_group_freeze_timeout_limit = 60000ULL * M0_TIME_ONE_MSEC,
+		.bec_group_merge_thread_nr	= 4,
 		.bec_reqh		  = reqh,
 		.bec_wait_for_recovery	  = true,
 	    },
@@ -338,6 +339,9 @@ void m0_be_ut_backend_cfg_default(struct m0_be_domain_cfg *cfg)
 		.bc_seg_cfg		   = NULL,
 		.bc_seg_nr		   = 0,
 		.bc_pd_cfg = {
+			.bpdc_sched = {
+				.bisc_ios_max = 0x2,
+			},
 			.bpdc_seg_io_nr = 0x2,
 		},
 		.bc_log_discard_cfg = {
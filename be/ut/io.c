@@ -20,10 +20,152 @@
  */
 
 
+/**
+ * @addtogroup be
+ *
+ * @{
+ */
+
+#include "be/io.h"
+
+#include "lib/misc.h"           /* ARRAY_SIZE */
+#include "ut/ut.h"              /* M0_UT_ASSERT */
+#include "ut/stob.h"            /* m0_ut_stob_linux_get_by_key */
+
 void m0_be_ut_io(void)
 {
 }
 
+enum {
+	BE_UT_IO_REG_NR    = 4,
+	BE_UT_IO_BUF_SIZE  = 0x1000,
+	BE_UT_IO_STOB_KEY0 = 0x10,
+	BE_UT_IO_STOB_KEY1 = 0x11,
+};
+
+struct be_ut_io_reg {
+	int         bur_stob;
+	m0_bindex_t bur_start;
+	m0_bindex_t bur_end;
+};
+
+static char be_ut_io_buf[BE_UT_IO_BUF_SIZE];
+
+/*
+ * Fills bio with the regions. User buffers follow stob offsets, so regions
+ * which are not sequential are kept apart.
+ */
+static void be_ut_io_fill(struct m0_be_io           *bio,
+			  struct m0_stob           **stobs,
+			  const struct be_ut_io_reg *regs,
+			  int                        nr)
+{
+	int i;
+
+	m0_be_io_reset(bio);
+	for (i = 0; i < nr; ++i) {
+		M0_UT_ASSERT(regs[i].bur_end <= BE_UT_IO_BUF_SIZE);
+		m0_be_io_add(bio, stobs[regs[i].bur_stob],
+			     &be_ut_io_buf[regs[i].bur_start],
+			     regs[i].bur_start,
+			     regs[i].bur_end - regs[i].bur_start);
+	}
+	m0_be_io_configure(bio, SIO_WRITE);
+}
+
+static void be_ut_io_stob_intersect_check(struct m0_be_io           *bio0,
+					  struct m0_be_io           *bio1,
+					  struct m0_stob           **stobs,
+					  const struct be_ut_io_reg *regs0,
+					  int                        nr0,
+					  const struct be_ut_io_reg *regs1,
+					  int                        nr1,
+					  bool                       intersect)
+{
+	be_ut_io_fill(bio0, stobs, regs0, nr0);
+	be_ut_io_fill(bio1, stobs, regs1, nr1);
+	M0_UT_ASSERT(m0_be_io_stob_intersect(bio0, bio1) == intersect);
+	M0_UT_ASSERT(m0_be_io_stob_intersect(bio1, bio0) == intersect);
+}
+
+void m0_be_ut_io_stob_intersect(void)
+{
+	struct m0_be_io_credit  iocred = M0_BE_IO_CREDIT(BE_UT_IO_REG_NR,
+							 BE_UT_IO_BUF_SIZE, 2);
+	struct m0_stob         *stobs[2];
+	struct m0_be_io         bio0;
+	struct m0_be_io         bio1;
+	int                     rc;
+	/* Sorted extents of one stob, interleaved and touching. */
+	const struct be_ut_io_reg sorted0[] = {
+		{ 0, 0x000, 0x100 }, { 0, 0x200, 0x300 }, { 0, 0x400, 0x500 },
+	};
+	const struct be_ut_io_reg sorted1[] = {
+		{ 0, 0x100, 0x200 }, { 0, 0x300, 0x400 }, { 0, 0x500, 0x600 },
+	};
+	/* The same with one extent overlapping the last one of sorted0. */
+	const struct be_ut_io_reg sorted2[] = {
+		{ 0, 0x100, 0x200 }, { 0, 0x300, 0x400 }, { 0, 0x4ff, 0x600 },
+	};
+	/* Disjoint with sorted1, but not sorted. */
+	const struct be_ut_io_reg unsorted[] = {
+		{ 0, 0x400, 0x500 }, { 0, 0x000, 0x100 },
+	};
+	/* The same extents as sorted0, but of the other stob. */
+	const struct be_ut_io_reg other[] = {
+		{ 1, 0x000, 0x100 }, { 1, 0x200, 0x300 }, { 1, 0x400, 0x500 },
+	};
+	/* Parts of both stobs, overlapping sorted0 in the second one. */
+	const struct be_ut_io_reg both[] = {
+		{ 1, 0x000, 0x100 }, { 0, 0x280, 0x290 },
+	};
+
+	stobs[0] = m0_ut_stob_linux_get_by_key(BE_UT_IO_STOB_KEY0);
+	M0_UT_ASSERT(stobs[0] != NULL);
+	stobs[1] = m0_ut_stob_linux_get_by_key(BE_UT_IO_STOB_KEY1);
+	M0_UT_ASSERT(stobs[1] != NULL);
+	rc = m0_be_io_init(&bio0);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_io_allocate(&bio0, &iocred);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_io_init(&bio1);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_io_allocate(&bio1, &iocred);
+	M0_UT_ASSERT(rc == 0);
+
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      sorted0, ARRAY_SIZE(sorted0),
+				      sorted1, ARRAY_SIZE(sorted1), false);
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      sorted0, ARRAY_SIZE(sorted0),
+				      sorted2, ARRAY_SIZE(sorted2), true);
+	/* Unsorted extents are conservatively reported as intersecting. */
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      unsorted, ARRAY_SIZE(unsorted),
+				      sorted1, ARRAY_SIZE(sorted1), true);
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      sorted0, ARRAY_SIZE(sorted0),
+				      other, ARRAY_SIZE(other), false);
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      unsorted, ARRAY_SIZE(unsorted),
+				      other, ARRAY_SIZE(other), false);
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      sorted1, ARRAY_SIZE(sorted1),
+				      both, ARRAY_SIZE(both), false);
+	be_ut_io_stob_intersect_check(&bio0, &bio1, stobs,
+				      sorted0, ARRAY_SIZE(sorted0),
+				      both, ARRAY_SIZE(both), true);
+
+	m0_be_io_deallocate(&bio1);
+	m0_be_io_fini(&bio1);
+	m0_be_io_deallocate(&bio0);
+	m0_be_io_fini(&bio0);
+	m0_ut_stob_put(stobs[1], true);
+	m0_ut_stob_put(stobs[0], true);
+}
+
+/** @} end of be group */
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
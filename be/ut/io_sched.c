@@ -40,6 +40,7 @@
 #include "lib/time.h"           /* m0_time_now */
 #include "lib/atomic.h"         /* m0_atomic64 */
 #include "lib/semaphore.h"      /* m0_semaphore */
+#include "lib/mutex.h"          /* m0_mutex */
 
 #include "be/op.h"              /* m0_be_op_init */
 #include "be/io.h"              /* m0_be_io_init */
@@ -66,6 +67,7 @@ struct be_ut_io_sched_io_state {
 	enum be_ut_io_sched_io_op  sis_op;
 	m0_time_t                  sis_time;
 	struct m0_be_io           *sis_io;
+	struct m0_ext              sis_ext;
 	/* TODO dependencies etc. */
 };
 
@@ -80,6 +82,8 @@ struct be_ut_io_sched_test {
 	uint64_t                          st_data;
 	/* seed for m0_rnd64() */
 	uint64_t                          st_seed;
+	/* I/O offsets are in [0, st_offset_max) */
+	uint64_t                          st_offset_max;
 	/* callback execution queue */
 	struct be_ut_io_sched_io_state  *st_states;
 	/* st_states array size */
@@ -111,6 +115,71 @@ struct be_ut_io_sched_test {
 
 static struct m0_be_io_sched  be_ut_io_sched_scheduler;
 
+/*
+ * I/Os which are started but not reported finished yet, in the start order.
+ * Protected by be_ut_io_sched_inflight_lock.
+ */
+static struct m0_be_io *be_ut_io_sched_inflight[BE_UT_IO_SCHED_THREAD_NR *
+						BE_UT_IO_SCHED_IO_NR];
+static uint64_t         be_ut_io_sched_inflight_head;
+static uint64_t         be_ut_io_sched_inflight_tail;
+static struct m0_mutex  be_ut_io_sched_inflight_lock;
+/* Maximal number of stob I/Os in progress when an I/O is started. */
+static uint64_t         be_ut_io_sched_running_max;
+
+/* The test adds one region of one stob to every m0_be_io. */
+static bool be_ut_io_sched_io_overlap(struct m0_be_io *bio1,
+				      struct m0_be_io *bio2)
+{
+	const struct m0_indexvec *iv1 = &bio1->bio_part[0].bip_sio.si_stob;
+	const struct m0_indexvec *iv2 = &bio2->bio_part[0].bip_sio.si_stob;
+
+	return iv1->iv_index[0] < iv2->iv_index[0] + iv2->iv_vec.v_count[0] &&
+	       iv2->iv_index[0] < iv1->iv_index[0] + iv1->iv_vec.v_count[0];
+}
+
+/*
+ * Called from the start callback, under the scheduler lock. Checks that
+ * every overlapping I/O started before bio has already finished its stob
+ * I/O, even if its completion is not reported yet.
+ */
+static void be_ut_io_sched_inflight_add(struct m0_be_io *bio)
+{
+	struct m0_be_io *prev;
+	uint64_t         running = 0;
+	uint64_t         i;
+
+	M0_UT_ASSERT(m0_be_io_sched_is_locked(&be_ut_io_sched_scheduler));
+	m0_mutex_lock(&be_ut_io_sched_inflight_lock);
+	for (i = be_ut_io_sched_inflight_head;
+	     i < be_ut_io_sched_inflight_tail; ++i) {
+		prev = be_ut_io_sched_inflight[i %
+				ARRAY_SIZE(be_ut_io_sched_inflight)];
+		M0_UT_ASSERT(prev->bio_sched_done ||
+			     !be_ut_io_sched_io_overlap(prev, bio));
+		running += !prev->bio_sched_done;
+	}
+	be_ut_io_sched_running_max = max_check(be_ut_io_sched_running_max,
+					       running);
+	M0_UT_ASSERT(be_ut_io_sched_inflight_tail -
+		     be_ut_io_sched_inflight_head <
+		     ARRAY_SIZE(be_ut_io_sched_inflight));
+	be_ut_io_sched_inflight[be_ut_io_sched_inflight_tail++ %
+				ARRAY_SIZE(be_ut_io_sched_inflight)] = bio;
+	m0_mutex_unlock(&be_ut_io_sched_inflight_lock);
+}
+
+/* Completion is reported in the start order. */
+static void be_ut_io_sched_inflight_del(struct m0_be_io *bio)
+{
+	m0_mutex_lock(&be_ut_io_sched_inflight_lock);
+	M0_UT_ASSERT(be_ut_io_sched_inflight_head <
+		     be_ut_io_sched_inflight_tail);
+	M0_UT_ASSERT(be_ut_io_sched_inflight[be_ut_io_sched_inflight_head++ %
+				ARRAY_SIZE(be_ut_io_sched_inflight)] == bio);
+	m0_mutex_unlock(&be_ut_io_sched_inflight_lock);
+}
+
 static void be_ut_io_sched_io_ready_add(struct be_ut_io_sched_test *test,
 					struct m0_be_io            *bio,
 					struct m0_be_op            *op)
@@ -166,7 +235,9 @@ static void be_ut_io_sched_io_completion_cb(struct m0_be_op *op, void *param)
 		.sis_op   = BE_UT_IO_SCHED_IO_FINISH,
 		.sis_time = m0_time_now(),
 		.sis_io   = bio,
+		.sis_ext  = bio->bio_ext,
 	};
+	be_ut_io_sched_inflight_del(bio);
 	be_ut_io_sched_io_state_add(test, &io_state);
 	be_ut_io_sched_io_ready_add(test, bio, op);
 }
@@ -178,7 +249,9 @@ static void be_ut_io_sched_io_start_cb(struct m0_be_op *op, void *param)
 		.sis_op   = BE_UT_IO_SCHED_IO_START,
 		.sis_time = m0_time_now(),
 		.sis_io   = bio,
+		.sis_ext  = bio->bio_ext,
 	};
+	be_ut_io_sched_inflight_add(bio);
 	be_ut_io_sched_io_state_add(m0_be_io_user_data(bio), &io_state);
 }
 
@@ -228,8 +301,7 @@ static void be_ut_io_sched_thread(void *param)
 		be_ut_io_sched_io_ready_get(test, &bio, &op);
 		m0_be_io_reset(bio);
 		m0_be_op_reset(op);
-		offset = m0_rnd64(&test->st_seed) %
-			 BE_UT_IO_SCHED_IO_OFFSET_MAX;
+		offset = m0_rnd64(&test->st_seed) % test->st_offset_max;
 		m0_be_io_add(bio, stob, &test->st_data, offset,
 			     sizeof(test->st_data));
 		m0_be_io_configure(bio, SIO_WRITE);
@@ -260,9 +332,23 @@ be_ut_io_sched_states_check(struct be_ut_io_sched_io_state *states,
 			     int                            states_nr,
 			     struct m0_atomic64            *states_pos)
 {
-	int pos = m0_atomic64_get(states_pos);
+	m0_bindex_t start_pos  = 0;
+	m0_bindex_t finish_pos = 0;
+	int         pos = m0_atomic64_get(states_pos);
+	int         i;
 
 	M0_UT_ASSERT(pos == states_nr);
+	/* I/Os are started and reported finished in the m0_ext order */
+	for (i = 0; i < states_nr; ++i) {
+		if (states[i].sis_op == BE_UT_IO_SCHED_IO_START) {
+			M0_UT_ASSERT(start_pos <= states[i].sis_ext.e_start);
+			start_pos = states[i].sis_ext.e_end;
+		} else {
+			M0_UT_ASSERT(finish_pos <= states[i].sis_ext.e_start);
+			M0_UT_ASSERT(start_pos >= states[i].sis_ext.e_end);
+			finish_pos = states[i].sis_ext.e_end;
+		}
+	}
 	/* TODO additional checks */
 }
 
@@ -278,15 +364,17 @@ M0_UT_THREADS_DEFINE(be_ut_io_sched, &be_ut_io_sched_thread);
  * 3) Checks that all start and completion callbacks for m0_be_io was called
  * in the right order.
  *
- * @note Currently m0_be_io_sched executes m0_be_io one by one in the
- * order they are added to the scheduler queue.
+ * m0_be_io_sched executes m0_be_io one by one in the order they are added to
+ * the scheduler queue if ios_max is 1. Otherwise non-intersecting m0_be_io
+ * are executed concurrently.
  */
-void m0_be_ut_io_sched(void)
+static void be_ut_io_sched_run(uint32_t ios_max, uint64_t offset_max)
 {
 	struct be_ut_io_sched_io_state *states;
 	struct be_ut_io_sched_test     *tests;
 	struct m0_be_io_sched_cfg       cfg = {
 		.bisc_pos_start = 0x1234,
+		.bisc_ios_max   = ios_max,
 	};
 	struct m0_be_io_sched          *sched = &be_ut_io_sched_scheduler;
 	struct m0_atomic64              states_pos;
@@ -313,6 +401,7 @@ void m0_be_ut_io_sched(void)
 			.st_stob         = stob,
 			.st_data         = m0_rnd64(&seed),
 			.st_seed         = i,
+			.st_offset_max   = offset_max,
 			.st_states       = states,
 			.st_states_nr    = states_nr,
 			.st_states_pos   = &states_pos,
@@ -320,20 +409,56 @@ void m0_be_ut_io_sched(void)
 		};
 	}
 
+	be_ut_io_sched_inflight_head = 0;
+	be_ut_io_sched_inflight_tail = 0;
+	be_ut_io_sched_running_max = 0;
+	m0_mutex_init(&be_ut_io_sched_inflight_lock);
 	M0_SET0(sched);
 	rc = m0_be_io_sched_init(sched, &cfg);
 	M0_UT_ASSERT(rc == 0);
 	M0_UT_THREADS_START(be_ut_io_sched, BE_UT_IO_SCHED_THREAD_NR, tests);
 	M0_UT_THREADS_STOP(be_ut_io_sched);
 	m0_be_io_sched_fini(sched);
+	M0_UT_ASSERT(be_ut_io_sched_inflight_head ==
+		     be_ut_io_sched_inflight_tail);
+	m0_mutex_fini(&be_ut_io_sched_inflight_lock);
 
 	be_ut_io_sched_states_check(states, states_nr, &states_pos);
+	M0_UT_ASSERT(be_ut_io_sched_running_max < max32u(ios_max, 1));
+	/*
+	 * Non-intersecting I/Os are run concurrently: some I/O is started
+	 * before the stob I/O preceding it is finished.
+	 */
+	if (ios_max > 1 && offset_max == BE_UT_IO_SCHED_IO_OFFSET_MAX)
+		M0_UT_ASSERT(be_ut_io_sched_running_max > 0);
+	/* Overlapping I/Os are never in progress at the same time. */
+	if (offset_max <= sizeof(uint64_t))
+		M0_UT_ASSERT(be_ut_io_sched_running_max == 0);
 
 	m0_ut_stob_put(stob, true);
 	m0_free(states);
 	m0_free(tests);
 }
 
+void m0_be_ut_io_sched(void)
+{
+	be_ut_io_sched_run(1, BE_UT_IO_SCHED_IO_OFFSET_MAX);
+}
+
+void m0_be_ut_io_sched_concurrent(void)
+{
+	be_ut_io_sched_run(BE_UT_IO_SCHED_IO_NR, BE_UT_IO_SCHED_IO_OFFSET_MAX);
+}
+
+/*
+ * Every I/O overlaps every other one on the stob, so they must not be in
+ * progress at the same time even if the scheduler allows it.
+ */
+void m0_be_ut_io_sched_overlap(void)
+{
+	be_ut_io_sched_run(BE_UT_IO_SCHED_IO_NR, sizeof(uint64_t));
+}
+
 /** @} end of be group */
 #undef M0_TRACE_SUBSYSTEM
 
@@ -57,6 +57,7 @@ extern void m0_be_ut_regmap_random(void);
 extern void m0_be_ut_reg_area_simple(void);
 extern void m0_be_ut_reg_area_random(void);
 extern void m0_be_ut_reg_area_merge(void);
+extern void m0_be_ut_reg_area_merger_parallel(void);
 
 extern void m0_be_ut_fmt_log_header(void);
 extern void m0_be_ut_fmt_cblock(void);
@@ -65,7 +66,10 @@ extern void m0_be_ut_fmt_group_size_max(void);
 extern void m0_be_ut_fmt_group_size_max_rnd(void);
 
 extern void m0_be_ut_io(void);
+extern void m0_be_ut_io_stob_intersect(void);
 extern void m0_be_ut_io_sched(void);
+extern void m0_be_ut_io_sched_concurrent(void);
+extern void m0_be_ut_io_sched_overlap(void);
 
 extern void m0_be_ut_log_store_create_simple(void);
 extern void m0_be_ut_log_store_create_random(void);
@@ -113,6 +117,8 @@ extern void m0_be_ut_tx_persistence(void);
 extern void m0_be_ut_tx_fast(void);
 extern void m0_be_ut_tx_concurrent(void);
 extern void m0_be_ut_tx_concurrent_excl(void);
+extern void m0_be_ut_tx_group_policy(void);
+extern void m0_be_ut_tx_group_adapt(void);
 extern void m0_be_ut_tx_force(void);
 extern void m0_be_ut_tx_gc(void);
 extern void m0_be_ut_tx_payload(void);
@@ -189,13 +195,18 @@ struct m0_ut_suite be_ut = {
 // XXX		{ "reg_area-simple",         m0_be_ut_reg_area_simple         },
 		{ "reg_area-random",         m0_be_ut_reg_area_random         },
 		{ "reg_area-merge",          m0_be_ut_reg_area_merge          },
+		{ "reg_area-merger_parallel",
+				     m0_be_ut_reg_area_merger_parallel },
 		{ "fmt-log_header",          m0_be_ut_fmt_log_header          },
 		{ "fmt-cblock",              m0_be_ut_fmt_cblock              },
 		{ "fmt-group",               m0_be_ut_fmt_group               },
 		{ "fmt-group_size_max",      m0_be_ut_fmt_group_size_max      },
 		{ "fmt-group_size_max_rnd",  m0_be_ut_fmt_group_size_max_rnd  },
 		{ "io-noop",                 m0_be_ut_io                      },
+		{ "io-stob_intersect",       m0_be_ut_io_stob_intersect       },
 		{ "io_sched",                m0_be_ut_io_sched                },
+		{ "io_sched-concurrent",     m0_be_ut_io_sched_concurrent     },
+		{ "io_sched-overlap",        m0_be_ut_io_sched_overlap        },
 		{ "log_store-create_simple", m0_be_ut_log_store_create_simple },
 		{ "log_store-create_random", m0_be_ut_log_store_create_random },
 		{ "log_store-io_window",     m0_be_ut_log_store_io_window     },
@@ -239,6 +250,8 @@ struct m0_ut_suite be_ut = {
 		{ "tx-callback",             m0_be_ut_tx_callback             },
 		{ "tx-concurrent",           m0_be_ut_tx_concurrent           },
 		{ "tx-concurrent-excl",      m0_be_ut_tx_concurrent_excl      },
+		{ "tx-group_policy",         m0_be_ut_tx_group_policy         },
+		{ "tx-group_adapt",          m0_be_ut_tx_group_adapt          },
 		{ "tx_bulk-usecase",         m0_be_ut_tx_bulk_usecase         },
 		{ "tx_bulk-empty",           m0_be_ut_tx_bulk_empty           },
 		{ "tx_bulk-error_reg",       m0_be_ut_tx_bulk_error_reg       },
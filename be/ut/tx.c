@@ -40,6 +40,7 @@
 #include "ut/ut.h"
 
 #include "be/ut/helper.h"       /* m0_be_ut_backend */
+#include "be/engine.h"          /* m0_be_engine__group_adapt */
 
 void m0_be_ut_tx_usecase_success(void)
 {
@@ -738,6 +739,161 @@ void m0_be_ut_tx_concurrent_excl(void)
 	m0_be_ut_tx_concurrent_helper(true);
 }
 
+enum {
+	BE_UT_TX_GP_THREAD_NR = 8,
+	BE_UT_TX_GP_BURST_NR  = 8,
+	BE_UT_TX_GP_BURST_TX  = 8,
+	BE_UT_TX_GP_IDLE      = 10 * M0_TIME_ONE_MSEC,
+	BE_UT_TX_GP_TARGET    = 5 * M0_TIME_ONE_MSEC,
+};
+
+struct be_ut_tx_gp_thread {
+	struct m0_thread         gpt_thread;
+	struct m0_be_ut_backend *gpt_ut_be;
+	m0_time_t                gpt_latency_sum;
+	m0_time_t                gpt_latency_max;
+};
+
+/* Bursts of back-to-back txs separated by idle periods. */
+static void be_ut_tx_gp_thread(struct be_ut_tx_gp_thread *t)
+{
+	struct m0_be_tx tx;
+	m0_time_t       start;
+	m0_time_t       latency;
+	int             i;
+	int             j;
+	int             rc;
+
+	for (i = 0; i < BE_UT_TX_GP_BURST_NR; ++i) {
+		for (j = 0; j < BE_UT_TX_GP_BURST_TX; ++j) {
+			M0_SET0(&tx);
+			m0_be_ut_tx_init(&tx, t->gpt_ut_be);
+			start = m0_time_now();
+			rc = m0_be_tx_open_sync(&tx);
+			M0_UT_ASSERT(rc == 0);
+			m0_be_tx_close(&tx);
+			rc = m0_be_tx_timedwait(&tx, M0_BITS(M0_BTS_LOGGED,
+							     M0_BTS_PLACED,
+							     M0_BTS_DONE),
+						M0_TIME_NEVER);
+			M0_UT_ASSERT(rc == 0);
+			latency = m0_time_sub(m0_time_now(), start);
+			t->gpt_latency_sum += latency;
+			t->gpt_latency_max = max64u(t->gpt_latency_max,
+						    latency);
+			rc = m0_be_tx_timedwait(&tx, M0_BITS(M0_BTS_DONE),
+						M0_TIME_NEVER);
+			M0_UT_ASSERT(rc == 0);
+			m0_be_tx_fini(&tx);
+		}
+		m0_nanosleep(BE_UT_TX_GP_IDLE, NULL);
+	}
+	m0_be_ut_backend_thread_exit(t->gpt_ut_be);
+}
+
+static void be_ut_tx_group_policy_run(m0_time_t latency_target)
+{
+	static struct be_ut_tx_gp_thread threads[BE_UT_TX_GP_THREAD_NR];
+	static struct m0_be_domain_cfg   cfg;
+	struct m0_be_ut_backend          ut_be = {};
+	struct m0_be_engine             *en;
+	m0_time_t                        start;
+	m0_time_t                        sum = 0;
+	m0_time_t                        max = 0;
+	int                              i;
+	int                              rc;
+
+	m0_be_ut_backend_cfg_default(&cfg);
+	cfg.bc_engine.bec_group_commit_latency_target = latency_target;
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, true);
+	M0_UT_ASSERT(rc == 0);
+
+	start = m0_time_now();
+	for (i = 0; i < ARRAY_SIZE(threads); ++i) {
+		threads[i] = (struct be_ut_tx_gp_thread) {
+			.gpt_ut_be = &ut_be,
+		};
+		rc = M0_THREAD_INIT(&threads[i].gpt_thread,
+				    struct be_ut_tx_gp_thread *, NULL,
+				    &be_ut_tx_gp_thread, &threads[i],
+				    "#%dbe_ut_gp", i);
+		M0_UT_ASSERT(rc == 0);
+	}
+	for (i = 0; i < ARRAY_SIZE(threads); ++i) {
+		rc = m0_thread_join(&threads[i].gpt_thread);
+		M0_UT_ASSERT(rc == 0);
+		m0_thread_fini(&threads[i].gpt_thread);
+		sum += threads[i].gpt_latency_sum;
+		max  = max64u(max, threads[i].gpt_latency_max);
+	}
+	M0_LOG(M0_INFO, "policy=%s elapsed="TIME_F" latency: avg="TIME_F
+	       " max="TIME_F, latency_target == 0 ? "static" : "adaptive",
+	       TIME_P(m0_time_sub(m0_time_now(), start)),
+	       TIME_P(sum / (BE_UT_TX_GP_THREAD_NR * BE_UT_TX_GP_BURST_NR *
+			     BE_UT_TX_GP_BURST_TX)), TIME_P(max));
+	/*
+	 * The adaptive policy tracks tx arrival and group log write, idle
+	 * periods are clamped at the target. The static one doesn't.
+	 */
+	en = m0_be_domain_engine(&ut_be.but_dom);
+	if (latency_target == 0) {
+		M0_UT_ASSERT(en->eng_tx_interarrival == 0);
+		M0_UT_ASSERT(en->eng_group_log_latency == 0);
+	} else {
+		M0_UT_ASSERT(en->eng_tx_interarrival > 0);
+		M0_UT_ASSERT(en->eng_tx_interarrival <= latency_target);
+		M0_UT_ASSERT(en->eng_group_log_latency > 0);
+	}
+	m0_be_ut_backend_fini(&ut_be);
+}
+
+/*
+ * Runs the same bursty load with the static and the adaptive group close
+ * policies. Group fill and commit latency of every group are in the
+ * "gr-logged" addb2 records.
+ */
+void m0_be_ut_tx_group_policy(void)
+{
+	be_ut_tx_group_policy_run(0);
+	be_ut_tx_group_policy_run(BE_UT_TX_GP_TARGET);
+}
+
+/* Group size and freeze delay chosen by the adaptive policy. */
+void m0_be_ut_tx_group_adapt(void)
+{
+	struct m0_be_engine_cfg cfg = {
+		.bec_group_cfg = { .tgc_tx_nr_max = 64 },
+		.bec_group_freeze_timeout_min    = M0_TIME_ONE_MSEC / 10,
+		.bec_group_commit_latency_target = 10 * M0_TIME_ONE_MSEC,
+	};
+	m0_time_t delay;
+	uint64_t  nr;
+
+	/* No history yet: wait for a full group, within the target. */
+	delay = m0_be_engine__group_adapt(&cfg, 0, 0, 1, &nr);
+	M0_UT_ASSERT(nr == 64 && delay == 10 * M0_TIME_ONE_MSEC);
+	/* Expected arrivals during the target less the log write. */
+	delay = m0_be_engine__group_adapt(&cfg, M0_TIME_ONE_MSEC,
+					  4 * M0_TIME_ONE_MSEC, 2, &nr);
+	M0_UT_ASSERT(nr == 2 + 6 && delay == 6 * M0_TIME_ONE_MSEC);
+	/* Faster arrivals give larger groups, not longer delays. */
+	delay = m0_be_engine__group_adapt(&cfg, M0_TIME_ONE_MSEC / 2,
+					  4 * M0_TIME_ONE_MSEC, 2, &nr);
+	M0_UT_ASSERT(nr == 2 + 12 && delay == 6 * M0_TIME_ONE_MSEC);
+	/* Group size is capped, and so is the delay then. */
+	delay = m0_be_engine__group_adapt(&cfg, M0_TIME_ONE_MSEC / 20,
+					  0, 60, &nr);
+	M0_UT_ASSERT(nr == 64 && delay == 4 * M0_TIME_ONE_MSEC / 20);
+	/* Nothing is expected in time: close after the minimal timeout. */
+	delay = m0_be_engine__group_adapt(&cfg, 20 * M0_TIME_ONE_MSEC,
+					  4 * M0_TIME_ONE_MSEC, 1, &nr);
+	M0_UT_ASSERT(nr == 1 && delay == M0_TIME_ONE_MSEC / 10);
+	/* Log write alone exceeds the target. */
+	delay = m0_be_engine__group_adapt(&cfg, M0_TIME_ONE_MSEC,
+					  20 * M0_TIME_ONE_MSEC, 3, &nr);
+	M0_UT_ASSERT(nr == 3 && delay == M0_TIME_ONE_MSEC / 10);
+}
+
 enum {
 	BE_UT_TX_CAPTURING_SEG_SIZE = 0x10000,
 	BE_UT_TX_CAPTURING_TX_NR    = 0x10,
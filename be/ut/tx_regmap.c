@@ -30,6 +30,7 @@
 #include "lib/string.h"         /* memcpy */
 
 #include "be/ut/helper.h"	/* m0_be_ut_seg */
+#include "lib/thread_pool.h"	/* m0_parallel_pool */
 
 /*
 #define LOGD(...) printf(__VA_ARGS__)
@@ -1039,6 +1040,147 @@ void m0_be_ut_reg_area_merge(void)
 	m0_be_ut_seg_fini(&ut_seg);
 }
 
+/* backend UT parallel reg_area merger. */
+enum {
+	BE_UT_RA_MP_SEG_SIZE   = 0x10000,
+	BE_UT_RA_MP_SPACE      = 0x4000,
+	BE_UT_RA_MP_RA_NR      = 0x40,
+	BE_UT_RA_MP_R_NR       = 0x20,
+	BE_UT_RA_MP_R_SIZE_MAX = 0x10,
+	BE_UT_RA_MP_THREAD_NR  = 4,
+	BE_UT_RA_MP_PART_NR    = 8,
+	BE_UT_RA_MP_ITER       = 0x10,
+};
+
+static unsigned char be_ut_ra_mp_seq[BE_UT_RA_MP_SPACE];
+static unsigned char be_ut_ra_mp_par[BE_UT_RA_MP_SPACE];
+
+static void be_ut_reg_area_mp_flatten(struct m0_be_reg_area *ra,
+				      unsigned char         *arr)
+{
+	struct m0_be_reg_d *rd;
+	m0_bindex_t         index;
+
+	memset(arr, 0, BE_UT_RA_MP_SPACE);
+	M0_BE_REG_AREA_FORALL(ra, rd) {
+		index = be_ut_reg_area_merge_addr2offs(rd->rd_reg.br_addr);
+		M0_UT_ASSERT(index + rd->rd_reg.br_size <= BE_UT_RA_MP_SPACE);
+		memcpy(&arr[index], rd->rd_buf, rd->rd_reg.br_size);
+	}
+}
+
+/* Captures a random region at a random place with the given gen_idx. */
+static void be_ut_reg_area_mp_capture(struct m0_be_reg_area *ra,
+				      unsigned long          gen_idx)
+{
+	static unsigned char random[BE_UT_RA_MP_R_SIZE_MAX];
+	struct m0_be_reg_d   rd;
+	m0_bindex_t          begin;
+	m0_bcount_t          size;
+	int                  i;
+
+	size  = be_ut_reg_area_merge_rand(1, BE_UT_RA_MP_R_SIZE_MAX);
+	begin = be_ut_reg_area_merge_rand(0, BE_UT_RA_MP_SPACE - size);
+	for (i = 0; i < size; ++i)
+		random[i] = be_ut_reg_area_merge_rand(1, 0xFF);
+	rd = (struct m0_be_reg_d) {
+		.rd_reg     = M0_BE_REG(be_ut_ra_merge_seg, size,
+					be_ut_reg_area_merge_offs2addr(begin)),
+		.rd_buf     = NULL,
+		.rd_gen_idx = gen_idx,
+	};
+	memcpy(rd.rd_reg.br_addr, random, size);
+	m0_be_reg_area_capture(ra, &rd);
+}
+
+/*
+ * Merges the same random sources with and without a parallel pool and checks
+ * that the resulting segment images are the same.
+ */
+void m0_be_ut_reg_area_merger_parallel(void)
+{
+	static struct m0_be_reg_area  mra[BE_UT_RA_MP_RA_NR];
+	struct m0_be_reg_area_merger  brm_seq = {};
+	struct m0_be_reg_area_merger  brm_par = {};
+	struct m0_be_reg_area         ra_seq;
+	struct m0_be_reg_area         ra_par;
+	struct m0_parallel_pool       pool;
+	struct m0_be_tx_credit        prepared_mra;
+	struct m0_be_tx_credit        prepared_ra = {};
+	struct m0_be_ut_seg           ut_seg;
+	unsigned long                 gen_idx = 0;
+	int                           iter;
+	int                           i;
+	int                           j;
+	int                           rc;
+
+	m0_be_ut_seg_init(&ut_seg, NULL, BE_UT_RA_MP_SEG_SIZE);
+	be_ut_ra_merge_seg  = ut_seg.bus_seg;
+	be_ut_ra_merge_seed = 42;
+
+	prepared_mra = M0_BE_TX_CREDIT(BE_UT_RA_MP_R_NR,
+				       BE_UT_RA_MP_R_NR *
+				       BE_UT_RA_MP_R_SIZE_MAX);
+	m0_be_tx_credit_mac(&prepared_ra, &prepared_mra, BE_UT_RA_MP_RA_NR);
+	for (i = 0; i < ARRAY_SIZE(mra); ++i) {
+		rc = m0_be_reg_area_init(&mra[i], &prepared_mra,
+					 M0_BE_REG_AREA_DATA_COPY);
+		M0_UT_ASSERT(rc == 0);
+	}
+	/* the parallel merge may split regions at the range boundaries */
+	prepared_ra.tc_reg_nr += BE_UT_RA_MP_PART_NR;
+	rc = m0_be_reg_area_init(&ra_seq, &prepared_ra,
+				 M0_BE_REG_AREA_DATA_NOCOPY);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_reg_area_init(&ra_par, &prepared_ra,
+				 M0_BE_REG_AREA_DATA_NOCOPY);
+	M0_UT_ASSERT(rc == 0);
+
+	rc = m0_parallel_pool_init(&pool, BE_UT_RA_MP_THREAD_NR,
+				   BE_UT_RA_MP_PART_NR);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_reg_area_merger_init(&brm_seq, BE_UT_RA_MP_RA_NR);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_reg_area_merger_init(&brm_par, BE_UT_RA_MP_RA_NR);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_reg_area_merger_parallel_init(&brm_par, &pool,
+						 BE_UT_RA_MP_PART_NR);
+	M0_UT_ASSERT(rc == 0);
+
+	for (iter = 0; iter < BE_UT_RA_MP_ITER; ++iter) {
+		m0_be_reg_area_reset(&ra_seq);
+		m0_be_reg_area_reset(&ra_par);
+		m0_be_reg_area_merger_reset(&brm_seq);
+		m0_be_reg_area_merger_reset(&brm_par);
+		for (i = 0; i < ARRAY_SIZE(mra); ++i) {
+			m0_be_reg_area_reset(&mra[i]);
+			for (j = 0; j < BE_UT_RA_MP_R_NR; ++j)
+				be_ut_reg_area_mp_capture(&mra[i], ++gen_idx);
+			m0_be_reg_area_merger_add(&brm_seq, &mra[i]);
+			m0_be_reg_area_merger_add(&brm_par, &mra[i]);
+		}
+		m0_be_reg_area_merger_merge_to(&brm_seq, &ra_seq);
+		m0_be_reg_area_merger_merge_to(&brm_par, &ra_par);
+		/* the sizes above are chosen to always take the parallel path */
+		M0_UT_ASSERT(brm_seq.brm_parallel_nr == 0);
+		M0_UT_ASSERT(brm_par.brm_parallel_nr == iter + 1);
+		be_ut_reg_area_mp_flatten(&ra_seq, be_ut_ra_mp_seq);
+		be_ut_reg_area_mp_flatten(&ra_par, be_ut_ra_mp_par);
+		M0_UT_ASSERT(memcmp(be_ut_ra_mp_seq, be_ut_ra_mp_par,
+				    BE_UT_RA_MP_SPACE) == 0);
+	}
+
+	m0_be_reg_area_merger_fini(&brm_par);
+	m0_be_reg_area_merger_fini(&brm_seq);
+	m0_parallel_pool_terminate_wait(&pool);
+	m0_parallel_pool_fini(&pool);
+	m0_be_reg_area_fini(&ra_par);
+	m0_be_reg_area_fini(&ra_seq);
+	for (i = 0; i < ARRAY_SIZE(mra); ++i)
+		m0_be_reg_area_fini(&mra[i]);
+	m0_be_ut_seg_fini(&ut_seg);
+}
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -29,6 +29,7 @@
 #include "fid/fid.h"
 #include "fid/fid_xc.h"
 #include "lib/types.h"
+#include "lib/types_xc.h"       /* m0_uint128_xc */
 #include "lib/buf.h"
 #include "lib/buf_xc.h"
 #include "lib/cookie.h"
@@ -343,6 +344,11 @@ enum m0_cas_op_flags {
 	 * NO DTM is needed for this operation.
 	 */
 	COF_NO_DTM = 1 << 11,
+	/**
+	 * For NEXT operation, attaches the request to the server-side cursor
+	 * session identified by m0_cas_op::cg_cursor. See m0_cas_cursor.
+	 */
+	COF_CURSOR = 1 << 12,
 };
 
 enum m0_cas_opcode {
@@ -367,6 +373,22 @@ enum m0_cas_type {
 	CT_MEM
 } M0_XCA_ENUM;
 
+/**
+ * Identifies a server-side cursor session of a streaming NEXT.
+ *
+ * A client scanning a catalogue in batches generates a unique cc_id and sends
+ * NEXT requests with COF_CURSOR set and cc_seq equal to 0, 1, 2, ... The
+ * first request (cc_seq == 0) carries the start key, every following request
+ * continues from the last key returned by its predecessor, so the client can
+ * keep several batches in flight without waiting for the replies. The
+ * service executes the requests of a session strictly in cc_seq order and
+ * forgets the session after it has been idle for a while.
+ */
+struct m0_cas_cursor {
+	struct m0_uint128 cc_id;
+	uint64_t          cc_seq;
+} M0_XCA_RECORD M0_XCA_DOMAIN(rpc);
+
 /**
  * CAS-GET, CAS-PUT, CAS-DEL and CAS-CUR fops.
  *
@@ -405,6 +427,9 @@ struct m0_cas_op {
 	 * operation.
 	 */
 	struct m0_dtx0_descriptor cg_descriptor;
+
+	/** Cursor session, valid for CAS-CUR with COF_CURSOR flag only. */
+	struct m0_cas_cursor      cg_cursor;
 } M0_XCA_RECORD M0_XCA_DOMAIN(rpc);
 
 /**
@@ -487,6 +512,28 @@ M0_INTERNAL void m0_cas__ut_svc_dtm0_domain_set(struct m0_reqh_service *svc,
 						struct m0_dtm0_domain  *dod);
 M0_INTERNAL struct m0_be_domain *
 m0_cas__ut_svc_be_get(struct m0_reqh_service *svc);
+/**
+ * Lets up to @nr_max PUT and DEL requests of a locality share a transaction,
+ * waiting for at most @delay for each other. Called before the service is
+ * started. Zero @delay selects the default one.
+ */
+M0_INTERNAL void m0_cas__ut_svc_batch_set(struct m0_reqh_service *svc,
+					  uint32_t                nr_max,
+					  m0_time_t               delay);
+/**
+ * Returns the number of shared transactions opened by the service and the
+ * number of requests executed in them.
+ */
+M0_INTERNAL void m0_cas__ut_svc_batch_stats(struct m0_reqh_service *svc,
+					    uint64_t               *opened,
+					    uint64_t               *members);
+/**
+ * Sets the lease of idle cursor sessions and the time a request waits for its
+ * predecessors in the session.
+ */
+M0_INTERNAL void m0_cas__ut_svc_cursor_set(struct m0_reqh_service *svc,
+					   m0_time_t               lease,
+					   m0_time_t               wait);
 M0_INTERNAL int m0_cas_fom_spawn(
 	struct m0_fom           *lead,
 	struct m0_fom_thralldom *thrall,
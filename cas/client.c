@@ -26,6 +26,7 @@
 #include "lib/vec.h"
 #include "lib/misc.h"    /* M0_IN */
 #include "lib/memory.h"
+#include "lib/uuid.h"    /* m0_uuid_generate */
 #include "sm/sm.h"
 #include "fid/fid.h"     /* m0_fid */
 #include "rpc/item.h"
@@ -1828,11 +1829,12 @@ M0_INTERNAL void m0_cas_get_rep(const struct m0_cas_req *req,
 	M0_LEAVE();
 }
 
-M0_INTERNAL int m0_cas_next(struct m0_cas_req *req,
-			    struct m0_cas_id  *index,
-			    struct m0_bufvec  *start_keys,
-			    uint32_t          *recs_nr,
-			    uint32_t           flags)
+static int cas_next(struct m0_cas_req          *req,
+		    struct m0_cas_id           *index,
+		    struct m0_bufvec           *start_keys,
+		    uint32_t                   *recs_nr,
+		    uint32_t                    flags,
+		    const struct m0_cas_cursor *cursor)
 {
 	struct m0_cas_op      *op;
 	enum m0_cas_req_state  next_state;
@@ -1853,12 +1855,16 @@ M0_INTERNAL int m0_cas_next(struct m0_cas_req *req,
 
 	for (i = 0; i < start_keys->ov_vec.v_nr; i++)
 		max_replies_nr += recs_nr[i];
+	if (cursor != NULL)
+		flags |= COF_CURSOR;
 	rc = cas_req_prep(req, index, start_keys, NULL, max_replies_nr, flags,
 			  &op);
 	if (rc != 0)
 		return M0_ERR(rc);
 	for (i = 0; i < start_keys->ov_vec.v_nr; i++)
 		op->cg_rec.cr_rec[i].cr_rc = recs_nr[i];
+	if (cursor != NULL)
+		op->cg_cursor = *cursor;
 	req->ccr_keys = start_keys;
 	rc = creq_fop_create_and_prepare(req, &cas_cur_fopt, op,
 					 &next_state);
@@ -1869,6 +1875,37 @@ M0_INTERNAL int m0_cas_next(struct m0_cas_req *req,
 	return M0_RC(rc);
 }
 
+M0_INTERNAL int m0_cas_next(struct m0_cas_req *req,
+			    struct m0_cas_id  *index,
+			    struct m0_bufvec  *start_keys,
+			    uint32_t          *recs_nr,
+			    uint32_t           flags)
+{
+	return cas_next(req, index, start_keys, recs_nr, flags, NULL);
+}
+
+M0_INTERNAL void m0_cas_cursor_init(struct m0_cas_cursor *cursor)
+{
+	m0_uuid_generate(&cursor->cc_id);
+	cursor->cc_seq = 0;
+}
+
+M0_INTERNAL int m0_cas_next_cursor(struct m0_cas_req    *req,
+				   struct m0_cas_id     *index,
+				   struct m0_bufvec     *start_key,
+				   uint32_t              recs_nr,
+				   uint32_t              flags,
+				   struct m0_cas_cursor *cursor)
+{
+	int rc;
+
+	M0_PRE(start_key->ov_vec.v_nr == 1);
+	rc = cas_next(req, index, start_key, &recs_nr, flags, cursor);
+	if (rc == 0)
+		cursor->cc_seq++;
+	return M0_RC(rc);
+}
+
 M0_INTERNAL void m0_cas_rep_mlock(const struct m0_cas_req *req,
 				  uint64_t                 idx)
 {
@@ -69,6 +69,7 @@ struct m0_rpc_session;
  * - m0_cas_put()
  * - m0_cas_get()
  * - m0_cas_next()
+ * - m0_cas_next_cursor()
  * - m0_cas_del()
  *
  * If one of the functions above returns non-zero return code, then further
@@ -531,6 +532,36 @@ M0_INTERNAL int m0_cas_next(struct m0_cas_req *req,
 			    uint32_t          *recs_nr,
 			    uint32_t           flags);
 
+/**
+ * Initialises a cursor session for m0_cas_next_cursor() with a new unique
+ * identifier.
+ */
+M0_INTERNAL void m0_cas_cursor_init(struct m0_cas_cursor *cursor);
+
+/**
+ * Gets the next batch of 'recs_nr' records of a streaming scan.
+ *
+ * Works like m0_cas_next() with a single start key, but attaches the request
+ * to the server-side cursor session 'cursor' (see m0_cas_cursor). The first
+ * request of the session starts from 'start_key' according to 'flags', every
+ * following one continues right after the last record returned by the
+ * previous requests: its 'start_key' is ignored, COF_SLANT and
+ * COF_EXCLUDE_START_KEY are implied. Sequence number of the session is
+ * incremented on success, so the next batch can be requested before the reply
+ * to this one is received. All requests of a session should be sent to the
+ * same CAS service.
+ *
+ * @pre start_key->ov_vec.v_nr == 1
+ * @pre m0_cas_req_is_locked(req)
+ * @see m0_cas_next(), m0_cas_cursor_init()
+ */
+M0_INTERNAL int m0_cas_next_cursor(struct m0_cas_req    *req,
+				   struct m0_cas_id     *index,
+				   struct m0_bufvec     *start_key,
+				   uint32_t              recs_nr,
+				   uint32_t              flags,
+				   struct m0_cas_cursor *cursor);
+
 /**
  * Gets execution result of m0_cas_next() request.
  *
@@ -215,6 +215,11 @@ static struct m0_be_op *ctg_beop(struct m0_ctg_op *ctg_op)
 		&ctg_op->co_cur.bc_op : &ctg_op->co_beop;
 }
 
+static struct m0_be_tx *ctg_op_tx(struct m0_ctg_op *ctg_op)
+{
+	return ctg_op->co_tx ?: &ctg_op->co_fom->fo_tx.tx_betx;
+}
+
 /**
  * Returns the number of bytes required to store the given "value"
  * in on-disk format.
@@ -1093,7 +1098,7 @@ static bool ctg_op_cb(struct m0_clink *clink)
 	struct m0_be_op   *op       = ctg_beop(ctg_op);
 	int                opc      = ctg_op->co_opcode;
 	int                ct       = ctg_op->co_ct;
-	struct m0_be_tx   *tx       = &ctg_op->co_fom->fo_tx.tx_betx;
+	struct m0_be_tx   *tx       = ctg_op_tx(ctg_op);
 	struct m0_chan    *ctg_chan = &ctg_op->co_ctg->cc_chan.bch_chan;
 	struct m0_cas_ctg *ctg;
 	int                rc;
@@ -1143,7 +1148,7 @@ static bool ctg_op_cb(struct m0_clink *clink)
 			 */
 			m0_buf_memcpy(&ctg_op->co_mem_buf, &ctg_op->co_val);
 			M0_BE_TX_CAPTURE_BUF(cas_seg(tx->t_engine->eng_domain),
-					     &ctg_op->co_fom->fo_tx.tx_betx,
+					     tx,
 					     &ctg_op->co_mem_buf);
 			break;
 		case CTG_OP_COMBINE(CO_MEM_FREE, CT_MEM):
@@ -1230,7 +1235,7 @@ static int ctg_op_cb_btree(struct m0_btree_cb *cb, struct m0_btree_rec *rec)
 {
 	struct ctg_op_cb_data  *datum    = cb->c_datum;
 	struct m0_ctg_op       *ctg_op   = datum->d_ctg_op;
-	struct m0_be_tx        *tx       = &ctg_op->co_fom->fo_tx.tx_betx;
+	struct m0_be_tx        *tx       = ctg_op_tx(ctg_op);
 	struct m0_chan         *ctg_chan = &ctg_op->co_ctg->cc_chan.bch_chan;
 	int                     opc      = ctg_op->co_opcode;
 	int                     ct       = ctg_op->co_ct;
@@ -1309,7 +1314,7 @@ static int ctg_op_exec_normal(struct m0_ctg_op *ctg_op, int next_phase)
 	struct m0_buf             *key     = &ctg_op->co_key;
 	struct m0_btree           *btree   = ctg_op->co_ctg->cc_tree;
 	struct m0_btree_cursor    *cur     = &ctg_op->co_cur;
-	struct m0_be_tx           *tx      = &ctg_op->co_fom->fo_tx.tx_betx;
+	struct m0_be_tx           *tx      = ctg_op_tx(ctg_op);
 	struct m0_be_op           *beop    = ctg_beop(ctg_op);
 	int                        opc     = ctg_op->co_opcode;
 	int                        ct      = ctg_op->co_ct;
@@ -1543,7 +1548,7 @@ static int ctg_op_exec(struct m0_ctg_op *ctg_op, int next_phase)
 
 static int ctg_mem_op_exec(struct m0_ctg_op *ctg_op, int next_phase)
 {
-	struct m0_be_tx *tx   = &ctg_op->co_fom->fo_tx.tx_betx;
+	struct m0_be_tx *tx   = ctg_op_tx(ctg_op);
 	struct m0_be_op *beop = ctg_beop(ctg_op);
 	int              opc  = ctg_op->co_opcode;
 	int              ct   = ctg_op->co_ct;
@@ -2694,7 +2699,7 @@ static int versioned_put_update_cb(struct m0_btree_cb *cb,
 	struct ver_update_datum *datum       = cb->c_datum;
 	struct m0_ctg_op        *ctg_op      = datum->d_ctg_op;
 	struct m0_crv           *new_version = datum->d_new_version;
-	struct m0_be_tx         *tx          = &ctg_op->co_fom->fo_tx.tx_betx;
+	struct m0_be_tx         *tx          = ctg_op_tx(ctg_op);
 	struct m0_buf            btree_val;
 	m0_bcount_t              ksize;
 
@@ -2722,7 +2727,7 @@ static int versioned_put_sync(struct m0_ctg_op *ctg_op)
 	struct m0_btree_op       kv_op        = {};
 	struct m0_btree         *btree        = ctg_op->co_ctg->cc_tree;
 	struct m0_buf           *key          = &ctg_op->co_key;
-	struct m0_be_tx         *tx           = &ctg_op->co_fom->fo_tx.tx_betx;
+	struct m0_be_tx         *tx           = ctg_op_tx(ctg_op);
 	struct m0_crv            new_version  = M0_CRV_INIT_NONE;
 	struct m0_crv            old_version  = M0_CRV_INIT_NONE;
 	struct m0_btree_rec      rec          = {
@@ -273,6 +273,12 @@ struct m0_ctg_op {
 	 * See ::COF_VERSIONED for details.
 	 */
 	bool                      co_is_versioned;
+	/**
+	 * Transaction the operation is executed in. NULL means the
+	 * transaction of the caller FOM (m0_ctg_op::co_fom). Set after
+	 * m0_ctg_op_init() by callers sharing a transaction between FOMs.
+	 */
+	struct m0_be_tx          *co_tx;
 };
 
 #define CTG_OP_COMBINE(opc, ct) (((uint64_t)(opc)) | ((ct) << 16))
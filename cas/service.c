@@ -32,11 +32,15 @@
 #include "lib/finject.h"
 #include "lib/assert.h"
 #include "lib/arith.h"               /* min_check, M0_3WAY */
+#include "lib/atomic.h"
 #include "lib/misc.h"                /* M0_IN */
 #include "lib/errno.h"               /* ENOMEM, EPROTO */
 #include "lib/ext.h"
+#include "lib/string.h"              /* getenv */
 #include "fop/fom_long_lock.h"
 #include "fop/fom_generic.h"
+#include "fol/fol.h"                 /* FOL_REC_MAXSIZE */
+#include "fdmi/fol_fdmi_src.h"       /* m0_fol_fdmi_is_posting */
 #include "fop/fom_interpose.h"
 #include "reqh/reqh_service.h"
 #include "reqh/reqh.h"               /* m0_reqh */
@@ -313,6 +317,102 @@ enum {
 	INVALID_CAS_SDEV_ID = UINT32_MAX
 };
 
+enum {
+	/** Maximal number of cursor sessions kept by a CAS service. */
+	CAS_CURSOR_NR_MAX    = 1024,
+	/** Seconds an idle cursor session is kept for. */
+	CAS_CURSOR_LEASE_SEC = 30,
+	/** Seconds a request waits for its predecessors in the session. */
+	CAS_CURSOR_WAIT_SEC  = 10
+};
+
+enum {
+	/** Upper limit on the number of requests sharing a transaction. */
+	CAS_BATCH_NR_MAX       = 256,
+	/** Default time a shared transaction waits for new members. */
+	CAS_BATCH_DELAY_USEC   = 200,
+	/**
+	 * Limit on the total size of member requests. The FOL record of a
+	 * shared transaction holds all of them (and their replies, and values
+	 * of deleted records) in FOL_REC_MAXSIZE bytes of payload.
+	 */
+	CAS_BATCH_PAYLOAD_MAX  = FOL_REC_MAXSIZE / 4
+};
+
+/**
+ * Server-side state of a streaming NEXT, see m0_cas_cursor.
+ *
+ * The session doesn't keep a btree cursor open between requests: btree
+ * cursors are bound to the fom and the long lock taken by it. Instead it
+ * keeps the last key returned to the client, and every request of the session
+ * positions the cursor right after this key. The session serialises its
+ * requests, so the client doesn't need to wait for the reply to the previous
+ * batch to know where the next one starts.
+ *
+ * Sessions are protected by cas_service::c_cursor_lock.
+ */
+struct cas_cursor {
+	struct m0_uint128 cc_id;
+	/** Catalogue iterated by the session. */
+	struct m0_fid     cc_fid;
+	/** Sequence number of the next request to be executed. */
+	uint64_t          cc_seq;
+	/** Last key returned to the client. */
+	struct m0_buf     cc_key;
+	/** Sticky error, fails all following requests of the session. */
+	int               cc_rc;
+	/** The session is forgotten after this time if no foms use it. */
+	m0_time_t         cc_expire;
+	/** Number of foms attached to the session. */
+	uint32_t          cc_ref;
+	struct m0_tlink   cc_linkage;
+	uint64_t          cc_magic;
+};
+
+M0_TL_DESCR_DEFINE(cas_cursor, "cas cursor sessions", static,
+		   struct cas_cursor, cc_linkage, cc_magic,
+		   M0_CAS_CURSOR_MAGIC, M0_CAS_CURSOR_HEAD_MAGIC);
+M0_TL_DEFINE(cas_cursor, static, struct cas_cursor);
+
+/**
+ * BE transaction shared by PUT and DEL requests executed in a locality.
+ *
+ * Requests which would otherwise open a transaction each join the batch of
+ * their locality in CAS_PREP instead. The first member (the leader) opens the
+ * transaction when the batch is full, when no other batchable request of the
+ * locality is on its way to CAS_PREP, or after cas_service::c_batch_delay.
+ * The last member to finish its updates closes the transaction, every member
+ * replies once it is closed. The batch is freed when the transaction is done
+ * and all members are past M0_FOPH_TXN_DONE_WAIT.
+ *
+ * A batch is only accessed by foms of its locality, under the locality lock.
+ */
+struct cas_batch {
+	struct m0_dtx     cb_tx;
+	/** Sum of request payload sizes of the members. */
+	m0_bcount_t       cb_payload;
+	struct cas_fom   *cb_leader;
+	uint32_t          cb_nr;
+	/** Members which have not finished their updates yet. */
+	uint32_t          cb_active;
+	/** Members which have not passed M0_FOPH_TXN_DONE_WAIT yet. */
+	uint32_t          cb_ref;
+	/** No more members are accepted. */
+	bool              cb_sealed;
+	/** The leader opens the transaction at this time at the latest. */
+	m0_time_t         cb_deadline;
+	/** Signalled when the batch is joined, sealed or opened. */
+	struct m0_chan    cb_chan;
+};
+
+/** Batching state of a locality, protected by the locality lock. */
+struct cas_batch_loc {
+	/** Batch accepting new members, if any. */
+	struct cas_batch *bl_cur;
+	/** Batchable foms of the locality which have not joined a batch yet. */
+	uint32_t          bl_pending;
+};
+
 struct cas_service {
 	struct m0_reqh_service  c_service;
 	struct m0_be_domain    *c_be_domain;
@@ -325,6 +425,29 @@ struct cas_service {
 	 */
 	uint32_t                c_sdev_id;
 	struct m0_dtm0_domain  *c_dtm0_domain;
+	/** List of cursor sessions, linked through cas_cursor::cc_linkage. */
+	struct m0_tl            c_cursors;
+	uint32_t                c_cursors_nr;
+	struct m0_mutex         c_cursor_lock;
+	/** Signalled when a fom releases its cursor session. */
+	struct m0_chan          c_cursor_chan;
+	/** Idle cursor session lifetime, CAS_CURSOR_LEASE_SEC by default. */
+	m0_time_t               c_cursor_lease;
+	/** Cursor wait bound, CAS_CURSOR_WAIT_SEC by default. */
+	m0_time_t               c_cursor_wait;
+	/**
+	 * Maximal number of requests sharing a transaction, batching is
+	 * disabled if it is less than 2. See cas_batch.
+	 */
+	uint32_t                c_batch_nr_max;
+	m0_time_t               c_batch_delay;
+	/** Batching states indexed by locality, NULL if batching is off. */
+	struct cas_batch_loc   *c_batch_locs;
+	uint32_t                c_batch_locs_nr;
+	/** Number of shared transactions opened. */
+	struct m0_atomic64      c_batch_opened;
+	/** Number of requests executed in shared transactions. */
+	struct m0_atomic64      c_batch_members;
 };
 
 struct cas_kv {
@@ -386,6 +509,26 @@ struct cas_fom {
 				       	     [STATS_KV_IO_NR]
 				       	     [STATS_NR];
 	struct m0_dtm0_redo      *cf_redo;
+	/* Cursor session fields, used with COF_CURSOR only. */
+	struct cas_cursor        *cf_cursor;
+	/** Start key of the batch, owned by the fom. */
+	struct m0_buf             cf_cursor_key;
+	/** Key of the last record successfully returned in the batch. */
+	struct m0_buf             cf_cursor_last;
+	int                       cf_cursor_rc;
+	/** The fom is the one executing the current request of the session. */
+	bool                      cf_cursor_turn;
+	m0_time_t                 cf_cursor_deadline;
+	struct m0_sm_timer        cf_cursor_timer;
+	bool                      cf_cursor_timer_started;
+	/* Shared transaction fields, see cas_batch. */
+	struct cas_batch         *cf_batch;
+	/** The fom is counted in cas_batch_loc::bl_pending. */
+	bool                      cf_batch_pending;
+	/** The fom is counted in cas_batch::cb_active. */
+	bool                      cf_batch_active;
+	struct m0_sm_timer        cf_batch_timer;
+	bool                      cf_batch_timer_started;
 };
 
 enum cas_fom_phase {
@@ -427,6 +570,9 @@ enum cas_fom_phase {
 	CAS_IDROP_LOCKED,
 	CAS_IDROP_START_GC,
 	CAS_DTM0,
+	CAS_CURSOR_WAIT,
+	CAS_BATCH_OPEN,
+	CAS_BATCH_DONE,
 	CAS_NR
 };
 
@@ -521,6 +667,18 @@ static int cas_ctidx_lookup(struct cas_fom *fom, const struct m0_cas_id *in_cid,
 			    int next);
 static int cas_ctidx_delete(struct cas_fom *fom, const struct m0_cas_id *in_cid,
 			    int next);
+static int cas_cursor_wait(struct cas_fom *fom);
+static void cas_cursor_last_set(struct cas_fom *fom);
+static void cas_cursor_release(struct cas_fom *fom);
+static bool cas_batch_eligible(const struct cas_fom *fom);
+static void cas_batch_pend(struct cas_fom *fom);
+static void cas_batch_unpend(struct cas_fom *fom);
+static int  cas_batch_join(struct cas_fom *fom,
+			   const struct m0_be_tx_credit *cred);
+static int  cas_batch_open(struct cas_fom *fom);
+static int  cas_batch_done(struct cas_fom *fom);
+static int  cas_batch_put(struct cas_fom *fom);
+static void cas_fom_failure(struct cas_fom *fom, int rc, bool ctg_op_fini);
 static int cas_redo_alloc(struct m0_fom *fom0, struct m0_dtm0_redo **out);
 static void cas_redo_free0(struct m0_dtm0_redo **redo);
 
@@ -537,6 +695,7 @@ M0_INTERNAL void m0_cas_svc_init(void)
 			  m0_generic_conf.scf_nr_states);
 	m0_sm_conf_trans_extend(&m0_generic_conf, &cas_sm_conf);
 	cas_fom_phases[M0_FOPH_INIT].sd_allowed |= M0_BITS(CAS_CHECK_PRE);
+	cas_fom_phases[M0_FOPH_TXN_INIT].sd_allowed |= M0_BITS(CAS_START);
 	cas_fom_phases[M0_FOPH_TXN_OPEN].sd_allowed |= M0_BITS(CAS_START);
 	cas_fom_phases[M0_FOPH_QUEUE_REPLY].sd_allowed |=
 		M0_BITS(M0_FOPH_TXN_LOGGED_WAIT);
@@ -582,6 +741,68 @@ m0_cas__ut_svc_be_get(struct m0_reqh_service *svc)
 	return service->c_be_domain;
 }
 
+M0_INTERNAL void m0_cas__ut_svc_batch_set(struct m0_reqh_service *svc,
+					  uint32_t                nr_max,
+					  m0_time_t               delay)
+{
+	struct cas_service *service = M0_AMB(service, svc, c_service);
+
+	M0_PRE(service->c_batch_locs == NULL);
+	service->c_batch_nr_max = nr_max;
+	service->c_batch_delay  = delay;
+}
+
+M0_INTERNAL void m0_cas__ut_svc_batch_stats(struct m0_reqh_service *svc,
+					    uint64_t               *opened,
+					    uint64_t               *members)
+{
+	struct cas_service *service = M0_AMB(service, svc, c_service);
+
+	*opened  = m0_atomic64_get(&service->c_batch_opened);
+	*members = m0_atomic64_get(&service->c_batch_members);
+}
+
+M0_INTERNAL void m0_cas__ut_svc_cursor_set(struct m0_reqh_service *svc,
+					   m0_time_t               lease,
+					   m0_time_t               wait)
+{
+	struct cas_service *service = M0_AMB(service, svc, c_service);
+
+	m0_mutex_lock(&service->c_cursor_lock);
+	service->c_cursor_lease = lease;
+	service->c_cursor_wait  = wait;
+	m0_mutex_unlock(&service->c_cursor_lock);
+}
+
+/**
+ * Sets up shared transactions of PUT and DEL requests, see cas_batch.
+ *
+ * Batching is off, unless it is enabled by m0_cas__ut_svc_batch_set() or
+ * the M0_CAS_BATCH_NR environment variable, giving the maximal number of
+ * requests in a batch.
+ */
+static int cas_service_batch_init(struct cas_service *service)
+{
+	const char *env = getenv("M0_CAS_BATCH_NR");
+
+	if (service->c_batch_nr_max == 0 && env != NULL)
+		service->c_batch_nr_max = strtoul(env, NULL, 0);
+	service->c_batch_nr_max = min_check(service->c_batch_nr_max,
+					    (uint32_t)CAS_BATCH_NR_MAX);
+	if (service->c_batch_nr_max < 2)
+		return M0_RC(0);
+	if (service->c_batch_delay == 0)
+		service->c_batch_delay = M0_MKTIME(0, CAS_BATCH_DELAY_USEC *
+						  1000);
+	service->c_batch_locs_nr = m0_fom_dom()->fd_localities_nr;
+	M0_ALLOC_ARR(service->c_batch_locs, service->c_batch_locs_nr);
+	if (service->c_batch_locs == NULL)
+		return M0_ERR(-ENOMEM);
+	M0_LOG(M0_NOTICE, "Batching of up to %u requests, delay "TIME_F,
+	       service->c_batch_nr_max, TIME_P(service->c_batch_delay));
+	return M0_RC(0);
+}
+
 static int cas_service_sdev_id_set(struct cas_service *cas_svc)
 {
 	struct m0_reqh         *reqh;
@@ -671,6 +892,8 @@ static int cas_service_start(struct m0_reqh_service *svc)
 		m0_cas_gc_start(svc);
 		rc = cas_service_sdev_id_set(service);
 	}
+	if (rc == 0)
+		rc = cas_service_batch_init(service);
 	return rc;
 }
 
@@ -689,9 +912,25 @@ static void cas_service_stop(struct m0_reqh_service *svc)
 static void cas_service_fini(struct m0_reqh_service *svc)
 {
 	struct cas_service *service = M0_AMB(service, svc, c_service);
+	struct cas_cursor  *cur;
 
 	M0_PRE(M0_IN(m0_reqh_service_state_get(svc),
 		     (M0_RST_STOPPED, M0_RST_FAILED)));
+	M0_ASSERT(service->c_batch_locs == NULL ||
+		  m0_forall(i, service->c_batch_locs_nr,
+			    service->c_batch_locs[i].bl_cur == NULL &&
+			    service->c_batch_locs[i].bl_pending == 0));
+	m0_free(service->c_batch_locs);
+	m0_tl_teardown(cas_cursor, &service->c_cursors, cur) {
+		M0_ASSERT(cur->cc_ref == 0);
+		m0_buf_free(&cur->cc_key);
+		m0_free(cur);
+	}
+	cas_cursor_tlist_fini(&service->c_cursors);
+	m0_mutex_lock(&service->c_cursor_lock);
+	m0_chan_fini(&service->c_cursor_chan);
+	m0_mutex_unlock(&service->c_cursor_lock);
+	m0_mutex_fini(&service->c_cursor_lock);
 	m0_free(service);
 }
 
@@ -705,11 +944,550 @@ static int cas_service_type_allocate(struct m0_reqh_service **svc,
 		*svc = &service->c_service;
 		(*svc)->rs_type = stype;
 		(*svc)->rs_ops  = &cas_service_ops;
+		cas_cursor_tlist_init(&service->c_cursors);
+		m0_mutex_init(&service->c_cursor_lock);
+		m0_chan_init(&service->c_cursor_chan,
+			     &service->c_cursor_lock);
+		m0_atomic64_set(&service->c_batch_opened, 0);
+		m0_atomic64_set(&service->c_batch_members, 0);
+		service->c_cursor_lease = M0_MKTIME(CAS_CURSOR_LEASE_SEC, 0);
+		service->c_cursor_wait  = M0_MKTIME(CAS_CURSOR_WAIT_SEC, 0);
 		return M0_RC(0);
 	} else
 		return M0_ERR(-ENOMEM);
 }
 
+static struct cas_service *cas_fom_service(const struct cas_fom *fom)
+{
+	struct cas_service *service;
+
+	return M0_AMB(service, fom->cf_fom.fo_service, c_service);
+}
+
+/**
+ * Finds the session with the given identifier, forgetting expired sessions
+ * on the way. An expired session is forgotten even if it is the one looked
+ * for: a request arriving after the lease starts a new session.
+ */
+static struct cas_cursor *cas_cursor_find(struct cas_service      *service,
+					  const struct m0_uint128 *id,
+					  m0_time_t                now)
+{
+	struct cas_cursor *found = NULL;
+	struct cas_cursor *cur;
+
+	M0_PRE(m0_mutex_is_locked(&service->c_cursor_lock));
+	m0_tl_for(cas_cursor, &service->c_cursors, cur) {
+		if (cur->cc_ref == 0 && cur->cc_expire < now) {
+			cas_cursor_tlink_del_fini(cur);
+			m0_buf_free(&cur->cc_key);
+			m0_free(cur);
+			service->c_cursors_nr--;
+		} else if (m0_uint128_eq(&cur->cc_id, id))
+			found = cur;
+	} m0_tl_endfor;
+	return found;
+}
+
+/**
+ * Attaches the fom to the session named in the request, creating the session
+ * if this is the first request of it to arrive.
+ */
+static int cas_cursor_attach(struct cas_fom *fom, m0_time_t now)
+{
+	struct cas_service *service = cas_fom_service(fom);
+	struct m0_cas_op   *op      = cas_op(&fom->cf_fom);
+	struct cas_cursor  *cur;
+
+	M0_PRE(fom->cf_cursor == NULL);
+
+	cur = cas_cursor_find(service, &op->cg_cursor.cc_id, now);
+	if (cur == NULL) {
+		if (service->c_cursors_nr >= CAS_CURSOR_NR_MAX)
+			return M0_ERR(-EBUSY);
+		M0_ALLOC_PTR(cur);
+		if (cur == NULL)
+			return M0_ERR(-ENOMEM);
+		cur->cc_id  = op->cg_cursor.cc_id;
+		cur->cc_fid = op->cg_id.ci_fid;
+		cas_cursor_tlink_init_at_tail(cur, &service->c_cursors);
+		service->c_cursors_nr++;
+	} else if (!m0_fid_eq(&cur->cc_fid, &op->cg_id.ci_fid))
+		return M0_ERR_INFO(-EPROTO, "Cursor "U128X_F" is bound to "
+				   FID_F, U128_P(&cur->cc_id),
+				   FID_P(&cur->cc_fid));
+	cur->cc_ref++;
+	cur->cc_expire = m0_time_add(now, service->c_cursor_lease);
+	fom->cf_cursor = cur;
+	m0_sm_timer_init(&fom->cf_cursor_timer);
+	fom->cf_cursor_deadline = m0_time_add(now, service->c_cursor_wait);
+	return M0_RC(0);
+}
+
+static void cas_cursor_timer_cb(struct m0_sm_timer *timer)
+{
+	struct cas_fom     *fom     = M0_AMB(fom, timer, cf_cursor_timer);
+	struct m0_fom      *fom0    = &fom->cf_fom;
+	struct cas_service *service = cas_fom_service(fom);
+	bool                waiting;
+
+	m0_mutex_lock(&service->c_cursor_lock);
+	/*
+	 * The session channel may have woken the fom already, otherwise
+	 * cancel the wait and wake the fom up to fail the request.
+	 */
+	waiting = m0_fom_is_waiting_on(fom0);
+	if (waiting)
+		m0_fom_callback_cancel(&fom0->fo_cb);
+	m0_mutex_unlock(&service->c_cursor_lock);
+	if (waiting)
+		m0_fom_ready(fom0);
+}
+
+/**
+ * Checks whether the fom's request is the next one in its session.
+ *
+ * Returns 0 and prepares the request for execution if it is, -EAGAIN if the
+ * fom should wait for the preceding requests.
+ */
+static int cas_cursor_turn(struct cas_fom *fom, m0_time_t now)
+{
+	struct m0_cas_op  *op  = cas_op(&fom->cf_fom);
+	struct cas_cursor *cur = fom->cf_cursor;
+	uint64_t           seq = op->cg_cursor.cc_seq;
+	int                rc  = 0;
+
+	M0_PRE(m0_mutex_is_locked(&cas_fom_service(fom)->c_cursor_lock));
+
+	if (cur->cc_rc != 0)
+		return M0_ERR(cur->cc_rc);
+	if (seq < cur->cc_seq)
+		return M0_ERR_INFO(-EPROTO, "Stale request %"PRIu64" of "
+				   "cursor "U128X_F, seq, U128_P(&cur->cc_id));
+	if (seq > cur->cc_seq)
+		return now < fom->cf_cursor_deadline ?
+			-EAGAIN : M0_ERR(-ETIMEDOUT);
+	if (seq > 0) {
+		/* Continue right after the last returned key. */
+		rc = m0_buf_copy(&fom->cf_cursor_key, &cur->cc_key);
+		op->cg_flags |= COF_SLANT | COF_EXCLUDE_START_KEY;
+	}
+	cur->cc_expire = m0_time_add(now, cas_fom_service(fom)->c_cursor_lease);
+	fom->cf_cursor_turn = true;
+	fom->cf_cursor_rc   = rc;
+	if (rc == 0)
+		m0_fom_phase_set(&fom->cf_fom, M0_FOPH_INIT);
+	return M0_RC(rc);
+}
+
+/**
+ * Waits until all requests of the session preceding the fom's request are
+ * executed.
+ *
+ * Requests of a session may arrive in any order and are executed by foms in
+ * different localities, so a fom which is not next in the session waits on
+ * cas_service::c_cursor_chan for at most cas_service::c_cursor_wait.
+ */
+static int cas_cursor_wait(struct cas_fom *fom)
+{
+	struct m0_fom      *fom0    = &fom->cf_fom;
+	struct cas_service *service = cas_fom_service(fom);
+	m0_time_t           now     = m0_time_now();
+	int                 result  = M0_FSO_AGAIN;
+	int                 rc      = 0;
+
+	if (fom->cf_cursor_timer_started) {
+		m0_sm_timer_cancel(&fom->cf_cursor_timer);
+		m0_sm_timer_fini(&fom->cf_cursor_timer);
+		m0_sm_timer_init(&fom->cf_cursor_timer);
+		fom->cf_cursor_timer_started = false;
+	}
+	m0_mutex_lock(&service->c_cursor_lock);
+	if (fom->cf_cursor == NULL)
+		rc = cas_cursor_attach(fom, now);
+	if (rc == 0)
+		rc = cas_cursor_turn(fom, now);
+	if (rc == -EAGAIN) {
+		m0_fom_wait_on(fom0, &service->c_cursor_chan, &fom0->fo_cb);
+		rc = m0_sm_timer_start(&fom->cf_cursor_timer,
+				       &fom0->fo_loc->fl_group,
+				       cas_cursor_timer_cb,
+				       fom->cf_cursor_deadline);
+		if (rc == 0) {
+			fom->cf_cursor_timer_started = true;
+			result = M0_FSO_WAIT;
+		} else
+			m0_fom_callback_cancel(&fom0->fo_cb);
+	}
+	m0_mutex_unlock(&service->c_cursor_lock);
+	if (rc != 0)
+		m0_fom_phase_move(fom0, rc, M0_FOPH_FAILURE);
+	return result;
+}
+
+/**
+ * Sets the start key of the batch: the last key returned by the session for
+ * continuation requests, the key from the request for the first one.
+ */
+static int cas_cursor_key_setup(struct cas_fom *fom)
+{
+	struct m0_buf *key = &fom->cf_ikv[0].ckv_key;
+	int            rc  = 0;
+
+	if (cas_op(&fom->cf_fom)->cg_cursor.cc_seq > 0)
+		*key = fom->cf_cursor_key;
+	else {
+		rc = m0_buf_copy(&fom->cf_cursor_key, key);
+		if (rc != 0)
+			fom->cf_cursor_rc = rc;
+	}
+	return M0_RC(rc);
+}
+
+/**
+ * Remembers the key of the record just returned to the client, the next
+ * request of the session starts after it.
+ */
+static void cas_cursor_last_set(struct cas_fom *fom)
+{
+	m0_buf_free(&fom->cf_cursor_last);
+	if (fom->cf_cursor_rc == 0)
+		fom->cf_cursor_rc = m0_buf_copy(&fom->cf_cursor_last,
+						&fom->cf_out_key);
+}
+
+/**
+ * Detaches the fom from its session and lets the next request of the session
+ * proceed.
+ *
+ * The session advances to the next sequence number even if the request
+ * failed, the key is advanced only past the records actually returned.
+ */
+static void cas_cursor_release(struct cas_fom *fom)
+{
+	struct m0_fom      *fom0    = &fom->cf_fom;
+	struct m0_cas_op   *op      = cas_op(fom0);
+	struct cas_service *service = cas_fom_service(fom);
+	struct cas_cursor  *cur     = fom->cf_cursor;
+	uint64_t            seq     = op->cg_cursor.cc_seq;
+
+	if (fom->cf_cursor_timer_started)
+		m0_sm_timer_cancel(&fom->cf_cursor_timer);
+	m0_sm_timer_fini(&fom->cf_cursor_timer);
+
+	m0_mutex_lock(&service->c_cursor_lock);
+	if (fom->cf_cursor_turn) {
+		M0_ASSERT(seq == cur->cc_seq);
+		if (fom->cf_cursor_rc != 0)
+			cur->cc_rc = fom->cf_cursor_rc;
+		else if (m0_buf_is_set(&fom->cf_cursor_last))
+			M0_SWAP(cur->cc_key, fom->cf_cursor_last);
+		else if (seq == 0 && m0_buf_is_set(&fom->cf_cursor_key))
+			M0_SWAP(cur->cc_key, fom->cf_cursor_key);
+		else if (seq == 0)
+			/* The start key is unknown, nothing to continue. */
+			cur->cc_rc = m0_fom_rc(fom0) ?: -EPROTO;
+		cur->cc_seq++;
+		m0_chan_broadcast(&service->c_cursor_chan);
+	}
+	cur->cc_ref--;
+	cur->cc_expire = m0_time_add(m0_time_now(), service->c_cursor_lease);
+	m0_mutex_unlock(&service->c_cursor_lock);
+	fom->cf_cursor = NULL;
+	m0_buf_free(&fom->cf_cursor_key);
+	m0_buf_free(&fom->cf_cursor_last);
+}
+
+static struct cas_batch_loc *cas_batch_loc(const struct cas_fom *fom)
+{
+	struct cas_service *service = cas_fom_service(fom);
+	int                 idx     = fom->cf_fom.fo_loc->fl_idx;
+
+	M0_PRE(0 <= idx && idx < service->c_batch_locs_nr);
+	return &service->c_batch_locs[idx];
+}
+
+/**
+ * Requests which need something else than a plain BE transaction (DTM0,
+ * synchronous replies, index operations) keep their own transactions.
+ *
+ * So do all requests while FDMI records are posted: the FOL record of a batch
+ * belongs to the shared transaction, and members, whose own fo_tx is never
+ * opened, would post no FDMI record. The check is made when a request is
+ * about to open its transaction, so a batch formed just before FDMI filters
+ * are defined may still go unposted, as may any request executed then.
+ */
+static bool cas_batch_eligible(const struct cas_fom *fom)
+{
+	const struct m0_fom *fom0 = &fom->cf_fom;
+	struct m0_cas_op    *op   = cas_op(fom0);
+
+	return !ENABLE_DTM0 && cas_fom_service(fom)->c_batch_locs != NULL &&
+		!fom0->fo_local &&
+		M0_IN(m0_cas_opcode(fom0->fo_fop), (CO_PUT, CO_DEL)) &&
+		cas_type(fom0) == CT_BTREE &&
+		!(op->cg_flags & COF_SYNC_WAIT) &&
+		m0_dtm0_tx_desc_is_none(&op->cg_txd) &&
+		!m0_fol_fdmi_is_posting();
+}
+
+static void cas_batch_pend(struct cas_fom *fom)
+{
+	M0_PRE(!fom->cf_batch_pending && fom->cf_batch == NULL);
+	cas_batch_loc(fom)->bl_pending++;
+	fom->cf_batch_pending = true;
+}
+
+static void cas_batch_unpend(struct cas_fom *fom)
+{
+	struct cas_batch_loc *loc;
+
+	if (!fom->cf_batch_pending)
+		return;
+	loc = cas_batch_loc(fom);
+	M0_CNT_DEC(loc->bl_pending);
+	fom->cf_batch_pending = false;
+	/* The leader may be waiting for this fom. */
+	if (loc->bl_pending == 0 && loc->bl_cur != NULL)
+		m0_chan_broadcast(&loc->bl_cur->cb_chan);
+}
+
+static void cas_batch_seal(struct cas_batch_loc *loc, struct cas_batch *b)
+{
+	b->cb_sealed = true;
+	if (loc->bl_cur == b)
+		loc->bl_cur = NULL;
+	m0_chan_broadcast(&b->cb_chan);
+}
+
+static void cas_batch_free(struct cas_batch *b)
+{
+	struct m0_be_tx *tx = &b->cb_tx.tx_betx;
+
+	M0_PRE(b->cb_ref == 0);
+	if (m0_be_tx_state(tx) == M0_BTS_PREPARE) {
+		/* Never opened, move it to FAILED like fom_failure() does. */
+		m0_be_tx_prep(tx, &m0_be_tx_credit_invalid);
+		m0_be_tx_open(tx);
+	}
+	M0_ASSERT(M0_IN(m0_be_tx_state(tx), (M0_BTS_DONE, M0_BTS_FAILED)));
+	m0_dtx_fini(&b->cb_tx);
+	m0_chan_fini(&b->cb_chan);
+	m0_free(b);
+}
+
+static int cas_batch_alloc(struct cas_fom *fom)
+{
+	struct m0_fom        *fom0    = &fom->cf_fom;
+	struct cas_service   *service = cas_fom_service(fom);
+	struct cas_batch_loc *loc     = cas_batch_loc(fom);
+	struct cas_batch     *b;
+
+	M0_PRE(loc->bl_cur == NULL);
+	M0_ALLOC_PTR(b);
+	if (b == NULL)
+		return M0_ERR(-ENOMEM);
+	m0_dtx_init(&b->cb_tx, service->c_be_domain, &fom0->fo_loc->fl_group);
+	m0_be_tx_payload_prep(&b->cb_tx.tx_betx, FOL_REC_MAXSIZE);
+	m0_chan_init(&b->cb_chan, &fom0->fo_loc->fl_group.s_lock);
+	b->cb_leader   = fom;
+	b->cb_deadline = m0_time_add(m0_time_now(), service->c_batch_delay);
+	m0_sm_timer_init(&fom->cf_batch_timer);
+	loc->bl_cur = b;
+	return M0_RC(0);
+}
+
+/**
+ * Adds the fom, needing @cred for its updates, to the batch of its locality.
+ * A new batch is started if there is no batch accepting members, or if the
+ * fom doesn't fit into the current one.
+ */
+static int cas_batch_join(struct cas_fom               *fom,
+			  const struct m0_be_tx_credit *cred)
+{
+	struct m0_fom        *fom0    = &fom->cf_fom;
+	struct cas_service   *service = cas_fom_service(fom);
+	struct cas_batch_loc *loc     = cas_batch_loc(fom);
+	struct cas_batch     *b       = loc->bl_cur;
+	m0_bcount_t           payload;
+	int                   rc;
+
+	M0_PRE(fom->cf_batch_pending);
+	payload = m0_rpc_item_payload_size(m0_fop_to_rpc_item(fom0->fo_fop));
+	if (b != NULL &&
+	    (m0_be_should_break(&service->c_be_domain->bd_engine,
+				&b->cb_tx.tx_betx_cred, cred) ||
+	     b->cb_payload + payload > CAS_BATCH_PAYLOAD_MAX))
+		cas_batch_seal(loc, b);
+	if (loc->bl_cur == NULL) {
+		rc = cas_batch_alloc(fom);
+		if (rc != 0)
+			return M0_ERR(rc);
+	}
+	b = loc->bl_cur;
+	rc = m0_fop_fol_add(fom0->fo_fop, fom0->fo_rep_fop, &b->cb_tx);
+	if (rc != 0) {
+		if (b->cb_nr == 0) {
+			cas_batch_seal(loc, b);
+			m0_sm_timer_fini(&fom->cf_batch_timer);
+			cas_batch_free(b);
+		}
+		return M0_ERR(rc);
+	}
+	m0_be_tx_credit_add(&b->cb_tx.tx_betx_cred, cred);
+	b->cb_payload += payload;
+	b->cb_nr++;
+	b->cb_active++;
+	b->cb_ref++;
+	fom->cf_batch = b;
+	fom->cf_batch_active = true;
+	cas_batch_unpend(fom);
+	if (b->cb_nr >= service->c_batch_nr_max)
+		cas_batch_seal(loc, b);
+	return M0_RC(0);
+}
+
+static void cas_batch_timer_cb(struct m0_sm_timer *timer)
+{
+	struct cas_fom *fom  = M0_AMB(fom, timer, cf_batch_timer);
+	struct m0_fom  *fom0 = &fom->cf_fom;
+
+	/* Executed under the locality lock, as the fom ticks are. */
+	if (m0_fom_is_waiting_on(fom0)) {
+		m0_fom_callback_cancel(&fom0->fo_cb);
+		m0_fom_ready(fom0);
+	}
+}
+
+static void cas_batch_timer_stop(struct cas_fom *fom)
+{
+	if (fom->cf_batch_timer_started) {
+		m0_sm_timer_cancel(&fom->cf_batch_timer);
+		m0_sm_timer_fini(&fom->cf_batch_timer);
+		m0_sm_timer_init(&fom->cf_batch_timer);
+		fom->cf_batch_timer_started = false;
+	}
+}
+
+/**
+ * Waits until the shared transaction is open. The leader opens it once the
+ * batch is complete, see cas_batch.
+ */
+static int cas_batch_open(struct cas_fom *fom)
+{
+	struct m0_fom        *fom0 = &fom->cf_fom;
+	struct cas_batch     *b    = fom->cf_batch;
+	struct m0_be_tx      *tx   = &b->cb_tx.tx_betx;
+	struct cas_batch_loc *loc  = cas_batch_loc(fom);
+	bool                  lead = b->cb_leader == fom;
+	int                   rc;
+
+	if (lead)
+		cas_batch_timer_stop(fom);
+	switch (m0_be_tx_state(tx)) {
+	case M0_BTS_PREPARE:
+		if (lead && (b->cb_sealed || loc->bl_pending == 0 ||
+			     m0_time_now() >= b->cb_deadline)) {
+			cas_batch_seal(loc, b);
+			m0_sm_timer_fini(&fom->cf_batch_timer);
+			m0_atomic64_inc(&cas_fom_service(fom)->c_batch_opened);
+			m0_atomic64_add(&cas_fom_service(fom)->c_batch_members,
+					b->cb_nr);
+			m0_dtx_open(&b->cb_tx);
+			m0_chan_broadcast(&b->cb_chan);
+			return M0_FSO_AGAIN;
+		}
+		m0_fom_wait_on(fom0, &b->cb_chan, &fom0->fo_cb);
+		if (lead) {
+			rc = m0_sm_timer_start(&fom->cf_batch_timer,
+					       &fom0->fo_loc->fl_group,
+					       cas_batch_timer_cb,
+					       b->cb_deadline);
+			if (rc != 0) {
+				/* Don't wait for more members then. */
+				m0_fom_callback_cancel(&fom0->fo_cb);
+				b->cb_sealed = true;
+				return M0_FSO_AGAIN;
+			}
+			fom->cf_batch_timer_started = true;
+		}
+		return M0_FSO_WAIT;
+	case M0_BTS_OPENING:
+	case M0_BTS_GROUPING:
+		m0_fom_wait_on(fom0, &tx->t_sm.sm_chan, &fom0->fo_cb);
+		return M0_FSO_WAIT;
+	case M0_BTS_ACTIVE:
+		if (b->cb_tx.tx_state == M0_DTX_INIT)
+			m0_dtx_opened(&b->cb_tx);
+		m0_fom_phase_set(fom0, CAS_TXN_OPENED);
+		return M0_FSO_AGAIN;
+	default:
+		M0_ASSERT(m0_be_tx_state(tx) == M0_BTS_FAILED);
+		cas_fom_failure(fom, M0_ERR(tx->t_sm.sm_rc), false);
+		return M0_FSO_AGAIN;
+	}
+}
+
+/**
+ * Leaves the batch after the fom updates are done or failed. The last member
+ * adds the FOL record and closes the transaction, the others wait until it is
+ * closed, so that no reply is sent before the transaction of the request is
+ * closed, as without batching.
+ */
+static int cas_batch_done(struct cas_fom *fom)
+{
+	struct m0_fom     *fom0 = &fom->cf_fom;
+	struct cas_batch  *b    = fom->cf_batch;
+	struct m0_be_tx   *tx   = &b->cb_tx.tx_betx;
+	struct m0_cas_rep *rep  = m0_fop_data(fom0->fo_rep_fop);
+	int                rc;
+
+	if (fom->cf_batch_active) {
+		fom->cf_batch_active = false;
+		M0_CNT_DEC(b->cb_active);
+		if (b->cb_active == 0 && m0_be_tx_state(tx) == M0_BTS_ACTIVE) {
+			rc = m0_dtx_fol_add(&b->cb_tx);
+			M0_ASSERT_INFO(rc == 0, "m0_dtx_fol_add() failed: rc=%d",
+				       rc);
+			m0_dtx_done(&b->cb_tx);
+		}
+	}
+	if (m0_be_tx_state(tx) == M0_BTS_ACTIVE) {
+		m0_fom_wait_on(fom0, &tx->t_sm.sm_chan, &fom0->fo_cb);
+		return M0_FSO_WAIT;
+	}
+	if (m0_be_tx_state(tx) != M0_BTS_FAILED) {
+		/* See m0_fom_mod_rep_fill(). */
+		rep->cgr_mod_rep.fmr_remid.tri_txid = tx->t_id;
+		rep->cgr_mod_rep.fmr_remid.tri_locality = fom0->fo_loc_idx;
+	}
+	m0_fom_phase_set(fom0, m0_fom_rc(fom0) == 0 ?
+			 M0_FOPH_SUCCESS : M0_FOPH_FAILURE);
+	return M0_FSO_AGAIN;
+}
+
+/**
+ * Drops the fom reference to its batch once the shared transaction is done,
+ * in place of m0_fom_tx_done_wait().
+ */
+static int cas_batch_put(struct cas_fom *fom)
+{
+	struct m0_fom    *fom0 = &fom->cf_fom;
+	struct cas_batch *b    = fom->cf_batch;
+	struct m0_be_tx  *tx   = &b->cb_tx.tx_betx;
+
+	M0_PRE(!fom->cf_batch_active);
+	if (!M0_IN(m0_be_tx_state(tx), (M0_BTS_DONE, M0_BTS_FAILED))) {
+		m0_fom_wait_on(fom0, &tx->t_sm.sm_chan, &fom0->fo_cb);
+		return M0_FSO_WAIT;
+	}
+	fom->cf_batch = NULL;
+	M0_CNT_DEC(b->cb_ref);
+	if (b->cb_ref == 0)
+		cas_batch_free(b);
+	return M0_FSO_AGAIN;
+}
+
 static bool cas_service_started(struct m0_fop  *fop,
 				struct m0_reqh *reqh)
 {
@@ -1074,6 +1852,7 @@ static void cas_fom_cleanup(struct cas_fom *fom, bool ctg_op_fini)
 	struct m0_cas_ctg *ctidx      = m0_ctg_ctidx();
 	struct m0_cas_ctg *dead_index = m0_ctg_dead_index();
 
+	cas_batch_unpend(fom);
 	m0_long_unlock(m0_ctg_lock(meta), &fom->cf_meta);
 	m0_long_unlock(m0_ctg_lock(ctidx), &fom->cf_ctidx);
 	m0_long_unlock(m0_ctg_lock(dead_index), &fom->cf_dead_index);
@@ -1111,7 +1890,8 @@ static void cas_fom_failure(struct cas_fom *fom, int rc, bool ctg_op_fini)
 	repdata->cgr_rep.cr_nr  = 0;
 
 	cas_fom_cleanup(fom, ctg_op_fini);
-	m0_fom_phase_move(&fom->cf_fom, rc, M0_FOPH_FAILURE);
+	m0_fom_phase_move(&fom->cf_fom, rc, fom->cf_batch_active ?
+			  CAS_BATCH_DONE : M0_FOPH_FAILURE);
 }
 
 static int cas_dtm0_logrec_credit_add(struct m0_fom *fom0)
@@ -1252,7 +2032,8 @@ static void cas_fom_success(struct cas_fom *fom, enum m0_cas_opcode opc)
 {
 	cas_fom_executed(fom);
 	cas_fom_cleanup(fom, opc == CO_CUR);
-	m0_fom_phase_set(&fom->cf_fom, M0_FOPH_SUCCESS);
+	m0_fom_phase_set(&fom->cf_fom, fom->cf_batch_active ?
+			 CAS_BATCH_DONE : M0_FOPH_SUCCESS);
 }
 
 static void addb2_add_kv_attrs(const struct cas_fom *fom, enum stats_kv_io kv_io)
@@ -1390,7 +2171,18 @@ static int cas_fom_tick(struct m0_fom *fom0)
 			m0_fom_phase_set(fom0, CAS_CHECK_PRE);
 			break;
 		}
-		if (phase == M0_FOPH_TXN_COMMIT) {
+		if (phase == M0_FOPH_TXN_INIT && cas_batch_eligible(fom)) {
+			/* The fom joins a shared transaction in CAS_PREP. */
+			cas_batch_pend(fom);
+			m0_fom_phase_set(fom0, CAS_START);
+			break;
+		}
+		if (phase == M0_FOPH_TXN_DONE_WAIT && fom->cf_batch != NULL &&
+		    cas_batch_put(fom) == M0_FSO_WAIT) {
+			result = M0_FSO_WAIT;
+			break;
+		}
+		if (phase == M0_FOPH_TXN_COMMIT && fom->cf_batch == NULL) {
 			/* Piggyback some information about the transaction */
 			if (M0_IN(opc, (CO_PUT, CO_DEL)))
 				m0_fom_mod_rep_fill(&rep->cgr_mod_rep, fom0);
@@ -1447,10 +2239,20 @@ static int cas_fom_tick(struct m0_fom *fom0)
 				     m0_sm_id_get(&fom0->fo_sm_phase),
 				     M0_AVI_CAS_FOM_ATTR_IKV_NR,
 				     fom->cf_ikv_nr);
-			m0_fom_phase_set(fom0, M0_FOPH_INIT);
+			m0_fom_phase_set(fom0, op->cg_flags & COF_CURSOR ?
+					 CAS_CURSOR_WAIT : M0_FOPH_INIT);
 		} else
 			m0_fom_phase_move(fom0, M0_RC(rc), M0_FOPH_FAILURE);
 		break;
+	case CAS_CURSOR_WAIT:
+		result = cas_cursor_wait(fom);
+		break;
+	case CAS_BATCH_OPEN:
+		result = cas_batch_open(fom);
+		break;
+	case CAS_BATCH_DONE:
+		result = cas_batch_done(fom);
+		break;
 	case CAS_START:
 		if (is_meta) {
 			/*
@@ -1544,6 +2346,8 @@ static int cas_fom_tick(struct m0_fom *fom0)
 		if (fom->cf_ipos == op->cg_rec.cr_nr) {
 			fom->cf_ipos = 0;
 			rc = cas_incoming_kv_setup(fom, op);
+			if (rc == 0 && fom->cf_cursor != NULL)
+				rc = cas_cursor_key_setup(fom);
 			if (rc != 0)
 				cas_fom_failure(fom, M0_ERR(rc), false);
 			else {
@@ -1592,6 +2396,20 @@ static int cas_fom_tick(struct m0_fom *fom0)
 			break;
 		}
 
+		if (fom->cf_batch_pending) {
+			struct m0_be_tx_credit cred = {};
+
+			for (i = 0; i < op->cg_rec.cr_nr; i++)
+				cas_prep(fom, opc, ct, ctg, i, &cred);
+			fom->cf_ipos = 0;
+			fom->cf_opos = 0;
+			rc = cas_batch_join(fom, &cred);
+			if (rc != 0)
+				cas_fom_failure(fom, M0_ERR(rc), false);
+			else
+				m0_fom_phase_set(fom0, CAS_BATCH_OPEN);
+			break;
+		}
 		for (i = 0; i < op->cg_rec.cr_nr; i++)
 			cas_prep(fom, opc, ct, ctg, i,
 				 &fom0->fo_tx.tx_betx_cred);
@@ -1901,6 +2719,9 @@ static void cas_fom_fini(struct m0_fom *fom0)
 	uint64_t           i;
 
 	cas_redo_free0(&fom->cf_redo);
+	if (fom->cf_cursor != NULL)
+		cas_cursor_release(fom);
+	M0_ASSERT(fom->cf_batch == NULL && !fom->cf_batch_pending);
 
 	for (i = 0; i < op->cg_rec.cr_nr; i++) {
 		rec = cas_at(op, i);
@@ -1959,21 +2780,15 @@ static int cas_sdev_state(struct m0_poolmach    *pm,
 			  uint32_t               sdev_idx,
 			  enum m0_pool_nd_state *state_out)
 {
-	int i;
+	uint32_t idx;
 
 	if (M0_FI_ENABLED("sdev_fail")) {
 		*state_out = M0_PNDS_FAILED;
 		return 0;
 	}
-	for (i = 0; i < pm->pm_state->pst_nr_devices; i++) {
-		struct m0_pooldev *sdev = &pm->pm_state->pst_devices_array[i];
-
-		if (sdev->pd_sdev_idx == sdev_idx) {
-			*state_out = sdev->pd_state;
-			return 0;
-		}
-	}
-	return M0_ERR(-EINVAL);
+	if (m0_poolmach_sdev_to_idx(pm, sdev_idx, &idx) != 0)
+		return M0_ERR(-EINVAL);
+	return m0_poolmach_device_state(pm, idx, state_out);
 }
 
 /**
@@ -2103,6 +2918,10 @@ static int cas_op_check(struct m0_cas_op *op,
 			}
 		}
 	}
+	if (rc == 0 && (flags & COF_CURSOR) &&
+	    (opc != CO_CUR || ct != CT_BTREE || op->cg_rec.cr_nr != 1))
+		rc = M0_ERR_INFO(-EPROTO, "Cursor session is supported for "
+				 "single-key NEXT on a catalogue only");
 	if (rc == 0)
 		/*
 		 * Note: fill cf_in_cids there.
@@ -2414,6 +3233,8 @@ static int cas_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
 
 	if (opc != CO_CUR)
 		m0_ctg_op_init(&fom->cf_ctg_op, fom0, flags);
+	if (fom->cf_batch != NULL)
+		ctg_op->co_tx = &fom->cf_batch->cb_tx.tx_betx;
 
 	switch (CTG_OP_COMBINE(opc, ct)) {
 	case CTG_OP_COMBINE(CO_GET, CT_BTREE):
@@ -2674,6 +3495,8 @@ static int cas_done(struct cas_fom *fom, struct m0_cas_op *op,
 
 	rc = rec_out->cr_rc;
 	if (opc == CO_CUR) {
+		if (fom->cf_cursor != NULL && rc == 0 && ctg_rc == 0)
+			cas_cursor_last_set(fom);
 		fom->cf_curpos++;
 		if (rc == 0 && ctg_rc == 0)
 			rc = fom->cf_startkey_excluded ?
@@ -2947,8 +3770,21 @@ static struct m0_sm_state_descr cas_fom_phases[] = {
 	},
 	[CAS_CHECK] = {
 		.sd_name      = "cas-op-check",
+		.sd_allowed   = M0_BITS(M0_FOPH_INIT, CAS_CURSOR_WAIT,
+					M0_FOPH_FAILURE)
+	},
+	[CAS_CURSOR_WAIT] = {
+		.sd_name      = "cursor-wait",
 		.sd_allowed   = M0_BITS(M0_FOPH_INIT, M0_FOPH_FAILURE)
 	},
+	[CAS_BATCH_OPEN] = {
+		.sd_name      = "batch-open",
+		.sd_allowed   = M0_BITS(CAS_TXN_OPENED, CAS_BATCH_DONE)
+	},
+	[CAS_BATCH_DONE] = {
+		.sd_name      = "batch-done",
+		.sd_allowed   = M0_BITS(M0_FOPH_SUCCESS, M0_FOPH_FAILURE)
+	},
 	[CAS_START] = {
 		.sd_name      = "start",
 		.sd_allowed   = M0_BITS(CAS_META_LOCK, CAS_LOAD_KEY)
@@ -2993,7 +3829,8 @@ static struct m0_sm_state_descr cas_fom_phases[] = {
 	},
 	[CAS_PREP] = {
 		.sd_name      = "prep",
-		.sd_allowed   = M0_BITS(M0_FOPH_TXN_OPEN, M0_FOPH_FAILURE)
+		.sd_allowed   = M0_BITS(M0_FOPH_TXN_OPEN, CAS_BATCH_OPEN,
+					M0_FOPH_FAILURE)
 	},
 	[CAS_TXN_OPENED] = {
 		.sd_name      = "txn-opened",
@@ -3007,7 +3844,7 @@ static struct m0_sm_state_descr cas_fom_phases[] = {
 		.sd_name      = "loop",
 		.sd_allowed   = M0_BITS(CAS_CTIDX, CAS_DTM0, CAS_INSERT_TO_DEAD,
 					CAS_PREPARE_SEND, M0_FOPH_SUCCESS,
-					M0_FOPH_FAILURE)
+					M0_FOPH_FAILURE, CAS_BATCH_DONE)
 	},
 
 
@@ -3108,7 +3945,11 @@ struct m0_sm_trans_descr cas_fom_trans[] = {
 	{ "cas-op-check_pre_failed", CAS_CHECK_PRE,     M0_FOPH_FAILURE },
 	{ "cas-op-checked",       CAS_CHECK,            M0_FOPH_INIT },
 	{ "cas-op-check-failed",  CAS_CHECK,            M0_FOPH_FAILURE },
+	{ "cursor-op-checked",    CAS_CHECK,            CAS_CURSOR_WAIT },
+	{ "cursor-turn",          CAS_CURSOR_WAIT,      M0_FOPH_INIT },
+	{ "cursor-failed",        CAS_CURSOR_WAIT,      M0_FOPH_FAILURE },
 	{ "tx-initialised",       M0_FOPH_TXN_OPEN,     CAS_START },
+	{ "tx-shared",            M0_FOPH_TXN_INIT,     CAS_START },
 	{ "ctg-op?",              CAS_START,            CAS_META_LOCK },
 	{ "meta-op?",             CAS_START,            CAS_LOAD_KEY },
 	{ "meta-locked",          CAS_META_LOCK,        CAS_META_LOOKUP },
@@ -3132,6 +3973,12 @@ struct m0_sm_trans_descr cas_fom_trans[] = {
 	{ "meta-locked",          CAS_LOCK,             CAS_CTIDX_LOCK },
 	{ "tx-credit-calculated", CAS_PREP,             M0_FOPH_TXN_OPEN },
 	{ "keys-vals-invalid",    CAS_PREP,             M0_FOPH_FAILURE },
+	{ "batch-joined",         CAS_PREP,             CAS_BATCH_OPEN },
+	{ "batch-opened",         CAS_BATCH_OPEN,       CAS_TXN_OPENED },
+	{ "batch-open-failed",    CAS_BATCH_OPEN,       CAS_BATCH_DONE },
+	{ "batch-done",           CAS_BATCH_DONE,       M0_FOPH_SUCCESS },
+	{ "batch-failed",         CAS_BATCH_DONE,       M0_FOPH_FAILURE },
+	{ "batch-all-done?",      CAS_LOOP,             CAS_BATCH_DONE },
 	{ "txn-opened-ctg-op?",   CAS_TXN_OPENED,       CAS_META_UNLOCK },
 	{ "txn-opened-meta-op?",  CAS_TXN_OPENED,       CAS_LOOP },
 	{ "meta-unlocked",        CAS_META_UNLOCK,      CAS_LOOP },
@@ -70,6 +70,8 @@ static struct m0_cas_rep       rep;
 static struct m0_cas_rec       repv[N];
 static struct m0_fid           ifid = IFID(2, 3);
 static bool                    mt;
+/** Passed to m0_cas__ut_svc_batch_set() on service start. */
+static uint32_t                batch_nr;
 
 extern void (*cas__ut_cb_done)(struct m0_fom *fom);
 extern void (*cas__ut_cb_fini)(struct m0_fom *fom);
@@ -195,6 +197,7 @@ static void _init(bool mkfs, bool use_small_credits)
 	m0_cas__ut_svc_be_set(cas, &be.but_dom);
 	ut_dod_init(&dtm0_domain, &reqh, &be.but_dom);
 	m0_cas__ut_svc_dtm0_domain_set(cas, &dtm0_domain);
+	m0_cas__ut_svc_batch_set(cas, batch_nr, 0);
 	m0_reqh_service_start(cas);
 	m0_reqh_start(&reqh);
 	cas__ut_cb_done = &cb_done;
@@ -383,6 +386,9 @@ static void fop_release(struct m0_ref *ref)
 struct fopsem {
 	struct m0_semaphore fs_end;
 	struct m0_fop       fs_fop;
+	/** Don't copy the reply to "rep", only its return code to fs_rc. */
+	bool                fs_quiet;
+	int                 fs_rc;
 };
 
 static void cb_done(struct m0_fom *fom)
@@ -393,10 +399,13 @@ static void cb_done(struct m0_fom *fom)
 
 	M0_UT_ASSERT(reply != NULL);
 	M0_UT_ASSERT(reply->cgr_rep.cr_nr <= ARRAY_SIZE(repv));
-	rep.cgr_rc         = reply->cgr_rc;
-	rep.cgr_rep.cr_nr  = reply->cgr_rep.cr_nr;
-	rep.cgr_rep.cr_rec = repv;
-	for (i = 0; !mt && i < rep.cgr_rep.cr_nr; ++i) {
+	fs->fs_rc = reply->cgr_rc;
+	if (!fs->fs_quiet) {
+		rep.cgr_rc         = reply->cgr_rc;
+		rep.cgr_rep.cr_nr  = reply->cgr_rep.cr_nr;
+		rep.cgr_rep.cr_rec = repv;
+	}
+	for (i = 0; !mt && !fs->fs_quiet && i < rep.cgr_rep.cr_nr; ++i) {
 		struct m0_cas_rec *rec = &reply->cgr_rep.cr_rec[i];
 		int                rc;
 
@@ -424,32 +433,55 @@ static void cb_fini(struct m0_fom *fom)
 {
 }
 
+/**
+ * Hands the request over to the reqh without waiting for the reply, see
+ * op_wait().
+ */
+static void op_post(struct fopsem *fs, struct m0_fop_type *ft,
+		    struct m0_cas_op *op, bool quiet)
+{
+	int result;
+
+	M0_UT_ASSERT(cas__ut_cb_done == &cb_done);
+	M0_UT_ASSERT(cas__ut_cb_fini == &cb_fini);
+	m0_fop_init(&fs->fs_fop, ft, op, &fop_release);
+	fs->fs_fop.f_item.ri_rmachine = (void *)1;
+	fs->fs_quiet = quiet;
+	m0_semaphore_init(&fs->fs_end, 0);
+	result = m0_reqh_fop_handle(&reqh, &fs->fs_fop);
+	M0_UT_ASSERT(result == 0);
+}
+
+static void op_wait(struct fopsem *fs)
+{
+	m0_semaphore_down(&fs->fs_end);
+	/**
+	 * @note There is no need to finalise the locally allocated fop: rpc was
+	 * never used, so there are no resources to free.
+	 */
+	m0_semaphore_fini(&fs->fs_end);
+}
+
+static void op_submit(struct m0_fop_type *ft, struct m0_cas_op *op)
+{
+	struct fopsem fs;
+
+	rep_clear();
+	op_post(&fs, ft, op, false);
+	op_wait(&fs);
+}
+
 static void fop_submit(struct m0_fop_type *ft, const struct m0_fid *index,
 		       struct m0_cas_rec *rec)
 {
-	int              result;
-	struct fopsem    fs;
 	struct m0_cas_op op = {
 		.cg_id  = { .ci_fid = *index },
 		.cg_rec = { .cr_rec = rec }
 	};
 
-	M0_UT_ASSERT(cas__ut_cb_done == &cb_done);
-	M0_UT_ASSERT(cas__ut_cb_fini == &cb_fini);
 	while (rec[op.cg_rec.cr_nr].cr_rc != ~0ULL)
 		++ op.cg_rec.cr_nr;
-	m0_fop_init(&fs.fs_fop, ft, &op, &fop_release);
-	fs.fs_fop.f_item.ri_rmachine = (void *)1;
-	m0_semaphore_init(&fs.fs_end, 0);
-	rep_clear();
-	result = m0_reqh_fop_handle(&reqh, &fs.fs_fop);
-	M0_UT_ASSERT(result == 0);
-	m0_semaphore_down(&fs.fs_end);
-	/**
-	 * @note There is no need to finalise the locally allocated fop: rpc was
-	 * never used, so there are no resources to free.
-	 */
-	m0_semaphore_fini(&fs.fs_end);
+	op_submit(ft, &op);
 }
 
 enum {
@@ -1340,6 +1372,207 @@ static void cur_N(void)
 	fini();
 }
 
+/** Request of a cursor session, see cursor_op_init(). */
+struct cursor_op {
+	uint64_t          co_key;
+	struct m0_cas_rec co_rec;
+	struct m0_cas_op  co_op;
+};
+
+static void cursor_op_init(struct cursor_op *cop, const struct m0_fid *index,
+			   const struct m0_cas_cursor *cur, uint64_t key,
+			   uint64_t nr)
+{
+	cop->co_key = key;
+	cop->co_rec = (struct m0_cas_rec) {
+		.cr_key.u.ab_buf = M0_BUF_INIT(sizeof cop->co_key,
+					       &cop->co_key),
+		.cr_key.ab_type  = M0_RPC_AT_INLINE,
+		.cr_rc           = nr
+	};
+	cop->co_op = (struct m0_cas_op) {
+		.cg_id     = { .ci_fid = *index },
+		.cg_rec    = { .cr_nr = 1, .cr_rec = &cop->co_rec },
+		.cg_flags  = COF_CURSOR,
+		.cg_cursor = *cur
+	};
+}
+
+/**
+ * Sends the next NEXT request of the cursor session "cur".
+ */
+static void cursor_next(const struct m0_fid *index, struct m0_cas_cursor *cur,
+			uint64_t key, uint64_t nr)
+{
+	struct cursor_op cop;
+
+	cursor_op_init(&cop, index, cur, key, nr);
+	op_submit(&cas_cur_fopt, &cop.co_op);
+	cur->cc_seq++;
+}
+
+/**
+ * Checks that the last reply holds "nr" records of insert_odd() starting
+ * with key "first".
+ */
+static void cursor_rep_check(uint64_t first, int nr)
+{
+	struct m0_buf *buf;
+	int            k;
+
+	M0_UT_ASSERT(rep.cgr_rc == 0);
+	M0_UT_ASSERT(rep.cgr_rep.cr_nr == nr);
+	for (k = 0; k < nr; k++) {
+		M0_UT_ASSERT(rep_check(k, k + 1, BSET, BSET));
+		buf = &repv[k].cr_key.u.ab_buf;
+		M0_UT_ASSERT(*(uint64_t *)buf->b_addr == CB(first + 2 * k));
+	}
+}
+
+/**
+ * Scans the index in small batches through a cursor session, checks that
+ * every record is returned exactly once and in order.
+ */
+static void cur_session(void)
+{
+	struct m0_cas_cursor cur = { .cc_id = M0_UINT128(0xca5, 1) };
+	struct m0_cas_cursor stale;
+	struct m0_buf       *buf;
+	uint64_t             expected = 1;
+	bool                 eof = false;
+	int                  batch = 7;
+	int                  k;
+
+	init();
+	meta_fid_submit(&cas_put_fopt, &ifid);
+	insert_odd(&ifid);
+	while (!eof) {
+		/* The key matters for the first request of the session only. */
+		cursor_next(&ifid, &cur, cur.cc_seq == 0 ? CB(1) : CB(0),
+			    batch);
+		M0_UT_ASSERT(rep.cgr_rc == 0);
+		M0_UT_ASSERT(rep.cgr_rep.cr_nr == batch);
+		for (k = 0; k < batch && !eof; k++) {
+			if (expected >= INSERTS) {
+				M0_UT_ASSERT(rep_check(k, -ENOENT,
+						       BUNSET, BUNSET));
+				eof = true;
+				continue;
+			}
+			M0_UT_ASSERT(rep_check(k, k + 1, BSET, BSET));
+			buf = &repv[k].cr_key.u.ab_buf;
+			M0_UT_ASSERT(buf->b_nob == sizeof (uint64_t));
+			M0_UT_ASSERT(*(uint64_t *)buf->b_addr == CB(expected));
+			buf = &repv[k].cr_val.u.ab_buf;
+			M0_UT_ASSERT(*(uint64_t *)buf->b_addr ==
+				     expected * expected);
+			expected += 2;
+		}
+	}
+	/* Repeated request is rejected. */
+	stale = cur;
+	stale.cc_seq--;
+	cursor_next(&ifid, &stale, CB(1), batch);
+	M0_UT_ASSERT(rep.cgr_rc == -EPROTO);
+	/* Cursor sessions are not supported for the meta-index. */
+	cur = (struct m0_cas_cursor) { .cc_id = M0_UINT128(0xca5, 2) };
+	cursor_next(&m0_cas_meta_fid, &cur, CB(1), batch);
+	M0_UT_ASSERT(rep.cgr_rc == -EPROTO);
+	/* Cleaning up allocated memory to avoid leaks. */
+	meta_fid_submit(&cas_del_fopt, &ifid);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	fini();
+}
+
+/**
+ * Requests of a session arriving out of order: the second batch waits for
+ * the first one and then continues after it.
+ */
+static void cur_session_order(void)
+{
+	struct m0_cas_cursor cur = { .cc_id = M0_UINT128(0xca5, 3) };
+	struct cursor_op     cop[2];
+	struct fopsem        fs[2];
+	bool                 done;
+
+	init();
+	meta_fid_submit(&cas_put_fopt, &ifid);
+	insert_odd(&ifid);
+
+	cur.cc_seq = 1;
+	cursor_op_init(&cop[1], &ifid, &cur, CB(0), 5);
+	rep_clear();
+	op_post(&fs[1], &cas_cur_fopt, &cop[1].co_op, false);
+	/* The second batch can't proceed without the first one. */
+	done = m0_semaphore_timeddown(&fs[1].fs_end, m0_time_from_now(0,
+						200 * M0_TIME_ONE_MSEC));
+	M0_UT_ASSERT(!done);
+
+	cur.cc_seq = 0;
+	cursor_op_init(&cop[0], &ifid, &cur, CB(1), 3);
+	op_post(&fs[0], &cas_cur_fopt, &cop[0].co_op, true);
+	op_wait(&fs[0]);
+	M0_UT_ASSERT(fs[0].fs_rc == 0);
+	op_wait(&fs[1]);
+	/* Keys 1, 3 and 5 were returned by the first batch. */
+	cursor_rep_check(7, 5);
+
+	meta_fid_submit(&cas_del_fopt, &ifid);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	fini();
+}
+
+/**
+ * A request whose predecessors never arrive fails after the wait bound, an
+ * idle session is forgotten after its lease.
+ */
+static void cur_session_expire(void)
+{
+	struct m0_cas_cursor cur = { .cc_id = M0_UINT128(0xca5, 4) };
+	struct m0_cas_cursor lost = { .cc_id = M0_UINT128(0xca5, 5),
+				      .cc_seq = 1 };
+	m0_time_t            start;
+
+	init();
+	m0_cas__ut_svc_cursor_set(cas, M0_MKTIME(1, 0),
+				  200 * M0_TIME_ONE_MSEC);
+	meta_fid_submit(&cas_put_fopt, &ifid);
+	insert_odd(&ifid);
+
+	/* CAS_CURSOR_WAIT timeout. */
+	start = m0_time_now();
+	cursor_next(&ifid, &lost, CB(0), 3);
+	M0_UT_ASSERT(rep.cgr_rc == -ETIMEDOUT);
+	M0_UT_ASSERT(m0_time_sub(m0_time_now(), start) >=
+		     200 * M0_TIME_ONE_MSEC);
+
+	/* The lease is extended by every request of the session. */
+	cursor_next(&ifid, &cur, CB(1), 3);
+	cursor_rep_check(1, 3);
+	m0_nanosleep(m0_time(0, 500 * M0_TIME_ONE_MSEC), NULL);
+	cursor_next(&ifid, &cur, CB(0), 3);
+	cursor_rep_check(7, 3);
+	m0_nanosleep(m0_time(0, 500 * M0_TIME_ONE_MSEC), NULL);
+	cursor_next(&ifid, &cur, CB(0), 3);
+	cursor_rep_check(13, 3);
+
+	/*
+	 * After the lease the session is forgotten: the continuation request
+	 * starts a new session and waits for its first request in vain.
+	 */
+	m0_nanosleep(m0_time(1, 500 * M0_TIME_ONE_MSEC), NULL);
+	cursor_next(&ifid, &cur, CB(0), 3);
+	M0_UT_ASSERT(rep.cgr_rc == -ETIMEDOUT);
+	/* A new first request restarts the scan. */
+	cur.cc_seq = 0;
+	cursor_next(&ifid, &cur, CB(1), 3);
+	cursor_rep_check(1, 3);
+
+	meta_fid_submit(&cas_del_fopt, &ifid);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	fini();
+}
+
 static struct m0_thread t[8];
 
 static void meta_mt_thread(int idx)
@@ -1381,6 +1614,85 @@ static void meta_mt(void)
 	fini();
 }
 
+enum {
+	BATCH_KEYS_NR = 20
+};
+
+static void batch_mt_thread(int idx)
+{
+	struct m0_fid index = IFID(2, 10 + idx);
+	uint64_t      key;
+
+	for (key = 1; key <= BATCH_KEYS_NR; ++key) {
+		index_op(&cas_put_fopt, &index, key, idx * 100 + key);
+		if (key % 2 == 0)
+			index_op(&cas_del_fopt, &index, key - 1, NOVAL);
+	}
+}
+
+/**
+ * Test PUT and DEL requests sharing transactions.
+ */
+static void batch(void)
+{
+	struct m0_fid index;
+	uint64_t      key;
+	uint64_t      opened;
+	uint64_t      members;
+	int           i;
+	int           result;
+
+	batch_nr = 4;
+	init();
+	for (i = 0; i < ARRAY_SIZE(t); ++i)
+		meta_fid_submit(&cas_put_fopt, &IFID(2, 10 + i));
+	/* A lone request doesn't wait for others. */
+	index_op(&cas_put_fopt, &IFID(2, 10), BATCH_KEYS_NR, 1);
+	M0_UT_ASSERT(rep.cgr_rc == 0);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	index_op(&cas_del_fopt, &IFID(2, 10), BATCH_KEYS_NR, NOVAL);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	m0_cas__ut_svc_batch_stats(cas, &opened, &members);
+	M0_UT_ASSERT(opened == 2 && members == 2);
+	mt = true;
+	for (i = 0; i < ARRAY_SIZE(t); ++i) {
+		result = M0_THREAD_INIT(&t[i], int, NULL, &batch_mt_thread, i,
+					"batch-mt-%i", i);
+		M0_UT_ASSERT(result == 0);
+	}
+	for (i = 0; i < ARRAY_SIZE(t); ++i) {
+		m0_thread_join(&t[i]);
+		m0_thread_fini(&t[i]);
+	}
+	mt = false;
+	/*
+	 * Every PUT and DEL went through a shared transaction, and some of
+	 * them had company.
+	 */
+	m0_cas__ut_svc_batch_stats(cas, &opened, &members);
+	M0_UT_ASSERT(members == 2 + ARRAY_SIZE(t) * BATCH_KEYS_NR * 3 / 2);
+	M0_UT_ASSERT(opened < members);
+	/* Even keys are left, odd ones are deleted. */
+	for (i = 0; i < ARRAY_SIZE(t); ++i) {
+		index = IFID(2, 10 + i);
+		for (key = 1; key <= BATCH_KEYS_NR; ++key) {
+			index_op(&cas_get_fopt, &index, key, NOVAL);
+			if (key % 2 != 0) {
+				M0_UT_ASSERT(rep_check(0, -ENOENT, BUNSET,
+						       BUNSET));
+				continue;
+			}
+			M0_UT_ASSERT(rep_check(0, 0, BUNSET, BSET));
+			M0_UT_ASSERT(*(uint64_t *)rep.cgr_rep.cr_rec[0].cr_val.
+				     u.ab_buf.b_addr == i * 100 + key);
+		}
+		meta_fid_submit(&cas_del_fopt, &index);
+		M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	}
+	fini();
+	batch_nr = 0;
+}
+
 static void meta_insert_fail(void)
 {
 	m0_fi_enable_once("ctg_kbuf_get", "cas_alloc_fail");
@@ -2203,6 +2515,10 @@ struct m0_ut_suite cas_service_ut = {
 		{ "lookup-N",                &lookup_N,              "Nikita" },
 		{ "lookup-restart",          &lookup_restart,        "Nikita" },
 		{ "cur-N",                   &cur_N,                 "Nikita" },
+		{ "cur-session",             &cur_session },
+		{ "cur-session-order",       &cur_session_order },
+		{ "cur-session-expire",      &cur_session_expire },
+		{ "batch",                   &batch },
 		{ "meta-mt",                 &meta_mt,               "Nikita" },
 		{ "meta-insert-fail",        &meta_insert_fail,      "Leonid" },
 		{ "meta-lookup-fail",        &meta_lookup_fail,      "Leonid" },
@@ -390,6 +390,127 @@ static int bc_cmp(const void *key0, const void *key1)
 				(const struct m0_cob_bckey *)key1);
 }
 
+/**
+ * Volatile part of a bytecount shard.
+ */
+struct cob_bc_shard {
+	struct m0_mutex bsh_lock;
+	/** Deferred additions to each slot since it was last folded. */
+	uint32_t        bsh_nr[M0_COB_BC_SLOTS_NR];
+};
+
+struct m0_cob_bc_shards {
+	struct m0_be_seg    *bss_seg;
+	struct cob_bc_shard  bss_shard[M0_COB_BC_SHARDS_NR];
+};
+
+static struct m0_cob_bc_slot *cob_bc_slot(const struct m0_cob_domain *dom,
+					  uint64_t shard, int idx)
+{
+	return &dom->cd_bc_slots[shard * M0_COB_BC_SLOTS_NR + idx];
+}
+
+static bool cob_bc_slot_is_bound(const struct m0_cob_bc_slot *slot)
+{
+	return m0_fid_is_set(&slot->bs_key.cbk_pfid);
+}
+
+static bool cob_bc_slot_matches(const struct m0_cob_bc_slot *slot,
+				const struct m0_cob_bckey   *key)
+{
+	return cob_bc_slot_is_bound(slot) &&
+	       m0_cob_bckey_cmp(&slot->bs_key, key) == 0;
+}
+
+/** Delta accumulated in the slot and not yet folded into the btree. */
+static int64_t cob_bc_slot_pending(const struct m0_cob_bc_slot *slot)
+{
+	return (int64_t)(slot->bs_added - slot->bs_folded);
+}
+
+/** Returns @count adjusted by @delta, without going below zero. */
+static uint64_t cob_bc_count_add(uint64_t count, int64_t delta)
+{
+	if (delta < 0 && count < -(uint64_t)delta)
+		return 0;
+	return count + delta;
+}
+
+/**
+ * Sum of the deltas pending for @key in all shards.
+ *
+ * The caller holds m0_cob_domain::cd_lock, which keeps folds out, so that
+ * the result is consistent with the btree record.
+ */
+static int64_t cob_bc_pending(const struct m0_cob_domain *dom,
+			      const struct m0_cob_bckey  *key)
+{
+	struct cob_bc_shard *sh;
+	int64_t              sum = 0;
+	uint64_t             i;
+	int                  j;
+
+	if (dom->cd_bc_shards == NULL)
+		return 0;
+	for (i = 0; i < M0_COB_BC_SHARDS_NR; ++i) {
+		sh = &dom->cd_bc_shards->bss_shard[i];
+		m0_mutex_lock(&sh->bsh_lock);
+		for (j = 0; j < M0_COB_BC_SLOTS_NR; ++j) {
+			if (cob_bc_slot_matches(cob_bc_slot(dom, i, j), key))
+				sum += cob_bc_slot_pending(cob_bc_slot(dom,
+								       i, j));
+		}
+		m0_mutex_unlock(&sh->bsh_lock);
+	}
+	return sum;
+}
+
+static void cob_bc_rec_complete(const struct m0_cob_domain *dom,
+				const struct m0_cob_bckey  *key,
+				struct m0_cob_bcrec        *rec)
+{
+	rec->cbr_bytecount = cob_bc_count_add(rec->cbr_bytecount,
+					      cob_bc_pending(dom, key));
+}
+
+static bool cob_domain_has_bc_slots(const struct m0_cob_domain *dom)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &dom->cd_header);
+	return tag.ot_version >= M0_COB_DOMAIN_FORMAT_VERSION_2 &&
+	       dom->cd_bc_slots != NULL;
+}
+
+static int cob_bc_shards_init(struct m0_cob_domain *dom, struct m0_be_seg *seg)
+{
+	struct m0_cob_bc_shards *bcs;
+	int                      i;
+
+	dom->cd_bc_shards = NULL;
+	if (!cob_domain_has_bc_slots(dom))
+		return 0;
+	M0_ALLOC_PTR(bcs);
+	if (bcs == NULL)
+		return M0_ERR(-ENOMEM);
+	bcs->bss_seg = seg;
+	for (i = 0; i < M0_COB_BC_SHARDS_NR; ++i)
+		m0_mutex_init(&bcs->bss_shard[i].bsh_lock);
+	dom->cd_bc_shards = bcs;
+	return 0;
+}
+
+static void cob_bc_shards_fini(struct m0_cob_domain *dom)
+{
+	int i;
+
+	if (dom->cd_bc_shards == NULL)
+		return;
+	for (i = 0; i < M0_COB_BC_SHARDS_NR; ++i)
+		m0_mutex_fini(&dom->cd_bc_shards->bss_shard[i].bsh_lock);
+	m0_free0(&dom->cd_bc_shards);
+}
+
 M0_INTERNAL int m0_cob_bc_iterator_init(struct m0_cob             *cob,
 					struct m0_cob_bc_iterator *it,
 					const struct m0_fid       *pver_fid,
@@ -415,6 +536,7 @@ M0_INTERNAL int m0_cob_bc_iterator_init(struct m0_cob             *cob,
 
 M0_INTERNAL int m0_cob_bc_iterator_get(struct m0_cob_bc_iterator *it)
 {
+	struct m0_cob_domain *cdom = it->ci_cob->co_dom;
 	struct m0_cob_bckey *bckey;
 	struct m0_cob_bcrec *bcrec;
 	struct m0_btree_key  r_key;
@@ -425,6 +547,7 @@ M0_INTERNAL int m0_cob_bc_iterator_get(struct m0_cob_bc_iterator *it)
 	m0_buf_init(&key, it->ci_key, m0_cob_bckey_size());
 	m0_buf_init(&val, it->ci_rec, m0_cob_bcrec_size());
 	r_key.k_data = M0_BUFVEC_INIT_BUF(&key.b_addr, &key.b_nob),
+	m0_rwlock_read_lock(&cdom->cd_lock.bl_u.rwlock);
 	rc = m0_btree_cursor_get(&it->ci_cursor, &r_key, true);
 	if (rc == 0) {
 		m0_btree_cursor_kv_get(&it->ci_cursor, &key, &val);
@@ -435,18 +558,22 @@ M0_INTERNAL int m0_cob_bc_iterator_get(struct m0_cob_bc_iterator *it)
 		M0_ASSERT(sizeof(bcrec) <= m0_cob_bcrec_size());
 		memcpy(it->ci_key, bckey, m0_cob_bckey_size());
 		memcpy(it->ci_rec, bcrec, m0_cob_bcrec_size());
+		cob_bc_rec_complete(cdom, it->ci_key, it->ci_rec);
 	}
+	m0_rwlock_read_unlock(&cdom->cd_lock.bl_u.rwlock);
 	return M0_RC(rc);
 }
 
 M0_INTERNAL int m0_cob_bc_iterator_next(struct m0_cob_bc_iterator *it)
 {
-	struct m0_cob_bckey *bckey;
-	struct m0_cob_bcrec *bcrec;
-	struct m0_buf        key;
-	struct m0_buf        val;
-	int                  rc;
+	struct m0_cob_domain *cdom = it->ci_cob->co_dom;
+	struct m0_cob_bckey  *bckey;
+	struct m0_cob_bcrec  *bcrec;
+	struct m0_buf         key;
+	struct m0_buf         val;
+	int                   rc;
 
+	m0_rwlock_read_lock(&cdom->cd_lock.bl_u.rwlock);
 	rc = m0_btree_cursor_next(&it->ci_cursor);
 	if (rc == 0) {
 		m0_btree_cursor_kv_get(&it->ci_cursor, &key, &val);
@@ -457,7 +584,9 @@ M0_INTERNAL int m0_cob_bc_iterator_next(struct m0_cob_bc_iterator *it)
 		M0_ASSERT(sizeof(bcrec) <= m0_cob_bcrec_size());
 		memcpy(it->ci_key, bckey, m0_cob_bckey_size());
 		memcpy(it->ci_rec, bcrec, m0_cob_bcrec_size());
+		cob_bc_rec_complete(cdom, it->ci_key, it->ci_rec);
 	}
+	m0_rwlock_read_unlock(&cdom->cd_lock.bl_u.rwlock);
 	return M0_RC(rc);
 }
 
@@ -488,6 +617,8 @@ M0_INTERNAL int m0_cob_bc_entries_dump(struct m0_cob_domain *cdom,
 	if (cdom->cd_bytecount == NULL)
 		return M0_ERR(-ENOENT);
 
+	/* Keep folds out, so that pending deltas are added exactly once. */
+	m0_rwlock_read_lock(&cdom->cd_lock.bl_u.rwlock);
 	*out_count = 0;
 	m0_btree_cursor_init(&it.ci_cursor, cdom->cd_bytecount);
 	rc = m0_btree_cursor_first(&it.ci_cursor);
@@ -503,6 +634,7 @@ M0_INTERNAL int m0_cob_bc_entries_dump(struct m0_cob_domain *cdom,
 			 (*out_count));
 	if (rc != 0) {
 		m0_btree_cursor_fini(&it.ci_cursor);
+		m0_rwlock_read_unlock(&cdom->cd_lock.bl_u.rwlock);
 		return M0_ERR(rc);
 	}
 	
@@ -511,6 +643,7 @@ M0_INTERNAL int m0_cob_bc_entries_dump(struct m0_cob_domain *cdom,
 	if (rc != 0) {
 		m0_buf_free(out_keys);
 		m0_btree_cursor_fini(&it.ci_cursor);
+		m0_rwlock_read_unlock(&cdom->cd_lock.bl_u.rwlock);
 		return M0_ERR(rc);
 	}
 
@@ -528,6 +661,7 @@ M0_INTERNAL int m0_cob_bc_entries_dump(struct m0_cob_domain *cdom,
 
 		memcpy(key_cursor, key_buf.b_addr, key_buf.b_nob);
 		memcpy(rec_cursor, rec_buf.b_addr, rec_buf.b_nob);
+		cob_bc_rec_complete(cdom, key_cursor, rec_cursor);
 		key_cursor++;
 		rec_cursor++;
 
@@ -535,6 +669,7 @@ M0_INTERNAL int m0_cob_bc_entries_dump(struct m0_cob_domain *cdom,
 	}
 
 	m0_btree_cursor_fini(&it.ci_cursor);
+	m0_rwlock_read_unlock(&cdom->cd_lock.bl_u.rwlock);
 
 	return M0_RC(0);
 }
@@ -671,7 +806,8 @@ int m0_cob_domain_init(struct m0_cob_domain *dom, struct m0_be_seg *seg)
 
 	m0_rwlock_init(&dom->cd_lock.bl_u.rwlock);
 
-	return M0_RC(0);
+	rc = cob_bc_shards_init(dom, seg);
+	return M0_RC(rc);
 }
 
 void m0_cob_domain_fini(struct m0_cob_domain *dom)
@@ -725,6 +861,7 @@ void m0_cob_domain_fini(struct m0_cob_domain *dom)
 		m0_free0(&dom->cd_bytecount);
 	}
 
+	cob_bc_shards_fini(dom);
 	m0_rwlock_fini(&dom->cd_lock.bl_u.rwlock);
 }
 
@@ -789,6 +926,13 @@ M0_INTERNAL int m0_cob_domain_credit_add(struct m0_cob_domain          *dom,
 				   };
 	m0_btree_create_credit(&bt, cred, 1); /** Tree cd_bytecount */
 
+	M0_BE_ALLOC_CREDIT_ARR(dom->cd_bc_slots,
+			       M0_COB_BC_SHARDS_NR * M0_COB_BC_SLOTS_NR, seg, cred);
+	m0_be_tx_credit_add(cred, &M0_BE_TX_CREDIT(1,
+			M0_COB_BC_SHARDS_NR * M0_COB_BC_SLOTS_NR *
+			sizeof dom->cd_bc_slots[0]));
+	m0_be_tx_credit_add(cred, &M0_BE_TX_CREDIT_PTR(&dom->cd_bc_slots));
+
 	m0_free(cdid_str);
 	return M0_RC(0);
 }
@@ -929,6 +1073,23 @@ int m0_cob_domain_create_prepared(struct m0_cob_domain          **out,
 						      &fid, tx, &keycmp));
 	M0_ASSERT(rc == 0);
 
+	/*
+	 * The domain is usable without delta slots: m0_cob_bc_add() then
+	 * updates the btree directly.
+	 */
+	M0_BE_ALLOC_ARR_SYNC(dom->cd_bc_slots,
+			     M0_COB_BC_SHARDS_NR * M0_COB_BC_SLOTS_NR, seg, tx);
+	if (dom->cd_bc_slots != NULL) {
+		memset(dom->cd_bc_slots, 0, M0_COB_BC_SHARDS_NR *
+		       M0_COB_BC_SLOTS_NR * sizeof dom->cd_bc_slots[0]);
+		M0_BE_TX_CAPTURE_ARR(seg, tx, dom->cd_bc_slots,
+				     M0_COB_BC_SHARDS_NR * M0_COB_BC_SLOTS_NR);
+	}
+	M0_BE_TX_CAPTURE_PTR(seg, tx, &dom->cd_bc_slots);
+	m0_rwlock_init(&dom->cd_lock.bl_u.rwlock);
+	/* Nothing is pending yet, so running without shards is exact too. */
+	(void)cob_bc_shards_init(dom, seg);
+
 	data = M0_BUF_INIT_PTR(&dom);
 	rc = m0_be_0type_add(&m0_be_cob0, bedom, tx, cdid_str, &data);
 	M0_ASSERT(rc == 0);
@@ -1046,6 +1207,9 @@ int m0_cob_domain_destroy(struct m0_cob_domain *dom,
 
 	m0_be_0type_del_credit(bedom, &m0_be_cob0, cdid_str, &cred);
 	M0_BE_FREE_CREDIT_PTR(dom, seg, &cred);
+	if (cob_domain_has_bc_slots(dom))
+		M0_BE_FREE_CREDIT_ARR(dom->cd_bc_slots, M0_COB_BC_SHARDS_NR *
+				      M0_COB_BC_SLOTS_NR, seg, &cred);
 	m0_btree_destroy_credit(dom->cd_object_index,   NULL, &cred, 1);
 	m0_btree_destroy_credit(dom->cd_namespace,      NULL, &cred, 1);
 	m0_btree_destroy_credit(dom->cd_fileattr_basic, NULL, &cred, 1);
@@ -1087,6 +1251,8 @@ int m0_cob_domain_destroy(struct m0_cob_domain *dom,
 
 	dom->cd_id.id = 0;
 	M0_BE_TX_CAPTURE_PTR(seg, tx, &dom->cd_id);
+	if (cob_domain_has_bc_slots(dom))
+		M0_BE_FREE_ARR_SYNC(dom->cd_bc_slots, seg, tx);
 	M0_BE_FREE_PTR_SYNC(dom, seg, tx);
 
 	m0_be_tx_close_sync(tx);
@@ -1381,7 +1547,11 @@ M0_INTERNAL int m0_cob_bc_lookup(struct m0_cob *cob,
 	m0_buf_init(&key, bc_key, m0_cob_bckey_size());
 	m0_buf_init(&val, bc_rec, m0_cob_bcrec_size());
 
+	m0_rwlock_read_lock(&cob->co_dom->cd_lock.bl_u.rwlock);
 	rc = cob_table_lookup(cob->co_dom->cd_bytecount, &key, &val);
+	if (rc == 0)
+		cob_bc_rec_complete(cob->co_dom, bc_key, bc_rec);
+	m0_rwlock_read_unlock(&cob->co_dom->cd_lock.bl_u.rwlock);
 	if (rc == 0)
 		cob->co_flags |= M0_CA_BCREC;
 	return M0_RC(rc);
@@ -1430,6 +1600,204 @@ M0_INTERNAL int m0_cob_bc_update(struct m0_cob *cob,
 	return M0_RC(rc);
 }
 
+/**
+ * Adds @delta to the btree record of @key, inserting it if needed.
+ * The caller holds m0_cob_domain::cd_lock for writing.
+ */
+static int cob_bc_table_add(struct m0_cob_domain *dom,
+			    struct m0_cob_bckey  *key,
+			    int64_t               delta,
+			    struct m0_be_tx      *tx)
+{
+	struct m0_cob_bcrec rec = {};
+	struct m0_buf       kbuf;
+	struct m0_buf       vbuf;
+	int                 rc;
+
+	m0_buf_init(&kbuf, key, m0_cob_bckey_size());
+	m0_buf_init(&vbuf, &rec, m0_cob_bcrec_size());
+
+	rc = cob_table_lookup(dom->cd_bytecount, &kbuf, &vbuf);
+	if (rc == -ENOENT) {
+		rec.cbr_bytecount = cob_bc_count_add(0, delta);
+		rec.cbr_cob_objects = 1;
+		rc = cob_table_insert(dom->cd_bytecount, tx, &kbuf, &vbuf);
+	} else if (rc == 0) {
+		rec.cbr_bytecount = cob_bc_count_add(rec.cbr_bytecount, delta);
+		rc = cob_table_update(dom->cd_bytecount, tx, &kbuf, &vbuf);
+	}
+	return M0_RC(rc);
+}
+
+/**
+ * Moves the pending delta of @slot into the btree.
+ * The caller holds m0_cob_domain::cd_lock for writing and the shard lock.
+ */
+static int cob_bc_slot_fold(struct m0_cob_domain  *dom,
+			    struct m0_cob_bc_slot *slot,
+			    struct m0_be_tx       *tx)
+{
+	int rc;
+
+	if (!cob_bc_slot_is_bound(slot) || cob_bc_slot_pending(slot) == 0)
+		return 0;
+	rc = cob_bc_table_add(dom, &slot->bs_key, cob_bc_slot_pending(slot),
+			      tx);
+	if (rc == 0) {
+		slot->bs_folded = slot->bs_added;
+		M0_BE_TX_CAPTURE_PTR(dom->cd_bc_shards->bss_seg, tx,
+				     &slot->bs_folded);
+	}
+	return M0_RC(rc);
+}
+
+/**
+ * Folds the slots of @key in all shards into the btree record of @key with a
+ * single update, so that the record holds every delta added so far.
+ * The caller holds m0_cob_domain::cd_lock for writing.
+ */
+static int cob_bc_key_fold(struct m0_cob_domain *dom,
+			   struct m0_cob_bckey  *key,
+			   struct m0_be_tx      *tx)
+{
+	struct cob_bc_shard   *sh;
+	struct m0_cob_bc_slot *slot;
+	int64_t                pending = cob_bc_pending(dom, key);
+	uint64_t               i;
+	int                    j;
+	int                    rc;
+
+	if (pending == 0)
+		return 0;
+	rc = cob_bc_table_add(dom, key, pending, tx);
+	if (rc != 0)
+		return M0_ERR(rc);
+	for (i = 0; i < M0_COB_BC_SHARDS_NR; ++i) {
+		sh = &dom->cd_bc_shards->bss_shard[i];
+		m0_mutex_lock(&sh->bsh_lock);
+		for (j = 0; j < M0_COB_BC_SLOTS_NR; ++j) {
+			slot = cob_bc_slot(dom, i, j);
+			if (cob_bc_slot_matches(slot, key) &&
+			    cob_bc_slot_pending(slot) != 0) {
+				slot->bs_folded = slot->bs_added;
+				M0_BE_TX_CAPTURE_PTR(dom->cd_bc_shards->bss_seg,
+						     tx, &slot->bs_folded);
+			}
+		}
+		m0_mutex_unlock(&sh->bsh_lock);
+	}
+	return 0;
+}
+
+static int cob_bc_slot_find(const struct m0_cob_domain *dom, uint64_t shard,
+			    const struct m0_cob_bckey  *key)
+{
+	int i;
+
+	for (i = 0; i < M0_COB_BC_SLOTS_NR; ++i) {
+		if (cob_bc_slot_matches(cob_bc_slot(dom, shard, i), key))
+			return i;
+	}
+	return -1;
+}
+
+/** Picks a slot to rebind: a free one, otherwise the least used one. */
+static int cob_bc_slot_victim(const struct m0_cob_domain *dom, uint64_t shard)
+{
+	const struct cob_bc_shard *sh = &dom->cd_bc_shards->bss_shard[shard];
+	int                        victim = 0;
+	int                        i;
+
+	for (i = 0; i < M0_COB_BC_SLOTS_NR; ++i) {
+		if (!cob_bc_slot_is_bound(cob_bc_slot(dom, shard, i)))
+			return i;
+		if (sh->bsh_nr[i] < sh->bsh_nr[victim])
+			victim = i;
+	}
+	return victim;
+}
+
+M0_INTERNAL int m0_cob_bc_add(struct m0_cob       *cob,
+			      struct m0_cob_bckey *bc_key,
+			      int64_t              delta,
+			      uint64_t             shard,
+			      struct m0_be_tx     *tx)
+{
+	struct m0_cob_domain  *dom  = cob->co_dom;
+	struct m0_rwlock      *lock = &dom->cd_lock.bl_u.rwlock;
+	struct cob_bc_shard   *sh;
+	struct m0_cob_bc_slot *slot;
+	int                    idx;
+	int                    rc;
+
+	M0_ENTRY("KEY: "FID_F"/%" PRIu64 " delta=%" PRIi64,
+		 FID_P(&bc_key->cbk_pfid), bc_key->cbk_user_id, delta);
+	M0_PRE(m0_fid_is_set(&bc_key->cbk_pfid));
+
+	if (dom->cd_bc_shards == NULL) {
+		m0_rwlock_write_lock(lock);
+		rc = cob_bc_table_add(dom, bc_key, delta, tx);
+		m0_rwlock_write_unlock(lock);
+		return M0_RC(rc);
+	}
+	if (delta < 0) {
+		/*
+		 * The byte count is clamped at zero when a negative delta is
+		 * applied, as with direct btree updates. Deferring the delta
+		 * would clamp the sum instead: 100, -200, +50 would give 0
+		 * rather than 50. Fold every pending delta of the key first and
+		 * apply this one to the btree directly. Negative deltas come
+		 * from cob deletion and are rare.
+		 */
+		m0_rwlock_write_lock(lock);
+		rc = cob_bc_key_fold(dom, bc_key, tx) ?:
+		     cob_bc_table_add(dom, bc_key, delta, tx);
+		m0_rwlock_write_unlock(lock);
+		return M0_RC(rc);
+	}
+
+	shard %= M0_COB_BC_SHARDS_NR;
+	sh = &dom->cd_bc_shards->bss_shard[shard];
+	m0_mutex_lock(&sh->bsh_lock);
+	idx = cob_bc_slot_find(dom, shard, bc_key);
+	if (idx >= 0 && sh->bsh_nr[idx] < M0_COB_BC_FOLD_NR) {
+		slot = cob_bc_slot(dom, shard, idx);
+		slot->bs_added += delta;
+		M0_BE_TX_CAPTURE_PTR(dom->cd_bc_shards->bss_seg, tx,
+				     &slot->bs_added);
+		sh->bsh_nr[idx]++;
+		m0_mutex_unlock(&sh->bsh_lock);
+		return M0_RC(0);
+	}
+	m0_mutex_unlock(&sh->bsh_lock);
+
+	/*
+	 * Slow path: the slot of the key is due for a fold, or the key has no
+	 * slot in this shard yet. Fold the slot and apply @delta to the btree
+	 * directly, which also makes sure that the key is in the btree before
+	 * any of its deltas is deferred.
+	 */
+	m0_rwlock_write_lock(lock);
+	m0_mutex_lock(&sh->bsh_lock);
+	idx = cob_bc_slot_find(dom, shard, bc_key);
+	if (idx < 0)
+		idx = cob_bc_slot_victim(dom, shard);
+	slot = cob_bc_slot(dom, shard, idx);
+	rc = cob_bc_slot_fold(dom, slot, tx) ?:
+	     cob_bc_table_add(dom, bc_key, delta, tx);
+	if (rc == 0) {
+		if (!cob_bc_slot_matches(slot, bc_key)) {
+			*slot = (struct m0_cob_bc_slot){ .bs_key = *bc_key };
+			M0_BE_TX_CAPTURE_PTR(dom->cd_bc_shards->bss_seg, tx,
+					     slot);
+		}
+		sh->bsh_nr[idx] = 0;
+	}
+	m0_mutex_unlock(&sh->bsh_lock);
+	m0_rwlock_write_unlock(lock);
+	return M0_RC(rc);
+}
+
 /**
    Search for a record in the namespace table
 
@@ -2668,6 +3036,20 @@ M0_INTERNAL void m0_cob_tx_credit(struct m0_cob_domain *dom,
 		TCREDIT(dom->cd_bytecount, DELETE, BC, accum);
 		TCREDIT(dom->cd_bytecount, UPDATE, BC, accum);
 		break;
+	case M0_COB_OP_BYTECOUNT_ADD:
+		/*
+		 * Slot fold and direct update on the slow path, or a fold of
+		 * the key in every shard (a key has at most one slot per
+		 * shard) for a negative delta.
+		 */
+		m0_be_tx_credit_add(accum, &M0_BE_TX_CREDIT(2,
+					sizeof(struct m0_cob_bc_slot)));
+		m0_be_tx_credit_add(accum, &M0_BE_TX_CREDIT(
+					M0_COB_BC_SHARDS_NR, sizeof(uint64_t)));
+		for (i = 0; i < 2; ++i)
+			m0_cob_tx_credit(dom, M0_COB_OP_BYTECOUNT_UPDATE,
+					 accum);
+		break;
 	default:
 		M0_IMPOSSIBLE("Impossible cob optype");
 	}
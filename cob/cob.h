@@ -218,6 +218,8 @@ struct m0_fid;
 struct m0_cob_id;
 struct m0_cob_domain;
 struct m0_cob_domain_id;
+struct m0_cob_bc_slot;
+struct m0_cob_bc_shards;
 
 /*
  * This is used to separate the range of COB IDs for IOS-es and MDS-es, which is
@@ -287,6 +289,14 @@ struct m0_cob_domain {
 	struct m0_btree *cd_fileattr_omg;   /** Pointer to fileattr_omg tree */
 	struct m0_btree *cd_fileattr_ea;    /** Pointer to fileattr_ea tree */
 	struct m0_btree *cd_bytecount;      /** Pointer to bytecount tree */
+	/**
+	 * Persistent bytecount delta slots, M0_COB_BC_SHARDS_NR *
+	 * M0_COB_BC_SLOTS_NR of them. Valid since
+	 * M0_COB_DOMAIN_FORMAT_VERSION_2, NULL if the domain has none.
+	 */
+	struct m0_cob_bc_slot   *cd_bc_slots;
+	/** Volatile shard locks, set up by m0_cob_domain_init(). */
+	struct m0_cob_bc_shards *cd_bc_shards;
 
 	/**
 	 *  Root nodes for the above trees follow here. These root nodes
@@ -308,13 +318,14 @@ struct m0_cob_domain {
 
 enum m0_cob_domain_format_version {
 	M0_COB_DOMAIN_FORMAT_VERSION_1 = 1,
+	/** m0_cob_domain::cd_bc_slots added. */
+	M0_COB_DOMAIN_FORMAT_VERSION_2,
 
 	/* future versions, uncomment and update M0_COB_DOMAIN_FORMAT_VERSION */
-	/*M0_COB_DOMAIN_FORMAT_VERSION_2,*/
 	/*M0_COB_DOMAIN_FORMAT_VERSION_3,*/
 
 	/** Current version, should point to the latest version present */
-	M0_COB_DOMAIN_FORMAT_VERSION = M0_COB_DOMAIN_FORMAT_VERSION_1
+	M0_COB_DOMAIN_FORMAT_VERSION = M0_COB_DOMAIN_FORMAT_VERSION_2
 };
 
 int m0_cob_domain_init(struct m0_cob_domain *dom,
@@ -553,6 +564,41 @@ struct m0_cob_bcrec {
 	uint64_t          cbr_cob_objects;  /**< Cob object count */
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
+/**
+ * Per-locality byte count accumulation.
+ *
+ * m0_cob_bc_add() does not touch the bytecount btree on the common path.
+ * It adds the delta to a persistent slot of the shard selected by the
+ * caller (normally its locality) and captures the slot in the caller's
+ * transaction, under the shard lock only.
+ *
+ * A slot is bound to a single key, which is always present in the btree.
+ * bs_added is advanced (modulo 2^64) by m0_cob_bc_add(); bs_folded is set
+ * to bs_added when the accumulated delta is moved into the btree record, in
+ * the same transaction as the record update. Thus bs_added - bs_folded is
+ * the delta not yet folded, in memory as well as after recovery, and
+ * m0_cob_bc_lookup(), the iterator and m0_cob_bc_entries_dump() add it to
+ * the btree value.
+ *
+ * A slot is folded after M0_COB_BC_FOLD_NR deferred additions, or when it
+ * is rebound to another key. Both happen on the slow path of
+ * m0_cob_bc_add(), under m0_cob_domain::cd_lock. Negative deltas are never
+ * deferred: all slots of the key are folded and the delta is applied to the
+ * btree record directly.
+ */
+enum {
+	M0_COB_BC_SHARDS_NR = 64,
+	M0_COB_BC_SLOTS_NR  = 8,
+	M0_COB_BC_FOLD_NR   = 256,
+};
+
+/** Persistent byte count delta slot. */
+struct m0_cob_bc_slot {
+	struct m0_cob_bckey bs_key;
+	uint64_t            bs_added;
+	uint64_t            bs_folded;
+};
+
 /**
  * In-memory representation of a component object.
  *
@@ -917,10 +963,32 @@ M0_INTERNAL int m0_cob_bc_insert(struct m0_cob *cob,
 				 struct m0_cob_bcrec *bc_val,
 				 struct m0_be_tx *tx);
 
+/**
+ * Adds @delta to the byte count of @bc_key, creating the record with a
+ * single cob object if it does not exist. The byte count does not go below
+ * zero: a negative delta is clamped when it is applied, so 100, -200, +50
+ * gives 50.
+ *
+ * A positive delta is normally deferred to a slot of shard @shard (taken modulo
+ * M0_COB_BC_SHARDS_NR) and folded into the btree later, see
+ * m0_cob_bc_slot. Callers running in a fom pass their locality index, so
+ * that concurrent writers do not share a lock.
+ *
+ * Transaction credit: M0_COB_OP_BYTECOUNT_ADD.
+ */
+M0_INTERNAL int m0_cob_bc_add(struct m0_cob       *cob,
+			      struct m0_cob_bckey *bc_key,
+			      int64_t              delta,
+			      uint64_t             shard,
+			      struct m0_be_tx     *tx);
+
 /**
  * Updates a record in the bytecount table
  * If the update fails, it returns error.
  *
+ * The btree value is overwritten; deltas pending in the slots of
+ * m0_cob_bc_add() are still added on top of it by lookups.
+ *
  * @param cob    cob btree to store byte count.
  * @param bc_key pool version fid and user_id.
  * @param bc_rec byte count for the given pool version.
@@ -1114,6 +1182,7 @@ enum m0_cob_op {
 	M0_COB_OP_BYTECOUNT_SET,
 	M0_COB_OP_BYTECOUNT_DEL,
 	M0_COB_OP_BYTECOUNT_UPDATE,
+	M0_COB_OP_BYTECOUNT_ADD,
 } M0_XCA_ENUM;
 
 M0_INTERNAL void m0_cob_tx_credit(struct m0_cob_domain *dom,
@@ -31,6 +31,8 @@
 
 enum {
 	KEY_VAL_NR = 10,
+	/* Enough rounds for every key slot to be folded at least once. */
+	BC_ADD_ROUNDS = M0_COB_BC_FOLD_NR + 10,
 };
 
 static struct m0_cob_domain_id  id = { 42 };
@@ -40,6 +42,11 @@ static struct m0_cob_domain    *dom;
 static struct m0_cob           *cob;
 struct m0_cob_bckey             bckey[KEY_VAL_NR] = {};
 struct m0_cob_bcrec             bcrec[KEY_VAL_NR] = {};
+static uint64_t                 bc_expect[KEY_VAL_NR + 1];
+static struct m0_cob_bckey      bc_new_key = {
+	.cbk_pfid    = M0_FID_TINIT('k', 2, 0),
+	.cbk_user_id = 7
+};
 
 
 static int ut_init(void)
@@ -266,6 +273,127 @@ void test_update(void)
 	m0_be_tx_fini(tx);
 }
 
+static void bc_check(const struct m0_cob_bckey *key, uint64_t bytecount,
+		     uint64_t objects)
+{
+	struct m0_cob_bcrec out_rec = {};
+	int                 rc;
+
+	rc = m0_cob_bc_lookup(cob, (struct m0_cob_bckey *)key, &out_rec);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(out_rec.cbr_bytecount == bytecount);
+	M0_UT_ASSERT(out_rec.cbr_cob_objects == objects);
+}
+
+void test_add(void)
+{
+	struct m0_be_tx         tx_;
+	struct m0_be_tx        *tx = &tx_;
+	struct m0_be_tx_credit  accum;
+	struct m0_buf           keys;
+	struct m0_buf           recs;
+	struct m0_cob_bcrec    *rcurr;
+	uint32_t                count;
+	int                     rc;
+	int                     i;
+	int                     j;
+
+	for (i = 0; i < KEY_VAL_NR; i++)
+		bc_expect[i] = bcrec[i].cbr_bytecount;
+
+	/*
+	 * More keys than slots per shard and more rounds than
+	 * M0_COB_BC_FOLD_NR: exercises deferred additions, folds and slot
+	 * rebinding.
+	 */
+	for (j = 0; j < BC_ADD_ROUNDS; j++) {
+		accum = M0_BE_TX_CREDIT(0, 0);
+		for (i = 0; i < KEY_VAL_NR; i++)
+			m0_cob_tx_credit(dom, M0_COB_OP_BYTECOUNT_ADD, &accum);
+		ut_tx_open(tx, &accum);
+		for (i = 0; i < KEY_VAL_NR; i++) {
+			rc = m0_cob_bc_add(cob, &bckey[i], j + 1, j % 3, tx);
+			M0_UT_ASSERT(rc == 0);
+			bc_expect[i] += j + 1;
+		}
+		m0_be_tx_close_sync(tx);
+		m0_be_tx_fini(tx);
+		if (j % 50 == 0) {
+			for (i = 0; i < KEY_VAL_NR; i++)
+				bc_check(&bckey[i], bc_expect[i],
+					 bcrec[i].cbr_cob_objects);
+		}
+	}
+
+	/* Negative deltas stop at zero, new keys get a single object. */
+	accum = M0_BE_TX_CREDIT(0, 0);
+	m0_cob_tx_credit(dom, M0_COB_OP_BYTECOUNT_ADD, &accum);
+	m0_cob_tx_credit(dom, M0_COB_OP_BYTECOUNT_ADD, &accum);
+	ut_tx_open(tx, &accum);
+	rc = m0_cob_bc_add(cob, &bckey[0], -(int64_t)bc_expect[0] - 5, 1, tx);
+	M0_UT_ASSERT(rc == 0);
+	bc_expect[0] = 0;
+	rc = m0_cob_bc_add(cob, &bc_new_key, 4096, 5, tx);
+	M0_UT_ASSERT(rc == 0);
+	bc_expect[KEY_VAL_NR] = 4096;
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+
+	for (i = 0; i < KEY_VAL_NR; i++)
+		bc_check(&bckey[i], bc_expect[i], bcrec[i].cbr_cob_objects);
+	bc_check(&bc_new_key, bc_expect[KEY_VAL_NR], 1);
+
+	/*
+	 * Negative deltas are clamped when applied, not when summed, also
+	 * with deltas pending in other shards: X, -(X + 100), +50, +30, -20
+	 * gives 60.
+	 */
+	accum = M0_BE_TX_CREDIT(0, 0);
+	for (i = 0; i < 4; i++)
+		m0_cob_tx_credit(dom, M0_COB_OP_BYTECOUNT_ADD, &accum);
+	ut_tx_open(tx, &accum);
+	rc = m0_cob_bc_add(cob, &bckey[1], -(int64_t)bc_expect[1] - 100, 0,
+			   tx);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_cob_bc_add(cob, &bckey[1], 50, 1, tx);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_cob_bc_add(cob, &bckey[1], 30, 2, tx);
+	M0_UT_ASSERT(rc == 0);
+	bc_check(&bckey[1], 80, bcrec[1].cbr_cob_objects);
+	rc = m0_cob_bc_add(cob, &bckey[1], -20, 0, tx);
+	M0_UT_ASSERT(rc == 0);
+	bc_expect[1] = 60;
+	m0_be_tx_close_sync(tx);
+	m0_be_tx_fini(tx);
+	bc_check(&bckey[1], bc_expect[1], bcrec[1].cbr_cob_objects);
+
+	rc = m0_cob_bc_entries_dump(cob->co_dom, &keys, &recs, &count);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(count == KEY_VAL_NR + 1);
+	rcurr = (struct m0_cob_bcrec *)recs.b_addr;
+	for (i = 0; i < KEY_VAL_NR; i++)
+		M0_UT_ASSERT(rcurr[i].cbr_bytecount == bc_expect[i]);
+	M0_UT_ASSERT(rcurr[KEY_VAL_NR].cbr_bytecount ==
+		     bc_expect[KEY_VAL_NR]);
+	m0_buf_free(&keys);
+	m0_buf_free(&recs);
+}
+
+void test_add_reinit(void)
+{
+	struct m0_be_seg *seg0 = m0_be_domain_seg0_get(&ut_be.but_dom);
+	int               i;
+	int               rc;
+
+	/* Deferred deltas are persistent: they survive domain re-init. */
+	m0_cob_domain_fini(dom);
+	rc = m0_cob_domain_init(dom, seg0);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < KEY_VAL_NR; i++)
+		bc_check(&bckey[i], bc_expect[i], bcrec[i].cbr_cob_objects);
+	bc_check(&bc_new_key, bc_expect[KEY_VAL_NR], 1);
+}
+
 struct m0_ut_suite bytecount_ut = {
 	.ts_name = "bytecount-ut",
 	.ts_init = ut_init,
@@ -278,6 +406,8 @@ struct m0_ut_suite bytecount_ut = {
 		{ "bc-tree-iterator", test_iterator },
 		{ "bc-tree-lookup",   test_lookup },
 		{ "bc-tree-update",   test_update },
+		{ "bc-add",           test_add },
+		{ "bc-add-reinit",    test_add_reinit },
 		{ "cob-dom-fini",     test_fini },
 		{ NULL, NULL }
 	}
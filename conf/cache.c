@@ -27,6 +27,7 @@
 #include "conf/obj_ops.h"   /* m0_conf_obj_delete */
 #include "conf/preload.h"   /* m0_confx_to_string */
 #include "motr/magic.h"     /* M0_CONF_OBJ_MAGIC, M0_CONF_CACHE_MAGIC */
+#include "fid/fid.h"        /* m0_fid_hash */
 #include "conf/onwire.h"    /* m0_confx */
 #include "lib/errno.h"      /* EEXIST */
 #include "lib/memory.h"     /* M0_ALLOC_PTR, M0_ALLOC_ARR */
@@ -37,6 +38,14 @@
  * The implementation of m0_conf_cache::ca_registry is based on linked
  * list data structure.
  *
+ * m0_conf_cache::ca_index duplicates the registry in a fid-keyed hash
+ * table.  It starts with CONF_CACHE_INDEX_MIN buckets and is rebuilt with
+ * CONF_CACHE_INDEX_GROWTH times more buckets whenever the average chain
+ * grows longer than CONF_CACHE_INDEX_LOAD objects, so that loading a
+ * configuration of N objects costs O(N) instead of O(N^2).  A failure to
+ * allocate (or grow) the table is not fatal: an uninitialised index makes
+ * m0_conf_cache_lookup() scan the registry, a small one makes it slower.
+ *
  * @see @ref conf, @ref conf-lspec
  *
  * @{
@@ -47,6 +56,86 @@ M0_TL_DESCR_DEFINE(m0_conf_cache, "registered m0_conf_obj-s", ,
 		   M0_CONF_OBJ_MAGIC, M0_CONF_CACHE_MAGIC);
 M0_TL_DEFINE(m0_conf_cache, M0_INTERNAL, struct m0_conf_obj);
 
+enum {
+	CONF_CACHE_INDEX_MIN    = 64,
+	CONF_CACHE_INDEX_LOAD   = 2,
+	CONF_CACHE_INDEX_GROWTH = 4,
+};
+
+static uint64_t conf_cache_index_hash(const struct m0_htable *htable,
+				      const struct m0_fid *fid)
+{
+	return m0_fid_hash(fid) % htable->h_bucket_nr;
+}
+
+static bool conf_cache_index_key_eq(const struct m0_fid *fid1,
+				    const struct m0_fid *fid2)
+{
+	return m0_fid_eq(fid1, fid2);
+}
+
+M0_HT_DESCR_DEFINE(conf_cache_index, "m0_conf_obj-s indexed by fid", static,
+		   struct m0_conf_obj, co_index_link, co_gen_magic,
+		   M0_CONF_OBJ_MAGIC, M0_CONF_CACHE_INDEX_MAGIC,
+		   co_id, conf_cache_index_hash, conf_cache_index_key_eq);
+M0_HT_DEFINE(conf_cache_index, static, struct m0_conf_obj, struct m0_fid);
+
+static bool conf_cache_index_is_init(const struct m0_conf_cache *cache)
+{
+	return cache->ca_index.h_buckets != NULL;
+}
+
+/**
+ * Moves indexed objects to a larger hash table.
+ *
+ * Keeps the current table if the new one cannot be allocated.
+ */
+static void conf_cache_index_grow(struct m0_conf_cache *cache)
+{
+	struct m0_htable    larger;
+	struct m0_conf_obj *obj;
+	uint64_t            nr;
+	int                 rc;
+
+	nr = cache->ca_index.h_bucket_nr * CONF_CACHE_INDEX_GROWTH;
+	rc = conf_cache_index_htable_init(&larger, nr);
+	if (rc != 0) {
+		M0_LOG(M0_WARN, "Cannot grow conf cache index to %"PRIu64
+		       " buckets: rc=%d", nr, rc);
+		return;
+	}
+	m0_htable_for(conf_cache_index, obj, &cache->ca_index) {
+		conf_cache_index_htable_del(&cache->ca_index, obj);
+		conf_cache_index_htable_add(&larger, obj);
+	} m0_htable_endfor;
+	conf_cache_index_htable_fini(&cache->ca_index);
+	cache->ca_index = larger;
+}
+
+static void conf_cache_index_add(struct m0_conf_cache *cache,
+				 struct m0_conf_obj *obj)
+{
+	conf_cache_index_tlink_init(obj);
+	if (!conf_cache_index_is_init(cache))
+		return;
+	if (cache->ca_index_nr >=
+	    cache->ca_index.h_bucket_nr * CONF_CACHE_INDEX_LOAD)
+		conf_cache_index_grow(cache);
+	conf_cache_index_htable_add(&cache->ca_index, obj);
+	++cache->ca_index_nr;
+}
+
+static void conf_cache_index_del(struct m0_conf_cache *cache,
+				 struct m0_conf_obj *obj)
+{
+	if (conf_cache_index_is_init(cache)) {
+		M0_ASSERT(cache->ca_index_nr > 0);
+		conf_cache_index_htable_del(&cache->ca_index, obj);
+		--cache->ca_index_nr;
+	}
+	conf_cache_index_tlink_fini(obj);
+}
+
 M0_INTERNAL void m0_conf_cache_lock(struct m0_conf_cache *cache)
 {
 	m0_mutex_lock(cache->ca_lock);
@@ -62,15 +151,38 @@ M0_INTERNAL bool m0_conf_cache_is_locked(const struct m0_conf_cache *cache)
 	return m0_mutex_is_locked(cache->ca_lock);
 }
 
+M0_INTERNAL void m0_conf_cache_ha_batch_begin(struct m0_conf_cache *cache)
+{
+	M0_PRE(m0_conf_cache_is_locked(cache));
+	M0_CNT_INC(cache->ca_ha_batch);
+}
+
+M0_INTERNAL void m0_conf_cache_ha_batch_end(struct m0_conf_cache *cache)
+{
+	M0_PRE(m0_conf_cache_is_locked(cache));
+	M0_CNT_DEC(cache->ca_ha_batch);
+	if (cache->ca_ha_batch == 0)
+		m0_chan_broadcast(&cache->ca_ha_batch_chan);
+}
+
 M0_INTERNAL void
 m0_conf_cache_init(struct m0_conf_cache *cache, struct m0_mutex *lock)
 {
 	M0_ENTRY();
 
 	m0_conf_cache_tlist_init(&cache->ca_registry);
+	M0_SET0(&cache->ca_index);
+	cache->ca_index_nr = 0;
+	if (conf_cache_index_htable_init(&cache->ca_index,
+					 CONF_CACHE_INDEX_MIN) != 0) {
+		M0_LOG(M0_WARN, "No conf cache index, lookups will be slow");
+		M0_SET0(&cache->ca_index);
+	}
 	cache->ca_lock = lock;
 	cache->ca_ver  = 0;
 	cache->ca_fid_counter = 0;
+	cache->ca_ha_batch = 0;
+	m0_chan_init(&cache->ca_ha_batch_chan, lock);
 
 	M0_LEAVE();
 }
@@ -88,6 +200,7 @@ m0_conf_cache_add(struct m0_conf_cache *cache, struct m0_conf_obj *obj)
 	if (x != NULL)
 		return M0_ERR(-EEXIST);
 	m0_conf_cache_tlist_add(&cache->ca_registry, obj);
+	conf_cache_index_add(cache, obj);
 	return M0_RC(0);
 }
 
@@ -106,28 +219,31 @@ M0_INTERNAL struct m0_conf_obj *
 m0_conf_cache_lookup(const struct m0_conf_cache *cache,
 		     const struct m0_fid *id)
 {
+	if (conf_cache_index_is_init(cache))
+		return conf_cache_index_htable_lookup(&cache->ca_index, id);
 	return m0_tl_find(m0_conf_cache, obj, &cache->ca_registry,
 			  m0_fid_eq(&obj->co_id, id));
 }
 
-static void _obj_del(struct m0_conf_obj *obj)
+static void _obj_del(struct m0_conf_cache *cache, struct m0_conf_obj *obj)
 {
 	M0_ENTRY("obj="FID_F, FID_P(&obj->co_id));
 
 	m0_conf_cache_tlist_del(obj);
+	conf_cache_index_del(cache, obj);
 	m0_conf_obj_delete(obj);
 
 	M0_LEAVE();
 }
 
 M0_INTERNAL void
-m0_conf_cache_del(const struct m0_conf_cache *cache, struct m0_conf_obj *obj)
+m0_conf_cache_del(struct m0_conf_cache *cache, struct m0_conf_obj *obj)
 {
 	M0_ENTRY();
 	M0_PRE(m0_conf_cache_is_locked(cache));
 	M0_PRE(m0_conf_cache_tlist_contains(&cache->ca_registry, obj));
 
-	_obj_del(obj);
+	_obj_del(cache, obj);
 
 	M0_LEAVE();
 }
@@ -159,7 +275,7 @@ static void conf_cache_clean(struct m0_conf_cache *cache,
 		if (type == NULL || m0_conf_obj_type(obj) == type) {
 			if (gc && !obj->co_deleted)
 				continue;
-			_obj_del(obj);
+			_obj_del(cache, obj);
 		}
 	} m0_tl_endfor;
 	M0_LEAVE();
@@ -187,6 +303,12 @@ M0_INTERNAL void m0_conf_cache_fini(struct m0_conf_cache *cache)
 	m0_conf_cache_lock(cache);
 	m0_conf_cache_clean(cache, NULL);
 	m0_conf_cache_tlist_fini(&cache->ca_registry);
+	if (conf_cache_index_is_init(cache)) {
+		M0_ASSERT(cache->ca_index_nr == 0);
+		conf_cache_index_htable_fini(&cache->ca_index);
+	}
+	M0_ASSERT(cache->ca_ha_batch == 0);
+	m0_chan_fini(&cache->ca_ha_batch_chan);
 	m0_conf_cache_unlock(cache);
 
 	M0_LEAVE();
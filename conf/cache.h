@@ -25,6 +25,8 @@
 
 #include "conf/obj.h"
 #include "lib/tlist.h"  /* M0_TL_DESCR_DECLARE */
+#include "lib/hash.h"   /* m0_htable */
+#include "lib/chan.h"   /* m0_chan */
 
 struct m0_mutex;
 
@@ -47,6 +49,10 @@ M0_TL_DECLARE(m0_conf_cache, M0_INTERNAL, struct m0_conf_obj);
  *     After an object has been added to the registry, any attempt to
  *     add another one with similar identity will fail;
  *
+ *   - indexes registered objects by fid (m0_conf_cache::ca_index), so
+ *     that m0_conf_cache_lookup() does not depend on the number of
+ *     cached objects;
+ *
  *   - simplifies erasing of configuration cache.
  *     m0_conf_cache_fini() frees all configuration objects that are
  *     registered. No sophisticated DAG traversal is needed.
@@ -98,6 +104,19 @@ struct m0_conf_cache {
 	 */
 	struct m0_tl     ca_registry;
 
+	/**
+	 * Hash table of m0_conf_obj-s keyed by m0_conf_obj::co_id,
+	 * linked through m0_conf_obj::co_index_link.
+	 *
+	 * Contains the same objects as ->ca_registry. The table is grown
+	 * as objects are added. If it cannot be allocated, lookups fall
+	 * back to scanning ->ca_registry.
+	 */
+	struct m0_htable ca_index;
+
+	/** Number of objects in ->ca_index. */
+	uint64_t         ca_index_nr;
+
 	/** Cache lock. */
 	struct m0_mutex *ca_lock;
 
@@ -109,6 +128,22 @@ struct m0_conf_cache {
 	 * fids of newly created m0_conf_objv objects.
 	 */
 	uint64_t         ca_fid_counter;
+
+	/**
+	 * Nesting depth of m0_conf_cache_ha_batch_begin().
+	 *
+	 * While it is non-zero, the cached objects are being updated by a
+	 * batch of HA state changes. Subscribers to m0_conf_obj::co_ha_chan
+	 * may postpone work that is needed only once per batch by adding a
+	 * (usually one-shot) clink to ->ca_ha_batch_chan.
+	 */
+	uint32_t         ca_ha_batch;
+
+	/**
+	 * Broadcast by the outermost m0_conf_cache_ha_batch_end().
+	 * Protected by ->ca_lock.
+	 */
+	struct m0_chan   ca_ha_batch_chan;
 };
 
 /** Initialises configuration cache. */
@@ -126,6 +161,24 @@ M0_INTERNAL void m0_conf_cache_lock(struct m0_conf_cache *cache);
 M0_INTERNAL void m0_conf_cache_unlock(struct m0_conf_cache *cache);
 M0_INTERNAL bool m0_conf_cache_is_locked(const struct m0_conf_cache *cache);
 
+/**
+ * Marks the beginning of a batch of HA state changes applied to the cache.
+ *
+ * Batches nest; see m0_conf_cache::ca_ha_batch.
+ *
+ * @pre  m0_conf_cache_is_locked(cache)
+ */
+M0_INTERNAL void m0_conf_cache_ha_batch_begin(struct m0_conf_cache *cache);
+
+/**
+ * Ends a batch started by m0_conf_cache_ha_batch_begin(). The outermost call
+ * broadcasts m0_conf_cache::ca_ha_batch_chan.
+ *
+ * @pre  m0_conf_cache_is_locked(cache)
+ * @pre  cache->ca_ha_batch > 0
+ */
+M0_INTERNAL void m0_conf_cache_ha_batch_end(struct m0_conf_cache *cache);
+
 /**
  * Deletes registered objects of specific type or, if `type' is NULL,
  * all registered configuration objects.
@@ -162,7 +215,7 @@ M0_INTERNAL int m0_conf_cache_add(struct m0_conf_cache *cache,
  * @pre  m0_conf_cache_is_locked(cache)
  * @pre  m0_conf_cache_tlist_contains(&cache->ca_registry, obj)
  */
-M0_INTERNAL void m0_conf_cache_del(const struct m0_conf_cache *cache,
+M0_INTERNAL void m0_conf_cache_del(struct m0_conf_cache *cache,
 				   struct m0_conf_obj *obj);
 
 /**
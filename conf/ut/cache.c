@@ -30,6 +30,7 @@
 #include "lib/errno.h"     /* ENOENT */
 #include "lib/fs.h"        /* m0_file_read */
 #include "lib/memory.h"    /* m0_free0 */
+#include "lib/ub.h"        /* m0_ub_set */
 #include "ut/misc.h"       /* M0_UT_PATH */
 #include "ut/ut.h"
 
@@ -128,6 +129,47 @@ static void test_cache(void)
 	m0_conf_cache_unlock(&m0_conf_ut_cache);
 }
 
+enum { INDEX_UT_OBJS_NR = 1000 };
+
+static struct m0_fid index_ut_fid(uint64_t i)
+{
+	return M0_FID_TINIT(M0_CONF_SDEV_TYPE.cot_ftype.ft_id, 1, i);
+}
+
+static void test_cache_index(void)
+{
+	struct m0_conf_obj *obj;
+	struct m0_fid       fid;
+	uint64_t            i;
+
+	for (i = 0; i < INDEX_UT_OBJS_NR; ++i) {
+		fid = index_ut_fid(i);
+		ut_conf_obj_create(&fid, &obj);
+	}
+	/* The index has grown past its initial size. */
+	M0_UT_ASSERT(m0_conf_ut_cache.ca_index_nr >= INDEX_UT_OBJS_NR);
+	M0_UT_ASSERT(m0_conf_ut_cache.ca_index.h_bucket_nr >
+		     INDEX_UT_OBJS_NR / 4);
+	for (i = 0; i < INDEX_UT_OBJS_NR; ++i) {
+		fid = index_ut_fid(i);
+		obj = m0_conf_cache_lookup(&m0_conf_ut_cache, &fid);
+		M0_UT_ASSERT(obj != NULL && m0_fid_eq(&obj->co_id, &fid));
+		if (i % 2 == 0)
+			ut_conf_obj_delete(obj);
+	}
+	for (i = 0; i < INDEX_UT_OBJS_NR; ++i) {
+		fid = index_ut_fid(i);
+		obj = m0_conf_cache_lookup(&m0_conf_ut_cache, &fid);
+		M0_UT_ASSERT((obj == NULL) == (i % 2 == 0));
+	}
+
+	m0_conf_cache_lock(&m0_conf_ut_cache);
+	m0_conf_cache_clean(&m0_conf_ut_cache, &M0_CONF_SDEV_TYPE);
+	m0_conf_cache_unlock(&m0_conf_ut_cache);
+	M0_UT_ASSERT(m0_conf_ut_cache.ca_index_nr ==
+		     m0_conf_cache_tlist_length(&m0_conf_ut_cache.ca_registry));
+}
+
 static void test_obj_find(void)
 {
 	int                 rc;
@@ -190,9 +232,107 @@ struct m0_ut_suite conf_ut = {
 	.ts_tests = {
 		{ "obj-xtors",   test_obj_xtors },
 		{ "cache",       test_cache     },
+		{ "cache-index", test_cache_index },
 		{ "obj-find",    test_obj_find  },
 		{ "obj-fill",    test_obj_fill  },
 		{ "dir-add-del", test_dir_add_del },
 		{ NULL, NULL }
 	}
 };
+
+enum {
+	CACHE_UB_DEVICES_NR = 8192,
+	CACHE_UB_LOAD_ITER  = 8,
+	CACHE_UB_ITER       = 200000,
+};
+
+static struct m0_mutex      cache_ub_lock;
+static struct m0_conf_cache cache_ub;
+
+static struct m0_fid cache_ub_fid(uint64_t i)
+{
+	return M0_FID_TINIT(i % 2 == 0 ? M0_CONF_SDEV_TYPE.cot_ftype.ft_id :
+			    M0_CONF_DRIVE_TYPE.cot_ftype.ft_id, 1, i / 2);
+}
+
+/**
+ * Populates cache_ub with stubs of CACHE_UB_DEVICES_NR sdevs and as many
+ * drives, the way m0_conf_cache_from_string() does it.
+ */
+static void cache_ub_load(void)
+{
+	struct m0_conf_obj *obj;
+	struct m0_fid       fid;
+	uint64_t            i;
+	int                 rc;
+
+	m0_conf_cache_init(&cache_ub, &cache_ub_lock);
+	m0_conf_cache_lock(&cache_ub);
+	for (i = 0; i < 2 * CACHE_UB_DEVICES_NR; ++i) {
+		fid = cache_ub_fid(i);
+		rc = m0_conf_obj_find(&cache_ub, &fid, &obj);
+		M0_UB_ASSERT(rc == 0);
+	}
+	m0_conf_cache_unlock(&cache_ub);
+}
+
+static void cache_ub_unload(void)
+{
+	m0_conf_cache_fini(&cache_ub);
+}
+
+static int cache_ub_init(const char *opts M0_UNUSED)
+{
+	m0_mutex_init(&cache_ub_lock);
+	return 0;
+}
+
+static void cache_ub_fini(void)
+{
+	m0_mutex_fini(&cache_ub_lock);
+}
+
+static void cache_ub_load_round(int i M0_UNUSED)
+{
+	cache_ub_load();
+	cache_ub_unload();
+}
+
+static void cache_ub_lookup(int i)
+{
+	struct m0_fid fid = cache_ub_fid(m0_hash(i) %
+					 (2 * CACHE_UB_DEVICES_NR));
+
+	M0_UB_ASSERT(m0_conf_cache_lookup(&cache_ub, &fid) != NULL);
+}
+
+static void cache_ub_scan(int i)
+{
+	struct m0_fid fid = cache_ub_fid(m0_hash(i) %
+					 (2 * CACHE_UB_DEVICES_NR));
+
+	M0_UB_ASSERT(m0_tl_find(m0_conf_cache, obj, &cache_ub.ca_registry,
+				m0_fid_eq(&obj->co_id, &fid)) != NULL);
+}
+
+struct m0_ub_set m0_conf_cache_ub = {
+	.us_name = "conf-cache-ub",
+	.us_init = cache_ub_init,
+	.us_fini = cache_ub_fini,
+	.us_run  = {
+		{ .ub_name  = "load",
+		  .ub_iter  = CACHE_UB_LOAD_ITER,
+		  .ub_round = cache_ub_load_round },
+		{ .ub_name  = "lookup",
+		  .ub_iter  = CACHE_UB_ITER,
+		  .ub_init  = cache_ub_load,
+		  .ub_round = cache_ub_lookup,
+		  .ub_fini  = cache_ub_unload },
+		{ .ub_name  = "lookup-scan",
+		  .ub_iter  = CACHE_UB_ITER / 100,
+		  .ub_init  = cache_ub_load,
+		  .ub_round = cache_ub_scan,
+		  .ub_fini  = cache_ub_unload },
+		{ .ub_name = NULL }
+	}
+};
@@ -0,0 +1,627 @@
+/*
+ * Copyright (c) 2012-2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "lib/assert.h"
+#include "lib/arith.h"             /* min_check */
+#include "motr/magic.h"
+#include "desim/sim.h"
+#include "desim/net.h"
+#include "desim/elevator.h"
+#include "desim/mio.h"
+#include "layout/linear_enum.h"    /* struct m0_layout_linear_enum */
+
+/**
+   @addtogroup desim desim
+   @{
+ */
+
+struct mio_rpc {
+	struct mio_thread *mr_thread;
+	struct mio_srv    *mr_srv;
+	unsigned           mr_loc;
+	bool               mr_write;
+	unsigned           mr_nr;
+	struct mio_unit    mr_unit[MIO_RPC_UNITS_MAX];
+	/** Time the rpc was placed to the locality queue. */
+	sim_time_t         mr_queued;
+	/** Signalled when the fom is done with its non-blocking part. */
+	struct sim_chan    mr_wait;
+	/** Linkage to mio_client::mcl_queue, then to mio_loc::ml_queue. */
+	struct m0_tlink    mr_linkage;
+	uint64_t           mr_magic;
+};
+
+M0_TL_DESCR_DEFINE(mrpc, "mio rpcs", static, struct mio_rpc,
+		   mr_linkage, mr_magic, M0_DESIM_MIO_RPC_MAGIC,
+		   M0_DESIM_MIO_RPC_HEAD_MAGIC);
+M0_TL_DEFINE(mrpc, static, struct mio_rpc);
+
+static sim_time_t mio_xfer_time(m0_bcount_t nob, unsigned long long rate)
+{
+	return rate == 0 ? 0 : nob * 1000000000ULL / rate;
+}
+
+static struct mio_srv *mio_unit_srv(const struct mio_conf *conf,
+				    const struct mio_unit *u)
+{
+	return &conf->mc_srv[u->mu_obj / conf->mc_nr_devices];
+}
+
+/* BE */
+
+/**
+ * Places a transaction of @nob log bytes to the BE log of @srv and waits
+ * until it is committed.
+ */
+static void mio_be_tx(struct sim_thread *t, struct mio_srv *srv,
+		      m0_bcount_t nob)
+{
+	struct mio_conf *conf = srv->ms_conf;
+	struct mio_be   *be   = &srv->ms_be;
+	uint64_t         seq;
+
+	while (be->mb_log_used + nob > conf->mc_be_log_size)
+		sim_chan_wait(&be->mb_space, t);
+	be->mb_log_used += nob;
+	be->mb_pending  += nob;
+	seq = ++be->mb_seq_open;
+	sim_chan_signal(&be->mb_log_wait);
+	while (be->mb_seq_committed < seq)
+		sim_chan_wait(&be->mb_commit, t);
+}
+
+/** Writes pending transactions to the log, one group commit at a time. */
+static void mio_be_log_loop(struct sim *s, struct sim_thread *t, void *arg)
+{
+	struct mio_srv  *srv  = arg;
+	struct mio_conf *conf = srv->ms_conf;
+	struct mio_be   *be   = &srv->ms_be;
+	m0_bcount_t      batch;
+	uint64_t         upto;
+
+	while (1) {
+		while (be->mb_pending == 0) {
+			if (conf->mc_shutdown)
+				sim_thread_exit(t);
+			sim_chan_wait(&be->mb_log_wait, t);
+		}
+		batch = be->mb_pending;
+		upto  = be->mb_seq_open;
+		be->mb_pending = 0;
+		sim_sleep(t, conf->mc_be_log_latency +
+			  mio_xfer_time(batch, conf->mc_be_log_rate));
+		be->mb_seq_committed = upto;
+		be->mb_dirty += batch;
+		cnt_mod(&be->mb_batch, batch);
+		sim_chan_broadcast(&be->mb_commit);
+		if (be->mb_dirty >= conf->mc_be_wb_threshold)
+			sim_chan_signal(&be->mb_wb_wait);
+	}
+}
+
+/** Writes dirty segment pages back, releasing log space. */
+static void mio_be_wb_loop(struct sim *s, struct sim_thread *t, void *arg)
+{
+	struct mio_srv  *srv  = arg;
+	struct mio_conf *conf = srv->ms_conf;
+	struct mio_be   *be   = &srv->ms_be;
+	m0_bcount_t      chunk;
+
+	while (1) {
+		while (be->mb_dirty == 0 ||
+		       be->mb_dirty < conf->mc_be_wb_threshold) {
+			if (conf->mc_shutdown)
+				sim_thread_exit(t);
+			sim_chan_wait(&be->mb_wb_wait, t);
+		}
+		chunk = be->mb_dirty;
+		sim_log(s, SLL_TRACE, "S#%s: write-back %10" PRIu64 "\n",
+			srv->ms_name, chunk);
+		sim_sleep(t, mio_xfer_time(chunk, conf->mc_be_seg_rate));
+		M0_ASSERT(be->mb_log_used >= chunk);
+		be->mb_dirty    -= chunk;
+		be->mb_log_used -= chunk;
+		sim_chan_broadcast(&be->mb_space);
+	}
+}
+
+/* IOSERVICE */
+
+/** Executes non-blocking parts of foms in the locality. */
+static void mio_loc_loop(struct sim *s, struct sim_thread *t, void *arg)
+{
+	struct mio_loc  *loc  = arg;
+	struct mio_conf *conf = loc->ml_srv->ms_conf;
+	struct mio_rpc  *rpc;
+
+	while (1) {
+		while (mrpc_tlist_is_empty(&loc->ml_queue)) {
+			if (conf->mc_shutdown)
+				sim_thread_exit(t);
+			sim_chan_wait(&loc->ml_incoming, t);
+		}
+		rpc = mrpc_tlist_pop(&loc->ml_queue);
+		cnt_mod(&rpc->mr_srv->ms_loc_wait, s->ss_bolt - rpc->mr_queued);
+		sim_sleep(t, sim_rnd(conf->mc_fom_cpu_min,
+				     conf->mc_fom_cpu_max) +
+			  rpc->mr_nr * conf->mc_unit_cpu);
+		sim_chan_signal(&rpc->mr_wait);
+	}
+}
+
+/** Sends @rpc and waits until the ioservice completes it. */
+static void mio_rpc_exec(struct sim_thread *t, struct mio_rpc *rpc)
+{
+	struct mio_srv  *srv  = rpc->mr_srv;
+	struct mio_conf *conf = srv->ms_conf;
+	struct net_conf *net  = conf->mc_net;
+	struct mio_loc  *loc  = &srv->ms_loc[rpc->mr_loc];
+	unsigned         sect = srv->ms_el[0].e_dev->sd_conf->sc_sector_size;
+	m0_bcount_t      nob  = rpc->mr_nr * conf->mc_unitsize;
+	unsigned         i;
+
+	net_tx(t, net, net->nc_rpc_size,
+	       net->nc_rpc_delay_min, net->nc_rpc_delay_max);
+	rpc->mr_queued = t->st_sim->ss_bolt;
+	mrpc_tlist_add_tail(&loc->ml_queue, rpc);
+	sim_chan_signal(&loc->ml_incoming);
+	sim_chan_wait(&rpc->mr_wait, t);
+	if (rpc->mr_write)
+		net_tx(t, net, nob, mio_xfer_time(nob, net->nc_rate_max),
+		       mio_xfer_time(nob, net->nc_rate_min));
+	for (i = 0; i < rpc->mr_nr; ++i) {
+		const struct mio_unit *u = &rpc->mr_unit[i];
+
+		elevator_io(&srv->ms_el[u->mu_obj % conf->mc_nr_devices],
+			    rpc->mr_write ? SRT_WRITE : SRT_READ,
+			    u->mu_frame * conf->mc_unitsize / sect,
+			    conf->mc_unitsize / sect);
+	}
+	if (rpc->mr_write)
+		mio_be_tx(t, srv, rpc->mr_nr * conf->mc_be_tx_size);
+	else
+		net_tx(t, net, nob, mio_xfer_time(nob, net->nc_rate_max),
+		       mio_xfer_time(nob, net->nc_rate_min));
+	net_tx(t, net, net->nc_rpc_size,
+	       net->nc_rpc_delay_min, net->nc_rpc_delay_max);
+}
+
+/* CLIENT */
+
+static void mio_sender_loop(struct sim *s, struct sim_thread *t, void *arg)
+{
+	struct mio_client *cl = arg;
+	struct mio_rpc    *rpc;
+	struct mio_thread *mt;
+
+	while (1) {
+		while (mrpc_tlist_is_empty(&cl->mcl_queue)) {
+			if (cl->mcl_conf->mc_shutdown)
+				sim_thread_exit(t);
+			sim_chan_wait(&cl->mcl_send, t);
+		}
+		rpc = mrpc_tlist_pop(&cl->mcl_queue);
+		mt  = rpc->mr_thread;
+		mio_rpc_exec(t, rpc);
+		mrpc_tlink_fini(rpc);
+		sim_chan_fini(&rpc->mr_wait);
+		sim_free(rpc);
+		M0_ASSERT(mt->mt_outstanding > 0);
+		if (--mt->mt_outstanding == 0)
+			sim_chan_signal(&mt->mt_phase_done);
+	}
+}
+
+/**
+ * Transfers @nr units, batching units addressed to the same server into
+ * rpcs, and waits until all rpcs complete.
+ */
+static void mio_phase(struct mio_thread *mt, bool write,
+		      const struct mio_unit *u, unsigned nr)
+{
+	struct mio_client *cl   = mt->mt_client;
+	struct mio_conf   *conf = cl->mcl_conf;
+	struct mio_rpc    *rpc;
+	struct mio_srv    *srv;
+	unsigned           i;
+	unsigned           j;
+
+	for (i = 0; i < conf->mc_nr_servers; ++i) {
+		srv = &conf->mc_srv[i];
+		rpc = NULL;
+		for (j = 0; j < nr; ++j) {
+			if (mio_unit_srv(conf, &u[j]) != srv)
+				continue;
+			if (rpc == NULL ||
+			    rpc->mr_nr == conf->mc_rpc_units_max) {
+				if (rpc != NULL)
+					cnt_mod(&conf->mc_rpc_units,
+						rpc->mr_nr);
+				rpc = sim_alloc(sizeof *rpc);
+				rpc->mr_thread = mt;
+				rpc->mr_srv    = srv;
+				rpc->mr_write  = write;
+				rpc->mr_loc    = (u[j].mu_obj + cl->mcl_id) %
+						 conf->mc_nr_locs;
+				mrpc_tlink_init(rpc);
+				sim_chan_init(&rpc->mr_wait, NULL);
+				mrpc_tlist_add_tail(&cl->mcl_queue, rpc);
+				mt->mt_outstanding++;
+			}
+			rpc->mr_unit[rpc->mr_nr++] = u[j];
+		}
+		if (rpc != NULL)
+			cnt_mod(&conf->mc_rpc_units, rpc->mr_nr);
+	}
+	sim_chan_broadcast(&cl->mcl_send);
+	while (mt->mt_outstanding > 0)
+		sim_chan_wait(&mt->mt_phase_done, &mt->mt_thread);
+}
+
+static void mio_unit_map(struct m0_pdclust_instance *pi, m0_bindex_t grp,
+			 unsigned idx, struct mio_unit *u)
+{
+	const struct m0_pdclust_src_addr src = {
+		.sa_group = grp,
+		.sa_unit  = idx
+	};
+	struct m0_pdclust_tgt_addr       tgt;
+
+	m0_pdclust_instance_map(pi, &src, &tgt);
+	u->mu_obj   = tgt.ta_obj;
+	u->mu_frame = tgt.ta_frame;
+}
+
+static void mio_thread_loop(struct sim *s, struct sim_thread *t, void *arg)
+{
+	struct mio_thread          *mt   = arg;
+	struct mio_conf            *conf = mt->mt_client->mcl_conf;
+	struct m0_pdclust_instance *pi;
+	uint32_t                    N    = conf->mc_N;
+	uint32_t                    K    = conf->mc_K;
+	m0_bcount_t                 unit = conf->mc_unitsize;
+	m0_bcount_t                 gsize = N * unit;
+	struct mio_unit            *rd;
+	struct mio_unit            *wr;
+	unsigned                    rd_nr;
+	unsigned                    wr_nr;
+	unsigned                    grp_nr;
+	unsigned                    max_nr;
+	m0_bindex_t                 off;
+	m0_bindex_t                 grp;
+	sim_time_t                  start;
+
+	M0_ASSERT(t == &mt->mt_thread);
+
+	pi = m0_layout_instance_to_pdi(mt->mt_layout_instance);
+	max_nr = (conf->mc_io_size / gsize + 2) * (N + K);
+	rd = sim_alloc(max_nr * sizeof rd[0]);
+	wr = sim_alloc(max_nr * sizeof wr[0]);
+	for (off = 0; off < conf->mc_total; off += conf->mc_io_size) {
+		m0_bindex_t end = off + conf->mc_io_size;
+
+		sim_sleep(t, sim_rnd(conf->mc_delay_min, conf->mc_delay_max));
+		start = s->ss_bolt;
+		rd_nr = wr_nr = grp_nr = 0;
+		for (grp = off / gsize; grp * gsize < end; ++grp, ++grp_nr) {
+			unsigned u0 = max64u(off, grp * gsize) % gsize / unit;
+			unsigned u1 = (min64u(end, (grp + 1) * gsize) - 1) %
+				      gsize / unit;
+			unsigned nr = u1 - u0 + 1;
+			unsigned i;
+
+			if (conf->mc_read) {
+				for (i = u0; i <= u1; ++i)
+					mio_unit_map(pi, grp, i, &rd[rd_nr++]);
+				continue;
+			}
+			/* Read-modify-write: read-old or read-rest. */
+			if (nr < N && nr + K < N - nr) {
+				for (i = u0; i <= u1; ++i)
+					mio_unit_map(pi, grp, i, &rd[rd_nr++]);
+				for (i = N; i < N + K; ++i)
+					mio_unit_map(pi, grp, i, &rd[rd_nr++]);
+			} else if (nr < N) {
+				for (i = 0; i < N; ++i) {
+					if (i < u0 || i > u1)
+						mio_unit_map(pi, grp, i,
+							     &rd[rd_nr++]);
+				}
+			}
+			for (i = u0; i <= u1; ++i)
+				mio_unit_map(pi, grp, i, &wr[wr_nr++]);
+			for (i = N; i < N + K; ++i)
+				mio_unit_map(pi, grp, i, &wr[wr_nr++]);
+		}
+		M0_ASSERT(rd_nr <= max_nr && wr_nr <= max_nr);
+		if (!conf->mc_read)
+			cnt_mod(&conf->mc_rmw_units, rd_nr);
+		if (rd_nr > 0)
+			mio_phase(mt, false, rd, rd_nr);
+		if (wr_nr > 0) {
+			/* Parity of every touched group. */
+			sim_sleep(t, mio_xfer_time(grp_nr * gsize,
+						   conf->mc_parity_rate));
+			mio_phase(mt, true, wr, wr_nr);
+		}
+		cnt_mod(&conf->mc_op_lat, s->ss_bolt - start);
+		sim_log(s, SLL_TRACE, "C [%3i:%3i] %10" PRIu64 " rd: %u wr: %u"
+			" %llu\n", mt->mt_client->mcl_id, mt->mt_id, off,
+			rd_nr, wr_nr, s->ss_bolt - start);
+	}
+	sim_free(rd);
+	sim_free(wr);
+	conf->mc_end = max_check(conf->mc_end, s->ss_bolt);
+	sim_thread_exit(t);
+}
+
+static int mio_threads_start(struct sim_callout *call)
+{
+	struct mio_conf *conf = call->sc_datum;
+	struct sim      *s    = call->sc_sim;
+	unsigned         i;
+	unsigned         j;
+
+	for (i = 0; i < conf->mc_nr_servers; ++i) {
+		struct mio_srv *srv = &conf->mc_srv[i];
+
+		for (j = 0; j < conf->mc_nr_locs; ++j)
+			sim_thread_init(s, &srv->ms_loc[j].ml_thread, 0,
+					mio_loc_loop, &srv->ms_loc[j]);
+		sim_thread_init(s, &srv->ms_be.mb_log_thread, 0,
+				mio_be_log_loop, srv);
+		sim_thread_init(s, &srv->ms_be.mb_wb_thread, 0,
+				mio_be_wb_loop, srv);
+	}
+	for (i = 0; i < conf->mc_nr_clients; ++i) {
+		struct mio_client *c = &conf->mc_client[i];
+
+		for (j = 0; j < conf->mc_rpc_inflight; ++j)
+			sim_thread_init(s, &c->mcl_sender[j], 0,
+					mio_sender_loop, c);
+		for (j = 0; j < conf->mc_nr_threads; ++j)
+			sim_thread_init(s, &c->mcl_thread[j].mt_thread, 0,
+					mio_thread_loop, &c->mcl_thread[j]);
+	}
+	return 1;
+}
+
+static void mio_layout_build(struct mio_conf *conf)
+{
+	int                           result;
+	struct m0_layout_linear_attr  lin_attr;
+	struct m0_layout_linear_enum *lin_enum;
+	struct m0_pdclust_attr        pl_attr;
+	uint64_t                      lid;
+
+	result = m0_layout_domain_init(&conf->mc_l_dom);
+	M0_ASSERT(result == 0);
+
+	result = m0_layout_standard_types_register(&conf->mc_l_dom);
+	M0_ASSERT(result == 0);
+
+	lin_attr.lla_nr = conf->mc_pool_version.pv_attr.pa_P;
+	lin_attr.lla_A = 0;
+	lin_attr.lla_B = 1;
+	result = m0_linear_enum_build(&conf->mc_l_dom, &lin_attr, &lin_enum);
+	M0_ASSERT(result == 0);
+
+	pl_attr.pa_N = conf->mc_N;
+	pl_attr.pa_K = conf->mc_K;
+	pl_attr.pa_S = conf->mc_S;
+	pl_attr.pa_P = conf->mc_pool_version.pv_attr.pa_P;
+	pl_attr.pa_unit_size = conf->mc_unitsize;
+	lid = 0x4f495f5254304d; /* M0TR_IO */
+	m0_uint128_init(&pl_attr.pa_seed, "desim_motr_io_pd");
+
+	result = m0_pdclust_build(&conf->mc_l_dom, lid, &pl_attr,
+				  &lin_enum->lle_base, &conf->mc_pdclust);
+	M0_ASSERT(result == 0);
+}
+
+static void mio_srv_init(struct mio_conf *conf, struct mio_srv *srv,
+			 unsigned id)
+{
+	struct mio_be *be = &srv->ms_be;
+	unsigned       i;
+
+	srv->ms_conf = conf;
+	srv->ms_id   = id;
+	sim_name_set(&srv->ms_name, "%u", id);
+	srv->ms_el  = sim_alloc(conf->mc_nr_devices * sizeof srv->ms_el[0]);
+	srv->ms_loc = sim_alloc(conf->mc_nr_locs * sizeof srv->ms_loc[0]);
+	for (i = 0; i < conf->mc_nr_locs; ++i) {
+		srv->ms_loc[i].ml_srv = srv;
+		mrpc_tlist_init(&srv->ms_loc[i].ml_queue);
+		sim_chan_init(&srv->ms_loc[i].ml_incoming,
+			      "srv#%u::loc#%u::idle", id, i);
+	}
+	cnt_init(&srv->ms_loc_wait, NULL, "srv#%u::loc_wait", id);
+	sim_chan_init(&be->mb_log_wait, "srv#%u::be::log_idle", id);
+	sim_chan_init(&be->mb_commit, "srv#%u::be::commit_wait", id);
+	sim_chan_init(&be->mb_space, "srv#%u::be::log_space_wait", id);
+	sim_chan_init(&be->mb_wb_wait, "srv#%u::be::wb_idle", id);
+	cnt_init(&be->mb_batch, NULL, "srv#%u::be::group_commit_bytes", id);
+}
+
+static void mio_srv_fini(struct mio_conf *conf, struct mio_srv *srv)
+{
+	struct mio_be *be = &srv->ms_be;
+	unsigned       i;
+
+	for (i = 0; i < conf->mc_nr_locs; ++i) {
+		sim_thread_fini(&srv->ms_loc[i].ml_thread);
+		sim_chan_fini(&srv->ms_loc[i].ml_incoming);
+		mrpc_tlist_fini(&srv->ms_loc[i].ml_queue);
+	}
+	sim_thread_fini(&be->mb_log_thread);
+	sim_thread_fini(&be->mb_wb_thread);
+	sim_chan_fini(&be->mb_log_wait);
+	sim_chan_fini(&be->mb_commit);
+	sim_chan_fini(&be->mb_space);
+	sim_chan_fini(&be->mb_wb_wait);
+	cnt_fini(&be->mb_batch);
+	cnt_fini(&srv->ms_loc_wait);
+	sim_free(srv->ms_loc);
+	sim_free(srv->ms_el);
+	sim_free(srv->ms_name);
+}
+
+/**
+ * Initialises the model and schedules start of its threads.
+ *
+ * Elevators of server devices (mio_srv::ms_el) are to be initialised by the
+ * caller before sim_run().
+ */
+M0_INTERNAL void mio_init(struct sim *s, struct mio_conf *conf)
+{
+	unsigned      i;
+	unsigned      j;
+	struct m0_fid p_id  = {0x123, 0x456};
+	struct m0_fid pv_id = {0x789, 0x101112};
+	int           result;
+
+	M0_PRE(conf->mc_nr_servers > 0 && conf->mc_nr_devices > 0);
+	M0_PRE(conf->mc_nr_locs > 0 && conf->mc_rpc_inflight > 0);
+
+	conf->mc_sim = s;
+	conf->mc_rpc_units_max = min_check(max_check(conf->mc_rpc_units_max,
+						     1U),
+					   (unsigned)MIO_RPC_UNITS_MAX);
+	conf->mc_io_size = max64u(m0_round_up(conf->mc_io_size,
+					      conf->mc_unitsize),
+				  conf->mc_unitsize);
+	/* A single rpc must fit into the log, write-back must be reachable. */
+	conf->mc_be_log_size = max64u(conf->mc_be_log_size,
+				      2 * MIO_RPC_UNITS_MAX *
+				      conf->mc_be_tx_size);
+	conf->mc_be_wb_threshold = min64u(conf->mc_be_wb_threshold,
+					  conf->mc_be_log_size / 2);
+	m0_pool_init(&conf->mc_pool, &p_id, 0);
+	m0_pool_version_init(&conf->mc_pool_version, &pv_id, &conf->mc_pool,
+			     conf->mc_nr_servers * conf->mc_nr_devices,
+			     conf->mc_nr_servers, conf->mc_N, conf->mc_K,
+			     conf->mc_S);
+	mio_layout_build(conf);
+	cnt_init(&conf->mc_op_lat, NULL, "mio::op_latency");
+	cnt_init(&conf->mc_rmw_units, NULL, "mio::rmw_read_units");
+	cnt_init(&conf->mc_rpc_units, NULL, "mio::rpc_units");
+
+	conf->mc_srv = sim_alloc(conf->mc_nr_servers * sizeof conf->mc_srv[0]);
+	for (i = 0; i < conf->mc_nr_servers; ++i)
+		mio_srv_init(conf, &conf->mc_srv[i], i);
+
+	conf->mc_client = sim_alloc(conf->mc_nr_clients *
+				    sizeof conf->mc_client[0]);
+	for (i = 0; i < conf->mc_nr_clients; ++i) {
+		struct mio_client *c = &conf->mc_client[i];
+
+		c->mcl_conf   = conf;
+		c->mcl_id     = i;
+		c->mcl_thread = sim_alloc(conf->mc_nr_threads *
+					  sizeof c->mcl_thread[0]);
+		c->mcl_sender = sim_alloc(conf->mc_rpc_inflight *
+					  sizeof c->mcl_sender[0]);
+		mrpc_tlist_init(&c->mcl_queue);
+		sim_chan_init(&c->mcl_send, "client#%u::sender_idle", i);
+		for (j = 0; j < conf->mc_nr_threads; ++j) {
+			struct mio_thread *mt = &c->mcl_thread[j];
+			struct m0_fid      gfid;
+
+			mt->mt_id     = j;
+			mt->mt_client = c;
+			sim_chan_init(&mt->mt_phase_done,
+				      "client#%u::thread#%u::phase_wait", i, j);
+			m0_fid_set(&gfid, 0,
+				   1000 + i * conf->mc_nr_threads + j);
+			result = m0_layout_instance_build(
+					m0_pdl_to_layout(conf->mc_pdclust),
+					&gfid, &mt->mt_layout_instance);
+			M0_ASSERT(result == 0);
+		}
+	}
+	sim_timer_add(s, 0, mio_threads_start, conf);
+}
+
+/**
+ * Stops threads of the model, which must be idle (sim_run() returned), and
+ * finalises it.
+ */
+M0_INTERNAL void mio_fini(struct mio_conf *conf)
+{
+	unsigned i;
+	unsigned j;
+
+	conf->mc_shutdown = 1;
+	for (i = 0; i < conf->mc_nr_clients; ++i)
+		sim_chan_broadcast(&conf->mc_client[i].mcl_send);
+	for (i = 0; i < conf->mc_nr_servers; ++i) {
+		struct mio_srv *srv = &conf->mc_srv[i];
+
+		for (j = 0; j < conf->mc_nr_locs; ++j)
+			sim_chan_broadcast(&srv->ms_loc[j].ml_incoming);
+		sim_chan_broadcast(&srv->ms_be.mb_log_wait);
+		sim_chan_broadcast(&srv->ms_be.mb_wb_wait);
+	}
+	/* drain events added during finalisation. */
+	sim_run(conf->mc_sim);
+
+	for (i = 0; i < conf->mc_nr_clients; ++i) {
+		struct mio_client *c = &conf->mc_client[i];
+
+		for (j = 0; j < conf->mc_nr_threads; ++j) {
+			struct mio_thread *mt = &c->mcl_thread[j];
+
+			sim_thread_fini(&mt->mt_thread);
+			sim_chan_fini(&mt->mt_phase_done);
+			m0_layout_instance_fini(mt->mt_layout_instance);
+		}
+		for (j = 0; j < conf->mc_rpc_inflight; ++j)
+			sim_thread_fini(&c->mcl_sender[j]);
+		sim_chan_fini(&c->mcl_send);
+		mrpc_tlist_fini(&c->mcl_queue);
+		sim_free(c->mcl_sender);
+		sim_free(c->mcl_thread);
+	}
+	sim_free(conf->mc_client);
+	for (i = 0; i < conf->mc_nr_servers; ++i)
+		mio_srv_fini(conf, &conf->mc_srv[i]);
+	sim_free(conf->mc_srv);
+	cnt_fini(&conf->mc_op_lat);
+	cnt_fini(&conf->mc_rmw_units);
+	cnt_fini(&conf->mc_rpc_units);
+	m0_layout_put(&conf->mc_pdclust->pl_base.sl_base);
+	m0_layout_standard_types_unregister(&conf->mc_l_dom);
+	m0_layout_domain_fini(&conf->mc_l_dom);
+	m0_pool_fini(&conf->mc_pool);
+}
+
+/** @} end of desim group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2012-2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_DESIM_MIO_H__
+#define __MOTR_DESIM_MIO_H__
+
+/**
+   @addtogroup desim desim
+
+   <b>Motr I/O path model</b>
+
+   mio models object I/O of the Motr client and ioservice:
+
+   - client threads issue I/O operations of mio_conf::mc_io_size bytes to
+     their own object. An operation is split into parity groups mapped to
+     devices by pdclust. A write which doesn't cover whole groups is done as
+     read-modify-write: either old data and parity or the rest of the group
+     is read first, whichever is smaller, then parity is calculated and new
+     data and parity are written;
+
+   - units of an I/O phase addressed to the same server are batched into
+     rpcs of at most mio_conf::mc_rpc_units_max units. Each client has
+     mio_conf::mc_rpc_inflight sender threads, limiting rpcs in flight;
+
+   - an ioservice has mio_conf::mc_nr_locs localities. A fom executes its
+     non-blocking part in the locality of the target object; the locality is
+     busy meanwhile. Stob I/O is done on the server device elevators;
+
+   - a write is committed through the server BE: transactions are placed to
+     the log by group commit, log space is reclaimed by segment write-back
+     started after mio_conf::mc_be_wb_threshold bytes are dirty.
+
+   Results are reported by counters (see cnt_dump_all()), including time
+   spent in every queue.
+
+   @{
+ */
+
+#include "lib/tlist.h"
+#include "lib/types.h"                   /* m0_bcount_t */
+
+#include "pool/pool.h"
+#include "layout/layout.h"
+#include "layout/pdclust.h"
+#include "desim/sim.h"
+#include "desim/cnt.h"
+
+struct net_conf;
+struct elevator;
+struct mio_conf;
+struct mio_srv;
+struct mio_client;
+
+enum {
+	/** Maximal number of units in an rpc. */
+	MIO_RPC_UNITS_MAX = 64
+};
+
+/** Unit of a parity group mapped to a device. */
+struct mio_unit {
+	uint32_t mu_obj;
+	uint64_t mu_frame;
+};
+
+struct mio_thread {
+	struct sim_thread          mt_thread;
+	struct mio_client         *mt_client;
+	unsigned                   mt_id;
+	struct m0_layout_instance *mt_layout_instance;
+	/** Number of rpcs of the current I/O phase not completed yet. */
+	unsigned                   mt_outstanding;
+	struct sim_chan            mt_phase_done;
+};
+
+struct mio_client {
+	struct mio_conf   *mcl_conf;
+	unsigned           mcl_id;
+	struct mio_thread *mcl_thread;
+	/** rpc sender threads, mio_conf::mc_rpc_inflight of them. */
+	struct sim_thread *mcl_sender;
+	/** rpcs waiting for a sender thread. */
+	struct m0_tl       mcl_queue;
+	struct sim_chan    mcl_send;
+};
+
+struct mio_loc {
+	struct mio_srv    *ml_srv;
+	struct sim_thread  ml_thread;
+	struct m0_tl       ml_queue;
+	struct sim_chan    ml_incoming;
+};
+
+/** BE of a server: log with group commit and segment write-back. */
+struct mio_be {
+	struct sim_thread  mb_log_thread;
+	struct sim_thread  mb_wb_thread;
+	/** Log space used by transactions not yet written back. */
+	m0_bcount_t        mb_log_used;
+	/** Bytes of transactions waiting for the next group commit. */
+	m0_bcount_t        mb_pending;
+	/** Bytes committed to the log but not written back to the segment. */
+	m0_bcount_t        mb_dirty;
+	uint64_t           mb_seq_open;
+	uint64_t           mb_seq_committed;
+	struct sim_chan    mb_log_wait;
+	struct sim_chan    mb_commit;
+	struct sim_chan    mb_space;
+	struct sim_chan    mb_wb_wait;
+	/** Bytes per group commit. */
+	struct cnt         mb_batch;
+};
+
+struct mio_srv {
+	struct mio_conf  *ms_conf;
+	unsigned          ms_id;
+	/** Device elevators, set up by the user after mio_init(). */
+	struct elevator  *ms_el;
+	struct mio_loc   *ms_loc;
+	struct mio_be     ms_be;
+	/** Time rpcs wait in locality queues. */
+	struct cnt        ms_loc_wait;
+	char             *ms_name;
+};
+
+struct mio_conf {
+	/* topology */
+	unsigned                  mc_nr_clients;
+	unsigned                  mc_nr_threads;
+	unsigned                  mc_nr_servers;
+	unsigned                  mc_nr_devices;
+	/* layout */
+	uint32_t                  mc_N;
+	uint32_t                  mc_K;
+	uint32_t                  mc_S;
+	uint64_t                  mc_unitsize;
+	struct m0_layout_domain   mc_l_dom;
+	struct m0_pdclust_layout *mc_pdclust;
+	struct m0_pool            mc_pool;
+	struct m0_pool_version    mc_pool_version;
+	/* workload */
+	bool                      mc_read;
+	/** Operation size, rounded up to the unit size. */
+	m0_bcount_t               mc_io_size;
+	/** Bytes transferred by each client thread. */
+	m0_bcount_t               mc_total;
+	sim_time_t                mc_delay_min;
+	sim_time_t                mc_delay_max;
+	/* client */
+	unsigned                  mc_rpc_inflight;
+	unsigned                  mc_rpc_units_max;
+	/** Parity calculation speed, bytes per second, 0 if free. */
+	unsigned long long        mc_parity_rate;
+	/* ioservice */
+	unsigned                  mc_nr_locs;
+	sim_time_t                mc_fom_cpu_min;
+	sim_time_t                mc_fom_cpu_max;
+	/** Additional fom cpu time per unit. */
+	sim_time_t                mc_unit_cpu;
+	/* BE */
+	/** Log bytes per written unit (cob, balloc and emap updates). */
+	m0_bcount_t               mc_be_tx_size;
+	sim_time_t                mc_be_log_latency;
+	unsigned long long        mc_be_log_rate;
+	m0_bcount_t               mc_be_log_size;
+	m0_bcount_t               mc_be_wb_threshold;
+	unsigned long long        mc_be_seg_rate;
+
+	struct net_conf          *mc_net;
+	struct mio_srv           *mc_srv;
+	struct mio_client        *mc_client;
+	struct sim               *mc_sim;
+	int                       mc_shutdown;
+	/** Time the last client thread finished. */
+	sim_time_t                mc_end;
+	/** Operation latency. */
+	struct cnt                mc_op_lat;
+	/** Units read by read-modify-write per operation. */
+	struct cnt                mc_rmw_units;
+	/** Units per rpc. */
+	struct cnt                mc_rpc_units;
+};
+
+M0_INTERNAL void mio_init(struct sim *s, struct mio_conf *conf);
+M0_INTERNAL void mio_fini(struct mio_conf *conf);
+
+#endif /* __MOTR_DESIM_MIO_H__ */
+
+/** @} end of desim group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
@@ -185,8 +185,8 @@ static void net_leave(struct sim_thread *t, struct net_conf *n,
 	sim_chan_broadcast(&n->nc_queue);
 }
 
-static void net_tx(struct sim_thread *t, struct net_conf *n,
-		   unsigned long nob, sim_time_t min, sim_time_t max)
+M0_INTERNAL void net_tx(struct sim_thread *t, struct net_conf *n,
+			unsigned long nob, sim_time_t min, sim_time_t max)
 {
 	net_enter(t, n, nob);
 	sim_sleep(t, sim_rnd(min, max));
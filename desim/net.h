@@ -88,6 +88,13 @@ M0_INTERNAL void net_srv_fini(struct net_srv *srv);
 M0_INTERNAL void net_init(struct net_conf *net);
 M0_INTERNAL void net_fini(struct net_conf *net);
 
+/**
+ * Transfers @nob bytes over the network, waiting for network capacity first.
+ * Transfer time is uniformly distributed in [min, max].
+ */
+M0_INTERNAL void net_tx(struct sim_thread *t, struct net_conf *n,
+			unsigned long nob, sim_time_t min, sim_time_t max);
+
 M0_INTERNAL void net_rpc_init(struct net_rpc *rpc, struct net_conf *conf,
 			      struct net_srv *srv, struct m0_stob_id *stob_id,
 			      unsigned long long offset, unsigned long nob);
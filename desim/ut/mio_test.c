@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2012-2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "motr/init.h"
+#include "lib/thread.h"    /* LAMBDA */
+#include "lib/getopts.h"
+
+#include "desim/sim.h"
+#include "desim/storage.h"
+#include "desim/chs.h"
+#include "desim/net.h"
+#include "desim/mio.h"
+#include "desim/elevator.h"
+
+/**
+   @addtogroup desim desim
+   @{
+ */
+
+static struct net_conf net = {
+	.nc_frag_size      = 4*1024,
+	.nc_rpc_size       =   1024,
+	.nc_rpc_delay_min  =   1000, /* microsecond */
+	.nc_rpc_delay_max  =   5000,
+	.nc_frag_delay_min =    100,
+	.nc_frag_delay_max =   1000,
+	.nc_rate_min       =  750000000,
+	.nc_rate_max       = 1000000000, /* 1GB/sec QDR Infiniband */
+	.nc_nob_max        =     ~0UL,
+	.nc_msg_max        =     ~0UL,
+};
+
+static struct mio_conf mio = {
+	.mc_nr_clients      = 1,
+	.mc_nr_threads      = 1,
+	.mc_nr_servers      = 1,
+	.mc_nr_devices      = 12,
+	.mc_N               = 8,
+	.mc_K               = 2,
+	.mc_S               = 2,
+	.mc_unitsize        = 1024*1024,
+	.mc_io_size         = 8*1024*1024,
+	.mc_total           = 256*1024*1024,
+	.mc_delay_min       =         0,
+	.mc_delay_max       =   1000000, /* millisecond */
+	.mc_rpc_inflight    =         8,
+	.mc_rpc_units_max   =        16,
+	.mc_parity_rate     = 2000000000,
+	.mc_nr_locs         =         8,
+	.mc_fom_cpu_min     =     20000,
+	.mc_fom_cpu_max     =     50000,
+	.mc_unit_cpu        =      2000,
+	.mc_be_tx_size      =      4096,
+	.mc_be_log_latency  =     50000,
+	.mc_be_log_rate     = 500000000,
+	.mc_be_log_size     = 128*1024*1024,
+	.mc_be_wb_threshold = 32*1024*1024,
+	.mc_be_seg_rate     = 200000000,
+	.mc_net             = &net
+};
+
+static struct chs_conf ST31000640SS = { /* Barracuda ES.2 */
+	.cc_storage = {
+		.sc_sector_size = 512,
+	},
+	.cc_heads          = 4*2,    /* sginfo */
+	.cc_cylinders      = 153352, /* sginfo */
+	.cc_track_skew     = 160,    /* sginfo */
+	.cc_cylinder_skew  = 76,     /* sginfo */
+	.cc_sectors_min    = 1220,   /* sginfo */
+	.cc_sectors_max    = 1800,   /* guess */
+	.cc_cyl_in_zone    = 48080,  /* sginfo */
+
+	.cc_seek_avg            =  8500000, /* data sheet */
+	.cc_seek_track_to_track =   800000, /* data sheet */
+	.cc_seek_full_stroke    = 16000000, /* guess */
+	.cc_write_settle        =   500000, /* guess */
+	.cc_head_switch         =   500000, /* guess */
+	.cc_command_latency     =        0, /* unknown */
+
+	.cc_rps                 = 7200/60
+};
+
+static void workload_init(struct sim *s, int argc, char **argv)
+{
+	unsigned i;
+	unsigned j;
+
+	net_init(&net);
+	mio_init(s, &mio);
+	chs_conf_init(&ST31000640SS);
+
+	for (i = 0; i < mio.mc_nr_servers; ++i) {
+		for (j = 0; j < mio.mc_nr_devices; ++j) {
+			struct chs_dev *disc;
+
+			disc = sim_alloc(sizeof *disc);
+			sim_name_set(&disc->cd_storage.sd_name, "%u:%u", i, j);
+			chs_dev_init(disc, s, &ST31000640SS);
+			elevator_init(&mio.mc_srv[i].ms_el[j],
+				      &disc->cd_storage);
+		}
+	}
+}
+
+static void workload_fini(void)
+{
+	unsigned i;
+	unsigned j;
+
+	for (i = 0; i < mio.mc_nr_servers; ++i) {
+		for (j = 0; j < mio.mc_nr_devices; ++j) {
+			struct elevator *el;
+			struct chs_dev  *disc;
+
+			el = &mio.mc_srv[i].ms_el[j];
+			disc = container_of(el->e_dev,
+					    struct chs_dev, cd_storage);
+			elevator_fini(el);
+			chs_dev_fini(disc);
+			sim_free(disc);
+		}
+	}
+	chs_conf_fini(&ST31000640SS);
+	mio_fini(&mio);
+	net_fini(&net);
+}
+
+int main(int argc, char **argv)
+{
+	struct sim s;
+	int        result;
+
+	result = m0_init(NULL);
+	M0_ASSERT(result == 0);
+
+	result = M0_GETOPTS(argv[0], argc, argv,
+	    M0_HELPARG('h'),
+	    M0_FORMATARG('c', "clients", "%u", &mio.mc_nr_clients),
+	    M0_FORMATARG('t', "threads per client", "%u", &mio.mc_nr_threads),
+	    M0_FORMATARG('s', "servers", "%u", &mio.mc_nr_servers),
+	    M0_FORMATARG('d', "devices per server", "%u", &mio.mc_nr_devices),
+	    M0_FORMATARG('N', "N", "%u", &mio.mc_N),
+	    M0_FORMATARG('K', "K", "%u", &mio.mc_K),
+	    M0_FORMATARG('S', "S", "%u", &mio.mc_S),
+	    M0_FORMATARG('u', "unit size", "%lu", &mio.mc_unitsize),
+	    M0_FORMATARG('o', "operation size", "%lu", &mio.mc_io_size),
+	    M0_FORMATARG('n', "total per thread", "%lu", &mio.mc_total),
+	    M0_FLAGARG('r', "read instead of write", &mio.mc_read),
+	    M0_FORMATARG('i', "rpcs in flight per client", "%u",
+			 &mio.mc_rpc_inflight),
+	    M0_FORMATARG('b', "units per rpc", "%u", &mio.mc_rpc_units_max),
+	    M0_FORMATARG('l', "localities per server", "%u",
+			 &mio.mc_nr_locs),
+	    M0_FORMATARG('L', "BE log size", "%lu", &mio.mc_be_log_size),
+	    M0_FORMATARG('w', "BE write-back threshold", "%lu",
+			 &mio.mc_be_wb_threshold),
+	    M0_VOIDARG('v', "increase verbosity",
+		       LAMBDA(void, (void){ sim_log_level++; } )));
+
+	M0_ASSERT(result == 0);
+
+	sim_init(&s);
+	workload_init(&s, argc, argv);
+	sim_run(&s);
+	cnt_dump_all();
+	sim_log(&s, SLL_WARN, "%10.2f MB/s\n",
+		1000.0 * mio.mc_nr_clients * mio.mc_nr_threads *
+		mio.mc_total / (1 << 20) * 1000000 / mio.mc_end);
+	workload_fini();
+	sim_fini(&s);
+	m0_fini();
+	return 0;
+}
+
+/** @} end of desim group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
@@ -131,41 +131,37 @@ static void dtm0_req_fop_fini(struct dtm0_req_fop *req)
 	m0_buf_free(&req->dtr_payload);
 }
 
+/**
+ * Initialises the link FOM sending @owned_req. On success the request is
+ * released together with the fop, on failure it is left to the caller.
+ */
 static int drlink_fom_init(struct drlink_fom            *fom,
 			   struct m0_dtm0_service       *svc,
 			   struct m0_be_op              *op,
 			   const struct m0_fid          *tgt,
-			   const struct dtm0_req_fop    *req,
+			   struct dtm0_req_fop          *owned_req,
 			   const struct m0_fom          *parent_fom,
 			   bool                          wait_for_ack)
 {
 	struct m0_rpc_machine  *mach;
 	struct m0_reqh         *reqh;
-	struct dtm0_req_fop    *owned_req;
 	struct m0_fop          *fop;
 
 	M0_ENTRY();
 	M0_PRE(fom != NULL);
 	M0_PRE(svc != NULL);
-	M0_PRE(req != NULL);
+	M0_PRE(owned_req != NULL);
 	M0_PRE(m0_fid_is_valid(tgt));
 
 	reqh = svc->dos_generic.rs_reqh;
 	mach = m0_reqh_rpc_mach_tlist_head(&reqh->rh_rpc_machines);
 
-	owned_req = dtm0_req_fop_dup(req);
-	if (owned_req == NULL)
-		return M0_ERR(-ENOMEM);
-
-	fop = m0_fop_alloc(req->dtr_msg == DTM_REDO ?
+	fop = m0_fop_alloc(owned_req->dtr_msg == DTM_REDO ?
 			   &dtm0_redo_fop_fopt:
 			   &dtm0_req_fop_fopt,
 			   owned_req, mach);
-	if (fop == NULL) {
-		dtm0_req_fop_fini(owned_req);
-		m0_free(owned_req);
+	if (fop == NULL)
 		return M0_ERR(-ENOMEM);
-	}
 
 	/*
 	 * When ACK is not required, the FOM may be released before
@@ -643,12 +639,12 @@ static int drlink_fom_tick(struct m0_fom *fom)
 	return M0_RC(rc);
 }
 
-M0_INTERNAL int m0_dtm0_req_post(struct m0_dtm0_service    *svc,
-                                 struct m0_be_op           *op,
-				 const struct dtm0_req_fop *req,
-				 const struct m0_fid       *tgt,
-				 const struct m0_fom       *parent_fom,
-				 bool                       wait_for_ack)
+M0_INTERNAL int m0_dtm0_req_post_owned(struct m0_dtm0_service *svc,
+				       struct m0_be_op        *op,
+				       struct dtm0_req_fop    *req,
+				       const struct m0_fid    *tgt,
+				       const struct m0_fom    *parent_fom,
+				       bool                    wait_for_ack)
 {
 	int                  rc;
 	struct drlink_fom   *fom;
@@ -669,6 +665,31 @@ M0_INTERNAL int m0_dtm0_req_post(struct m0_dtm0_service    *svc,
 	return rc == 0 ? M0_RC(rc) : M0_ERR(rc);
 }
 
+M0_INTERNAL int m0_dtm0_req_post(struct m0_dtm0_service    *svc,
+                                 struct m0_be_op           *op,
+				 const struct dtm0_req_fop *req,
+				 const struct m0_fid       *tgt,
+				 const struct m0_fom       *parent_fom,
+				 bool                       wait_for_ack)
+{
+	struct dtm0_req_fop *owned_req;
+	int                  rc;
+
+	M0_ENTRY();
+
+	owned_req = dtm0_req_fop_dup(req);
+	if (owned_req == NULL)
+		return M0_ERR(-ENOMEM);
+
+	rc = m0_dtm0_req_post_owned(svc, op, owned_req, tgt, parent_fom,
+				    wait_for_ack);
+	if (rc != 0) {
+		dtm0_req_fop_fini(owned_req);
+		m0_free(owned_req);
+	}
+	return M0_RC(rc);
+}
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
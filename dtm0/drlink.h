@@ -67,6 +67,21 @@ M0_INTERNAL int m0_dtm0_req_post(struct m0_dtm0_service    *svc,
 				 const struct m0_fom       *parent_fom,
 				 bool                       wait_for_ack);
 
+/**
+ * The same as m0_dtm0_req_post(), but @req is not copied.
+ *
+ * @req must be allocated with m0_alloc() and its payload and tx descriptor
+ * must be allocated the way xcode allocates them. On success, @req belongs to
+ * the link and is freed together with the fop. On failure, it is left to the
+ * caller.
+ */
+M0_INTERNAL int m0_dtm0_req_post_owned(struct m0_dtm0_service *svc,
+				       struct m0_be_op        *op,
+				       struct dtm0_req_fop    *req,
+				       const struct m0_fid    *tgt,
+				       const struct m0_fom    *parent_fom,
+				       bool                    wait_for_ack);
+
 #endif /* __MOTR_DTM0_DRLINK_H__ */
 
 /*
@@ -758,7 +758,7 @@ Max: [* defect *] No mention of tests being done. Please clearly state when and
 #include "lib/trace.h"
 #include "dtm0/recovery.h"    /* m0_dtm0_recovery_machine */
 #include "dtm0/service.h"     /* m0_dtm0_service */
-#include "dtm0/drlink.h"      /* m0_dtm0_req_post */
+#include "dtm0/drlink.h"      /* m0_dtm0_req_post_owned */
 #include "dtm0/fop.h"         /* dtm0_req_fop */
 #include "be/op.h"            /* m0_be_op */
 #include "be/queue.h"         /* m0_be_queue */
@@ -844,6 +844,16 @@ struct recovery_fom {
 	 * with ::rf_last_known_ha_state unless we have HA epochs.
 	 */
 	bool                            rf_last_known_eol;
+
+	/**
+	 * Ring of m0_dtm0_recovery_machine::rm_redo_window ops of REDO
+	 * messages sent to the remote service.  rf_redo_nr ops starting from
+	 * rf_redo_head are in flight, the oldest one first.  NULL for the
+	 * local FOM, it does not send REDOs.
+	 */
+	struct m0_be_op                *rf_redo_ops;
+	uint32_t                        rf_redo_head;
+	uint32_t                        rf_redo_nr;
 };
 
 enum eolq_item_type {
@@ -941,6 +951,7 @@ m0_dtm0_recovery_machine_init(struct m0_dtm0_recovery_machine           *m,
 		m->rm_ops = ops;
 	else
 		m->rm_ops = &m0_dtm0_recovery_machine_default_ops;
+	m->rm_redo_window = M0_DTM0_REDO_WINDOW_DEFAULT;
 	rfom_tlist_init(&m->rm_rfoms);
 	m0_sm_group_init(&m->rm_sm_group);
 	m0_sm_init(&m->rm_sm, &m0_drm_sm_conf,
@@ -1299,8 +1310,9 @@ static int recovery_fom_init(struct recovery_fom             *rf,
 			     const struct m0_fid             *target,
 			     bool                             is_volatile)
 {
-	int rc;
-	bool is_local = m0_fid_eq(recovery_machine_local_id(m), target);
+	int      rc;
+	uint32_t i;
+	bool     is_local = m0_fid_eq(recovery_machine_local_id(m), target);
 
 	M0_ENTRY("m=%p, rf=%p, tgt=" FID_F ", is_vol=%d, is_local=%d",
 		 m, rf, FID_P(target), !!is_volatile, !!is_local);
@@ -1355,6 +1367,15 @@ static int recovery_fom_init(struct recovery_fom             *rf,
 		 * M0_NC_DTM_RECOVERING.
 		 */
 		rf->rf_last_known_ha_state = M0_NC_DTM_RECOVERING;
+	} else {
+		M0_PRE(m->rm_redo_window > 0);
+		M0_ALLOC_ARR(rf->rf_redo_ops, m->rm_redo_window);
+		if (rf->rf_redo_ops == NULL) {
+			m0_be_queue_fini(&rf->rf_heq);
+			return M0_ERR(-ENOMEM);
+		}
+		for (i = 0; i < m->rm_redo_window; ++i)
+			m0_be_op_init(&rf->rf_redo_ops[i]);
 	}
 
 	rf->rf_m = m;
@@ -1405,7 +1426,15 @@ static void m0_be_queue__finish(struct m0_be_queue *bq, struct m0_buf *item)
 
 static void recovery_fom_fini(struct recovery_fom *rf)
 {
+	uint32_t i;
+
 	M0_ENTRY("m=%p, rf= %p", rf->rf_m, rf);
+	if (rf->rf_redo_ops != NULL) {
+		M0_ASSERT(rf->rf_redo_nr == 0);
+		for (i = 0; i < rf->rf_m->rm_redo_window; ++i)
+			m0_be_op_fini(&rf->rf_redo_ops[i]);
+		m0_free0(&rf->rf_redo_ops);
+	}
 	m0_clink_del_lock(&rf->rf_ha_clink);
 	m0_clink_fini(&rf->rf_ha_clink);
 	m0_co_context_fini(&rf->rf_coro);
@@ -1669,6 +1698,55 @@ static void eolq_await(struct m0_fom *fom, struct eolq_item *out)
 	*out = F(got) ? F(item) : (struct eolq_item) { .ei_type = EIT_END };
 }
 
+/** Op for the next REDO message sent to the remote service of @rf. */
+static struct m0_be_op *redo_window_add(struct recovery_fom *rf)
+{
+	uint32_t window = rf->rf_m->rm_redo_window;
+
+	M0_PRE(rf->rf_redo_nr < window);
+	return &rf->rf_redo_ops[(rf->rf_redo_head + rf->rf_redo_nr++) % window];
+}
+
+/** Op of the oldest REDO message in flight. */
+static struct m0_be_op *redo_window_oldest(struct recovery_fom *rf)
+{
+	M0_PRE(rf->rf_redo_nr > 0);
+	return &rf->rf_redo_ops[rf->rf_redo_head];
+}
+
+/** Forgets the oldest REDO message once it is acknowledged. */
+static void redo_window_pop(struct recovery_fom *rf)
+{
+	m0_be_op_reset(redo_window_oldest(rf));
+	rf->rf_redo_head = (rf->rf_redo_head + 1) % rf->rf_m->rm_redo_window;
+	rf->rf_redo_nr--;
+}
+
+/**
+ * Waits for acknowledgements of the oldest REDO messages until at most @nr
+ * of them are in flight.
+ */
+static void redo_window_shrink(struct m0_fom *fom, uint32_t nr)
+{
+	struct recovery_fom *rf = M0_AMB(rf, fom, rf_base);
+
+	M0_CO_REENTER(CO(fom));
+
+	while (rf->rf_redo_nr > nr) {
+		M0_CO_YIELD_RC(CO(fom), m0_be_op_tick_ret(
+					redo_window_oldest(rf), fom,
+					RFS_WAITING));
+		redo_window_pop(rf);
+	}
+}
+
+/** Destroys whatever redo_post() left in @redo. */
+static void redo_fini(struct dtm0_req_fop *redo)
+{
+	m0_dtm0_tx_desc_fini(&redo->dtr_txr);
+	m0_buf_free(&redo->dtr_payload);
+}
+
 static bool participated(const struct m0_dtm0_log_rec *record,
 			 const struct m0_fid          *svc)
 {
@@ -1694,7 +1772,6 @@ static void dtm0_restore(struct m0_fom        *fom,
 
 	M0_CO_REENTER(CO(fom),
 		      struct m0_fid       initiator;
-		      struct m0_be_op     reply_op;
 		      bool                next;
 		      struct m0_dtm0_tid  last_dtx_id;
 		      bool                last_dtx_met;
@@ -1736,9 +1813,6 @@ static void dtm0_restore(struct m0_fom        *fom,
 	/* XXX: race condition in the case where we are stopping the FOM. */
 	F(initiator) = recovery_fom_local(rf->rf_m)->rf_tgt_svc;
 
-	M0_SET0(&F(reply_op));
-	m0_be_op_init(&F(reply_op));
-
 	/*
 	 * last_dtx_met and next seem to have very close meaning, but they are
 	 * not the same.  last_dtx_met is "we have reached the last transaction
@@ -1750,6 +1824,16 @@ static void dtm0_restore(struct m0_fom        *fom,
 	 * need both flags to define what to do.
 	 */
 	do {
+		/*
+		 * Up to rm_redo_window REDOs are in flight, so that replay of
+		 * a long log does not take a round trip per record.  The
+		 * remote side applies each REDO on its own, the order of
+		 * replies does not matter.  Note that the record is not kept
+		 * in the FOM frame, so this is the only place where the loop
+		 * may yield.
+		 */
+		M0_CO_FUN(CO(fom), redo_window_shrink(fom,
+				rf->rf_m->rm_redo_window - 1));
 		if (F(last_dtx_met)) {
 			/*
 			 * Last iteration reached the RECOVERING mark in the
@@ -1793,39 +1877,45 @@ static void dtm0_restore(struct m0_fom        *fom,
 		 * current implementation, EOL flags should be sent on a
 		 * separate message, which must not have any payload.
 		 */
+		if (!F(next))
+			break;
+
+		/*
+		 * The record is a private copy made by the log iterator, its
+		 * payload and descriptor are moved into the message.  The
+		 * default redo_post() hands them over to the fop as they are,
+		 * without copying them once again.
+		 */
 		redo = (struct dtm0_req_fop) {
 			.dtr_msg       = DTM_REDO,
 			.dtr_initiator = F(initiator),
+			.dtr_payload   = record.dlr_payload,
+			.dtr_txr       = record.dlr_txd,
 		};
-		if (F(next)) {
-			redo.dtr_payload   = record.dlr_payload;
-			redo.dtr_txr       = record.dlr_txd;
-		} else {
-			redo.dtr_flags     = M0_BITS(M0_DMF_EOL);
-		}
-
-		/*
-		 * TODO: there is extra memcpy happening here -- first copy done
-		 * in recovery_machine_log_iter_next (it clones the record),
-		 * second copy is done in recovery_machine_redo_post() below.
-		 * If this proves to be too inefficient, we can eliminate extra
-		 * copies.
-		 */
-		recovery_machine_redo_post(rf->rf_m, &rf->rf_base,
-					   &rf->rf_tgt_svc,
-					   &redo, &F(reply_op));
-
-		if (F(next))
-			m0_dtm0_log_iter_rec_fini(&record);
+		M0_SET0(&record);
 
 		M0_LOG(M0_DEBUG, "out-redo: (m=%p) " REDO_F,
 		       rf->rf_m, REDO_P(&redo));
-		M0_CO_YIELD_RC(CO(fom), m0_be_op_tick_ret(&F(reply_op),
-							  fom, RFS_WAITING));
-		m0_be_op_reset(&F(reply_op));
-	} while (F(next));
+		recovery_machine_redo_post(rf->rf_m, &rf->rf_base,
+					   &rf->rf_tgt_svc,
+					   &redo, redo_window_add(rf));
+		redo_fini(&redo);
+	} while (true);
 
-	m0_be_op_fini(&F(reply_op));
+	/*
+	 * EOL tells the remote side that the log is replayed, so it is sent
+	 * only after all REDOs are acknowledged.
+	 */
+	M0_CO_FUN(CO(fom), redo_window_shrink(fom, 0));
+	redo = (struct dtm0_req_fop) {
+		.dtr_msg       = DTM_REDO,
+		.dtr_initiator = F(initiator),
+		.dtr_flags     = M0_BITS(M0_DMF_EOL),
+	};
+	M0_LOG(M0_DEBUG, "out-redo: (m=%p) " REDO_F, rf->rf_m, REDO_P(&redo));
+	recovery_machine_redo_post(rf->rf_m, &rf->rf_base, &rf->rf_tgt_svc,
+				   &redo, redo_window_add(rf));
+	M0_CO_FUN(CO(fom), redo_window_shrink(fom, 0));
 
 	recovery_machine_log_iter_fini(rf->rf_m, &rf->rf_log_iter);
 	M0_SET0(&rf->rf_log_iter);
@@ -1857,11 +1947,11 @@ static void dtm0_evict(struct m0_fom *fom,
 	M0_CO_REENTER(CO(fom),
 		      struct dtm0_req_fop redo;
 		      struct m0_fid       initiator;
-		      struct m0_be_op     reply_op;
 		      bool                next;
 		      struct m0_dtm0_tid  last_dtx_id;
 		      bool                last_dtx_met;
 		      int                 i;
+		      int                 rc;
 		      struct m0_dtm0_log_rec record;
 		      );
 
@@ -1899,9 +1989,7 @@ static void dtm0_evict(struct m0_fom *fom,
 
 	/* XXX: race condition in the case where we are stopping the FOM. */
 	F(initiator) = recovery_fom_local(rf->rf_m)->rf_tgt_svc;
-
-	M0_SET0(&F(reply_op));
-	m0_be_op_init(&F(reply_op));
+	F(rc) = 0;
 
 	/*
 	 * last_dtx_met and next seem to have very close meaning, but they are
@@ -1953,42 +2041,61 @@ static void dtm0_evict(struct m0_fom *fom,
 		if (!F(next))
 			break;
 
-		F(redo) = (struct dtm0_req_fop) {
-			.dtr_msg       = DTM_REDO,
-			.dtr_initiator = F(initiator),
-			.dtr_payload   = F(record).dlr_payload,
-			.dtr_txr       = F(record).dlr_txd,
-			.dtr_flags     = M0_BITS(M0_DMF_EVICTION),
-		};
-
 		for (F(i) = 0; F(i) < F(record).dlr_txd.dtd_ps.dtp_nr; F(i)++) {
+			/* See dtm0_restore() about the window. */
+			M0_CO_FUN(CO(fom), redo_window_shrink(fom,
+					rf->rf_m->rm_redo_window - 1));
 			tx_pa = &F(record).dlr_txd.dtd_ps.dtp_pa[F(i)];
 			M0_LOG(M0_DEBUG, "i=%d fid=" FID_F " state=%"PRIu32,
 			       F(i), FID_P(&tx_pa->p_fid), tx_pa->p_state);
 			if (tx_pa->p_state == M0_DTPS_PERSISTENT)
 				continue;
-			recovery_machine_redo_post(rf->rf_m, &rf->rf_base,
-						   &tx_pa->p_fid,
-						   &F(redo), &F(reply_op));
+			/*
+			 * The record is sent to several participants,
+			 * redo_post() gets a copy it may take over.
+			 */
+			F(redo) = (struct dtm0_req_fop) {
+				.dtr_msg       = DTM_REDO,
+				.dtr_initiator = F(initiator),
+				.dtr_flags     = M0_BITS(M0_DMF_EVICTION),
+			};
+			F(rc) = m0_dtm0_tx_desc_copy(&F(record).dlr_txd,
+						     &F(redo).dtr_txr) ?:
+				m0_buf_copy(&F(redo).dtr_payload,
+					    &F(record).dlr_payload);
+			if (F(rc) != 0) {
+				redo_fini(&F(redo));
+				break;
+			}
 			M0_LOG(M0_DEBUG, "out-redo: (m=%p) " REDO_F,
 			       rf->rf_m, REDO_P(&F(redo)));
-			M0_CO_YIELD_RC(CO(fom), m0_be_op_tick_ret(
-							&F(reply_op), fom,
-							RFS_WAITING));
-			m0_be_op_reset(&F(reply_op));
+			recovery_machine_redo_post(rf->rf_m, &rf->rf_base,
+						   &tx_pa->p_fid, &F(redo),
+						   redo_window_add(rf));
+			redo_fini(&F(redo));
 		}
 
 		m0_dtm0_log_iter_rec_fini(&F(record));
 
-		if (F(last_dtx_met))
+		if (F(last_dtx_met) || F(rc) != 0)
 			break;
 	} while (true);
 
-	m0_be_op_fini(&F(reply_op));
+	M0_CO_FUN(CO(fom), redo_window_shrink(fom, 0));
 
 	recovery_machine_log_iter_fini(rf->rf_m, &rf->rf_log_iter);
 	M0_SET0(&rf->rf_log_iter);
 
+	/*
+	 * The client is not evicted if its records could not be replayed, so
+	 * that the eviction is not reported as done.
+	 */
+	if (F(rc) != 0) {
+		M0_LOG(M0_ERROR, "Eviction failed for rf = %p: rc=%d",
+		       rf, F(rc));
+		goto end_no_callback;
+	}
+
 end:
 	recovery_machine_evicted(rf->rf_m, &rf->rf_tgt_svc);
 end_no_callback:
@@ -2460,9 +2567,25 @@ static void default_redo_post(struct m0_dtm0_recovery_machine *m,
 			      struct dtm0_req_fop             *redo,
 			      struct m0_be_op                 *op)
 {
-	int rc;
+	struct dtm0_req_fop *owned;
+	int                  rc;
 
-	rc = m0_dtm0_req_post(m->rm_svc, op, redo, tgt_svc, fom, true);
+	/*
+	 * Take over the payload and the descriptor instead of cloning them,
+	 * see m0_dtm0_recovery_machine_ops::redo_post().
+	 */
+	M0_ALLOC_PTR(owned);
+	if (owned != NULL) {
+		*owned = *redo;
+		rc = m0_dtm0_req_post_owned(m->rm_svc, op, owned, tgt_svc,
+					    fom, true);
+		if (rc == 0) {
+			M0_SET0(&redo->dtr_txr);
+			M0_SET0(&redo->dtr_payload);
+		} else
+			m0_free(owned);
+	} else
+		rc = M0_ERR(-ENOMEM);
 	/*
 	 * We assume "perfect" links between ONLINE/RECOVERING processes.
 	 * If the link is not perfect then let's just kill the process
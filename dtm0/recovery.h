@@ -52,6 +52,11 @@ enum m0_dtm0_recovery_machine_states {
 	M0_DRMS_NR,
 };
 
+enum {
+	/** Default value of m0_dtm0_recovery_machine::rm_redo_window. */
+	M0_DTM0_REDO_WINDOW_DEFAULT = 32,
+};
+
 struct m0_dtm0_recovery_machine_ops {
 	/**
 	 * Post a REDO message to the target DTM0 service.
@@ -60,6 +65,10 @@ struct m0_dtm0_recovery_machine_ops {
 	 * immediately, before function completes, or it is cloned and stored
 	 * for future use.  Caller will destroy all content of `redo` structure
 	 * right after the call to redo_post().
+	 *
+	 * Instead of cloning, redo_post() may take over the payload and the
+	 * transaction descriptor of `redo`; it then has to zero them in
+	 * `redo`, so that the caller does not destroy them.
 	 */
 	void (*redo_post)(struct m0_dtm0_recovery_machine *m,
 			  struct m0_fom                   *fom,
@@ -119,6 +128,14 @@ struct m0_dtm0_recovery_machine {
 
 	struct m0_sm_group                         rm_sm_group;
 	struct m0_sm                               rm_sm;
+
+	/**
+	 * Maximum number of REDO messages sent to a remote participant and
+	 * not acknowledged yet.  Set to M0_DTM0_REDO_WINDOW_DEFAULT by
+	 * m0_dtm0_recovery_machine_init(), may be changed before
+	 * m0_dtm0_recovery_machine_start().
+	 */
+	uint32_t                                   rm_redo_window;
 };
 
 M0_EXTERN const struct m0_dtm0_recovery_machine_ops
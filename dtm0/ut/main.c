@@ -28,6 +28,8 @@
 #include "net/net.h"
 #include "rpc/rpclib.h"
 #include "ut/ut.h"
+#include "lib/thread.h"
+#include "lib/time.h"
 #include "cas/cas.h"
 #include "cas/cas_xc.h"
 #include "dtm0/recovery.h"
@@ -132,6 +134,9 @@ struct ut_remach {
 	/* Client-side stubs for conf objects. */
 	struct m0_conf_process           cli_procs[UT_SIDE_NR];
 	struct m0_mutex                  cli_proc_guards[UT_SIDE_NR];
+
+	/* REDO window of the machines, 0 means the default one. */
+	uint32_t                         redo_window;
 };
 
 struct ha_thought {
@@ -428,11 +433,19 @@ ut_remach_ops_get(struct ut_remach *um)
 	return um->remach_ops;
 }
 
+static void ut_remach_redo_window_set(struct ut_remach *um,
+				      enum ut_sides     side)
+{
+	if (um->redo_window != 0)
+		ut_remach_get(um, side)->rm_redo_window = um->redo_window;
+}
+
 static void ut_srv_remach_init(struct ut_remach *um)
 {
 	m0_dtm0_recovery_machine_init(ut_remach_get(um, UT_SIDE_SRV),
 				      ut_remach_ops_get(um),
 				      ut_remach_svc_get(um, UT_SIDE_SRV));
+	ut_remach_redo_window_set(um, UT_SIDE_SRV);
 }
 
 static void ut_cli_remach_conf_obj_init(struct ut_remach *um)
@@ -464,6 +477,7 @@ static void ut_cli_remach_init(struct ut_remach *um)
 	m0_dtm0_recovery_machine_init(ut_remach_get(um, UT_SIDE_CLI),
 				      ut_remach_ops_get(um),
 				      um->svcs[UT_SIDE_CLI]);
+	ut_remach_redo_window_set(um, UT_SIDE_CLI);
 }
 
 static void ut_srv_remach_fini(struct ut_remach *um)
@@ -628,6 +642,7 @@ static void ut_remach_reset_srv(struct ut_remach *um)
 	m0_dtm0_recovery_machine_fini(m);
 	m0_dtm0_recovery_machine_init(m, ut_remach_ops_get(um),
 				      ut_remach_svc_get(um, UT_SIDE_SRV));
+	ut_remach_redo_window_set(um, UT_SIDE_SRV);
 	rc = m0_dtm0_recovery_machine_start(m);
 	M0_UT_ASSERT(rc == 0);
 }
@@ -891,16 +906,98 @@ static void remach_boot_real_log(void)
 	ut_remach_shutdown(&um);
 }
 
-/* Use-case: replay a non-empty client log to the server. */
-static void remach_real_log_replay(void)
+enum {
+	/* Max REDO window of the window UT. */
+	UT_WINDOW_MAX      = 16,
+	/* Replies are held until the window is full or this many ticks pass. */
+	UT_WINDOW_STALL_NR = 10,
+};
+
+/*
+ * REDOs "in flight": posted by um_window_redo_post(), but not replied yet.
+ * The replies are sent by window_replier().
+ */
+static struct m0_mutex  window_lock;
+static struct m0_be_op *window_ops[UT_WINDOW_MAX];
+static uint32_t         window_nr;
+static uint32_t         window_nr_max;
+static uint32_t         window_size;
+static bool             window_stop;
+
+/* Applies the REDO at once, but leaves the reply to window_replier(). */
+static void um_window_redo_post(struct m0_dtm0_recovery_machine *m,
+				struct m0_fom                   *fom,
+				const struct m0_fid *tgt_svc,
+				struct dtm0_req_fop *redo,
+				struct m0_be_op *op)
+{
+	struct m0_be_op applied = {};
+
+	m0_be_op_init(&applied);
+	um_real_log_redo_post(m, fom, tgt_svc, redo, &applied);
+	m0_be_op_fini(&applied);
+
+	m0_be_op_active(op);
+	m0_mutex_lock(&window_lock);
+	M0_UT_ASSERT(window_nr < window_size);
+	window_ops[window_nr++] = op;
+	window_nr_max = max_check(window_nr_max, window_nr);
+	m0_mutex_unlock(&window_lock);
+}
+
+/*
+ * Replies to all REDOs in flight once the window is full.  The machine also
+ * waits for all replies before EOL and at the end of the log, this is
+ * detected as no new REDOs during UT_WINDOW_STALL_NR ticks.
+ */
+static void window_replier(void *unused)
+{
+	uint32_t prev_nr = 0;
+	uint32_t stall_nr = 0;
+	uint32_t i;
+	bool     stop;
+
+	do {
+		m0_nanosleep(m0_time(0, 1000000), NULL);
+		m0_mutex_lock(&window_lock);
+		stall_nr = window_nr == prev_nr ? stall_nr + 1 : 0;
+		if (window_nr == window_size ||
+		    (window_nr > 0 && stall_nr >= UT_WINDOW_STALL_NR)) {
+			for (i = 0; i < window_nr; ++i)
+				m0_be_op_done(window_ops[i]);
+			window_nr = 0;
+		}
+		prev_nr = window_nr;
+		stop = window_stop;
+		m0_mutex_unlock(&window_lock);
+	} while (!stop);
+}
+
+static void real_log_replay(uint64_t records_nr, uint32_t redo_window)
 {
+	struct m0_dtm0_recovery_machine_ops ops = *ut_remach_ops_get_real_log();
 	struct ut_remach um = {
-		.cp         = UT_CP_PERSISTENT_CLIENT,
-		.remach_ops = ut_remach_ops_get_real_log(),
+		.cp          = UT_CP_PERSISTENT_CLIENT,
+		.remach_ops  = &ops,
+		.redo_window = redo_window,
 	};
+	struct m0_thread replier = {};
+	int              rc;
 	/* cafe bell */
 	const uint64_t since = 0xCAFEBELL;
-	const uint64_t records_nr = 10;
+
+	M0_UT_ASSERT(redo_window <= UT_WINDOW_MAX);
+	if (redo_window != 0) {
+		ops.redo_post = um_window_redo_post;
+		m0_mutex_init(&window_lock);
+		window_nr = 0;
+		window_nr_max = 0;
+		window_size = redo_window;
+		window_stop = false;
+		rc = M0_THREAD_INIT(&replier, void *, NULL, &window_replier,
+				    NULL, "redo-replier");
+		M0_UT_ASSERT(rc == 0);
+	}
 
 	ut_remach_boot(&um);
 
@@ -921,6 +1018,34 @@ static void remach_real_log_replay(void)
 	ut_remach_ha_thinks(&um, &HA_THOUGHT(UT_SIDE_SRV, M0_NC_ONLINE));
 
 	ut_remach_shutdown(&um);
+
+	if (redo_window != 0) {
+		m0_mutex_lock(&window_lock);
+		window_stop = true;
+		m0_mutex_unlock(&window_lock);
+		m0_thread_join(&replier);
+		m0_thread_fini(&replier);
+		M0_UT_ASSERT(window_nr == 0);
+		/* The REDOs were sent without waiting for replies. */
+		M0_UT_ASSERT(window_nr_max > 1);
+		M0_UT_ASSERT(window_nr_max == redo_window);
+		m0_mutex_fini(&window_lock);
+	}
+}
+
+/* Use-case: replay a non-empty client log to the server. */
+static void remach_real_log_replay(void)
+{
+	real_log_replay(10, 0);
+}
+
+/*
+ * Use-case: replay a log much longer than the REDO window, so that the
+ * window is filled and drained many times before EOL is sent.
+ */
+static void remach_real_log_replay_window(void)
+{
+	real_log_replay(100, 3);
 }
 
 static uint64_t last_dtxid_dts_phys;
@@ -1488,6 +1613,8 @@ struct m0_ut_suite dtm0_ut = {
 		{ "remach-reboot-twice",    remach_reboot_twice    },
 		{ "remach-boot-real-log",   remach_boot_real_log   },
 		{ "remach-real-log-replay", remach_real_log_replay  },
+		{ "remach-real-log-replay-window",
+			                      remach_real_log_replay_window },
 		{ "remach-rec-mark-empty",    remach_rec_mark_empty       },
 		{ "remach-rec-mark-nonempty", remach_rec_mark_nonempty    },
 		{ "remach-client-eviction-empty-log",
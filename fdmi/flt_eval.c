@@ -25,6 +25,10 @@
 
 #include "lib/types.h"
 #include "lib/errno.h"
+#include "lib/memory.h"
+#include "lib/misc.h"           /* M0_SET0 */
+#include "lib/hash_fnc.h"       /* m0_hash_fnc_fnv1 */
+#include "motr/magic.h"
 
 #include "fdmi/filter.h"
 #include "fdmi/flt_eval.h"
@@ -92,10 +96,72 @@ static int eval_gt(struct m0_fdmi_flt_operands *opnds,
 	return M0_RC(rc);
 }
 
+static int eval_and(struct m0_fdmi_flt_operands *opnds,
+                    struct m0_fdmi_flt_operand  *res)
+{
+	int rc = 0;
+
+	M0_ENTRY();
+
+	if (opnds->ffp_count != 2 ||
+	    opnds->ffp_operands[0].ffo_type != M0_FF_OPND_BOOL ||
+	    opnds->ffp_operands[1].ffo_type != M0_FF_OPND_BOOL) {
+		rc = -EINVAL;
+	} else {
+		m0_fdmi_flt_bool_opnd_fill(res,
+			opnds->ffp_operands[0].ffo_data.fpl_pld.fpl_boolean &&
+			opnds->ffp_operands[1].ffo_data.fpl_pld.fpl_boolean);
+	}
+	return M0_RC(rc);
+}
+
+static bool flt_opnd_eq(const struct m0_fdmi_flt_operand *a,
+			const struct m0_fdmi_flt_operand *b)
+{
+	const struct m0_fdmi_flt_opnd_pld *pa = &a->ffo_data;
+	const struct m0_fdmi_flt_opnd_pld *pb = &b->ffo_data;
+
+	if (a->ffo_type != b->ffo_type || pa->fpl_type != pb->fpl_type)
+		return false;
+	switch (pa->fpl_type) {
+	case M0_FF_OPND_PLD_INT:
+		return pa->fpl_pld.fpl_integer == pb->fpl_pld.fpl_integer;
+	case M0_FF_OPND_PLD_UINT:
+		return pa->fpl_pld.fpl_uinteger == pb->fpl_pld.fpl_uinteger;
+	case M0_FF_OPND_PLD_BOOL:
+		return !pa->fpl_pld.fpl_boolean == !pb->fpl_pld.fpl_boolean;
+	case M0_FF_OPND_PLD_BUF:
+		return m0_buf_eq(&pa->fpl_pld.fpl_buf, &pb->fpl_pld.fpl_buf);
+	default:
+		return false;
+	}
+}
+
+static int eval_equal(struct m0_fdmi_flt_operands *opnds,
+                      struct m0_fdmi_flt_operand  *res)
+{
+	int rc = 0;
+
+	M0_ENTRY();
+
+	if (opnds->ffp_count != 2 ||
+	    opnds->ffp_operands[0].ffo_type !=
+	    opnds->ffp_operands[1].ffo_type) {
+		rc = -EINVAL;
+	} else {
+		m0_fdmi_flt_bool_opnd_fill(res,
+				flt_opnd_eq(&opnds->ffp_operands[0],
+					    &opnds->ffp_operands[1]));
+	}
+	return M0_RC(rc);
+}
+
 static void init_std_operation_handlers(m0_fdmi_flt_op_cb_t *handlers)
 {
-	handlers[M0_FFO_OR] = eval_or;
-	handlers[M0_FFO_GT] = eval_gt;
+	handlers[M0_FFO_OR]    = eval_or;
+	handlers[M0_FFO_AND]   = eval_and;
+	handlers[M0_FFO_EQUAL] = eval_equal;
+	handlers[M0_FFO_GT]    = eval_gt;
 }
 
 M0_INTERNAL int m0_fdmi_eval_add_op_cb(struct m0_fdmi_eval_ctx *ctx,
@@ -207,6 +273,530 @@ M0_INTERNAL void m0_fdmi_eval_fini(struct m0_fdmi_eval_ctx *ctx)
 	M0_LEAVE();
 }
 
+/*
+ ******************************************************************************
+ * Compiled filter programs
+ ******************************************************************************
+ */
+
+static struct m0_fdmi_flt_node *flt_opnd_node(const struct m0_fdmi_flt_node *n,
+					      int                            i)
+{
+	return n->ffn_u.ffn_oper.ffon_opnds.fno_opnds[i].ffnp_ptr;
+}
+
+/**
+ * Counts instructions needed for the sub-tree rooted at @node and returns the
+ * depth of operand stack needed to evaluate it.
+ */
+static int flt_node_size(const struct m0_fdmi_flt_node *node, uint32_t *nr)
+{
+	const struct m0_fdmi_flt_op_node *on;
+	int                               depth = 1;
+	int                               d;
+	int                               i;
+
+	if (node == NULL)
+		return -EINVAL;
+	++*nr;
+	switch (node->ffn_type) {
+	case M0_FLT_OPERAND_NODE:
+	case M0_FLT_VARIABLE_NODE:
+		return 1;
+	case M0_FLT_OPERATION_NODE:
+		on = &node->ffn_u.ffn_oper;
+		if (on->ffon_op_code >= M0_FFO_TOTAL_OPS_CNT ||
+		    on->ffon_opnds.fno_cnt > FDMI_FLT_MAX_OPNDS_NR)
+			return -EINVAL;
+		/* i-th operand is evaluated with i operands on the stack. */
+		for (i = 0; i < on->ffon_opnds.fno_cnt; ++i) {
+			d = flt_node_size(flt_opnd_node(node, i), nr);
+			if (d < 0)
+				return d;
+			depth = max32(depth, d + i);
+		}
+		return depth;
+	default:
+		return -EINVAL;
+	}
+}
+
+static int flt_opnd_copy(struct m0_fdmi_flt_operand       *dst,
+			 const struct m0_fdmi_flt_operand *src)
+{
+	*dst = *src;
+	if (src->ffo_data.fpl_type == M0_FF_OPND_PLD_BUF)
+		return m0_buf_copy(&dst->ffo_data.fpl_pld.fpl_buf,
+				   &src->ffo_data.fpl_pld.fpl_buf);
+	return 0;
+}
+
+static void flt_opnd_free(struct m0_fdmi_flt_operand *opnd)
+{
+	if (opnd->ffo_data.fpl_type == M0_FF_OPND_PLD_BUF)
+		m0_buf_free(&opnd->ffo_data.fpl_pld.fpl_buf);
+}
+
+static int flt_node_emit(struct m0_fdmi_flt_prog       *prog,
+			 const struct m0_fdmi_flt_node *node)
+{
+	const struct m0_fdmi_flt_op_node *on;
+	struct m0_fdmi_flt_insn          *insn;
+	int                               rc = 0;
+	int                               i;
+
+	if (node->ffn_type == M0_FLT_OPERATION_NODE) {
+		on = &node->ffn_u.ffn_oper;
+		for (i = 0; i < on->ffon_opnds.fno_cnt && rc == 0; ++i)
+			rc = flt_node_emit(prog, flt_opnd_node(node, i));
+		if (rc != 0)
+			return rc;
+	}
+	insn = &prog->fp_insns[prog->fp_nr];
+	switch (node->ffn_type) {
+	case M0_FLT_OPERAND_NODE:
+		insn->fi_type = M0_FFI_OPND;
+		rc = flt_opnd_copy(&insn->fi_opnd, &node->ffn_u.ffn_operand);
+		break;
+	case M0_FLT_VARIABLE_NODE:
+		insn->fi_type = M0_FFI_VAR;
+		rc = m0_buf_copy(&insn->fi_var.ffvn_data,
+				 &node->ffn_u.ffn_var.ffvn_data);
+		break;
+	case M0_FLT_OPERATION_NODE:
+		insn->fi_type = M0_FFI_OPER;
+		insn->fi_op   = on->ffon_op_code;
+		insn->fi_nr   = on->ffon_opnds.fno_cnt;
+		break;
+	default:
+		M0_IMPOSSIBLE("Checked by flt_node_size().");
+	}
+	if (rc == 0)
+		++prog->fp_nr;
+	return rc;
+}
+
+M0_INTERNAL int m0_fdmi_flt_prog_compile(struct m0_fdmi_flt_prog     *prog,
+					 const struct m0_fdmi_filter *flt)
+{
+	uint32_t nr = 0;
+	int      depth;
+	int      rc;
+
+	M0_ENTRY("prog=%p flt=%p", prog, flt);
+
+	M0_SET0(prog);
+	depth = flt_node_size(flt->ff_root, &nr);
+	if (depth < 0)
+		return M0_ERR(depth);
+	if (depth > FDMI_FLT_PROG_STACK_MAX)
+		return M0_ERR_INFO(-E2BIG, "depth=%d", depth);
+	M0_ALLOC_ARR(prog->fp_insns, nr);
+	if (prog->fp_insns == NULL)
+		return M0_ERR(-ENOMEM);
+	rc = flt_node_emit(prog, flt->ff_root);
+	if (rc != 0)
+		m0_fdmi_flt_prog_fini(prog);
+	M0_POST(ergo(rc == 0, prog->fp_nr == nr));
+	return M0_RC(rc);
+}
+
+M0_INTERNAL void m0_fdmi_flt_prog_fini(struct m0_fdmi_flt_prog *prog)
+{
+	struct m0_fdmi_flt_insn *insn;
+	uint32_t                 i;
+
+	for (i = 0; i < prog->fp_nr; ++i) {
+		insn = &prog->fp_insns[i];
+		if (insn->fi_type == M0_FFI_OPND)
+			flt_opnd_free(&insn->fi_opnd);
+		else if (insn->fi_type == M0_FFI_VAR)
+			m0_buf_free(&insn->fi_var.ffvn_data);
+	}
+	m0_free(prog->fp_insns);
+	M0_SET0(prog);
+}
+
+static int flt_var_get(struct m0_fdmi_eval_var_info      *var_info,
+		       const struct m0_fdmi_flt_var_node *var,
+		       struct m0_fdmi_flt_operand        *out)
+{
+	if (var_info == NULL || var_info->get_value_cb == NULL)
+		return -EINVAL;
+	return var_info->get_value_cb(var_info->user_data,
+				      (struct m0_fdmi_flt_var_node *)var, out);
+}
+
+M0_INTERNAL int m0_fdmi_flt_prog_eval(struct m0_fdmi_eval_ctx       *ctx,
+				      const struct m0_fdmi_flt_prog *prog,
+				      struct m0_fdmi_eval_var_info  *var_info)
+{
+	struct m0_fdmi_flt_operand     stack[FDMI_FLT_PROG_STACK_MAX];
+	struct m0_fdmi_flt_operands    operands;
+	const struct m0_fdmi_flt_insn *insn;
+	m0_fdmi_flt_op_cb_t            op;
+	uint32_t                       sp = 0;
+	uint32_t                       i;
+	int                            rc = 0;
+
+	M0_PRE(prog->fp_nr > 0);
+
+	for (i = 0; i < prog->fp_nr && rc == 0; ++i) {
+		insn = &prog->fp_insns[i];
+		switch (insn->fi_type) {
+		case M0_FFI_OPND:
+			stack[sp++] = insn->fi_opnd;
+			break;
+		case M0_FFI_VAR:
+			rc = flt_var_get(var_info, &insn->fi_var, &stack[sp++]);
+			break;
+		case M0_FFI_OPER:
+			M0_ASSERT(sp >= insn->fi_nr);
+			sp -= insn->fi_nr;
+			operands.ffp_count = insn->fi_nr;
+			memcpy(operands.ffp_operands, &stack[sp],
+			       insn->fi_nr * sizeof stack[0]);
+			op = ctx->opers[insn->fi_op];
+			rc = op != NULL ? op(&operands, &stack[sp++]) : -ENOSYS;
+			break;
+		default:
+			M0_IMPOSSIBLE("Invalid instruction type %u.",
+				      insn->fi_type);
+		}
+		M0_ASSERT(sp <= FDMI_FLT_PROG_STACK_MAX);
+	}
+	if (rc == 0) {
+		M0_ASSERT(sp == 1);
+		if (stack[0].ffo_type != M0_FF_OPND_BOOL ||
+		    stack[0].ffo_data.fpl_type != M0_FF_OPND_PLD_BOOL)
+			return M0_ERR(-EINVAL);
+		rc = stack[0].ffo_data.fpl_pld.fpl_boolean;
+	}
+	return rc;
+}
+
+/*
+ ******************************************************************************
+ * Filter sets
+ ******************************************************************************
+ */
+
+/** Filter in a set. */
+struct fdmi_flt_entry {
+	uint64_t                     fe_magic;
+	struct m0_conf_fdmi_filter  *fe_flt;
+	/** Compiled program. Used if fe_prog.fp_nr != 0. */
+	struct m0_fdmi_flt_prog      fe_prog;
+	/** Evaluator for filters which are not compiled. */
+	m0_fdmi_flt_eval_t           fe_eval;
+	/** Guard variable, valid if the filter is indexed. */
+	struct m0_fdmi_flt_var_node  fe_gvar;
+	/** Guard constant, valid if the filter is indexed. */
+	struct m0_fdmi_flt_operand   fe_gval;
+	/** Linkage into m0_fdmi_flt_set::fs_generic or a bucket. */
+	struct m0_tlink              fe_linkage;
+};
+
+/** Distinct guard variable. */
+struct fdmi_flt_var {
+	uint64_t                           fv_magic;
+	uint32_t                           fv_id;
+	/** Points to fdmi_flt_entry::fe_gvar of the first guarded filter. */
+	const struct m0_fdmi_flt_var_node *fv_node;
+	struct m0_tlink                    fv_linkage;
+};
+
+struct fdmi_flt_key {
+	/** fdmi_flt_var::fv_id */
+	uint32_t                          fk_var;
+	const struct m0_fdmi_flt_operand *fk_val;
+};
+
+/** Filters guarded by the same (variable, constant) pair. */
+struct fdmi_flt_bucket {
+	uint64_t            fb_magic;
+	struct fdmi_flt_key fb_key;
+	struct m0_hlink     fb_hlink;
+	struct m0_tl        fb_entries;
+};
+
+M0_TL_DESCR_DEFINE(fdmi_flt_entry, "fdmi filter set entries", static,
+		   struct fdmi_flt_entry, fe_linkage, fe_magic,
+		   M0_FDMI_FLT_SET_ENTRY_MAGIC,
+		   M0_FDMI_FLT_SET_ENTRY_HEAD_MAGIC);
+M0_TL_DEFINE(fdmi_flt_entry, static, struct fdmi_flt_entry);
+
+M0_TL_DESCR_DEFINE(fdmi_flt_var, "fdmi filter set guard vars", static,
+		   struct fdmi_flt_var, fv_linkage, fv_magic,
+		   M0_FDMI_FLT_SET_VAR_MAGIC, M0_FDMI_FLT_SET_VAR_HEAD_MAGIC);
+M0_TL_DEFINE(fdmi_flt_var, static, struct fdmi_flt_var);
+
+static uint64_t flt_key_hash(const struct m0_htable *htable, const void *k)
+{
+	const struct fdmi_flt_key         *key = k;
+	const struct m0_fdmi_flt_opnd_pld *pld = &key->fk_val->ffo_data;
+	uint64_t                           h;
+
+	switch (pld->fpl_type) {
+	case M0_FF_OPND_PLD_INT:
+	case M0_FF_OPND_PLD_UINT:
+		h = pld->fpl_pld.fpl_uinteger;
+		break;
+	case M0_FF_OPND_PLD_BOOL:
+		h = !!pld->fpl_pld.fpl_boolean;
+		break;
+	case M0_FF_OPND_PLD_BUF:
+		h = m0_hash_fnc_fnv1(pld->fpl_pld.fpl_buf.b_addr,
+				     pld->fpl_pld.fpl_buf.b_nob);
+		break;
+	default:
+		h = 0;
+	}
+	return m0_hash(h + key->fk_var) % htable->h_bucket_nr;
+}
+
+static bool flt_key_eq(const void *k0, const void *k1)
+{
+	const struct fdmi_flt_key *key0 = k0;
+	const struct fdmi_flt_key *key1 = k1;
+
+	return key0->fk_var == key1->fk_var &&
+		flt_opnd_eq(key0->fk_val, key1->fk_val);
+}
+
+M0_HT_DESCR_DEFINE(fdmi_flt_bucket, "fdmi filter set index", static,
+		   struct fdmi_flt_bucket, fb_hlink, fb_magic,
+		   M0_FDMI_FLT_SET_BUCKET_MAGIC,
+		   M0_FDMI_FLT_SET_BUCKET_HEAD_MAGIC,
+		   fb_key, flt_key_hash, flt_key_eq);
+M0_HT_DEFINE(fdmi_flt_bucket, static, struct fdmi_flt_bucket,
+	     struct fdmi_flt_key);
+
+M0_INTERNAL int m0_fdmi_flt_set_init(struct m0_fdmi_flt_set *set)
+{
+	M0_SET0(set);
+	fdmi_flt_entry_tlist_init(&set->fs_generic);
+	fdmi_flt_var_tlist_init(&set->fs_vars);
+	return fdmi_flt_bucket_htable_init(&set->fs_index,
+					   FDMI_FLT_SET_BUCKET_NR);
+}
+
+static void flt_entry_free(struct fdmi_flt_entry *e)
+{
+	fdmi_flt_entry_tlink_fini(e);
+	if (e->fe_prog.fp_nr != 0) {
+		m0_fdmi_flt_prog_fini(&e->fe_prog);
+		m0_buf_free(&e->fe_gvar.ffvn_data);
+		flt_opnd_free(&e->fe_gval);
+	}
+	m0_free(e);
+}
+
+M0_INTERNAL void m0_fdmi_flt_set_fini(struct m0_fdmi_flt_set *set)
+{
+	struct fdmi_flt_bucket *b;
+	struct fdmi_flt_entry  *e;
+	struct fdmi_flt_var    *v;
+
+	m0_tl_teardown(fdmi_flt_entry, &set->fs_generic, e)
+		flt_entry_free(e);
+	fdmi_flt_entry_tlist_fini(&set->fs_generic);
+	m0_tl_teardown(fdmi_flt_var, &set->fs_vars, v) {
+		fdmi_flt_var_tlink_fini(v);
+		m0_free(v);
+	}
+	fdmi_flt_var_tlist_fini(&set->fs_vars);
+	m0_htable_for(fdmi_flt_bucket, b, &set->fs_index) {
+		fdmi_flt_bucket_htable_del(&set->fs_index, b);
+		fdmi_flt_bucket_tlink_fini(b);
+		m0_tl_teardown(fdmi_flt_entry, &b->fb_entries, e)
+			flt_entry_free(e);
+		fdmi_flt_entry_tlist_fini(&b->fb_entries);
+		m0_free(b);
+	} m0_htable_endfor;
+	fdmi_flt_bucket_htable_fini(&set->fs_index);
+}
+
+/**
+ * Finds a (variable == constant) conjunct, which must hold for the filter
+ * to be true.
+ */
+static bool flt_guard_find(const struct m0_fdmi_flt_node    *node,
+			   const struct m0_fdmi_flt_var_node **var,
+			   const struct m0_fdmi_flt_operand  **val)
+{
+	const struct m0_fdmi_flt_op_node *on = &node->ffn_u.ffn_oper;
+	const struct m0_fdmi_flt_node    *l;
+	const struct m0_fdmi_flt_node    *r;
+
+	if (node->ffn_type != M0_FLT_OPERATION_NODE ||
+	    on->ffon_opnds.fno_cnt != 2)
+		return false;
+	l = flt_opnd_node(node, 0);
+	r = flt_opnd_node(node, 1);
+	switch (on->ffon_op_code) {
+	case M0_FFO_AND:
+		return flt_guard_find(l, var, val) ||
+			flt_guard_find(r, var, val);
+	case M0_FFO_EQUAL:
+		if (l->ffn_type == M0_FLT_OPERAND_NODE)
+			M0_SWAP(l, r);
+		if (l->ffn_type != M0_FLT_VARIABLE_NODE ||
+		    r->ffn_type != M0_FLT_OPERAND_NODE)
+			return false;
+		*var = &l->ffn_u.ffn_var;
+		*val = &r->ffn_u.ffn_operand;
+		return true;
+	default:
+		return false;
+	}
+}
+
+static int flt_set_index(struct m0_fdmi_flt_set *set,
+			 struct fdmi_flt_entry  *e)
+{
+	struct fdmi_flt_bucket *b;
+	struct fdmi_flt_var    *v;
+	struct fdmi_flt_key     key;
+	bool                    new_var = false;
+
+	v = m0_tl_find(fdmi_flt_var, v, &set->fs_vars,
+		       m0_buf_eq(&v->fv_node->ffvn_data,
+				 &e->fe_gvar.ffvn_data));
+	if (v == NULL) {
+		M0_ALLOC_PTR(v);
+		if (v == NULL)
+			return M0_ERR(-ENOMEM);
+		v->fv_id   = fdmi_flt_var_tlist_length(&set->fs_vars);
+		v->fv_node = &e->fe_gvar;
+		fdmi_flt_var_tlink_init_at_tail(v, &set->fs_vars);
+		new_var = true;
+	}
+	key = (struct fdmi_flt_key) { .fk_var = v->fv_id,
+				      .fk_val = &e->fe_gval };
+	b = fdmi_flt_bucket_htable_lookup(&set->fs_index, &key);
+	if (b == NULL) {
+		M0_ALLOC_PTR(b);
+		if (b == NULL) {
+			/* v->fv_node points into e, which the caller frees. */
+			if (new_var) {
+				fdmi_flt_var_tlink_del_fini(v);
+				m0_free(v);
+			}
+			return M0_ERR(-ENOMEM);
+		}
+		b->fb_key = key;
+		fdmi_flt_bucket_tlink_init(b);
+		fdmi_flt_entry_tlist_init(&b->fb_entries);
+		fdmi_flt_bucket_htable_add(&set->fs_index, b);
+	}
+	fdmi_flt_entry_tlink_init_at_tail(e, &b->fb_entries);
+	set->fs_indexed_nr++;
+	return 0;
+}
+
+M0_INTERNAL int m0_fdmi_flt_set_add(struct m0_fdmi_flt_set     *set,
+				    struct m0_conf_fdmi_filter *filter,
+				    m0_fdmi_flt_eval_t          eval)
+{
+	const struct m0_fdmi_flt_var_node *gvar;
+	const struct m0_fdmi_flt_operand  *gval;
+	struct fdmi_flt_entry             *e;
+	int                                rc;
+
+	M0_ENTRY("set=%p filter=%p", set, filter);
+
+	M0_ALLOC_PTR(e);
+	if (e == NULL)
+		return M0_ERR(-ENOMEM);
+	e->fe_flt  = filter;
+	e->fe_eval = eval;
+	if (filter->ff_type == M0_FDMI_FILTER_TYPE_TREE &&
+	    m0_fdmi_flt_prog_compile(&e->fe_prog, &filter->ff_filter) == 0 &&
+	    flt_guard_find(filter->ff_filter.ff_root, &gvar, &gval)) {
+		rc = m0_buf_copy(&e->fe_gvar.ffvn_data, &gvar->ffvn_data) ?:
+			flt_opnd_copy(&e->fe_gval, gval) ?:
+			flt_set_index(set, e);
+		if (rc != 0) {
+			flt_entry_free(e);
+			return M0_ERR(rc);
+		}
+	} else {
+		fdmi_flt_entry_tlink_init_at_tail(e, &set->fs_generic);
+	}
+	set->fs_nr++;
+	return M0_RC(0);
+}
+
+static int flt_entry_eval(struct m0_fdmi_flt_set       *set,
+			  struct fdmi_flt_entry        *e,
+			  struct m0_fdmi_eval_ctx      *ctx,
+			  struct m0_fdmi_eval_var_info *var_info,
+			  void (*matched)(struct m0_conf_fdmi_filter *, void *),
+			  void                         *datum)
+{
+	int rc;
+
+	set->fs_visited++;
+	if (e->fe_prog.fp_nr != 0)
+		rc = m0_fdmi_flt_prog_eval(ctx, &e->fe_prog, var_info);
+	else if (e->fe_eval != NULL)
+		rc = e->fe_eval(ctx, e->fe_flt, var_info);
+	else
+		rc = -EINVAL;
+	if (rc > 0) {
+		matched(e->fe_flt, datum);
+		return 1;
+	}
+	if (rc < 0)
+		M0_LOG(M0_DEBUG, "filter "FID_F" evaluation failed: %d",
+		       FID_P(&e->fe_flt->ff_filter_id), rc);
+	return 0;
+}
+
+M0_INTERNAL int m0_fdmi_flt_set_match(struct m0_fdmi_flt_set       *set,
+				      struct m0_fdmi_eval_ctx      *ctx,
+				      struct m0_fdmi_eval_var_info *var_info,
+				      void (*matched)(struct m0_conf_fdmi_filter *,
+						      void *),
+				      void                         *datum)
+{
+	struct m0_fdmi_flt_operand  val;
+	struct fdmi_flt_bucket     *b;
+	struct fdmi_flt_entry      *e;
+	struct fdmi_flt_var        *v;
+	struct fdmi_flt_key         key;
+	int                         nr = 0;
+	int                         rc;
+
+	M0_ENTRY("set=%p", set);
+
+	m0_tl_for(fdmi_flt_entry, &set->fs_generic, e) {
+		nr += flt_entry_eval(set, e, ctx, var_info, matched, datum);
+	} m0_tl_endfor;
+
+	m0_tl_for(fdmi_flt_var, &set->fs_vars, v) {
+		/*
+		 * Filters guarded by a variable which cannot be evaluated
+		 * would fail evaluation as well.
+		 */
+		rc = flt_var_get(var_info, v->fv_node, &val);
+		if (rc != 0)
+			continue;
+		key = (struct fdmi_flt_key) { .fk_var = v->fv_id,
+					      .fk_val = &val };
+		b = fdmi_flt_bucket_htable_lookup(&set->fs_index, &key);
+		if (b == NULL)
+			continue;
+		m0_tl_for(fdmi_flt_entry, &b->fb_entries, e) {
+			nr += flt_entry_eval(set, e, ctx, var_info,
+					     matched, datum);
+		} m0_tl_endfor;
+	} m0_tl_endfor;
+
+	return M0_RC(nr);
+}
+
 #undef M0_TRACE_SUBSYSTEM
 
 /*
@@ -25,6 +25,8 @@
 #ifndef __MOTR_FDMI_FDMI_FLT_EVAL_H__
 #define __MOTR_FDMI_FDMI_FLT_EVAL_H__
 
+#include "lib/tlist.h"
+#include "lib/hash.h"
 #include "fdmi/filter.h"
 /**
  * @defgroup FDMI_DLD_fspec_filter_eval FDMI filter evaluator description
@@ -129,6 +131,151 @@ M0_INTERNAL int m0_fdmi_eval_flt(struct m0_fdmi_eval_ctx      *ctx,
  */
 M0_INTERNAL void m0_fdmi_eval_fini(struct m0_fdmi_eval_ctx *ctx);
 
+/**
+ * Compiled filters
+ * ----------------
+ *
+ * Interpreting the filter tree for every posted record is expensive when
+ * many filters are registered. A filter expression tree can be compiled into
+ * a flat post-order program (m0_fdmi_flt_prog), which is evaluated by a
+ * simple loop over an operand stack.
+ *
+ * Compiled filters are grouped into a filter set (m0_fdmi_flt_set). Filters
+ * whose expression can only be true if some variable equals some constant
+ * (the root of the tree is M0_FFO_EQUAL of a variable and a constant, or
+ * M0_FFO_AND with such a conjunct) are indexed by (variable, constant).
+ * Matching a record against the set evaluates each distinct indexed variable
+ * once, looks up the filters guarded by its value and only evaluates those,
+ * plus the filters which could not be indexed.
+ *
+ * Indexing relies on the standard M0_FFO_EQUAL and M0_FFO_AND semantics.
+ * Filter evaluation errors are treated as "no match", so a filter skipped by
+ * the index because the guard variable has a value of different type (which
+ * would be an evaluation error) is handled the same way as by the tree
+ * evaluator.
+ */
+
+enum {
+	/** Maximal depth of the operand stack of a compiled filter program. */
+	FDMI_FLT_PROG_STACK_MAX = 16,
+	/** Number of buckets in the filter set index. */
+	FDMI_FLT_SET_BUCKET_NR  = 64
+};
+
+/** Instruction types of a compiled filter program. */
+enum m0_fdmi_flt_insn_type {
+	/** Push constant operand. */
+	M0_FFI_OPND,
+	/** Push value of a variable node. */
+	M0_FFI_VAR,
+	/** Pop operands, apply operation and push the result. */
+	M0_FFI_OPER
+};
+
+/** Instruction of a compiled filter program. */
+struct m0_fdmi_flt_insn {
+	/** Instruction type (@ref m0_fdmi_flt_insn_type). */
+	uint32_t                    fi_type;
+	/** Operation code (@ref m0_fdmi_flt_op_code), for M0_FFI_OPER. */
+	uint32_t                    fi_op;
+	/** Number of operands popped, for M0_FFI_OPER. */
+	uint32_t                    fi_nr;
+	/** Constant operand, for M0_FFI_OPND. */
+	struct m0_fdmi_flt_operand  fi_opnd;
+	/** Variable descriptor, for M0_FFI_VAR. */
+	struct m0_fdmi_flt_var_node fi_var;
+};
+
+/**
+ * Filter expression tree compiled into a post-order program.
+ *
+ * The program owns copies of all constant operands and variable descriptors,
+ * so it stays valid after the source tree is finalised.
+ */
+struct m0_fdmi_flt_prog {
+	uint32_t                 fp_nr;
+	struct m0_fdmi_flt_insn *fp_insns;
+};
+
+/**
+ * Evaluator of a filter which is not a tree filter
+ * (see m0_fdmi_sd_filter_type_handler).
+ */
+typedef int (*m0_fdmi_flt_eval_t)(struct m0_fdmi_eval_ctx      *ctx,
+				  struct m0_conf_fdmi_filter   *filter,
+				  struct m0_fdmi_eval_var_info *var_info);
+
+/** Set of compiled filters, indexed by their equality guards. */
+struct m0_fdmi_flt_set {
+	/** Filters which have to be evaluated for every record. */
+	struct m0_tl     fs_generic;
+	/** Distinct variables used by the guards of indexed filters. */
+	struct m0_tl     fs_vars;
+	/** (variable, constant) -> list of filters guarded by it. */
+	struct m0_htable fs_index;
+	/** Number of filters in the set. */
+	uint32_t         fs_nr;
+	/** Number of filters indexed by a guard. */
+	uint32_t         fs_indexed_nr;
+	/** Number of filter evaluations done by m0_fdmi_flt_set_match(). */
+	uint64_t         fs_visited;
+};
+
+/**
+ * Compiles filter expression tree into a program.
+ *
+ * @return -EINVAL if the tree is malformed, @n
+ *         -E2BIG if the tree is too deep (see FDMI_FLT_PROG_STACK_MAX).
+ */
+M0_INTERNAL int m0_fdmi_flt_prog_compile(struct m0_fdmi_flt_prog     *prog,
+					 const struct m0_fdmi_filter *flt);
+
+/** Releases resources of a compiled program. */
+M0_INTERNAL void m0_fdmi_flt_prog_fini(struct m0_fdmi_flt_prog *prog);
+
+/**
+ * Evaluates compiled filter program.
+ *
+ * Return value has the same meaning as for m0_fdmi_eval_flt().
+ */
+M0_INTERNAL int m0_fdmi_flt_prog_eval(struct m0_fdmi_eval_ctx       *ctx,
+				      const struct m0_fdmi_flt_prog *prog,
+				      struct m0_fdmi_eval_var_info  *var_info);
+
+M0_INTERNAL int  m0_fdmi_flt_set_init(struct m0_fdmi_flt_set *set);
+M0_INTERNAL void m0_fdmi_flt_set_fini(struct m0_fdmi_flt_set *set);
+
+/**
+ * Adds filter to the set.
+ *
+ * Tree filters are compiled and, if possible, indexed. Other filters (and
+ * tree filters which cannot be compiled) are evaluated with @eval for every
+ * record. @eval may be NULL, in which case evaluation of the filter fails
+ * with -EINVAL.
+ *
+ * The set keeps a pointer to @filter. Filters which cannot be compiled are
+ * evaluated on the filter expression tree, so the caller must keep @filter
+ * and its tree alive while the filter is in the set.
+ */
+M0_INTERNAL int m0_fdmi_flt_set_add(struct m0_fdmi_flt_set     *set,
+				    struct m0_conf_fdmi_filter *filter,
+				    m0_fdmi_flt_eval_t          eval);
+
+/**
+ * Matches record described by @var_info against the filters of the set.
+ *
+ * @matched is called for each filter evaluated to true. Filters are visited
+ * in no particular order.
+ *
+ * @return number of matched filters.
+ */
+M0_INTERNAL int m0_fdmi_flt_set_match(struct m0_fdmi_flt_set       *set,
+				      struct m0_fdmi_eval_ctx      *ctx,
+				      struct m0_fdmi_eval_var_info *var_info,
+				      void (*matched)(struct m0_conf_fdmi_filter *,
+						      void *),
+				      void                         *datum);
+
 /** @} end of FDMI_DLD_fspec_filter_eval */
 
 #endif /* __MOTR_FDMI_FDMI_FLT_EVAL_H__ */
@@ -706,6 +706,13 @@ M0_INTERNAL void m0_fol_fdmi_post_record(struct m0_fom *fom)
 	M0_LEAVE();
 }
 
+M0_INTERNAL bool m0_fol_fdmi_is_posting(void)
+{
+	struct m0_fdmi_src_dock *src_dock = m0_fdmi_src_dock_get();
+
+	return src_dock->fsdc_started && src_dock->fsdc_filters_defined;
+}
+
 M0_INTERNAL bool
 m0_fol_fdmi__filter_kv_substring_match(struct m0_buf  *value,
                                        const char    **substrings)
@@ -88,6 +88,12 @@ M0_INTERNAL int m0_fol_fdmi_src_deinit(void);
 /** Submit new FOL entry to FDMI. */
 M0_INTERNAL void m0_fol_fdmi_post_record(struct m0_fom *fom);
 
+/**
+ * Returns true if m0_fol_fdmi_post_record() would post a record, that is if
+ * the source dock is running and FDMI filters are defined.
+ */
+M0_INTERNAL bool m0_fol_fdmi_is_posting(void);
+
 /** Implements M0_FDMI_FILTER_TYPE_KV_SUBSTRING filter. */
 M0_INTERNAL int
 m0_fol_fdmi_filter_kv_substring(struct m0_fdmi_eval_ctx      *ctx,
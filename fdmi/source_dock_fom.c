@@ -40,9 +40,10 @@ static size_t fdmi_sd_fom_locality(const struct m0_fom *fom);
 static int sd_fom_send_record(struct fdmi_sd_fom *sd_fom,
 			      struct m0_fop      *fop,
 			      const char         *ep);
-static int fdmi_filter_calc(struct fdmi_sd_fom         *sd_fom,
-			    struct m0_fdmi_src_rec     *src_rec,
-			    struct m0_conf_fdmi_filter *fdmi_filter);
+static m0_fdmi_flt_eval_t fdmi_filter_type_eval(enum m0_fdmi_filter_type_id id);
+static int node_eval(void                        *data,
+		     struct m0_fdmi_flt_var_node *value_desc,
+		     struct m0_fdmi_flt_operand  *value);
 
 static int fdmi_rr_fom_create(struct m0_fop *fop, struct m0_fom **out,
 			      struct m0_reqh *reqh);
@@ -257,6 +258,16 @@ M0_INTERNAL void m0_fdmi__src_dock_fom_init(void)
 	M0_LEAVE();
 }
 
+static bool fdmi_sd_conf_expired_cb(struct m0_clink *clink)
+{
+	struct fdmi_sd_fom *sd_fom = M0_AMB(sd_fom, clink, fsf_conf_exp);
+
+	M0_ENTRY("sd_fom %p", sd_fom);
+	m0_atomic64_inc(&sd_fom->fsf_conf_gen);
+	M0_LEAVE();
+	return true;
+}
+
 M0_INTERNAL int
 m0_fdmi__src_dock_fom_start(struct m0_fdmi_src_dock *src_dock,
 			    const struct m0_filterc_ops *filterc_ops,
@@ -315,6 +326,11 @@ m0_fdmi__src_dock_fom_start(struct m0_fdmi_src_dock *src_dock,
 	M0_LOG(M0_DEBUG, "Filters?=%d", !!src_dock->fsdc_filters_defined);
 
 	m0_fdmi_eval_init(&sd_fom->fsf_flt_eval);
+	M0_SET_ARR0(sd_fom->fsf_flt_cache);
+	m0_atomic64_set(&sd_fom->fsf_conf_gen, 0);
+	sd_fom->fsf_flt_gen = 0;
+	m0_clink_init(&sd_fom->fsf_conf_exp, fdmi_sd_conf_expired_cb);
+	m0_clink_add_lock(&reqh->rh_conf_cache_exp, &sd_fom->fsf_conf_exp);
 	m0_mutex_init(&sd_fom->fsf_pending_fops_lock);
 	pending_fops_tlist_init(&sd_fom->fsf_pending_fops);
 	sd_fom->fsf_has_records = false;
@@ -376,56 +392,123 @@ static size_t fdmi_sd_fom_locality(const struct m0_fom *fom)
 	return 1;
 }
 
-static int apply_filters(struct fdmi_sd_fom     *sd_fom,
-			 struct m0_fdmi_src_rec *src_rec)
+static void flt_cache_drop(struct fdmi_sd_fom *sd_fom)
+{
+	struct fdmi_sd_flt_cache *fc;
+	int                       i;
+
+	for (i = 0; i < ARRAY_SIZE(sd_fom->fsf_flt_cache); ++i) {
+		fc = &sd_fom->fsf_flt_cache[i];
+		if (fc->fc_valid)
+			m0_fdmi_flt_set_fini(&fc->fc_set);
+		fc->fc_valid = false;
+	}
+}
+
+static int flt_set_build(struct fdmi_sd_fom      *sd_fom,
+			 struct m0_fdmi_flt_set  *set,
+			 enum m0_fdmi_rec_type_id rec_type)
 {
 	struct m0_fom              *fom = &sd_fom->fsf_fom;
 	struct m0_filterc_ctx      *filterc = &sd_fom->fsf_filter_ctx;
 	struct m0_conf_fdmi_filter *fdmi_filter;
-	int                         matched;
-	int                         rc = 0;
-	int                         ret;
+	int                         rc;
 
-	M0_ENTRY("sd_fom %p, src_rec %p", sd_fom, src_rec);
-	M0_PRE(m0_fdmi__record_is_valid(src_rec));
+	M0_ENTRY("sd_fom %p, rec_type %x", sd_fom, rec_type);
 
-	do {
-		/* @todo fco_get_next shouldn't block (phase 2) */
-		m0_fom_block_enter(fom);
-		ret = filterc->fcc_ops->fco_get_next(&sd_fom->fsf_filter_iter,
-						     &fdmi_filter);
-		m0_fom_block_leave(fom);
-		if (ret > 0) {
-			matched = fdmi_filter_calc(sd_fom, src_rec,
-						   fdmi_filter);
-			src_rec->fsr_matched = (matched > 0);
-			if (matched < 0) {
-				/**
-				 * @todo Mark FDMI filter as invalid
-				 * (send HA not?) (phase 2)
-				 */
-			} else if (matched && !src_rec->fsr_dryrun) {
-				/**
-				 * This list is accessed and modified
-				 * from thread at a time. No protection
-				 * needed.
-				 */
-				fdmi_matched_filter_list_tlink_init_at(
-					fdmi_filter, &src_rec->fsr_filter_list);
-			}
-		} else if (ret < 0) {
-			rc = ret;
+	/* @todo fco_open and fco_get_next shouldn't block (phase 2) */
+	m0_fom_block_enter(fom);
+	rc = filterc->fcc_ops->fco_open(filterc, rec_type,
+					&sd_fom->fsf_filter_iter);
+	if (rc == 0) {
+		while ((rc = filterc->fcc_ops->fco_get_next(
+				     &sd_fom->fsf_filter_iter,
+				     &fdmi_filter)) > 0) {
+			rc = m0_fdmi_flt_set_add(set, fdmi_filter,
+				fdmi_filter_type_eval(fdmi_filter->ff_type));
+			if (rc != 0)
+				break;
 		}
-	} while (ret > 0);
+		filterc->fcc_ops->fco_close(&sd_fom->fsf_filter_iter);
+	}
+	m0_fom_block_leave(fom);
 	return M0_RC(rc);
 }
 
+/**
+ * Returns compiled filter set for the record type, building it on the first
+ * use.
+ */
+static int flt_set_get(struct fdmi_sd_fom       *sd_fom,
+		       enum m0_fdmi_rec_type_id  rec_type,
+		       struct m0_fdmi_flt_set  **out)
+{
+	struct fdmi_sd_flt_cache *fc = NULL;
+	int64_t                   gen;
+	int                       rc;
+	int                       i;
+
+	gen = m0_atomic64_get(&sd_fom->fsf_conf_gen);
+	if (gen != sd_fom->fsf_flt_gen) {
+		M0_LOG(M0_DEBUG, "conf expired, dropping compiled filters");
+		flt_cache_drop(sd_fom);
+		sd_fom->fsf_flt_gen = gen;
+	}
+	for (i = 0; i < ARRAY_SIZE(sd_fom->fsf_flt_cache); ++i) {
+		if (sd_fom->fsf_flt_cache[i].fc_valid &&
+		    sd_fom->fsf_flt_cache[i].fc_rec_type == rec_type) {
+			*out = &sd_fom->fsf_flt_cache[i].fc_set;
+			return 0;
+		}
+		if (!sd_fom->fsf_flt_cache[i].fc_valid && fc == NULL)
+			fc = &sd_fom->fsf_flt_cache[i];
+	}
+	if (fc == NULL) {
+		flt_cache_drop(sd_fom);
+		fc = &sd_fom->fsf_flt_cache[0];
+	}
+	rc = m0_fdmi_flt_set_init(&fc->fc_set);
+	if (rc != 0)
+		return M0_ERR(rc);
+	rc = flt_set_build(sd_fom, &fc->fc_set, rec_type);
+	if (rc != 0) {
+		m0_fdmi_flt_set_fini(&fc->fc_set);
+		return M0_RC(rc);
+	}
+	M0_LOG(M0_DEBUG, "rec_type %x: %u filters, %u indexed", rec_type,
+	       fc->fc_set.fs_nr, fc->fc_set.fs_indexed_nr);
+	fc->fc_rec_type = rec_type;
+	fc->fc_valid    = true;
+	*out = &fc->fc_set;
+	return 0;
+}
+
+static void filter_matched(struct m0_conf_fdmi_filter *fdmi_filter,
+			   void                       *datum)
+{
+	struct m0_fdmi_src_rec *src_rec = datum;
+
+	src_rec->fsr_matched = true;
+	if (!src_rec->fsr_dryrun) {
+		/**
+		 * This list is accessed and modified
+		 * from thread at a time. No protection
+		 * needed.
+		 */
+		fdmi_matched_filter_list_tlink_init_at(
+			fdmi_filter, &src_rec->fsr_filter_list);
+	}
+}
+
 static int process_fdmi_rec(struct fdmi_sd_fom *sd_fom,
 			    struct m0_fdmi_src_rec *src_rec)
 {
-	struct m0_fom         *fom = &sd_fom->fsf_fom;
-	struct m0_filterc_ctx *filterc = &sd_fom->fsf_filter_ctx;
-	int                    ret;
+	struct m0_fdmi_eval_var_info  get_var_info = {
+		.user_data    = src_rec,
+		.get_value_cb = node_eval
+	};
+	struct m0_fdmi_flt_set       *set;
+	int                           ret;
 
 	M0_ENTRY("sd_fom %p, src_rec %p", sd_fom, src_rec);
 	M0_PRE(m0_fdmi__record_is_valid(src_rec));
@@ -438,15 +521,16 @@ static int process_fdmi_rec(struct fdmi_sd_fom *sd_fom,
 	 */
 	m0_fdmi__fs_begin(src_rec);
 
-	m0_fom_block_enter(fom);
-	ret = filterc->fcc_ops->fco_open(filterc,
-					 m0_fdmi__sd_rec_type_id_get(src_rec),
-					 &sd_fom->fsf_filter_iter);
-	m0_fom_block_leave(fom);
-
+	ret = flt_set_get(sd_fom, m0_fdmi__sd_rec_type_id_get(src_rec), &set);
 	if (ret == 0) {
-		ret = apply_filters(sd_fom, src_rec);
-		filterc->fcc_ops->fco_close(&sd_fom->fsf_filter_iter);
+		src_rec->fsr_matched = false;
+		/**
+		 * @todo Mark FDMI filters failed to evaluate as invalid
+		 * (send HA not?) (phase 2)
+		 */
+		(void)m0_fdmi_flt_set_match(set, &sd_fom->fsf_flt_eval,
+					    &get_var_info, filter_matched,
+					    src_rec);
 	}
 	return M0_RC(ret);
 }
@@ -462,6 +546,9 @@ static void fdmi_sd_fom_fini(struct m0_fom *fom)
 	filterc_ctx->fcc_ops->fco_stop(filterc_ctx);
 	m0_filterc_ctx_fini(filterc_ctx);
 
+	flt_cache_drop(sd_fom);
+	m0_clink_del_lock(&sd_fom->fsf_conf_exp);
+	m0_clink_fini(&sd_fom->fsf_conf_exp);
 	m0_fdmi_eval_fini(&sd_fom->fsf_flt_eval);
 
 	m0_rpc_conn_pool_fini(&sd_fom->fsf_conn_pool);
@@ -824,35 +911,16 @@ static struct m0_fdmi_sd_filter_type_handler fdmi_filter_type_handlers[] = {
 	},
 };
 
-static int fdmi_filter_calc(struct fdmi_sd_fom         *sd_fom,
-			    struct m0_fdmi_src_rec     *src_rec,
-			    struct m0_conf_fdmi_filter *fdmi_filter)
+static m0_fdmi_flt_eval_t fdmi_filter_type_eval(enum m0_fdmi_filter_type_id id)
 {
-	struct m0_fdmi_sd_filter_type_handler *handler;
-	struct m0_fdmi_eval_var_info           get_var_info;
-	int                                    rc;
-	int                                    i;
-
-	M0_ENTRY("sd_fom=%p src_rec=%p fdmi_filter=%p",
-		 sd_fom, src_rec, fdmi_filter);
-	M0_PRE(m0_fdmi__record_is_valid(src_rec));
-
-	get_var_info.user_data    = src_rec;
-	get_var_info.get_value_cb = node_eval;
+	int i;
 
 	for (i = 0; i < ARRAY_SIZE(fdmi_filter_type_handlers); ++i) {
-		handler = &fdmi_filter_type_handlers[i];
-		if (handler->ffth_id == fdmi_filter->ff_type) {
-			rc = handler->ffth_handler(&sd_fom->fsf_flt_eval,
-						   fdmi_filter,
-						   &get_var_info);
-			return M0_RC_INFO(rc,
-					  "sd_fom=%p src_rec=%p fdmi_filter=%p",
-					  sd_fom, src_rec, fdmi_filter);
-
-		}
+		if (fdmi_filter_type_handlers[i].ffth_id == id)
+			return fdmi_filter_type_handlers[i].ffth_handler;
 	}
-	return M0_ERR_INFO(-EINVAL, "ff_filter_id=%d", fdmi_filter->ff_type);
+	M0_LOG(M0_ERROR, "Unknown filter type %d", id);
+	return NULL;
 }
 
 
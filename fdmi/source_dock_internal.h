@@ -64,6 +64,24 @@ M0_TL_DECLARE(fdmi_record_list, M0_EXTERN, struct m0_fdmi_src_rec);
 M0_TL_DESCR_DECLARE(fdmi_matched_filter_list, M0_EXTERN);
 M0_TL_DECLARE(fdmi_matched_filter_list, M0_EXTERN, struct m0_conf_fdmi_filter);
 
+enum {
+	/** Number of FDMI record types with cached compiled filters. */
+	FDMI_SD_FLT_CACHE_NR = 4
+};
+
+/**
+ * Compiled filters of an FDMI record type.
+ *
+ * Filter sets are built from filterc on the first record of the type and
+ * dropped when configuration cache expires (m0_reqh::rh_conf_cache_exp), as
+ * they refer to m0_conf_fdmi_filter objects.
+ */
+struct fdmi_sd_flt_cache {
+	enum m0_fdmi_rec_type_id fc_rec_type;
+	bool                     fc_valid;
+	struct m0_fdmi_flt_set   fc_set;
+};
+
 /** FDMI source dock FOM */
 struct fdmi_sd_fom {
 	struct m0_fom           fsf_fom;
@@ -72,6 +90,12 @@ struct fdmi_sd_fom {
 	struct m0_filterc_ctx   fsf_filter_ctx;
 	struct m0_filterc_iter  fsf_filter_iter;
 	struct m0_fdmi_eval_ctx fsf_flt_eval;
+	struct fdmi_sd_flt_cache fsf_flt_cache[FDMI_SD_FLT_CACHE_NR];
+	/** Incremented when configuration cache expires. */
+	struct m0_atomic64      fsf_conf_gen;
+	/** Value of ->fsf_conf_gen ->fsf_flt_cache was built at. */
+	int64_t                 fsf_flt_gen;
+	struct m0_clink         fsf_conf_exp;
 	struct m0_rpc_conn_pool fsf_conn_pool;
 	struct m0_tl            fsf_pending_fops;
 	/** Mutex to protect list of pending fops. */
@@ -26,6 +26,7 @@
 #include "fdmi/filter_xc.h"
 #include "fdmi/flt_eval.h"
 #include "lib/finject.h"
+#include "lib/ub.h"
 #include "xcode/xcode.h"
 #include "ut/ut.h"
 #include "conf/obj.h"           /* m0_conf_fdmi_filter */
@@ -390,6 +391,214 @@ static void flt_str_ops(void)
 	m0_fdmi_filter_fini(&flt);
 }
 
+/* ------------------------------------------------------------------
+ * Helpers: records with two uint variables, "type" and "size".
+ * ------------------------------------------------------------------ */
+
+struct flt_ut_rec {
+	uint64_t fur_type;
+	uint64_t fur_size;
+};
+
+static char flt_ut_type[] = "type";
+static char flt_ut_size[] = "size";
+
+static int flt_ut_var_get(void                        *user_data,
+			  struct m0_fdmi_flt_var_node *value_desc,
+			  struct m0_fdmi_flt_operand  *value)
+{
+	struct flt_ut_rec *rec = user_data;
+	struct m0_buf      type = M0_BUF_INITS(flt_ut_type);
+	struct m0_buf      size = M0_BUF_INITS(flt_ut_size);
+
+	if (m0_buf_eq(&value_desc->ffvn_data, &type))
+		m0_fdmi_flt_uint_opnd_fill(value, rec->fur_type);
+	else if (m0_buf_eq(&value_desc->ffvn_data, &size))
+		m0_fdmi_flt_uint_opnd_fill(value, rec->fur_size);
+	else
+		return -ENOENT;
+	return 0;
+}
+
+static struct m0_fdmi_flt_node *flt_ut_var(char *name)
+{
+	struct m0_buf var = M0_BUF_INITS(name);
+
+	return m0_fdmi_flt_var_node_create(&var);
+}
+
+/** type == t && size > sz */
+static struct m0_fdmi_flt_node *flt_ut_guarded(uint64_t t, uint64_t sz)
+{
+	return m0_fdmi_flt_op_node_create(
+		M0_FFO_AND,
+		m0_fdmi_flt_op_node_create(M0_FFO_EQUAL,
+					   flt_ut_var(flt_ut_type),
+					   m0_fdmi_flt_uint_node_create(t)),
+		m0_fdmi_flt_op_node_create(M0_FFO_GT,
+					   flt_ut_var(flt_ut_size),
+					   m0_fdmi_flt_uint_node_create(sz)));
+}
+
+/** size > sz || false */
+static struct m0_fdmi_flt_node *flt_ut_unguarded(uint64_t sz)
+{
+	return m0_fdmi_flt_op_node_create(
+		M0_FFO_OR,
+		m0_fdmi_flt_op_node_create(M0_FFO_GT,
+					   flt_ut_var(flt_ut_size),
+					   m0_fdmi_flt_uint_node_create(sz)),
+		m0_fdmi_flt_bool_node_create(false));
+}
+
+static void flt_ut_conf_init(struct m0_conf_fdmi_filter *flt,
+			     struct m0_fdmi_flt_node    *root)
+{
+	M0_SET0(flt);
+	flt->ff_type = M0_FDMI_FILTER_TYPE_TREE;
+	m0_fdmi_filter_init(&flt->ff_filter);
+	m0_fdmi_filter_root_set(&flt->ff_filter, root);
+}
+
+/* ------------------------------------------------------------------
+ * Test Case: compiled filters give the same results as the tree.
+ * ------------------------------------------------------------------ */
+
+static void flt_eval_compiled(void)
+{
+	struct m0_fdmi_eval_ctx       eval_ctx;
+	struct flt_ut_rec             rec;
+	struct m0_fdmi_eval_var_info  var_info = {
+		.user_data    = &rec,
+		.get_value_cb = flt_ut_var_get
+	};
+	struct m0_conf_fdmi_filter    flt[3];
+	struct m0_fdmi_flt_prog       prog;
+	struct m0_fdmi_flt_node      *root;
+	int                           rc;
+	int                           i;
+	int                           j;
+
+	m0_fdmi_eval_init(&eval_ctx);
+	flt_ut_conf_init(&flt[0], flt_ut_guarded(3, 100));
+	flt_ut_conf_init(&flt[1], flt_ut_unguarded(10));
+	flt_ut_conf_init(&flt[2], m0_fdmi_flt_op_node_create(
+				 M0_FFO_EQUAL, flt_ut_var(flt_ut_type),
+				 m0_fdmi_flt_int_node_create(3)));
+	for (i = 0; i < ARRAY_SIZE(flt); ++i) {
+		rc = m0_fdmi_flt_prog_compile(&prog, &flt[i].ff_filter);
+		M0_UT_ASSERT(rc == 0);
+		for (j = 0; j < 32; ++j) {
+			rec = (struct flt_ut_rec) { .fur_type = j % 5,
+						    .fur_size = j * 10 };
+			M0_UT_ASSERT(m0_fdmi_flt_prog_eval(&eval_ctx, &prog,
+							   &var_info) ==
+				     m0_fdmi_eval_flt(&eval_ctx, &flt[i],
+						      &var_info));
+		}
+		/* Program doesn't depend on the tree. */
+		m0_fdmi_filter_fini(&flt[i].ff_filter);
+		rec = (struct flt_ut_rec) { .fur_type = 3, .fur_size = 1000 };
+		rc = m0_fdmi_flt_prog_eval(&eval_ctx, &prog, &var_info);
+		M0_UT_ASSERT(rc == (i == 2 ? -EINVAL : 1));
+		m0_fdmi_flt_prog_fini(&prog);
+	}
+
+	/* Left-nested tree needs constant stack. */
+	root = m0_fdmi_flt_bool_node_create(true);
+	for (i = 0; i < 2 * FDMI_FLT_PROG_STACK_MAX; ++i)
+		root = m0_fdmi_flt_op_node_create(
+			M0_FFO_OR, root, m0_fdmi_flt_bool_node_create(false));
+	flt_ut_conf_init(&flt[0], root);
+	rc = m0_fdmi_flt_prog_compile(&prog, &flt[0].ff_filter);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_fdmi_flt_prog_eval(&eval_ctx, &prog, NULL) == 1);
+	m0_fdmi_flt_prog_fini(&prog);
+	m0_fdmi_filter_fini(&flt[0].ff_filter);
+
+	/* Right-nested tree is too deep. */
+	root = m0_fdmi_flt_bool_node_create(true);
+	for (i = 0; i < FDMI_FLT_PROG_STACK_MAX; ++i)
+		root = m0_fdmi_flt_op_node_create(
+			M0_FFO_OR, m0_fdmi_flt_bool_node_create(false), root);
+	flt_ut_conf_init(&flt[0], root);
+	rc = m0_fdmi_flt_prog_compile(&prog, &flt[0].ff_filter);
+	M0_UT_ASSERT(rc == -E2BIG);
+	m0_fdmi_filter_fini(&flt[0].ff_filter);
+
+	m0_fdmi_eval_fini(&eval_ctx);
+}
+
+/* ------------------------------------------------------------------
+ * Test Case: filter set visits only filters which can match.
+ * ------------------------------------------------------------------ */
+
+enum { FLT_UT_SET_NR = 200 };
+
+static void flt_ut_matched(struct m0_conf_fdmi_filter *flt, void *datum)
+{
+	struct m0_conf_fdmi_filter *base = datum;
+
+	M0_UT_ASSERT(flt >= base && flt < base + FLT_UT_SET_NR);
+	flt->ff_filter_id.f_key++;
+}
+
+static void flt_eval_set(void)
+{
+	struct m0_fdmi_eval_ctx       eval_ctx;
+	struct flt_ut_rec             rec;
+	struct m0_fdmi_eval_var_info  var_info = {
+		.user_data    = &rec,
+		.get_value_cb = flt_ut_var_get
+	};
+	struct m0_conf_fdmi_filter   *flt;
+	struct m0_fdmi_flt_set        set;
+	uint64_t                      visited;
+	int                           rc;
+	int                           i;
+
+	M0_ALLOC_ARR(flt, FLT_UT_SET_NR);
+	M0_UT_ASSERT(flt != NULL);
+	m0_fdmi_eval_init(&eval_ctx);
+	rc = m0_fdmi_flt_set_init(&set);
+	M0_UT_ASSERT(rc == 0);
+	/* Filter i is guarded by type == i / 2, last one is not guarded. */
+	for (i = 0; i < FLT_UT_SET_NR; ++i) {
+		flt_ut_conf_init(&flt[i], i == FLT_UT_SET_NR - 1 ?
+				 flt_ut_unguarded(50) :
+				 flt_ut_guarded(i / 2, i));
+		rc = m0_fdmi_flt_set_add(&set, &flt[i], &m0_fdmi_eval_flt);
+		M0_UT_ASSERT(rc == 0);
+		m0_fdmi_filter_fini(&flt[i].ff_filter);
+	}
+	M0_UT_ASSERT(set.fs_nr == FLT_UT_SET_NR);
+	M0_UT_ASSERT(set.fs_indexed_nr == FLT_UT_SET_NR - 1);
+
+	/* type 7 guards filters 14 and 15, size 15 matches only 14. */
+	rec = (struct flt_ut_rec) { .fur_type = 7, .fur_size = 15 };
+	visited = set.fs_visited;
+	rc = m0_fdmi_flt_set_match(&set, &eval_ctx, &var_info,
+				   flt_ut_matched, flt);
+	M0_UT_ASSERT(rc == 1);
+	M0_UT_ASSERT(set.fs_visited - visited == 3);
+	M0_UT_ASSERT(flt[14].ff_filter_id.f_key == 1);
+	M0_UT_ASSERT(m0_forall(j, FLT_UT_SET_NR,
+			       j == 14 || flt[j].ff_filter_id.f_key == 0));
+
+	/* Unknown type: only the unguarded filter is visited. */
+	rec = (struct flt_ut_rec) { .fur_type = 1000, .fur_size = 100 };
+	visited = set.fs_visited;
+	rc = m0_fdmi_flt_set_match(&set, &eval_ctx, &var_info,
+				   flt_ut_matched, flt);
+	M0_UT_ASSERT(rc == 1);
+	M0_UT_ASSERT(set.fs_visited - visited == 1);
+	M0_UT_ASSERT(flt[FLT_UT_SET_NR - 1].ff_filter_id.f_key == 1);
+
+	m0_fdmi_flt_set_fini(&set);
+	m0_fdmi_eval_fini(&eval_ctx);
+	m0_free(flt);
+}
+
 /* ------------------------------------------------------------------
  * Test Sute definition
  * ------------------------------------------------------------------ */
@@ -400,6 +609,8 @@ struct m0_ut_suite fdmi_filter_eval_ut = {
 		{ "simple-or",        flt_eval_simple_or },
 		{ "simple-gt",        flt_eval_simple_gt },
 		{ "callback",         flt_set_op_cb },
+		{ "compiled",         flt_eval_compiled },
+		{ "filter-set",       flt_eval_set },
 		/** @todo Move to filter tests */
 		{ "filter-xcode-str", flt_eval_flt_xcode_str },
 		{ "filter-str-ops",   flt_str_ops },
@@ -407,6 +618,102 @@ struct m0_ut_suite fdmi_filter_eval_ut = {
 	},
 };
 
+/* ------------------------------------------------------------------
+ * Benchmark: tree evaluation of every filter vs. indexed filter set.
+ * ------------------------------------------------------------------ */
+
+enum {
+	FLT_UB_FILTERS_NR = 512,
+	FLT_UB_ITER       = 10000,
+	FLT_UB_TYPES_NR   = 128
+};
+
+static struct m0_conf_fdmi_filter *ub_flt;
+static struct m0_fdmi_flt_set      ub_set;
+static struct m0_fdmi_eval_ctx     ub_eval_ctx;
+static struct flt_ut_rec           ub_rec;
+static struct m0_fdmi_eval_var_info ub_var_info = {
+	.user_data    = &ub_rec,
+	.get_value_cb = flt_ut_var_get
+};
+static uint64_t                    ub_matched;
+
+static void ub_flt_matched(struct m0_conf_fdmi_filter *flt, void *datum)
+{
+	++ub_matched;
+}
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	int rc = 0;
+	int i;
+
+	M0_ALLOC_ARR(ub_flt, FLT_UB_FILTERS_NR);
+	M0_UB_ASSERT(ub_flt != NULL);
+	m0_fdmi_eval_init(&ub_eval_ctx);
+	rc = m0_fdmi_flt_set_init(&ub_set);
+	/* Every 16th filter is not guarded. */
+	for (i = 0; i < FLT_UB_FILTERS_NR && rc == 0; ++i) {
+		flt_ut_conf_init(&ub_flt[i], i % 16 == 0 ?
+				 flt_ut_unguarded(i) :
+				 flt_ut_guarded(i % FLT_UB_TYPES_NR, i));
+		rc = m0_fdmi_flt_set_add(&ub_set, &ub_flt[i],
+					 &m0_fdmi_eval_flt);
+	}
+	return rc;
+}
+
+static void ub_fini(void)
+{
+	int i;
+
+	for (i = 0; i < FLT_UB_FILTERS_NR; ++i)
+		m0_fdmi_filter_fini(&ub_flt[i].ff_filter);
+	m0_fdmi_flt_set_fini(&ub_set);
+	m0_fdmi_eval_fini(&ub_eval_ctx);
+	m0_free(ub_flt);
+}
+
+static void ub_rec_set(int i)
+{
+	ub_rec = (struct flt_ut_rec) { .fur_type = i % FLT_UB_TYPES_NR,
+				       .fur_size = i % (FLT_UB_FILTERS_NR * 2) };
+}
+
+static void ub_tree(int i)
+{
+	int j;
+
+	ub_rec_set(i);
+	for (j = 0; j < FLT_UB_FILTERS_NR; ++j) {
+		if (m0_fdmi_eval_flt(&ub_eval_ctx, &ub_flt[j],
+				     &ub_var_info) > 0)
+			++ub_matched;
+	}
+}
+
+static void ub_indexed(int i)
+{
+	ub_rec_set(i);
+	m0_fdmi_flt_set_match(&ub_set, &ub_eval_ctx, &ub_var_info,
+			      ub_flt_matched, NULL);
+}
+
+struct m0_ub_set m0_fdmi_filter_eval_ub = {
+	.us_name = "fdmi-filter-eval-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "tree",
+		  .ub_iter  = FLT_UB_ITER,
+		  .ub_round = ub_tree },
+		{ .ub_name  = "indexed",
+		  .ub_iter  = FLT_UB_ITER,
+		  .ub_round = ub_indexed },
+		{ .ub_name = NULL }
+	}
+};
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
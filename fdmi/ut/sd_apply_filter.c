@@ -123,8 +123,7 @@ static int test_fs_node_eval(
 {
 	M0_UT_ASSERT(src_rec == &g_src_rec);
 	M0_UT_ASSERT(src_rec->fsr_data == &g_fdmi_data);
-	M0_UT_ASSERT(value_desc->ffvn_data.b_nob == strlen(g_var_str));
-	M0_UT_ASSERT(value_desc->ffvn_data.b_addr == g_var_str);
+	M0_UT_ASSERT(m0_buf_streq(&value_desc->ffvn_data, g_var_str));
 
 	m0_fdmi_flt_bool_opnd_fill(value, false);
 	return 0;
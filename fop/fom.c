@@ -35,6 +35,7 @@
 #include "lib/uuid.h"                 /* m0_node_uuid */
 #include "lib/semaphore.h"            /* m0_semaphore */
 #include "lib/finject.h"              /* M0_FI_ENABLED */
+#include "lib/lockprof.h"             /* m0_lockprof_chore_init */
 #include "addb2/net.h"
 #include "addb2/addb2.h"
 #include "addb2/storage.h"
@@ -1257,6 +1258,7 @@ M0_INTERNAL int m0_fom_domain_init(struct m0_fom_domain **out)
 				       NULL,
 				       M0_MKTIME(HUNG_FOP_SEC_PERIOD, 0),
 				       0);
+				result = m0_lockprof_chore_init();
 			}
 		} else
 			result = M0_ERR(-ENOMEM);
@@ -1275,6 +1277,7 @@ M0_INTERNAL void m0_fom_domain_fini(struct m0_fom_domain *dom)
 {
 	int i;
 
+	m0_lockprof_chore_fini();
 	m0_locality_chore_fini(&dom->fd_hung_foms_chore);
 	if (dom->fd_localities != NULL) {
 		for (i = dom->fd_localities_nr - 1; i >= 0; --i) {
@@ -439,6 +439,7 @@ static int ha_level_enter(struct m0_module *module)
 			.hlc_rpc_machine  = ha->h_cfg.hcf_rpc_machine,
 			.hlq_q_cfg_in     = {},
 			.hlq_q_cfg_out    = {},
+			.hlc_nvec_coalesce = ha->h_cfg.hcf_nvec_coalesce,
 		};
 		rc = ha_link_ctx_init(ha, ha->h_link_ctx, &hl_cfg, NULL,
 				      &M0_FID0, HLX_OUTGOING);
@@ -748,6 +749,7 @@ ha_link_incoming_create(struct m0_ha                       *ha,
 		.hlc_rpc_machine  = ha->h_cfg.hcf_rpc_machine,
 		.hlq_q_cfg_in     = {},
 		.hlq_q_cfg_out    = {},
+		.hlc_nvec_coalesce = ha->h_cfg.hcf_nvec_coalesce,
 	};
 	M0_ALLOC_PTR(hlx);
 	M0_ASSERT(hlx != NULL); /* XXX */
@@ -277,6 +277,8 @@ struct m0_ha_cfg {
 	const char                         *hcf_addr;
 	/** Fid of local process. */
 	struct m0_fid                       hcf_process_fid;
+	/** @see m0_ha_link_cfg::hlc_nvec_coalesce */
+	bool                                hcf_nvec_coalesce;
 
 	/* m0_ha is resposible for the next fields */
 
@@ -698,6 +698,8 @@ static int halon_interface_level_enter(struct m0_module *module)
 			.hcf_addr        = hii->hii_cfg.hic_local_rpc_endpoint,
 			.hcf_reqh        = &hii->hii_reqh,
 			.hcf_process_fid = hii->hii_cfg.hic_process_fid,
+			/* see @ref halon-interface-tag */
+			.hcf_nvec_coalesce = true,
 		};
 		hii->hii_cfg.hic_dispatcher_cfg = (struct m0_ha_dispatcher_cfg){
 			.hdc_enable_note      = true,
@@ -65,6 +65,13 @@
  * called. Exactly one of this functions is called exactly once for each message
  * sent.
  *
+ * M0_HA_NVEC_SET messages sent over the same m0_ha_link one after another are
+ * coalesced into one message while they wait in the outgoing queue, so that a
+ * mass failure reaches the process in a few messages instead of one message
+ * per failed object. m0_halon_interface_send() returns the same tag for all
+ * the coalesced messages, and msg_is_delivered_cb() or
+ * msg_is_not_delivered_cb() is called once for this tag.
+ *
  * msg_is_delivered_cb() means that the message has been successfully delivered
  * to the destination and it is not going to be resent if the destination
  * restarts. msg_is_not_delivered_cb() is called if the message can't be
@@ -76,7 +83,9 @@
  * Each message has a tag. The tag has uint64_t type and it's assigned
  * internally when user tries to send a message (m0_halon_interface_send(),
  * for example).  Tag value is unique for all the messages sent or received
- * over a single m0_ha_link. No other assumption about tag value should be used.
+ * over a single m0_ha_link, except for the coalesced M0_HA_NVEC_SET messages
+ * (see above), which share the tag. No other assumption about tag value should
+ * be used.
  *
  * Tag is used for message identification when struct m0_ha_msg is not available.
  *
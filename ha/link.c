@@ -75,6 +75,7 @@
 #include "lib/types.h"          /* m0_uint128 */
 #include "lib/misc.h"           /* container_of */
 #include "lib/time.h"           /* m0_time_from_now */
+#include "lib/finject.h"        /* M0_FI_ENABLED */
 
 #include "sm/sm.h"              /* m0_sm_state_descr */
 #include "rpc/rpc.h"            /* m0_rpc_reply_post */
@@ -261,6 +262,7 @@ M0_INTERNAL int m0_ha_link_init(struct m0_ha_link     *hl,
 	hl->hln_fom_enable_wakeup = true;
 	hl->hln_no_new_delivered = false;
 	hl->hln_req_fop_seq = 0;
+	hl->hln_q_out_coalesce_tag = M0_HA_MSG_TAG_INVALID;
 	hl->hln_backoff_rc = 0;
 	hl->hln_backoff_nr = 0;
 	return M0_RC(0);
@@ -401,6 +403,7 @@ M0_INTERNAL void m0_ha_link_start(struct m0_ha_link          *hl,
 	lp = &hl->hln_conn_cfg.hlcc_params;
 	m0_ha_lq_tags_set(&hl->hln_q_out, &lp->hlp_tags_local);
 	m0_ha_lq_tags_set(&hl->hln_q_in,  &lp->hlp_tags_remote);
+	hl->hln_q_out_coalesce_tag = M0_HA_MSG_TAG_INVALID;
 	hl->hln_cb_disconnecting = false;
 	hl->hln_cb_reused        = false;
 	m0_mutex_unlock(&hl->hln_lock);
@@ -553,13 +556,71 @@ enum ha_link_send_type {
 	HA_LINK_SEND_REPLY,
 };
 
+static bool ha_link_msg_is_coalescible(const struct m0_ha_link *hl,
+				       const struct m0_ha_msg  *msg)
+{
+	return hl->hln_cfg.hlc_nvec_coalesce &&
+	       msg->hm_data.hed_type == M0_HA_MSG_NVEC &&
+	       msg->hm_data.u.hed_nvec.hmnv_type == M0_HA_NVEC_SET &&
+	       msg->hm_data.u.hed_nvec.hmnv_id_of_get == 0 &&
+	       m0_ha_msg_tag(msg) == M0_HA_MSG_TAG_UNKNOWN;
+}
+
+/**
+ * Appends the notes of msg to the last message of hln_q_out if the outgoing
+ * fom hasn't taken it yet. Notes are not deduplicated: the receiver has to
+ * see every intermediate state, pool machine transitions depend on them.
+ */
+static bool ha_link_q_out_coalesce(struct m0_ha_link      *hl,
+                                   const struct m0_ha_msg *msg,
+                                   uint64_t               *tag)
+{
+	const struct m0_ha_msg_nvec *src = &msg->hm_data.u.hed_nvec;
+	struct m0_ha_msg_nvec       *dst;
+	struct m0_ha_msg            *last;
+
+	M0_PRE(m0_mutex_is_locked(&hl->hln_lock));
+
+	if (hl->hln_q_out_coalesce_tag == M0_HA_MSG_TAG_INVALID ||
+	    !ha_link_msg_is_coalescible(hl, msg))
+		return false;
+	last = m0_ha_lq_msg(&hl->hln_q_out, hl->hln_q_out_coalesce_tag);
+	M0_ASSERT(last != NULL);
+	dst = &last->hm_data.u.hed_nvec;
+	if (dst->hmnv_ignore_same_state != src->hmnv_ignore_same_state ||
+	    dst->hmnv_nr + src->hmnv_nr > ARRAY_SIZE(dst->hmnv_arr.hmna_arr) ||
+	    last->hm_epoch != msg->hm_epoch ||
+	    !m0_fid_eq(&last->hm_fid, &msg->hm_fid) ||
+	    !m0_fid_eq(&last->hm_source_process, &msg->hm_source_process) ||
+	    !m0_fid_eq(&last->hm_source_service, &msg->hm_source_service))
+		return false;
+	memcpy(&dst->hmnv_arr.hmna_arr[dst->hmnv_nr], src->hmnv_arr.hmna_arr,
+	       src->hmnv_nr * sizeof src->hmnv_arr.hmna_arr[0]);
+	dst->hmnv_nr += src->hmnv_nr;
+	*tag = hl->hln_q_out_coalesce_tag;
+	return true;
+}
+
+/** m0_ha_lq_next() for hln_q_out. The message taken can't be coalesced. */
+static struct m0_ha_msg *ha_link_q_out_next(struct m0_ha_link *hl)
+{
+	M0_PRE(m0_mutex_is_locked(&hl->hln_lock));
+	hl->hln_q_out_coalesce_tag = M0_HA_MSG_TAG_INVALID;
+	return m0_ha_lq_next(&hl->hln_q_out);
+}
+
 M0_INTERNAL void m0_ha_link_send(struct m0_ha_link      *hl,
                                  const struct m0_ha_msg *msg,
                                  uint64_t               *tag)
 {
 	M0_ENTRY("hl=%p msg=%p", hl, msg);
 	m0_mutex_lock(&hl->hln_lock);
-	*tag = m0_ha_lq_enqueue(&hl->hln_q_out, msg);
+	if (!ha_link_q_out_coalesce(hl, msg, tag)) {
+		*tag = m0_ha_lq_enqueue(&hl->hln_q_out, msg);
+		hl->hln_q_out_coalesce_tag =
+			ha_link_msg_is_coalescible(hl, msg) ?
+			*tag : M0_HA_MSG_TAG_INVALID;
+	}
 	m0_mutex_unlock(&hl->hln_lock);
 	ha_link_outgoing_fom_wakeup(hl);
 	M0_LEAVE("hl=%p msg=%p tag=%"PRIu64, hl, msg, *tag);
@@ -823,7 +884,7 @@ static void ha_link_tags_update(struct m0_ha_link *hl,
 	M0_LOG(M0_DEBUG, "hl=%p  in="HLTAGS_F, hl, HLTAGS_P(&tags_in));
 
 	while (m0_ha_lq_tag_next(&hl->hln_q_out) < in_delivered)
-		(void)m0_ha_lq_next(&hl->hln_q_out);
+		(void)ha_link_q_out_next(hl);
 
 	delivered = m0_ha_lq_tag_delivered(&hl->hln_q_out);
 	while (delivered < in_delivered) {
@@ -1403,7 +1464,7 @@ static int ha_link_outgoing_fom_tick(struct m0_fom *fom)
 			m0_mutex_lock(&hl->hln_lock);
 			hl->hln_fom_enable_wakeup = false;
 			hl->hln_no_new_delivered = true;
-			while (m0_ha_lq_next(&hl->hln_q_out) != NULL)
+			while (ha_link_q_out_next(hl) != NULL)
 				;
 			while (m0_ha_lq_tag_delivered(&hl->hln_q_out) <
 			       m0_ha_lq_tag_next(&hl->hln_q_out)) {
@@ -1581,7 +1642,8 @@ static int ha_link_outgoing_fom_tick(struct m0_fom *fom)
 			return M0_RC(M0_FSO_AGAIN);
 		}
 		m0_mutex_lock(&hl->hln_lock);
-		hl->hln_msg_to_send = m0_ha_lq_next(&hl->hln_q_out);
+		hl->hln_msg_to_send = M0_FI_ENABLED("q_out_hold") ? NULL :
+				      ha_link_q_out_next(hl);
 		hl->hln_confirmed_update = ha_link_q_in_confirm_all(hl);
 		m0_mutex_unlock(&hl->hln_lock);
 		if (hl->hln_msg_to_send != NULL || hl->hln_confirmed_update) {
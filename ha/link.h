@@ -181,6 +181,13 @@ struct m0_ha_link_cfg {
 	struct m0_rpc_machine  *hlc_rpc_machine;
 	struct m0_ha_lq_cfg     hlq_q_cfg_in;
 	struct m0_ha_lq_cfg     hlq_q_cfg_out;
+	/**
+	 * Allows m0_ha_link_send() to append the notes of an M0_HA_NVEC_SET
+	 * message to the previous one, if the latter is still waiting in the
+	 * outgoing queue. All the coalesced messages get the same tag, so it
+	 * should only be enabled if the users don't track individual tags.
+	 */
+	bool                    hlc_nvec_coalesce;
 };
 
 struct m0_ha_link {
@@ -215,6 +222,12 @@ struct m0_ha_link {
 	bool                        hln_waking_up;
 	struct m0_sm_ast            hln_waking_ast;
 	struct m0_ha_msg           *hln_msg_to_send;
+	/**
+	 * Tag of the message in hln_q_out which the following M0_HA_NVEC_SET
+	 * messages may be coalesced with, or M0_HA_MSG_TAG_INVALID.
+	 * See m0_ha_link_cfg::hlc_nvec_coalesce. Protected by hln_lock.
+	 */
+	uint64_t                    hln_q_out_coalesce_tag;
 	/** It's protected by outgoing fom sm group lock */
 	bool                        hln_confirmed_update;
 	struct m0_fop               hln_outgoing_fop;
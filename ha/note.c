@@ -167,6 +167,7 @@ static void ha_state_accept(struct m0_confc         *confc,
 
 	cache = &confc->cc_cache;
 	m0_conf_cache_lock(cache);
+	m0_conf_cache_ha_batch_begin(cache);
 	for (i = 0; i < note->nv_nr; ++i) {
 		obj = m0_conf_cache_lookup(cache, &note->nv_note[i].no_id);
 		M0_LOG(M0_DEBUG, "nv_note[%d]=(no_id="FID_F" no_state=%"PRIu32
@@ -182,6 +183,7 @@ static void ha_state_accept(struct m0_confc         *confc,
 				m0_chan_broadcast(&obj->co_ha_chan);
 		}
 	}
+	m0_conf_cache_ha_batch_end(cache);
 	m0_conf_cache_unlock(cache);
 	M0_LEAVE();
 }
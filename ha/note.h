@@ -367,7 +367,10 @@ M0_INTERNAL void m0_ha_state_single_post(struct m0_ha_nvec     *nvec);
  *         m0_conf_fid_type(&note->nv_note[i].no_id) == &M0_CONF_POOL_TYPE))
  *
  * Actual cache update is done by ha_state_accept() called on per-client basis
- * in the course of iterating global HA context client list.
+ * in the course of iterating global HA context client list. The whole note is
+ * applied to a confc cache as a single HA batch (see
+ * m0_conf_cache_ha_batch_begin()), so that subscribers can do once per note
+ * the work they would otherwise repeat for every object.
  *
  * See m0_ha_msg_nvec::hmnv_ignore_same_state for ignore_same_state flag
  * description.
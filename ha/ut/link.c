@@ -42,6 +42,7 @@
 #include "ut/threads.h"         /* M0_UT_THREADS_DEFINE */
 #include "ha/ut/helper.h"       /* m0_ha_ut_rpc_ctx */
 #include "ha/link_service.h"    /* m0_ha_link_service_init */
+#include "lib/finject.h"        /* m0_fi_enable */
 
 struct ha_ut_link_ctx {
 	struct m0_ha_link          ulc_link;
@@ -211,6 +212,155 @@ void m0_ha_ut_link_usecase(void)
 	m0_free(rpc_ctx);
 };
 
+enum {
+	HA_UT_LINK_COALESCE_NR  = M0_HA_STATE_UPDATE_LIMIT + 0x10,
+	/* Each object goes through 2 states, see ha_ut_link_set_nvec_msg(). */
+	HA_UT_LINK_COALESCE_OBJ = HA_UT_LINK_COALESCE_NR / 2,
+};
+
+/*
+ * i-th note of a mass failure: all the objects become M0_NC_TRANSIENT, then
+ * all of them become M0_NC_FAILED.
+ */
+static void ha_ut_link_set_nvec_msg(struct m0_ha_msg *msg, uint64_t i)
+{
+	*msg = (struct m0_ha_msg){
+		.hm_data = {
+			.hed_type   = M0_HA_MSG_NVEC,
+			.u.hed_nvec = {
+				.hmnv_type = M0_HA_NVEC_SET,
+				.hmnv_nr   = 1,
+			},
+		},
+	};
+	msg->hm_data.u.hed_nvec.hmnv_arr.hmna_arr[0] = (struct m0_ha_note){
+		.no_id    = M0_FID_INIT(0x1000, i % HA_UT_LINK_COALESCE_OBJ),
+		.no_state = i < HA_UT_LINK_COALESCE_OBJ ?
+			    M0_NC_TRANSIENT : M0_NC_FAILED,
+	};
+}
+
+/*
+ * Mass failure: HA_UT_LINK_COALESCE_NR single-note messages are sent while
+ * the outgoing fom is held, so that all of them are coalesced. The receiver
+ * applies the notes to its copy of the object states the way
+ * m0_ha_state_accept() does. It has to converge to the final state of every
+ * object after as few messages as possible, going through every intermediate
+ * state in order.
+ */
+void m0_ha_ut_link_nvec_coalesce(void)
+{
+	struct m0_ha_ut_rpc_ctx *rpc_ctx;
+	struct m0_reqh_service  *hl_service;
+	struct ha_ut_link_ctx   *ctx1;
+	struct ha_ut_link_ctx   *ctx2;
+	struct m0_ha_link       *hl1;
+	struct m0_ha_link       *hl2;
+	struct m0_uint128        id1 = M0_UINT128(0, 0);
+	struct m0_uint128        id2 = M0_UINT128(0, 1);
+	struct m0_uint128        id  = M0_UINT128(1, 3);
+	struct m0_ha_msg_nvec   *nvec;
+	struct m0_ha_msg        *msg;
+	struct m0_ha_msg        *msg_recv;
+	struct m0_ha_note       *note;
+	uint32_t                *state;
+	uint64_t                 obj;
+	uint64_t                 tag;
+	uint64_t                 tag_first;
+	uint64_t                 tag_recv;
+	uint64_t                 nr_msgs = 0;
+	uint64_t                 nr_notes = 0;
+	uint64_t                 i;
+	int                      rc;
+
+	M0_ALLOC_PTR(rpc_ctx);
+	M0_UT_ASSERT(rpc_ctx != NULL);
+	m0_ha_ut_rpc_ctx_init(rpc_ctx);
+	rc = m0_ha_link_service_init(&hl_service, &rpc_ctx->hurc_reqh);
+	M0_UT_ASSERT(rc == 0);
+	M0_ALLOC_PTR(ctx1);
+	M0_UT_ASSERT(ctx1 != NULL);
+	ha_ut_link_init(ctx1, rpc_ctx, hl_service, &id1, &id2, &id, true,
+			false);
+	ctx1->ulc_link.hln_cfg.hlc_nvec_coalesce = true;
+	m0_ha_link_start(&ctx1->ulc_link, &ctx1->ulc_conn_cfg);
+	M0_ALLOC_PTR(ctx2);
+	M0_UT_ASSERT(ctx2 != NULL);
+	ha_ut_link_init(ctx2, rpc_ctx, hl_service, &id2, &id1, &id, false,
+			true);
+	hl1 = &ctx1->ulc_link;
+	hl2 = &ctx2->ulc_link;
+	M0_ALLOC_PTR(msg);
+	M0_UT_ASSERT(msg != NULL);
+	M0_ALLOC_ARR(state, HA_UT_LINK_COALESCE_OBJ);
+	M0_UT_ASSERT(state != NULL);
+	for (i = 0; i < HA_UT_LINK_COALESCE_OBJ; ++i)
+		state[i] = M0_NC_ONLINE;
+
+	m0_fi_enable("ha_link_outgoing_fom_tick", "q_out_hold");
+	for (i = 0; i < HA_UT_LINK_COALESCE_NR; ++i) {
+		ha_ut_link_set_nvec_msg(msg, i);
+		m0_ha_link_send(hl1, msg, &tag);
+		if (i == 0)
+			tag_first = tag;
+		M0_UT_ASSERT(tag == (i < M0_HA_STATE_UPDATE_LIMIT ?
+				     tag_first : tag_first + 2));
+	}
+	m0_fi_disable("ha_link_outgoing_fom_tick", "q_out_hold");
+	/* Not coalescible, wakes the outgoing fom up. */
+	ha_ut_link_set_some_msg(msg);
+	m0_ha_link_send(hl1, msg, &tag);
+	M0_UT_ASSERT(tag == tag_first + 4);
+
+	while (nr_notes < HA_UT_LINK_COALESCE_NR) {
+		m0_ha_link_wait_arrival(hl2);
+		msg_recv = m0_ha_link_recv(hl2, &tag_recv);
+		M0_UT_ASSERT(msg_recv != NULL);
+		M0_UT_ASSERT(msg_recv->hm_data.hed_type == M0_HA_MSG_NVEC);
+		nvec = &msg_recv->hm_data.u.hed_nvec;
+		M0_UT_ASSERT(nr_notes + nvec->hmnv_nr <=
+			     HA_UT_LINK_COALESCE_NR);
+		for (i = 0; i < nvec->hmnv_nr; ++i) {
+			note = &nvec->hmnv_arr.hmna_arr[i];
+			obj = note->no_id.f_key;
+			M0_UT_ASSERT(note->no_id.f_container == 0x1000);
+			M0_UT_ASSERT(obj == (nr_notes + i) %
+				     HA_UT_LINK_COALESCE_OBJ);
+			/* ONLINE -> TRANSIENT -> FAILED, nothing skipped. */
+			M0_UT_ASSERT(state[obj] ==
+				     (note->no_state == M0_NC_TRANSIENT ?
+				      M0_NC_ONLINE : M0_NC_TRANSIENT));
+			state[obj] = note->no_state;
+		}
+		nr_notes += nvec->hmnv_nr;
+		++nr_msgs;
+		m0_ha_link_delivered(hl2, msg_recv);
+	}
+	M0_UT_ASSERT(nr_notes == HA_UT_LINK_COALESCE_NR);
+	M0_UT_ASSERT(nr_msgs == 2);
+	/* Converged: every object is in its final state. */
+	M0_UT_ASSERT(m0_forall(j, HA_UT_LINK_COALESCE_OBJ,
+			       state[j] == M0_NC_FAILED));
+	m0_ha_link_wait_arrival(hl2);
+	msg_recv = m0_ha_link_recv(hl2, &tag_recv);
+	M0_UT_ASSERT(msg_recv != NULL);
+	M0_UT_ASSERT(m0_ha_msg_eq(msg_recv, msg));
+	m0_ha_link_delivered(hl2, msg_recv);
+	m0_ha_link_wait_delivery(hl1, tag);
+	m0_free(state);
+	m0_free(msg);
+	m0_ha_link_flush(hl1);
+	m0_ha_link_flush(hl2);
+
+	ha_ut_link_fini(ctx2);
+	m0_free(ctx2);
+	ha_ut_link_fini(ctx1);
+	m0_free(ctx1);
+	m0_ha_link_service_fini(hl_service);
+	m0_ha_ut_rpc_ctx_fini(rpc_ctx);
+	m0_free(rpc_ctx);
+}
+
 enum {
 	HA_UT_THREAD_PAIR_NR = 0x10,
 	HA_UT_MSG_PER_THREAD = 0x20,
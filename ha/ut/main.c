@@ -40,6 +40,7 @@ extern void m0_ha_ut_link_usecase(void);
 extern void m0_ha_ut_link_multithreaded(void);
 extern void m0_ha_ut_link_reconnect_simple(void);
 extern void m0_ha_ut_link_reconnect_multiple(void);
+extern void m0_ha_ut_link_nvec_coalesce(void);
 
 extern void m0_ha_ut_entrypoint_usecase(void);
 extern void m0_ha_ut_entrypoint_client(void);
@@ -59,6 +60,7 @@ struct m0_ut_suite ha_ut = {
 		{ "link-multithreaded",     &m0_ha_ut_link_multithreaded      },
 		{ "link-reconnect_simple",  &m0_ha_ut_link_reconnect_simple   },
 		{ "link-reconnect_multiple",&m0_ha_ut_link_reconnect_multiple },
+		{ "link-nvec_coalesce",     &m0_ha_ut_link_nvec_coalesce      },
 		{ "entrypoint-usecase",     &m0_ha_ut_entrypoint_usecase      },
 		{ "entrypoint-client",      &m0_ha_ut_entrypoint_client       },
 		{ "ha-usecase",             &m0_ha_ut_ha_usecase              },
@@ -236,6 +236,10 @@ static void usage()
 	printf("    multi_release <fid> <offset> <len> <max_tier> "
 			"[options: keep_latest]\n");
 	printf("    set_write_tier <fid> <tier>\n\n");
+	printf("  options:\n");
+	printf("    -d, --depth <n>  blocks in flight when copying data "
+			"between tiers (default %d)\n\n",
+			HSM_COPY_DEPTH_DEFAULT);
 	printf("  <fid> parameter format is [hi:]lo. "
 	                  "(hi == 0 if not specified.)\n");
 	printf("  The numbers are read in decimal, hexadecimal "
@@ -343,8 +347,9 @@ static int parse_release_subopt(char *opts, enum hsm_rls_flags *flags)
 static const struct option option_tab[] = {
 	{"quiet", no_argument, NULL, 'q'},
 	{"verbose", required_argument, NULL, 'v'},
+	{"depth", required_argument, NULL, 'd'},
 };
-#define SHORT_OPT "qv"
+#define SHORT_OPT "qvd:"
 
 static int parse_cmd_options(int argc, char **argv)
 {
@@ -361,6 +366,14 @@ static int parse_cmd_options(int argc, char **argv)
 			if (hsm_options.trace_level < LOG_DEBUG)
 				hsm_options.trace_level++;
 			break;
+		case 'd':
+			hsm_options.copy_depth = atoi(optarg);
+			if (hsm_options.copy_depth <= 0) {
+				fprintf(stderr, "Invalid copy depth: %s\n",
+					optarg);
+				return -EINVAL;
+			}
+			break;
 		case ':':
 		case '?':
 		default:
@@ -370,6 +383,20 @@ static int parse_cmd_options(int argc, char **argv)
 	return 0;
 }
 
+/** report the throughput of the data copied by the last command */
+static void copy_report(void)
+{
+	struct m0hsm_copy_stats stats;
+
+	m0hsm_copy_stats_get(&stats, true);
+	if (stats.bytes == 0 || hsm_options.trace_level < LOG_INFO)
+		return;
+	fprintf(stderr, "%" PRIu64 " bytes copied in %.3f s (%.1f MB/s)\n",
+		stats.bytes, (double)stats.time_ns / M0_TIME_ONE_SECOND,
+		stats.time_ns == 0 ? 0.0 :
+		(double)stats.bytes * M0_TIME_ONE_SECOND / stats.time_ns / 1e6);
+}
+
 /* test functions hidden in m0hsm_api */
 int m0hsm_test_write(struct m0_uint128 id, off_t offset, size_t len, int seed);
 int m0hsm_test_read(struct m0_uint128 id, off_t offset, size_t len);
@@ -499,6 +526,7 @@ static int run_cmd(int argc, char **argv)
 			flags |= HSM_MOVE;
 
 		rc = m0hsm_copy(id, src_tier, tgt_tier, offset, len, flags);
+		copy_report();
 
 	} else if (m0_streq(action, "stage")) {
 		off_t offset;
@@ -526,6 +554,7 @@ static int run_cmd(int argc, char **argv)
 				 return -1;
 
 		rc = m0hsm_stage(id, tgt_tier, offset, len, flags);
+		copy_report();
 
 	} else if (m0_streq(action, "archive")) {
 		off_t offset;
@@ -553,6 +582,7 @@ static int run_cmd(int argc, char **argv)
 				 return -1;
 
 		rc = m0hsm_archive(id, tgt_tier, offset, len, flags);
+		copy_report();
 
 	} else if (m0_streq(action, "release") ||
 		   m0_streq(action, "multi_release")) {
@@ -38,6 +38,8 @@
 #include <stdarg.h>
 
 #include "lib/trace.h"
+#include "lib/mutex.h"
+#include "lib/semaphore.h"
 #include "conf/obj.h"
 #include "fid/fid.h"
 #include "motr/idx.h"
@@ -57,6 +59,7 @@ struct m0hsm_options options = {
 	.trace_level = LOG_INFO,
 	.op_timeout = 10,
 	.log_stream = NULL, /* default will be set by m0hsm_init() */
+	.copy_depth = HSM_COPY_DEPTH_DEFAULT,
 };
 
 static struct m0_client *m0_instance;
@@ -1858,6 +1861,8 @@ uint64_t get_optimal_bs(struct m0_obj *obj, uint64_t obj_sz)
 	gsz = usz * pa->pa_N;
 	/* max 2-times pool-width deep, otherwise we may get -E2BIG */
 	max_bs = usz * 2 * pa->pa_P * pa->pa_N / (pa->pa_N + pa->pa_K + pa->pa_S);
+	/* whole parity groups only, to avoid read-modify-write on writes */
+	max_bs = max64u(max_bs / gsz, 1) * gsz;
 
 	VERB("usz=%lu pool="FID_F" (N,K,S,P)=(%u,%u,%u,%u) max_bs=%" PRId64 "\n", usz,
 	     FID_P(&pver->pv_pool->po_id), pa->pa_N, pa->pa_K, pa->pa_S, pa->pa_P, max_bs);
@@ -1867,7 +1872,7 @@ uint64_t get_optimal_bs(struct m0_obj *obj, uint64_t obj_sz)
 	else if (obj_sz <= gsz)
 		return gsz;
 	else
-		return roundup_power2(obj_sz);
+		return m0_round_up(min64u(roundup_power2(obj_sz), max_bs), gsz);
 }
 
 /**
@@ -2106,18 +2111,175 @@ int m0hsm_test_read(struct m0_uint128 id, off_t offset, size_t len)
 	RETURN(rc);
 }
 
-/** copy an extent from one (flat) object to another */
+/** Completion tracking of a tier-to-tier copy. */
+struct copy_ctx {
+	/** protects copy_slot::cs_complete */
+	struct m0_mutex		 cc_lock;
+	/** upped once per completed operation */
+	struct m0_semaphore	 cc_done;
+};
+
+/** One in-flight block of a tier-to-tier copy. */
+struct copy_slot {
+	/** I/O vectors, with the data buffer allocated once for the copy */
+	struct io_ctx		 cs_io;
+	/** pending read or write operation, NULL if none */
+	struct m0_op		*cs_op;
+	/** index of the block held by the slot */
+	uint64_t		 cs_block;
+	/** true if cs_op is the write of the block */
+	bool			 cs_write;
+	/** cs_op is complete but the slot is not retired yet */
+	bool			 cs_complete;
+	struct copy_ctx		*cs_ctx;
+};
+
+/** Data copy statistics, accumulated until reset */
+static struct m0hsm_copy_stats copy_stats;
+
+void m0hsm_copy_stats_get(struct m0hsm_copy_stats *stats, bool reset)
+{
+	*stats = copy_stats;
+	if (reset)
+		M0_SET0(&copy_stats);
+}
+
+static int copy_slots_alloc(struct copy_slot *slots, int nr, size_t bsize)
+{
+	int i;
+	int rc = 0;
+
+	for (i = 0; i < nr && rc == 0; i++)
+		rc = m0_bufvec_alloc_aligned(&slots[i].cs_io.data, 1, bsize,
+					     m0_pageshift_get()) ?:
+		     m0_bufvec_alloc(&slots[i].cs_io.attr, 1, 1) ?:
+		     m0_indexvec_alloc(&slots[i].cs_io.ext, 1);
+	return rc;
+}
+
+static void copy_slots_free(struct copy_slot *slots, int nr, size_t bsize)
+{
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		M0_ASSERT(slots[i].cs_op == NULL);
+		/* the last block may have been shorter */
+		if (slots[i].cs_io.data.ov_vec.v_count != NULL)
+			slots[i].cs_io.data.ov_vec.v_count[0] = bsize;
+		m0_bufvec_free_aligned(&slots[i].cs_io.data,
+				       m0_pageshift_get());
+		m0_bufvec_free(&slots[i].cs_io.attr);
+		m0_indexvec_free(&slots[i].cs_io.ext);
+	}
+}
+
+/** marks the slot complete and wakes up copy_slot_completed() */
+static void copy_op_cb(struct m0_op *op)
+{
+	struct copy_slot *slot = op->op_datum;
+	struct copy_ctx  *cc = slot->cs_ctx;
+
+	m0_mutex_lock(&cc->cc_lock);
+	slot->cs_complete = true;
+	m0_mutex_unlock(&cc->cc_lock);
+	m0_semaphore_up(&cc->cc_done);
+}
+
+static const struct m0_op_ops copy_op_ops = {
+	.oop_failed = copy_op_cb,
+	.oop_stable = copy_op_cb,
+};
+
+/** launch a read or write of the block mapped in the slot, don't wait */
+static int copy_op_launch(struct m0_obj *obj, enum m0_obj_opcode opcode,
+			  struct copy_slot *slot)
+{
+	int rc;
+
+	rc = m0_obj_op(obj, opcode, &slot->cs_io.ext, &slot->cs_io.data,
+		       &slot->cs_io.attr, 0, 0, &slot->cs_op);
+	if (rc != 0) {
+		slot->cs_op = NULL;
+		return rc;
+	}
+	slot->cs_write = opcode == M0_OC_WRITE;
+	slot->cs_op->op_datum = slot;
+	m0_op_setup(slot->cs_op, &copy_op_ops, 0);
+	m0_op_launch(&slot->cs_op, 1);
+	return 0;
+}
+
+/**
+ * Wait until an operation completes and return its slot. If several
+ * operations are complete, the one of the oldest block is returned.
+ */
+static struct copy_slot *copy_slot_completed(struct copy_ctx *cc,
+					     struct copy_slot *slots, int nr)
+{
+	struct copy_slot *oldest = NULL;
+	int               i;
+
+	m0_semaphore_down(&cc->cc_done);
+	m0_mutex_lock(&cc->cc_lock);
+	for (i = 0; i < nr; i++) {
+		if (slots[i].cs_complete &&
+		    (oldest == NULL || slots[i].cs_block < oldest->cs_block))
+			oldest = &slots[i];
+	}
+	M0_ASSERT(oldest != NULL);
+	oldest->cs_complete = false;
+	m0_mutex_unlock(&cc->cc_lock);
+	return oldest;
+}
+
+/** wait for the pending operation of the slot (if any) and release it */
+static int copy_op_wait(struct copy_slot *slot)
+{
+	int rc;
+
+	if (slot->cs_op == NULL)
+		return 0;
+	rc = m0_op_wait(slot->cs_op, M0_BITS(M0_OS_FAILED, M0_OS_STABLE),
+			M0_TIME_NEVER) ?: m0_rc(slot->cs_op);
+	m0_op_fini(slot->cs_op);
+	m0_op_free(slot->cs_op);
+	slot->cs_op = NULL;
+	return rc;
+}
+
+/**
+ * Copy an extent from one (flat) object to another.
+ *
+ * The extent is split in parity-group aligned blocks (see get_optimal_bs())
+ * which are copied through options.copy_depth slots: the reads of the next
+ * blocks are in flight while the previous blocks are written. Slot buffers
+ * are allocated once and reused for all the blocks.
+ *
+ * The loop is driven by completions: whichever operation completes first
+ * is handled first (the oldest block if several are complete). A completed
+ * read is turned into the write of the block, a completed write frees its
+ * slot for the read of the next block.
+ */
 static int copy_extent_data(struct m0_uint128 src_id,
 			    struct m0_uint128 tgt_id,
 		            const struct extent *range)
 {
 	struct m0_obj src_obj = {};
 	struct m0_obj tgt_obj = {};
+	struct copy_slot *slots = NULL;
+	struct copy_slot *slot;
+	struct copy_ctx cc;
 	size_t block_size;
-	struct io_ctx ctx = {};
-	size_t rest = range->len;
-	off_t start = range->off;
+	uint64_t nr_blocks;
+	uint64_t next_read = 0;  /* next block to be read */
+	uint64_t inflight = 0;   /* launched operations not retired yet */
+	uint64_t depth;
+	uint64_t i;
+	m0_time_t start_time;
+	m0_time_t elapsed = 0;
+	size_t len;
 	int rc;
+	int rc2;
 	ENTRY;
 
 	m0_obj_init(&src_obj, m0_uber_realm, &src_id,
@@ -2133,49 +2295,92 @@ static int copy_extent_data(struct m0_uint128 src_id,
 	if (rc)
 		goto out_close_src;
 
-	block_size = get_optimal_bs(&tgt_obj, rest);
+	block_size = get_optimal_bs(&tgt_obj, range->len);
 	if (block_size == 0) {
 		ERROR("Could not get the optimal block size for the object\n");
 		rc = -EINVAL;
 		goto fini;
 	}
+	nr_blocks = (range->len + block_size - 1) / block_size;
+	/* keep the total size of in-flight buffers bounded */
+	depth = options.copy_depth > 0 ? options.copy_depth :
+					 HSM_COPY_DEPTH_DEFAULT;
+	depth = min3(depth, nr_blocks, max64u(MAX_M0_BUFSZ / block_size, 1));
 
-	VERB("Using I/O block size of %zu bytes\n", block_size);
+	VERB("Using I/O block size of %zu bytes, %" PRIu64 " blocks in flight\n",
+	     block_size, depth);
 
-	for (; rest > 0; rest -= block_size, start += block_size) {
-		if (rest < block_size)
-			/* non full block */
-			block_size = rest;
-
-		rc = prepare_io_ctx(&ctx, 1, block_size, true);
-		if (rc) {
-			ERROR("prepare_io_ctx() failed: rc=%d\n", rc);
-			goto fini;
-		}
+	M0_ALLOC_ARR(slots, depth);
+	if (slots == NULL) {
+		rc = -ENOMEM;
+		goto fini;
+	}
+	rc = copy_slots_alloc(slots, depth, block_size);
+	if (rc) {
+		ERROR("copy_slots_alloc() failed: rc=%d\n", rc);
+		goto free;
+	}
 
-		rc = map_io_ctx(&ctx, 1, block_size, start, NULL);
-		if (rc) {
-			ERROR("map_io_ctx() failed: rc=%d\n", rc);
-			break;
+	m0_mutex_init(&cc.cc_lock);
+	m0_semaphore_init(&cc.cc_done, 0);
+	for (i = 0; i < depth; i++)
+		slots[i].cs_ctx = &cc;
+
+	start_time = m0_time_now();
+	for (;;) {
+		/* fill free slots with reads */
+		for (i = 0; rc == 0 && i < depth && next_read < nr_blocks; i++) {
+			slot = &slots[i];
+			if (slot->cs_op != NULL)
+				continue;
+			len = min64u(block_size,
+				     range->len - next_read * block_size);
+			slot->cs_block = next_read;
+			slot->cs_io.ext.iv_index[0] = range->off +
+						      next_read * block_size;
+			slot->cs_io.ext.iv_vec.v_count[0] = len;
+			slot->cs_io.data.ov_vec.v_count[0] = len;
+			slot->cs_io.attr.ov_vec.v_count[0] = 0;
+			VERB("Copy block: offset=%#" PRIx64 ", length=%#zx\n",
+			     slot->cs_io.ext.iv_index[0], len);
+			rc = copy_op_launch(&src_obj, M0_OC_READ, slot);
+			if (rc) {
+				ERROR("read launch failed: rc=%d\n", rc);
+				break;
+			}
+			next_read++;
+			inflight++;
 		}
-
-		/* read blocks */
-		rc = read_blocks(&src_obj, &ctx);
-		if (rc) {
-			ERROR("read_blocks() failed: rc=%d\n", rc);
+		if (inflight == 0)
 			break;
-		}
 
-		/* now write data to the target object */
-		rc = write_blocks(&tgt_obj, &ctx);
-		if (rc) {
-			ERROR("write_blocks() failed: rc=%d\n", rc);
-			break;
+		slot = copy_slot_completed(&cc, slots, depth);
+		inflight--;
+		rc2 = copy_op_wait(slot);
+		if (rc2)
+			ERROR("block %s failed: rc=%d\n",
+			      slot->cs_write ? "write" : "read", rc2);
+		rc = rc ?: rc2;
+		if (!slot->cs_write && rc == 0) {
+			/* the read is complete: write the block out */
+			rc = copy_op_launch(&tgt_obj, M0_OC_WRITE, slot);
+			if (rc == 0)
+				inflight++;
+			else
+				ERROR("write launch failed: rc=%d\n", rc);
 		}
 	}
+	elapsed = m0_time_sub(m0_time_now(), start_time);
+	m0_semaphore_fini(&cc.cc_done);
+	m0_mutex_fini(&cc.cc_lock);
 
-	/* Free bufvec's and indexvec's */
-	free_io_ctx(&ctx, true);
+	if (rc == 0) {
+		copy_stats.bytes += range->len;
+		copy_stats.time_ns += elapsed;
+	}
+ free:
+	copy_slots_free(slots, depth, block_size);
+	m0_free(slots);
  fini:
 	m0_entity_fini(&tgt_obj.ob_entity);
  out_close_src:
@@ -2184,9 +2389,10 @@ static int copy_extent_data(struct m0_uint128 src_id,
 	if (rc == 0)
 		INFO("%zu bytes successfully copied from subobj "
 		     "<%#" PRIx64 ":%#" PRIx64 "> to <%#" PRIx64 ":%#" PRIx64 ">"
-	             " at offset %#" PRIx64 "\n", range->len,
+	             " at offset %#" PRIx64 " (%.1f MB/s)\n", range->len,
 		     src_id.u_hi, src_id.u_lo, tgt_id.u_hi, tgt_id.u_lo,
-		     range->off);
+		     range->off, elapsed == 0 ? 0.0 :
+		     (double)range->len * M0_TIME_ONE_SECOND / elapsed / 1e6);
 
 	RETURN(rc);
 }
@@ -56,8 +56,15 @@ struct m0hsm_options {
 	FILE		  *log_stream;
 	/** rc-file with config params */
 	FILE		  *rcfile;
+	/**
+	 * number of blocks in flight when copying data between tiers
+	 * (default HSM_COPY_DEPTH_DEFAULT, 0 also selects the default)
+	 */
+	int		   copy_depth;
 };
 
+enum {HSM_COPY_DEPTH_DEFAULT = 4};
+
 /** Max Object Store I/O buffer size */
 enum {MAX_M0_BUFSZ = 128*1024*1024};
 
@@ -142,6 +149,21 @@ int m0hsm_copy(struct m0_uint128 obj_id, uint8_t src_tier_idx,
 	      uint8_t tgt_tier_idx, off_t offset, size_t length,
 	      enum hsm_cp_flags flags);
 
+/** Data copy statistics */
+struct m0hsm_copy_stats {
+	/** bytes copied between tiers */
+	uint64_t bytes;
+	/** time spent copying them, in nanoseconds */
+	uint64_t time_ns;
+};
+
+/**
+ * Get statistics of the data copied by m0hsm_copy(), m0hsm_stage() and
+ * m0hsm_archive() since m0hsm_init() or the last reset.
+ * @param reset  Reset the statistics after getting them.
+ */
+void m0hsm_copy_stats_get(struct m0hsm_copy_stats *stats, bool reset);
+
 /** release options */
 enum hsm_rls_flags {
 	HSM_KEEP_LATEST = (1 << 0), /**< Release all data versions in the given
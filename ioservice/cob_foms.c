@@ -74,8 +74,8 @@ static void cob_stob_create_credit(struct m0_fom *fom);
 static int cob_stob_delete_credit(struct m0_fom *fom);
 static struct m0_cob_domain *cdom_get(const struct m0_fom *fom);
 static int cob_ops_stob_find(struct m0_fom_cob_op *co);
-static int cob_bytecount_decrement(struct m0_cob *cob, struct m0_cob_bckey *key,
-				   uint64_t bytecount, struct m0_be_tx *tx);
+static int cob_bytecount_decrement(struct m0_fom *fom, struct m0_cob *cob,
+				   struct m0_cob_bckey *key, uint64_t bytecount);
 
 enum {
 	CC_COB_VERSION_INIT	= 0,
@@ -535,7 +535,7 @@ static int cob_stob_delete_credit(struct m0_fom *fom)
 	fop_type = cob_op->fco_fop_type;
 	if (cob_is_md(cob_op)) {
 		cob_op_credit(fom, M0_COB_OP_DELETE, tx_cred);
-		cob_op_credit(fom, M0_COB_OP_BYTECOUNT_UPDATE, tx_cred);
+		cob_op_credit(fom, M0_COB_OP_BYTECOUNT_ADD, tx_cred);
 		if (cob_op->fco_recreate)
 			cob_op_credit(fom, M0_COB_OP_CREATE, tx_cred);
 		cob_op->fco_is_done = true;
@@ -1152,7 +1152,7 @@ static int cd_cob_delete(struct m0_fom            *fom,
 
 	key.cbk_pfid = pver; 
 	key.cbk_user_id = M0_BYTECOUNT_USER_ID;
-	rc = cob_bytecount_decrement(cob, &key, byte_count, m0_fom_tx(fom));
+	rc = cob_bytecount_decrement(fom, cob, &key, byte_count);
 	if (rc != 0)
 		M0_ERR_INFO(rc, "Bytecount decrement unsuccesfull");
 
@@ -1246,8 +1246,8 @@ static int ce_stob_edit(struct m0_fom *fom, struct m0_fom_cob_op *cd,
 	return M0_RC(rc);
 }
 
-static int cob_bytecount_decrement(struct m0_cob *cob, struct m0_cob_bckey *key,
-				   uint64_t bytecount, struct m0_be_tx *tx)
+static int cob_bytecount_decrement(struct m0_fom *fom, struct m0_cob *cob,
+				   struct m0_cob_bckey *key, uint64_t bytecount)
 {
 	int                 rc;
 	struct m0_cob_bcrec rec = {};
@@ -1262,15 +1262,12 @@ static int cob_bytecount_decrement(struct m0_cob *cob, struct m0_cob_bckey *key,
 
 	rc = m0_cob_bc_lookup(cob, key, &rec);
 	if (rc == 0) {
-		if (rec.cbr_bytecount < bytecount)
-			rec.cbr_bytecount = 0;
-		else
-			rec.cbr_bytecount -= bytecount;
-		rc = m0_cob_bc_update(cob, key, &rec, tx);
+		rc = m0_cob_bc_add(cob, key, -(int64_t)bytecount,
+				   fom->fo_loc->fl_idx, m0_fom_tx(fom));
 		if (rc != 0)
 			return M0_ERR(rc);
 		M0_LOG(M0_DEBUG, "Bytecount reduced by %" PRIu64
-				 " to %" PRIu64 , bytecount, rec.cbr_bytecount);
+				 " from %" PRIu64 , bytecount, rec.cbr_bytecount);
 	} else
 		M0_ERR(rc);
 
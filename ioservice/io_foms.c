@@ -612,8 +612,6 @@ static int zero_copy_initiate(struct m0_fom *);
 static int zero_copy_finish(struct m0_fom *);
 static int net_buffer_release(struct m0_fom *);
 static int nbuf_release_done(struct m0_fom *fom, int still_required);
-static int cob_bytecount_increment(struct m0_cob *cob, struct m0_cob_bckey *key,
-				   uint64_t bytecount, struct m0_be_tx *tx);
 
 static void io_fom_addb2_descr(struct m0_fom *fom);
 
@@ -1023,6 +1021,11 @@ static int io_fom_cob2file(struct m0_fom *fom, struct m0_fid *fid,
  * request. This function copies segment from network buffer with size
  * same as ivec_count.
  *
+ * No data is copied: stob I/O is done directly from (to) the network buffer
+ * memory the bulk transfer lands in, so every segment must be aligned to
+ * the stob block size. Segments adjacent in memory are merged, so that the
+ * stob sees as few and as large buffers as possible.
+ *
  * @param fom file operation machine instance.
  * @param obuf pointer to bufvec from stobio object.
  * @param ibuf pointer to bufve from network buffer from buffer pool.
@@ -1042,13 +1045,19 @@ static int align_bufvec(struct m0_fom    *fom,
 	int         rc;
 	int         i;
 	m0_bcount_t blk;
-	bool        all4k = true;
+	m0_bcount_t total = ivec_count;
 
 	M0_PRE(fom != NULL);
 	M0_PRE(obuf != NULL);
 	M0_PRE(ibuf != NULL);
 
 	for (i = 0, blk = 0; i < ibuf->ov_vec.v_nr; ++i) {
+		if (!m0_is_aligned(ibuf->ov_vec.v_count[i], 1ULL << bshift) ||
+		    !m0_addr_is_aligned(ibuf->ov_buf[i], bshift))
+			return M0_ERR_INFO(-EPROTO, "Unaligned segment %d: "
+					   "%p/%" PRIu64 " bshift=%" PRIu32,
+					   i, ibuf->ov_buf[i],
+					   ibuf->ov_vec.v_count[i], bshift);
 		blk += ibuf->ov_vec.v_count[i] >> bshift;
 		if (blk >= ivec_count)
 			break;
@@ -1063,7 +1072,6 @@ static int align_bufvec(struct m0_fom    *fom,
 	/* Align bufvec before copying to bufvec from stob io */
 	for (i = 0; i < obuf->ov_vec.v_nr; ++i) {
 		blk = min64u(ibuf->ov_vec.v_count[i] >> bshift, ivec_count);
-		all4k &= ibuf->ov_vec.v_count[i] == 4096;
 		obuf->ov_vec.v_count[i] = blk;
 		obuf->ov_buf[i]         = m0_stob_addr_pack(ibuf->ov_buf[i],
 							    bshift);
@@ -1073,17 +1081,15 @@ static int align_bufvec(struct m0_fom    *fom,
 	}
 
 	/*
-	 * Performance: Compaction special case for block size of 1M (256 * 4k).
-	 * Leads to significant pressure reduction on BE layer by means of
-	 * BE allocations minimisation.
+	 * Performance: net buffer pool allocates segments of a buffer
+	 * contiguously (m0_bufvec_alloc_aligned_packed()), so the whole buffer
+	 * usually collapses into a single segment, whatever the number and the
+	 * size of segments are. This reduces the number of iocbs of linux stob
+	 * and the number of BE allocations of AD stob.
 	 */
-	if (all4k && obuf->ov_vec.v_nr == 256) {
+	if (obuf->ov_vec.v_nr > 1)
 		m0_bufvec_pack(obuf);
-
-		/* one block of 1M */
-		M0_ASSERT(obuf->ov_vec.v_nr == 1);
-		M0_ASSERT(obuf->ov_vec.v_count[0] == ((1 << 20) >> bshift));
-	}
+	M0_POST(m0_vec_count(&obuf->ov_vec) == total);
 
 	return 0;
 }
@@ -1362,8 +1368,8 @@ static int net_buffer_acquire(struct m0_fom *fom)
 	while (acquired_net_bufs < required_net_bufs) {
 	    struct m0_net_buffer *nb;
 
-	    m0_net_buffer_pool_lock(pool);
-	    nb = m0_net_buffer_pool_get(pool, colour);
+	    nb = m0_net_buffer_pool_cache_get(pool, fom->fo_loc->fl_idx,
+					      colour);
 
 	    if (nb == NULL && acquired_net_bufs == 0) {
 		    struct m0_rios_buffer_pool *bpdesc;
@@ -1372,8 +1378,15 @@ static int net_buffer_acquire(struct m0_fom *fom)
 		     * Network buffer is not available. At least one
 		     * buffer is need for zero-copy. Registers FOM clink
 		     * with buffer pool wait channel to get buffer
-		     * pool non-empty signal.
+		     * pool non-empty signal. A buffer could have been
+		     * returned since the cache gave up, re-check under
+		     * the pool lock.
 		     */
+		    m0_net_buffer_pool_lock(pool);
+		    if (pool->nbp_free > 0) {
+			    m0_net_buffer_pool_unlock(pool);
+			    continue;
+		    }
 		    bpdesc = container_of(pool, struct m0_rios_buffer_pool,
 					  rios_bp);
 		    m0_fom_wait_on(fom, &bpdesc->rios_bp_wait, &fom->fo_cb);
@@ -1382,7 +1395,6 @@ static int net_buffer_acquire(struct m0_fom *fom)
 		    M0_LEAVE();
 		    return M0_FSO_WAIT;
 	    } else if (nb == NULL) {
-		    m0_net_buffer_pool_unlock(pool);
 		    /*
 		     * Some network buffers are available for zero copy
 		     * init. FOM can continue with available buffers.
@@ -1390,10 +1402,16 @@ static int net_buffer_acquire(struct m0_fom *fom)
 		    break;
 	    }
 	    acquired_net_bufs++;
-	    /* Signal next possible waiter for buffers. */
-	    if (acquired_net_bufs == required_net_bufs && pool->nbp_free > 0)
-			pool->nbp_ops->nbpo_not_empty(pool);
-	    m0_net_buffer_pool_unlock(pool);
+	    /*
+	     * Signal next possible waiter for buffers. Waiters only exist
+	     * while the cache is short of buffers.
+	     */
+	    if (acquired_net_bufs == required_net_bufs && pool->nbp_mag_short) {
+		    m0_net_buffer_pool_lock(pool);
+		    if (pool->nbp_free > 0)
+			    pool->nbp_ops->nbpo_not_empty(pool);
+		    m0_net_buffer_pool_unlock(pool);
+	    }
 
 	    if (m0_is_read_fop(fop))
 		   nb->nb_qtype = M0_NET_QT_ACTIVE_BULK_SEND;
@@ -1476,18 +1494,17 @@ static int nbuf_release_done(struct m0_fom *fom, int still_required)
 					   &fom_obj->fcrw_netbuf_list));
 	acquired = netbufs_tlist_length(&fom_obj->fcrw_netbuf_list);
 
-	m0_net_buffer_pool_lock(fom_obj->fcrw_bp);
 	while (acquired > still_required) {
 		struct m0_net_buffer *nb;
 
 		nb = netbufs_tlist_tail(&fom_obj->fcrw_netbuf_list);
 		M0_ASSERT(nb != NULL);
-		m0_net_buffer_pool_put(fom_obj->fcrw_bp, nb, colour);
 		netbufs_tlink_del_fini(nb);
+		m0_net_buffer_pool_cache_put(fom_obj->fcrw_bp,
+					     fom->fo_loc->fl_idx, nb, colour);
 		--acquired;
 		++released;
 	}
-	m0_net_buffer_pool_unlock(fom_obj->fcrw_bp);
 
 	fom_obj->fcrw_batch_size = acquired;
 	M0_LOG(M0_DEBUG, "Released %d network buffer(s), batch_size = %d.",
@@ -2306,6 +2323,8 @@ static int m0_io_fom_cob_rw_tick(struct m0_fom *fom)
 			accum = m0_fom_tx_credit(fom);
 			stob_be_credit(fom);
 			m0_cob_tx_credit(fom_cdom(fom), M0_COB_OP_UPDATE, accum);
+			m0_cob_tx_credit(fom_cdom(fom), M0_COB_OP_BYTECOUNT_ADD,
+					 accum);
 			if (fom_obj->fcrw_flags & M0_IO_FLAG_CROW) {
 				struct m0_stob_id stob_id;
 				m0_fid_convert_cob2stob(&rwfop->crw_fid,
@@ -2317,10 +2336,6 @@ static int m0_io_fom_cob_rw_tick(struct m0_fom *fom)
 						 M0_COB_OP_UPDATE, accum);
 				m0_cob_tx_credit(fom_cdom(fom),
 						 M0_COB_OP_DELETE, accum);
-				m0_cob_tx_credit(fom_cdom(fom),
-						 M0_COB_OP_BYTECOUNT_SET, accum);
-				m0_cob_tx_credit(fom_cdom(fom),
-						 M0_COB_OP_BYTECOUNT_UPDATE, accum);
 			}
 		} else if (phase == M0_FOPH_AUTHORISATION) {
 			rc = m0_fom_tick_generic(fom);
@@ -2378,8 +2393,11 @@ static int m0_io_fom_cob_rw_tick(struct m0_fom *fom)
 		bc_rc = fom_cob_locate(fom);
 		if (bc_rc == 0) {
 			cob = fom_obj->fcrw_cob;
-			cob_bytecount_increment(cob, &key, byte_count,
-						m0_fom_tx(fom));
+			bc_rc = m0_cob_bc_add(cob, &key, byte_count,
+					      fom->fo_loc->fl_idx,
+					      m0_fom_tx(fom));
+			if (bc_rc != 0)
+				M0_ERR_INFO(bc_rc, "Failed to update bytecount");
 			/**
 			 * XXX: Overlapping cob extentds are not accounted for
 			 * during cob overwrite. IF a cob is overwritten,
@@ -2475,12 +2493,12 @@ static void m0_io_fom_cob_rw_fini(struct m0_fom *fom)
 	if (fom_obj->fcrw_bp != NULL) {
 		M0_INVARIANT_EX(m0_tlist_invariant(&netbufs_tl,
 						   &fom_obj->fcrw_netbuf_list));
-		m0_net_buffer_pool_lock(fom_obj->fcrw_bp);
 		m0_tl_for (netbufs, &fom_obj->fcrw_netbuf_list, nb) {
-			m0_net_buffer_pool_put(fom_obj->fcrw_bp, nb, colour);
 			netbufs_tlink_del_fini(nb);
+			m0_net_buffer_pool_cache_put(fom_obj->fcrw_bp,
+						     fom->fo_loc->fl_idx,
+						     nb, colour);
 		} m0_tl_endfor;
-		m0_net_buffer_pool_unlock(fom_obj->fcrw_bp);
 		netbufs_tlist_fini(&fom_obj->fcrw_netbuf_list);
 	}
 
@@ -2547,40 +2565,6 @@ static void io_fom_addb2_descr(struct m0_fom *fom)
 		     m0_net_tm_colour_get(m0_fop_tm_get(fop)));
 }
 
-static int cob_bytecount_increment(struct m0_cob *cob, struct m0_cob_bckey *key,
-				   uint64_t bytecount, struct m0_be_tx *tx)
-{
-	int                 rc;
-	struct m0_rwlock   *cdom_lock = &cob->co_dom->cd_lock.bl_u.rwlock;
-	struct m0_cob_bcrec rec = {};
-
-	M0_ENTRY("KEY: "FID_F"/%" PRIu64, FID_P(&key->cbk_pfid), key->cbk_user_id);
-
-	m0_rwlock_write_lock(cdom_lock);
-	rc = m0_cob_bc_lookup(cob, key, &rec);
-	if (rc == -ENOENT) {
-		rec.cbr_bytecount = bytecount;
-		rec.cbr_cob_objects = 1;
-		rc = m0_cob_bc_insert(cob, key, &rec, tx);
-		m0_rwlock_write_unlock(cdom_lock);
-		if (rc != 0)
-			return M0_ERR(rc);
-		M0_LOG(M0_DEBUG, "Bytecount inserted %" PRIu64, bytecount);
-	} else if (rc == 0) {
-		rec.cbr_bytecount += bytecount;
-		rc = m0_cob_bc_update(cob, key, &rec, tx);
-		m0_rwlock_write_unlock(cdom_lock);
-		if (rc != 0)
-			return M0_ERR(rc);
-		M0_LOG(M0_DEBUG, "Bytecount increased by %" PRIu64
-				 " to %" PRIu64, bytecount,
-				 rec.cbr_bytecount);
-	} else
-		M0_ERR(rc);
-
-	return M0_RC(rc);		
-}
-
 #undef M0_TRACE_SUBSYSTEM
 
 /** @} end of io_foms */
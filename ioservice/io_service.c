@@ -264,8 +264,16 @@ M0_INTERNAL int m0_ios_create_buffer_pool(struct m0_reqh_service *service)
 		nbuffs = m0_net_buffer_pool_provision(&newbp->rios_bp,
 						      ios_net_buffer_pool_size);
 		m0_net_buffer_pool_unlock(&newbp->rios_bp);
-		if (nbuffs < ios_net_buffer_pool_size) {
-			rc = -ENOMEM;
+		/*
+		 * I/O foms get and put buffers through per-locality
+		 * magazines, see net_buffer_acquire().
+		 */
+		if (nbuffs == ios_net_buffer_pool_size)
+			rc = m0_net_buffer_pool_cache_init(&newbp->rios_bp,
+						m0_reqh_nr_localities(reqh),
+						M0_NET_BUFFER_POOL_MAG_SIZE);
+		if (nbuffs < ios_net_buffer_pool_size || rc != 0) {
+			rc = rc ?: -ENOMEM;
 			m0_chan_fini_lock(&newbp->rios_bp_wait);
 			m0_net_buffer_pool_fini(&newbp->rios_bp);
 			m0_free(newbp);
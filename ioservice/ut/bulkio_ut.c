@@ -262,14 +262,18 @@ static struct m0_net_buffer_pool *buf_pool;
 static int                        next_write_test = TEST00;
 static int                        next_read_test  = TEST00;
 
+/*
+ * I/O foms get buffers through the per-locality cache of the pool, so the
+ * magazines have to be emptied too: m0_net_buffer_pool_cache_get() returns
+ * NULL only when neither the pool nor any magazine has a buffer left.
+ */
 static void empty_buffers_pool(uint32_t colour)
 {
 	nb_nr--;
-	m0_net_buffer_pool_lock(buf_pool);
 	do {
-		nb_list[++nb_nr] = m0_net_buffer_pool_get(buf_pool, colour);
+		nb_list[++nb_nr] = m0_net_buffer_pool_cache_get(buf_pool, 0,
+								colour);
 	} while (nb_list[nb_nr] != NULL);
-	m0_net_buffer_pool_unlock(buf_pool);
 }
 
 static void release_one_buffer(uint32_t colour)
@@ -1757,6 +1761,122 @@ static void bulkio_server_read_write_multiple_nb(void)
 	m0_reqh_idle_wait(reqh);
 }
 
+enum {
+	ALIGN_UT_SHIFT = 12,
+	ALIGN_UT_BLOCK = 1 << ALIGN_UT_SHIFT,
+	ALIGN_UT_SEG   = 4 * ALIGN_UT_BLOCK,
+};
+
+/*
+ * Aligns a network buffer of 8 16K segments, i.e. a layout other than
+ * 256 4K segments of the usual pool buffer.
+ */
+static void bulkio_server_align_bufvec_packed(void)
+{
+	struct m0_fom    fom = {};
+	struct m0_bufvec ibuf;
+	struct m0_bufvec obuf;
+	int              rc;
+
+	rc = m0_bufvec_alloc_aligned_packed(&ibuf, 8, ALIGN_UT_SEG,
+					    ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == 0);
+
+	/* The whole buffer becomes a single stob segment. */
+	rc = align_bufvec(&fom, &obuf, &ibuf, 32, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(obuf.ov_vec.v_nr == 1);
+	M0_UT_ASSERT(obuf.ov_vec.v_count[0] == 32);
+	M0_UT_ASSERT(m0_stob_addr_open(obuf.ov_buf[0], ALIGN_UT_SHIFT) ==
+		     ibuf.ov_buf[0]);
+	m0_bufvec_free2(&obuf);
+
+	/* The I/O ends in the middle of the 5th segment. */
+	rc = align_bufvec(&fom, &obuf, &ibuf, 18, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(obuf.ov_vec.v_nr == 1);
+	M0_UT_ASSERT(obuf.ov_vec.v_count[0] == 18);
+	m0_bufvec_free2(&obuf);
+
+	/* The buffer is too small for the I/O. */
+	rc = align_bufvec(&fom, &obuf, &ibuf, 33, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == -EPROTO);
+
+	m0_bufvec_free_aligned_packed(&ibuf, ALIGN_UT_SHIFT);
+}
+
+/* Only the segments adjacent in memory are merged. */
+static void bulkio_server_align_bufvec_gap(void)
+{
+	struct m0_fom    fom = {};
+	struct m0_bufvec ibuf;
+	struct m0_bufvec obuf;
+	char            *area;
+	int              rc;
+
+	area = m0_alloc_aligned(4 * ALIGN_UT_SEG, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(area != NULL);
+	rc = m0_bufvec_empty_alloc(&ibuf, 3);
+	M0_UT_ASSERT(rc == 0);
+	ibuf.ov_buf[0] = area;
+	ibuf.ov_buf[1] = area + 2 * ALIGN_UT_SEG;
+	ibuf.ov_buf[2] = area + 3 * ALIGN_UT_SEG;
+	ibuf.ov_vec.v_count[0] = ALIGN_UT_SEG;
+	ibuf.ov_vec.v_count[1] = ALIGN_UT_SEG;
+	ibuf.ov_vec.v_count[2] = ALIGN_UT_SEG;
+
+	rc = align_bufvec(&fom, &obuf, &ibuf, 12, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(obuf.ov_vec.v_nr == 2);
+	M0_UT_ASSERT(obuf.ov_vec.v_count[0] == 4);
+	M0_UT_ASSERT(obuf.ov_vec.v_count[1] == 8);
+	M0_UT_ASSERT(m0_stob_addr_open(obuf.ov_buf[1], ALIGN_UT_SHIFT) ==
+		     ibuf.ov_buf[1]);
+	m0_bufvec_free2(&obuf);
+
+	m0_bufvec_free2(&ibuf);
+	m0_free_aligned(area, 4 * ALIGN_UT_SEG, ALIGN_UT_SHIFT);
+}
+
+/* Segments not aligned to the stob block are rejected. */
+static void bulkio_server_align_bufvec_unaligned(void)
+{
+	struct m0_fom    fom = {};
+	struct m0_bufvec ibuf;
+	struct m0_bufvec obuf;
+	char            *area;
+	int              rc;
+
+	area = m0_alloc_aligned(4 * ALIGN_UT_SEG, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(area != NULL);
+	rc = m0_bufvec_empty_alloc(&ibuf, 2);
+	M0_UT_ASSERT(rc == 0);
+
+	/* Size of the first segment is not a multiple of the block. */
+	ibuf.ov_buf[0] = area;
+	ibuf.ov_vec.v_count[0] = ALIGN_UT_SEG + 512;
+	ibuf.ov_buf[1] = area + 2 * ALIGN_UT_SEG;
+	ibuf.ov_vec.v_count[1] = ALIGN_UT_SEG;
+	rc = align_bufvec(&fom, &obuf, &ibuf, 8, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == -EPROTO);
+
+	/* Address of the second segment is not aligned. */
+	ibuf.ov_vec.v_count[0] = ALIGN_UT_SEG;
+	ibuf.ov_buf[1] = area + 2 * ALIGN_UT_SEG + 512;
+	rc = align_bufvec(&fom, &obuf, &ibuf, 8, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == -EPROTO);
+
+	/* Unaligned segments past the end of the I/O do not matter. */
+	rc = align_bufvec(&fom, &obuf, &ibuf, 4, ALIGN_UT_SHIFT);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(obuf.ov_vec.v_nr == 1);
+	M0_UT_ASSERT(obuf.ov_vec.v_count[0] == 4);
+	m0_bufvec_free2(&obuf);
+
+	m0_bufvec_free2(&ibuf);
+	m0_free_aligned(area, 4 * ALIGN_UT_SEG, ALIGN_UT_SHIFT);
+}
+
 static void bulkio_init(void)
 {
 	int         rc;
@@ -1844,6 +1964,12 @@ struct m0_ut_suite bulkio_server_ut = {
 		   bulkio_server_read_write_multiple_nb},
 		{ "bulkio_server_rw_state_transition_test",
 		   bulkio_server_rw_state_transition_test},
+		{ "bulkio_server_align_bufvec_packed",
+		   bulkio_server_align_bufvec_packed},
+		{ "bulkio_server_align_bufvec_gap",
+		   bulkio_server_align_bufvec_gap},
+		{ "bulkio_server_align_bufvec_unaligned",
+		   bulkio_server_align_bufvec_unaligned},
 /** @todo: MOTR-1502: When HA will be in place we no longer require
  *       VERSION_MISMATCH error as server/client will
  *       fetch latestpool machine states from HA at every crash/reboot.
@@ -62,12 +62,28 @@ static int op_type_parse(const char *op_name)
 
 }
 
+static int targs_enc(struct isc_targs *ta, struct m0_buf *out)
+{
+	int           rc;
+	struct m0_buf buf = M0_BUF_INIT0;
+
+	rc = m0_xcode_obj_enc_to_buf(&M0_XCODE_OBJ(isc_targs_xc, ta),
+				     &buf.b_addr, &buf.b_nob);
+	if (rc != 0)
+		return rc;
+
+	*out = M0_BUF_INIT0; /* to avoid panic */
+	rc = m0_buf_copy_aligned(out, &buf, M0_0VEC_SHIFT);
+	m0_buf_free(&buf);
+
+	return rc;
+}
+
 static int minmax_input_prepare(struct m0_buf *out, struct m0_fid *comp_fid,
 				struct m0_layout_io_plop *iop,
 				uint32_t *reply_len, enum isc_comp_type type)
 {
-	int           rc;
-	struct m0_buf buf = M0_BUF_INIT0;
+	int              rc;
 	struct isc_targs ta = {};
 
 	if (iop->iop_ext.iv_vec.v_nr == 0) {
@@ -79,14 +95,8 @@ static int minmax_input_prepare(struct m0_buf *out, struct m0_fid *comp_fid,
 				  &ta.ist_ioiv);
 	if (rc != 0)
 		return rc;
-	rc = m0_xcode_obj_enc_to_buf(&M0_XCODE_OBJ(isc_targs_xc, &ta),
-				     &buf.b_addr, &buf.b_nob);
-	if (rc != 0)
-		return rc;
-
-	*out = M0_BUF_INIT0; /* to avoid panic */
-	rc = m0_buf_copy_aligned(out, &buf, M0_0VEC_SHIFT);
-	m0_buf_free(&buf);
+	rc = targs_enc(&ta, out);
+	m0_free(ta.ist_ioiv.ci_iosegs);
 
 	if (type == ICT_MIN)
 		isc_fid_get("comp_min", comp_fid);
@@ -385,6 +395,121 @@ static void* output_process(struct m0_buf *result, bool last,
 	return NULL;
 }
 
+/** Accumulator of the fan-out min2/max2 computation. */
+struct mm_fanout_acc {
+	enum isc_comp_type mfa_type;
+	/** Index of the resulting element in the object (1-based). */
+	uint64_t           mfa_idx;
+	/** Total number of elements seen. */
+	uint64_t           mfa_nr;
+	double             mfa_val;
+};
+
+static int minmax2_obj_args(const struct isc_fanout_tgt *t,
+			    struct m0_buf *args)
+{
+	struct isc_targs ta = {
+		.ist_cob  = t->ift_cob,
+		.ist_ioiv = t->ift_ext
+	};
+
+	return targs_enc(&ta, args);
+}
+
+/**
+ * Merge the result over all the local units of one ioservice.
+ *
+ * The reported index is local to the concatenation of the cob extents,
+ * so translate it to the object offset first. Among equal values the
+ * one closer to the object start wins, as in the unit-by-unit mode.
+ */
+static int minmax2_obj_reduce(const struct isc_fanout_tgt *t,
+			      struct m0_buf *result, void *acc)
+{
+	int                   rc;
+	uint64_t              idx;
+	struct mm_result      new = {};
+	struct mm_fanout_acc *a = acc;
+
+	rc = m0_xcode_obj_dec_from_buf(&M0_XCODE_OBJ(mm_result_xc, &new),
+				       result->b_addr, result->b_nob);
+	if (rc != 0) {
+		ERR("failed to parse result: rc=%d\n", rc);
+		return rc;
+	}
+	if (new.mr_nr == 0)
+		goto out;
+	idx = isc_fanout_goff(t, (new.mr_idx - 1) * sizeof(double)) /
+		sizeof(double) + 1;
+	DBG("cob="FID_F" nr=%lu idx=%lu val=%lf\n", FID_P(&t->ift_cob),
+	    new.mr_nr, idx, new.mr_val);
+	if (a->mfa_nr == 0 ||
+	    (a->mfa_type == ICT_MIN2 ? new.mr_val < a->mfa_val :
+				       new.mr_val > a->mfa_val) ||
+	    (new.mr_val == a->mfa_val && idx < a->mfa_idx)) {
+		a->mfa_val = new.mr_val;
+		a->mfa_idx = idx;
+	}
+	a->mfa_nr += new.mr_nr;
+ out:
+	mm_result_free_xcode_bufs(&new);
+	return 0;
+}
+
+/**
+ * Collect the extents of all the read plops of the plan
+ * into the fan-out targets.
+ */
+static int fanout_collect(struct m0_layout_plan *plan, struct isc_fanout *fo)
+{
+	int                       rc;
+	struct m0_layout_plop    *plop = NULL;
+	struct m0_layout_io_plop *iopl;
+
+	for (;;) {
+		rc = m0_layout_plan_get(plan, 0, &plop);
+		if (rc != 0) {
+			ERR("failed to get plop: rc=%d\n", rc);
+			return rc;
+		}
+		if (plop->pl_type == M0_LAT_DONE)
+			return 0;
+		if (plop->pl_type == M0_LAT_OUT_READ)
+			continue; /* XXX not used atm */
+
+		M0_ASSERT(plop->pl_type == M0_LAT_READ);
+
+		m0_layout_plop_start(plop);
+		iopl = container_of(plop, struct m0_layout_io_plop, iop_base);
+		rc = isc_fanout_add(fo, iopl);
+		m0_layout_plop_done(plop);
+		if (rc != 0)
+			return rc;
+	}
+}
+
+static int fanout_comp(struct isc_fanout *fo, int op_type)
+{
+	int                  rc;
+	struct m0_fid        comp_fid;
+	struct mm_fanout_acc acc = { .mfa_type = op_type };
+
+	isc_fid_get(op_type == ICT_MIN2 ? "comp_min2_obj" : "comp_max2_obj",
+		    &comp_fid);
+	rc = isc_fanout_exec(fo, &comp_fid, minmax2_obj_args,
+			     minmax2_obj_reduce, &acc);
+	if (rc != 0) {
+		ERR("fan-out computation failed: rc=%d\n", rc);
+		return rc;
+	}
+	printf("idx=%lu val=%lf\n", acc.mfa_idx, acc.mfa_val);
+	printf("ioservices=%u scanned in place=%lu bytes"
+	       " moved over network=%lu bytes\n",
+	       fo->ifo_nr, fo->ifo_bytes, fo->ifo_moved);
+
+	return 0;
+}
+
 char *prog;
 
 const char *help_str = "\
@@ -405,6 +530,8 @@ Usage: %s OPTIONS COMP OBJ_ID LEN\n\
    -p <fid>   profile fid\n\
 \n\
  Other non-mandatory options:\n\
+   -r  run min2/max2 once per ioservice over all its units of the object\n\
+       and combine the partial results (map/reduce)\n\
    -v  increase verbosity (-vv to increase even more)\n\
    -h  this help\n\
 \n";
@@ -559,11 +686,16 @@ int main(int argc, char **argv)
 	m0_bcount_t            bs;
 	m0_bindex_t            off = 0;
 	struct m0_obj          obj = {};
+	struct isc_fanout      fo;
+	bool                   fanout = false;
 
 	prog = basename(strdup(argv[0]));
 
-	while ((opt = getopt(argc, argv, ":vhe:x:f:p:")) != -1) {
+	while ((opt = getopt(argc, argv, ":rvhe:x:f:p:")) != -1) {
 		switch (opt) {
+		case 'r':
+			fanout = true;
+			break;
 		case 'e':
 			conf.mc_local_addr = optarg;
 			break;
@@ -600,6 +732,10 @@ int main(int argc, char **argv)
 	op_type = op_type_parse(argv[optind]);
 	if (op_type == -EINVAL)
 		usage();
+	if (fanout && op_type != ICT_MIN2 && op_type != ICT_MAX2) {
+		ERR("-r is supported for min2 and max2 only\n");
+		usage();
+	}
 	if (read_id(argv[optind + 1], &obj_id) < 1)
 		usage();
 	len = atoll(argv[optind + 2]);
@@ -632,6 +768,7 @@ int main(int argc, char **argv)
 		usage();
 	}
 	unit_sz = m0_obj_layout_id_to_unit_size(obj.ob_attr.oa_layout_id);
+	isc_fanout_init(&fo);
 
 	for (; rc == 0 && len > 0; len -= len < bs ? len : bs, off += bs) {
 		if (len < bs)
@@ -658,12 +795,19 @@ int main(int argc, char **argv)
 			usage();
 		}
 
-		rc = launch_comp(plan, op_type, len <= bs ? true : false);
+		if (fanout)
+			rc = fanout_collect(plan, &fo);
+		else
+			rc = launch_comp(plan, op_type, len <= bs);
 
 		m0_layout_plan_fini(plan);
 		free_segs(&data, &ext, &attr);
 	}
 
+	if (fanout && rc == 0)
+		rc = fanout_comp(&fo, op_type);
+	isc_fanout_fini(&fo);
+
 	isc_fini(cinst);
 
 	return rc != 0 ? 1 : 0;
@@ -289,6 +289,109 @@ int comp_max2(struct m0_buf *in, struct m0_buf *out,
 	return do_minmax(MAX2, in, out, comp_data, rc);
 }
 
+/** State of min2/max2 computation over all the local data of an object. */
+struct mm_obj_state {
+	struct isc_targs       mos_args;
+	struct m0_isc_obj_iter mos_it;
+	struct mm_result       mos_res;
+};
+
+static void mm_obj_scan(enum op op, struct mm_result *res,
+			const double *p, int64_t nr)
+{
+	int64_t i;
+
+	for (i = 0; i < nr; i++, res->mr_nr++) {
+		if (res->mr_nr == 0 || (op == MIN2 ? p[i] < res->mr_val :
+						     p[i] > res->mr_val)) {
+			res->mr_idx = res->mr_nr + 1;
+			res->mr_val = p[i];
+		}
+	}
+}
+
+/**
+ * Do the computation of min/max over all the units of the object
+ * stored on this ioservice.
+ *
+ * Unlike do_minmax(), which reads one unit per request, the function
+ * walks all the cob extents given in the arguments with m0_isc_obj_iter,
+ * one chunk per call, and replies with a single mm_result. mr_idx is
+ * the index of the element within the concatenation of the extents,
+ * the client maps it back to the object offset.
+ */
+static int do_minmax2_obj(enum op op, struct m0_buf *in, struct m0_buf *out,
+			  struct m0_isc_comp_private *data, int *rc)
+{
+	struct mm_obj_state *st = data->icp_data;
+	struct m0_buf        buf = M0_BUF_INIT0;
+	const char          *p;
+	int64_t              len;
+
+	if (st == NULL) { /* 1st call */
+		M0_ALLOC_PTR(st);
+		if (st == NULL) {
+			*rc = -ENOMEM;
+			return M0_FSO_AGAIN;
+		}
+		*rc = m0_xcode_obj_dec_from_buf(
+			&M0_XCODE_OBJ(isc_targs_xc, &st->mos_args),
+			in->b_addr, in->b_nob);
+		if (*rc != 0) {
+			M0_LOG(M0_ERROR, "failed to xdecode args: rc=%d", *rc);
+			m0_free(st);
+			return M0_FSO_AGAIN;
+		}
+		m0_isc_obj_iter_init(&st->mos_it, &st->mos_args.ist_cob,
+				     &st->mos_args.ist_ioiv, 0);
+		data->icp_data = st;
+	} else {
+		len = m0_isc_obj_iter_get(&st->mos_it, &p);
+		if (len < 0) {
+			*rc = M0_ERR_INFO((int)len, "failed to read data");
+			goto out;
+		}
+		M0_ASSERT((len & 7) == 0); /* unit size is multiple of 8 */
+		mm_obj_scan(op, &st->mos_res, (const double *)p, len / 8);
+	}
+
+	*rc = m0_isc_obj_iter_next(&st->mos_it, data->icp_fom);
+	if (*rc == 0) {
+		*rc = -EAGAIN; /* Wait for the next chunk. */
+		return M0_FSO_WAIT;
+	}
+	if (*rc == -ENOENT) {
+		M0_LOG(M0_DEBUG, "cob="FID_F" scanned=%lu",
+		       FID_P(&st->mos_args.ist_cob),
+		       (unsigned long)st->mos_it.oi_done);
+		*rc = m0_xcode_obj_enc_to_buf(
+				&M0_XCODE_OBJ(mm_result_xc, &st->mos_res),
+				&buf.b_addr, &buf.b_nob) ?:
+		      m0_buf_copy_aligned(out, &buf, M0_0VEC_SHIFT);
+		m0_buf_free(&buf);
+	} else if (*rc == -EAGAIN) {
+		*rc = -EBUSY; /* See the comment in launch_io(). */
+	}
+ out:
+	m0_isc_obj_iter_fini(&st->mos_it);
+	m0_free(st->mos_args.ist_ioiv.ci_iosegs); /* allocated by xdecode */
+	m0_free(st);
+	data->icp_data = NULL;
+	return M0_FSO_AGAIN;
+}
+
+int comp_min2_obj(struct m0_buf *in, struct m0_buf *out,
+		  struct m0_isc_comp_private *comp_data, int *rc)
+{
+	return do_minmax2_obj(MIN2, in, out, comp_data, rc);
+}
+
+int comp_max2_obj(struct m0_buf *in, struct m0_buf *out,
+		  struct m0_isc_comp_private *comp_data, int *rc)
+{
+	return do_minmax2_obj(MAX2, in, out, comp_data, rc);
+}
+
 static void comp_reg(const char *f_name, int (*ftn)(struct m0_buf *arg_in,
 						    struct m0_buf *args_out,
 					            struct m0_isc_comp_private
@@ -312,5 +415,7 @@ void motr_lib_init(void)
 	comp_reg("comp_max", comp_max);
 	comp_reg("comp_min2", comp_min2);
 	comp_reg("comp_max2", comp_max2);
+	comp_reg("comp_min2_obj", comp_min2_obj);
+	comp_reg("comp_max2_obj", comp_max2_obj);
 	m0_xc_iscservice_demo_libdemo_init();
 }
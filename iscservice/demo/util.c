@@ -19,8 +19,10 @@
  */
 
 #include <stdio.h>
+#include <string.h>           /* memcpy */
 
 #include "lib/trace.h"        /* m0_trace_set_mmapped_buffer */
+#include "lib/memory.h"       /* M0_ALLOC_ARR */
 #include "rpc/rpclib.h"       /* M0_RPCLIB_MAX_RETRIES */
 #include "motr/client_internal.h" /* m0_client */
 #include "layout/plan.h"      /* m0_layout_io_plop */
@@ -105,16 +107,14 @@ uint64_t set_exts(struct m0_indexvec *ext, uint64_t off, uint64_t bsz)
 	return i * bsz;
 }
 
-int isc_req_prepare(struct isc_req *req, struct m0_buf *args,
-		    const struct m0_fid *comp_fid,
-		    struct m0_layout_io_plop *iop, uint32_t reply_len)
+static int isc_req_prepare_sess(struct isc_req *req, struct m0_buf *args,
+				const struct m0_fid *comp_fid,
+				struct m0_rpc_session *sess, uint32_t reply_len)
 {
 	int                    rc;
-	struct m0_rpc_session *sess = iop->iop_session;
 	struct m0_fop_isc     *fop_isc = &req->cir_isc_fop;
 	struct m0_fop         *arg_fop = &req->cir_fop;
 
-	req->cir_plop = &iop->iop_base;
 	fop_isc->fi_comp_id = *comp_fid;
 	m0_rpc_at_init(&fop_isc->fi_args);
 	rc = m0_rpc_at_add(&fop_isc->fi_args, args, sess->s_conn);
@@ -140,6 +140,15 @@ int isc_req_prepare(struct isc_req *req, struct m0_buf *args,
 	return rc;
 }
 
+int isc_req_prepare(struct isc_req *req, struct m0_buf *args,
+		    const struct m0_fid *comp_fid,
+		    struct m0_layout_io_plop *iop, uint32_t reply_len)
+{
+	req->cir_plop = &iop->iop_base;
+	return isc_req_prepare_sess(req, args, comp_fid, iop->iop_session,
+				    reply_len);
+}
+
 void isc_req_replied(struct m0_rpc_item *item)
 {
 	int                    rc;
@@ -195,7 +204,7 @@ static void ireqs_list_add_in_order(struct isc_req *req)
 	m0_list_add_before(&r->cir_link, &req->cir_link);
 }
 
-int isc_req_send(struct isc_req *req)
+static int isc_req_post(struct isc_req *req)
 {
 	int                    rc;
 	struct m0_rpc_item    *item;
@@ -212,6 +221,13 @@ int isc_req_send(struct isc_req *req)
 		ERR("Failed to send request to %s: rc=%d\n",
 		    m0_rpc_conn_addr(req->cir_rpc_sess->s_conn), rc);
 
+	return rc;
+}
+
+int isc_req_send(struct isc_req *req)
+{
+	int rc = isc_req_post(req);
+
 	ireqs_list_add_in_order(req);
 
 	return rc;
@@ -241,6 +257,158 @@ void isc_req_fini(struct isc_req *req)
 	fop_fini_lock(&req->cir_fop);
 }
 
+static struct isc_fanout_tgt *fanout_tgt_find(struct isc_fanout *fo,
+					       const struct m0_fid *cob)
+{
+	struct isc_fanout_tgt *t;
+
+	m0_list_for_each_entry(&fo->ifo_tgts, t, struct isc_fanout_tgt,
+			       ift_link) {
+		if (m0_fid_eq(&t->ift_cob, cob))
+			return t;
+	}
+	return NULL;
+}
+
+void isc_fanout_init(struct isc_fanout *fo)
+{
+	M0_SET0(fo);
+	m0_list_init(&fo->ifo_tgts);
+}
+
+void isc_fanout_fini(struct isc_fanout *fo)
+{
+	struct isc_fanout_tgt *t;
+
+	m0_list_teardown(&fo->ifo_tgts, t, struct isc_fanout_tgt, ift_link) {
+		if (t->ift_sent)
+			isc_req_fini(&t->ift_req);
+		m0_free(t->ift_ext.ci_iosegs);
+		m0_free(t->ift_goff);
+		m0_free(t);
+	}
+	m0_list_fini(&fo->ifo_tgts);
+}
+
+int isc_fanout_add(struct isc_fanout *fo, struct m0_layout_io_plop *iop)
+{
+	struct isc_fanout_tgt *t;
+	struct m0_indexvec    *ext = &iop->iop_ext;
+	struct m0_ioseg       *segs;
+	m0_bindex_t           *goffs;
+	m0_bindex_t            goff = iop->iop_goff;
+	uint32_t               nr;
+	uint32_t               i;
+
+	t = fanout_tgt_find(fo, &iop->iop_base.pl_ent);
+	if (t == NULL) {
+		M0_ALLOC_PTR(t);
+		if (t == NULL)
+			return -ENOMEM;
+		t->ift_cob  = iop->iop_base.pl_ent;
+		t->ift_sess = iop->iop_session;
+		m0_list_add_tail(&fo->ifo_tgts, &t->ift_link);
+		fo->ifo_nr++;
+	}
+
+	nr = t->ift_ext.ci_nr + ext->iv_vec.v_nr;
+	if (nr > t->ift_alloc) {
+		nr = max32u(nr, t->ift_alloc * 2);
+		M0_ALLOC_ARR(segs, nr);
+		M0_ALLOC_ARR(goffs, nr);
+		if (segs == NULL || goffs == NULL) {
+			m0_free(segs);
+			m0_free(goffs);
+			return -ENOMEM;
+		}
+		if (t->ift_ext.ci_nr > 0) {
+			memcpy(segs, t->ift_ext.ci_iosegs,
+			       t->ift_ext.ci_nr * sizeof segs[0]);
+			memcpy(goffs, t->ift_goff,
+			       t->ift_ext.ci_nr * sizeof goffs[0]);
+		}
+		m0_free(t->ift_ext.ci_iosegs);
+		m0_free(t->ift_goff);
+		t->ift_ext.ci_iosegs = segs;
+		t->ift_goff = goffs;
+		t->ift_alloc = nr;
+	}
+	/*
+	 * The plop extents are contiguous in the object starting from
+	 * iop_goff, remember where each of them begins there.
+	 */
+	for (i = 0; i < ext->iv_vec.v_nr; i++) {
+		t->ift_ext.ci_iosegs[t->ift_ext.ci_nr] = (struct m0_ioseg) {
+			.ci_index = ext->iv_index[i],
+			.ci_count = ext->iv_vec.v_count[i]
+		};
+		t->ift_goff[t->ift_ext.ci_nr++] = goff;
+		goff += ext->iv_vec.v_count[i];
+		fo->ifo_bytes += ext->iv_vec.v_count[i];
+	}
+	return 0;
+}
+
+m0_bindex_t isc_fanout_goff(const struct isc_fanout_tgt *t, m0_bcount_t off)
+{
+	uint32_t i;
+
+	for (i = 0; i < t->ift_ext.ci_nr; i++) {
+		if (off < t->ift_ext.ci_iosegs[i].ci_count)
+			return t->ift_goff[i] + off;
+		off -= t->ift_ext.ci_iosegs[i].ci_count;
+	}
+	return M0_BINDEX_MAX;
+}
+
+int isc_fanout_exec(struct isc_fanout *fo, const struct m0_fid *comp_fid,
+		    isc_fanout_args_t args, isc_fanout_reduce_t reduce,
+		    void *acc)
+{
+	int                    rc = 0;
+	int                    sent = 0;
+	struct isc_fanout_tgt *t;
+	struct m0_buf          buf;
+
+	/* Map: one request per ioservice with all its extents. */
+	m0_list_for_each_entry(&fo->ifo_tgts, t, struct isc_fanout_tgt,
+			       ift_link) {
+		rc = args(t, &buf);
+		if (rc != 0) {
+			ERR("input preparation failed: %d\n", rc);
+			break;
+		}
+		rc = isc_req_prepare_sess(&t->ift_req, &buf, comp_fid,
+					  t->ift_sess, CBL_DEFAULT_MAX);
+		if (rc != 0) {
+			m0_buf_free(&buf);
+			ERR("request preparation failed: %d\n", rc);
+			break;
+		}
+		t->ift_sent = true;
+		rc = isc_req_post(&t->ift_req);
+		if (rc != 0)
+			break;
+		DBG("cob="FID_F" segs=%u\n", FID_P(&t->ift_cob),
+		    t->ift_ext.ci_nr);
+		sent++;
+	}
+
+	while (sent-- > 0)
+		m0_semaphore_down(&isc_sem);
+
+	/* Reduce the partial results. */
+	m0_list_for_each_entry(&fo->ifo_tgts, t, struct isc_fanout_tgt,
+			       ift_link) {
+		if (rc != 0 || !t->ift_sent)
+			break;
+		rc = t->ift_req.cir_rc ?: reduce(t, &t->ift_req.cir_result, acc);
+		fo->ifo_moved += t->ift_req.cir_result.b_nob;
+	}
+
+	return rc;
+}
+
 /*
  * init client resources.
  */
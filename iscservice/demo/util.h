@@ -108,6 +108,76 @@ int isc_req_send(struct isc_req *req);
  */
 void isc_req_fini(struct isc_req *req);
 
+/**
+ * Per-ioservice part of a fan-out computation: all the units of the
+ * object stored in one cob.
+ */
+struct isc_fanout_tgt {
+	/** Cob holding the units. */
+	struct m0_fid          ift_cob;
+	/** RPC session of the ioservice the cob is on. */
+	struct m0_rpc_session *ift_sess;
+	/** The cob extents of the units, in the object order. */
+	struct m0_io_indexvec  ift_ext;
+	/** Object offset of each ift_ext extent. */
+	m0_bindex_t           *ift_goff;
+	uint32_t               ift_alloc;
+	/** Request sent to the ioservice and its reply. */
+	struct isc_req         ift_req;
+	bool                   ift_sent;
+	struct m0_list_link    ift_link;
+};
+
+/**
+ * Fan-out (map/reduce) computation over an object.
+ *
+ * Instead of sending one request per unit, as launch_comp() in iscdemo.c
+ * does, the units found in the layout plan are grouped by cob, and one
+ * request carrying all the extents of a cob is sent to the ioservice
+ * holding it. The computation there walks the extents locally (see
+ * m0_isc_obj_iter) and replies with one partial result, which is
+ * combined with the others on the client.
+ */
+struct isc_fanout {
+	struct m0_list ifo_tgts;
+	/** Number of targets (ioservices). */
+	uint32_t       ifo_nr;
+	/** Object bytes covered by the computation. */
+	m0_bcount_t    ifo_bytes;
+	/** Bytes received from the ioservices (the partial results). */
+	m0_bcount_t    ifo_moved;
+};
+
+/** Prepares the computation arguments for target @t in @args. */
+typedef int (*isc_fanout_args_t)(const struct isc_fanout_tgt *t,
+				 struct m0_buf *args);
+/** Merges the partial @result received from target @t into @acc. */
+typedef int (*isc_fanout_reduce_t)(const struct isc_fanout_tgt *t,
+				   struct m0_buf *result, void *acc);
+
+void isc_fanout_init(struct isc_fanout *fo);
+void isc_fanout_fini(struct isc_fanout *fo);
+
+/**
+ * Adds the extents of the plop to the target of its cob.
+ * The plop can be done right after that.
+ */
+int isc_fanout_add(struct isc_fanout *fo, struct m0_layout_io_plop *iop);
+
+/**
+ * Sends the computation @comp to all the targets, waits for all the
+ * replies and reduces them in the order the targets were added.
+ */
+int isc_fanout_exec(struct isc_fanout *fo, const struct m0_fid *comp,
+		    isc_fanout_args_t args, isc_fanout_reduce_t reduce,
+		    void *acc);
+
+/**
+ * Returns the object offset of the byte at @off in the concatenation of
+ * the target extents, or M0_BINDEX_MAX if @off is beyond them.
+ */
+m0_bindex_t isc_fanout_goff(const struct isc_fanout_tgt *t, m0_bcount_t off);
+
 int alloc_segs(struct m0_bufvec *data, struct m0_indexvec *ext,
 	       struct m0_bufvec *attr, uint64_t bsz, uint32_t cnt);
 void free_segs(struct m0_bufvec *data, struct m0_indexvec *ext,
@@ -930,6 +930,102 @@ M0_INTERNAL void m0_isc_io_fini(struct m0_stob_io *stio)
 	m0_stob_io_fini(stio);
 	m0_storage_dev_stob_put(m0_cs_storage_devs_get(), stob);
 }
+
+M0_INTERNAL void m0_isc_obj_iter_init(struct m0_isc_obj_iter *it,
+				      const struct m0_fid *cob,
+				      struct m0_io_indexvec *ext,
+				      m0_bcount_t chunk)
+{
+	M0_SET0(it);
+	it->oi_cob   = *cob;
+	it->oi_ext   = ext;
+	it->oi_chunk = chunk ?: M0_ISC_OBJ_ITER_CHUNK;
+	it->oi_cur.ci_iosegs = it->oi_segs;
+}
+
+/**
+ * Unpacks the result of the read once it is complete. This has to be done
+ * exactly once before m0_isc_io_fini(), whether the data is consumed or not.
+ */
+static void obj_iter_collect(struct m0_isc_obj_iter *it)
+{
+	if (it->oi_data == NULL) {
+		it->oi_len = m0_isc_io_res(&it->oi_stio, &it->oi_data);
+		if (it->oi_stio.si_rc != 0)
+			it->oi_len = it->oi_stio.si_rc;
+	}
+}
+
+M0_INTERNAL void m0_isc_obj_iter_fini(struct m0_isc_obj_iter *it)
+{
+	if (it->oi_active) {
+		obj_iter_collect(it);
+		m0_isc_io_fini(&it->oi_stio);
+		it->oi_active = false;
+		it->oi_data = NULL;
+	}
+}
+
+/**
+ * Fills oi_cur with the extents of the next step: up to oi_chunk bytes,
+ * taken from as many consecutive extents as fit into oi_segs[].
+ */
+static m0_bcount_t obj_iter_step(struct m0_isc_obj_iter *it)
+{
+	struct m0_io_indexvec *ext = it->oi_ext;
+	struct m0_ioseg       *seg;
+	m0_bcount_t            nob = 0;
+	m0_bcount_t            cnt;
+
+	it->oi_cur.ci_nr = 0;
+	while (it->oi_seg < ext->ci_nr && nob < it->oi_chunk &&
+	       it->oi_cur.ci_nr < ARRAY_SIZE(it->oi_segs)) {
+		seg = &ext->ci_iosegs[it->oi_seg];
+		cnt = min64u(seg->ci_count - it->oi_segoff,
+			     it->oi_chunk - nob);
+		it->oi_segs[it->oi_cur.ci_nr++] = (struct m0_ioseg) {
+			.ci_index = seg->ci_index + it->oi_segoff,
+			.ci_count = cnt
+		};
+		nob += cnt;
+		it->oi_segoff += cnt;
+		if (it->oi_segoff == seg->ci_count) {
+			it->oi_seg++;
+			it->oi_segoff = 0;
+		}
+	}
+	return nob;
+}
+
+M0_INTERNAL int m0_isc_obj_iter_next(struct m0_isc_obj_iter *it,
+				     struct m0_fom *fom)
+{
+	int rc;
+
+	M0_ENTRY("cob="FID_F" seg=%u/%u", FID_P(&it->oi_cob), it->oi_seg,
+		 it->oi_ext->ci_nr);
+	m0_isc_obj_iter_fini(it);
+	if (obj_iter_step(it) == 0)
+		return M0_RC(-ENOENT);
+	rc = m0_isc_io_launch(&it->oi_stio, &it->oi_cob, &it->oi_cur, fom);
+	it->oi_active = rc == 0;
+	return M0_RC(rc);
+}
+
+M0_INTERNAL int64_t m0_isc_obj_iter_get(struct m0_isc_obj_iter *it,
+					const char **buf)
+{
+	bool first = it->oi_data == NULL;
+
+	M0_PRE(it->oi_active);
+	obj_iter_collect(it);
+	if (it->oi_len > 0) {
+		*buf = it->oi_data;
+		if (first)
+			it->oi_done += it->oi_len;
+	}
+	return it->oi_len;
+}
 #endif /* !__KERNEL__ */
 
 
@@ -27,6 +27,9 @@
 
 #include "iscservice/isc_fops.h"
 #include "fop/fom_generic.h"
+#ifndef __KERNEL__
+#include "stob/io.h"         /* m0_stob_io */
+#endif
 
 /**
    @defgroup iscservice ISC Service Operations
@@ -112,6 +115,15 @@
   device(s). In order to schedule computations over data it's necessary to know
   the interdependency of operations, and this is where the layout access plan
   is required. Kindly refer "layout/plan.h" for detailed documentation.
+
+  @section iscservice-near-data Near-data Computations
+
+  A computation may walk the local data of an object with m0_isc_obj_iter
+  instead of reading it over the network. The client groups the units of
+  the object by the cob (i.e. by the ioservice) holding them, sends one
+  request per ioservice with all its cob extents, and reduces the partial
+  results. Only the partial results cross the network. See
+  iscservice/demo for the fan-out side.
 @{
  */
 
@@ -300,6 +312,91 @@ M0_INTERNAL int64_t m0_isc_io_res(struct m0_stob_io *stio, char **buf);
  */
 M0_INTERNAL void m0_isc_io_fini(struct m0_stob_io *stio);
 
+#ifndef __KERNEL__
+enum {
+	/** Default amount of data read per m0_isc_obj_iter step. */
+	M0_ISC_OBJ_ITER_CHUNK    = 1 << 20,
+	/** Maximum number of cob extents read in one step. */
+	M0_ISC_OBJ_ITER_SEGS_MAX = 16,
+};
+
+/**
+ * Read-only iterator over the local data of an object.
+ *
+ * Lets a computation walk all the units of an object stored on this
+ * ioservice (given as cob extents, e.g. everything the client found
+ * for the cob in the layout plan) without reading them in one go and
+ * without the data ever leaving the node. Each step reads at most
+ * oi_chunk bytes, coalescing small extents, directly from the stob
+ * backing the cob.
+ *
+ * Usage from a computation (see comp_min2_obj() in iscservice/demo):
+ * @code
+ *	if (!first_call)
+ *		len = m0_isc_obj_iter_get(it, &data); // consume the chunk
+ *	*rc = m0_isc_obj_iter_next(it, pdata->icp_fom);
+ *	if (*rc == 0) {
+ *		*rc = -EAGAIN;     // be called again when data is ready
+ *		return M0_FSO_WAIT;
+ *	}
+ *	// -ENOENT: all the data is visited, produce the result.
+ * @endcode
+ */
+struct m0_isc_obj_iter {
+	/** Cob holding the data. */
+	struct m0_fid          oi_cob;
+	/** Cob extents to visit, in order. Not owned. */
+	struct m0_io_indexvec *oi_ext;
+	/** Maximum number of bytes read per step. */
+	m0_bcount_t            oi_chunk;
+	/** Current position: extent index and offset inside it. */
+	uint32_t               oi_seg;
+	m0_bcount_t            oi_segoff;
+	/** Total number of bytes delivered so far. */
+	m0_bcount_t            oi_done;
+	/** Extents of the current step. */
+	struct m0_ioseg        oi_segs[M0_ISC_OBJ_ITER_SEGS_MAX];
+	struct m0_io_indexvec  oi_cur;
+	struct m0_stob_io      oi_stio;
+	/** True while oi_stio holds a launched or completed read. */
+	bool                   oi_active;
+	/** Data and length (or -error) of the completed read. */
+	char                  *oi_data;
+	int64_t                oi_len;
+};
+
+/**
+ * Initialises the iterator over @ext extents of @cob.
+ * @chunk of 0 selects M0_ISC_OBJ_ITER_CHUNK.
+ */
+M0_INTERNAL void m0_isc_obj_iter_init(struct m0_isc_obj_iter *it,
+				      const struct m0_fid *cob,
+				      struct m0_io_indexvec *ext,
+				      m0_bcount_t chunk);
+
+/**
+ * Releases the data of the previous step and launches the read of the next
+ * one. @fom is woken up when the data is ready.
+ *
+ * @retval 0       the read is launched
+ * @retval -ENOENT all the extents have been visited
+ */
+M0_INTERNAL int m0_isc_obj_iter_next(struct m0_isc_obj_iter *it,
+				     struct m0_fom *fom);
+
+/**
+ * Returns the data read by the last m0_isc_obj_iter_next() in @buf.
+ * The data is valid until the next m0_isc_obj_iter_next() or
+ * m0_isc_obj_iter_fini() call.
+ *
+ * @retval number of bytes read or -error
+ */
+M0_INTERNAL int64_t m0_isc_obj_iter_get(struct m0_isc_obj_iter *it,
+					const char **buf);
+
+M0_INTERNAL void m0_isc_obj_iter_fini(struct m0_isc_obj_iter *it);
+#endif /* !__KERNEL__ */
+
 /** @} end of iscservice */
 /* __MOTR_ISC_H__ */
 #endif
@@ -29,6 +29,9 @@
 #include "lib/finject.h"
 #include "rpc/rpclib.h"           /* m0_rpc_server_start */
 #include "rpc/ut/at/at_ut.h"      /* atut__bufdata_alloc */
+#include "ioservice/fid_convert.h" /* m0_fid_convert_cob2stob */
+#include "ioservice/storage_dev.h" /* m0_storage_dev_stob_create */
+#include "stob/io.h"               /* m0_stob_io_bufvec_launch */
 
 #include <stdio.h>
 
@@ -937,6 +940,171 @@ static void test_remote_err_path(void)
 	isc_ut_server_stop();
 }
 
+enum {
+	/* Chunks and extents have to be multiples of the stob block. */
+	OI_UNIT    = 1 << 14,
+	OI_UNIT_NR = 8,
+};
+
+/* State of obj_iter_walk(), shared with test_obj_iter(). */
+static struct {
+	struct m0_fid          oiw_cob;
+	struct m0_io_indexvec  oiw_ext;
+	m0_bcount_t            oiw_chunk;
+	/* Stop once this many bytes are seen, 0 to walk all the extents. */
+	m0_bcount_t            oiw_stop;
+	/* Extents data concatenated, as the iterator should deliver it. */
+	char                  *oiw_expect;
+	struct m0_isc_obj_iter oiw_it;
+	m0_bcount_t            oiw_seen;
+	uint32_t               oiw_steps;
+} oiw;
+
+/* Walks oiw.oiw_ext with m0_isc_obj_iter checking the data. */
+static int obj_iter_walk(struct m0_buf *in, struct m0_buf *out,
+			 struct m0_isc_comp_private *comp_data, int *rc)
+{
+	const char *p;
+	int64_t     len;
+
+	if (comp_data->icp_data == NULL) {
+		m0_isc_obj_iter_init(&oiw.oiw_it, &oiw.oiw_cob, &oiw.oiw_ext,
+				     oiw.oiw_chunk);
+		comp_data->icp_data = &oiw;
+	} else {
+		len = m0_isc_obj_iter_get(&oiw.oiw_it, &p);
+		M0_UT_ASSERT(len > 0);
+		M0_UT_ASSERT(memcmp(p, oiw.oiw_expect + oiw.oiw_seen,
+				    len) == 0);
+		oiw.oiw_seen += len;
+		oiw.oiw_steps++;
+		if (oiw.oiw_stop != 0 && oiw.oiw_seen >= oiw.oiw_stop) {
+			*rc = 0;
+			goto out;
+		}
+	}
+	*rc = m0_isc_obj_iter_next(&oiw.oiw_it, comp_data->icp_fom);
+	if (*rc == 0) {
+		*rc = -EAGAIN;
+		return M0_FSO_WAIT;
+	}
+	if (*rc == -ENOENT)
+		*rc = 0;
+ out:
+	m0_isc_obj_iter_fini(&oiw.oiw_it);
+	comp_data->icp_data = NULL;
+	return M0_FSO_AGAIN;
+}
+
+static void obj_iter_run(struct m0_fid *fid, m0_bcount_t chunk,
+			 m0_bcount_t stop)
+{
+	struct m0_isc_comp_req comp_req;
+
+	M0_SET0(&comp_req);
+	M0_SET0(&oiw.oiw_it);
+	oiw.oiw_chunk = chunk;
+	oiw.oiw_stop  = stop;
+	oiw.oiw_seen  = 0;
+	oiw.oiw_steps = 0;
+	local_invocation(&comp_req, fid, 0);
+	M0_UT_ASSERT(!oiw.oiw_it.oi_active);
+	M0_UT_ASSERT(oiw.oiw_it.oi_done == oiw.oiw_seen);
+}
+
+/*
+ * Tests m0_isc_obj_iter over a cob holding several units of an object,
+ * some of which belong to other objects and are skipped.
+ */
+static void test_obj_iter(void)
+{
+	struct m0_ioseg         segs[] = {
+		{ .ci_index = 0,           .ci_count = 2 * OI_UNIT },
+		{ .ci_index = 3 * OI_UNIT, .ci_count = OI_UNIT },
+		{ .ci_index = 5 * OI_UNIT, .ci_count = 3 * OI_UNIT },
+	};
+	struct m0_storage_devs *devs;
+	struct m0_stob_id       stob_id;
+	struct m0_stob         *stob;
+	struct m0_bufvec        bv;
+	struct m0_fid           gob;
+	struct m0_fid           fid;
+	m0_bcount_t             count;
+	m0_bcount_t             total = 0;
+	uint32_t                shift;
+	char                   *data;
+	void                   *addr;
+	int                     rc;
+	int                     i;
+
+	rc = isc_ut_server_start();
+	M0_UT_ASSERT(rc == 0);
+	devs = m0_cs_storage_devs_get();
+	m0_fid_gob_make(&gob, 0, 0x42);
+	m0_fid_convert_gob2cob(&gob, &oiw.oiw_cob, M0_SDEV_CID_DEFAULT);
+	m0_fid_convert_cob2stob(&oiw.oiw_cob, &stob_id);
+	rc = m0_storage_dev_stob_create(devs, &stob_id, NULL);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_storage_dev_stob_find(devs, &stob_id, &stob);
+	M0_UT_ASSERT(rc == 0);
+
+	shift = m0_stob_block_shift(stob);
+	data = m0_alloc_aligned(OI_UNIT_NR * OI_UNIT, shift);
+	M0_UT_ASSERT(data != NULL);
+	for (i = 0; i < OI_UNIT_NR * OI_UNIT; ++i)
+		data[i] = i % 251;
+	addr  = m0_stob_addr_pack(data, shift);
+	count = (OI_UNIT_NR * OI_UNIT) >> shift;
+	bv    = M0_BUFVEC_INIT_BUF(&addr, &count);
+	rc = m0_stob_io_bufvec_launch(stob, &bv, SIO_WRITE, 0);
+	M0_UT_ASSERT(rc == 0);
+
+	oiw.oiw_ext = (struct m0_io_indexvec) {
+		.ci_nr     = ARRAY_SIZE(segs),
+		.ci_iosegs = segs
+	};
+	oiw.oiw_expect = m0_alloc(OI_UNIT_NR * OI_UNIT);
+	M0_UT_ASSERT(oiw.oiw_expect != NULL);
+	for (i = 0; i < ARRAY_SIZE(segs); ++i) {
+		memcpy(oiw.oiw_expect + total, data + segs[i].ci_index,
+		       segs[i].ci_count);
+		total += segs[i].ci_count;
+	}
+
+	fid_get("obj_iter_walk", &fid);
+	rc = m0_isc_comp_register(obj_iter_walk, "obj_iter_walk", &fid);
+	M0_UT_ASSERT(rc == 0);
+	/* The default chunk takes all the extents in one step. */
+	obj_iter_run(&fid, 0, 0);
+	M0_UT_ASSERT(oiw.oiw_steps == 1);
+	M0_UT_ASSERT(oiw.oiw_seen == total);
+	/*
+	 * 2-unit chunks: the 2nd step coalesces the 2nd extent with the
+	 * head of the 3rd one, the 3rd step takes the rest of it.
+	 */
+	obj_iter_run(&fid, 2 * OI_UNIT, 0);
+	M0_UT_ASSERT(oiw.oiw_steps == 3);
+	M0_UT_ASSERT(oiw.oiw_seen == total);
+	/* Chunks smaller than a unit split every extent. */
+	obj_iter_run(&fid, OI_UNIT / 2, 0);
+	M0_UT_ASSERT(oiw.oiw_steps == total / (OI_UNIT / 2));
+	M0_UT_ASSERT(oiw.oiw_seen == total);
+	/* The computation stops early, the iterator releases its read. */
+	obj_iter_run(&fid, 2 * OI_UNIT, 3 * OI_UNIT);
+	M0_UT_ASSERT(oiw.oiw_steps == 2);
+	M0_UT_ASSERT(oiw.oiw_seen == 4 * OI_UNIT);
+	M0_UT_ASSERT(oiw.oiw_it.oi_seg == 2);
+	M0_UT_ASSERT(oiw.oiw_it.oi_segoff == OI_UNIT);
+	m0_isc_comp_unregister(&fid);
+
+	m0_free(oiw.oiw_expect);
+	m0_free_aligned(data, OI_UNIT_NR * OI_UNIT, shift);
+	m0_stob_delete_mark(stob);
+	rc = m0_storage_dev_stob_destroy(devs, stob, NULL);
+	M0_UT_ASSERT(rc == 0);
+	isc_ut_server_stop();
+}
+
 struct m0_ut_suite isc_service_ut = {
 	.ts_name  = "isc-service-ut",
 	.ts_init  = NULL,
@@ -948,6 +1116,7 @@ struct m0_ut_suite isc_service_ut = {
 		{"remote-comp-signature", test_comp_signature,  "Nachiket"},
 		{"remote-waiting",        test_remote_waiting,  "Nachiket"},
 		{"remote-error-path",     test_remote_err_path, "Nachiket"},
+		{"obj-iter",              test_obj_iter,        "agent"},
 		{NULL, NULL}
 	}
 };
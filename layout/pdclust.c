@@ -645,6 +645,79 @@ static void permute(uint32_t n, uint32_t *k, uint32_t *s, uint32_t *r)
 	r[s[n - 1]] = n - 1;
 }
 
+/**
+ * Computes permutation of the columns of tile omega in the tile cache entry tc.
+ */
+static void tile_permute(struct m0_pdclust_instance *pi, struct tile_cache *tc,
+			 uint64_t omega)
+{
+	struct m0_pdclust_attr    attr;
+	struct m0_fid            *gfid;
+	uint32_t                  i;
+	uint64_t                  rstate;
+
+	attr = pi_to_pl(pi)->pl_attr;
+	gfid = &pi->pi_base.li_gfid;
+
+	/* Initialise columns array that will be permuted. */
+	for (i = 0; i < attr.pa_P; ++i)
+		tc->tc_permute[i] = i;
+
+	/* Initialise PRNG. */
+	rstate = m0_hash(attr.pa_seed.u_hi + gfid->f_key) ^
+		 m0_hash(attr.pa_seed.u_lo + omega + gfid->f_container);
+
+	/* Generate permutation number in lexicographic ordering. */
+	for (i = 0; i < attr.pa_P - 1; ++i)
+		tc->tc_lcode[i] = m0_rnd(attr.pa_P - i, &rstate);
+
+	/* Apply the permutation. */
+	permute(attr.pa_P, tc->tc_lcode, tc->tc_permute, tc->tc_inverse);
+	tc->tc_tile_no = omega;
+}
+
+/**
+ * Makes m0_pdclust_instance::pi_tile_cache describe tile omega and returns it.
+ *
+ * If the tile is found in m0_pdclust_instance::pi_tile_lru[], its entry is
+ * promoted. Otherwise the permutation is re-computed in the least recently
+ * used entry.
+ */
+static struct tile_cache *tile_cache_get(struct m0_pdclust_instance *pi,
+					 uint64_t omega)
+{
+	struct tile_cache *tc  = &pi->pi_tile_cache;
+	struct tile_cache *lru = pi->pi_tile_lru;
+	struct tile_cache  entry;
+	bool               hit = false;
+	int                i;
+
+	if (tc->tc_tile_no == omega)
+		return tc;
+
+	for (i = 0; i < ARRAY_SIZE(pi->pi_tile_lru) &&
+		    lru[i].tc_permute != NULL; ++i) {
+		if (lru[i].tc_tile_no == omega) {
+			hit = true;
+			break;
+		}
+	}
+	if (i == 0 && !hit) {
+		/* No spare entries, re-use the single one. */
+		tile_permute(pi, tc, omega);
+		return tc;
+	}
+	if (!hit)
+		--i;
+	entry = lru[i];
+	memmove(&lru[1], &lru[0], i * sizeof lru[0]);
+	lru[0] = *tc;
+	*tc = entry;
+	if (!hit)
+		tile_permute(pi, tc, omega);
+	return tc;
+}
+
 /**
  * Returns column number that a column t has after a permutation for tile omega
  * is applied.
@@ -654,39 +727,14 @@ static uint64_t permute_column(struct m0_pdclust_instance *pi,
 {
 	struct tile_cache        *tc;
 	struct m0_pdclust_attr    attr;
-	struct m0_pdclust_layout *pl;
-	struct m0_fid            *gfid;
 
-	pl   = pi_to_pl(pi);
-	attr =  pl->pl_attr;
-	gfid = &pi->pi_base.li_gfid;
+	attr = pi_to_pl(pi)->pl_attr;
 
 	M0_ENTRY("t %lu, P %lu", (unsigned long)t, (unsigned long)attr.pa_P);
 	M0_ASSERT(t < attr.pa_P);
-	tc = &pi->pi_tile_cache;
 
 	/* If cached values are for different tile, update the cache. */
-	if (tc->tc_tile_no != omega) {
-		uint32_t i;
-		uint64_t rstate;
-
-		/* Initialise columns array that will be permuted. */
-		for (i = 0; i < attr.pa_P; ++i)
-			tc->tc_permute[i] = i;
-
-		/* Initialise PRNG. */
-		rstate = m0_hash(attr.pa_seed.u_hi + gfid->f_key) ^
-			 m0_hash(attr.pa_seed.u_lo + omega + gfid->f_container);
-
-		/* Generate permutation number in lexicographic ordering. */
-		for (i = 0; i < attr.pa_P - 1; ++i)
-			tc->tc_lcode[i] = m0_rnd(attr.pa_P - i, &rstate);
-
-		/* Apply the permutation. */
-		permute(attr.pa_P, tc->tc_lcode,
-			tc->tc_permute, tc->tc_inverse);
-		tc->tc_tile_no = omega;
-	}
+	tc = tile_cache_get(pi, omega);
 
 	/**
 	 * @todo Not sure if this should be replaced by an ADDB DP or a M0_LOG.
@@ -783,6 +831,49 @@ M0_INTERNAL void m0_pdclust_instance_inv(struct m0_pdclust_instance *pi,
 	src->sa_group = m_enc(C, omega, j);
 }
 
+M0_INTERNAL void
+m0_pdclust_instance_map_range(struct m0_pdclust_instance *pi,
+			      uint64_t group, uint64_t nr,
+			      struct m0_pdclust_tgt_addr *tgt)
+{
+	struct m0_pdclust_layout *pl;
+	struct tile_cache        *tc;
+	uint32_t                  W;
+	uint32_t                  P;
+	uint32_t                  C;
+	uint32_t                  L;
+	uint32_t                  u;
+	uint64_t                  g;
+	uint64_t                  omega;
+	uint64_t                  j;
+	uint64_t                  r;
+	uint64_t                  t;
+
+	M0_PRE(pdclust_instance_invariant(pi));
+	M0_PRE(nr > 0 && tgt != NULL);
+
+	M0_ENTRY("pi %p group %"PRIu64" nr %"PRIu64, pi, group, nr);
+
+	pl = pi_to_pl(pi);
+	W = pl->pl_attr.pa_N + pl->pl_attr.pa_K + pl->pl_attr.pa_S;
+	P = pl->pl_attr.pa_P;
+	C = pl->pl_C;
+	L = pl->pl_L;
+	tc = &pi->pi_tile_cache;
+
+	for (g = group; g < group + nr; ++g) {
+		m_dec(C, g, &omega, &j);
+		if (tc->tc_tile_no != omega)
+			tile_cache_get(pi, omega);
+		for (u = 0; u < W; ++u, ++tgt) {
+			m_dec(P, m_enc(W, j, u), &r, &t);
+			tgt->ta_obj   = tc->tc_permute[t];
+			tgt->ta_frame = m_enc(L, omega, r);
+		}
+	}
+	M0_LEAVE("pi %p", pi);
+}
+
 static const struct m0_layout_instance_ops pdclust_instance_ops;
 M0_INTERNAL void pdclust_instance_fini(struct m0_layout_instance *li);
 
@@ -831,6 +922,39 @@ M0_INTERNAL bool m0_pdclust_is_replicated(struct m0_pdclust_layout *play)
 	return play->pl_attr.pa_N == 1;
 }
 
+static void tile_lru_free(struct m0_pdclust_instance *pi)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(pi->pi_tile_lru); ++i) {
+		m0_free(pi->pi_tile_lru[i].tc_inverse);
+		m0_free(pi->pi_tile_lru[i].tc_permute);
+		m0_free(pi->pi_tile_lru[i].tc_lcode);
+		M0_SET0(&pi->pi_tile_lru[i]);
+	}
+}
+
+static int tile_lru_alloc(struct m0_pdclust_instance *pi, uint32_t P)
+{
+	struct tile_cache *tc;
+	int                i;
+
+	for (i = 0; i < ARRAY_SIZE(pi->pi_tile_lru); ++i) {
+		tc = &pi->pi_tile_lru[i];
+		M0_ALLOC_ARR(tc->tc_lcode, P);
+		M0_ALLOC_ARR(tc->tc_permute, P);
+		M0_ALLOC_ARR(tc->tc_inverse, P);
+		if (tc->tc_lcode == NULL || tc->tc_permute == NULL ||
+		    tc->tc_inverse == NULL) {
+			tile_lru_free(pi);
+			return M0_ERR(-ENOMEM);
+		}
+		/* No tile is cached yet. */
+		tc->tc_tile_no = UINT64_MAX;
+	}
+	return 0;
+}
+
 /**
  * Implementation of lo_instance_build().
  *
@@ -881,8 +1005,8 @@ err1_injected:
 err2_injected:
 		if (tc->tc_lcode != NULL &&
 		    tc->tc_permute != NULL &&
-		    tc->tc_inverse != NULL) {
-			tc->tc_tile_no = 1;
+		    tc->tc_inverse != NULL &&
+		    tile_lru_alloc(pi, P) == 0) {
 
 			if (M0_FI_ENABLED("parity_math_err"))
 				{ rc = -EPROTO; goto err3_injected; }
@@ -894,7 +1018,7 @@ err3_injected:
 							&pdclust_instance_ops);
 				m0_pdclust_instance_bob_init(pi);
 				m0_mutex_init(&pi->pi_mutex);
-				permute_column(pi, 0, 0);
+				tile_permute(pi, tc, 0);
 			}
 			else
 				M0_LOG(M0_ERROR, "pi %p, m0_parity_math_init()"
@@ -917,6 +1041,7 @@ err3_injected:
 			m0_free(tc->tc_inverse);
 			m0_free(tc->tc_permute);
 			m0_free(tc->tc_lcode);
+			tile_lru_free(pi);
 		}
 		m0_free(pi);
 	}
@@ -945,6 +1070,7 @@ M0_INTERNAL void pdclust_instance_fini(struct m0_layout_instance *li)
 	m0_free(pi->pi_tile_cache.tc_inverse);
 	m0_free(pi->pi_tile_cache.tc_permute);
 	m0_free(pi->pi_tile_cache.tc_lcode);
+	tile_lru_free(pi);
 	m0_free(pi);
 	M0_LEAVE();
 }
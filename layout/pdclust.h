@@ -162,6 +162,11 @@ struct m0_pdclust_layout {
 	uint64_t                  pl_magic;
 };
 
+enum {
+	/** Number of tiles, permutations of which are cached by an instance. */
+	M0_PDCLUST_TILE_CACHE_NR = 8
+};
+
 /**
  * Parity de-clustered layout instance for a particular file.
  *
@@ -178,8 +183,9 @@ struct m0_pdclust_instance {
 	 * function is relatively expensive to re-compute. To reduce the
 	 * overhead, such information is cached.
 	 *
-	 * Currently only information for a single tile is cached. More
-	 * sophisticated schemes are possible.
+	 * Information for M0_PDCLUST_TILE_CACHE_NR tiles is cached: this entry
+	 * describes the most recently used tile, less recently used tiles are
+	 * kept in m0_pdclust_instance::pi_tile_lru[].
 	 */
 	struct tile_cache {
 		/** Tile to which caches information pertains. */
@@ -217,6 +223,16 @@ struct m0_pdclust_instance {
 		uint32_t *tc_lcode;
 	} pi_tile_cache;
 
+	/**
+	 * Less recently used tiles, most recently used first.
+	 *
+	 * Entries are moved (by value, the arrays are not copied) between
+	 * this array and m0_pdclust_instance::pi_tile_cache, so that the
+	 * latter always describes the tile used last. Entries with
+	 * tc_permute == NULL are not used.
+	 */
+	struct tile_cache            pi_tile_lru[M0_PDCLUST_TILE_CACHE_NR - 1];
+
 	uint64_t                     pi_cache_nr;
 	struct m0_fd_perm_cache     *pi_perm_cache;
 	/** Parity math information, initialised according to the layout. */
@@ -319,6 +335,22 @@ M0_INTERNAL void m0_pdclust_instance_inv(struct m0_pdclust_instance *pi,
 					 const struct m0_pdclust_tgt_addr *tgt,
 					 struct m0_pdclust_src_addr *src);
 
+/**
+ * Maps all the units of @nr consecutive parity groups, starting from @group,
+ * to target frames.
+ *
+ * Target address of unit u of group (group + i) is returned in
+ * tgt[i * (N + K + S) + u]. Results are the same as returned by
+ * m0_pdclust_instance_map() for each unit, but tile permutation is looked up
+ * once per tile rather than once per unit.
+ *
+ * @pre nr > 0 && tgt != NULL
+ */
+M0_INTERNAL void
+m0_pdclust_instance_map_range(struct m0_pdclust_instance *pi,
+			      uint64_t group, uint64_t nr,
+			      struct m0_pdclust_tgt_addr *tgt);
+
 M0_INTERNAL int m0_pdclust_perm_cache_build(struct m0_layout *layout,
 					    struct m0_pdclust_instance *pi);
 
@@ -2507,6 +2507,51 @@ static void ldemo(struct m0_pdclust_instance *pi,
 	}
 }
 
+/*
+ * Verifies that m0_pdclust_instance_map_range() agrees with
+ * m0_pdclust_instance_map(), while the tiles are visited in an order which
+ * cycles through more tiles than the instance caches.
+ */
+static void lrange(struct m0_pdclust_instance *pi,
+		   const struct m0_pdclust_layout *pl)
+{
+	struct m0_pdclust_src_addr  src;
+	struct m0_pdclust_tgt_addr  tgt;
+	struct m0_pdclust_src_addr  src1;
+	struct m0_pdclust_tgt_addr *range;
+	uint32_t                    W;
+	uint32_t                    C;
+	uint64_t                    nr;
+	uint64_t                    i;
+	uint64_t                    first;
+	uint32_t                    unit;
+
+	W  = pl->pl_attr.pa_N + pl->pl_attr.pa_K + pl->pl_attr.pa_S;
+	C  = pl->pl_C;
+	nr = 2 * C;
+	M0_ALLOC_ARR(range, nr * W);
+	M0_UT_ASSERT(range != NULL);
+	for (i = 0; i < 4 * M0_PDCLUST_TILE_CACHE_NR; ++i) {
+		/* Tiles 0, 3, 6, ... modulo 2 * M0_PDCLUST_TILE_CACHE_NR. */
+		first = (i * 3) % (2 * M0_PDCLUST_TILE_CACHE_NR) * C + C / 2;
+		m0_pdclust_instance_map_range(pi, first, nr, range);
+		for (src.sa_group = first; src.sa_group < first + nr;
+		     ++src.sa_group) {
+			for (unit = 0; unit < W; ++unit) {
+				src.sa_unit = unit;
+				m0_pdclust_instance_map(pi, &src, &tgt);
+				M0_UT_ASSERT(memcmp(&tgt,
+					&range[(src.sa_group - first) * W +
+					       unit], sizeof tgt) == 0);
+				m0_pdclust_instance_inv(pi, &tgt, &src1);
+				M0_UT_ASSERT(memcmp(&src, &src1,
+						    sizeof src) == 0);
+			}
+		}
+	}
+	m0_free(range);
+}
+
 /* Tests the APIs supported for m0_pdclust_instance object. */
 static int test_pdclust_instance_obj(uint32_t enum_id, uint64_t lid,
 				     bool inline_test, bool failure_test)
@@ -2576,6 +2621,7 @@ static int test_pdclust_instance_obj(uint32_t enum_id, uint64_t lid,
 		M0_UT_ASSERT(m0_ref_read(&l->l_ref) == 2);
 		pi = m0_layout_instance_to_pdi(li);
 		ldemo(pi, pl);
+		lrange(pi, pl);
 
 		/* Verify m0_layout_instance_to_pdi(). */
 		li = &pi->pi_base;
@@ -3804,6 +3850,123 @@ struct m0_ut_suite layout_ut = {
 };
 M0_EXPORTED(layout_ut);
 
+#ifndef __KERNEL__
+#include "lib/ub.h"
+
+enum {
+	LAYOUT_UB_ITER   = 200,
+	/* Parity groups mapped by every round. */
+	LAYOUT_UB_GROUPS = 256,
+	/* Tiles visited in turn by the "interleaved" benchmarks. */
+	LAYOUT_UB_TILES  = M0_PDCLUST_TILE_CACHE_NR / 2,
+	LAYOUT_UB_P      = 100
+};
+
+static struct m0_pdclust_layout   *ub_pl;
+static struct m0_pdclust_instance *ub_pi;
+static struct m0_pool_version      ub_pver;
+static uint64_t                    ub_cache_len[] = { 1, 2, 3, 4 };
+static struct m0_pdclust_tgt_addr *ub_tgt;
+static uint32_t                    ub_W;
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	struct m0_layout_linear_enum *lin_enum;
+	struct m0_layout_instance    *li;
+	struct m0_uint128             seed;
+	struct m0_fid                 gfid;
+	uint32_t                      N;
+	uint32_t                      K;
+	uint32_t                      S;
+	uint32_t                      P;
+
+	test_init();
+	m0_uint128_init(&seed, "buildpdclustlayo");
+	NKP_assign_and_pool_init(LINEAR_ENUM_ID, INLINE_NOT_APPLICABLE,
+				 14, 30, LAYOUT_UB_P, &N, &K, &S, &P);
+	rc = pdclust_layout_build(LINEAR_ENUM_ID, 13001, N, K, S, P, &seed,
+				  10, 20, &ub_pl, &lin_enum, !FAILURE_TEST);
+	M0_UB_ASSERT(rc == 0);
+	ub_pver.pv_fd_tree.ft_cache_info.fci_nr   = ARRAY_SIZE(ub_cache_len);
+	ub_pver.pv_fd_tree.ft_cache_info.fci_info = ub_cache_len;
+	m0_pdl_to_layout(ub_pl)->l_pver = &ub_pver;
+	m0_fid_set(&gfid, 0, 999);
+	rc = m0_layout_instance_build(m0_pdl_to_layout(ub_pl), &gfid, &li);
+	M0_UB_ASSERT(rc == 0);
+	ub_pi = m0_layout_instance_to_pdi(li);
+	ub_W = N + K + S;
+	M0_ALLOC_ARR(ub_tgt, LAYOUT_UB_GROUPS * ub_W);
+	M0_UB_ASSERT(ub_tgt != NULL);
+	return 0;
+}
+
+static void ub_fini(void)
+{
+	m0_free(ub_tgt);
+	m0_layout_instance_fini(&ub_pi->pi_base);
+	m0_layout_put(m0_pdl_to_layout(ub_pl));
+	m0_pool_fini(&pool);
+	test_fini();
+}
+
+/* Returns i-th group of a round, alternating between LAYOUT_UB_TILES tiles. */
+static uint64_t ub_group(int round, uint64_t i, bool interleaved)
+{
+	uint64_t base = (uint64_t)round * LAYOUT_UB_GROUPS;
+
+	return interleaved ?
+		base + (i % LAYOUT_UB_TILES) * ub_pl->pl_C +
+		i / LAYOUT_UB_TILES : base + i;
+}
+
+static void ub_map(int round, bool interleaved)
+{
+	struct m0_pdclust_src_addr src;
+	uint64_t                   i;
+
+	for (i = 0; i < LAYOUT_UB_GROUPS; ++i) {
+		src.sa_group = ub_group(round, i, interleaved);
+		for (src.sa_unit = 0; src.sa_unit < ub_W; ++src.sa_unit)
+			m0_pdclust_instance_map(ub_pi, &src,
+						&ub_tgt[i * ub_W + src.sa_unit]);
+	}
+}
+
+static void ub_map_sequential(int round)
+{
+	ub_map(round, false);
+}
+
+static void ub_map_interleaved(int round)
+{
+	ub_map(round, true);
+}
+
+static void ub_map_range(int round)
+{
+	m0_pdclust_instance_map_range(ub_pi, ub_group(round, 0, false),
+				      LAYOUT_UB_GROUPS, ub_tgt);
+}
+
+struct m0_ub_set m0_layout_ub = {
+	.us_name = "layout-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		{ .ub_name  = "map-sequential",
+		  .ub_iter  = LAYOUT_UB_ITER,
+		  .ub_round = ub_map_sequential },
+		{ .ub_name  = "map-interleaved",
+		  .ub_iter  = LAYOUT_UB_ITER,
+		  .ub_round = ub_map_interleaved },
+		{ .ub_name  = "map-range",
+		  .ub_iter  = LAYOUT_UB_ITER,
+		  .ub_round = ub_map_range },
+		{ .ub_name = NULL }
+	}
+};
+#endif /* __KERNEL__ */
+
 #undef M0_TRACE_SUBSYSTEM
 
 /*
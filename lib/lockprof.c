@@ -0,0 +1,290 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+
+/**
+ * @addtogroup lockprof
+ *
+ * Call sites live in a fixed open-addressed table, so that accounting never
+ * allocates memory or takes a lock (which would recurse into the profiler).
+ * A slot is claimed by compare-and-swap of its key, which encodes the call
+ * site address and the lock kind; everything else in the slot is updated
+ * with atomic operations.
+ *
+ * @{
+ */
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_LIB
+#include "lib/trace.h"
+
+#include "lib/lockprof.h"
+#include "lib/atomic.h"
+#include "lib/arith.h"                /* m0_log2 */
+#include "lib/errno.h"
+#include "lib/hash.h"                 /* m0_hash */
+#include "lib/misc.h"                 /* m0_ptr_wrap, M0_SET0 */
+#include "lib/locality.h"
+#include "addb2/addb2.h"
+#include "addb2/identifier.h"
+
+enum {
+	/** Slots probed before giving up and using the overflow site. */
+	LOCKPROF_PROBE_NR = 16,
+	/** Interval of posting statistics to addb2. */
+	LOCKPROF_POST_SEC = 1
+};
+
+struct m0_lockprof_site {
+	/** (address << 2) | (kind + 1), 0 for a free slot. */
+	int64_t            ls_key;
+	struct m0_atomic64 ls_acquired;
+	struct m0_atomic64 ls_contended;
+	struct m0_atomic64 ls_wait;
+	struct m0_atomic64 ls_hold;
+	int64_t            ls_wait_max;
+	int64_t            ls_hold_max;
+	struct m0_atomic64 ls_wait_hist[M0_LOCKPROF_HIST_NR];
+	struct m0_atomic64 ls_hold_hist[M0_LOCKPROF_HIST_NR];
+};
+
+/** The table, the last slot is the overflow site. */
+static struct m0_lockprof_site lockprof_sites[M0_LOCKPROF_SITES_NR + 1];
+static bool lockprof_on = true;
+static struct m0_locality_chore lockprof_chore;
+
+static int64_t site_key(const void *addr, enum m0_lockprof_kind kind)
+{
+	M0_CASSERT(M0_LPK_NR < 4);
+	return ((uint64_t)addr << 2) | (kind + 1);
+}
+
+static const void *site_addr(const struct m0_lockprof_site *site)
+{
+	return (const void *)((uint64_t)site->ls_key >> 2);
+}
+
+/** Returns M0_LPK_NR for the overflow site. */
+static enum m0_lockprof_kind site_kind(const struct m0_lockprof_site *site)
+{
+	return site->ls_key == 0 ? M0_LPK_NR : (site->ls_key & 3) - 1;
+}
+
+static struct m0_lockprof_site *site_find(const void *addr,
+					  enum m0_lockprof_kind kind,
+					  bool create)
+{
+	int64_t  key = site_key(addr, kind);
+	uint64_t idx = m0_hash(key) % M0_LOCKPROF_SITES_NR;
+	int      i;
+
+	for (i = 0; i < LOCKPROF_PROBE_NR; ++i) {
+		struct m0_lockprof_site *site = &lockprof_sites[idx];
+		int64_t                  cur  = site->ls_key;
+
+		if (cur == key)
+			return site;
+		if (cur == 0) {
+			if (!create)
+				return NULL;
+			if (m0_atomic64_cas(&site->ls_key, 0, key))
+				return site;
+			if (site->ls_key == key)
+				return site;
+		}
+		idx = (idx + 1) % M0_LOCKPROF_SITES_NR;
+	}
+	return create ? &lockprof_sites[M0_LOCKPROF_SITES_NR] : NULL;
+}
+
+/** Histogram bucket of a duration, see M0_LOCKPROF_HIST_NR. */
+static unsigned hist_idx(m0_time_t t)
+{
+	uint64_t us = t / 1000;
+
+	return us == 0 ? 0 : min_check(1 + m0_log2(us) / 2,
+				       (unsigned)M0_LOCKPROF_HIST_NR - 1);
+}
+
+static void max_update(int64_t *max, int64_t val)
+{
+	int64_t cur;
+
+	do {
+		cur = *max;
+	} while (val > cur && !m0_atomic64_cas(max, cur, val));
+}
+
+M0_INTERNAL bool m0_lockprof_is_enabled(void)
+{
+	return lockprof_on;
+}
+
+M0_INTERNAL void m0_lockprof_enable(bool on)
+{
+	lockprof_on = on;
+}
+
+M0_INTERNAL struct m0_lockprof_site *
+m0_lockprof_acquired(const void *addr, enum m0_lockprof_kind kind,
+		     bool contended, m0_time_t wait)
+{
+	struct m0_lockprof_site *site;
+
+	M0_PRE(M0_IN(kind, (M0_LPK_MUTEX, M0_LPK_READ, M0_LPK_WRITE)));
+	site = site_find(addr, kind, true);
+	m0_atomic64_inc(&site->ls_acquired);
+	if (contended) {
+		m0_atomic64_inc(&site->ls_contended);
+		m0_atomic64_add(&site->ls_wait, wait);
+		m0_atomic64_inc(&site->ls_wait_hist[hist_idx(wait)]);
+		max_update(&site->ls_wait_max, wait);
+	}
+	return site;
+}
+
+M0_INTERNAL void m0_lockprof_released(struct m0_lockprof_site *site,
+				      m0_time_t hold)
+{
+	m0_atomic64_add(&site->ls_hold, hold);
+	m0_atomic64_inc(&site->ls_hold_hist[hist_idx(hold)]);
+	max_update(&site->ls_hold_max, hold);
+}
+
+static void site_stats(const struct m0_lockprof_site *site,
+		       struct m0_lockprof_stats *out)
+{
+	int i;
+
+	*out = (struct m0_lockprof_stats) {
+		.lps_addr      = site_addr(site),
+		.lps_kind      = site_kind(site),
+		.lps_acquired  = m0_atomic64_get(&site->ls_acquired),
+		.lps_contended = m0_atomic64_get(&site->ls_contended),
+		.lps_wait      = m0_atomic64_get(&site->ls_wait),
+		.lps_wait_max  = site->ls_wait_max,
+		.lps_hold      = m0_atomic64_get(&site->ls_hold),
+		.lps_hold_max  = site->ls_hold_max
+	};
+	for (i = 0; i < M0_LOCKPROF_HIST_NR; ++i) {
+		out->lps_wait_hist[i] = m0_atomic64_get(&site->ls_wait_hist[i]);
+		out->lps_hold_hist[i] = m0_atomic64_get(&site->ls_hold_hist[i]);
+	}
+}
+
+M0_INTERNAL int m0_lockprof_stats_get(const void *addr,
+				      enum m0_lockprof_kind kind,
+				      struct m0_lockprof_stats *out)
+{
+	struct m0_lockprof_site *site = site_find(addr, kind, false);
+
+	if (site == NULL)
+		return -ENOENT;
+	site_stats(site, out);
+	return 0;
+}
+
+M0_INTERNAL void m0_lockprof_reset(void)
+{
+	M0_SET_ARR0(lockprof_sites);
+}
+
+/** Histogram buckets as addb2 record values. */
+#define HIST_VALUES(h) (h)[0], (h)[1], (h)[2], (h)[3], (h)[4], (h)[5],	\
+	(h)[6], (h)[7], (h)[8], (h)[9], (h)[10], (h)[11]
+
+M0_INTERNAL void m0_lockprof_post(void)
+{
+	struct m0_lockprof_stats s;
+	uint64_t                 site;
+	int                      i;
+
+	M0_CASSERT(M0_LOCKPROF_HIST_NR == 12);
+	for (i = 0; i < ARRAY_SIZE(lockprof_sites); ++i) {
+		if ((lockprof_sites[i].ls_key == 0 &&
+		     i != M0_LOCKPROF_SITES_NR) ||
+		    m0_atomic64_get(&lockprof_sites[i].ls_acquired) == 0)
+			continue;
+		site_stats(&lockprof_sites[i], &s);
+		site = m0_ptr_wrap(s.lps_addr);
+		M0_ADDB2_ADD(M0_AVI_LOCK_PROF, site, s.lps_kind,
+			     s.lps_acquired, s.lps_contended,
+			     s.lps_wait, s.lps_wait_max,
+			     s.lps_hold, s.lps_hold_max);
+		if (s.lps_contended > 0)
+			M0_ADDB2_ADD(M0_AVI_LOCK_PROF_WAIT, site,
+				     HIST_VALUES(s.lps_wait_hist));
+		if (s.lps_kind != M0_LPK_READ)
+			M0_ADDB2_ADD(M0_AVI_LOCK_PROF_HOLD, site,
+				     HIST_VALUES(s.lps_hold_hist));
+	}
+}
+
+static void lockprof_tick(struct m0_locality_chore *chore,
+			  struct m0_locality *loc, void *place)
+{
+	if (loc->lo_idx == 0 && m0_lockprof_is_enabled())
+		m0_lockprof_post();
+}
+
+static const struct m0_locality_chore_ops lockprof_chore_ops = {
+	.co_name = "lockprof",
+	.co_tick = lockprof_tick
+};
+
+M0_INTERNAL int m0_lockprof_chore_init(void)
+{
+	int rc;
+
+	if (!M0_LOCKPROF_ENABLED)
+		return 0;
+	M0_PRE(lockprof_chore.lc_ops == NULL);
+	rc = m0_locality_chore_init(&lockprof_chore, &lockprof_chore_ops,
+				    NULL, M0_MKTIME(LOCKPROF_POST_SEC, 0), 0);
+	if (rc != 0)
+		M0_SET0(&lockprof_chore);
+	return M0_RC(rc);
+}
+
+M0_INTERNAL void m0_lockprof_chore_fini(void)
+{
+	if (lockprof_chore.lc_ops != NULL) {
+		m0_locality_chore_fini(&lockprof_chore);
+		M0_SET0(&lockprof_chore);
+	}
+}
+
+#undef M0_TRACE_SUBSYSTEM
+
+/** @} end of lockprof group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -0,0 +1,172 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_LIB_LOCKPROF_H__
+#define __MOTR_LIB_LOCKPROF_H__
+
+#include "lib/types.h"
+#include "lib/time.h"
+
+/**
+   @defgroup lockprof Lock contention profiler
+
+   Profiler of m0_mutex and m0_rwlock, compiled into the locking functions
+   when motr is configured with --enable-lock-prof (user space only).
+
+   Statistics are kept per call site, i.e., per return address of the
+   locking call, and per lock kind:
+
+   - number of acquisitions;
+   - number of contended acquisitions, where the lock was not available
+     immediately;
+   - total and maximal wait time, and a histogram of wait times of
+     contended acquisitions;
+   - total and maximal hold time, and a histogram of hold times. Hold time
+     is not measured for read locks, because the lock does not know which
+     of its readers unlocks it.
+
+   Statistics are cumulative. Every second, locality 0 posts them to addb2
+   as M0_AVI_LOCK_PROF, M0_AVI_LOCK_PROF_WAIT and M0_AVI_LOCK_PROF_HOLD
+   records (see m0_lockprof_post()), which m0addb2dump prints with call
+   sites resolved to symbols.
+
+   When motr is not configured with --enable-lock-prof, locking functions do
+   not call the profiler at all. Otherwise, m0_lockprof_enable() pauses and
+   resumes profiling; the only cost of a paused profiler is a check of a
+   global flag per lock operation.
+
+   @{
+ */
+
+#if defined(ENABLE_LOCK_PROF) && !defined(__KERNEL__)
+#define M0_LOCKPROF_ENABLED (1)
+#else
+#define M0_LOCKPROF_ENABLED (0)
+#endif
+
+enum m0_lockprof_kind {
+	M0_LPK_MUTEX,
+	M0_LPK_READ,
+	M0_LPK_WRITE,
+	M0_LPK_NR
+};
+
+enum {
+	/**
+	   Number of distinct (call site, kind) pairs tracked. Acquisitions at
+	   sites which do not fit are accounted to a single overflow site with
+	   address 0.
+	 */
+	M0_LOCKPROF_SITES_NR = 1024,
+	/**
+	   Number of histogram buckets. Bucket 0 counts durations below 1us,
+	   bucket i counts durations in [4^(i-1), 4^i) microseconds, the last
+	   bucket counts everything from 4^10us (about 1s) up.
+	 */
+	M0_LOCKPROF_HIST_NR  = 12
+};
+
+struct m0_lockprof_site;
+
+/** A snapshot of the statistics of a call site. */
+struct m0_lockprof_stats {
+	const void            *lps_addr;
+	enum m0_lockprof_kind  lps_kind;
+	uint64_t               lps_acquired;
+	uint64_t               lps_contended;
+	m0_time_t              lps_wait;
+	m0_time_t              lps_wait_max;
+	m0_time_t              lps_hold;
+	m0_time_t              lps_hold_max;
+	uint64_t               lps_wait_hist[M0_LOCKPROF_HIST_NR];
+	uint64_t               lps_hold_hist[M0_LOCKPROF_HIST_NR];
+};
+
+#ifndef __KERNEL__
+
+/** True iff profiling is not paused. */
+M0_INTERNAL bool m0_lockprof_is_enabled(void);
+M0_INTERNAL void m0_lockprof_enable(bool on);
+
+/**
+   Accounts an acquisition of a lock of the given kind at call site "addr",
+   which waited for "wait" if "contended". Returns the site to be passed to
+   m0_lockprof_released().
+ */
+M0_INTERNAL struct m0_lockprof_site *
+m0_lockprof_acquired(const void *addr, enum m0_lockprof_kind kind,
+		     bool contended, m0_time_t wait);
+
+/** Accounts the release of a lock acquired at "site" and held for "hold". */
+M0_INTERNAL void m0_lockprof_released(struct m0_lockprof_site *site,
+				      m0_time_t hold);
+
+/**
+   Fills "out" with the statistics of call site "addr". Returns -ENOENT if
+   no acquisition at this site was accounted.
+ */
+M0_INTERNAL int m0_lockprof_stats_get(const void *addr,
+				      enum m0_lockprof_kind kind,
+				      struct m0_lockprof_stats *out);
+
+/**
+   Forgets all call sites. Acquisitions and releases racing with the reset
+   may be lost.
+ */
+M0_INTERNAL void m0_lockprof_reset(void);
+
+/** Posts statistics of all call sites to addb2 in the current context. */
+M0_INTERNAL void m0_lockprof_post(void);
+
+/**
+   Starts periodic posting of statistics from locality 0. Does nothing if
+   the profiler is not compiled in.
+
+   @pre m0_fom_dom() != NULL
+ */
+M0_INTERNAL int  m0_lockprof_chore_init(void);
+M0_INTERNAL void m0_lockprof_chore_fini(void);
+
+#else /* __KERNEL__ */
+
+static inline int  m0_lockprof_chore_init(void) { return 0; }
+static inline void m0_lockprof_chore_fini(void) {}
+
+#endif /* __KERNEL__ */
+
+/** @} end of lockprof group */
+#endif /* __MOTR_LIB_LOCKPROF_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -46,18 +46,69 @@ M0_INTERNAL void m0_mutex_fini(struct m0_mutex *mutex)
 }
 M0_EXPORTED(m0_mutex_fini);
 
+#if M0_LOCKPROF_ENABLED
+static bool mutex_prof_is_on(void)
+{
+	return m0_lockprof_is_enabled();
+}
+
+/**
+ * Takes the mutex, accounting the acquisition to the call site of
+ * m0_mutex_lock(). Contention is detected by a failed trylock, so that
+ * uncontended acquisitions do not read the clock before the lock is taken.
+ */
+static void mutex_prof_lock(struct m0_mutex *mutex, const void *site)
+{
+	bool      contended;
+	m0_time_t start = 0;
+
+	contended = m0_arch_mutex_trylock(&mutex->m_arch) != 0;
+	if (contended) {
+		start = m0_time_now();
+		m0_arch_mutex_lock(&mutex->m_arch);
+	}
+	mutex->m_prof_taken = m0_time_now();
+	mutex->m_prof = m0_lockprof_acquired(site, M0_LPK_MUTEX, contended,
+					     mutex->m_prof_taken - start);
+}
+
+static void mutex_prof_unlock(struct m0_mutex *mutex)
+{
+	struct m0_lockprof_site *site = mutex->m_prof;
+
+	if (site != NULL) {
+		mutex->m_prof = NULL;
+		m0_lockprof_released(site, m0_time_now() - mutex->m_prof_taken);
+	}
+}
+#else
+static bool mutex_prof_is_on(void)
+{
+	return false;
+}
+
+static void mutex_prof_lock(struct m0_mutex *mutex, const void *site)
+{
+}
+
+static void mutex_prof_unlock(struct m0_mutex *mutex)
+{
+}
+#endif
+
 M0_INTERNAL void m0_mutex_lock(struct m0_mutex *mutex)
 {
 	struct m0_mutex_addb2 *ma = mutex->m_addb2;
 
 	M0_PRE(m0_mutex_is_not_locked(mutex));
-	if (ma == NULL)
-		m0_arch_mutex_lock(&mutex->m_arch);
-	else {
+	if (ma != NULL) {
 		M0_ADDB2_HIST(ma->ma_id, &ma->ma_wait, m0_ptr_wrap(mutex),
 			      m0_arch_mutex_lock(&mutex->m_arch));
 		ma->ma_taken = m0_time_now();
-	}
+	} else if (mutex_prof_is_on())
+		mutex_prof_lock(mutex, __builtin_return_address(0));
+	else
+		m0_arch_mutex_lock(&mutex->m_arch);
 	M0_ASSERT(mutex->m_owner == NULL);
 	mutex->m_owner = m0_thread_self();
 }
@@ -69,6 +120,7 @@ M0_INTERNAL void m0_mutex_unlock(struct m0_mutex *mutex)
 
 	M0_PRE(m0_mutex_is_locked(mutex));
 	mutex->m_owner = NULL;
+	mutex_prof_unlock(mutex);
 	if (ma != NULL) {
 		m0_time_t hold  = m0_time_now() - ma->ma_taken;
 		uint64_t  datum = m0_ptr_wrap(mutex);
@@ -27,6 +27,7 @@
 
 #include "lib/types.h"
 #include "addb2/histogram.h"
+#include "lib/lockprof.h"                /* M0_LOCKPROF_ENABLED */
 
 /**
    @defgroup mutex Mutual exclusion synchronisation object
@@ -45,9 +46,15 @@ struct m0_mutex_addb2;
 struct m0_thread;
 
 struct m0_mutex {
-	struct m0_arch_mutex   m_arch;
-	struct m0_thread      *m_owner;
-	struct m0_mutex_addb2 *m_addb2;
+	struct m0_arch_mutex     m_arch;
+	struct m0_thread        *m_owner;
+	struct m0_mutex_addb2   *m_addb2;
+#if M0_LOCKPROF_ENABLED
+	/** Profiler call site of the current owner. */
+	struct m0_lockprof_site *m_prof;
+	/** When the current owner took the mutex. */
+	m0_time_t                m_prof_taken;
+#endif
 };
 
 /**
@@ -22,6 +22,7 @@
 
 #include "lib/assert.h"
 #include "lib/rwlock.h"
+#include "lib/lockprof.h"
 
 /**
    @addtogroup rwlock Read-write lock
@@ -32,12 +33,45 @@
    @{
  */
 
+#if M0_LOCKPROF_ENABLED
+/**
+   Takes the lock with "lock_fn", accounting the acquisition to call site
+   "site". Contention is detected by a failed "try_fn". The time the lock was
+   taken is returned in "taken", unless it is NULL.
+ */
+static struct m0_lockprof_site *
+rwlock_prof_lock(struct m0_rwlock *lock, enum m0_lockprof_kind kind,
+		 const void *site, int (*try_fn)(pthread_rwlock_t *),
+		 int (*lock_fn)(pthread_rwlock_t *), m0_time_t *taken)
+{
+	bool      contended;
+	m0_time_t start = 0;
+	m0_time_t now   = 0;
+	int       rc;
+
+	contended = try_fn(&lock->rw_lock) != 0;
+	if (contended) {
+		start = m0_time_now();
+		rc = lock_fn(&lock->rw_lock);
+		M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
+	}
+	if (contended || taken != NULL)
+		now = m0_time_now();
+	if (taken != NULL)
+		*taken = now;
+	return m0_lockprof_acquired(site, kind, contended, now - start);
+}
+#endif
+
 M0_INTERNAL void m0_rwlock_init(struct m0_rwlock *lock)
 {
 	int rc;
 
 	rc = pthread_rwlock_init(&lock->rw_lock, NULL);
 	M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
+#if M0_LOCKPROF_ENABLED
+	lock->rw_prof = NULL;
+#endif
 }
 
 M0_INTERNAL void m0_rwlock_fini(struct m0_rwlock *lock)
@@ -52,6 +86,16 @@ M0_INTERNAL void m0_rwlock_write_lock(struct m0_rwlock *lock)
 {
 	int rc;
 
+#if M0_LOCKPROF_ENABLED
+	if (m0_lockprof_is_enabled()) {
+		lock->rw_prof = rwlock_prof_lock(lock, M0_LPK_WRITE,
+						 __builtin_return_address(0),
+						 &pthread_rwlock_trywrlock,
+						 &pthread_rwlock_wrlock,
+						 &lock->rw_prof_taken);
+		return;
+	}
+#endif
 	rc = pthread_rwlock_wrlock(&lock->rw_lock);
 	M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
 }
@@ -60,6 +104,14 @@ M0_INTERNAL void m0_rwlock_write_unlock(struct m0_rwlock *lock)
 {
 	int rc;
 
+#if M0_LOCKPROF_ENABLED
+	struct m0_lockprof_site *site = lock->rw_prof;
+
+	if (site != NULL) {
+		lock->rw_prof = NULL;
+		m0_lockprof_released(site, m0_time_now() - lock->rw_prof_taken);
+	}
+#endif
 	rc = pthread_rwlock_unlock(&lock->rw_lock);
 	M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
 }
@@ -68,6 +120,16 @@ void m0_rwlock_read_lock(struct m0_rwlock *lock)
 {
 	int rc;
 
+#if M0_LOCKPROF_ENABLED
+	if (m0_lockprof_is_enabled()) {
+		/* Readers do not record their hold time, see lib/lockprof.h. */
+		(void)rwlock_prof_lock(lock, M0_LPK_READ,
+				       __builtin_return_address(0),
+				       &pthread_rwlock_tryrdlock,
+				       &pthread_rwlock_rdlock, NULL);
+		return;
+	}
+#endif
 	rc = pthread_rwlock_rdlock(&lock->rw_lock);
 	M0_ASSERT_INFO(rc == 0, "rc=%d", rc);
 }
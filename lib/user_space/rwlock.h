@@ -33,11 +33,19 @@
 */
 
 #include <pthread.h>
+#include "lib/lockprof.h"                /* M0_LOCKPROF_ENABLED */
+
 /**
    Blocking read-write lock.
  */
 struct m0_rwlock {
-        pthread_rwlock_t rw_lock;
+        pthread_rwlock_t         rw_lock;
+#if M0_LOCKPROF_ENABLED
+        /** Profiler call site of the current writer. */
+        struct m0_lockprof_site *rw_prof;
+        /** When the current writer took the lock. */
+        m0_time_t                rw_prof_taken;
+#endif
 };
 
 /** @} end of rwlock group */
@@ -0,0 +1,158 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+
+#include "ut/ut.h"
+#include "lib/lockprof.h"
+#include "lib/mutex.h"
+#include "lib/rwlock.h"
+#include "lib/thread.h"
+#include "lib/errno.h"
+#include "lib/misc.h"                  /* M0_SET0 */
+
+enum {
+	LP_THREADS_NR = 8,
+	LP_ROUNDS_NR  = 1000
+};
+
+/* Fake call sites: only their addresses are used. */
+static char site_a;
+static char site_b;
+
+static struct m0_mutex  lp_mutex;
+static struct m0_rwlock lp_rwlock;
+
+static void sites_check(void)
+{
+	struct m0_lockprof_stats s;
+	struct m0_lockprof_site *site;
+	int                      rc;
+	int                      i;
+
+	m0_lockprof_reset();
+	rc = m0_lockprof_stats_get(&site_a, M0_LPK_MUTEX, &s);
+	M0_UT_ASSERT(rc == -ENOENT);
+
+	for (i = 0; i < 3; ++i) {
+		site = m0_lockprof_acquired(&site_a, M0_LPK_MUTEX, false, 0);
+		m0_lockprof_released(site, 10);
+	}
+	site = m0_lockprof_acquired(&site_a, M0_LPK_MUTEX, true,
+				    5 * M0_TIME_ONE_MSEC / 1000);
+	m0_lockprof_released(site, 2 * M0_TIME_ONE_MSEC);
+	(void)m0_lockprof_acquired(&site_a, M0_LPK_READ, true,
+				   2 * M0_TIME_ONE_SECOND);
+
+	rc = m0_lockprof_stats_get(&site_a, M0_LPK_MUTEX, &s);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(s.lps_addr == &site_a);
+	M0_UT_ASSERT(s.lps_kind == M0_LPK_MUTEX);
+	M0_UT_ASSERT(s.lps_acquired == 4);
+	M0_UT_ASSERT(s.lps_contended == 1);
+	M0_UT_ASSERT(s.lps_wait == 5000);
+	M0_UT_ASSERT(s.lps_wait_max == 5000);
+	M0_UT_ASSERT(s.lps_hold == 30 + 2 * M0_TIME_ONE_MSEC);
+	M0_UT_ASSERT(s.lps_hold_max == 2 * M0_TIME_ONE_MSEC);
+	/* 5us falls into [4us, 16us). */
+	M0_UT_ASSERT(s.lps_wait_hist[2] == 1);
+	M0_UT_ASSERT(s.lps_hold_hist[0] == 3);
+	/* 2ms falls into [1024us, 4096us). */
+	M0_UT_ASSERT(s.lps_hold_hist[6] == 1);
+
+	rc = m0_lockprof_stats_get(&site_a, M0_LPK_READ, &s);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(s.lps_acquired == 1 && s.lps_contended == 1);
+	M0_UT_ASSERT(s.lps_wait_hist[M0_LOCKPROF_HIST_NR - 1] == 1);
+	M0_UT_ASSERT(s.lps_hold == 0);
+
+	rc = m0_lockprof_stats_get(&site_a, M0_LPK_WRITE, &s);
+	M0_UT_ASSERT(rc == -ENOENT);
+	rc = m0_lockprof_stats_get(&site_b, M0_LPK_MUTEX, &s);
+	M0_UT_ASSERT(rc == -ENOENT);
+}
+
+static void lp_worker(int unused)
+{
+	int i;
+
+	for (i = 0; i < LP_ROUNDS_NR; ++i) {
+		m0_mutex_lock(&lp_mutex);
+		m0_mutex_unlock(&lp_mutex);
+		if (i % 4 == 0) {
+			m0_rwlock_write_lock(&lp_rwlock);
+			m0_rwlock_write_unlock(&lp_rwlock);
+		} else {
+			m0_rwlock_read_lock(&lp_rwlock);
+			m0_rwlock_read_unlock(&lp_rwlock);
+		}
+	}
+}
+
+static void hooks_check(void)
+{
+	struct m0_thread t[LP_THREADS_NR];
+	bool             on = m0_lockprof_is_enabled();
+	int              rc;
+	int              i;
+
+	M0_SET_ARR0(t);
+	m0_mutex_init(&lp_mutex);
+	m0_rwlock_init(&lp_rwlock);
+	m0_lockprof_enable(true);
+	for (i = 0; i < ARRAY_SIZE(t); ++i) {
+		rc = M0_THREAD_INIT(&t[i], int, NULL, &lp_worker, 0,
+				    "lockprof%d", i);
+		M0_UT_ASSERT(rc == 0);
+	}
+	for (i = 0; i < ARRAY_SIZE(t); ++i) {
+		m0_thread_join(&t[i]);
+		m0_thread_fini(&t[i]);
+	}
+	/* Pausing the profiler in the middle of a critical section is fine. */
+	m0_mutex_lock(&lp_mutex);
+	m0_lockprof_enable(false);
+	m0_mutex_unlock(&lp_mutex);
+	M0_UT_ASSERT(!m0_lockprof_is_enabled());
+	m0_lockprof_post();
+	m0_lockprof_enable(on);
+	m0_rwlock_fini(&lp_rwlock);
+	m0_mutex_fini(&lp_mutex);
+}
+
+void test_lockprof(void)
+{
+	sites_check();
+	hooks_check();
+}
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -36,6 +36,7 @@ extern void test_finject(void);
 extern void test_getopts(void);
 extern void test_list(void);
 extern void test_lockers(void);
+extern void test_lockprof(void);
 extern void test_memory(void);
 extern void m0_test_misc(void);
 extern void test_mutex(void);
@@ -80,6 +81,7 @@ struct m0_ut_suite libm0_ut = {
 		{ "locality",         test_locality,     "Nikita" },
 		{ "locality-chore",   test_locality_chore, "Nikita" },
 		{ "lockers",          test_lockers       },
+		{ "lockprof",         test_lockprof      },
 		{ "memory",           test_memory        },
 		{ "misc",             m0_test_misc       },
 		{ "mutex",            test_mutex         },
@@ -1198,8 +1198,11 @@ int m0_obj_lock_init(struct m0_obj *obj);
 
 /**
  * Finalizes the object lock and decreased the rm_ctx::rmc_ref::ref_cnt.
- * If the rm_ctx::rmc_ref::ref_cnt becomes 0, then finalize the
- * cached RM context.
+ * If the rm_ctx::rmc_ref::ref_cnt becomes 0, the RM context is kept idle
+ * together with the credits it has borrowed, so that locking the object
+ * again doesn't go to the creditor. Idle contexts are finalized, and their
+ * credits returned, after M0_RM_CTX_LEASE_SECS or when more than
+ * M0_RM_CTX_IDLE_MAX of them are kept.
  *
  * @pre   m0_obj_init()
  * @pre   m0_obj_lock_init()
@@ -1748,7 +1748,7 @@ int m0_client_init(struct m0_client **m0c_p,
 	m0__composite_container_init(m0c);
 
 	/* Init the hash-table for RM contexts */
-	rm_ctx_htable_init(&m0c->m0c_rm_ctxs, M0_RM_HBUCKET_NR);
+	m0_obj_lock_ctxs_init(m0c);
 
 	if (ENABLE_DTM0) {
 		struct m0_reqh_service *reqh_svc;
@@ -1874,7 +1874,7 @@ void m0_client_fini(struct m0_client *m0c, bool fini_m0)
 	}
 
 	/* Finalize hash-table for RM contexts */
-	rm_ctx_htable_fini(&m0c->m0c_rm_ctxs);
+	m0_obj_lock_ctxs_fini(m0c);
 
 	/* shut down this client instance */
 	m0_sm_group_lock(&m0c->m0c_sm_group);
@@ -92,6 +92,19 @@ enum {
 	M0_RM_HBUCKET_NR = 100
 };
 
+/**
+ * Limits of the idle RM lock context cache, see m0_obj_lock_fini().
+ */
+enum {
+	/** Maximal number of idle contexts kept. */
+	M0_RM_CTX_IDLE_MAX   = 256,
+	/**
+	 * Seconds an idle context keeps its cached credits, default of
+	 * m0_client::m0c_rm_ctx_lease.
+	 */
+	M0_RM_CTX_LEASE_SECS = 10,
+};
+
 enum m0__entity_states {
 	M0_ES_INIT = 1,
 	M0_ES_CREATING,
@@ -636,6 +649,27 @@ struct m0_client {
 
 	struct m0_htable                        m0c_rm_ctxs;
 
+	/**
+	 * Idle RM lock contexts, least recently used first. An idle context
+	 * is still in ->m0c_rm_ctxs and its owner keeps the credits it has
+	 * borrowed, so locking the object again is a local operation.
+	 * Protected by ->m0c_rm_ctx_lru_lock.
+	 */
+	struct m0_tl                            m0c_rm_ctx_lru;
+	uint32_t                                m0c_rm_ctx_lru_nr;
+	struct m0_mutex                         m0c_rm_ctx_lru_lock;
+	/** Time an idle context keeps its cached credits. */
+	m0_time_t                               m0c_rm_ctx_lease;
+	/**
+	 * Thread finalising the idle contexts whose lease has expired, so
+	 * that the credits are returned even if no other object is locked.
+	 */
+	struct m0_thread                        m0c_rm_ctx_reaper;
+	/** Wakes the reaper up before its period has passed. */
+	struct m0_semaphore                     m0c_rm_ctx_reaper_wake;
+	/** Flag used to make the reaper exit. */
+	bool                                    m0c_rm_ctx_reaper_active;
+
 	struct m0_dtm0_service                 *m0c_dtms;
 
 	struct m0_dtm0_domain                   m0c_dtm0_domain;
@@ -674,11 +708,28 @@ struct m0_rm_lock_ctx {
 	uint64_t                rmc_magic;
 	/** A generation count for cookie associated with this ctx. */
 	uint64_t                rmc_gen;
+	/** Linkage into m0_client::m0c_rm_ctx_lru while the ctx is idle. */
+	struct m0_tlink         rmc_lru_link;
+	uint64_t                rmc_lru_magic;
+	/** Time the ctx became idle. */
+	m0_time_t               rmc_idle_since;
 };
 
 /** Methods for hash-table holding rm_ctx for RM locks */
 M0_HT_DECLARE(rm_ctx, M0_INTERNAL, struct m0_rm_lock_ctx, struct m0_fid);
 
+/**
+ * Initialises the RM lock contexts of the client instance and starts the
+ * reaper of the idle ones.
+ */
+M0_INTERNAL void m0_obj_lock_ctxs_init(struct m0_client *m0c);
+
+/**
+ * Finalises the RM lock contexts of the client instance, returning the
+ * credits cached by the idle ones.
+ */
+M0_INTERNAL void m0_obj_lock_ctxs_fini(struct m0_client *m0c);
+
 /**
  * A wrapper structure over m0_rm_incoming.
  * It represents a request to borrow/sublet resource
@@ -395,6 +395,8 @@ static int motr_ha_level_enter(struct m0_module *module)
 				.hcf_addr        = mha->mh_cfg.mhc_addr,
 				.hcf_reqh        = mha->mh_cfg.mhc_reqh,
 				.hcf_process_fid = mha->mh_cfg.mhc_process_fid,
+				/* delivery callbacks ignore tags */
+				.hcf_nvec_coalesce = true,
 			                }));
 	case MOTR_HA_LEVEL_DISPATCHER:
 		return M0_RC(m0_ha_dispatcher_init(&mha->mh_dispatcher,
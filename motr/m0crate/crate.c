@@ -69,6 +69,9 @@ const bcnt_t cr_default_csum_size  = 16;
 const bcnt_t cr_default_key_size   = sizeof(struct m0_fid);
 const bcnt_t cr_default_max_ksize  = 1 << 10; /* default upper limit for key_size parameter. i.e 1KB */
 const bcnt_t cr_default_max_vsize  = 1 << 20; /* default upper limit for value_size parameter. i.e 1MB */
+const double cr_default_zipf_theta = 0.99;    /* YCSB default skew */
+const int    cr_default_hot_set    = 20;      /* 80% of ops go to ... */
+const int    cr_default_hot_ops    = 80;      /* ... 20% of the keys */
 static struct m0_be_seg *seg;
 static struct m0_btree *tree;
 uint8_t *rnode; /* Root Node */
@@ -86,6 +89,7 @@ const char *cr_workload_name[CWT_NR] = {
 	[CWT_IO]    = "io",
 	[CWT_INDEX] = "index",
 	[CWT_BTREE] = "btree",
+	[CWT_MIX]   = "mix",
 };
 
 static int hpcs_init  (struct workload *w);
@@ -173,6 +177,16 @@ static const struct workload_type_ops w_ops[CWT_NR] = {
 		.wto_parse  = btree_parse,
 		.wto_check  = btree_check
         },
+
+	[CWT_MIX] = {
+                .wto_init   = init,
+                .wto_fini   = fini,
+                .wto_run    = run_mix,
+                .wto_op_get = NULL,
+                .wto_op_run = m0_op_run_mix,
+		.wto_parse  = NULL,
+		.wto_check  = check
+        },
 };
 
 static void fletcher_2_native(void *buf, uint64_t size);
@@ -265,6 +279,9 @@ int workload_init(struct workload *w, enum cr_workload_type wtype)
         w->cw_fpattern  = strdup(cr_default_fpattern);
         w->cw_nr_dir    = cr_default_nr_dir;
         w->cw_read_frac = cr_default_read_frac;
+	w->cw_shape.cls_zipf_theta    = cr_default_zipf_theta;
+	w->cw_shape.cls_hot_set_prcnt = cr_default_hot_set;
+	w->cw_shape.cls_hot_ops_prcnt = cr_default_hot_ops;
 
 	/* set default values before yaml parsing */
 	if (wtype == CWT_INDEX) {
@@ -284,6 +301,7 @@ static void workload_fini(struct workload *w)
         wop(w)->wto_fini(w);
 	free(w->cw_buf);
 	free(w->cw_fpattern);
+	m0_free(w->cw_shape.cls_json);
         pthread_mutex_destroy(&w->cw_lock);
 }
 
@@ -367,7 +385,7 @@ static void *worker_thread(void *datum)
 	 * Motr can launch multiple operations in a single go.
 	 * Single operation in a loop won't work for Motr.
 	 */
-	if (w->cw_type == CWT_IO || w->cw_type == CWT_INDEX)
+	if (M0_IN(w->cw_type, (CWT_IO, CWT_INDEX, CWT_MIX)))
 		wop(w)->wto_op_run(w, wt, NULL);
 	else {
 		while (workload_op_get(w, &op) == 0)
@@ -433,8 +451,7 @@ static void workload_run(struct workload *w)
         cr_log(CLL_INFO, "random seed:           %u\n", w->cw_rstate);
         cr_log(CLL_INFO, "number of threads:     %u\n", w->cw_nr_thread);
 	/* Following params not applicable to IO and INDEX tests */
-	if (CWT_IO != w->cw_type && CWT_INDEX != w->cw_type &&
-	    CWT_BTREE != w->cw_type) {
+	if (!M0_IN(w->cw_type, (CWT_IO, CWT_INDEX, CWT_BTREE, CWT_MIX))) {
 		cr_log(CLL_INFO, "average size:          %llu\n", w->cw_avg);
 		cr_log(CLL_INFO, "maximal size:          %llu\n", w->cw_max);
 		/*
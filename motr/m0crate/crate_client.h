@@ -35,6 +35,7 @@
 #include "motr/client.h"
 #include "motr/m0crate/workload.h"
 #include "motr/m0crate/crate_utils.h"
+#include "motr/m0crate/crate_stats.h"
 
 struct crate_conf {
         /* Client parameters */
@@ -63,7 +64,8 @@ struct crate_conf {
 enum m0_operation_type {
 	OT_INDEX,
 	OT_IO,
-	OT_BTREE
+	OT_BTREE,
+	OT_MIX
 };
 
 enum cr_opcode {
@@ -117,6 +119,9 @@ struct m0_workload_index {
 	struct m0_fid		index_fid;
 
 	uint64_t		seed;
+
+	/** Per-opcode latencies of all threads, merged as they finish. */
+	struct cr_hist		hist[CRATE_OP_NR];
 };
 
 struct m0_workload_task {
@@ -156,6 +161,8 @@ struct cwi_global {
 	bool              cg_created;
 	int               cg_nr_tasks;
 	m0_time_t         cg_cwi_acc_time[CR_OPS_NR];
+	/** Per-operation latencies of all the tasks. */
+	struct cr_hist    cg_hist[CR_OPS_NR];
 	struct m0_mutex   cg_mutex;
 };
 
@@ -186,6 +193,59 @@ struct m0_workload_io {
 	m0_time_t         cwi_execution_time;
 	m0_time_t         cwi_time[CR_OPS_NR];
 	char             *cwi_filename;
+	const struct cr_load_shape *cwi_shape;
+};
+
+/** Classes of operations of the mixed workload, as issued by an S3 gateway. */
+enum cr_mix_class {
+	/** Create (or overwrite) an object, then PUT its record to the index. */
+	CMC_WRITE,
+	/** GET the record from the index, then read the object. */
+	CMC_READ,
+	/** NEXT over the index (bucket listing). */
+	CMC_LIST,
+	/** DEL the record from the index, then delete the object. */
+	CMC_DELETE,
+	CMC_NR
+};
+
+/** Client operations the classes are made of. */
+enum cr_mix_step {
+	CMS_CREATE,
+	CMS_OPEN,
+	CMS_WRITE,
+	CMS_READ,
+	CMS_DELETE,
+	CMS_KV_PUT,
+	CMS_KV_GET,
+	CMS_KV_NEXT,
+	CMS_KV_DEL,
+	CMS_NR
+};
+
+struct m0_workload_mix {
+	/** Share of each class in the operation stream, in percents. */
+	int               cwm_prcnt[CMC_NR];
+	uint32_t          cwm_layout_id;
+	struct m0_fid     cwm_pool_id;
+	/** Object size is cwm_bs * cwm_bcount_per_op. */
+	uint64_t          cwm_bs;
+	uint32_t          cwm_bcount_per_op;
+	/** Number of object slots (and index records) of each thread. */
+	int32_t           cwm_nr_objs;
+	/** Number of operations executed by each thread. */
+	int               cwm_op_count;
+	m0_time_t         cwm_execution_time;
+	int               cwm_next_records;
+	/** Index holding object records. */
+	struct m0_fid     cwm_index_fid;
+	m0_time_t         cwm_start_time;
+	uint64_t          cwm_ops_done[CMC_NR];
+	uint64_t          cwm_ops_failed[CMC_NR];
+	/** End-to-end latency of each class. */
+	struct cr_hist    cwm_class_hist[CMC_NR];
+	/** Latency of each client operation, whatever class it served. */
+	struct cr_hist    cwm_step_hist[CMS_NR];
 };
 
 struct cti_global {
@@ -209,6 +269,11 @@ struct m0_task_io {
 	struct m0_bufvec          *cti_rd_bufvec;
 	struct m0_uint128         *cti_ids;
 	m0_time_t                  cti_op_acc_time;
+	/** Latencies of the current phase, merged by cr_cti_report(). */
+	struct cr_hist             cti_hist;
+	struct cr_pacer            cti_pacer;
+	/** Block offsets of random I/O, when RAND_IO is set. */
+	struct cr_key_gen          cti_blocks;
 	struct cti_global          cti_g;
 	/** Limit op_launch to max_nr_ops */
 	struct m0_semaphore        cti_max_ops_sem;
@@ -221,6 +286,11 @@ void m0_op_run(struct workload *w, struct workload_task *task,
 void run_index(struct workload *w, struct workload_task *tasks);
 void m0_op_run_index(struct workload *w, struct workload_task *task,
 			 const struct workload_op *op);
+void run_mix(struct workload *w, struct workload_task *tasks);
+void m0_op_run_mix(struct workload *w, struct workload_task *task,
+		   const struct workload_op *op);
+int create_index(struct m0_uint128 id);
+void set_idx_flags(struct m0_op *op);
 
 
 /** @} end of crate group */
@@ -102,6 +102,14 @@ extern struct crate_conf *conf;
  * * KEY_ORDER - defines key ordering in operations ("ordered" or "random").
  * * INDEX_FID - index fid (fid, for example, `<7800000000000001:0>`).
  * * LOG_LEVEL - logging level(err(0), warn(1), info(2), trace(3), debug(4)).
+ * * ARRIVAL_RATE - operations per second issued by each thread; 0 (default)
+ *	issues the next operation as soon as the previous one completes.
+ * * KEY_DIST - popularity of keys picked for GET, NEXT and DEL in random
+ *	order: uniform (default), zipf or hotset.
+ * * ZIPF_THETA - skew of the zipf distribution, in (0, 1), 0.99 by default.
+ * * HOT_SET_PRCNT, HOT_OPS_PRCNT - HOT_OPS_PRCNT% of operations go to the
+ *	first HOT_SET_PRCNT% of keys (20 and 80 by default).
+ * * RESULTS_JSON - file to append JSON results to ("-" for stdout).
  *
  *
  * ## Operation order (see ::cr_idx_w_select_op)
@@ -124,15 +132,19 @@ extern struct crate_conf *conf;
  *
  * ### ::cr_idx_w_find_rnd_k
  * This function selects random key, puts it in the key list and does it again
- * until list is full or bitmap is full.
+ * until list is full or bitmap is full. Operations on existing keys draw them
+ * from KEY_DIST, PUT always looks for free keys uniformly.
  *
  * ## Different logic for different operations (see struct ::cr_idx_w_ops).
  * This struct describes how operation should be prepared for execution and
  * how they change storage state.
  *
  * ## Measurements
- * Currently, only execution time is measured during the test. It measures with
- * `m0_time*` functions. Crate prints result to stdout when test is finished.
+ * Execution time of every operation is measured with `m0_time*` functions and
+ * recorded in a per-opcode latency histogram (see ::cr_hist), warmup
+ * operations excluded. With ARRIVAL_RATE set, latency counts from the
+ * scheduled start of the operation, so time spent behind a slow operation is
+ * not lost. Crate prints result to stdout when test is finished.
  *
  * ## Logging
  * crate has own logging system, which based on `fprintf(stderr...)`.
@@ -353,10 +365,19 @@ struct cr_idx_w {
 	size_t				exec_time;
 	enum cr_op_selector		op_selector;
 	struct cr_idx_w_results	        ciw_results;
+	/** Keys for random operations on existing records. */
+	struct cr_key_gen		keys;
+	struct cr_pacer			pacer;
+	/** Scheduled start of the next operation, 0 if not paced. */
+	m0_time_t			op_sched;
+	/** Warmup operations are not recorded in the histograms. */
+	bool				warmup;
+	struct cr_hist			hist[CRATE_OP_NR];
 };
 
 static int cr_idx_w_init(struct cr_idx_w *ciw,
-			 struct m0_workload_index *wit);
+			 struct m0_workload_index *wit,
+			 const struct cr_load_shape *ls);
 static void cr_idx_w_fini(struct cr_idx_w *ciw);
 static void cr_idx_w_seq_keys_init(struct cr_idx_w *w, int keys_nr);
 static void cr_idx_w_seq_keys_fini(struct cr_idx_w *w);
@@ -433,6 +454,18 @@ static void cr_time_measure_report(struct cr_time_measure_ctx *t,
 			op_results[i].cior_op_count);
 	}
 
+	for (i = 0; i < CRATE_OP_NR; i++) {
+		if (w.hist[i].ch_count == 0)
+			continue;
+		fprintf(stdout, "result: %s, p50_ns, %" PRIu64 ", p99_ns, "
+			"%" PRIu64 ", p999_ns, %" PRIu64 ", max_ns, %" PRIu64
+			"\n", op_results[i].cior_op_label,
+			cr_hist_percentile(&w.hist[i], 50.0),
+			cr_hist_percentile(&w.hist[i], 99.0),
+			cr_hist_percentile(&w.hist[i], 99.9),
+			w.hist[i].ch_max);
+	}
+
 	/* Results in m0crate format */
 	fprintf(stdout, "\nTotal: time="TIME_F" ("TIME_F" per op) ops=%d\n",
                        TIME_P(w.ciw_results.ciwr_total_time_m0),
@@ -456,7 +489,8 @@ static void cr_time_measure_report(struct cr_time_measure_ctx *t,
 /* IMPLEMENTATION */
 
 static int cr_idx_w_init(struct cr_idx_w *ciw,
-			 struct m0_workload_index *wit)
+			 struct m0_workload_index *wit,
+			 const struct cr_load_shape *ls)
 {
 	int rc;
 	int i;
@@ -473,6 +507,12 @@ static int cr_idx_w_init(struct cr_idx_w *ciw,
 	/* Setting up min_key_size default to MIN_KEY_SIZE */
 	ciw->wit->min_key_size = CR_MIN_KEY_SIZE;
 
+	for (i = 0; i < CRATE_OP_NR; i++) {
+		rc = cr_hist_init(&ciw->hist[i]);
+		if (rc != 0)
+			goto err;
+	}
+
 	/* Init crate index result */
 	for (i = 0; i < CRATE_OP_NR; i++) {
 		ciw->ciw_results.ciwr_ops_result[i].cior_op_label =
@@ -519,9 +559,14 @@ static int cr_idx_w_init(struct cr_idx_w *ciw,
 	else
 		ciw->warmup_del_cnt = 0;
 
+	rc = cr_key_gen_init(&ciw->keys, ls, ciw->nr_keys);
+	if (rc != 0)
+		goto err;
+	cr_pacer_init(&ciw->pacer, ls->cls_rate);
+
 	rc = m0_bitmap_init(&ciw->bm, ciw->nr_keys);
 	if (rc != 0)
-		return M0_ERR(rc);
+		goto err;
 
 	srand(wit->seed);
 
@@ -552,6 +597,11 @@ static int cr_idx_w_init(struct cr_idx_w *ciw,
 	M0_POST(ciw->nr_keys > 0);
 
 	return M0_RC(0);
+err:
+	/* cr_hist_fini() is idempotent: the caller may fini them again. */
+	for (i = 0; i < CRATE_OP_NR; i++)
+		cr_hist_fini(&ciw->hist[i]);
+	return M0_ERR(rc);
 }
 
 static void cr_idx_w_fini(struct cr_idx_w *ciw)
@@ -954,7 +1004,8 @@ static int cr_idx_w_find_rnd_k(struct cr_idx_w *w,
 			break;
 		}
 
-		r = cr_rand_pos_range_l(w->nr_keys);
+		r = op->empty_bit ? cr_key_gen_next(&w->keys) :
+				    cr_rand_pos_range_l(w->nr_keys);
 		M0_ASSERT(r < w->nr_keys);
 		attempts++;
 
@@ -1143,12 +1194,15 @@ static int cr_idx_w_execute(struct cr_idx_w *w,
 		goto do_exit_kv;
 	}
 	/* accumulate time required by each op on opcode basis. */
-	op_start_time = m0_time_now();
+	op_start_time = w->op_sched ?: m0_time_now();
+	w->op_sched = 0;
 	rc = cr_execute_query(&w->wit->index_fid, &kv, opcode);
 	op_time = m0_time_sub(m0_time_now(), op_start_time);
 	w->ciw_results.ciwr_ops_result[opcode].cior_ops_total_time_m0 =
 			m0_time_add(w->ciw_results.ciwr_ops_result[opcode].cior_ops_total_time_m0,
 			op_time);
+	if (rc == 0 && !w->warmup)
+		cr_hist_record(&w->hist[opcode], op_time);
 	if (rc != 0) {
 		rc = M0_ERR(rc);
 		goto do_exit_kv;
@@ -1311,6 +1365,7 @@ static int cr_idx_w_common(struct cr_idx_w *w)
 		nr_kv_per_op = cr_idx_w_get_nr_keys_per_op(w, op);
 		crlog(CLL_DEBUG, "nr_kv_per_op: %d", nr_kv_per_op);
 
+		w->op_sched = cr_pacer_wait(&w->pacer);
 		rc = cr_idx_w_execute(w, op, is_random, nr_kv_per_op,
 				      &missing_key);
 		if (rc != 0) {
@@ -1333,6 +1388,7 @@ static int cr_idx_w_warmup(struct cr_idx_w *w)
 	int rc = 0;
 	int i;
 
+	w->warmup = true;
 	for (i = 0; i < w->warmup_put_cnt && rc == 0; i++) {
 		m0_bitmap_print(&w->bm);
 		rc = cr_idx_w_execute(w, CRATE_OP_PUT, false,
@@ -1344,6 +1400,7 @@ static int cr_idx_w_warmup(struct cr_idx_w *w)
 		rc = cr_idx_w_execute(w, CRATE_OP_DEL, true,
 				      w->nr_kv_per_op, NULL);
 	}
+	w->warmup = false;
 
 	return M0_RC(rc);
 }
@@ -1391,7 +1448,7 @@ static M0_UNUSED int delete_index(struct m0_uint128 id)
 }
 
 
-static int create_index(struct m0_uint128 id)
+int create_index(struct m0_uint128 id)
 {
 	int            rc;
 	struct m0_op  *ops[1] = { NULL };
@@ -1528,6 +1585,7 @@ static int index_operation(struct workload *wt,
 	struct m0_workload_index     *wit = wt->u.cw_index;
 	struct m0_uint128             index_fid;
 	int                           rc;
+	int                           i;
 
 	M0_PRE(crate_uber_realm() != NULL);
 	M0_PRE(crate_uber_realm()->re_instance != NULL);
@@ -1543,7 +1601,7 @@ static int index_operation(struct workload *wt,
 			goto do_exit;
 	}
 
-	rc = cr_idx_w_init(&w, wit);
+	rc = cr_idx_w_init(&w, wit, &wt->cw_shape);
 	if (rc != 0)
 		goto do_exit_wg;
 
@@ -1572,14 +1630,35 @@ do_exit_wg:
 	cr_time_measure_end(&t);
 	cr_time_capture_results(&t, &w);
 	cr_time_measure_report(&t, w);
+	pthread_mutex_lock(&wt->cw_lock);
+	for (i = 0; i < CRATE_OP_NR; i++)
+		cr_hist_merge(&wit->hist[i], &w.hist[i]);
+	pthread_mutex_unlock(&wt->cw_lock);
+	for (i = 0; i < CRATE_OP_NR; i++)
+		cr_hist_fini(&w.hist[i]);
 do_exit:
 	return M0_RC(rc);
 }
 
 void run_index(struct workload *w, struct workload_task *tasks)
 {
+	struct m0_workload_index *wit = w->u.cw_index;
+	m0_time_t                 start;
+	int                       i;
+	int                       rc = 0;
+
+	for (i = 0; i < CRATE_OP_NR && rc == 0; i++)
+		rc = cr_hist_init(&wit->hist[i]);
+	if (rc != 0)
+		crlog(CLL_WARN, "No memory for latency histograms.");
+
+	start = m0_time_now();
 	workload_start(w, tasks);
 	workload_join(w, tasks);
+	cr_stats_json(w, m0_time_sub(m0_time_now(), start), wit->hist,
+		      (const char **)cr_idx_op_labels, CRATE_OP_NR);
+	for (i = 0; i < CRATE_OP_NR; i++)
+		cr_hist_fini(&wit->hist[i]);
 }
 
 void m0_op_run_index(struct workload *w, struct workload_task *task,
@@ -67,9 +67,21 @@
  * * EXEC_TIME - time limit for executing (seconds or "unlimited").
  * * NR_ROUNDS:  - How many times this workload to be executed.
  *
+ * ## Load shape
+ * * ARRIVAL_RATE - operations per second issued by each thread. When set,
+ *	operations are launched on a fixed schedule (open loop) and latency
+ *	is measured from the scheduled start rather than the actual one.
+ * * KEY_DIST - distribution of random block offsets: uniform (default),
+ *	zipf (skew ZIPF_THETA) or hotset (HOT_OPS_PRCNT% of operations hit
+ *	the first HOT_SET_PRCNT% of the object).
+ * * RESULTS_JSON - file to append per-workload JSON results to ("-" for
+ *	stdout).
+ *
  * ## Measurements
- * Currently, only execution time is measured during the test. It measures with
- * `m0_time*` functions. Crate prints result to stdout when test is finished.
+ * Execution time and per-operation latency are measured with `m0_time*`
+ * functions. Latencies are collected in per-task histograms (see
+ * ::cr_hist), so that percentiles are reported along with the averages.
+ * Crate prints result to stdout when test is finished.
  * ## Logging
  * crate has own logging system, which based on `fprintf(stderr...)`.
  * (see ::crlog and see ::cr_log).
@@ -127,22 +139,16 @@ typedef int (*cr_operation_t)(struct m0_workload_io *cwi,
 			      int                    obj_idx,
 			      int                    op_index);
 
-/**
- * Get pseudo-random uint64 in positive range [0;end)
- * client index workload has a similar function.
- * That function should be in utility and this should be deleted.
- */
-static size_t cr_rand___range_l(size_t end)
-{
-	size_t val_h;
-	size_t val_l;
-	size_t res;
-
-	val_l = rand();
-	val_h = rand();
-	res = (val_h << 32) | val_l;
-	return res % end;
-}
+static const char *cr_io_op_labels[CR_OPS_NR] = {
+	[CR_CREATE]    = "create",
+	[CR_OPEN]      = "open",
+	[CR_WRITE]     = "write",
+	[CR_READ]      = "read",
+	[CR_DELETE]    = "delete",
+	[CR_POPULATE]  = "populate",
+	[CR_CLEANUP]   = "cleanup",
+	[CR_READ_ONLY] = "read_only"
+};
 
 void cr_time_acc(m0_time_t *t1, m0_time_t t2)
 {
@@ -166,6 +172,7 @@ void cr_op_stable(struct m0_op *op)
 		op_time = m0_time_sub(op_context->coc_op_finish,
 				      op_context->coc_op_launch);
 		cr_time_acc(&cti->cti_op_acc_time, op_time);
+		cr_hist_record(&cti->cti_hist, op_time);
 		m0_semaphore_up(&cti->cti_max_ops_sem);
 		op_context->coc_buf_vec = NULL;
 	}
@@ -254,7 +261,6 @@ int cr_io_vector_prep(struct m0_workload_io *cwi,
 	uint64_t            nr_segments;
 	uint64_t            start_offset;
 	uint64_t            op_start_offset = 0;
-	size_t              rand_offset;
 	uint64_t            io_size = cwi->cwi_io_size;
 	uint64_t            offset;
 	struct m0_bufvec   *buf_vec = NULL;
@@ -295,15 +301,9 @@ int cr_io_vector_prep(struct m0_workload_io *cwi,
 	for (i = 0; i < cwi->cwi_bcount_per_op; i ++) {
 		if (cwi->cwi_random_io) {
 			do {
-				/* Generate the random offset. */
-				rand_offset = cr_rand___range_l(io_size);
-				/*
-				 * m0_round_down() would prevent partially
-				 * overlapping indexvec segments.
-				 */
-				offset = m0_round_down(rand_offset,
-						       cwi->cwi_bs);
-				bitmap_index = offset / cwi->cwi_bs;
+				/* Pick a block as per KEY_DIST. */
+				bitmap_index = cr_key_gen_next(&cti->cti_blocks);
+				offset = bitmap_index * cwi->cwi_bs;
 			} while (m0_bitmap_get(&segment_indices, bitmap_index));
 
 			m0_bitmap_set(&segment_indices, bitmap_index, true);
@@ -455,8 +455,10 @@ int cr_execute_ops(struct m0_workload_io *cwi, struct m0_task_io *cti,
 	int                   idx;
 	struct m0_op_context *op_ctx;
 	cr_operation_t        spec_op;
+	m0_time_t             sched;
 
 	for (i = 0; i < cti->cti_nr_ops; i++) {
+		sched = cr_pacer_wait(&cti->cti_pacer);
 		m0_semaphore_down(&cti->cti_max_ops_sem);
 		/* We can launch at least one more operation. */
 		idx = cr_free_op_idx(cti, cwi->cwi_max_nr_ops);
@@ -478,7 +480,7 @@ int cr_execute_ops(struct m0_workload_io *cwi, struct m0_task_io *cti,
 		cti->cti_ops[idx]->op_datum = op_ctx;
 		m0_op_setup(cti->cti_ops[idx], cbs, 0);
 		cti->cti_op_status[idx] = CR_OP_EXECUTING;
-		op_ctx->coc_op_launch = m0_time_now();
+		op_ctx->coc_op_launch = sched ?: m0_time_now();
 		m0_op_launch(&cti->cti_ops[idx], 1);
 	}
 	return rc;
@@ -491,8 +493,10 @@ void cr_cti_report(struct m0_task_io *cti, enum m0_operations op_code)
 	m0_mutex_lock(&cwi->cwi_g.cg_mutex);
 	cr_time_acc(&cwi->cwi_g.cg_cwi_acc_time[op_code], cti->cti_op_acc_time);
 	cwi->cwi_ops_done[op_code] += cti->cti_nr_ops_done;
+	cr_hist_merge(&cwi->cwi_g.cg_hist[op_code], &cti->cti_hist);
 	m0_mutex_unlock(&cwi->cwi_g.cg_mutex);
 
+	cr_hist_reset(&cti->cti_hist);
 	cti->cti_op_acc_time = 0;
 	cti->cti_nr_ops_done = 0;
 }
@@ -504,6 +508,7 @@ int cr_op_namei(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 	int                   idx;
 	m0_time_t             stime;
 	m0_time_t             etime;
+	m0_time_t             sched;
 	struct m0_op_context *op_ctx;
 	struct m0_op_ops     *cbs;
 	cr_operation_t        spec_op;
@@ -520,9 +525,11 @@ int cr_op_namei(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 	       op_code == CR_CREATE ? "Creating" :
 	       op_code == CR_OPEN ? "Opening" : "Deleting");
 	m0_semaphore_init(&cti->cti_max_ops_sem, cwi->cwi_max_nr_ops);
+	cr_pacer_init(&cti->cti_pacer, cwi->cwi_shape->cls_rate);
 	stime = m0_time_now();
 
 	for (i = 0; i < cwi->cwi_nr_objs; i++) {
+		sched = cr_pacer_wait(&cti->cti_pacer);
 		m0_semaphore_down(&cti->cti_max_ops_sem);
 		/* We can launch at least one more operation. */
 		idx = cr_free_op_idx(cti, cwi->cwi_max_nr_ops);
@@ -538,7 +545,7 @@ int cr_op_namei(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 		cti->cti_ops[idx]->op_datum = op_ctx;
 		m0_op_setup(cti->cti_ops[idx], cbs, 0);
 		cti->cti_op_status[idx] = CR_OP_EXECUTING;
-		op_ctx->coc_op_launch = m0_time_now();
+		op_ctx->coc_op_launch = sched ?: m0_time_now();
 		m0_op_launch(&cti->cti_ops[idx], 1);
 	}
 	/* Task is done. Wait for all operations to complete. */
@@ -607,6 +614,7 @@ int cr_op_io(struct m0_workload_io  *cwi, struct m0_task_io *cti,
 	       TIME_P(m0_time_now()), cti->cti_task_idx,
 	       op_code == CR_WRITE ? "Writing" : "Reading");
 	m0_semaphore_init(&cti->cti_max_ops_sem, cwi->cwi_max_nr_ops);
+	cr_pacer_init(&cti->cti_pacer, cwi->cwi_shape->cls_rate);
 	stime = m0_time_now();
 
 	for (i = 0; i < cwi->cwi_nr_objs; i++) {
@@ -836,6 +844,7 @@ void cr_task_io_cleanup(struct m0_task_io **cti_p)
 	m0_free(cti->cti_rd_bufvec);
 	m0_free(cti->cti_op_status);
 	m0_free(cti->cti_op_rcs);
+	cr_hist_fini(&cti->cti_hist);
 	m0_free0(cti_p);
 }
 
@@ -884,12 +893,23 @@ int cr_task_prep_one(struct m0_workload_io *cwi,
 	cti->cti_cwi = cwi;
 	cti->cti_progress = 0;
 
+	rc = cr_hist_init(&cti->cti_hist);
+	if (rc != 0)
+		goto error_rc;
+
 	if (cwi->cwi_opcode != CR_CLEANUP) {
 		cti->cti_nr_ops = (cwi->cwi_io_size /
 				  (cwi->cwi_bs * cwi->cwi_bcount_per_op)) ?: 1;
 		rc = cr_task_prep_bufs(cwi, cti);
 		if (rc != 0)
 			goto error_rc;
+		if (cwi->cwi_random_io) {
+			rc = cr_key_gen_init(&cti->cti_blocks, cwi->cwi_shape,
+					     (cwi->cwi_io_size + cwi->cwi_bs -
+					      1) / cwi->cwi_bs);
+			if (rc != 0)
+				goto error_rc;
+		}
 	}
 
 	M0_ALLOC_ARR(cti->cti_ids, cwi->cwi_nr_objs);
@@ -1010,6 +1030,14 @@ static uint64_t bw(uint64_t bytes, m0_time_t time)
 	return bytes * M0_TIME_ONE_MSEC / (time / 1000);
 }
 
+static void cr_io_hists_fini(struct m0_workload_io *cwi)
+{
+	int i;
+
+	for (i = 0; i < CR_OPS_NR; i++)
+		cr_hist_fini(&cwi->cwi_g.cg_hist[i]);
+}
+
 void run(struct workload *w, struct workload_task *tasks)
 {
 	int                    i;
@@ -1020,6 +1048,15 @@ void run(struct workload *w, struct workload_task *tasks)
 	struct m0_uint128      start_obj_id;
 
 	start_obj_id = cwi->cwi_start_obj_id;
+	cwi->cwi_shape = &w->cw_shape;
+	for (i = 0; i < CR_OPS_NR; i++) {
+		rc = cr_hist_init(&cwi->cwi_g.cg_hist[i]);
+		if (rc != 0) {
+			cr_io_hists_fini(cwi);
+			cr_log(CLL_ERROR, "Histogram allocation failed.\n");
+			return;
+		}
+	}
 	m0_mutex_init(&cwi->cwi_g.cg_mutex);
 	cwi->cwi_start_time = m0_time_now();
 	if (M0_IN(cwi->cwi_opcode, (CR_POPULATE, CR_CLEANUP)) &&
@@ -1032,6 +1069,7 @@ void run(struct workload *w, struct workload_task *tasks)
 		if (rc != 0) {
 			cr_tasks_release(w, tasks);
 			m0_mutex_fini(&cwi->cwi_g.cg_mutex);
+			cr_io_hists_fini(cwi);
 			cr_log(CLL_ERROR, "Task preparation failed.\n");
 			return;
 		}
@@ -1072,26 +1110,31 @@ void run(struct workload *w, struct workload_task *tasks)
 		       TIME_P(cwi->cwi_time[CR_DELETE]),
 		       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_DELETE] /
 			      cwi->cwi_ops_done[CR_DELETE]));
-	if (cwi->cwi_ops_done[CR_WRITE] == 0)
-		return;
-	written = cwi->cwi_bs * cwi->cwi_bcount_per_op *
-	          cwi->cwi_ops_done[CR_WRITE];
-	cr_log(CLL_INFO, "W: "TIME_F" ("TIME_F" per op), "
-	       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
-	       TIME_P(cwi->cwi_time[CR_WRITE]),
-	       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_WRITE] /
-		      cwi->cwi_ops_done[CR_WRITE]), written/1024,
-	       bw(written, cwi->cwi_time[CR_WRITE]) /1024);
-	if (cwi->cwi_ops_done[CR_READ] == 0)
-		return;
-	read = cwi->cwi_bs * cwi->cwi_bcount_per_op *
-	       cwi->cwi_ops_done[CR_READ];
-	cr_log(CLL_INFO, "R: "TIME_F" ("TIME_F" per op), "
-	       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
-	       TIME_P(cwi->cwi_time[CR_READ]),
-	       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_READ] /
-		      cwi->cwi_ops_done[CR_READ]), read/1024,
-	       bw(read, cwi->cwi_time[CR_READ]) /1024);
+	if (cwi->cwi_ops_done[CR_WRITE] != 0) {
+		written = cwi->cwi_bs * cwi->cwi_bcount_per_op *
+			  cwi->cwi_ops_done[CR_WRITE];
+		cr_log(CLL_INFO, "W: "TIME_F" ("TIME_F" per op), "
+		       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
+		       TIME_P(cwi->cwi_time[CR_WRITE]),
+		       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_WRITE] /
+			      cwi->cwi_ops_done[CR_WRITE]), written/1024,
+		       bw(written, cwi->cwi_time[CR_WRITE]) /1024);
+	}
+	if (cwi->cwi_ops_done[CR_READ] != 0) {
+		read = cwi->cwi_bs * cwi->cwi_bcount_per_op *
+		       cwi->cwi_ops_done[CR_READ];
+		cr_log(CLL_INFO, "R: "TIME_F" ("TIME_F" per op), "
+		       "%" PRIu64 " KiB, %" PRIu64 " KiB/s\n",
+		       TIME_P(cwi->cwi_time[CR_READ]),
+		       TIME_P(cwi->cwi_g.cg_cwi_acc_time[CR_READ] /
+			      cwi->cwi_ops_done[CR_READ]), read/1024,
+		       bw(read, cwi->cwi_time[CR_READ]) /1024);
+	}
+	for (i = 0; i < CR_OPS_NR; i++)
+		cr_hist_log(&cwi->cwi_g.cg_hist[i], cr_io_op_labels[i]);
+	cr_stats_json(w, m0_time_sub(cwi->cwi_finish_time, cwi->cwi_start_time),
+		      cwi->cwi_g.cg_hist, cr_io_op_labels, CR_OPS_NR);
+	cr_io_hists_fini(cwi);
 }
 
 void m0_op_run(struct workload *w, struct workload_task *task,
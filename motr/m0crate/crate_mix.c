@@ -0,0 +1,656 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2017-2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/** @defgroup mix_workload Mixed object and index workload.
+ * \ingroup crate
+ *
+ * Crate mixed workload overview.
+ * -------------------------------
+ *
+ * Object and index workloads (see @ref io_workload and @ref dix_workload)
+ * each drive a single kind of operations. The mixed workload issues both
+ * from the same threads, correlated the way an S3 gateway does it:
+ *
+ * * WRITE  - create the object (or open an existing one), write it, then PUT
+ *	its record (key -> object id) to the index;
+ * * READ   - GET the record from the index, then open and read the object;
+ * * LIST   - NEXT over the index from a random key (bucket listing);
+ * * DELETE - DEL the record from the index, then delete the object.
+ *
+ * Each thread owns NR_OBJS object slots. Slots are picked as per KEY_DIST. A
+ * READ or DELETE which picks an empty slot is turned into a WRITE, so the
+ * store fills up the way a fresh bucket does.
+ *
+ * ## Workload parameters
+ *
+ * * WORKLOAD_TYPE: 3.
+ * * PUT, GET, NEXT, DEL - share of WRITE, READ, LIST and DELETE operations,
+ *	in percents (must sum up to 100).
+ * * BLOCK_SIZE, BLOCKS_PER_OP - object size is BLOCK_SIZE * BLOCKS_PER_OP.
+ * * NR_OBJS - number of object slots per thread.
+ * * OP_COUNT - number of operations per thread.
+ * * EXEC_TIME - time limit (seconds or "unlimited").
+ * * NXRECORDS - number of records returned by a LIST.
+ * * INDEX_FID - index holding object records.
+ * * POOL_FID - pool to create objects in.
+ * * ARRIVAL_RATE, KEY_DIST, ZIPF_THETA, HOT_SET_PRCNT, HOT_OPS_PRCNT,
+ *	RESULTS_JSON - as for the other client workloads.
+ *
+ * ## Measurements
+ * End-to-end latency is recorded per class. Latency of every client
+ * operation is recorded per step (object create, write, index put, ...),
+ * whatever class issued it, so that interference between object I/O and
+ * index traffic shows up as a shift of the step tails against the
+ * single-kind workloads.
+ *
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "lib/memory.h"
+#include "lib/trace.h"
+#include "motr/client.h"
+#include "motr/client_internal.h"
+
+#include "motr/m0crate/logger.h"
+#include "motr/m0crate/workload.h"
+#include "motr/m0crate/crate_client.h"
+#include "motr/m0crate/crate_client_utils.h"
+
+/** Logger prefix for the mixed workload */
+#define LOG_PREFIX "mix: "
+
+extern struct crate_conf *conf;
+extern struct m0_fid      dix_pool_ver;
+
+static const char *cr_mix_class_labels[CMC_NR] = {
+	[CMC_WRITE]  = "write",
+	[CMC_READ]   = "read",
+	[CMC_LIST]   = "list",
+	[CMC_DELETE] = "delete"
+};
+
+static const char *cr_mix_step_labels[CMS_NR] = {
+	[CMS_CREATE]  = "obj_create",
+	[CMS_OPEN]    = "obj_open",
+	[CMS_WRITE]   = "obj_write",
+	[CMS_READ]    = "obj_read",
+	[CMS_DELETE]  = "obj_delete",
+	[CMS_KV_PUT]  = "kv_put",
+	[CMS_KV_GET]  = "kv_get",
+	[CMS_KV_NEXT] = "kv_next",
+	[CMS_KV_DEL]  = "kv_del"
+};
+
+struct cr_mix_slot {
+	struct m0_uint128 cms_id;
+	bool              cms_live;
+};
+
+/** State of a thread running the mixed workload. */
+struct cr_mix_task {
+	struct m0_workload_mix *cmt_cwm;
+	uint64_t                cmt_tid;
+	struct cr_mix_slot     *cmt_slots;
+	/** Id given to the next created object. */
+	struct m0_uint128       cmt_next_id;
+	struct m0_bufvec        cmt_data;
+	struct m0_indexvec      cmt_ext;
+	struct cr_key_gen       cmt_keys;
+	struct cr_pacer         cmt_pacer;
+	/** Whether step latencies are recorded (not during cleanup). */
+	bool                    cmt_measure;
+	struct cr_hist          cmt_class[CMC_NR];
+	struct cr_hist          cmt_step[CMS_NR];
+	uint64_t                cmt_done[CMC_NR];
+	uint64_t                cmt_failed[CMC_NR];
+};
+
+typedef int (*cr_mix_op_t)(struct cr_mix_task *t, int slot);
+
+/* CLIENT OPERATIONS */
+
+/**
+ * Launches @op, waits for it and records its latency as @step. @rc is the
+ * result of the operation initialisation, @op is released in any case.
+ */
+static int mix_op_exec(struct cr_mix_task *t, enum cr_mix_step step,
+		       struct m0_op *op, int rc)
+{
+	m0_time_t start;
+
+	if (rc == 0) {
+		start = m0_time_now();
+		m0_op_launch(&op, 1);
+		rc = m0_op_wait(op, M0_BITS(M0_OS_FAILED, M0_OS_STABLE),
+				M0_TIME_NEVER) ?: m0_rc(op);
+		if (rc == 0 && t->cmt_measure)
+			cr_hist_record(&t->cmt_step[step],
+				       m0_time_sub(m0_time_now(), start));
+	}
+	if (op != NULL) {
+		m0_op_fini(op);
+		m0_op_free(op);
+	}
+	return rc;
+}
+
+static struct m0_fid *mix_pool(struct m0_workload_mix *cwm)
+{
+	return m0_fid_is_set(&cwm->cwm_pool_id) &&
+	       m0_fid_is_valid(&cwm->cwm_pool_id) ? &cwm->cwm_pool_id : NULL;
+}
+
+static void mix_obj_init(struct cr_mix_task *t, struct m0_obj *obj,
+			 const struct m0_uint128 *id)
+{
+	M0_SET0(obj);
+	m0_obj_init(obj, crate_uber_realm(), id, t->cmt_cwm->cwm_layout_id);
+}
+
+static int mix_obj_create(struct cr_mix_task *t, struct m0_obj *obj)
+{
+	struct m0_op *op = NULL;
+	int           rc;
+
+	rc = m0_entity_create(mix_pool(t->cmt_cwm), &obj->ob_entity, &op);
+	return mix_op_exec(t, CMS_CREATE, op, rc);
+}
+
+static int mix_obj_open(struct cr_mix_task *t, struct m0_obj *obj)
+{
+	struct m0_op *op = NULL;
+	int           rc;
+
+	rc = m0_entity_open(&obj->ob_entity, &op);
+	return mix_op_exec(t, CMS_OPEN, op, rc);
+}
+
+static int mix_obj_io(struct cr_mix_task *t, struct m0_obj *obj,
+		      enum m0_obj_opcode opcode)
+{
+	struct m0_op *op = NULL;
+	int           rc;
+
+	rc = m0_obj_op(obj, opcode, &t->cmt_ext, &t->cmt_data, NULL, 0, 0, &op);
+	return mix_op_exec(t, opcode == M0_OC_WRITE ? CMS_WRITE : CMS_READ,
+			   op, rc);
+}
+
+static int mix_obj_delete(struct cr_mix_task *t, struct m0_obj *obj)
+{
+	struct m0_op *op = NULL;
+	int           rc;
+
+	rc = m0_entity_delete(&obj->ob_entity, &op);
+	return mix_op_exec(t, CMS_DELETE, op, rc);
+}
+
+static int mix_idx_op(struct cr_mix_task *t, enum cr_mix_step step,
+		      enum m0_idx_opcode opcode, struct m0_bufvec *keys,
+		      struct m0_bufvec *vals, uint32_t flags)
+{
+	struct m0_idx  idx = {};
+	struct m0_op  *op = NULL;
+	int32_t       *rcs;
+	int            rc;
+
+	if (M0_ALLOC_ARR(rcs, keys->ov_vec.v_nr) == NULL)
+		return M0_ERR(-ENOMEM);
+
+	m0_idx_init(&idx, crate_uber_realm(),
+		    (struct m0_uint128 *)&t->cmt_cwm->cwm_index_fid);
+	if (conf->is_enf_meta && m0_fid_is_valid(&dix_pool_ver) &&
+	    m0_fid_is_set(&dix_pool_ver)) {
+		idx.in_entity.en_flags |= M0_ENF_META;
+		idx.in_attr.idx_layout_type = DIX_LTYPE_DESCR;
+		idx.in_attr.idx_pver = dix_pool_ver;
+	}
+
+	rc = m0_idx_op(&idx, opcode, keys, vals, rcs, flags, &op);
+	if (rc == 0)
+		set_idx_flags(op);
+	rc = mix_op_exec(t, step, op, rc);
+	/* NEXT reports -ENOENT for records past the end of the index. */
+	if (rc == 0 && opcode != M0_IC_NEXT)
+		rc = rcs[0];
+
+	m0_idx_fini(&idx);
+	m0_free(rcs);
+	return M0_RC(rc);
+}
+
+/* OPERATION CLASSES */
+
+static void mix_key(const struct cr_mix_task *t, int slot, struct m0_fid *key)
+{
+	*key = M0_FID_INIT(t->cmt_tid + 1, slot);
+}
+
+static int mix_write(struct cr_mix_task *t, int slot)
+{
+	struct cr_mix_slot *s = &t->cmt_slots[slot];
+	struct m0_obj       obj;
+	struct m0_fid       key;
+	void               *kbuf = &key;
+	void               *vbuf = &s->cms_id;
+	m0_bcount_t         klen = sizeof key;
+	m0_bcount_t         vlen = sizeof s->cms_id;
+	struct m0_bufvec    keys = M0_BUFVEC_INIT_BUF(&kbuf, &klen);
+	struct m0_bufvec    vals = M0_BUFVEC_INIT_BUF(&vbuf, &vlen);
+	bool                created = false;
+	int                 rc;
+
+	if (!s->cms_live) {
+		s->cms_id = t->cmt_next_id;
+		t->cmt_next_id.u_lo++;
+	}
+	mix_obj_init(t, &obj, &s->cms_id);
+	if (s->cms_live)
+		rc = mix_obj_open(t, &obj);
+	else {
+		rc = mix_obj_create(t, &obj);
+		created = rc == 0;
+	}
+	rc = rc ?: mix_obj_io(t, &obj, M0_OC_WRITE);
+	if (rc == 0) {
+		mix_key(t, slot, &key);
+		rc = mix_idx_op(t, CMS_KV_PUT, M0_IC_PUT, &keys, &vals,
+				M0_OIF_OVERWRITE);
+	}
+	/* No record points to the new object, so it would be leaked. */
+	if (rc != 0 && created) {
+		t->cmt_measure = false;
+		if (mix_obj_delete(t, &obj) != 0)
+			crlog(CLL_WARN, "Object "U128X_F" is left behind",
+			      U128_P(&s->cms_id));
+		t->cmt_measure = true;
+	}
+	m0_obj_fini(&obj);
+	if (rc == 0)
+		s->cms_live = true;
+	return M0_RC(rc);
+}
+
+static int mix_read(struct cr_mix_task *t, int slot)
+{
+	struct cr_mix_slot *s = &t->cmt_slots[slot];
+	struct m0_obj       obj;
+	struct m0_fid       key;
+	void               *kbuf = &key;
+	void               *vbuf = NULL;
+	m0_bcount_t         klen = sizeof key;
+	m0_bcount_t         vlen = 0;
+	struct m0_bufvec    keys = M0_BUFVEC_INIT_BUF(&kbuf, &klen);
+	struct m0_bufvec    vals = M0_BUFVEC_INIT_BUF(&vbuf, &vlen);
+	int                 rc;
+
+	mix_key(t, slot, &key);
+	rc = mix_idx_op(t, CMS_KV_GET, M0_IC_GET, &keys, &vals, 0);
+	if (rc == 0 && (vlen != sizeof s->cms_id ||
+			memcmp(vbuf, &s->cms_id, vlen) != 0)) {
+		crlog(CLL_ERROR, "Record of slot %d does not match object "
+		      U128X_F, slot, U128_P(&s->cms_id));
+		rc = M0_ERR(-EPROTO);
+	}
+	m0_free(vbuf);
+	if (rc != 0)
+		return M0_RC(rc);
+
+	mix_obj_init(t, &obj, &s->cms_id);
+	rc = mix_obj_open(t, &obj) ?: mix_obj_io(t, &obj, M0_OC_READ);
+	m0_obj_fini(&obj);
+	return M0_RC(rc);
+}
+
+static int mix_list(struct cr_mix_task *t, int slot)
+{
+	struct m0_workload_mix *cwm = t->cmt_cwm;
+	struct m0_bufvec        keys = {};
+	struct m0_bufvec        vals = {};
+	int                     rc;
+
+	rc = m0_bufvec_empty_alloc(&keys, cwm->cwm_next_records) ?:
+	     m0_bufvec_empty_alloc(&vals, cwm->cwm_next_records);
+	if (rc == 0) {
+		keys.ov_buf[0] = m0_alloc(sizeof(struct m0_fid));
+		if (keys.ov_buf[0] == NULL)
+			rc = M0_ERR(-ENOMEM);
+	}
+	if (rc == 0) {
+		keys.ov_vec.v_count[0] = sizeof(struct m0_fid);
+		mix_key(t, slot, keys.ov_buf[0]);
+		rc = mix_idx_op(t, CMS_KV_NEXT, M0_IC_NEXT, &keys, &vals, 0);
+	}
+	m0_bufvec_free(&keys);
+	m0_bufvec_free(&vals);
+	return M0_RC(rc);
+}
+
+static int mix_delete(struct cr_mix_task *t, int slot)
+{
+	struct cr_mix_slot *s = &t->cmt_slots[slot];
+	struct m0_obj       obj;
+	struct m0_fid       key;
+	void               *kbuf = &key;
+	m0_bcount_t         klen = sizeof key;
+	struct m0_bufvec    keys = M0_BUFVEC_INIT_BUF(&kbuf, &klen);
+	int                 rc;
+
+	mix_key(t, slot, &key);
+	rc = mix_idx_op(t, CMS_KV_DEL, M0_IC_DEL, &keys, NULL, 0);
+	/* The record is gone already if a previous delete failed later on. */
+	if (rc != 0 && rc != -ENOENT)
+		return M0_RC(rc);
+
+	mix_obj_init(t, &obj, &s->cms_id);
+	rc = mix_obj_open(t, &obj) ?: mix_obj_delete(t, &obj);
+	m0_obj_fini(&obj);
+	/* The slot stays live until its object is deleted. */
+	if (rc == 0)
+		s->cms_live = false;
+	return M0_RC(rc);
+}
+
+static const cr_mix_op_t cr_mix_ops[CMC_NR] = {
+	[CMC_WRITE]  = mix_write,
+	[CMC_READ]   = mix_read,
+	[CMC_LIST]   = mix_list,
+	[CMC_DELETE] = mix_delete
+};
+
+/* TASK */
+
+static enum cr_mix_class mix_class_pick(struct m0_workload_mix *cwm)
+{
+	int r = rand() % 100;
+	int i;
+
+	for (i = 0; i < CMC_NR - 1; i++) {
+		if (r < cwm->cwm_prcnt[i])
+			break;
+		r -= cwm->cwm_prcnt[i];
+	}
+	return i;
+}
+
+static bool mix_time_expired(struct m0_workload_mix *cwm)
+{
+	return cwm->cwm_execution_time != M0_TIME_NEVER &&
+	       m0_time_sub(m0_time_now(), cwm->cwm_start_time) >=
+	       cwm->cwm_execution_time;
+}
+
+static void mix_task_fini(struct cr_mix_task *t)
+{
+	int i;
+
+	for (i = 0; i < CMC_NR; i++)
+		cr_hist_fini(&t->cmt_class[i]);
+	for (i = 0; i < CMS_NR; i++)
+		cr_hist_fini(&t->cmt_step[i]);
+	m0_indexvec_free(&t->cmt_ext);
+	m0_bufvec_free_aligned(&t->cmt_data, M0_DEFAULT_BUF_SHIFT);
+	m0_free(t->cmt_slots);
+}
+
+static int mix_task_init(struct cr_mix_task *t, struct workload *w,
+			 uint64_t tid)
+{
+	struct m0_workload_mix *cwm = w->u.cw_mix;
+	uint64_t                hi;
+	int                     rc;
+	int                     i;
+
+	*t = (struct cr_mix_task) {
+		.cmt_cwm     = cwm,
+		.cmt_tid     = tid,
+		.cmt_measure = true
+	};
+	/* Highest 8 bits are left for Motr, see cr_get_oids(). */
+	do {
+		hi = (((uint64_t)rand() << 32) | rand()) & ~(0xFFUL << 56);
+	} while (hi == 0);
+	t->cmt_next_id = M0_UINT128(hi, 0);
+
+	M0_ALLOC_ARR(t->cmt_slots, cwm->cwm_nr_objs);
+	if (t->cmt_slots == NULL)
+		return M0_ERR(-ENOMEM);
+	rc = m0_bufvec_alloc_aligned(&t->cmt_data, cwm->cwm_bcount_per_op,
+				     cwm->cwm_bs, M0_DEFAULT_BUF_SHIFT) ?:
+	     m0_indexvec_alloc(&t->cmt_ext, cwm->cwm_bcount_per_op) ?:
+	     cr_key_gen_init(&t->cmt_keys, &w->cw_shape, cwm->cwm_nr_objs);
+	for (i = 0; i < CMC_NR && rc == 0; i++)
+		rc = cr_hist_init(&t->cmt_class[i]);
+	for (i = 0; i < CMS_NR && rc == 0; i++)
+		rc = cr_hist_init(&t->cmt_step[i]);
+	if (rc != 0) {
+		mix_task_fini(t);
+		return M0_ERR(rc);
+	}
+	for (i = 0; i < cwm->cwm_bcount_per_op; i++) {
+		memset(t->cmt_data.ov_buf[i], 'A' + tid % 26, cwm->cwm_bs);
+		t->cmt_ext.iv_index[i] = i * cwm->cwm_bs;
+		t->cmt_ext.iv_vec.v_count[i] = cwm->cwm_bs;
+	}
+	cr_pacer_init(&t->cmt_pacer, w->cw_shape.cls_rate);
+	return 0;
+}
+
+static void mix_task_run(struct cr_mix_task *t)
+{
+	struct m0_workload_mix *cwm = t->cmt_cwm;
+	enum cr_mix_class       cls;
+	m0_time_t               start;
+	int                     slot;
+	int                     rc;
+	int                     i;
+
+	for (i = 0; (cwm->cwm_op_count < 0 || i < cwm->cwm_op_count) &&
+		    !mix_time_expired(cwm); i++) {
+		start = cr_pacer_wait(&t->cmt_pacer) ?: m0_time_now();
+		cls   = mix_class_pick(cwm);
+		slot  = cr_key_gen_next(&t->cmt_keys);
+		if (M0_IN(cls, (CMC_READ, CMC_DELETE)) &&
+		    !t->cmt_slots[slot].cms_live)
+			cls = CMC_WRITE;
+		rc = cr_mix_ops[cls](t, slot);
+		if (rc == 0) {
+			cr_hist_record(&t->cmt_class[cls],
+				       m0_time_sub(m0_time_now(), start));
+			t->cmt_done[cls]++;
+		} else {
+			crlog(CLL_ERROR, "t%02"PRIu64": %s of slot %d "
+			      "failed: %d", t->cmt_tid,
+			      cr_mix_class_labels[cls], slot, rc);
+			t->cmt_failed[cls]++;
+		}
+	}
+
+	/* Leave neither objects nor records behind. */
+	t->cmt_measure = false;
+	for (i = 0; i < cwm->cwm_nr_objs; i++)
+		if (t->cmt_slots[i].cms_live)
+			mix_delete(t, i);
+}
+
+/** Merges results of the task into the workload ones. */
+static void mix_task_report(struct cr_mix_task *t, struct workload *w)
+{
+	struct m0_workload_mix *cwm = t->cmt_cwm;
+	int                     i;
+
+	pthread_mutex_lock(&w->cw_lock);
+	for (i = 0; i < CMC_NR; i++) {
+		cr_hist_merge(&cwm->cwm_class_hist[i], &t->cmt_class[i]);
+		cwm->cwm_ops_done[i]   += t->cmt_done[i];
+		cwm->cwm_ops_failed[i] += t->cmt_failed[i];
+	}
+	for (i = 0; i < CMS_NR; i++)
+		cr_hist_merge(&cwm->cwm_step_hist[i], &t->cmt_step[i]);
+	pthread_mutex_unlock(&w->cw_lock);
+}
+
+void m0_op_run_mix(struct workload *w, struct workload_task *task,
+		   const struct workload_op *op)
+{
+	struct m0_workload_task m0_task = {};
+	struct cr_mix_task      t;
+	bool                    is_m0_thread;
+	int                     rc;
+
+	is_m0_thread = m0_thread_tls() != NULL;
+	if (!is_m0_thread) {
+		rc = adopt_motr_thread(&m0_task);
+		if (rc != 0) {
+			crlog(CLL_ERROR, "Unable to adopt thread (%s)",
+			      strerror(-rc));
+			return;
+		}
+	}
+
+	rc = mix_task_init(&t, w, task->wt_thread);
+	if (rc == 0) {
+		mix_task_run(&t);
+		mix_task_report(&t, w);
+		mix_task_fini(&t);
+	} else
+		crlog(CLL_ERROR, "Task preparation failed (%s)",
+		      strerror(-rc));
+
+	if (!is_m0_thread)
+		release_motr_thread(&m0_task);
+}
+
+/* WORKLOAD */
+
+static int mix_check(struct m0_workload_mix *cwm)
+{
+	int sum = 0;
+	int i;
+
+	for (i = 0; i < CMC_NR; i++)
+		sum += cwm->cwm_prcnt[i];
+	if (sum != 100) {
+		crlog(CLL_ERROR, "PUT, GET, NEXT and DEL must sum up to 100, "
+		      "not %d", sum);
+		return M0_ERR(-EINVAL);
+	}
+	if (conf->layout_id <= 0 || cwm->cwm_bs == 0 || cwm->cwm_nr_objs <= 0) {
+		crlog(CLL_ERROR, "LAYOUT_ID, BLOCK_SIZE and NR_OBJS must be set");
+		return M0_ERR(-EINVAL);
+	}
+	cwm->cwm_layout_id       = conf->layout_id;
+	cwm->cwm_bcount_per_op   = cwm->cwm_bcount_per_op ?: 1;
+	cwm->cwm_next_records    = cwm->cwm_next_records > 0 ?
+				   cwm->cwm_next_records : 1;
+	if (cwm->cwm_execution_time == 0)
+		cwm->cwm_execution_time = M0_TIME_NEVER;
+	/* Without OP_COUNT the workload runs for EXEC_TIME. */
+	if (cwm->cwm_op_count == 0)
+		cwm->cwm_op_count = -1;
+	if (cwm->cwm_op_count < 0 &&
+	    cwm->cwm_execution_time == M0_TIME_NEVER) {
+		crlog(CLL_ERROR, "Either OP_COUNT or EXEC_TIME must be limited");
+		return M0_ERR(-EINVAL);
+	}
+	return 0;
+}
+
+static void mix_hists_fini(struct m0_workload_mix *cwm)
+{
+	int i;
+
+	for (i = 0; i < CMC_NR; i++)
+		cr_hist_fini(&cwm->cwm_class_hist[i]);
+	for (i = 0; i < CMS_NR; i++)
+		cr_hist_fini(&cwm->cwm_step_hist[i]);
+}
+
+void run_mix(struct workload *w, struct workload_task *tasks)
+{
+	struct m0_workload_mix *cwm = w->u.cw_mix;
+	struct cr_hist          hist[CMC_NR + CMS_NR];
+	const char             *labels[CMC_NR + CMS_NR];
+	m0_time_t               elapsed;
+	int                     rc;
+	int                     i;
+
+	rc = mix_check(cwm);
+	for (i = 0; i < CMC_NR && rc == 0; i++)
+		rc = cr_hist_init(&cwm->cwm_class_hist[i]);
+	for (i = 0; i < CMS_NR && rc == 0; i++)
+		rc = cr_hist_init(&cwm->cwm_step_hist[i]);
+	rc = rc ?: create_index(*(struct m0_uint128 *)&cwm->cwm_index_fid);
+	if (rc != 0) {
+		mix_hists_fini(cwm);
+		cr_log(CLL_ERROR, "Mixed workload preparation failed: %d\n", rc);
+		return;
+	}
+
+	cwm->cwm_start_time = m0_time_now();
+	workload_start(w, tasks);
+	workload_join(w, tasks);
+	elapsed = m0_time_sub(m0_time_now(), cwm->cwm_start_time);
+
+	cr_log(CLL_INFO, "Mixed workload is finished.\n");
+	cr_log(CLL_INFO, "Total: time="TIME_F"\n", TIME_P(elapsed));
+	for (i = 0; i < CMC_NR; i++) {
+		if (cwm->cwm_ops_done[i] + cwm->cwm_ops_failed[i] == 0)
+			continue;
+		cr_log(CLL_INFO, "%s: ops=%" PRIu64 " failed=%" PRIu64 "\n",
+		       cr_mix_class_labels[i], cwm->cwm_ops_done[i],
+		       cwm->cwm_ops_failed[i]);
+		cr_hist_log(&cwm->cwm_class_hist[i], cr_mix_class_labels[i]);
+	}
+	for (i = 0; i < CMS_NR; i++)
+		cr_hist_log(&cwm->cwm_step_hist[i], cr_mix_step_labels[i]);
+
+	for (i = 0; i < CMC_NR; i++) {
+		hist[i]   = cwm->cwm_class_hist[i];
+		labels[i] = cr_mix_class_labels[i];
+	}
+	for (i = 0; i < CMS_NR; i++) {
+		hist[CMC_NR + i]   = cwm->cwm_step_hist[i];
+		labels[CMC_NR + i] = cr_mix_step_labels[i];
+	}
+	cr_stats_json(w, elapsed, hist, labels, CMC_NR + CMS_NR);
+	mix_hists_fini(cwm);
+}
+
+/** @} end of mix_workload group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
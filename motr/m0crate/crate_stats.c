@@ -0,0 +1,343 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2017-2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/**
+ * @addtogroup crate_stats
+ *
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "lib/arith.h"
+#include "lib/memory.h"
+#include "motr/m0crate/logger.h"
+#include "motr/m0crate/crate_stats.h"
+
+static const char *cr_key_dist_name[CKD_NR] = {
+	[CKD_UNIFORM] = "uniform",
+	[CKD_ZIPF]    = "zipf",
+	[CKD_HOTSET]  = "hotset"
+};
+
+/* HISTOGRAM */
+
+static unsigned hist_idx(m0_time_t v)
+{
+	unsigned shift;
+
+	if (v < CR_HIST_SUB_NR)
+		return v;
+	shift = m0_log2(v) - CR_HIST_SUB_SHIFT;
+	return (shift + 1) * CR_HIST_SUB_NR + (v >> shift) - CR_HIST_SUB_NR;
+}
+
+/** Largest value which falls into bucket @idx. */
+static m0_time_t hist_idx_top(unsigned idx)
+{
+	unsigned shift;
+	uint64_t mant;
+
+	if (idx < CR_HIST_SUB_NR)
+		return idx;
+	shift = idx / CR_HIST_SUB_NR - 1;
+	mant  = idx % CR_HIST_SUB_NR + CR_HIST_SUB_NR;
+	return ((mant + 1) << shift) - 1;
+}
+
+int cr_hist_init(struct cr_hist *h)
+{
+	*h = (struct cr_hist) { .ch_min = M0_TIME_NEVER };
+	M0_ALLOC_ARR(h->ch_buckets, CR_HIST_BUCKETS_NR);
+	return h->ch_buckets == NULL ? -ENOMEM : 0;
+}
+
+void cr_hist_fini(struct cr_hist *h)
+{
+	m0_free0(&h->ch_buckets);
+}
+
+void cr_hist_reset(struct cr_hist *h)
+{
+	h->ch_count = 0;
+	h->ch_sum   = 0;
+	h->ch_max   = 0;
+	h->ch_min   = M0_TIME_NEVER;
+	if (h->ch_buckets != NULL)
+		memset(h->ch_buckets, 0,
+		       CR_HIST_BUCKETS_NR * sizeof h->ch_buckets[0]);
+}
+
+void cr_hist_record(struct cr_hist *h, m0_time_t latency)
+{
+	if (h->ch_buckets == NULL)
+		return;
+	h->ch_buckets[hist_idx(latency)]++;
+	h->ch_count++;
+	h->ch_sum += latency;
+	h->ch_min = min64u(h->ch_min, latency);
+	h->ch_max = max64u(h->ch_max, latency);
+}
+
+void cr_hist_merge(struct cr_hist *dst, const struct cr_hist *src)
+{
+	int i;
+
+	if (dst->ch_buckets == NULL || src->ch_buckets == NULL)
+		return;
+	for (i = 0; i < CR_HIST_BUCKETS_NR; i++)
+		dst->ch_buckets[i] += src->ch_buckets[i];
+	dst->ch_count += src->ch_count;
+	dst->ch_sum   += src->ch_sum;
+	dst->ch_min    = min64u(dst->ch_min, src->ch_min);
+	dst->ch_max    = max64u(dst->ch_max, src->ch_max);
+}
+
+m0_time_t cr_hist_percentile(const struct cr_hist *h, double prcnt)
+{
+	uint64_t rank;
+	uint64_t seen = 0;
+	int      i;
+
+	if (h->ch_count == 0)
+		return 0;
+	rank = ceil(h->ch_count * prcnt / 100.0);
+	rank = max64u(rank, 1);
+	for (i = 0; i < CR_HIST_BUCKETS_NR; i++) {
+		seen += h->ch_buckets[i];
+		if (seen >= rank)
+			return max64u(min64u(hist_idx_top(i), h->ch_max),
+				      h->ch_min);
+	}
+	return h->ch_max;
+}
+
+m0_time_t cr_hist_mean(const struct cr_hist *h)
+{
+	return h->ch_count == 0 ? 0 : h->ch_sum / h->ch_count;
+}
+
+void cr_hist_log(const struct cr_hist *h, const char *label)
+{
+	if (h->ch_count == 0)
+		return;
+	cr_log(CLL_INFO, "%s: p50="TIME_F" p99="TIME_F" p99.9="TIME_F
+	       " max="TIME_F"\n", label,
+	       TIME_P(cr_hist_percentile(h, 50.0)),
+	       TIME_P(cr_hist_percentile(h, 99.0)),
+	       TIME_P(cr_hist_percentile(h, 99.9)),
+	       TIME_P(h->ch_max));
+}
+
+/* KEY DISTRIBUTIONS */
+
+/** Pseudo-random uint64, built from two rand() calls like the callers did. */
+static uint64_t cr_rand64(void)
+{
+	uint64_t val_l = rand();
+	uint64_t val_h = rand();
+
+	return (val_h << 32) | val_l;
+}
+
+/** Pseudo-random double in [0; 1). */
+static double cr_rand_unit(void)
+{
+	const double range = (double)RAND_MAX + 1.0;
+
+	return (rand() + rand() * range) / (range * range);
+}
+
+static double zeta(uint64_t n, double theta)
+{
+	double   sum = 0.0;
+	uint64_t i;
+
+	for (i = 1; i <= n; i++)
+		sum += 1.0 / pow((double)i, theta);
+	return sum;
+}
+
+int cr_key_gen_init(struct cr_key_gen *g, const struct cr_load_shape *ls,
+		    uint64_t nr)
+{
+	double zeta2;
+
+	if (nr == 0)
+		return -EINVAL;
+	*g = (struct cr_key_gen) {
+		.ckg_dist = ls->cls_dist,
+		.ckg_nr   = nr
+	};
+	switch (g->ckg_dist) {
+	case CKD_UNIFORM:
+		break;
+	case CKD_ZIPF:
+		if (ls->cls_zipf_theta <= 0.0 || ls->cls_zipf_theta >= 1.0)
+			return -EINVAL;
+		g->ckg_theta = ls->cls_zipf_theta;
+		g->ckg_alpha = 1.0 / (1.0 - g->ckg_theta);
+		g->ckg_zetan = zeta(nr, g->ckg_theta);
+		zeta2 = zeta(2, g->ckg_theta);
+		if (nr > 2)
+			g->ckg_eta = (1.0 - pow(2.0 / nr, 1.0 - g->ckg_theta)) /
+				     (1.0 - zeta2 / g->ckg_zetan);
+		break;
+	case CKD_HOTSET:
+		if (ls->cls_hot_set_prcnt <= 0 || ls->cls_hot_set_prcnt > 100 ||
+		    ls->cls_hot_ops_prcnt < 0 || ls->cls_hot_ops_prcnt > 100)
+			return -EINVAL;
+		g->ckg_hot_nr = max64u(nr * ls->cls_hot_set_prcnt / 100, 1);
+		g->ckg_hot_ops_prcnt = ls->cls_hot_ops_prcnt;
+		break;
+	default:
+		return -EINVAL;
+	}
+	return 0;
+}
+
+uint64_t cr_key_gen_next(struct cr_key_gen *g)
+{
+	double   u;
+	uint64_t r;
+
+	switch (g->ckg_dist) {
+	case CKD_ZIPF:
+		u = cr_rand_unit();
+		if (u * g->ckg_zetan < 1.0)
+			return 0;
+		if (g->ckg_nr <= 2 ||
+		    u * g->ckg_zetan < 1.0 + pow(0.5, g->ckg_theta))
+			return min64u(1, g->ckg_nr - 1);
+		r = g->ckg_nr * pow(g->ckg_eta * u - g->ckg_eta + 1.0,
+				    g->ckg_alpha);
+		return min64u(r, g->ckg_nr - 1);
+	case CKD_HOTSET:
+		if (g->ckg_hot_nr == g->ckg_nr ||
+		    rand() % 100 < g->ckg_hot_ops_prcnt)
+			return cr_rand64() % g->ckg_hot_nr;
+		return g->ckg_hot_nr +
+		       cr_rand64() % (g->ckg_nr - g->ckg_hot_nr);
+	default:
+		return cr_rand64() % g->ckg_nr;
+	}
+}
+
+/* OPEN-LOOP PACING */
+
+void cr_pacer_init(struct cr_pacer *p, uint64_t rate)
+{
+	p->cp_interval = rate == 0 ? 0 : (M0_TIME_ONE_SECOND / rate ?: 1);
+	p->cp_next     = 0;
+}
+
+m0_time_t cr_pacer_wait(struct cr_pacer *p)
+{
+	m0_time_t now;
+	m0_time_t sched;
+
+	if (p->cp_interval == 0)
+		return 0;
+	now = m0_time_now();
+	if (p->cp_next == 0)
+		p->cp_next = now;
+	sched = p->cp_next;
+	/*
+	 * Do not skip missed slots when running behind: issuing them
+	 * back-to-back is what charges the stall to the latencies.
+	 */
+	if (sched > now)
+		m0_nanosleep(m0_time_sub(sched, now), NULL);
+	p->cp_next = m0_time_add(sched, p->cp_interval);
+	return sched;
+}
+
+/* JSON RESULTS */
+
+void cr_stats_json(const struct workload *w, m0_time_t elapsed,
+		   const struct cr_hist *hist, const char **labels, int nr)
+{
+	const struct cr_load_shape *ls = &w->cw_shape;
+	FILE                       *f;
+	bool                        first = true;
+	int                         i;
+
+	if (ls->cls_json == NULL)
+		return;
+	f = strcmp(ls->cls_json, "-") == 0 ? stdout : fopen(ls->cls_json, "a");
+	if (f == NULL) {
+		cr_log(CLL_ERROR, "Unable to open %s: %s\n", ls->cls_json,
+		       strerror(errno));
+		return;
+	}
+	fprintf(f, "{\"workload\": \"%s\", \"threads\": %u, "
+		"\"arrival_rate\": %" PRIu64 ", \"key_dist\": \"%s\", ",
+		w->cw_name, w->cw_nr_thread, ls->cls_rate,
+		cr_key_dist_name[ls->cls_dist]);
+	if (ls->cls_dist == CKD_ZIPF)
+		fprintf(f, "\"zipf_theta\": %.3f, ", ls->cls_zipf_theta);
+	else if (ls->cls_dist == CKD_HOTSET)
+		fprintf(f, "\"hot_set_prcnt\": %d, \"hot_ops_prcnt\": %d, ",
+			ls->cls_hot_set_prcnt, ls->cls_hot_ops_prcnt);
+	fprintf(f, "\"elapsed_ns\": %" PRIu64 ", \"ops\": {", elapsed);
+	for (i = 0; i < nr; i++) {
+		if (hist[i].ch_count == 0)
+			continue;
+		fprintf(f, "%s\"%s\": {\"count\": %" PRIu64 ", "
+			"\"min_ns\": %" PRIu64 ", \"mean_ns\": %" PRIu64 ", "
+			"\"p50_ns\": %" PRIu64 ", \"p90_ns\": %" PRIu64 ", "
+			"\"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64 ", "
+			"\"max_ns\": %" PRIu64 "}",
+			first ? "" : ", ", labels[i], hist[i].ch_count,
+			hist[i].ch_min, cr_hist_mean(&hist[i]),
+			cr_hist_percentile(&hist[i], 50.0),
+			cr_hist_percentile(&hist[i], 90.0),
+			cr_hist_percentile(&hist[i], 99.0),
+			cr_hist_percentile(&hist[i], 99.9),
+			hist[i].ch_max);
+		first = false;
+	}
+	fprintf(f, "}}\n");
+	if (f == stdout)
+		fflush(f);
+	else
+		fclose(f);
+}
+
+/** @} end of crate_stats group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
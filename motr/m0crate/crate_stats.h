@@ -0,0 +1,148 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2017-2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_M0CRATE_CRATE_STATS_H__
+#define __MOTR_M0CRATE_CRATE_STATS_H__
+
+/**
+ * @defgroup crate_stats
+ *
+ * Latency histograms, key popularity generators and open-loop pacing used by
+ * the client I/O and index workloads.
+ *
+ * @{
+ */
+
+#include <stdio.h>
+#include "lib/types.h"
+#include "lib/time.h"
+#include "motr/m0crate/workload.h"
+
+enum {
+	/** log2 of the number of linear sub-buckets per power of two. */
+	CR_HIST_SUB_SHIFT  = 6,
+	CR_HIST_SUB_NR     = 1 << CR_HIST_SUB_SHIFT,
+	/**
+	 * Enough buckets to cover the whole uint64_t range with relative
+	 * error below 1 / CR_HIST_SUB_NR.
+	 */
+	CR_HIST_BUCKETS_NR = (64 - CR_HIST_SUB_SHIFT + 1) * CR_HIST_SUB_NR
+};
+
+/**
+ * Log-linear (HDR-style) latency histogram.
+ *
+ * Values below CR_HIST_SUB_NR nanoseconds are counted exactly, every larger
+ * power of two is split into CR_HIST_SUB_NR equal buckets. Histograms of the
+ * same shape can be merged, so each thread records into its own one and the
+ * results are combined once the thread is done.
+ */
+struct cr_hist {
+	uint64_t  ch_count;
+	m0_time_t ch_min;
+	m0_time_t ch_max;
+	m0_time_t ch_sum;
+	uint64_t *ch_buckets;
+};
+
+int  cr_hist_init(struct cr_hist *h);
+void cr_hist_fini(struct cr_hist *h);
+void cr_hist_reset(struct cr_hist *h);
+void cr_hist_record(struct cr_hist *h, m0_time_t latency);
+void cr_hist_merge(struct cr_hist *dst, const struct cr_hist *src);
+/** Returns the latency below which @prcnt percents of samples fall. */
+m0_time_t cr_hist_percentile(const struct cr_hist *h, double prcnt);
+m0_time_t cr_hist_mean(const struct cr_hist *h);
+
+/**
+ * Generator of keys in [0, ckg_nr) following cr_load_shape::cls_dist.
+ *
+ * Zipf values are generated with the method from Gray et al., "Quickly
+ * generating billion-record synthetic databases": zeta(n) is computed once
+ * at initialisation, each draw is then O(1). Low ranks are the hot ones.
+ */
+struct cr_key_gen {
+	enum cr_key_dist ckg_dist;
+	uint64_t         ckg_nr;
+	/* CKD_ZIPF */
+	double           ckg_theta;
+	double           ckg_alpha;
+	double           ckg_zetan;
+	double           ckg_eta;
+	/* CKD_HOTSET */
+	uint64_t         ckg_hot_nr;
+	int              ckg_hot_ops_prcnt;
+};
+
+int      cr_key_gen_init(struct cr_key_gen *g, const struct cr_load_shape *ls,
+			 uint64_t nr);
+uint64_t cr_key_gen_next(struct cr_key_gen *g);
+
+/**
+ * Open-loop pacer.
+ *
+ * Issues operations on a fixed schedule, independent of how fast previous
+ * operations completed. Latency is measured from the scheduled start, so the
+ * queueing delay of a stalled system is charged to the operations that
+ * suffered it, instead of being hidden by the load generator slowing down
+ * (coordinated omission).
+ */
+struct cr_pacer {
+	m0_time_t cp_interval;
+	m0_time_t cp_next;
+};
+
+void      cr_pacer_init(struct cr_pacer *p, uint64_t rate);
+/**
+ * Sleeps until the next scheduled start and returns it, or returns 0 if
+ * the pacer is off (closed loop).
+ */
+m0_time_t cr_pacer_wait(struct cr_pacer *p);
+
+/**
+ * Appends a JSON object describing the results of workload @w to
+ * cr_load_shape::cls_json. @hist and @labels are indexed by the workload
+ * opcode; histograms without samples are omitted.
+ */
+void cr_stats_json(const struct workload *w, m0_time_t elapsed,
+		   const struct cr_hist *hist, const char **labels, int nr);
+
+/** Logs percentiles of @h with the given label at CLL_INFO. */
+void cr_hist_log(const struct cr_hist *h, const char *label);
+
+/** @} end of crate_stats group */
+#endif /* __MOTR_M0CRATE_CRATE_STATS_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
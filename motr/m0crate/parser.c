@@ -103,6 +103,12 @@ enum config_key_val {
 	INSERT,
 	LOOKUP,
 	DELETE,
+	ARRIVAL_RATE,
+	KEY_DIST,
+	ZIPF_THETA,
+	HOT_SET_PRCNT,
+	HOT_OPS_PRCNT,
+	RESULTS_JSON,
 };
 
 struct key_lookup_table {
@@ -171,7 +177,13 @@ struct key_lookup_table lookuptable[] = {
 	{"PATTERN", PATTERN},
 	{"INSERT", INSERT},
 	{"LOOKUP", LOOKUP},
-	{"DELETE", DELETE}
+	{"DELETE", DELETE},
+	{"ARRIVAL_RATE", ARRIVAL_RATE},
+	{"KEY_DIST", KEY_DIST},
+	{"ZIPF_THETA", ZIPF_THETA},
+	{"HOT_SET_PRCNT", HOT_SET_PRCNT},
+	{"HOT_OPS_PRCNT", HOT_OPS_PRCNT},
+	{"RESULTS_JSON", RESULTS_JSON}
 };
 
 #define NKEYS (sizeof(lookuptable)/sizeof(struct key_lookup_table))
@@ -247,16 +259,64 @@ static int parse_int(const char *value, enum config_key_val tag)
 	return val;
 }
 
+static int parse_prcnt(const char *value, enum config_key_val tag)
+{
+	int val = parse_int(value, tag);
+
+	if (val < 0 || val > 100)
+		parser_emit_error("Value '%s' of %s is not a percentage",
+				  value, get_key_from_index(tag));
+	return val;
+}
+
 #define SIZEOF_CWIDX sizeof(struct m0_workload_index)
 #define SIZEOF_CWIO sizeof(struct m0_workload_io)
 #define SIZEOF_CWBTREE sizeof(struct cr_workload_btree)
+#define SIZEOF_CWMIX sizeof(struct m0_workload_mix)
 
 #define workload_index(t) (t->u.cw_index)
 #define workload_io(t) (t->u.cw_io)
 #define workload_btree(t) (t->u.cw_btree)
+#define workload_mix(t) (t->u.cw_mix)
 
 const char conf_section_name[] = "MOTR_CONFIG";
 
+/**
+ * Whether workload-specific @key applies to the mixed workload. Keys of
+ * the index, io and btree workloads are rejected, as they would be stored
+ * to the private data of another workload type.
+ */
+static bool mix_key_is_valid(enum config_key_val key)
+{
+	switch (key) {
+	case WORKLOAD_TYPE:
+	case POOL_FID:
+	case SEED:
+	case NR_THREADS:
+	case NUM_OPS:
+	case NR_OBJS:
+	case PUT:
+	case GET:
+	case NEXT:
+	case DEL:
+	case NXRECORDS:
+	case OP_COUNT:
+	case EXEC_TIME:
+	case INDEX_FID:
+	case BLOCK_SIZE:
+	case BLOCKS_PER_OP:
+	case ARRIVAL_RATE:
+	case KEY_DIST:
+	case ZIPF_THETA:
+	case HOT_SET_PRCNT:
+	case HOT_OPS_PRCNT:
+	case RESULTS_JSON:
+		return true;
+	default:
+		return false;
+	}
+}
+
 int copy_value(struct workload *load, int max_workload, int *index,
 		char *key, char *value)
 {
@@ -266,8 +326,10 @@ int copy_value(struct workload *load, int max_workload, int *index,
 	struct m0_workload_io    *cw;
 	struct m0_workload_index *ciw;
 	struct cr_workload_btree *cbw;
+	struct m0_workload_mix   *cwm;
 	int			 *key_size;
 	int			 *val_size;
+	char			 *endptr;
 
 	if (m0_streq(value, conf_section_name)) {
 		if (conf != NULL) {
@@ -292,6 +354,14 @@ int copy_value(struct workload *load, int max_workload, int *index,
 		return -EINVAL;
 	}
 
+	if (get_index_from_key(key) > WORKLOAD_TYPE &&
+	    load[*index].cw_type == CWT_MIX &&
+	    !mix_key_is_valid(get_index_from_key(key))) {
+		cr_log(CLL_ERROR, "YAML file error: %s is not supported by "
+		       "the mixed workload\n", key);
+		return -EINVAL;
+	}
+
 	switch(get_index_from_key(key)) {
 		case LOCAL_ADDR:
 			conf->local_addr = m0_alloc(value_len + 1);
@@ -373,6 +443,11 @@ int copy_value(struct workload *load, int max_workload, int *index,
 				w->u.cw_io = m0_alloc(SIZEOF_CWIO);
 				if (w->u.cw_io == NULL)
 					return -ENOMEM;
+			} else if (atoi(value) == OT_MIX) {
+				w->cw_type = CWT_MIX;
+				w->u.cw_mix = m0_alloc(SIZEOF_CWMIX);
+				if (w->u.cw_mix == NULL)
+					return -ENOMEM;
 			} else {
 				w->cw_type = CWT_BTREE;
 				w->u.cw_btree = m0_alloc(SIZEOF_CWBTREE);
@@ -382,7 +457,7 @@ int copy_value(struct workload *load, int max_workload, int *index,
                         return workload_init(w, w->cw_type);
 		case SEED:
 			w = &load[*index];
-			if (w->cw_type == CWT_IO || w->cw_type == CWT_BTREE) {
+			if (M0_IN(w->cw_type, (CWT_IO, CWT_BTREE, CWT_MIX))) {
 				if (strcmp(value, "tstamp"))
 					w->cw_rstate = atoi(value);
 			} else {
@@ -413,26 +488,52 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			break;
 		case PUT:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_prcnt[CMC_WRITE] = parse_prcnt(value, PUT);
+				break;
+			}
 			ciw = workload_index(w);
 			ciw->opcode_prcnt[CRATE_OP_PUT] = parse_int(value, PUT);
 			break;
 		case GET:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_prcnt[CMC_READ] = parse_prcnt(value, GET);
+				break;
+			}
 			ciw = workload_index(w);
 			ciw->opcode_prcnt[CRATE_OP_GET] = parse_int(value, GET);
 			break;
 		case NEXT:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_prcnt[CMC_LIST] = parse_prcnt(value, NEXT);
+				break;
+			}
 			ciw = workload_index(w);
 			ciw->opcode_prcnt[CRATE_OP_NEXT] = parse_int(value, NEXT);
 			break;
 		case DEL:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_prcnt[CMC_DELETE] = parse_prcnt(value, DEL);
+				break;
+			}
 			ciw = workload_index(w);
 			ciw->opcode_prcnt[CRATE_OP_DEL] = parse_int(value, DEL);
 			break;
 		case NXRECORDS:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_next_records = parse_int(value,
+								  NXRECORDS);
+				break;
+			}
 			ciw = workload_index(w);
 			if (!strcmp(value, "default"))
 				ciw->next_records = -1;
@@ -441,6 +542,15 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			break;
 		case OP_COUNT:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				if (!strcmp(value, "unlimited"))
+					cwm->cwm_op_count = -1;
+				else
+					cwm->cwm_op_count = parse_int_with_units(
+							value, OP_COUNT);
+				break;
+			}
 			ciw = workload_index(w);
 			if (!strcmp(value, "unlimited"))
 				ciw->op_count = -1;
@@ -456,6 +566,13 @@ int copy_value(struct workload *load, int max_workload, int *index,
 				else
 					ciw->exec_time = parse_int(value,
 							           EXEC_TIME);
+			} else if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				if (!strcmp(value, "unlimited"))
+					cwm->cwm_execution_time = M0_TIME_NEVER;
+				else
+					cwm->cwm_execution_time = m0_time(
+						parse_int(value, EXEC_TIME), 0);
 			} else {
 				cw = workload_io(w);
 				if (!strcmp(value, "unlimited"))
@@ -560,6 +677,14 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			break;
 		case INDEX_FID:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				if (0 != m0_fid_sscanf(value,
+						       &cwm->cwm_index_fid))
+					parser_emit_error("Unable to parse "
+							  "fid: %s", value);
+				break;
+			}
 			ciw = workload_index(w);
 			if (0 != m0_fid_sscanf(value, &ciw->index_fid)) {
 				parser_emit_error("Unable to parse fid: %s", value);
@@ -590,16 +715,31 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			break;
 		case BLOCK_SIZE:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_bs = getnum(value, "block size");
+				break;
+			}
 			cw = workload_io(w);
 			cw->cwi_bs = getnum(value, "block size");
 			break;
 		case BLOCKS_PER_OP:
 			w  = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_bcount_per_op = atol(value);
+				break;
+			}
 			cw = workload_io(w);
 			cw->cwi_bcount_per_op = atol(value);
 			break;
 		case NR_OBJS:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				cwm->cwm_nr_objs = atoi(value);
+				break;
+			}
 			cw = workload_io(w);
 			cw->cwi_nr_objs = atoi(value);
 			break;
@@ -626,6 +766,13 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			break;
 		case POOL_FID:
 			w = &load[*index];
+			if (w->cw_type == CWT_MIX) {
+				cwm = workload_mix(w);
+				if (0 != m0_fid_sscanf(value, &cwm->cwm_pool_id))
+					parser_emit_error("Unable to parse "
+							  "fid: %s", value);
+				break;
+			}
 			cw = workload_io(w);
 			if (0 != m0_fid_sscanf(value, &cw->cwi_pool_id)) {
 				parser_emit_error("Unable to parse fid: %s", value);
@@ -694,6 +841,50 @@ int copy_value(struct workload *load, int max_workload, int *index,
 			cbw->cwb_bo[BOT_DELETE].prcnt = parse_int(value,
 								  DELETE);
 			break;
+		case ARRIVAL_RATE:
+			w = &load[*index];
+			w->cw_shape.cls_rate = getnum(value, "arrival rate");
+			break;
+		case KEY_DIST:
+			w = &load[*index];
+			if (!strcmp(value, "uniform"))
+				w->cw_shape.cls_dist = CKD_UNIFORM;
+			else if (!strcmp(value, "zipf"))
+				w->cw_shape.cls_dist = CKD_ZIPF;
+			else if (!strcmp(value, "hotset"))
+				w->cw_shape.cls_dist = CKD_HOTSET;
+			else
+				parser_emit_error("Unknown key distribution: "
+						  "'%s'", value);
+			break;
+		case ZIPF_THETA:
+			w = &load[*index];
+			w->cw_shape.cls_zipf_theta = strtod(value, &endptr);
+			if (endptr == value ||
+			    w->cw_shape.cls_zipf_theta <= 0.0 ||
+			    w->cw_shape.cls_zipf_theta >= 1.0)
+				parser_emit_error("ZIPF_THETA must be in (0, 1): "
+						  "'%s'", value);
+			break;
+		case HOT_SET_PRCNT:
+			w = &load[*index];
+			w->cw_shape.cls_hot_set_prcnt =
+				parse_prcnt(value, HOT_SET_PRCNT);
+			if (w->cw_shape.cls_hot_set_prcnt == 0)
+				parser_emit_error("HOT_SET_PRCNT must be > 0");
+			break;
+		case HOT_OPS_PRCNT:
+			w = &load[*index];
+			w->cw_shape.cls_hot_ops_prcnt =
+				parse_prcnt(value, HOT_OPS_PRCNT);
+			break;
+		case RESULTS_JSON:
+			w = &load[*index];
+			w->cw_shape.cls_json = m0_alloc(value_len + 1);
+			if (w->cw_shape.cls_json == NULL)
+				return -ENOMEM;
+			strcpy(w->cw_shape.cls_json, value);
+			break;
 		default:
 			break;
 	}
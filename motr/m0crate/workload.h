@@ -59,6 +59,7 @@ enum cr_workload_type {
 	CWT_IO,
 	CWT_INDEX,
 	CWT_BTREE,  /* Btree Operations */
+	CWT_MIX,    /* Correlated object and index operations */
         CWT_NR
 };
 
@@ -72,6 +73,37 @@ enum swab_type {
         ST_NR
 };
 
+/** Key (and block offset) popularity distributions. */
+enum cr_key_dist {
+	/** Every key is equally likely (default). */
+	CKD_UNIFORM,
+	/** Zipfian: rank r is selected with probability ~ 1/r^theta. */
+	CKD_ZIPF,
+	/** HOT_OPS_PRCNT% of ops go to the first HOT_SET_PRCNT% of keys. */
+	CKD_HOTSET,
+	CKD_NR
+};
+
+/**
+ * Shape of the load offered by a workload: arrival process, key popularity
+ * and where the machine-readable results go. Shared by I/O and index
+ * workloads.
+ */
+struct cr_load_shape {
+	/**
+	 * Operations per second issued by each thread. 0 means closed loop:
+	 * the next operation is issued as soon as a slot is free.
+	 */
+	uint64_t          cls_rate;
+	enum cr_key_dist  cls_dist;
+	/** Zipf skew, 0 < theta < 1. */
+	double            cls_zipf_theta;
+	int               cls_hot_set_prcnt;
+	int               cls_hot_ops_prcnt;
+	/** File the JSON results are appended to, "-" for stdout. */
+	char             *cls_json;
+};
+
 /* description of the whole workload */
 struct workload {
         enum cr_workload_type  cw_type;
@@ -96,11 +128,13 @@ struct workload {
 	short                  cw_read_frac;
         struct timeval         cw_rate;
         pthread_mutex_t        cw_lock;
+	struct cr_load_shape   cw_shape;
 
         union {
 		void *cw_io;
 		void *cw_index;
 		void *cw_btree;
+		void *cw_mix;
                 struct cr_hpcs {
                 } cw_hpcs;
                 struct cr_csum {
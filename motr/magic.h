@@ -245,6 +245,9 @@ enum m0_magic_satchel {
 	/* m0_conf_cache::ca_registry::t_magic (fabled feodal) */
 	M0_CONF_CACHE_MAGIC = 0x33fab1edfe0da177,
 
+	/* m0_conf_cache::ca_index bucket lists (ballad scaled) */
+	M0_CONF_CACHE_INDEX_MAGIC = 0x33ba11ad5ca1ed77,
+
 	/* m0_conf_obj::co_gen_magic (selfless cell) */
 	M0_CONF_OBJ_MAGIC = 0x335e1f1e55ce1177,
 
@@ -419,6 +422,12 @@ enum m0_magic_satchel {
 	/* ca_tl::td_head_magic (scaffold sale) */
 	M0_DESIM_SIM_THREAD_HEAD_MAGIC = 0x335caff01d5a1e77,
 
+	/* mio_rpc::mr_magic (a basal facade) */
+	M0_DESIM_MIO_RPC_MAGIC = 0x33aba5a1facade77,
+
+	/* mrpc_tl::td_head_magic (scaled decade) */
+	M0_DESIM_MIO_RPC_HEAD_MAGIC = 0x335ca1eddecade77,
+
 /* DTM */
 	/* m0_dtm_up::du_magix (blessed feoff) */
 	M0_DTM_UP_MAGIX = 0x33b1e55edfe0ff77,
@@ -1117,6 +1126,10 @@ enum m0_magic_satchel {
 	M0_RM_MAGIC           = 0x331CE1CE1C0E2277,
 	/* rm_ctx_tl::td_head_magic (coca cola sea) */
 	M0_RM_HEAD_MAGIC      = 0x33C0CAC01A5EA277,
+	/* m0_rm_lock_ctx::rmc_lru_magic (idle cadillac) */
+	M0_RM_LRU_MAGIC       = 0x331D1ECAD111AC77,
+	/* rm_ctx_lru_tl::td_head_magic (dead cod cafe) */
+	M0_RM_LRU_HEAD_MAGIC  = 0x33DEADC0DCAFE277,
 
 /* module/param */
 	/* m0_param_source::ps_magic (boozed billie) */
@@ -1154,6 +1167,11 @@ enum m0_magic_satchel {
 	M0_DIX_ROP_HEAD_MAGIC  = 0x33ba51c0ff10ad77,
 	/** struct m0_dix_cm::dcm_magic (dixdixdixdix) */
 	M0_DIX_CM_MAGIC        = 0x33d18d18d18d1877,
+/* CAS */
+	/** cas_cursor::cc_magic (cassia decoded) */
+	M0_CAS_CURSOR_MAGIC      = 0x33ca551adec0de77,
+	/** cas_cursor_tlist head magic (cassia bedded) */
+	M0_CAS_CURSOR_HEAD_MAGIC = 0x33ca551abedded77,
 /* DTM0 */
 	/** m0_bob_type::bt_magix (zodiacal bass) */
 	M0_DTM0_SVC_MAGIC       = 0x3320d1aca1ba5577,
@@ -1203,6 +1221,18 @@ enum m0_magic_satchel {
 	M0_FDMI_SRC_DOCK_PENDING_FOP_MAGIC = 0xf1eece0ff1ce,
 	/* pending_fops list head magic (feosol obsess) */
 	M0_FDMI_SRC_DOCK_PENDING_FOP_HEAD_MAGIC = 0xfe05010b5e55,
+	/* fdmi_flt_entry::fe_magic (fallable seed) */
+	M0_FDMI_FLT_SET_ENTRY_MAGIC = 0x33fa11ab1e5eed77,
+	/* fdmi_flt_entry list head magic (boased salads) */
+	M0_FDMI_FLT_SET_ENTRY_HEAD_MAGIC = 0x33b0a5ed5a1ad577,
+	/* fdmi_flt_var::fv_magic (cascadable doe) */
+	M0_FDMI_FLT_SET_VAR_MAGIC = 0x33ca5cadab1ed077,
+	/* fdmi_flt_var list head magic (decade of seed) */
+	M0_FDMI_FLT_SET_VAR_HEAD_MAGIC = 0x33decade0f5eed77,
+	/* fdmi_flt_bucket::fb_magic (feedable cab) */
+	M0_FDMI_FLT_SET_BUCKET_MAGIC = 0x33feedab1eca8077,
+	/* fdmi_flt_bucket hash head magic (baffled lobe) */
+	M0_FDMI_FLT_SET_BUCKET_HEAD_MAGIC = 0x33baff1ed10be077,
 /* DTM0 */
 	/* be/dtm0_log.c::dlr_tlink (be fifo head) */
 	M0_BE_DTM0_LOG_MAGIX = 0x33d73010600077,
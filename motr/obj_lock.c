@@ -29,6 +29,7 @@
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CLIENT
 
 #include "lib/trace.h"
+#include "lib/finject.h"
 #include "motr/client.h"
 #include "motr/client_internal.h"
 #include "motr/io.h"
@@ -79,6 +80,118 @@ M0_HT_DESCR_DEFINE(rm_ctx, "Hash-table for RM locks", M0_INTERNAL,
 
 M0_HT_DEFINE(rm_ctx, M0_INTERNAL, struct m0_rm_lock_ctx, struct m0_fid);
 
+M0_TL_DESCR_DEFINE(rm_ctx_lru, "Idle RM lock contexts", static,
+		   struct m0_rm_lock_ctx, rmc_lru_link, rmc_lru_magic,
+		   M0_RM_LRU_MAGIC, M0_RM_LRU_HEAD_MAGIC);
+
+M0_TL_DEFINE(rm_ctx_lru, static, struct m0_rm_lock_ctx);
+
+static bool rm_ctx_is_stale(const struct m0_client      *m0c,
+			    const struct m0_rm_lock_ctx *ctx,
+			    m0_time_t                    expired,
+			    bool                         all)
+{
+	return all || m0c->m0c_rm_ctx_lru_nr > M0_RM_CTX_IDLE_MAX ||
+	       ctx->rmc_idle_since < expired;
+}
+
+/**
+ * Finalises idle contexts whose lease has expired or which don't fit into
+ * M0_RM_CTX_IDLE_MAX, or all of them if @all is set. Finalisation winds the
+ * owner up, which returns the cached credits to the creditor.
+ *
+ * Contexts are looked up again by key under their hash bucket lock, as
+ * m0_obj_lock_init() may have taken one of them from the list meanwhile.
+ */
+static void rm_ctx_lru_evict(struct m0_client *m0c, bool all)
+{
+	struct m0_rm_lock_ctx *ctx;
+	struct m0_fid          key;
+	m0_time_t              expired;
+
+	M0_ENTRY("m0c=%p all=%d", m0c, !!all);
+	while (true) {
+		expired = m0_time_sub(m0_time_now(), m0c->m0c_rm_ctx_lease);
+		m0_mutex_lock(&m0c->m0c_rm_ctx_lru_lock);
+		ctx = rm_ctx_lru_tlist_head(&m0c->m0c_rm_ctx_lru);
+		if (ctx == NULL || !rm_ctx_is_stale(m0c, ctx, expired, all)) {
+			m0_mutex_unlock(&m0c->m0c_rm_ctx_lru_lock);
+			break;
+		}
+		key = ctx->rmc_key;
+		m0_mutex_unlock(&m0c->m0c_rm_ctx_lru_lock);
+
+		rm_ctx_hbucket_lock(&m0c->m0c_rm_ctxs, &key);
+		ctx = rm_ctx_htable_lookup(&m0c->m0c_rm_ctxs, &key);
+		m0_mutex_lock(&m0c->m0c_rm_ctx_lru_lock);
+		if (ctx != NULL && rm_ctx_lru_tlink_is_in(ctx) &&
+		    rm_ctx_is_stale(m0c, ctx, expired, all)) {
+			rm_ctx_lru_tlist_del(ctx);
+			M0_CNT_DEC(m0c->m0c_rm_ctx_lru_nr);
+			rm_ctx_htable_del(&m0c->m0c_rm_ctxs, ctx);
+		} else
+			ctx = NULL;
+		m0_mutex_unlock(&m0c->m0c_rm_ctx_lru_lock);
+		rm_ctx_hbucket_unlock(&m0c->m0c_rm_ctxs, &key);
+		if (ctx != NULL) {
+			M0_LOG(M0_DEBUG, "evict "FID_F, FID_P(&key));
+			m0_ref_put(&ctx->rmc_ref);
+		}
+	}
+	M0_LEAVE();
+}
+
+/**
+ * Evicts the idle contexts twice per lease. Finalising a context waits for
+ * its owner to wind up, which is not allowed in the AST context of a soft
+ * timer or a locality chore, hence a dedicated thread.
+ */
+static void rm_ctx_reaper(struct m0_client *m0c)
+{
+	while (m0c->m0c_rm_ctx_reaper_active) {
+		m0_semaphore_timeddown(&m0c->m0c_rm_ctx_reaper_wake,
+				       m0_time_add(m0_time_now(),
+						   m0c->m0c_rm_ctx_lease / 2));
+		rm_ctx_lru_evict(m0c, false);
+	}
+}
+
+M0_INTERNAL void m0_obj_lock_ctxs_init(struct m0_client *m0c)
+{
+	int rc;
+
+	rm_ctx_htable_init(&m0c->m0c_rm_ctxs, M0_RM_HBUCKET_NR);
+	rm_ctx_lru_tlist_init(&m0c->m0c_rm_ctx_lru);
+	m0c->m0c_rm_ctx_lru_nr = 0;
+	m0_mutex_init(&m0c->m0c_rm_ctx_lru_lock);
+	m0c->m0c_rm_ctx_lease = M0_MKTIME(M0_RM_CTX_LEASE_SECS, 0);
+	m0_semaphore_init(&m0c->m0c_rm_ctx_reaper_wake, 0);
+	m0c->m0c_rm_ctx_reaper_active = true;
+	rc = M0_THREAD_INIT(&m0c->m0c_rm_ctx_reaper, struct m0_client *,
+			    NULL, &rm_ctx_reaper, m0c, "client:rm-reaper");
+	if (rc != 0) {
+		/* Idle contexts are still evicted by m0_obj_lock_fini(). */
+		M0_LOG(M0_WARN, "Cannot start the RM context reaper: %d", rc);
+		m0c->m0c_rm_ctx_reaper_active = false;
+	}
+}
+
+M0_INTERNAL void m0_obj_lock_ctxs_fini(struct m0_client *m0c)
+{
+	if (m0c->m0c_rm_ctx_reaper_active) {
+		m0c->m0c_rm_ctx_reaper_active = false;
+		m0_semaphore_up(&m0c->m0c_rm_ctx_reaper_wake);
+		m0_thread_join(&m0c->m0c_rm_ctx_reaper);
+		m0_thread_fini(&m0c->m0c_rm_ctx_reaper);
+	}
+	m0_semaphore_fini(&m0c->m0c_rm_ctx_reaper_wake);
+	rm_ctx_lru_evict(m0c, true);
+	M0_ASSERT(m0c->m0c_rm_ctx_lru_nr == 0);
+	m0_mutex_fini(&m0c->m0c_rm_ctx_lru_lock);
+	rm_ctx_lru_tlist_fini(&m0c->m0c_rm_ctx_lru);
+	rm_ctx_htable_fini(&m0c->m0c_rm_ctxs);
+}
+
 int m0_obj_lock_init(struct m0_obj *obj)
 {
 	struct m0_fid          fid;
@@ -93,9 +206,16 @@ int m0_obj_lock_init(struct m0_obj *obj)
 	M0_LOG(M0_INFO, FID_F, FID_P(&fid));
 	rm_ctx_hbucket_lock(&m0c->m0c_rm_ctxs, &fid);
 	ctx = rm_ctx_htable_lookup(&m0c->m0c_rm_ctxs, &fid);
-	if (ctx != NULL)
-		m0_ref_get(&ctx->rmc_ref);
-	else {
+	if (ctx != NULL) {
+		m0_mutex_lock(&m0c->m0c_rm_ctx_lru_lock);
+		if (rm_ctx_lru_tlink_is_in(ctx)) {
+			/* Idle ctx, take over the reference of the cache. */
+			rm_ctx_lru_tlist_del(ctx);
+			M0_CNT_DEC(m0c->m0c_rm_ctx_lru_nr);
+		} else
+			m0_ref_get(&ctx->rmc_ref);
+		m0_mutex_unlock(&m0c->m0c_rm_ctx_lru_lock);
+	} else {
 		M0_ALLOC_PTR(ctx);
 		if (ctx == NULL) {
 			rm_ctx_hbucket_unlock(&m0c->m0c_rm_ctxs, &fid);
@@ -120,15 +240,21 @@ static void rm_ctx_init(struct m0_rm_lock_ctx *ctx,
 
 	M0_ENTRY();
 
-	rdom = rm_domain_get(m0c);
-	M0_ASSERT(rdom != NULL);
-
 	ctx->rmc_magic = M0_RM_MAGIC;
 	ctx->rmc_htable = &m0c->m0c_rm_ctxs;
 	ctx->rmc_key = *fid;
 	m0_cookie_new(&ctx->rmc_gen);
 	rm_ctx_tlink_init(ctx);
+	rm_ctx_lru_tlink_init(ctx);
 	m0_ref_init(&ctx->rmc_ref, 1, rm_ctx_fini);
+	/* UT of the context cache, which runs without an RM service. */
+	if (M0_FI_ENABLED("no_rm")) {
+		M0_LEAVE();
+		return;
+	}
+
+	rdom = rm_domain_get(m0c);
+	M0_ASSERT(rdom != NULL);
 	m0_rw_lockable_init(&ctx->rmc_rw_file, &ctx->rmc_key, rdom);
 	m0_rm_remote_init(&ctx->rmc_creditor, &ctx->rmc_rw_file.rwl_resource);
 	ctx->rmc_creditor.rem_session = m0_pools_common_active_rm_session(pc);
@@ -144,18 +270,29 @@ static void rm_ctx_init(struct m0_rm_lock_ctx *ctx,
 void m0_obj_lock_fini(struct m0_obj *obj)
 {
 	struct m0_rm_lock_ctx *ctx;
+	struct m0_client      *m0c;
 
 	M0_ENTRY();
 	M0_PRE(obj != NULL);
 
+	m0c = obj->ob_entity.en_realm->re_instance;
 	ctx = m0_cookie_of(&obj->ob_cookie, struct m0_rm_lock_ctx,
 			   rmc_gen);
 	M0_ASSERT(ctx != NULL);
 	rm_ctx_hbucket_lock(ctx->rmc_htable, &ctx->rmc_key);
 	if (m0_ref_read(&ctx->rmc_ref) == 1) {
-		rm_ctx_htable_del(ctx->rmc_htable, ctx);
+		/*
+		 * Last user. Keep the ctx: its owner caches the borrowed
+		 * credits, so the next lock of the object is granted
+		 * locally. The creditor still revokes them on conflict.
+		 */
+		ctx->rmc_idle_since = m0_time_now();
+		m0_mutex_lock(&m0c->m0c_rm_ctx_lru_lock);
+		rm_ctx_lru_tlist_add_tail(&m0c->m0c_rm_ctx_lru, ctx);
+		M0_CNT_INC(m0c->m0c_rm_ctx_lru_nr);
+		m0_mutex_unlock(&m0c->m0c_rm_ctx_lru_lock);
 		rm_ctx_hbucket_unlock(ctx->rmc_htable, &ctx->rmc_key);
-		m0_ref_put(&ctx->rmc_ref);
+		rm_ctx_lru_evict(m0c, false);
 	} else {
 		m0_ref_put(&ctx->rmc_ref);
 		rm_ctx_hbucket_unlock(ctx->rmc_htable, &ctx->rmc_key);
@@ -174,14 +311,17 @@ static void rm_ctx_fini(struct m0_ref *ref)
 
 	ctx = M0_AMB(ctx, ref, rmc_ref);
 
-	m0_rm_owner_windup(&ctx->rmc_owner);
-	rc = m0_rm_owner_timedwait(&ctx->rmc_owner,
-				   M0_BITS(ROS_FINAL, ROS_INSOLVENT),
-				   M0_TIME_NEVER);
-	M0_ASSERT(rc == 0);
-	m0_rm_rwlock_owner_fini(&ctx->rmc_owner);
-	m0_rm_remote_fini(&ctx->rmc_creditor);
-	m0_rw_lockable_fini(&ctx->rmc_rw_file);
+	if (!M0_FI_ENABLED("no_rm")) {
+		m0_rm_owner_windup(&ctx->rmc_owner);
+		rc = m0_rm_owner_timedwait(&ctx->rmc_owner,
+					   M0_BITS(ROS_FINAL, ROS_INSOLVENT),
+					   M0_TIME_NEVER);
+		M0_ASSERT(rc == 0);
+		m0_rm_rwlock_owner_fini(&ctx->rmc_owner);
+		m0_rm_remote_fini(&ctx->rmc_creditor);
+		m0_rw_lockable_fini(&ctx->rmc_rw_file);
+	}
+	rm_ctx_lru_tlink_fini(ctx);
 	rm_ctx_tlink_fini(ctx);
 	m0_free(ctx);
 
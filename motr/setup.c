@@ -24,6 +24,7 @@
 #include <sys/stat.h>  /* mkdir */
 #include <unistd.h>    /* daemon */
 #include <err.h>
+#include <stdlib.h>    /* getenv */
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_M0D
 #include "lib/trace.h"
@@ -1535,6 +1536,14 @@ static int cs_be_init(struct m0_reqh_context *rctx,
 		be->but_dom_cfg.bc_engine.bec_group_freeze_timeout_max =
 			rctx->rc_be_tx_group_freeze_timeout_max;
 	}
+	if (rctx->rc_be_tx_group_commit_latency_target > 0) {
+		be->but_dom_cfg.bc_engine.bec_group_commit_latency_target =
+			rctx->rc_be_tx_group_commit_latency_target;
+	}
+	if (rctx->rc_be_tx_group_merge_thread_nr > 0) {
+		be->but_dom_cfg.bc_engine.bec_group_merge_thread_nr =
+			rctx->rc_be_tx_group_merge_thread_nr;
+	}
 	rc = cs_be_dom_cfg_zone_pcnt_fill(&rctx->rc_reqh, &be->but_dom_cfg);
 	if (rc != 0)
 		goto err;
@@ -2380,10 +2389,52 @@ static int _args_parse(struct m0_motr *cctx, int argc, char **argv)
 	return M0_RC(rc_getops ?: rc);
 }
 
+static int cs_env_number_get(const char *name, uint64_t *out)
+{
+	const char *s = getenv(name);
+	char       *end;
+	uint64_t    val;
+
+	if (s == NULL)
+		return 0;
+	val = m0_strtou64(s, &end, 0);
+	if (*s == '\0' || *end != '\0')
+		return M0_ERR_INFO(-EINVAL, "%s=%s", name, s);
+	*out = val;
+	return 0;
+}
+
+/**
+ * Parses the request handler options passed through the environment.
+ *
+ * All single-letter options (-W is reserved by getopt) are taken, so newer
+ * BE tunables are read from M0_BE_* environment variables.
+ */
+static int cs_env_parse(struct m0_reqh_context *rctx)
+{
+	uint64_t latency_us = 0;
+	uint64_t thread_nr = 0;
+	int      rc;
+
+	rc = cs_env_number_get("M0_BE_TX_GROUP_COMMIT_LATENCY_US",
+			       &latency_us) ?:
+	     cs_env_number_get("M0_BE_TX_GROUP_MERGE_THREAD_NR", &thread_nr);
+	if (rc == 0 && thread_nr > UINT32_MAX)
+		rc = M0_ERR_INFO(-EINVAL, "merge thread nr: %"PRIu64,
+				 thread_nr);
+	if (rc == 0) {
+		rctx->rc_be_tx_group_commit_latency_target =
+			latency_us * M0_TIME_ONE_MSEC / 1000;
+		rctx->rc_be_tx_group_merge_thread_nr = thread_nr;
+	}
+	return M0_RC(rc);
+}
+
 static int cs_args_parse(struct m0_motr *cctx, int argc, char **argv)
 {
 	M0_ENTRY();
-	return _args_parse(cctx, argc, argv);
+	return _args_parse(cctx, argc, argv) ?:
+	       cs_env_parse(&cctx->cc_reqh_ctx);
 }
 
 static void cs_ha_connect(struct m0_motr *cctx)
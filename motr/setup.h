@@ -288,6 +288,8 @@ struct m0_reqh_context {
 	m0_bcount_t                  rc_be_tx_payload_size_max;
 	m0_time_t                    rc_be_tx_group_freeze_timeout_min;
 	m0_time_t                    rc_be_tx_group_freeze_timeout_max;
+	m0_time_t                    rc_be_tx_group_commit_latency_target;
+	uint32_t                     rc_be_tx_group_merge_thread_nr;
 
 	/**
 	 * Default path to the configuration database.
@@ -0,0 +1,152 @@
+#!/bin/bash
+#
+# Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# For any questions about this software or licensing,
+# please email opensource@seagate.com or cortx-questions@seagate.com.
+#
+
+
+#set -x
+
+motr_st_util_dir=$( cd "$(dirname "$0")" ; pwd -P )
+m0t1fs_dir="$motr_st_util_dir/../../../m0t1fs/linux_kernel/st"
+
+# Re-use as many m0t1fs system scripts as possible
+. "$m0t1fs_dir"/common.sh
+. "$m0t1fs_dir"/m0t1fs_common_inc.sh
+. "$m0t1fs_dir"/m0t1fs_client_inc.sh
+. "$m0t1fs_dir"/m0t1fs_server_inc.sh
+
+. "$motr_st_util_dir"/motr_local_conf.sh
+. "$motr_st_util_dir"/motr_st_inc.sh
+
+N=2
+K=1
+S=1
+P=4
+stride=32
+multiple_pools=1
+# Pools of m0t1fs_common_inc.sh with multiple_pools == 1.
+POOL_TIER1="<0x6f00000000000001:0x9>"
+POOL_TIER2="<0x6f0000000000000a:0x1>"
+# Not a whole number of parity groups, to get partial blocks.
+SIZE_SMALL=$((1024 * 1024 + 96 * 1024))
+# Several blocks of the maximal size.
+SIZE_LARGE=$((40 * 1024 * 1024))
+
+MOTR_TEST_DIR=$SANDBOX_DIR
+MOTR_TEST_LOGFILE=$SANDBOX_DIR/motr_`date +"%Y-%m-%d_%T"`.log
+MOTR_TRACE_DIR=$SANDBOX_DIR/motr
+M0HSM="$M0_SRC_DIR/hsm/m0hsm"
+
+m0hsm_env_init()
+{
+	export HOME="$MOTR_TEST_DIR"
+	export CLIENT_LADDR="$MOTR_LOCAL_EP"
+	export CLIENT_HA_ADDR="$MOTR_HA_EP"
+	export CLIENT_PROFILE="<$MOTR_PROF_OPT>"
+	export CLIENT_PROC_FID="<$MOTR_PROC_FID>"
+
+	mkdir -p "$HOME/.hsm"
+	cat > "$HOME/.hsm/config" <<EOF
+M0_POOL_TIER1 = $POOL_TIER1
+M0_POOL_TIER2 = $POOL_TIER2
+EOF
+}
+
+# Writes an object on tier 1, moves it to tier 2 with the given copy depth
+# and checks that the data read back from tier 2 is the same.
+m0hsm_move_test()
+{
+	local fid=$1
+	local len=$2
+	local depth=$3
+	local before="$MOTR_TEST_DIR/m0hsm_$fid.before"
+	local after="$MOTR_TEST_DIR/m0hsm_$fid.after"
+	local out="$MOTR_TEST_DIR/m0hsm_$fid.log"
+
+	echo "m0hsm move: fid=$fid len=$len depth=$depth"
+	$M0HSM create $fid 1 &>> "$MOTR_TEST_LOGFILE" &&
+	$M0HSM write $fid 0 $len $fid &>> "$MOTR_TEST_LOGFILE" &&
+	$M0HSM read $fid 0 $len > "$before" 2>> "$MOTR_TEST_LOGFILE" &&
+	$M0HSM -d $depth move $fid 0 $len 1 2 &> "$out" &&
+	$M0HSM read $fid 0 $len > "$after" 2>> "$MOTR_TEST_LOGFILE" || {
+		cat "$out" >> "$MOTR_TEST_LOGFILE"
+		echo "m0hsm failed"
+		return 1
+	}
+	cat "$out" >> "$MOTR_TEST_LOGFILE"
+	grep -q "MB/s" "$out" || {
+		echo "No copy throughput reported"
+		return 1
+	}
+	[ $(stat -c %s "$before") -ge $len ] || {
+		echo "Short read"
+		return 1
+	}
+	cmp "$before" "$after" || {
+		echo "Data differ after the move"
+		return 1
+	}
+	rm -f "$before" "$after" "$out"
+	return 0
+}
+
+m0hsm_test()
+{
+	local rc=0
+
+	motr_service start $multiple_pools $stride $N $K $S $P || {
+		echo "Failed to start Motr Service..."
+		return 1
+	}
+	dix_init
+	m0hsm_env_init
+
+	m0hsm_move_test 0x1001 $SIZE_SMALL 1 &&
+	m0hsm_move_test 0x1002 $SIZE_SMALL 4 &&
+	m0hsm_move_test 0x1003 $SIZE_LARGE 1 &&
+	m0hsm_move_test 0x1004 $SIZE_LARGE 3 &&
+	m0hsm_move_test 0x1005 $SIZE_LARGE 8 || rc=1
+
+	motr_service_stop || rc=1
+	return $rc
+}
+
+main()
+{
+	local rc
+
+	sandbox_init
+	mkdir "$MOTR_TRACE_DIR"
+
+	m0hsm_test
+	rc=$?
+	if [ $rc -ne "0" ]
+	then
+		echo "m0hsm tier-to-tier copy test failed"
+		echo "Test log file available at $MOTR_TEST_LOGFILE"
+		return $rc
+	fi
+
+	sandbox_fini
+	return 0
+}
+
+echo "m0hsm tier-to-tier copy test"
+trap unprepare EXIT
+main
+report_and_exit m0hsm-copy $?
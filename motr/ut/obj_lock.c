@@ -0,0 +1,185 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/*
+ * UT of the RM lock context cache of m0_obj_lock_{init,fini}(). Contexts
+ * are created without RM owners ("no_rm" fault injection), so only the
+ * cache itself is tested: lookup, reuse of idle contexts and their
+ * eviction by the reaper once the lease has expired. The default lease is
+ * kept until the eviction test, so that the contexts stay idle meanwhile.
+ */
+
+#include "ut/ut.h"              /* M0_UT_ASSERT */
+#include "lib/finject.h"
+#include "lib/memory.h"         /* M0_ALLOC_PTR */
+#include "lib/time.h"           /* m0_nanosleep */
+
+#include "motr/client.h"
+#include "motr/client_internal.h"
+
+enum {
+	/** Lease of the idle contexts, ms. */
+	OL_LEASE_MS = 20,
+	/** How long the reaper is waited for, in leases. */
+	OL_WAIT_NR  = 100,
+};
+
+static struct m0_client *ol_m0c;
+static struct m0_realm   ol_realm;
+
+static void ol_obj_init(struct m0_obj *obj, uint64_t key)
+{
+	M0_SET0(obj);
+	obj->ob_entity.en_realm = &ol_realm;
+	obj->ob_entity.en_id = M0_ID_APP;
+	obj->ob_entity.en_id.u_lo += key;
+	M0_UT_ASSERT(m0_obj_lock_init(obj) == 0);
+}
+
+static struct m0_rm_lock_ctx *ol_ctx(struct m0_obj *obj)
+{
+	return m0_cookie_of(&obj->ob_cookie, struct m0_rm_lock_ctx, rmc_gen);
+}
+
+static uint32_t ol_idle_nr(void)
+{
+	uint32_t nr;
+
+	m0_mutex_lock(&ol_m0c->m0c_rm_ctx_lru_lock);
+	nr = ol_m0c->m0c_rm_ctx_lru_nr;
+	m0_mutex_unlock(&ol_m0c->m0c_rm_ctx_lru_lock);
+	return nr;
+}
+
+/** Locks of the same object share one context. */
+static void ut_test_obj_lock_ctx_hit(void)
+{
+	struct m0_obj          o0;
+	struct m0_obj          o1;
+	struct m0_obj          o2;
+	struct m0_rm_lock_ctx *ctx;
+
+	ol_obj_init(&o0, 1);
+	ol_obj_init(&o1, 1);
+	ol_obj_init(&o2, 2);
+	ctx = ol_ctx(&o0);
+	M0_UT_ASSERT(ctx != NULL);
+	M0_UT_ASSERT(ol_ctx(&o1) == ctx);
+	M0_UT_ASSERT(ol_ctx(&o2) != ctx);
+	M0_UT_ASSERT(m0_ref_read(&ctx->rmc_ref) == 2);
+	M0_UT_ASSERT(rm_ctx_htable_size(&ol_m0c->m0c_rm_ctxs) == 2);
+
+	m0_obj_lock_fini(&o1);
+	M0_UT_ASSERT(m0_ref_read(&ctx->rmc_ref) == 1);
+	M0_UT_ASSERT(ol_idle_nr() == 0);
+	m0_obj_lock_fini(&o0);
+	m0_obj_lock_fini(&o2);
+	/* The contexts are kept idle, not finalised. */
+	M0_UT_ASSERT(ol_idle_nr() == 2);
+	M0_UT_ASSERT(rm_ctx_htable_size(&ol_m0c->m0c_rm_ctxs) == 2);
+}
+
+/** Locking an object again takes its idle context off the list. */
+static void ut_test_obj_lock_ctx_reuse(void)
+{
+	struct m0_obj          obj;
+	struct m0_rm_lock_ctx *ctx;
+	uint32_t               idle_nr;
+
+	ol_obj_init(&obj, 3);
+	ctx = ol_ctx(&obj);
+	m0_obj_lock_fini(&obj);
+	idle_nr = ol_idle_nr();
+	M0_UT_ASSERT(idle_nr > 0);
+
+	ol_obj_init(&obj, 3);
+	M0_UT_ASSERT(ol_ctx(&obj) == ctx);
+	M0_UT_ASSERT(m0_ref_read(&ctx->rmc_ref) == 1);
+	M0_UT_ASSERT(ol_idle_nr() == idle_nr - 1);
+	m0_obj_lock_fini(&obj);
+	M0_UT_ASSERT(ol_idle_nr() == idle_nr);
+}
+
+/**
+ * Idle contexts are finalised by the reaper after the lease, without any
+ * other lock call.
+ */
+static void ut_test_obj_lock_ctx_evict(void)
+{
+	struct m0_obj obj;
+	int           i;
+
+	/* Shorten the lease and let the reaper pick it up. */
+	ol_m0c->m0c_rm_ctx_lease = M0_MKTIME(0, OL_LEASE_MS * 1000000);
+	m0_semaphore_up(&ol_m0c->m0c_rm_ctx_reaper_wake);
+
+	ol_obj_init(&obj, 4);
+	m0_obj_lock_fini(&obj);
+	M0_UT_ASSERT(ol_idle_nr() > 0);
+	for (i = 0; i < OL_WAIT_NR && ol_idle_nr() > 0; ++i)
+		m0_nanosleep(m0_time(0, OL_LEASE_MS * 1000000), NULL);
+	M0_UT_ASSERT(ol_idle_nr() == 0);
+	M0_UT_ASSERT(rm_ctx_htable_size(&ol_m0c->m0c_rm_ctxs) == 0);
+}
+
+static int ut_obj_lock_init(void)
+{
+	m0_fi_enable("rm_ctx_init", "no_rm");
+	m0_fi_enable("rm_ctx_fini", "no_rm");
+	M0_ALLOC_PTR(ol_m0c);
+	M0_UT_ASSERT(ol_m0c != NULL);
+	m0_obj_lock_ctxs_init(ol_m0c);
+	M0_UT_ASSERT(ol_m0c->m0c_rm_ctx_reaper_active);
+	ol_realm.re_instance = ol_m0c;
+	return 0;
+}
+
+static int ut_obj_lock_fini(void)
+{
+	m0_obj_lock_ctxs_fini(ol_m0c);
+	m0_free(ol_m0c);
+	m0_fi_disable("rm_ctx_fini", "no_rm");
+	m0_fi_disable("rm_ctx_init", "no_rm");
+	return 0;
+}
+
+struct m0_ut_suite ut_suite_obj_lock = {
+	.ts_name = "obj-lock-ut",
+	.ts_init = ut_obj_lock_init,
+	.ts_fini = ut_obj_lock_fini,
+	.ts_tests = {
+		{ "ctx-hit",   ut_test_obj_lock_ctx_hit   },
+		{ "ctx-reuse", ut_test_obj_lock_ctx_reuse },
+		{ "ctx-evict", ut_test_obj_lock_ctx_evict },
+		{ NULL, NULL },
+	}
+};
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
@@ -42,6 +42,29 @@ M0_TL_DESCR_DEFINE(m0_net_pool, "net_buffer_pool", M0_INTERNAL,
 		   M0_NET_BUFFER_LINK_MAGIC, M0_NET_BUFFER_HEAD_MAGIC);
 M0_TL_DEFINE(m0_net_pool, M0_INTERNAL, struct m0_net_buffer);
 
+/**
+   Per-locality magazine of buffers, see m0_net_buffer_pool_cache_init().
+
+   pm_buf[0 .. pm_nr) is a stack: buffers are got from and put to the top,
+   and the bottom (coldest) buffers are returned to the pool when the magazine
+   overflows.
+
+   pm_colour[i] is the colour pm_buf[i] was put or got with. A get prefers the
+   topmost buffer of its colour and a flush returns each buffer to the pool
+   with its own colour, so colour affinity is kept as with the pool alone.
+ */
+struct m0_net_buffer_pool_mag {
+	struct m0_mutex        pm_lock;
+	uint32_t               pm_nr;
+	struct m0_net_buffer **pm_buf;
+	uint32_t              *pm_colour;
+	uint64_t               pm_hits;
+	uint64_t               pm_refills;
+	uint64_t               pm_flushes;
+	uint64_t               pm_bypasses;
+	uint64_t               pm_steals;
+};
+
 static bool pool_colour_check(const struct m0_net_buffer_pool *pool);
 static bool pool_lru_buffer_check(const struct m0_net_buffer_pool *pool);
 static bool colour_is_valid(const struct m0_net_buffer_pool *pool,
@@ -100,6 +123,10 @@ M0_INTERNAL int m0_net_buffer_pool_init(struct m0_net_buffer_pool *pool,
 	pool->nbp_colours_nr = colours;
 	pool->nbp_align      = shift;
 	pool->nbp_dont_dump  = dont_dump;
+	pool->nbp_mags       = NULL;
+	pool->nbp_mags_nr    = 0;
+	pool->nbp_mag_size   = 0;
+	pool->nbp_mag_short  = false;
 
 	if (colours == 0)
 		pool->nbp_colours = NULL;
@@ -160,6 +187,7 @@ M0_INTERNAL void m0_net_buffer_pool_fini(struct m0_net_buffer_pool *pool)
 
 	if (pool->nbp_colours == NULL && pool->nbp_colours_nr != 0)
 		return;
+	m0_net_buffer_pool_cache_fini(pool);
 	/*
 	 * The lock here is only needed to keep m0_net_buffer_pool_invariant()
 	 * happy. The caller must guarantee that there is no concurrency at this
@@ -322,6 +350,268 @@ M0_INTERNAL bool m0_net_buffer_pool_prune(struct m0_net_buffer_pool *pool)
 	return true;
 }
 
+static struct m0_net_buffer_pool_mag *
+pool_mag(const struct m0_net_buffer_pool *pool, uint32_t idx)
+{
+	return &pool->nbp_mags[idx % pool->nbp_mags_nr];
+}
+
+static void mag_push(struct m0_net_buffer_pool_mag *mag,
+		     struct m0_net_buffer *nb, uint32_t colour)
+{
+	mag->pm_colour[mag->pm_nr] = colour;
+	mag->pm_buf[mag->pm_nr++] = nb;
+}
+
+/**
+   Takes the topmost buffer of the given colour out of the magazine, or the
+   top buffer if there is none, as m0_net_buffer_pool_get() falls back to the
+   LRU list.
+ */
+static struct m0_net_buffer *mag_pop(struct m0_net_buffer_pool_mag *mag,
+				     uint32_t colour)
+{
+	struct m0_net_buffer *nb;
+	uint32_t              i = mag->pm_nr - 1;
+
+	M0_PRE(mag->pm_nr > 0);
+
+	if (colour != M0_BUFFER_ANY_COLOUR) {
+		while (i > 0 && mag->pm_colour[i] != colour)
+			--i;
+		if (mag->pm_colour[i] != colour)
+			i = mag->pm_nr - 1;
+	}
+	nb = mag->pm_buf[i];
+	--mag->pm_nr;
+	memmove(mag->pm_buf + i, mag->pm_buf + i + 1,
+		(mag->pm_nr - i) * sizeof mag->pm_buf[0]);
+	memmove(mag->pm_colour + i, mag->pm_colour + i + 1,
+		(mag->pm_nr - i) * sizeof mag->pm_colour[0]);
+	return nb;
+}
+
+/**
+   Returns up to "nr" coldest buffers of the magazine to the pool, each with
+   its own colour.
+   Called with both the magazine and the pool locked.
+ */
+static void mag_flush(struct m0_net_buffer_pool *pool,
+		      struct m0_net_buffer_pool_mag *mag, uint32_t nr)
+{
+	uint32_t i;
+
+	nr = min32u(nr, mag->pm_nr);
+	for (i = 0; i < nr; ++i)
+		m0_net_buffer_pool_put(pool, mag->pm_buf[i],
+				       mag->pm_colour[i]);
+	mag->pm_nr -= nr;
+	memmove(mag->pm_buf, mag->pm_buf + nr,
+		mag->pm_nr * sizeof mag->pm_buf[0]);
+	memmove(mag->pm_colour, mag->pm_colour + nr,
+		mag->pm_nr * sizeof mag->pm_colour[0]);
+}
+
+/**
+   Gets a buffer for the caller and refills the magazine with up to a half
+   of its capacity, without taking the pool below the threshold.
+   Called with both the magazine and the pool locked.
+ */
+static struct m0_net_buffer *mag_refill(struct m0_net_buffer_pool *pool,
+					struct m0_net_buffer_pool_mag *mag,
+					uint32_t colour)
+{
+	struct m0_net_buffer *nb;
+
+	nb = m0_net_buffer_pool_get(pool, colour);
+	if (nb == NULL)
+		return NULL;
+	while (mag->pm_nr < pool->nbp_mag_size / 2 &&
+	       pool->nbp_free > pool->nbp_threshold)
+		mag_push(mag, m0_net_buffer_pool_get(pool, colour), colour);
+	return nb;
+}
+
+/**
+   Returns buffers cached by all magazines to the pool, one magazine at a
+   time, until a buffer can be got from the pool.
+
+   The caller set nbp_mag_short under the pool lock before. Each magazine is
+   drained under its lock, so a put which is not seen here happens after the
+   magazine lock is released and sees nbp_mag_short.
+ */
+static struct m0_net_buffer *pool_steal(struct m0_net_buffer_pool *pool,
+					uint32_t colour)
+{
+	struct m0_net_buffer_pool_mag *mag;
+	struct m0_net_buffer          *nb = NULL;
+	uint32_t                       i;
+
+	for (i = 0; i < pool->nbp_mags_nr && nb == NULL; ++i) {
+		mag = &pool->nbp_mags[i];
+		m0_mutex_lock(&mag->pm_lock);
+		m0_net_buffer_pool_lock(pool);
+		if (mag->pm_nr > 0) {
+			mag_flush(pool, mag, mag->pm_nr);
+			++mag->pm_steals;
+		}
+		nb = m0_net_buffer_pool_get(pool, colour);
+		m0_net_buffer_pool_unlock(pool);
+		m0_mutex_unlock(&mag->pm_lock);
+	}
+	return nb;
+}
+
+M0_INTERNAL int m0_net_buffer_pool_cache_init(struct m0_net_buffer_pool *pool,
+					      uint32_t nr, uint32_t size)
+{
+	uint32_t i;
+
+	M0_PRE(m0_net_buffer_pool_is_not_locked(pool));
+	M0_PRE(pool->nbp_mags == NULL);
+	M0_PRE(nr > 0 && size > 1);
+
+	M0_ALLOC_ARR(pool->nbp_mags, nr);
+	if (pool->nbp_mags == NULL)
+		return M0_ERR(-ENOMEM);
+	pool->nbp_mags_nr  = nr;
+	pool->nbp_mag_size = size;
+	for (i = 0; i < nr; ++i)
+		m0_mutex_init(&pool->nbp_mags[i].pm_lock);
+	for (i = 0; i < nr; ++i) {
+		M0_ALLOC_ARR(pool->nbp_mags[i].pm_buf, size);
+		M0_ALLOC_ARR(pool->nbp_mags[i].pm_colour, size);
+		if (pool->nbp_mags[i].pm_buf == NULL ||
+		    pool->nbp_mags[i].pm_colour == NULL) {
+			m0_net_buffer_pool_cache_fini(pool);
+			return M0_ERR(-ENOMEM);
+		}
+	}
+	return 0;
+}
+
+M0_INTERNAL void m0_net_buffer_pool_cache_fini(struct m0_net_buffer_pool *pool)
+{
+	struct m0_net_buffer_pool_mag *mag;
+	uint32_t                       i;
+
+	M0_PRE(m0_net_buffer_pool_is_not_locked(pool));
+
+	if (pool->nbp_mags == NULL)
+		return;
+	m0_net_buffer_pool_lock(pool);
+	for (i = 0; i < pool->nbp_mags_nr; ++i) {
+		mag = &pool->nbp_mags[i];
+		mag_flush(pool, mag, mag->pm_nr);
+		m0_free(mag->pm_buf);
+		m0_free(mag->pm_colour);
+		m0_mutex_fini(&mag->pm_lock);
+	}
+	m0_net_buffer_pool_unlock(pool);
+	m0_free0(&pool->nbp_mags);
+	pool->nbp_mags_nr   = 0;
+	pool->nbp_mag_size  = 0;
+	pool->nbp_mag_short = false;
+}
+
+M0_INTERNAL struct m0_net_buffer *
+m0_net_buffer_pool_cache_get(struct m0_net_buffer_pool *pool, uint32_t idx,
+			     uint32_t colour)
+{
+	struct m0_net_buffer_pool_mag *mag;
+	struct m0_net_buffer          *nb;
+
+	M0_PRE(m0_net_buffer_pool_is_not_locked(pool));
+	M0_PRE(colour_is_valid(pool, colour));
+
+	if (pool->nbp_mags == NULL) {
+		m0_net_buffer_pool_lock(pool);
+		nb = m0_net_buffer_pool_get(pool, colour);
+		m0_net_buffer_pool_unlock(pool);
+		return nb;
+	}
+	mag = pool_mag(pool, idx);
+	m0_mutex_lock(&mag->pm_lock);
+	if (mag->pm_nr > 0) {
+		nb = mag_pop(mag, colour);
+		++mag->pm_hits;
+	} else {
+		m0_net_buffer_pool_lock(pool);
+		nb = mag_refill(pool, mag, colour);
+		if (nb == NULL)
+			pool->nbp_mag_short = true;
+		else if (pool->nbp_free > pool->nbp_threshold)
+			pool->nbp_mag_short = false;
+		m0_net_buffer_pool_unlock(pool);
+		++mag->pm_refills;
+	}
+	m0_mutex_unlock(&mag->pm_lock);
+	if (nb == NULL)
+		nb = pool_steal(pool, colour);
+	M0_POST(ergo(nb != NULL, nb->nb_pool == pool));
+	return nb;
+}
+
+M0_INTERNAL void m0_net_buffer_pool_cache_put(struct m0_net_buffer_pool *pool,
+					      uint32_t idx,
+					      struct m0_net_buffer *buf,
+					      uint32_t colour)
+{
+	struct m0_net_buffer_pool_mag *mag;
+
+	M0_PRE(m0_net_buffer_pool_is_not_locked(pool));
+	M0_PRE(colour_is_valid(pool, colour));
+	M0_PRE(buf != NULL && buf->nb_pool == pool);
+	M0_PRE(buf->nb_ep == NULL);
+	M0_PRE(!(buf->nb_flags & M0_NET_BUF_QUEUED));
+
+	if (pool->nbp_mags == NULL) {
+		m0_net_buffer_pool_lock(pool);
+		m0_net_buffer_pool_put(pool, buf, colour);
+		m0_net_buffer_pool_unlock(pool);
+		return;
+	}
+	mag = pool_mag(pool, idx);
+	m0_mutex_lock(&mag->pm_lock);
+	/* nbp_mag_short is read without the pool lock, see pool_steal(). */
+	if (pool->nbp_mag_short) {
+		m0_net_buffer_pool_lock(pool);
+		m0_net_buffer_pool_put(pool, buf, colour);
+		if (pool->nbp_free > pool->nbp_threshold)
+			pool->nbp_mag_short = false;
+		m0_net_buffer_pool_unlock(pool);
+		++mag->pm_bypasses;
+	} else {
+		if (mag->pm_nr == pool->nbp_mag_size) {
+			m0_net_buffer_pool_lock(pool);
+			mag_flush(pool, mag, pool->nbp_mag_size / 2);
+			m0_net_buffer_pool_unlock(pool);
+			++mag->pm_flushes;
+		}
+		mag_push(mag, buf, colour);
+	}
+	m0_mutex_unlock(&mag->pm_lock);
+}
+
+M0_INTERNAL void
+m0_net_buffer_pool_cache_stats(const struct m0_net_buffer_pool *pool,
+			       struct m0_net_buffer_pool_cache_stats *stats)
+{
+	const struct m0_net_buffer_pool_mag *mag;
+	uint32_t                             i;
+
+	M0_SET0(stats);
+	for (i = 0; i < pool->nbp_mags_nr; ++i) {
+		mag = &pool->nbp_mags[i];
+		stats->pcs_cached   += mag->pm_nr;
+		stats->pcs_hits     += mag->pm_hits;
+		stats->pcs_refills  += mag->pm_refills;
+		stats->pcs_flushes  += mag->pm_flushes;
+		stats->pcs_bypasses += mag->pm_bypasses;
+		stats->pcs_steals   += mag->pm_steals;
+	}
+}
+
 #undef M0_TRACE_SUBSYSTEM
 
 /** @} */ /* end of net_buffer_pool */
@@ -132,6 +132,18 @@
 	m0_net_buffer_pool_fini(&bp);
     @endcode
 
+    - Users which get and put buffers at a high rate from many localities can
+	put a per-locality cache in front of the pool. Cache operations must
+	be called without the pool lock held; "idx" is the caller's locality:
+    @code
+	rc = m0_net_buffer_pool_cache_init(&bp, nr_localities,
+					   M0_NET_BUFFER_POOL_MAG_SIZE);
+	...
+	nb = m0_net_buffer_pool_cache_get(&bp, idx, colour);
+	...
+	m0_net_buffer_pool_cache_put(&bp, idx, nb, colour);
+    @endcode
+
     @see Also see m0_net_tm_pool_attach() and @ref NetRQProvDLD
     "Auo-Provisioning of Receive Message Queue Buffers".
    @{
@@ -140,9 +152,12 @@
 enum {
 	M0_BUFFER_ANY_COLOUR	     = ~0,
 	M0_NET_BUFFER_POOL_THRESHOLD = 2,
+	/** Default capacity of a per-locality magazine. */
+	M0_NET_BUFFER_POOL_MAG_SIZE  = 16,
 };
 
 struct m0_net_buffer_pool;
+struct m0_net_buffer_pool_mag;
 
 /** Call backs that buffer pool can trigger on different memory conditions. */
 struct m0_net_buffer_pool_ops {
@@ -241,6 +256,95 @@ M0_INTERNAL void m0_net_buffer_pool_put(struct m0_net_buffer_pool *pool,
  */
 M0_INTERNAL bool m0_net_buffer_pool_prune(struct m0_net_buffer_pool *pool);
 
+/**
+   Initialises the per-locality cache of the pool: "nr" magazines, each
+   holding up to "size" buffers.
+
+   A magazine is a LIFO stack of buffers taken from the pool, protected by its
+   own lock. m0_net_buffer_pool_cache_get() and m0_net_buffer_pool_cache_put()
+   take the pool lock only to move a batch of size / 2 buffers between the
+   magazine and the pool.
+
+   Buffers sitting in magazines are not free from the pool's point of view.
+   Refill never takes the pool below nbp_threshold, except for the single
+   buffer the caller asked for, so that nbpo_below_threshold() is still
+   called, and the user can grow the pool, when buffers are really short.
+
+   @pre m0_net_buffer_pool_is_not_locked(pool)
+   @pre nr > 0 && size > 1
+ */
+M0_INTERNAL int m0_net_buffer_pool_cache_init(struct m0_net_buffer_pool *pool,
+					      uint32_t nr, uint32_t size);
+
+/**
+   Returns all cached buffers to the pool and finalises the cache.
+   Called by m0_net_buffer_pool_fini() if the cache is still there.
+
+   @pre m0_net_buffer_pool_is_not_locked(pool)
+ */
+M0_INTERNAL void m0_net_buffer_pool_cache_fini(struct m0_net_buffer_pool *pool);
+
+/**
+   Gets a buffer from the magazine of locality "idx", refilling the magazine
+   from the pool if it is empty. The topmost cached buffer of the given colour
+   is preferred, otherwise any cached buffer is returned, as
+   m0_net_buffer_pool_get() does.
+
+   If the pool is empty too, buffers cached by other localities are returned
+   to the pool before giving up. NULL is returned only if no buffer is free
+   anywhere. After this, until the pool has free buffers again, buffers
+   returned by m0_net_buffer_pool_cache_put() bypass magazines, so the
+   caller can wait for nbpo_not_empty() as with m0_net_buffer_pool_get():
+   lock the pool, check nbp_free and wait if it is 0.
+
+   Without the cache (see m0_net_buffer_pool_cache_init()) this is
+   m0_net_buffer_pool_get() under the pool lock.
+
+   @pre m0_net_buffer_pool_is_not_locked(pool)
+   @pre colour == M0_BUFFER_ANY_COLOUR || colour < pool->nbp_colours_nr
+   @post ergo(result != NULL, result->nb_pool == pool)
+ */
+M0_INTERNAL struct m0_net_buffer *
+m0_net_buffer_pool_cache_get(struct m0_net_buffer_pool *pool, uint32_t idx,
+			     uint32_t colour);
+
+/**
+   Puts the buffer into the magazine of locality "idx". If the magazine is
+   full, half of it is returned to the pool first.
+
+   @pre m0_net_buffer_pool_is_not_locked(pool)
+   @pre colour == M0_BUFFER_ANY_COLOUR || colour < pool->nbp_colours_nr
+   @pre buf->nb_pool == pool
+ */
+M0_INTERNAL void m0_net_buffer_pool_cache_put(struct m0_net_buffer_pool *pool,
+					      uint32_t idx,
+					      struct m0_net_buffer *buf,
+					      uint32_t colour);
+
+/** Occupancy and hit statistics of the cache, summed over magazines. */
+struct m0_net_buffer_pool_cache_stats {
+	/** Buffers currently sitting in magazines. */
+	uint64_t pcs_cached;
+	/** Gets served from a magazine without the pool lock. */
+	uint64_t pcs_hits;
+	/** Gets which had to refill the magazine from the pool. */
+	uint64_t pcs_refills;
+	/** Puts which had to return a half of the magazine to the pool. */
+	uint64_t pcs_flushes;
+	/** Puts which bypassed the magazine because buffers were short. */
+	uint64_t pcs_bypasses;
+	/** Times a magazine was drained to serve another locality. */
+	uint64_t pcs_steals;
+};
+
+/**
+   Collects cache statistics. Counters are read without magazine locks and
+   are approximate while the cache is in use.
+ */
+M0_INTERNAL void
+m0_net_buffer_pool_cache_stats(const struct m0_net_buffer_pool *pool,
+			       struct m0_net_buffer_pool_cache_stats *stats);
+
 /** Buffer pool. */
 struct m0_net_buffer_pool {
 	/** Number of free buffers in the pool. */
@@ -283,6 +387,21 @@ struct m0_net_buffer_pool {
 	   Buffers are linked through m0_net_buffer::nb_lru to this list.
 	 */
 	struct m0_tl			     nbp_lru;
+	/**
+	   Per-locality magazines, NULL unless
+	   m0_net_buffer_pool_cache_init() was called.
+	 */
+	struct m0_net_buffer_pool_mag	    *nbp_mags;
+	/** Number of magazines. */
+	uint32_t			     nbp_mags_nr;
+	/** Capacity of a magazine. */
+	uint32_t			     nbp_mag_size;
+	/**
+	   Set under the pool lock when m0_net_buffer_pool_cache_get() found
+	   no free buffers. While set, puts bypass magazines, so that the
+	   users waiting for nbpo_not_empty() are woken up.
+	 */
+	bool				     nbp_mag_short;
 };
 
 /** @} */ /* end of net_buffer_pool */
@@ -164,6 +164,148 @@ static void test_get_put_multiple(void)
 	m0_net_buffer_pool_unlock(&bp);
 }
 
+static void test_cache(void)
+{
+	struct m0_net_buffer                  *nb[16];
+	struct m0_net_buffer_pool_cache_stats  st;
+	uint32_t                               buf_nr = bp.nbp_buf_nr;
+	uint32_t                               i;
+	uint32_t                               n;
+	int                                    rc;
+	enum {
+		MAG_NR   = 2,
+		MAG_SIZE = 4,
+	};
+
+	M0_UT_ASSERT(buf_nr <= ARRAY_SIZE(nb) && buf_nr > MAG_SIZE);
+	M0_UT_ASSERT(bp.nbp_free == buf_nr);
+	rc = m0_net_buffer_pool_cache_init(&bp, MAG_NR, MAG_SIZE);
+	M0_UT_ASSERT(rc == 0);
+
+	/* The first get refills the magazine with a half of its capacity. */
+	nb[0] = m0_net_buffer_pool_cache_get(&bp, 0, M0_BUFFER_ANY_COLOUR);
+	M0_UT_ASSERT(nb[0] != NULL && nb[0]->nb_pool == &bp);
+	M0_UT_ASSERT(bp.nbp_free == buf_nr - 1 - MAG_SIZE / 2);
+	m0_net_buffer_pool_cache_stats(&bp, &st);
+	M0_UT_ASSERT(st.pcs_cached == MAG_SIZE / 2 && st.pcs_refills == 1 &&
+		     st.pcs_hits == 0);
+	nb[1] = m0_net_buffer_pool_cache_get(&bp, 0, M0_BUFFER_ANY_COLOUR);
+	M0_UT_ASSERT(nb[1] != NULL && nb[1] != nb[0]);
+	m0_net_buffer_pool_cache_stats(&bp, &st);
+	M0_UT_ASSERT(st.pcs_hits == 1);
+
+	/* Overflowing magazine returns its coldest half to the pool. */
+	m0_net_buffer_pool_cache_put(&bp, 0, nb[0], M0_BUFFER_ANY_COLOUR);
+	m0_net_buffer_pool_cache_put(&bp, 0, nb[1], M0_BUFFER_ANY_COLOUR);
+	m0_net_buffer_pool_cache_stats(&bp, &st);
+	M0_UT_ASSERT(st.pcs_cached == MAG_SIZE / 2 + 1);
+	M0_UT_ASSERT(st.pcs_flushes == 0);
+
+	/*
+	 * Exhaust the pool from the other locality: refills stop at the
+	 * threshold, then buffers cached by locality 0 are stolen.
+	 */
+	for (n = 0; n < ARRAY_SIZE(nb); ++n) {
+		nb[n] = m0_net_buffer_pool_cache_get(&bp, 1, 1);
+		if (nb[n] == NULL)
+			break;
+	}
+	M0_UT_ASSERT(n == buf_nr);
+	M0_UT_ASSERT(bp.nbp_free == 0 && bp.nbp_mag_short);
+	m0_net_buffer_pool_cache_stats(&bp, &st);
+	M0_UT_ASSERT(st.pcs_cached == 0 && st.pcs_steals == 1);
+
+	/* While short, puts go to the pool and wake up waiters. */
+	for (i = 0; i < n; ++i)
+		m0_net_buffer_pool_cache_put(&bp, i % MAG_NR, nb[i], 1);
+	m0_net_buffer_pool_cache_stats(&bp, &st);
+	M0_UT_ASSERT(st.pcs_bypasses == M0_NET_BUFFER_POOL_THRESHOLD + 1);
+	M0_UT_ASSERT(!bp.nbp_mag_short);
+	M0_UT_ASSERT(st.pcs_cached + bp.nbp_free == buf_nr);
+
+	/*
+	 * Magazines keep colours: a get prefers a buffer of its colour and the
+	 * buffer goes back to the pool's list of that colour.
+	 */
+	nb[0] = m0_net_buffer_pool_cache_get(&bp, 0, M0_BUFFER_ANY_COLOUR);
+	nb[1] = m0_net_buffer_pool_cache_get(&bp, 0, M0_BUFFER_ANY_COLOUR);
+	M0_UT_ASSERT(nb[0] != NULL && nb[1] != NULL);
+	m0_net_buffer_pool_cache_put(&bp, 0, nb[0], 2);
+	m0_net_buffer_pool_cache_put(&bp, 0, nb[1], 3);
+	M0_UT_ASSERT(m0_net_buffer_pool_cache_get(&bp, 0, 2) == nb[0]);
+	m0_net_buffer_pool_cache_put(&bp, 0, nb[0], 2);
+
+	m0_net_buffer_pool_cache_fini(&bp);
+	M0_UT_ASSERT(bp.nbp_free == buf_nr && bp.nbp_mags == NULL);
+	m0_net_buffer_pool_lock(&bp);
+	M0_UT_ASSERT(m0_net_buffer_pool_invariant(&bp));
+	M0_UT_ASSERT(m0_net_buffer_pool_get(&bp, 2) == nb[0]);
+	M0_UT_ASSERT(m0_net_buffer_pool_get(&bp, 3) == nb[1]);
+	m0_net_buffer_pool_put(&bp, nb[0], 2);
+	m0_net_buffer_pool_put(&bp, nb[1], 3);
+	m0_net_buffer_pool_unlock(&bp);
+}
+
+static void buffers_cache_get_put(int idx)
+{
+	struct m0_net_buffer *nb;
+	struct m0_clink       buf_link;
+	int                   i;
+
+	m0_clink_init(&buf_link, NULL);
+	m0_clink_add_lock(&buf_chan, &buf_link);
+	for (i = 0; i < 100; ++i) {
+		while ((nb = m0_net_buffer_pool_cache_get(&bp, idx,
+							  idx)) == NULL) {
+			m0_net_buffer_pool_lock(&bp);
+			if (bp.nbp_free == 0) {
+				m0_net_buffer_pool_unlock(&bp);
+				m0_chan_wait(&buf_link);
+			} else
+				m0_net_buffer_pool_unlock(&bp);
+		}
+		/* Pass the wake-up on, as net_buffer_acquire() does. */
+		if (bp.nbp_mag_short) {
+			m0_net_buffer_pool_lock(&bp);
+			if (bp.nbp_free > 0)
+				notempty(&bp);
+			m0_net_buffer_pool_unlock(&bp);
+		}
+		m0_nanosleep(m0_time(0, 100), NULL);
+		m0_net_buffer_pool_cache_put(&bp, idx, nb, idx);
+	}
+	m0_clink_del_lock(&buf_link);
+	m0_clink_fini(&buf_link);
+}
+
+static void test_cache_multiple(void)
+{
+	int		  i;
+	int		  rc;
+	const int	  nr_client_threads = 10;
+	struct m0_thread *client_thread;
+
+	rc = m0_net_buffer_pool_cache_init(&bp, nr_client_threads / 2, 4);
+	M0_UT_ASSERT(rc == 0);
+	M0_ALLOC_ARR(client_thread, nr_client_threads);
+	M0_UT_ASSERT(client_thread != NULL);
+	for (i = 0; i < nr_client_threads; i++) {
+		/* Two threads per magazine. */
+		rc = M0_THREAD_INIT(&client_thread[i], int,
+				    NULL, &buffers_cache_get_put,
+				    i / 2, "client_%d", i);
+		M0_ASSERT(rc == 0);
+	}
+	for (i = 0; i < nr_client_threads; i++)
+		m0_thread_join(&client_thread[i]);
+	m0_free(client_thread);
+	m0_net_buffer_pool_cache_fini(&bp);
+	m0_net_buffer_pool_lock(&bp);
+	M0_UT_ASSERT(m0_net_buffer_pool_invariant(&bp));
+	M0_UT_ASSERT(bp.nbp_free == bp.nbp_buf_nr);
+	m0_net_buffer_pool_unlock(&bp);
+}
+
 static void test_fini(void)
 {
 	m0_net_buffer_pool_lock(&bp);
@@ -219,6 +361,8 @@ struct m0_ut_suite buffer_pool_ut = {
 		{ "buffer_pool_grow",              test_grow },
 		{ "buffer_pool_prune",             test_prune },
 		{ "buffer_pool_get_put_multiple",  test_get_put_multiple },
+		{ "buffer_pool_cache",             test_cache },
+		{ "buffer_pool_cache_multiple",    test_cache_multiple },
 		{ "buffer_pool_fini",              test_fini },
 		{ NULL,                            NULL }
 	}
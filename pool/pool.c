@@ -27,6 +27,8 @@
 #include "lib/misc.h"
 #include "lib/assert.h"
 #include "lib/hash.h"      /* m0_hash */
+#include "lib/atomic.h"    /* m0_mb */
+#include "lib/time.h"      /* m0_nanosleep */
 #include "lib/string.h"    /* m0_streq */
 #include "conf/confc.h"    /* m0_confc_from_obj */
 #include "conf/schema.h"   /* M0_CST_IOS, M0_CST_MDS */
@@ -564,15 +566,221 @@ m0_pool_clean_pver_find(const struct m0_pool *pool)
 	return NULL;
 }
 
+/**
+ * Open-addressed hash table of pool versions keyed by pv_id.
+ *
+ * m0_pool_version_find() probes m0_pools_common::pc_pver_map without
+ * pc_mutex. Writers are serialised by the callers, the same way as
+ * modifications of the pool version lists (pc_mutex once the pools are
+ * set up). A new version is stored into a free slot
+ * of the current map after a memory barrier, so a concurrent reader sees
+ * either an empty slot or a fully initialised pool version. Removals and
+ * growth build a new map and publish it with a single pointer store.
+ *
+ * A replaced map, and the versions removed with it, are freed only after
+ * pools_common_pver_map_sync() has waited for all unlocked readers which
+ * could have loaded the old map pointer. Readers register themselves in one
+ * of two counters, pc_pver_readers[pc_pver_epoch & 1]; the writer switches
+ * the epoch and waits for the counter of the previous epoch to drain, twice.
+ * New readers join the other counter meanwhile, so the writer is not
+ * starved by a steady stream of lookups.
+ */
+struct m0_pool_version_map {
+	/** Number of slots minus 1; the number of slots is a power of 2. */
+	uint64_t                     pvm_mask;
+	/** Number of occupied slots. */
+	uint64_t                     pvm_nr;
+	struct m0_pool_version     **pvm_slots;
+};
+
+enum { POOL_VERSION_MAP_MIN = 16 };
+
+static struct m0_pool_version *
+pool_version_map_lookup(const struct m0_pool_version_map *map,
+			const struct m0_fid *id)
+{
+	struct m0_pool_version *pv;
+	uint64_t                i;
+
+	for (i = m0_fid_hash(id) & map->pvm_mask;
+	     (pv = map->pvm_slots[i]) != NULL; i = (i + 1) & map->pvm_mask) {
+		if (m0_fid_eq(&pv->pv_id, id))
+			return pv;
+	}
+	return NULL;
+}
+
+static bool pool_version_map_has_room(const struct m0_pool_version_map *map)
+{
+	/* Keep the load factor at most 1/2, so probe sequences stay short. */
+	return (map->pvm_nr + 1) * 2 <= map->pvm_mask + 1;
+}
+
+static void pool_version_map_insert(struct m0_pool_version_map *map,
+				    struct m0_pool_version *pv)
+{
+	uint64_t i;
+
+	M0_PRE(pool_version_map_has_room(map));
+
+	for (i = m0_fid_hash(&pv->pv_id) & map->pvm_mask;
+	     map->pvm_slots[i] != NULL; i = (i + 1) & map->pvm_mask)
+		M0_ASSERT(map->pvm_slots[i] != pv);
+	/* Make *pv visible before the slot is. */
+	m0_mb();
+	map->pvm_slots[i] = pv;
+	++map->pvm_nr;
+}
+
+static void pool_version_map_free(struct m0_pool_version_map *map)
+{
+	if (map != NULL) {
+		m0_free(map->pvm_slots);
+		m0_free(map);
+	}
+}
+
+/**
+ * Probes the current map without pc_mutex. Returns NULL if the version is
+ * not in the map or there is no map.
+ */
+static struct m0_pool_version *
+pools_common_pver_map_find(struct m0_pools_common *pc, const struct m0_fid *id)
+{
+	struct m0_pool_version_map *map;
+	struct m0_pool_version     *pv = NULL;
+	struct m0_atomic64         *readers;
+
+	readers = &pc->pc_pver_readers[m0_atomic64_get(&pc->pc_pver_epoch) &
+				       1];
+	m0_atomic64_inc(readers);
+	/* Load the map only after the writer can see this reader. */
+	m0_mb();
+	map = pc->pc_pver_map;
+	if (map != NULL)
+		pv = pool_version_map_lookup(map, id);
+	m0_mb();
+	m0_atomic64_dec(readers);
+	return pv;
+}
+
+/**
+ * Waits until no unlocked reader can still probe a map which was unpublished
+ * before the call.
+ */
+static void pools_common_pver_map_sync(struct m0_pools_common *pc)
+{
+	struct m0_atomic64 *readers;
+	int                 i;
+
+	/*
+	 * A reader which loaded the epoch just before it is switched may
+	 * register in the previous counter after it was checked. Such a
+	 * reader sees the new map, but it has to be waited for before that
+	 * map is replaced in turn, hence the second round.
+	 */
+	for (i = 0; i < 2; ++i) {
+		m0_mb();
+		readers = &pc->pc_pver_readers[
+				m0_atomic64_get(&pc->pc_pver_epoch) & 1];
+		m0_atomic64_inc(&pc->pc_pver_epoch);
+		m0_mb();
+		while (m0_atomic64_get(readers) != 0)
+			m0_nanosleep(m0_time(0, 1000), NULL);
+	}
+}
+
+/**
+ * Publishes @map (possibly NULL) and frees the replaced one once no reader
+ * uses it. After the call, no unlocked reader can access a version which is
+ * not in @map.
+ */
+static void pools_common_pver_map_publish(struct m0_pools_common     *pc,
+					  struct m0_pool_version_map *map)
+{
+	struct m0_pool_version_map *old = pc->pc_pver_map;
+
+	/* Make the slots visible before the map is. */
+	m0_mb();
+	pc->pc_pver_map = map;
+	if (old != NULL) {
+		pools_common_pver_map_sync(pc);
+		pool_version_map_free(old);
+	}
+}
+
+/** Stops unlocked lookups, before pool versions are freed. */
+static void pools_common_pver_map_retire(struct m0_pools_common *pc)
+{
+	pools_common_pver_map_publish(pc, NULL);
+}
+
+M0_INTERNAL void m0_pools_common_pver_map_rebuild(struct m0_pools_common *pc)
+{
+	struct m0_pool_version_map *map;
+	struct m0_pool             *pool;
+	struct m0_pool_version     *pv;
+	uint64_t                    nr = 0;
+	uint64_t                    size = POOL_VERSION_MAP_MIN;
+
+	m0_tl_for (pools, &pc->pc_pools, pool) {
+		nr += pool_version_tlist_length(&pool->po_vers);
+	} m0_tl_endfor;
+	while (size < 4 * nr)
+		size *= 2;
+
+	M0_ALLOC_PTR(map);
+	if (map != NULL) {
+		M0_ALLOC_ARR(map->pvm_slots, size);
+		if (map->pvm_slots == NULL)
+			m0_free0(&map);
+	}
+	if (map == NULL) {
+		M0_LOG(M0_WARN, "Cannot allocate pool version map of %"PRIu64
+		       " slots", size);
+	} else {
+		map->pvm_mask = size - 1;
+		m0_tl_for (pools, &pc->pc_pools, pool) {
+			m0_tl_for (pool_version, &pool->po_vers, pv) {
+				pool_version_map_insert(map, pv);
+			} m0_tl_endfor;
+		} m0_tl_endfor;
+	}
+	pools_common_pver_map_publish(pc, map);
+}
+
+/** Makes a pool version that was just added to its pool visible to lookups. */
+static void pools_common_pver_map_add(struct m0_pools_common *pc,
+				      struct m0_pool_version *pv)
+{
+	struct m0_pool_version_map *map = pc->pc_pver_map;
+
+	if (map != NULL && pool_version_map_has_room(map))
+		pool_version_map_insert(map, pv);
+	else
+		m0_pools_common_pver_map_rebuild(pc);
+}
+
 M0_INTERNAL struct m0_pool_version *
 m0_pool_version_lookup(const struct m0_pools_common *pc,
 		       const struct m0_fid *id)
 {
-	struct m0_pool         *pool;
-	struct m0_pool_version *pver;
+	struct m0_pool_version_map *map = pc->pc_pver_map;
+	struct m0_pool             *pool;
+	struct m0_pool_version     *pver;
 
 	M0_ENTRY(FID_F, FID_P(id));
 
+	/* The map is replaced under pc_mutex, which the caller holds. */
+	if (map != NULL) {
+		pver = pool_version_map_lookup(map, id);
+		if (pver != NULL)
+			return pver;
+	}
+	/*
+	 * Some versions are linked to po_vers directly (UTs), bypassing the
+	 * map.
+	 */
 	m0_tl_for (pools, &pc->pc_pools, pool) {
 		pver = m0_tl_find(pool_version, pv, &pool->po_vers,
 				  m0_fid_eq(&pv->pv_id, id));
@@ -593,6 +801,13 @@ m0_pool_version_find(struct m0_pools_common *pc, const struct m0_fid *id)
 	M0_ENTRY(FID_F, FID_P(id));
 	M0_PRE(pc != NULL);
 
+	/* I/O path: the version is known already, no lock is taken. */
+	pv = pools_common_pver_map_find(pc, id);
+	if (pv != NULL) {
+		M0_LEAVE("pv=%p", pv);
+		return pv;
+	}
+
 	m0_mutex_lock(&pc->pc_mutex);
 	pv = m0_pool_version_lookup(pc, id);
 	if (pv != NULL)
@@ -775,8 +990,10 @@ M0_INTERNAL int m0_pool_version_init_by_conf(struct m0_pool_version *pv,
 		       sizeof(pver->pv_u.subtree.pvs_tolerance));
 		rc = m0_fd_tile_build(pver, pv, &failure_level) ?:
 			m0_fd_tree_build(pver, &pv->pv_fd_tree);
-		if (rc == 0)
+		if (rc == 0) {
 			pool_version_tlist_add_tail(&pool->po_vers, pv);
+			pools_common_pver_map_add(pc, pv);
+		}
 	}
 
 	M0_POST(pool_version_invariant(pv));
@@ -1262,6 +1479,8 @@ static void pools_common__pools_update_or_cleanup(struct m0_pools_common *pc)
 	struct m0_reqh         *reqh = m0_confc2reqh(pc->pc_confc);
 	bool                    in_conf;
 
+	/* Versions are about to be freed, stop serving them unlocked. */
+	pools_common_pver_map_retire(pc);
 	m0_tl_for(pools, &pc->pc_pools, pool) {
 		in_conf = m0_conf_cache_contains(cache, &pool->po_id);
 		M0_LOG(M0_DEBUG, "pool %p "FID_F" is %sknown", pool,
@@ -1291,6 +1510,7 @@ static void pools_common__pools_update_or_cleanup(struct m0_pools_common *pc)
 			} m0_tl_endfor;
 		}
 	} m0_tl_endfor;
+	m0_pools_common_pver_map_rebuild(pc);
 }
 
 static void pool__layouts_evict(struct m0_pool *pool,
@@ -1556,6 +1776,7 @@ M0_INTERNAL void m0_pools_common_fini(struct m0_pools_common *pc)
 	pools_common_svc_ctx_tlist_fini(&pc->pc_abandoned_svc_ctxs);
 	pools_common_svc_ctx_tlist_fini(&pc->pc_svc_ctxs);
 	pools_tlist_fini(&pc->pc_pools);
+	pools_common_pver_map_retire(pc);
 	m0_free0(&pc->pc_dev2svc);
 	m0_clink_cleanup(&pc->pc_conf_exp);
 	m0_clink_fini(&pc->pc_conf_exp);
@@ -1756,6 +1977,8 @@ M0_INTERNAL int m0_pool_version_append(struct m0_pools_common  *pc,
 	rc = m0_layout_init_by_pver(&m0_confc2reqh(pc->pc_confc)->rh_ldom, *pv,
 				    NULL);
 	if (rc != 0) {
+		pool_version_tlist_del(*pv);
+		m0_pools_common_pver_map_rebuild(pc);
 		m0_pool_version_fini(*pv);
 		m0_free(*pv);
 		return M0_ERR(rc);
@@ -1878,6 +2101,7 @@ M0_INTERNAL void m0_pool_versions_destroy(struct m0_pools_common *pc)
 	struct m0_pool *p;
 
 	M0_ENTRY();
+	pools_common_pver_map_retire(pc);
 	m0_tl_for(pools, &pc->pc_pools, p) {
 		m0_pool_versions_fini(p);
 	} m0_tl_endfor;
@@ -1935,7 +2159,8 @@ static bool node_poolmach_state_update_cb(struct m0_clink *cl)
 			 pme.pe_type == M0_POOL_DEVICE ? "device":"node",
 			 pme.pe_index, pme.pe_state);
 
-	return M0_RC(m0_poolmach_state_transit(pnode->pn_pm, &pme));
+	return M0_RC(m0_poolmach_ha_event_post(pnode->pn_pm, obj->co_cache,
+					       &pme));
 }
 
 static bool disks_poolmach_state_update_cb(struct m0_clink *cl)
@@ -1956,7 +2181,8 @@ static bool disks_poolmach_state_update_cb(struct m0_clink *cl)
 			 pme.pe_type == M0_POOL_DEVICE ? "device":"node",
 			 pme.pe_index, pme.pe_state);
 
-	return M0_RC(m0_poolmach_state_transit(pdev->pd_pm, &pme));
+	return M0_RC(m0_poolmach_ha_event_post(pdev->pd_pm, obj->co_cache,
+					       &pme));
 }
 
 M0_INTERNAL void m0_poolnode_clink_del(struct m0_clink *cl)
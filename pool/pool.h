@@ -27,6 +27,7 @@
 
 #include "format/format.h"     /* m0_format_header */
 #include "lib/chan.h"          /* m0_clink */
+#include "lib/atomic.h"        /* m0_atomic64 */
 #include "lib/rwlock.h"
 #include "lib/tlist.h"
 #include "lib/tlist_xc.h"
@@ -51,6 +52,7 @@ struct m0_io_req;
 struct m0_pool;
 struct m0_pool_spare_usage;
 struct m0_confc_update_state;
+struct m0_pool_version_map;
 
 enum {
 	PM_DEFAULT_NR_NODES = 10,
@@ -235,6 +237,22 @@ struct m0_pools_common {
 	struct m0_clink                   pc_conf_ready_async;
 	/** Pool of cas services used to store dix. */
 	struct m0_pool                   *pc_dix_pool;
+	/**
+	 * Fid-indexed map of pool versions in ->pc_pools. Probed by
+	 * m0_pool_version_find() without ->pc_mutex, and by
+	 * m0_pool_version_lookup() under it before scanning the lists.
+	 *
+	 * Updated by the same code paths that modify pool version lists.
+	 * NULL if no map could be allocated.
+	 */
+	struct m0_pool_version_map       *pc_pver_map;
+	/**
+	 * Unlocked readers of ->pc_pver_map, counted per epoch, so that a
+	 * replaced map and the versions removed with it are freed only when
+	 * no reader uses them.
+	 */
+	struct m0_atomic64                pc_pver_epoch;
+	struct m0_atomic64                pc_pver_readers[2];
 };
 
 M0_TL_DESCR_DECLARE(pools_common_svc_ctx, M0_EXTERN);
@@ -304,6 +322,17 @@ m0_pool_version_lookup(const struct m0_pools_common *pc,
 M0_INTERNAL struct m0_pool_version *
 m0_pool_version_find(struct m0_pools_common *pc, const struct m0_fid *id);
 
+/**
+ * Builds a new map of all pool versions in pc->pc_pools and publishes it
+ * for m0_pool_version_find(). The replaced map is freed once no unlocked
+ * lookup uses it.
+ *
+ * Called whenever pool versions are added or removed. If the map cannot be
+ * allocated, m0_pool_version_find() falls back to scanning the lists under
+ * ->pc_mutex, so that a stale map never returns a finalised pool version.
+ */
+M0_INTERNAL void m0_pools_common_pver_map_rebuild(struct m0_pools_common *pc);
+
 M0_INTERNAL void m0_pool_version_fini(struct m0_pool_version *pv);
 
 M0_INTERNAL int m0_pool_versions_init_by_conf(struct m0_pool *pool,
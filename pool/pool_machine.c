@@ -25,6 +25,7 @@
 #include "lib/errno.h"
 #include "lib/memory.h"
 #include "lib/misc.h"
+#include "lib/hash.h"              /* m0_hash */
 #include "pool/pool.h"
 #include "reqh/reqh.h"             /* m0_reqh */
 #include "conf/confc.h"
@@ -60,6 +61,14 @@ M0_TL_DESCR_DEFINE(poolmach_equeue, "pool machine events queue", static,
 
 M0_TL_DEFINE(poolmach_equeue, static, struct poolmach_equeue_link);
 
+/** Work done once per m0_poolmach_state_transit() or per HA batch. */
+struct poolmach_transit_post {
+	/** Pool version flags have to be updated. */
+	bool ptp_changed;
+	/** The failure tolerance is exceeded, dump the event list. */
+	bool ptp_dump;
+};
+
 static struct m0_clink *poolnode_clink(struct m0_poolnode *pnode)
 {
 	return &pnode->pn_clink.bc_u.clink;
@@ -233,6 +242,108 @@ static bool poolmach_conf_ready_cb(struct m0_clink *clink)
 	return true;
 }
 
+/**
+ * Two open-addressed hash tables mapping device fids and storage device
+ * indices to indices in m0_poolmach_state::pst_devices_array.
+ *
+ * A slot holds the device index plus 1, 0 marks an empty slot. When several
+ * devices share a key (e.g. devices not filled from configuration), the
+ * first one is indexed, matching the linear scan the index replaces.
+ */
+struct m0_poolmach_devmap {
+	/** Number of slots minus 1; the number of slots is a power of 2. */
+	uint64_t  pdm_mask;
+	uint32_t *pdm_by_fid;
+	uint32_t *pdm_by_sdev;
+};
+
+static uint64_t devmap_sdev_hash(uint32_t sdev_idx)
+{
+	return m0_hash(sdev_idx);
+}
+
+static struct m0_pooldev *devmap_by_fid(const struct m0_poolmach_devmap *dm,
+					struct m0_pooldev *devs,
+					const struct m0_fid *fid)
+{
+	uint64_t i;
+
+	for (i = m0_fid_hash(fid) & dm->pdm_mask; dm->pdm_by_fid[i] != 0;
+	     i = (i + 1) & dm->pdm_mask) {
+		if (m0_fid_eq(&devs[dm->pdm_by_fid[i] - 1].pd_id, fid))
+			return &devs[dm->pdm_by_fid[i] - 1];
+	}
+	return NULL;
+}
+
+static struct m0_pooldev *devmap_by_sdev(const struct m0_poolmach_devmap *dm,
+					 struct m0_pooldev *devs,
+					 uint32_t sdev_idx)
+{
+	uint64_t i;
+
+	for (i = devmap_sdev_hash(sdev_idx) & dm->pdm_mask;
+	     dm->pdm_by_sdev[i] != 0; i = (i + 1) & dm->pdm_mask) {
+		if (devs[dm->pdm_by_sdev[i] - 1].pd_sdev_idx == sdev_idx)
+			return &devs[dm->pdm_by_sdev[i] - 1];
+	}
+	return NULL;
+}
+
+static void devmap_fini(struct m0_poolmach_devmap *dm)
+{
+	if (dm != NULL) {
+		m0_free(dm->pdm_by_fid);
+		m0_free(dm->pdm_by_sdev);
+		m0_free(dm);
+	}
+}
+
+M0_INTERNAL int m0_poolmach_devmap_build(struct m0_poolmach *pm)
+{
+	struct m0_poolmach_state  *st = pm->pm_state;
+	struct m0_poolmach_devmap *dm;
+	struct m0_pooldev         *pd;
+	uint64_t                   size = 1;
+	uint64_t                   j;
+	uint32_t                   i;
+
+	while (size < 2 * (uint64_t)st->pst_nr_devices)
+		size *= 2;
+	M0_ALLOC_PTR(dm);
+	if (dm == NULL)
+		return M0_ERR(-ENOMEM);
+	dm->pdm_mask = size - 1;
+	M0_ALLOC_ARR(dm->pdm_by_fid, size);
+	M0_ALLOC_ARR(dm->pdm_by_sdev, size);
+	if (dm->pdm_by_fid == NULL || dm->pdm_by_sdev == NULL) {
+		devmap_fini(dm);
+		return M0_ERR(-ENOMEM);
+	}
+	for (i = 0; i < st->pst_nr_devices; ++i) {
+		pd = &st->pst_devices_array[i];
+		if (devmap_by_fid(dm, st->pst_devices_array, &pd->pd_id) ==
+		    NULL) {
+			for (j = m0_fid_hash(&pd->pd_id) & dm->pdm_mask;
+			     dm->pdm_by_fid[j] != 0; j = (j + 1) & dm->pdm_mask)
+				;
+			dm->pdm_by_fid[j] = i + 1;
+		}
+		if (devmap_by_sdev(dm, st->pst_devices_array,
+				   pd->pd_sdev_idx) == NULL) {
+			for (j = devmap_sdev_hash(pd->pd_sdev_idx) &
+				 dm->pdm_mask;
+			     dm->pdm_by_sdev[j] != 0;
+			     j = (j + 1) & dm->pdm_mask)
+				;
+			dm->pdm_by_sdev[j] = i + 1;
+		}
+	}
+	devmap_fini(pm->pm_devmap);
+	pm->pm_devmap = dm;
+	return M0_RC(0);
+}
+
 M0_INTERNAL int m0_poolmach_init_by_conf(struct m0_poolmach *pm,
 					 struct m0_conf_pver *pver)
 {
@@ -277,6 +388,8 @@ M0_INTERNAL int m0_poolmach_init_by_conf(struct m0_poolmach *pm,
 			  ready_clink(pm->pm_state));
 	M0_LOG(M0_DEBUG, "nodes:%d devices: %d", idx_nodes, idx_devices);
 	M0_POST(idx_devices <= pm->pm_state->pst_nr_devices);
+	/* The index is an optimisation, lookups work without it. */
+	(void)m0_poolmach_devmap_build(pm);
 	return M0_RC(rc);
 }
 
@@ -362,6 +475,8 @@ static void state_init(struct m0_poolmach_state   *state,
 	state->pst_su_initialised = false;
 }
 
+static bool poolmach_ha_batch_end_cb(struct m0_clink *cl);
+
 static void poolmach_init(struct m0_poolmach       *pm,
 			  struct m0_pool_version   *pver,
 			  struct m0_poolmach_state *pm_state)
@@ -371,6 +486,9 @@ static void poolmach_init(struct m0_poolmach       *pm,
 
 	M0_SET0(pm);
 	m0_rwlock_init(&pm->pm_lock);
+	m0_clink_init(&pm->pm_batch_clink, poolmach_ha_batch_end_cb);
+	pm->pm_batch_clink.cl_is_oneshot = true;
+	poolmach_equeue_tlist_init(&pm->pm_batch_events);
 	pm->pm_state = pm_state;
 	pm->pm_is_initialised = true;
 	pm->pm_pver = pver;
@@ -459,6 +577,8 @@ M0_INTERNAL void m0_poolmach_fini(struct m0_poolmach *pm)
 		m0_clink_cleanup(ready_clink(state));
 		m0_clink_fini(ready_clink(state));
 	}
+	devmap_fini(pm->pm_devmap);
+	pm->pm_devmap = NULL;
 	m0_free(state->pst_spare_usage_array);
 	m0_free(state->pst_devices_array);
 	m0_free(state->pst_nodes_array);
@@ -467,6 +587,9 @@ M0_INTERNAL void m0_poolmach_fini(struct m0_poolmach *pm)
 	m0_rwlock_write_unlock(&pm->pm_lock);
 
 	pm->pm_is_initialised = false;
+	M0_ASSERT(!m0_clink_is_armed(&pm->pm_batch_clink));
+	m0_clink_fini(&pm->pm_batch_clink);
+	poolmach_equeue_tlist_fini(&pm->pm_batch_events);
 	m0_rwlock_fini(&pm->pm_lock);
 }
 
@@ -476,26 +599,19 @@ static bool disk_is_in(struct m0_tl *head, struct m0_pooldev *pd)
 			    m0_fid_eq(&d->pd_id, &pd->pd_id));
 }
 
+/** Called with m0_poolmach::pm_lock held in write mode. */
 static int poolmach_equeue_add(struct m0_poolmach *pm,
 			       const struct m0_poolmach_event *event)
 {
 	struct poolmach_equeue_link *new_link;
-	struct m0_poolmach_state    *state;
-	int                          rc;
 
-	m0_rwlock_write_lock(&pm->pm_lock);
 	M0_ALLOC_PTR(new_link);
-	if (new_link == NULL) {
-		rc = -ENOMEM;
-	} else {
-		new_link->pel_event = *event;
-		state = pm->pm_state;
-		poolmach_equeue_tlink_init_at_tail(new_link,
-						   &state->pst_event_queue);
-		rc = 0;
-	}
-	m0_rwlock_write_unlock(&pm->pm_lock);
-	return M0_RC(rc);
+	if (new_link == NULL)
+		return M0_ERR(-ENOMEM);
+	new_link->pel_event = *event;
+	poolmach_equeue_tlink_init_at_tail(new_link,
+					   &pm->pm_state->pst_event_queue);
+	return M0_RC(0);
 }
 
 M0_INTERNAL uint32_t m0_poolmach_equeue_length(struct m0_poolmach *pm)
@@ -551,8 +667,9 @@ static void spare_usage_arr_update(struct m0_poolmach *pm,
  *       |                                            v
  *       +------------------<-------------------------+
  */
-M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach       *pm,
-					  const struct m0_poolmach_event *event)
+static int poolmach_state_transit_locked(struct m0_poolmach             *pm,
+					 const struct m0_poolmach_event *event,
+					 struct poolmach_transit_post   *post)
 {
 	struct m0_poolmach_state      *state;
 	struct m0_pool_spare_usage    *spare_array;
@@ -566,9 +683,6 @@ M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach       *pm,
 
 	M0_ENTRY();
 
-	M0_PRE(pm != NULL);
-	M0_PRE(event != NULL);
-
 	M0_SET0(&event_link);
 	state = pm->pm_state;
 	pool = pm->pm_pver->pv_pool;
@@ -648,10 +762,9 @@ M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach       *pm,
 	default:
 		return M0_ERR(-EINVAL);
 	}
-	/* Step 1: lock the poolmach */
-	m0_rwlock_write_lock(&pm->pm_lock);
+	post->ptp_changed = true;
 
-	/* Step 2: Update the state according to event */
+	/* Step 1: Update the state according to event */
 	event_link.pel_event = *event;
 	if (event->pe_type == M0_POOL_NODE) {
 		/**
@@ -662,11 +775,16 @@ M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach       *pm,
 		state->pst_nodes_array[event->pe_index].pn_state =
 			event->pe_state;
 	} else if (event->pe_type == M0_POOL_DEVICE) {
+		/* See m0_poolmach_device_state(). */
+		m0_atomic64_inc(&pm->pm_dev_state_seq);
+		m0_mb();
 		state->pst_devices_array[event->pe_index].pd_state =
 			event->pe_state;
+		m0_mb();
+		m0_atomic64_inc(&pm->pm_dev_state_seq);
 	}
 
-	/* Step 4: Alloc or free a spare slot if necessary.*/
+	/* Step 2: Alloc or free a spare slot if necessary.*/
 	if (event->pe_type == M0_POOL_DEVICE) {
 		spare_array = state->pst_spare_usage_array;
 		pd = &state->pst_devices_array[event->pe_index];
@@ -781,18 +899,112 @@ M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach       *pm,
 					state->pst_max_device_failures,
 					event->pe_index,
 					event->pe_state);
+		post->ptp_dump = true;
+	}
+	return M0_RC(rc);
+}
+
+/** Does the work postponed by poolmach_state_transit_locked() calls. */
+static void poolmach_transit_post(struct m0_poolmach                 *pm,
+				  const struct poolmach_transit_post *post)
+{
+	struct m0_poolmach_state *state = pm->pm_state;
+
+	if (post->ptp_changed) {
+		pm->pm_pver->pv_is_dirty = state->pst_nr_failures > 0;
+		/* Clear any dirty sns flags set during previous repair */
+		pm->pm_pver->pv_sns_flags = state->pst_nr_failures <=
+					    state->pst_max_device_failures ?
+					    0 : pm->pm_pver->pv_sns_flags;
+	}
+	if (post->ptp_dump)
 		m0_poolmach_event_list_dump_locked(pm);
+}
+
+M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach       *pm,
+					  const struct m0_poolmach_event *event)
+{
+	struct poolmach_transit_post post = {};
+	int                          rc;
+
+	M0_ENTRY();
+
+	M0_PRE(pm != NULL);
+	M0_PRE(event != NULL);
+
+	m0_rwlock_write_lock(&pm->pm_lock);
+	rc = poolmach_state_transit_locked(pm, event, &post);
+	poolmach_transit_post(pm, &post);
+	m0_rwlock_write_unlock(&pm->pm_lock);
+	return M0_RC(rc);
+}
+
+/**
+ * Applies the events queued by m0_poolmach_ha_event_post() in their order,
+ * followed by @event if it is not NULL, taking ->pm_lock once. Pool version
+ * flags are updated and the event list is dumped once for all of them.
+ *
+ * Returns the result of @event, if any. Failures of the queued events are
+ * logged, as HA has already been told that the notes are delivered.
+ */
+static int poolmach_ha_batch_apply(struct m0_poolmach             *pm,
+				   const struct m0_poolmach_event *event)
+{
+	struct poolmach_transit_post  post = {};
+	struct poolmach_equeue_link  *link;
+	int                           rc = 0;
+
+	m0_rwlock_write_lock(&pm->pm_lock);
+	m0_tl_teardown(poolmach_equeue, &pm->pm_batch_events, link) {
+		rc = poolmach_state_transit_locked(pm, &link->pel_event,
+						   &post);
+		if (rc != 0)
+			M0_LOG(M0_ERROR, FID_F": event_type=%d event_index=%d"
+			       " event_state=%d rc=%d",
+			       FID_P(&pm->pm_pver->pv_id),
+			       link->pel_event.pe_type,
+			       link->pel_event.pe_index,
+			       link->pel_event.pe_state, rc);
+		m0_free(link);
 	}
-	pm->pm_pver->pv_is_dirty = state->pst_nr_failures > 0;
-	/* Clear any dirty sns flags set during previous repair */
-	pm->pm_pver->pv_sns_flags = state->pst_nr_failures <=
-				    state->pst_max_device_failures ?
-				    0 : pm->pm_pver->pv_sns_flags;
-	/* Finally: unlock the poolmach */
+	rc = event == NULL ? 0 :
+		poolmach_state_transit_locked(pm, event, &post);
+	poolmach_transit_post(pm, &post);
 	m0_rwlock_write_unlock(&pm->pm_lock);
 	return M0_RC(rc);
 }
 
+static bool poolmach_ha_batch_end_cb(struct m0_clink *cl)
+{
+	struct m0_poolmach *pm = container_of(cl, struct m0_poolmach,
+					      pm_batch_clink);
+
+	(void)poolmach_ha_batch_apply(pm, NULL);
+	return true;
+}
+
+M0_INTERNAL int m0_poolmach_ha_event_post(struct m0_poolmach             *pm,
+					  struct m0_conf_cache           *cache,
+					  const struct m0_poolmach_event *event)
+{
+	struct poolmach_equeue_link *link;
+
+	M0_ENTRY();
+	M0_PRE(m0_conf_cache_is_locked(cache));
+
+	if (cache->ca_ha_batch == 0)
+		return M0_RC(m0_poolmach_state_transit(pm, event));
+	M0_ALLOC_PTR(link);
+	if (link == NULL)
+		/* Don't reorder the events, apply the queued ones first. */
+		return M0_RC(poolmach_ha_batch_apply(pm, event));
+	link->pel_event = *event;
+	poolmach_equeue_tlink_init_at_tail(link, &pm->pm_batch_events);
+	if (!m0_clink_is_armed(&pm->pm_batch_clink))
+		m0_clink_add(&cache->ca_ha_batch_chan, &pm->pm_batch_clink);
+	return M0_RC(0);
+}
+
 M0_INTERNAL void m0_poolmach_state_last_cancel(struct m0_poolmach *pm)
 {
 	struct m0_poolmach_state      *state;
@@ -817,6 +1029,8 @@ M0_INTERNAL int m0_poolmach_device_state(struct m0_poolmach *pm,
 					 uint32_t device_index,
 					 enum m0_pool_nd_state *state_out)
 {
+	int64_t seq;
+
 	M0_PRE(pm != NULL);
 	M0_PRE(state_out != NULL);
 
@@ -824,9 +1038,18 @@ M0_INTERNAL int m0_poolmach_device_state(struct m0_poolmach *pm,
 		return M0_ERR_INFO(-EINVAL, "device index:%d total devices:%d",
 				device_index, pm->pm_state->pst_nr_devices);
 
-	m0_rwlock_read_lock(&pm->pm_lock);
-	*state_out = pm->pm_state->pst_devices_array[device_index].pd_state;
-	m0_rwlock_read_unlock(&pm->pm_lock);
+	/*
+	 * Read the state without pm_lock: retry while an update is in
+	 * progress (odd sequence) or if one happened meanwhile.
+	 */
+	do {
+		seq = m0_atomic64_get(&pm->pm_dev_state_seq);
+		m0_mb();
+		*state_out =
+		    pm->pm_state->pst_devices_array[device_index].pd_state;
+		m0_mb();
+	} while ((seq & 1) != 0 ||
+		 m0_atomic64_get(&pm->pm_dev_state_seq) != seq);
 	return 0;
 }
 
@@ -968,9 +1191,18 @@ out:
 M0_INTERNAL int m0_poolmach_fid_to_idx(struct m0_poolmach *pm,
 				       struct m0_fid *fid, uint32_t *idx)
 {
-	uint32_t i;
+	struct m0_pooldev *pd;
+	uint32_t           i;
 
 	M0_LOG(M0_DEBUG, "note:"FID_F, FID_P(fid));
+	if (pm->pm_devmap != NULL) {
+		pd = devmap_by_fid(pm->pm_devmap, pm->pm_state->pst_devices_array,
+				   fid);
+		if (pd == NULL)
+			return -ENOENT;
+		*idx = pd->pd_index;
+		return 0;
+	}
 	for (i = 0; i < pm->pm_state->pst_nr_devices; ++i) {
 		if (m0_fid_eq(&pm->pm_state->pst_devices_array[i].pd_id, fid)) {
 			*idx = pm->pm_state->pst_devices_array[i].pd_index;
@@ -980,6 +1212,30 @@ M0_INTERNAL int m0_poolmach_fid_to_idx(struct m0_poolmach *pm,
 	return i == pm->pm_state->pst_nr_devices ? -ENOENT : 0;
 }
 
+M0_INTERNAL int m0_poolmach_sdev_to_idx(struct m0_poolmach *pm,
+					uint32_t sdev_idx, uint32_t *idx)
+{
+	struct m0_poolmach_state *st = pm->pm_state;
+	struct m0_pooldev        *pd = NULL;
+	uint32_t                  i;
+
+	if (pm->pm_devmap != NULL) {
+		pd = devmap_by_sdev(pm->pm_devmap, st->pst_devices_array,
+				    sdev_idx);
+	} else {
+		for (i = 0; i < st->pst_nr_devices; ++i) {
+			if (st->pst_devices_array[i].pd_sdev_idx == sdev_idx) {
+				pd = &st->pst_devices_array[i];
+				break;
+			}
+		}
+	}
+	if (pd == NULL)
+		return -ENOENT;
+	*idx = pd - st->pst_devices_array;
+	return 0;
+}
+
 static void poolmach_event_queue_drop(struct m0_poolmach *pm,
 				      struct m0_poolmach_event *ev)
 {
@@ -29,6 +29,7 @@
 #include "lib/tlist.h"
 #include "lib/tlist_xc.h"
 #include "lib/rwlock.h"    /* m0_rwlock */
+#include "lib/atomic.h"    /* m0_atomic64 */
 #include "conf/obj.h"      /* m0_conf_pver_kind */
 
 /**
@@ -47,7 +48,9 @@ struct m0_pool_spare_usage;
 struct m0_pools_common;
 struct m0_poolmach_event;
 struct m0_poolmach_event_link;
+struct m0_poolmach_devmap;
 struct m0_confc;
+struct m0_conf_cache;
 struct m0_conf_pver;
 struct m0_motr;
 
@@ -176,6 +179,40 @@ struct m0_poolmach {
 
 	/** Read write lock to protect the whole pool machine. */
 	struct m0_rwlock           pm_lock;
+
+	/**
+	 * Sequence counter of device state updates, odd while one is in
+	 * progress. Lets m0_poolmach_device_state() read the state of a
+	 * device without taking ->pm_lock.
+	 */
+	struct m0_atomic64         pm_dev_state_seq;
+
+	/**
+	 * Device lookup index by fid and by storage device index.
+	 *
+	 * Built by m0_poolmach_init_by_conf() once device identities are
+	 * known and not modified afterwards, so it is read without taking
+	 * ->pm_lock. NULL for pool machines not initialised from
+	 * configuration; lookups then scan m0_poolmach_state::pst_devices_array.
+	 */
+	struct m0_poolmach_devmap *pm_devmap;
+
+	/**
+	 * One-shot clink on m0_conf_cache::ca_ha_batch_chan, armed by the
+	 * first state change this pool machine receives within an HA batch.
+	 * When the batch ends, the events of ->pm_batch_events are applied
+	 * under one acquisition of ->pm_lock, and the pool version flags are
+	 * updated once, instead of repeating this for every failure reported
+	 * by a mass-failure notification.
+	 */
+	struct m0_clink            pm_batch_clink;
+
+	/**
+	 * State changes of the current HA batch, in the order they have been
+	 * received. See m0_poolmach_ha_event_post(). Protected by the lock of
+	 * the conf cache the batch is applied to.
+	 */
+	struct m0_tl               pm_batch_events;
 };
 
 /** Event owner type, node or device. */
@@ -260,6 +297,21 @@ M0_INTERNAL void m0_poolmach_failvec_apply(struct m0_poolmach *pmach,
  */
 M0_INTERNAL int m0_poolmach_state_transit(struct m0_poolmach *pm,
 					  const struct m0_poolmach_event *event);
+
+/**
+ * Changes the pool machine state according to an HA state change of a conf
+ * object of @cache.
+ *
+ * Outside of an HA batch (see m0_conf_cache_ha_batch_begin()) this is
+ * m0_poolmach_state_transit(). Within a batch, the event is queued and
+ * applied together with the rest of the batch when it ends, so the result of
+ * the transition is not known yet and 0 is returned.
+ *
+ * @pre m0_conf_cache_is_locked(cache)
+ */
+M0_INTERNAL int m0_poolmach_ha_event_post(struct m0_poolmach             *pm,
+					  struct m0_conf_cache           *cache,
+					  const struct m0_poolmach_event *event);
 /**
  * Remove last pool machine event.
  */
@@ -267,6 +319,11 @@ M0_INTERNAL void m0_poolmach_state_last_cancel(struct m0_poolmach *pm);
 
 /**
  * Query the current state of a specified device.
+ *
+ * Does not take m0_poolmach::pm_lock. The state is read under
+ * m0_poolmach::pm_dev_state_seq and the read is retried if a transition has
+ * been in progress meanwhile.
+ *
  * @param pm pool machine.
  * @param device_index the index of the device to query.
  * @param state_out the output state.
@@ -343,6 +400,22 @@ M0_INTERNAL void m0_poolmach_event_list_dump_locked(struct m0_poolmach *pm);
 M0_INTERNAL void m0_poolmach_device_state_dump(struct m0_poolmach *pm);
 M0_INTERNAL uint64_t m0_poolmach_nr_dev_failures(struct m0_poolmach *pm);
 
+/**
+ * (Re)builds m0_poolmach::pm_devmap from the identities of the devices in
+ * m0_poolmach_state::pst_devices_array.
+ *
+ * Called by m0_poolmach_init_by_conf(). Users filling device identities by
+ * other means may call it once they are done.
+ */
+M0_INTERNAL int m0_poolmach_devmap_build(struct m0_poolmach *pm);
+
+/**
+ * Returns the index within pool machine of a device with given storage
+ * device index (m0_pooldev::pd_sdev_idx).
+ */
+M0_INTERNAL int m0_poolmach_sdev_to_idx(struct m0_poolmach *pm,
+					uint32_t sdev_idx, uint32_t *idx);
+
 /** Returns the index within pool machine for a device with given fid. */
 M0_INTERNAL int m0_poolmach_fid_to_idx(struct m0_poolmach *pm,
 				       struct m0_fid *fid, uint32_t *idx);
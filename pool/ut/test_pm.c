@@ -23,11 +23,14 @@
 #include "ut/ut.h"
 #include "lib/memory.h"
 #include "lib/misc.h"
+#include "lib/thread.h"
+#include "lib/atomic.h"
 #include "pool/pool.h"
 #include "cob/cob.h"
 #include "ut/be.h"
 #include "be/ut/helper.h"
 #include "ha/note.h"         /* m0_ha_nvec */
+#include "conf/cache.h"      /* m0_conf_cache_ha_batch_begin */
 
 #undef M0_TRACE_SUBSYSTEM
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_POOL
@@ -536,6 +539,266 @@ static void pm_test_multi_fail(void)
 	pool_pver_fini();
 }
 
+static void pm_test_device_lookup(void)
+{
+	struct m0_poolmach *pm = &pver.pv_mach;
+	struct m0_fid       fid;
+	uint32_t            idx;
+	uint32_t            i;
+	int                 pass;
+	int                 rc;
+
+	rc = pool_pver_init(8, PM_TEST_DEFAULT_MAX_DEVICE_FAILURE,
+			    PM_TEST_DEFAULT_SPARE_NUMBER);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < pm->pm_state->pst_nr_devices; ++i) {
+		pm->pm_state->pst_devices_array[i].pd_id =
+			M0_FID_TINIT('d', 1, 100 + i);
+		pm->pm_state->pst_devices_array[i].pd_sdev_idx = 1000 + i;
+	}
+	/* The first pass scans the devices, the second one uses the index. */
+	for (pass = 0; pass < 2; ++pass) {
+		M0_UT_ASSERT((pm->pm_devmap != NULL) == (pass == 1));
+		for (i = 0; i < pm->pm_state->pst_nr_devices; ++i) {
+			fid = M0_FID_TINIT('d', 1, 100 + i);
+			rc = m0_poolmach_fid_to_idx(pm, &fid, &idx);
+			M0_UT_ASSERT(rc == 0 && idx == i);
+			rc = m0_poolmach_sdev_to_idx(pm, 1000 + i, &idx);
+			M0_UT_ASSERT(rc == 0 && idx == i);
+		}
+		fid = M0_FID_TINIT('d', 1, 99);
+		M0_UT_ASSERT(m0_poolmach_fid_to_idx(pm, &fid, &idx) == -ENOENT);
+		M0_UT_ASSERT(m0_poolmach_sdev_to_idx(pm, 999, &idx) == -ENOENT);
+		if (pass == 0) {
+			rc = m0_poolmach_devmap_build(pm);
+			M0_UT_ASSERT(rc == 0);
+		}
+	}
+	pool_pver_fini();
+}
+
+static enum m0_pool_nd_state pm_dev_state(struct m0_poolmach *pm, uint32_t i)
+{
+	enum m0_pool_nd_state state;
+	int                   rc;
+
+	rc = m0_poolmach_device_state(pm, i, &state);
+	M0_UT_ASSERT(rc == 0);
+	return state;
+}
+
+/*
+ * State changes received within an HA batch are applied when the batch ends,
+ * in the order they have been received.
+ */
+static void pm_test_ha_batch(void)
+{
+	struct m0_poolmach       *pm = &pver.pv_mach;
+	struct m0_poolmach_event  event = { .pe_type = M0_POOL_DEVICE };
+	struct m0_conf_cache      cache;
+	struct m0_mutex           lock;
+	struct m0_ha_nvec         nvec;
+	uint32_t                  events_nr;
+	uint32_t                  i;
+	int                       rc;
+
+	rc = pool_pver_init(8, PM_TEST_DEFAULT_MAX_DEVICE_FAILURE,
+			    PM_TEST_DEFAULT_SPARE_NUMBER);
+	M0_UT_ASSERT(rc == 0);
+	M0_SET0(&nvec);
+	m0_poolmach_failvec_apply(pm, &nvec);
+	m0_mutex_init(&lock);
+	m0_conf_cache_init(&cache, &lock);
+	m0_conf_cache_lock(&cache);
+
+	/* Outside of a batch, the event is applied right away. */
+	event.pe_index = 0;
+	event.pe_state = M0_PNDS_ONLINE;
+	rc = m0_poolmach_ha_event_post(pm, &cache, &event);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(pm_dev_state(pm, 0) == M0_PNDS_ONLINE);
+	M0_UT_ASSERT(!m0_clink_is_armed(&pm->pm_batch_clink));
+	events_nr = poolmach_events_tlist_length(
+		&pm->pm_state->pst_events_list);
+
+	/*
+	 * Mass failure: all the devices fail, then repair of device 0 starts,
+	 * which is only valid after its failure. The transition of device 1
+	 * is invalid, it is skipped without affecting the rest of the batch.
+	 */
+	m0_conf_cache_ha_batch_begin(&cache);
+	for (i = 0; i < PM_TEST_DEFAULT_DEVICE_NUMBER; ++i) {
+		event.pe_index = i;
+		event.pe_state = M0_PNDS_FAILED;
+		rc = m0_poolmach_ha_event_post(pm, &cache, &event);
+		M0_UT_ASSERT(rc == 0);
+	}
+	event.pe_index = 0;
+	event.pe_state = M0_PNDS_SNS_REPAIRING;
+	rc = m0_poolmach_ha_event_post(pm, &cache, &event);
+	M0_UT_ASSERT(rc == 0);
+	event.pe_index = 1;
+	event.pe_state = M0_PNDS_SNS_REBALANCING;
+	rc = m0_poolmach_ha_event_post(pm, &cache, &event);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_clink_is_armed(&pm->pm_batch_clink));
+	/* Nothing is applied yet. */
+	M0_UT_ASSERT(pm_dev_state(pm, 0) == M0_PNDS_ONLINE);
+	M0_UT_ASSERT(pm_dev_state(pm, 1) == M0_PNDS_UNKNOWN);
+	M0_UT_ASSERT(pm->pm_state->pst_nr_failures == 0);
+	M0_UT_ASSERT(!pver.pv_is_dirty);
+	M0_UT_ASSERT(poolmach_events_tlist_length(
+			     &pm->pm_state->pst_events_list) == events_nr);
+
+	m0_conf_cache_ha_batch_end(&cache);
+	M0_UT_ASSERT(!m0_clink_is_armed(&pm->pm_batch_clink));
+	M0_UT_ASSERT(pm_dev_state(pm, 0) == M0_PNDS_SNS_REPAIRING);
+	for (i = 1; i < PM_TEST_DEFAULT_DEVICE_NUMBER; ++i)
+		M0_UT_ASSERT(pm_dev_state(pm, i) == M0_PNDS_FAILED);
+	M0_UT_ASSERT(pm->pm_state->pst_nr_failures ==
+		     PM_TEST_DEFAULT_DEVICE_NUMBER);
+	M0_UT_ASSERT(pver.pv_is_dirty);
+	M0_UT_ASSERT(poolmach_events_tlist_length(
+			     &pm->pm_state->pst_events_list) ==
+		     events_nr + PM_TEST_DEFAULT_DEVICE_NUMBER + 1);
+
+	m0_conf_cache_unlock(&cache);
+	m0_conf_cache_fini(&cache);
+	m0_mutex_fini(&lock);
+	pool_pver_fini();
+}
+
+enum {
+	PVM_POOLS_NR   = 2,
+	PVM_PVERS_NR   = 40,
+	PVM_READERS_NR = 4,
+	PVM_UPDATES_NR = 100,
+};
+
+static struct m0_pools_common pvm_pc;
+static struct m0_pool         pvm_pools[PVM_POOLS_NR];
+static struct m0_pool_version pvm_pvers[PVM_POOLS_NR][PVM_PVERS_NR];
+static struct m0_atomic64     pvm_stop;
+
+static struct m0_fid pvm_id(int pool, int i)
+{
+	return M0_FID_TINIT('v', 100 + pool, i);
+}
+
+/* Looks up the versions which stay in the pools, without pc_mutex. */
+static void pvm_reader(int unused)
+{
+	struct m0_fid id;
+	int           p;
+	int           i;
+
+	while (m0_atomic64_get(&pvm_stop) == 0) {
+		for (p = 0; p < PVM_POOLS_NR; ++p) {
+			for (i = 0; i < PVM_PVERS_NR; i += 2) {
+				id = pvm_id(p, i);
+				M0_UT_ASSERT(m0_pool_version_find(&pvm_pc,
+								  &id) ==
+					     &pvm_pvers[p][i]);
+			}
+		}
+	}
+}
+
+static void pm_test_pver_map(void)
+{
+	struct m0_pools_common *pc = &pvm_pc;
+	struct m0_thread        readers[PVM_READERS_NR] = {};
+	struct m0_pool_version *pv;
+	struct m0_fid           id;
+	int                     p;
+	int                     i;
+	int                     rc;
+
+	M0_SET0(pc);
+	m0_mutex_init(&pc->pc_mutex);
+	pools_tlist_init(&pc->pc_pools);
+	for (p = 0; p < PVM_POOLS_NR; ++p) {
+		id = M0_FID_TINIT('o', 100 + p, 0);
+		rc = m0_pool_init(&pvm_pools[p], &id, 0);
+		M0_UT_ASSERT(rc == 0);
+		pools_tlist_add_tail(&pc->pc_pools, &pvm_pools[p]);
+		for (i = 0; i < PVM_PVERS_NR; ++i) {
+			pv = &pvm_pvers[p][i];
+			M0_SET0(pv);
+			pv->pv_id = pvm_id(p, i);
+			pool_version_tlink_init_at_tail(pv,
+						&pvm_pools[p].po_vers);
+		}
+	}
+
+	m0_mutex_lock(&pc->pc_mutex);
+	m0_pools_common_pver_map_rebuild(pc);
+	/* Hits take no lock: pc_mutex is held by this very thread. */
+	for (p = 0; p < PVM_POOLS_NR; ++p) {
+		for (i = 0; i < PVM_PVERS_NR; ++i) {
+			id = pvm_id(p, i);
+			M0_UT_ASSERT(m0_pool_version_find(pc, &id) ==
+				     &pvm_pvers[p][i]);
+			M0_UT_ASSERT(m0_pool_version_lookup(pc, &id) ==
+				     &pvm_pvers[p][i]);
+		}
+	}
+	id = pvm_id(PVM_POOLS_NR, 0);
+	M0_UT_ASSERT(m0_pool_version_lookup(pc, &id) == NULL);
+
+	/* Versions removed from the pools are gone from the map. */
+	for (p = 0; p < PVM_POOLS_NR; ++p) {
+		for (i = 1; i < PVM_PVERS_NR; i += 2)
+			pool_version_tlink_del_fini(&pvm_pvers[p][i]);
+	}
+	m0_pools_common_pver_map_rebuild(pc);
+	for (p = 0; p < PVM_POOLS_NR; ++p) {
+		for (i = 0; i < PVM_PVERS_NR; ++i) {
+			id = pvm_id(p, i);
+			M0_UT_ASSERT(m0_pool_version_lookup(pc, &id) ==
+				     (i % 2 == 0 ? &pvm_pvers[p][i] : NULL));
+		}
+	}
+	m0_mutex_unlock(&pc->pc_mutex);
+
+	/*
+	 * Replace the map under running lookups. Each replaced map is freed
+	 * right away, once the lookups which may use it are done.
+	 */
+	m0_atomic64_set(&pvm_stop, 0);
+	for (i = 0; i < PVM_READERS_NR; ++i) {
+		rc = M0_THREAD_INIT(&readers[i], int, NULL, &pvm_reader, 0,
+				    "pvm-reader%d", i);
+		M0_UT_ASSERT(rc == 0);
+	}
+	for (i = 0; i < PVM_UPDATES_NR; ++i) {
+		m0_mutex_lock(&pc->pc_mutex);
+		m0_pools_common_pver_map_rebuild(pc);
+		m0_mutex_unlock(&pc->pc_mutex);
+	}
+	m0_atomic64_set(&pvm_stop, 1);
+	for (i = 0; i < PVM_READERS_NR; ++i) {
+		m0_thread_join(&readers[i]);
+		m0_thread_fini(&readers[i]);
+	}
+	M0_UT_ASSERT(m0_atomic64_get(&pc->pc_pver_readers[0]) == 0);
+	M0_UT_ASSERT(m0_atomic64_get(&pc->pc_pver_readers[1]) == 0);
+
+	for (p = 0; p < PVM_POOLS_NR; ++p) {
+		for (i = 0; i < PVM_PVERS_NR; i += 2)
+			pool_version_tlink_del_fini(&pvm_pvers[p][i]);
+	}
+	/* Frees the map, the pools have no versions left. */
+	m0_pool_versions_destroy(pc);
+	M0_UT_ASSERT(pc->pc_pver_map == NULL);
+	for (p = 0; p < PVM_POOLS_NR; ++p) {
+		pools_tlist_del(&pvm_pools[p]);
+		m0_pool_fini(&pvm_pools[p]);
+	}
+	pools_tlist_fini(&pc->pc_pools);
+	m0_mutex_fini(&pc->pc_mutex);
+}
+
 struct m0_ut_suite poolmach_ut = {
 	.ts_name = "poolmach-ut",
 	.ts_tests = {
@@ -543,6 +806,9 @@ struct m0_ut_suite poolmach_ut = {
 		{ "pm_test state transit", pm_test_transit                    },
 		{ "pm_test spare slot",    pm_test_spare_slot                 },
 		{ "pm_test multi fail",    pm_test_multi_fail                 },
+		{ "pm_test device lookup", pm_test_device_lookup              },
+		{ "pm_test pver map",      pm_test_pver_map                   },
+		{ "pm_test ha batch",      pm_test_ha_batch                   },
 		{ NULL,                    NULL                               }
 	}
 };
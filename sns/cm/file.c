@@ -401,6 +401,23 @@ m0_sns_cm_file_lock_wait(struct m0_sns_cm_file_ctx *fctx, struct m0_fom *fom)
 	return M0_RC(-EAGAIN);
 }
 
+M0_INTERNAL bool m0_sns_cm_file_is_locked(struct m0_sns_cm_file_ctx *fctx)
+{
+	uint32_t state;
+
+	M0_PRE(fctx != NULL && fctx->sf_scm != NULL);
+	M0_PRE(m0_mutex_is_locked(&fctx->sf_scm->sc_file_ctx_mutex));
+
+	if (m0_sns_cm_fctx_state_get(fctx) != M0_SCFS_LOCK_WAIT)
+		return m0_sns_cm_fctx_state_get(fctx) >= M0_SCFS_LOCKED;
+	m0_rm_owner_lock(&fctx->sf_owner);
+	state = fctx->sf_rin.rin_sm.sm_state;
+	m0_rm_owner_unlock(&fctx->sf_owner);
+	if (state == RI_SUCCESS)
+		_fctx_status_set(fctx, M0_SCFS_LOCKED);
+	return state == RI_SUCCESS;
+}
+
 M0_INTERNAL int m0_sns_cm_file_lock(struct m0_sns_cm *scm,
 				    const struct m0_fid *fid,
 				    struct m0_sns_cm_file_ctx **out)
@@ -704,6 +721,9 @@ m0_sns_cm_file_attr_and_layout(struct m0_sns_cm_file_ctx *fctx)
 						   M0_SCFS_LAYOUT_FETCHED)));
 
 	if (M0_FI_ENABLED("ut_attr_layout")) {
+		/* The iterator may have fetched them ahead. */
+		if (m0_sns_cm_fctx_state_get(fctx) == M0_SCFS_LAYOUT_FETCHED)
+			return M0_RC(0);
 		rc = m0_sns_cm_ut_file_size_layout(fctx);
 		if (rc != 0)
 			return M0_RC(rc);
@@ -153,6 +153,13 @@ M0_INTERNAL int
 m0_sns_cm_file_lock_wait(struct m0_sns_cm_file_ctx *fctx,
 			 struct m0_fom *fom);
 
+/**
+ * Returns true iff the rm file lock is acquired, without waiting for it.
+ * Failure to acquire the lock is left to be reported by
+ * m0_sns_cm_file_lock_wait().
+ */
+M0_INTERNAL bool m0_sns_cm_file_is_locked(struct m0_sns_cm_file_ctx *fctx);
+
 /**
  * Decrements the reference on the m0_sns_cm_file_ctx object.
  * When the count reaches null, m0_file_unlock() is invoked and
@@ -29,7 +29,10 @@
 #include "lib/misc.h"
 #include "lib/finject.h"
 
+#include "lib/bitmap.h"
+
 #include "cob/cob.h"
+#include "fd/fd.h"                 /* m0_fd_tile */
 #include "mdstore/mdstore.h"
 #include "reqh/reqh.h"
 #include "ioservice/io_service.h"
@@ -184,24 +187,202 @@ static void unit_to_cobfid(struct m0_sns_cm_iter_file_ctx *ifc,
 	m0_sns_cm_unit2cobfid(ifc->ifc_fctx, sa, ta, cob_fid_out);
 }
 
-/* Uses name space iterator. */
-M0_INTERNAL int __fid_next(struct m0_sns_cm_iter *it, struct m0_fid *fid_next)
+/**
+ * Returns true iff the target @tgt of the pool version holds units which are
+ * to be re-structured by the current copy machine operation.
+ */
+static bool __tgt_is_affected(struct m0_sns_cm *scm, struct m0_poolmach *pm,
+			      uint32_t tgt)
 {
-	struct m0_sns_cm_iter_file_ctx *ifc = &it->si_fc;
-	struct m0_cob_nsrec            *nsrec;
-	struct m0_pool_version         *pv;
-	struct m0_sns_cm               *scm = it2sns(it);
-	struct m0_reqh                 *reqh = m0_sns_cm2reqh(scm);
-	int                             rc;
+	return scm->sc_helpers->sch_is_cob_failed(pm, tgt) &&
+	       !m0_sns_cm_is_cob_repaired(pm, tgt);
+}
+
+/**
+ * Returns true iff the pool version @pv has targets affected by the current
+ * copy machine operation, i.e. its files may have units to be re-structured.
+ */
+static bool __pver_is_affected(struct m0_sns_cm_iter *it,
+			       struct m0_pool_version *pv)
+{
+	struct m0_sns_cm *scm = it2sns(it);
+
+	if (it->si_pver != pv) {
+		it->si_pver = pv;
+		it->si_pver_affected = m0_exists(t, pv->pv_attr.pa_P,
+						 __tgt_is_affected(scm,
+								   &pv->pv_mach,
+								   t));
+	}
+	return it->si_pver_affected;
+}
+
+/**
+ * Uses name space iterator to find the next GOB having units on the affected
+ * targets. The pool version of a GOB is known from the name space record of
+ * its cob, so GOBs of the pool versions not affected by the failure are
+ * skipped here, without locking them or fetching their attributes.
+ */
+M0_INTERNAL int __fid_next(struct m0_sns_cm_iter *it, struct m0_fid *fid_next,
+			   struct m0_poolmach **pm)
+{
+	struct m0_cob_nsrec    *nsrec;
+	struct m0_pool_version *pv;
+	struct m0_sns_cm       *scm = it2sns(it);
+	struct m0_reqh         *reqh = m0_sns_cm2reqh(scm);
+	int                     rc;
 
 	M0_ENTRY("it = %p", it);
 
-	rc = m0_cob_ns_iter_next(&it->si_cns_it, fid_next, &nsrec);
-	if (rc == 0) {
+	while ((rc = m0_cob_ns_iter_next(&it->si_cns_it, fid_next,
+					 &nsrec)) == 0) {
+		if (m0_fid_eq(fid_next, &M0_COB_ROOT_FID) ||
+		    m0_fid_eq(fid_next, &M0_MDSERVICE_SLASH_FID))
+			continue;
 		pv = m0_pool_version_find(reqh->rh_pools, &nsrec->cnr_pver);
-		ifc->ifc_pm = &pv->pv_mach;
+		if (pv == NULL) {
+			M0_LOG(M0_ERROR, "Cannot find pool version for fid="
+			       FID_F" pver="FID_F, FID_P(fid_next),
+			       FID_P(&nsrec->cnr_pver));
+			M0_CNT_INC(it->si_files_skipped);
+			continue;
+		}
+		if (!__pver_is_affected(it, pv)) {
+			M0_CNT_INC(it->si_files_skipped);
+			continue;
+		}
+		*pm = &pv->pv_mach;
+		break;
+	}
+
+	return M0_RC(rc);
+}
+
+/** Returns i-th file of the look-ahead window. */
+static struct m0_sns_cm_iter_pf *__pf(struct m0_sns_cm_iter *it, uint32_t i)
+{
+	M0_PRE(i < it->si_pf_nr);
+
+	return &it->si_pf[(it->si_pf_first + i) % ARRAY_SIZE(it->si_pf)];
+}
+
+static void __pf_pop(struct m0_sns_cm_iter *it)
+{
+	it->si_pf_first = (it->si_pf_first + 1) % ARRAY_SIZE(it->si_pf);
+	M0_CNT_DEC(it->si_pf_nr);
+}
+
+/**
+ * Tops up the look-ahead window (m0_sns_cm_iter::si_pf) with the next files
+ * to be re-structured, requesting their locks at once. Attribute fetch is
+ * started for the files of the window, whose locks are already acquired.
+ * Thus the lock and attribute round trips of several files overlap with each
+ * other and with the processing of the current file, instead of being paid
+ * one file at a time.
+ */
+static int __prefetch(struct m0_sns_cm_iter *it)
+{
+	struct m0_sns_cm          *scm = it2sns(it);
+	struct m0_sns_cm_iter_pf  *pf;
+	struct m0_sns_cm_file_ctx *fctx;
+	struct m0_poolmach        *pm;
+	struct m0_fid              fid;
+	uint32_t                   i;
+	int                        rc = 0;
+
+	M0_ENTRY("it = %p", it);
+
+	m0_fid_gob_make(&fid, 0, 0);
+	while (it->si_pf_nr < ARRAY_SIZE(it->si_pf) && !it->si_pf_end) {
+		rc = __fid_next(it, &fid, &pm);
+		if (rc == -ENOENT) {
+			it->si_pf_end = true;
+			rc = 0;
+			break;
+		}
+		if (rc != 0)
+			break;
+		M0_CNT_INC(it->si_pf_nr);
+		pf = __pf(it, it->si_pf_nr - 1);
+		pf->ip_gfid = fid;
+		pf->ip_pm = pm;
+		m0_mutex_lock(&scm->sc_file_ctx_mutex);
+		/* Otherwise the lock is requested again in ITPH_FID_LOCK. */
+		if (!M0_IN(m0_sns_cm_file_lock(scm, &fid, &pf->ip_fctx),
+			   (0, -EAGAIN)))
+			pf->ip_fctx = NULL;
+		m0_mutex_unlock(&scm->sc_file_ctx_mutex);
+	}
+	m0_mutex_lock(&scm->sc_file_ctx_mutex);
+	for (i = 0; i < it->si_pf_nr; ++i) {
+		fctx = __pf(it, i)->ip_fctx;
+		if (fctx != NULL)
+			(void)m0_sns_cm_file_is_locked(fctx);
 	}
+	m0_mutex_unlock(&scm->sc_file_ctx_mutex);
+
+	for (i = 0; i < it->si_pf_nr; ++i) {
+		pf = __pf(it, i);
+		fctx = pf->ip_fctx;
+		if (fctx == NULL ||
+		    m0_sns_cm_fctx_state_get(fctx) != M0_SCFS_LOCKED)
+			continue;
+		/* Errors are saved in the file context and reported later. */
+		fctx->sf_pm = pf->ip_pm;
+		(void)m0_sns_cm_file_attr_and_layout(fctx);
+	}
+
+	return M0_RC(rc);
+}
+
+/**
+ * Puts the file locks held by the look-ahead window. If @fom is not NULL, it
+ * waits for the lock and attribute requests still in flight, returning
+ * M0_FSO_WAIT, so that file contexts are not released under them. Otherwise
+ * such file contexts are left to m0_sns_cm_fctx_cleanup().
+ */
+static int __prefetch_fini(struct m0_sns_cm_iter *it, struct m0_fom *fom)
+{
+	struct m0_sns_cm          *scm = it2sns(it);
+	struct m0_sns_cm_iter_pf  *pf;
+	struct m0_sns_cm_file_ctx *fctx;
+	int                        rc = 0;
 
+	m0_mutex_lock(&scm->sc_file_ctx_mutex);
+	for (; it->si_pf_nr > 0; __pf_pop(it)) {
+		pf = __pf(it, 0);
+		fctx = pf->ip_fctx;
+		if (fctx == NULL)
+			continue;
+		switch (m0_sns_cm_fctx_state_get(fctx)) {
+		case M0_SCFS_LOCK_WAIT:
+			if (fom == NULL)
+				continue;
+			rc = m0_sns_cm_file_lock_wait(fctx, fom);
+			if (rc == -EAGAIN) {
+				rc = M0_FSO_WAIT;
+				goto out;
+			}
+			/* The reference is put on failure to lock. */
+			if (rc != 0) {
+				rc = 0;
+				continue;
+			}
+			break;
+		case M0_SCFS_ATTR_FETCH:
+		case M0_SCFS_LAYOUT_FETCH:
+			if (fom == NULL)
+				continue;
+			m0_sns_cm_file_attr_and_layout_wait(fctx, fom);
+			rc = M0_FSO_WAIT;
+			goto out;
+		default:
+			break;
+		}
+		m0_sns_cm_file_unlock(scm, &pf->ip_gfid);
+	}
+out:
+	m0_mutex_unlock(&scm->sc_file_ctx_mutex);
 	return M0_RC(rc);
 }
 
@@ -235,6 +416,7 @@ static int __file_context_init(struct m0_sns_cm_iter *it)
 	it->si_ag = NULL;
 	M0_SET0(out_last);
 	it->si_fc.ifc_group_last = fctx->sf_max_group;
+	it->si_tile = UINT64_MAX;
 
 	return M0_RC(0);
 }
@@ -325,39 +507,46 @@ end:
 	return M0_RC(rc);
 }
 
-/** Fetches next GOB fid. */
+/**
+ * Fetches next GOB fid from the look-ahead window. If the file lock was
+ * requested ahead, its reference is taken over and the iterator proceeds
+ * to the phase matching the state of the file context.
+ */
 static int iter_fid_next(struct m0_sns_cm_iter *it)
 {
 	struct m0_sns_cm_iter_file_ctx  *ifc = &it->si_fc;
-	struct m0_fid                    fid_next;
+	struct m0_sns_cm_iter_pf        *pf;
 	int                              rc;
 	M0_ENTRY("it = %p", it);
 
-	m0_fid_gob_make(&fid_next, 0, 0);
 	ifc->ifc_fctx = NULL;
-
-	/* Get current GOB fid saved in the iterator. */
-	do {
-		rc = __fid_next(it, &fid_next);
-	} while (rc == 0 && (m0_fid_eq(&fid_next, &M0_COB_ROOT_FID)     ||
-			     m0_fid_eq(&fid_next, &M0_MDSERVICE_SLASH_FID)));
-	if (rc == 0) {
-		/* Save next GOB fid in the iterator. */
-		ifc->ifc_gfid = fid_next;
-	}
+	rc = __prefetch(it);
+	if (rc != 0)
+		return M0_ERR(rc);
 	/* fini old layout instance and put old layout */
 	if (ifc->ifc_fctx != NULL && ifc->ifc_fctx->sf_layout != NULL) {
 		if (M0_FI_ENABLED("ut_fid_next"))
 			m0_layout_put(ifc->ifc_fctx->sf_layout);
 	}
-	if (rc == -ENOENT) {
+	if (it->si_pf_nr == 0) {
 		M0_LOG(M0_DEBUG, "no more data: returning -ENODATA last fid"
 		       FID_F, FID_P(&ifc->ifc_gfid));
 		return M0_RC(-ENODATA);
 	}
 
-	iter_phase_set(it, ITPH_FID_LOCK);
-	return M0_RC(rc);
+	/* Save next GOB fid in the iterator. */
+	pf = __pf(it, 0);
+	ifc->ifc_gfid = pf->ip_gfid;
+	ifc->ifc_pm = pf->ip_pm;
+	ifc->ifc_fctx = pf->ip_fctx;
+	__pf_pop(it);
+	if (ifc->ifc_fctx == NULL)
+		iter_phase_set(it, ITPH_FID_LOCK);
+	else if (m0_sns_cm_fctx_state_get(ifc->ifc_fctx) == M0_SCFS_LOCK_WAIT)
+		iter_phase_set(it, ITPH_FID_LOCK_WAIT);
+	else
+		iter_phase_set(it, ITPH_FID_ATTR_LAYOUT);
+	return M0_RC(0);
 }
 
 static bool __has_incoming(struct m0_sns_cm *scm,
@@ -374,33 +563,100 @@ static bool __has_incoming(struct m0_sns_cm *scm,
 	return m0_sns_cm_ag_is_relevant(scm, fctx, &agid);
 }
 
-
-static bool __group_skip(struct m0_sns_cm_iter *it, uint64_t group)
+/**
+ * Collects parity groups of the given tile of the current file, having
+ * non-spare units on the affected targets, in m0_sns_cm_iter::si_tile_groups.
+ *
+ * Instead of mapping every unit of every group in the tile to its target, only
+ * the frames of the affected targets are inverted to (group, unit) addresses,
+ * thus the cost is proportional to the number of failed devices rather than to
+ * the pool width.
+ */
+static int __tile_build(struct m0_sns_cm_iter *it, uint64_t tile)
 {
 	struct m0_sns_cm_iter_file_ctx *ifc = &it->si_fc;
 	struct m0_sns_cm_file_ctx      *fctx = ifc->ifc_fctx;
-	struct m0_fid                   cobfid;
+	struct m0_sns_cm               *scm = it2sns(it);
+	struct m0_poolmach             *pm = fctx->sf_pm;
+	struct m0_fd_tile              *ft;
+	struct m0_bitmap               *map = &it->si_tile_groups;
 	struct m0_pdclust_src_addr      sa;
 	struct m0_pdclust_tgt_addr      ta;
-	int                             i;
-	struct m0_poolmach             *pm = fctx->sf_pm;
- 	struct m0_sns_cm               *scm = it2sns(it);
-
-	M0_ENTRY("it: %p group: %lu", it, (unsigned long)group);
-
-	for (i = 0; i < ifc->ifc_upg; ++i) {
-		sa.sa_unit = i;
-		sa.sa_group = group;
-		m0_sns_cm_unit2cobfid(fctx, &sa, &ta, &cobfid);
-		if (scm->sc_helpers->sch_is_cob_failed(pm, ta.ta_obj) &&
-		    !m0_sns_cm_is_cob_repaired(pm, ta.ta_obj) &&
-		    !m0_sns_cm_unit_is_spare(fctx, group, sa.sa_unit))
-			return false;
-	}
+	uint64_t                        C;
+	uint64_t                        row;
+	uint32_t                        P;
+	uint32_t                        tgt;
+	int                             rc;
+
+	M0_ENTRY("it: %p tile: %"PRIu64, it, tile);
 
-	return true;
+	ft = &fctx->sf_layout->l_pver->pv_fd_tile;
+	C = ft->ft_rows * ft->ft_cols / ft->ft_G;
+	P = m0_pdclust_P(m0_layout_to_pdl(fctx->sf_layout));
+	if (map->b_nr != C) {
+		if (map->b_nr != 0)
+			m0_bitmap_fini(map);
+		rc = m0_bitmap_init(map, C);
+		if (rc != 0)
+			return M0_ERR(rc);
+	} else
+		m0_bitmap_reset(map);
+
+	for (tgt = 0; tgt < P; ++tgt) {
+		if (!__tgt_is_affected(scm, pm, tgt))
+			continue;
+		ta.ta_obj = tgt;
+		for (row = 0; row < ft->ft_rows; ++row) {
+			ta.ta_frame = m0_enc(ft->ft_rows, tile, row);
+			m0_sns_cm_file_bwd_map(fctx, &ta, &sa);
+			M0_CNT_INC(it->si_frames_nr);
+			/* Frame of a virtual target or a spare unit. */
+			if (sa.sa_group == UINT64_MAX ||
+			    m0_sns_cm_unit_is_spare(fctx, sa.sa_group,
+						    sa.sa_unit))
+				continue;
+			M0_ASSERT(sa.sa_group / C == tile);
+			m0_bitmap_set(map, sa.sa_group % C, true);
+		}
+	}
+	it->si_tile = tile;
+	return M0_RC(0);
 }
 
+/**
+ * Finds the first parity group, not less than @group, having units on the
+ * affected targets. Returns -ENOENT when there are no such groups left in the
+ * file.
+ */
+static int __group_affected(struct m0_sns_cm_iter *it, uint64_t *group)
+{
+	struct m0_sns_cm_iter_file_ctx *ifc = &it->si_fc;
+	struct m0_fd_tile              *ft;
+	uint64_t                        C;
+	uint64_t                        tile;
+	uint64_t                        j;
+	uint64_t                        g = *group;
+	int                             rc;
+
+	ft = &ifc->ifc_fctx->sf_layout->l_pver->pv_fd_tile;
+	C = ft->ft_rows * ft->ft_cols / ft->ft_G;
+	while (g <= ifc->ifc_group_last) {
+		m0_dec(C, g, &tile, &j);
+		if (it->si_tile != tile) {
+			rc = __tile_build(it, tile);
+			if (rc != 0)
+				return M0_ERR(rc);
+		}
+		for (; j < C && g <= ifc->ifc_group_last; ++j, ++g) {
+			if (m0_bitmap_get(&it->si_tile_groups, j)) {
+				M0_CNT_INC(it->si_groups_nr);
+				*group = g;
+				return 0;
+			}
+		}
+	}
+	return -ENOENT;
+}
 
 static int __group_alloc(struct m0_sns_cm *scm, struct m0_fid *gfid,
 			 uint64_t group, struct m0_pdclust_layout *pl,
@@ -466,9 +722,9 @@ out:
 
 /**
  * Finds parity group having units belonging to the failed container.
- * This iterates through each parity group of the file, and its units.
- * A COB id is calculated for each unit and checked if ti belongs to the
- * failed container, if yes then the group is selected for processing.
+ * Affected groups are located tile by tile by inverting the layout mapping of
+ * the frames on the failed targets (see __tile_build()), so that groups which
+ * do not have units on the failed devices are never visited.
  * This is invoked from ITPH_GROUP_NEXT phase.
  */
 static int __group_next(struct m0_sns_cm_iter *it)
@@ -499,8 +755,13 @@ static int __group_next(struct m0_sns_cm_iter *it)
 	if (m0_sns_cm_pver_is_dirty(pm->pm_pver))
 		goto fid_next;
 	for (group = sa->sa_group; group <= ifc->ifc_group_last; ++group) {
-		if (__group_skip(it, group))
-			continue;
+		rc = __group_affected(it, &group);
+		if (rc == -ENOENT) {
+			rc = 0;
+			break;
+		}
+		if (rc != 0)
+			goto out;
 		has_incoming = __has_incoming(scm, ifc->ifc_fctx, group);
 		if (!has_incoming)
 			nrlu = m0_sns_cm_ag_nr_local_units(scm, ifc->ifc_fctx,
@@ -775,6 +1036,9 @@ M0_INTERNAL int m0_sns_cm_iter_next(struct m0_cm *cm, struct m0_cm_cp *cp)
 		if (cm->cm_quiesce || cm->cm_abort) {
 			if (M0_IN(iter_phase(it), (ITPH_FID_NEXT,
 						   ITPH_GROUP_NEXT))) {
+				rc = __prefetch_fini(it, it->si_fom);
+				if (rc != 0)
+					return M0_RC(rc);
 				M0_LOG(M0_DEBUG, "%" PRId64 ": "
 				       "Got %s cmd: returning -ENODATA",
 					cm->cm_id,
@@ -828,6 +1092,7 @@ static struct m0_sm_state_descr cm_iter_sd[ITPH_NR] = {
 		.sd_flags   = 0,
 		.sd_name    = "FID next",
 		.sd_allowed = M0_BITS(ITPH_GROUP_NEXT, ITPH_FID_LOCK,
+				      ITPH_FID_LOCK_WAIT, ITPH_FID_ATTR_LAYOUT,
 				      ITPH_IDLE)
 	},
 	[ITPH_FID_LOCK] = {
@@ -879,6 +1144,11 @@ M0_INTERNAL int m0_sns_cm_iter_init(struct m0_sns_cm_iter *it)
 	m0_sm_init(&it->si_sm, &cm_iter_sm_conf, ITPH_INIT, &cm->cm_sm_group);
 	m0_sns_cm_iter_bob_init(it);
 	it->si_total_files = 0;
+	it->si_files_skipped = 0;
+	it->si_frames_nr = 0;
+	it->si_groups_nr = 0;
+	it->si_tile = UINT64_MAX;
+	M0_SET0(&it->si_tile_groups);
 	if (it->si_fom == NULL)
 		it->si_fom = &scm->sc_base.cm_cp_pump.p_fom;
 
@@ -899,6 +1169,10 @@ M0_INTERNAL int m0_sns_cm_iter_start(struct m0_sns_cm_iter *it)
 	agid2fid(&cm->cm_last_processed_out, &gfid_start);
 	m0_fid_gob_make(&gfid, gfid_start.f_container, gfid_start.f_key);
 	rc = m0_cob_ns_iter_init(&it->si_cns_it, &gfid, scm->sc_cob_dom);
+	it->si_pver = NULL;
+	it->si_pf_first = 0;
+	it->si_pf_nr = 0;
+	it->si_pf_end = false;
 	if (iter_phase(it) == ITPH_INIT)
 		iter_phase_set(it, ITPH_IDLE);
 
@@ -913,8 +1187,16 @@ M0_INTERNAL void m0_sns_cm_iter_stop(struct m0_sns_cm_iter *it)
 	if (!M0_IN(iter_phase(it), (ITPH_INIT, ITPH_IDLE)))
 		iter_phase_set(it, ITPH_IDLE);
 	if (iter_phase(it) == ITPH_IDLE) {
+		(void)__prefetch_fini(it, NULL);
 		if (it->si_cns_it.cni_cdom != NULL)
 			m0_cob_ns_iter_fini(&it->si_cns_it);
+		if (it->si_tile_groups.b_nr != 0)
+			m0_bitmap_fini(&it->si_tile_groups);
+		it->si_tile = UINT64_MAX;
+		M0_LOG(M0_DEBUG, "files: %"PRIu64" skipped: %"PRIu64
+		       " frames inverted: %"PRIu64" groups affected: %"PRIu64,
+		       it->si_total_files, it->si_files_skipped,
+		       it->si_frames_nr, it->si_groups_nr);
 		M0_SET0(&it->si_fc);
 	}
 }
@@ -924,6 +1206,8 @@ M0_INTERNAL void m0_sns_cm_iter_fini(struct m0_sns_cm_iter *it)
 	M0_PRE(it != NULL);
 	M0_PRE(M0_IN(iter_phase(it), (ITPH_INIT, ITPH_IDLE)));
 
+	if (it->si_tile_groups.b_nr != 0)
+		m0_bitmap_fini(&it->si_tile_groups);
 	iter_phase_set(it, ITPH_FINI);
 	m0_sm_fini(&it->si_sm);
 	m0_sns_cm_iter_bob_fini(it);
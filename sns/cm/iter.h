@@ -25,6 +25,7 @@
 #ifndef __MOTR_SNS_CM_ITER_H__
 #define __MOTR_SNS_CM_ITER_H__
 
+#include "lib/bitmap.h"
 #include "sm/sm.h"
 #include "cob/ns_iter.h"
 #include "layout/pdclust.h"
@@ -39,6 +40,15 @@ struct m0_cm;
 struct m0_sns_cm;
 struct m0_sns_cm_ag;
 struct m0_cm_cp;
+struct m0_pool_version;
+
+enum {
+	/**
+	 * Number of files selected by the iterator ahead of the current one,
+	 * see m0_sns_cm_iter::si_pf.
+	 */
+	SNS_CM_ITER_PREFETCH_NR = 8,
+};
 
 /**
  * File context in copy machine.
@@ -85,6 +95,25 @@ struct m0_sns_cm_iter_file_ctx {
 	bool                          ifc_cob_is_spare_unit;
 };
 
+/**
+ * File selected by the iterator ahead of the current one, whose lock and
+ * attributes are requested before the iterator gets to it.
+ */
+struct m0_sns_cm_iter_pf {
+	/** GOB to be re-structured. */
+	struct m0_fid                 ip_gfid;
+
+	/** Pool machine of the pool version of the GOB. */
+	struct m0_poolmach           *ip_pm;
+
+	/**
+	 * File context holding a reference on the file lock, NULL if the
+	 * lock could not be requested ahead. The reference is handed over to
+	 * the iterator when it gets to the file.
+	 */
+	struct m0_sns_cm_file_ctx    *ip_fctx;
+};
+
 /**
  * SNS copy machine data iterator. This iterates through the local data objects
  * which are part of the re-structuring process, in-order to recover from a
@@ -119,6 +148,52 @@ struct m0_sns_cm_iter {
 	 */
 	uint64_t                         si_total_files;
 
+	/**
+	 * Number of files skipped without locking them, because none of the
+	 * targets of their pool version is affected by the failure.
+	 */
+	uint64_t                         si_files_skipped;
+
+	/**
+	 * Pool version of the last file selected by the iterator, and whether
+	 * it has affected targets. Files of a pool version are mostly stored
+	 * together, so this saves the check of every target per file.
+	 */
+	struct m0_pool_version          *si_pver;
+	bool                             si_pver_affected;
+
+	/**
+	 * Look-ahead window of the files to be re-structured next. Lock and
+	 * attribute requests of these files are in flight while the current
+	 * file is processed, instead of being issued one file at a time.
+	 */
+	struct m0_sns_cm_iter_pf         si_pf[SNS_CM_ITER_PREFETCH_NR];
+
+	/** Index of the first file of the window in si_pf. */
+	uint32_t                         si_pf_first;
+
+	/** Number of files in the window. */
+	uint32_t                         si_pf_nr;
+
+	/** True once the cob namespace has no more files for the window. */
+	bool                             si_pf_end;
+
+	/**
+	 * Parity groups of the tile m0_sns_cm_iter::si_tile of the current
+	 * file, having units on the failed devices. Bit j corresponds to the
+	 * j-th group of the tile.
+	 */
+	struct m0_bitmap                 si_tile_groups;
+
+	/** Tile described by si_tile_groups, UINT64_MAX if none. */
+	uint64_t                         si_tile;
+
+	/** Number of frames on failed devices inverted to parity groups. */
+	uint64_t                         si_frames_nr;
+
+	/** Number of affected parity groups found by the iterator. */
+	uint64_t                         si_groups_nr;
+
 	uint64_t                         si_magix;
 };
 
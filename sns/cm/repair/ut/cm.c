@@ -45,6 +45,7 @@
 #include "sns/cm/repair/ag.h"
 #include "sns/cm/cm.h"
 #include "sns/cm/file.h"
+#include "sns/cm/cm_utils.h"
 #include "sns/cm/repair/ut/cp_common.h"
 
 enum {
@@ -68,7 +69,13 @@ static struct m0_fom_simple     iter_fom;
 static struct m0_fom_timeout    iter_fom_timeout;
 static struct m0_semaphore      iter_sem;
 static const struct m0_fid      M0_SNS_CM_REPAIR_UT_PVER = M0_FID_TINIT('v', 1, 8);
+/* Pool version of another pool, not affected by the failure. */
+static const struct m0_fid      M0_SNS_CM_UT_PVER_OTHER =
+					M0_FID_TINIT('v', 1, 57);
 static enum m0_cm_op            op;
+/* File and first group of it not checked yet by iter_group_check(). */
+static struct m0_fid            iter_gfid;
+static uint64_t                 iter_group_next;
 
 static struct m0_sm_state_descr iter_ut_fom_phases[] = {
 	[M0_FOM_PHASE_INIT] = {
@@ -183,10 +190,10 @@ static bool cp_verify(struct m0_sns_cm_cp *scp)
 	       !cp_data_buf_tlist_is_empty(&scp->sc_base.c_buffers);
 }
 
-M0_INTERNAL void cob_create(struct m0_reqh *reqh, struct m0_cob_domain *cdom,
+static void pver_cob_create(struct m0_reqh *reqh, struct m0_cob_domain *cdom,
 			    struct m0_be_domain *bedom,
 			    uint64_t cont, struct m0_fid *gfid,
-			    uint32_t cob_idx)
+			    uint32_t cob_idx, const struct m0_fid *pver_fid)
 {
 	struct m0_sm_group     *grp = m0_locality0_get()->lo_grp;
 	struct m0_cob          *cob;
@@ -213,7 +220,7 @@ M0_INTERNAL void cob_create(struct m0_reqh *reqh, struct m0_cob_domain *cdom,
         nskey_bs_len = strlen(nskey_bs);
 
 	motr = m0_cs_ctx_get(reqh);
-	pver = m0_pool_version_find(&motr->cc_pools_common, &M0_SNS_CM_REPAIR_UT_PVER);
+	pver = m0_pool_version_find(&motr->cc_pools_common, pver_fid);
 	M0_UT_ASSERT(pver != NULL);
 	rc = m0_cob_nskey_make(&nskey, gfid, nskey_bs, nskey_bs_len);
 	M0_ASSERT(rc == 0 && nskey != NULL);
@@ -238,6 +245,15 @@ M0_INTERNAL void cob_create(struct m0_reqh *reqh, struct m0_cob_domain *cdom,
 	m0_cob_put(cob);
 }
 
+M0_INTERNAL void cob_create(struct m0_reqh *reqh, struct m0_cob_domain *cdom,
+			    struct m0_be_domain *bedom,
+			    uint64_t cont, struct m0_fid *gfid,
+			    uint32_t cob_idx)
+{
+	pver_cob_create(reqh, cdom, bedom, cont, gfid, cob_idx,
+			&M0_SNS_CM_REPAIR_UT_PVER);
+}
+
 M0_INTERNAL void cob_delete(struct m0_cob_domain *cdom,
 			    struct m0_be_domain *bedom,
 			    uint64_t cont, const struct m0_fid *gfid)
@@ -353,6 +369,52 @@ static void cobs_delete(uint64_t nr_files, uint64_t nr_cobs)
 	}
 }
 
+/*
+ * Brute-force check of a group: maps every unit of it to its target, as the
+ * iterator did before affected groups were located by inverting the frames
+ * of the failed targets.
+ */
+static bool group_is_affected(struct m0_sns_cm_file_ctx *fctx, uint64_t group)
+{
+	struct m0_pdclust_src_addr sa = { .sa_group = group };
+	struct m0_pdclust_tgt_addr ta;
+	struct m0_fid              cobfid;
+	uint32_t                   upg;
+
+	upg = m0_pdclust_size(m0_layout_to_pdl(fctx->sf_layout));
+	for (sa.sa_unit = 0; sa.sa_unit < upg; ++sa.sa_unit) {
+		m0_sns_cm_unit2cobfid(fctx, &sa, &ta, &cobfid);
+		if (scm->sc_helpers->sch_is_cob_failed(fctx->sf_pm,
+						       ta.ta_obj) &&
+		    !m0_sns_cm_is_cob_repaired(fctx->sf_pm, ta.ta_obj) &&
+		    !m0_sns_cm_unit_is_spare(fctx, group, sa.sa_unit))
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Checks that the group of the copy packet is affected by the failure and
+ * that no affected group of the file was skipped before it.
+ */
+static void iter_group_check(struct m0_sns_cm_ag *sag)
+{
+	struct m0_sns_cm_file_ctx *fctx = sag->sag_fctx;
+	uint64_t                   group = agid2group(&sag->sag_base.cag_id);
+	uint64_t                   g;
+
+	if (!m0_fid_eq(&iter_gfid, &fctx->sf_fid)) {
+		iter_gfid = fctx->sf_fid;
+		iter_group_next = 0;
+	}
+	M0_UT_ASSERT(m0_fid_eq(&fctx->sf_pm->pm_pver->pv_id,
+			       &M0_SNS_CM_REPAIR_UT_PVER));
+	M0_UT_ASSERT(group_is_affected(fctx, group));
+	for (g = iter_group_next; g < group; ++g)
+		M0_UT_ASSERT(!group_is_affected(fctx, g));
+	iter_group_next = max64u(iter_group_next, group + 1);
+}
+
 static int iter_ut_fom_tick(struct m0_fom *fom, uint32_t  *sem_id, int *phase)
 {
 	int rc = M0_FSO_AGAIN;
@@ -378,6 +440,7 @@ static int iter_ut_fom_tick(struct m0_fom *fom, uint32_t  *sem_id, int *phase)
 				M0_ASSERT(sag->sag_fctx != NULL);
 				M0_ASSERT(sag->sag_fctx->sf_layout != NULL);
 				M0_ASSERT(sag->sag_fctx->sf_pi != NULL);
+				iter_group_check(sag);
 				buf_put(&scp);
 				m0_cm_cp_only_fini(&scp.sc_base);
 				*phase = M0_FOM_PHASE_INIT;
@@ -436,9 +499,14 @@ static void iter_run(uint64_t pool_width, uint64_t nr_files, uint64_t fd)
 	//pool_mach_transit(&pver->pv_mach, fd, M0_PNDS_FAILED);
 	//pool_mach_transit(&pver->pv_mach, fd, M0_PNDS_SNS_REPAIRING);
 	m0_fom_timeout_init(&iter_fom_timeout);
+	M0_SET0(&iter_gfid);
+	iter_group_next = 0;
 	M0_FOM_SIMPLE_POST(&iter_fom, reqh, &iter_ut_conf,
 			   &iter_ut_fom_tick, NULL, NULL, 2);
 	m0_semaphore_down(&iter_sem);
+	/* Only frames of the failed device were inverted to find the groups. */
+	M0_UT_ASSERT(ergo(scm->sc_it.si_groups_nr > 0,
+			  scm->sc_it.si_frames_nr > 0));
 	m0_semaphore_fini(&iter_sem);
 	m0_fom_timeout_fini(&iter_fom_timeout);
 	if (op == CM_OP_REPAIR)
@@ -580,6 +648,74 @@ static void iter_ag_init_failure(void)
 	iter_stop(6, 1, 2);
 }
 
+enum {
+	/* Files of M0_SNS_CM_UT_PVER_OTHER, see other_files_create(). */
+	ITER_UT_OTHER_FILES_NR = 3,
+	ITER_UT_OTHER_FILES_KEY = 1000,
+	ITER_UT_OTHER_FILES_P = 5,
+};
+
+/*
+ * Creates files having no units on the failed device: their cobs belong to
+ * the pool version of another pool.
+ */
+static void other_files_create(void)
+{
+	struct m0_cob_domain *cdom;
+	struct m0_fid         gfid;
+	int                   i;
+	int                   j;
+
+	m0_ios_cdom_get(cm->cm_service.rs_reqh, &cdom);
+	for (i = 0; i < ITER_UT_OTHER_FILES_NR; ++i) {
+		m0_fid_gob_make(&gfid, 0, M0_MDSERVICE_START_FID.f_key +
+				ITER_UT_OTHER_FILES_KEY + i);
+		for (j = 1; j <= ITER_UT_OTHER_FILES_P; ++j)
+			pver_cob_create(reqh, cdom, reqh->rh_beseg->bs_domain,
+					j, &gfid, j - 1,
+					&M0_SNS_CM_UT_PVER_OTHER);
+	}
+}
+
+static void other_files_delete(void)
+{
+	struct m0_cob_domain *cdom;
+	struct m0_fid         gfid;
+	int                   i;
+	int                   j;
+
+	m0_ios_cdom_get(cm->cm_service.rs_reqh, &cdom);
+	for (i = 0; i < ITER_UT_OTHER_FILES_NR; ++i) {
+		m0_fid_gob_make(&gfid, 0, M0_MDSERVICE_START_FID.f_key +
+				ITER_UT_OTHER_FILES_KEY + i);
+		for (j = 1; j <= ITER_UT_OTHER_FILES_P; ++j)
+			cob_delete(cdom, reqh->rh_beseg->bs_domain, j, &gfid);
+	}
+}
+
+/*
+ * Files of the pool versions not affected by the failure are skipped by the
+ * iterator without being locked, and no groups of them are re-structured (see
+ * iter_group_check()).
+ */
+static void iter_other_pver_files_skip(void)
+{
+	enum m0_cm_op ops[] = { CM_OP_REPAIR, CM_OP_REBALANCE };
+	int           i;
+
+	for (i = 0; i < ARRAY_SIZE(ops); ++i) {
+		op = ops[i];
+		iter_setup(4);
+		other_files_create();
+		iter_run(6, 2, 4);
+		M0_UT_ASSERT(scm->sc_it.si_files_skipped ==
+			     ITER_UT_OTHER_FILES_NR);
+		M0_UT_ASSERT(scm->sc_it.si_total_files == 2);
+		other_files_delete();
+		iter_stop(6, 2, 4);
+	}
+}
+
 static void iter_invalid_nr_cobs(void)
 {
 	op = CM_OP_REPAIR;
@@ -606,6 +742,7 @@ struct m0_ut_suite sns_cm_repreb_ut = {
 		  iter_repreb_large_file_with_large_unit_size},
 		{ "iter-ag-init-failure", iter_ag_init_failure},
 		{ "iter-invalid-nr-cobs", iter_invalid_nr_cobs},
+		{ "iter-other-pver-files-skip", iter_other_pver_files_skip},
 		{ NULL, NULL }
 	}
 };
@@ -31,6 +31,7 @@
 #include <stdio.h>        /* FILE, fopen */
 #include <unistd.h>       /* rmdir */
 
+#include "lib/arith.h"    /* m0_rnd */
 #include "lib/errno.h"
 #include "lib/locality.h" /* m0_locality_get */
 #include "lib/memory.h"
@@ -91,9 +92,32 @@
  *
  * <b> Latency emulation. </b>
  *
- * Perfstob emulates latency using a soft timer. Latency pattern is defined by
- * a statefull callback function. Currently, there is only constant latency
- * pattern.
+ * Perfstob emulates latency using a soft timer. Completion time of every I/O
+ * is computed by a device model shared by all stobs of the domain:
+ *
+ *     - the device serves up to "qdepth" I/Os at a time. An I/O starts when
+ *       a queue slot is free, so latency grows with the load;
+ *
+ *     - service time is the read or write latency ("rlat_us", "wlat_us"),
+ *       varied uniformly by +/- "jitter_pct" percents. With probability
+ *       "tail_permille" / 1000 it is multiplied by "tail_x" (tail outlier);
+ *
+ *     - an I/O which doesn't start where the previous one ended pays the seek
+ *       time "seek_us";
+ *
+ *     - data transfer takes size / "bw_mbps";
+ *
+ *     - after every "gc_every_mb" megabytes written the device stalls for
+ *       "gc_us" (garbage collection pause).
+ *
+ * Random values come from a generator seeded with "seed", so the same I/O
+ * sequence produces the same latencies on every run. The model is configured
+ * by the domain configuration string, e.g.
+ *
+ *     "qdepth=8 rlat_us=90 wlat_us=30 jitter_pct=20 tail_permille=5
+ *      tail_x=20 bw_mbps=2000 gc_every_mb=256 gc_us=5000 seed=1"
+ *
+ * Without parameters every I/O takes 1ms and I/Os are served one at a time.
  *
  * <b> Statistics. </b>
  *
@@ -104,13 +128,39 @@
 
 struct stob_perf_io;
 
-typedef m0_time_t (*stob_perf_latency_cb_t)(struct stob_perf_io *);
+enum {
+	/* Maximal number of I/Os served by the device model at a time. */
+	STOB_PERF_QDEPTH_MAX = 64,
+};
 
 struct stob_perf_domain_cfg {
 	size_t                 spc_tmpfs_size;
 	bool                   spc_is_null;
-	m0_time_t              spc_latency;
-	stob_perf_latency_cb_t spc_latency_cb;
+	/* Device model parameters, see "Latency emulation" above. */
+	m0_time_t              spc_rlat;
+	m0_time_t              spc_wlat;
+	uint64_t               spc_jitter_pct;
+	uint64_t               spc_tail_permille;
+	uint64_t               spc_tail_x;
+	m0_time_t              spc_seek;
+	uint64_t               spc_bw_mbps;
+	uint64_t               spc_qdepth;
+	uint64_t               spc_gc_every_mb;
+	m0_time_t              spc_gc;
+	uint64_t               spc_seed;
+};
+
+/* State of the device model, protected by stob_perf_domain::spd_lock. */
+struct stob_perf_model {
+	uint64_t    spm_rnd;
+	/* Time each queue slot becomes free. */
+	m0_time_t   spm_slot_free[STOB_PERF_QDEPTH_MAX];
+	/* End of the previous I/O, to detect sequential access. */
+	m0_bindex_t spm_last_end;
+	/* Bytes written since the last garbage collection pause. */
+	uint64_t    spm_gc_written;
+	/* The device doesn't start I/Os till this time. */
+	m0_time_t   spm_gc_until;
 };
 
 struct stob_perf_domain {
@@ -118,6 +168,8 @@ struct stob_perf_domain {
 	/** Perf stob domain is implemented on top of this linux stob domain. */
 	struct m0_stob_domain       *spd_ldom;
 	struct stob_perf_domain_cfg  spd_cfg;
+	struct stob_perf_model       spd_model;
+	struct m0_mutex              spd_lock;
 	uint64_t                     spd_magic;
 };
 
@@ -134,10 +186,14 @@ struct stob_perf {
 	struct stob_perf_domain *sp_pdom;
 	uint64_t                 sp_magic;
 
-	/* List of I/Os and latency logics */
+	/* List of I/Os sorted by completion time and latency logics */
 	struct m0_tl             sp_ios;
 	struct m0_mutex          sp_lock;
 	struct m0_timer          sp_timer;
+	/* Completion time the timer is armed for, 0 if it isn't. */
+	m0_time_t                sp_armed;
+	/* The timer has fired, sp_ast is posted and will re-arm it. */
+	bool                     sp_fired;
 	struct m0_sm_ast         sp_ast;
 };
 
@@ -148,6 +204,8 @@ struct stob_perf_io {
 	struct m0_clink    spi_clink;
 	struct m0_tlink    spi_link;
 	uint64_t           spi_magic;
+	/* Completion time assigned by the device model. */
+	m0_time_t          spi_done;
 };
 
 static struct m0_stob_domain_ops stob_perf_domain_ops;
@@ -194,9 +252,78 @@ static struct stob_perf *stob_perf_container(struct m0_stob *stob)
 	return pstob;
 }
 
-static m0_time_t stob_perf_latency_const(struct stob_perf_io *pio)
+static m0_time_t stob_perf_jitter(struct stob_perf_model            *m,
+				  const struct stob_perf_domain_cfg *cfg,
+				  m0_time_t                          t)
 {
-	return pio->spi_pstob->sp_pdom->spd_cfg.spc_latency;
+	uint64_t j = cfg->spc_jitter_pct;
+
+	if (j > 0)
+		t = t * (100 - j + m0_rnd(2 * j + 1, &m->spm_rnd)) / 100;
+	if (cfg->spc_tail_permille > 0 &&
+	    m0_rnd(1000, &m->spm_rnd) < cfg->spc_tail_permille)
+		t *= cfg->spc_tail_x;
+	return t;
+}
+
+/**
+ * Returns completion time of an I/O of @bytes at byte offset @off arriving
+ * at @now.
+ *
+ * @pre m0_mutex_is_locked(&pdom->spd_lock)
+ */
+static m0_time_t stob_perf_model_done(struct stob_perf_domain *pdom,
+				      bool                     write,
+				      m0_bindex_t              off,
+				      m0_bcount_t              bytes,
+				      m0_time_t                now)
+{
+	const struct stob_perf_domain_cfg *cfg = &pdom->spd_cfg;
+	struct stob_perf_model            *m   = &pdom->spd_model;
+	m0_time_t                          t;
+	m0_time_t                          start;
+	int                                slot = 0;
+	int                                i;
+
+	M0_PRE(m0_mutex_is_locked(&pdom->spd_lock));
+
+	t = stob_perf_jitter(m, cfg, write ? cfg->spc_wlat : cfg->spc_rlat);
+	if (off != m->spm_last_end)
+		t += cfg->spc_seek;
+	if (cfg->spc_bw_mbps > 0)
+		t += bytes * M0_TIME_ONE_SECOND / (cfg->spc_bw_mbps << 20);
+	m->spm_last_end = off + bytes;
+
+	for (i = 1; i < cfg->spc_qdepth; ++i) {
+		if (m->spm_slot_free[i] < m->spm_slot_free[slot])
+			slot = i;
+	}
+	start = max3(now, m->spm_slot_free[slot], m->spm_gc_until);
+	m->spm_slot_free[slot] = start + t;
+
+	if (write && cfg->spc_gc_every_mb > 0) {
+		m->spm_gc_written += bytes;
+		if (m->spm_gc_written >= cfg->spc_gc_every_mb << 20) {
+			m->spm_gc_written -= cfg->spc_gc_every_mb << 20;
+			m->spm_gc_until = start + t + cfg->spc_gc;
+		}
+	}
+	return start + t;
+}
+
+M0_INTERNAL m0_time_t m0_stob_perf_model_io(struct m0_stob_domain *dom,
+					    bool                   write,
+					    m0_bindex_t            off,
+					    m0_bcount_t            bytes,
+					    m0_time_t              now)
+{
+	struct stob_perf_domain *pdom = stob_perf_domain_container(dom);
+	m0_time_t                done;
+
+	m0_mutex_lock(&pdom->spd_lock);
+	done = stob_perf_model_done(pdom, write, off, bytes, now);
+	m0_mutex_unlock(&pdom->spd_lock);
+	return done;
 }
 
 static int stob_perf_domain_cfg_init_parse(const char  *str_cfg_init,
@@ -259,22 +386,105 @@ static char *stob_perf_domain_ldom_location(const char *location_data)
 	return ldom_location;
 }
 
+#define CFG_KEY(key, field, mult) \
+	{ key, offsetof(struct stob_perf_domain_cfg, field), mult }
+
+/* Numeric device model parameters: name, field, multiplier. */
+static const struct {
+	const char *spk_name;
+	size_t      spk_offset;
+	uint64_t    spk_mult;
+} stob_perf_cfg_keys[] = {
+	CFG_KEY("rlat_us",       spc_rlat,          1000),
+	CFG_KEY("wlat_us",       spc_wlat,          1000),
+	CFG_KEY("jitter_pct",    spc_jitter_pct,    1),
+	CFG_KEY("tail_permille", spc_tail_permille, 1),
+	CFG_KEY("tail_x",        spc_tail_x,        1),
+	CFG_KEY("seek_us",       spc_seek,          1000),
+	CFG_KEY("bw_mbps",       spc_bw_mbps,       1),
+	CFG_KEY("qdepth",        spc_qdepth,        1),
+	CFG_KEY("gc_every_mb",   spc_gc_every_mb,   1),
+	CFG_KEY("gc_us",         spc_gc,            1000),
+	CFG_KEY("seed",          spc_seed,          1),
+};
+
+#undef CFG_KEY
+
+static void stob_perf_domain_cfg_key(struct stob_perf_domain_cfg *cfg,
+				     const char                  *key,
+				     const char                  *val)
+{
+	uint64_t  v;
+	char     *end;
+	int       i;
+
+	if (strcmp(key, "null") == 0) {
+		cfg->spc_is_null = strcmp(val, "true") == 0 ||
+				   strcmp(val, "1") == 0;
+		return;
+	}
+	v = strtoull(val, &end, 0);
+	if (*end != '\0') {
+		M0_LOG(M0_WARN, "Invalid value: %s=%s", key, val);
+		return;
+	}
+	if (strcmp(key, "latency_us") == 0) {
+		cfg->spc_rlat = cfg->spc_wlat = v * 1000;
+		return;
+	}
+	for (i = 0; i < ARRAY_SIZE(stob_perf_cfg_keys); ++i) {
+		if (strcmp(key, stob_perf_cfg_keys[i].spk_name) == 0) {
+			*(uint64_t *)((char *)cfg +
+				      stob_perf_cfg_keys[i].spk_offset) =
+				v * stob_perf_cfg_keys[i].spk_mult;
+			return;
+		}
+	}
+	M0_LOG(M0_WARN, "Unknown parameter: %s", key);
+}
+
+/*
+ * Configuration string is a list of "key=value" pairs separated by spaces,
+ * commas or new lines.
+ */
 static void stob_perf_domain_cfg_parse(struct stob_perf_domain_cfg *cfg,
 				       const char                  *cfg_str)
 {
-	/* XXX TODO Define config format and parse it properly. */
+	char *str;
+	char *tok;
+	char *val;
+	char *save;
+
+	*cfg = (struct stob_perf_domain_cfg){
+		.spc_rlat   = M0_TIME_ONE_MSEC,
+		.spc_wlat   = M0_TIME_ONE_MSEC,
+		.spc_tail_x = 1,
+		.spc_qdepth = 1,
+	};
+	str = cfg_str == NULL ? NULL : m0_strdup(cfg_str);
+	if (cfg_str != NULL && str == NULL)
+		M0_LOG(M0_ERROR, "No memory to parse the configuration");
+	for (tok = str == NULL ? NULL : strtok_r(str, " ,\n\t", &save);
+	     tok != NULL; tok = strtok_r(NULL, " ,\n\t", &save)) {
+		val = strchr(tok, '=');
+		if (val == NULL) {
+			M0_LOG(M0_WARN, "Invalid parameter: %s", tok);
+			continue;
+		}
+		*val++ = '\0';
+		stob_perf_domain_cfg_key(cfg, tok, val);
+	}
+	m0_free(str);
 
-	cfg->spc_is_null = cfg_str != NULL &&
-			   (strstr(cfg_str, "null=true") != NULL ||
-			    strstr(cfg_str, "null=1") != NULL);
-	M0_LOG(M0_DEBUG, "spc_is_null=%d", !!cfg->spc_is_null);
+	cfg->spc_qdepth = min_check(max_check(cfg->spc_qdepth, (uint64_t)1),
+				    (uint64_t)STOB_PERF_QDEPTH_MAX);
+	cfg->spc_jitter_pct = min_check(cfg->spc_jitter_pct, (uint64_t)100);
+	cfg->spc_tail_x = max_check(cfg->spc_tail_x, (uint64_t)1);
+	M0_LOG(M0_DEBUG, "spc_is_null=%d qdepth=%"PRIu64" rlat=%"PRIu64
+	       " wlat=%"PRIu64" seed=%"PRIu64, !!cfg->spc_is_null,
+	       cfg->spc_qdepth, cfg->spc_rlat, cfg->spc_wlat, cfg->spc_seed);
 
 	cfg->spc_tmpfs_size = cfg->spc_is_null ? 64 : 256; /* XXX */
-	cfg->spc_latency = M0_TIME_ONE_MSEC;
-	cfg->spc_latency_cb = &stob_perf_latency_const;
-
-	/* Don't allow latency longer than 2 seconds, it's converted to long. */
-	M0_POST(cfg->spc_latency < 2 * M0_TIME_ONE_SECOND);
 }
 
 static int stob_perf_domain_read_config(struct stob_perf_domain *pdom,
@@ -384,6 +594,8 @@ static int stob_perf_domain_init(struct m0_stob_type    *type,
 	M0_ASSERT(ergo(rc == 0, pdom->spd_ldom != NULL));
 
 	if (rc == 0) {
+		m0_mutex_init(&pdom->spd_lock);
+		pdom->spd_model.spm_rnd = pdom->spd_cfg.spc_seed;
 		dom_key = m0_stob_domain__dom_key(
 					m0_stob_domain_id_get(pdom->spd_ldom));
 		M0_ASSERT(m0_stob_domain__dom_key_is_valid(dom_key));
@@ -405,6 +617,7 @@ static void stob_perf_domain_fini(struct m0_stob_domain *dom)
 	struct stob_perf_domain *pdom = stob_perf_domain_container(dom);
 
 	m0_stob_domain_fini(pdom->spd_ldom);
+	m0_mutex_fini(&pdom->spd_lock);
 	m0_free(pdom);
 }
 
@@ -598,13 +811,21 @@ static int stob_perf_linux_init_create(struct stob_perf_domain *pdom,
 	return M0_RC(rc);
 }
 
-static void stob_perf_timer_start(struct stob_perf    *pstob,
-				  struct stob_perf_io *pio)
+/**
+ * Arms the timer for the earliest I/O in the queue.
+ *
+ * @pre m0_mutex_is_locked(&pstob->sp_lock)
+ */
+static void stob_perf_timer_start(struct stob_perf *pstob)
 {
-	m0_time_t latency;
+	struct stob_perf_io *pio = stob_perf_ios_tlist_head(&pstob->sp_ios);
+
+	M0_PRE(m0_mutex_is_locked(&pstob->sp_lock));
 
-	latency = pstob->sp_pdom->spd_cfg.spc_latency_cb(pio);
-	m0_timer_start(&pstob->sp_timer, m0_time_from_now(0, latency));
+	if (pio != NULL) {
+		pstob->sp_armed = pio->spi_done;
+		m0_timer_start(&pstob->sp_timer, pio->spi_done);
+	}
 }
 
 static void stob_perf_ast_cb(struct m0_sm_group *grp, struct m0_sm_ast *ast)
@@ -612,23 +833,30 @@ static void stob_perf_ast_cb(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 	struct stob_perf    *pstob =
 				container_of(ast, struct stob_perf, sp_ast);
 	struct stob_perf_io *pio;
-	struct stob_perf_io *pio2;
+	struct m0_tl         done;
+	m0_time_t            now = m0_time_now();
 
 	M0_PRE(pstob == ast->sa_datum);
 	M0_PRE(pstob->sp_magic == M0_STOB_PERF_MAGIC);
 
-	m0_timer_stop(&pstob->sp_timer);
+	/* stob_perf_consume_io() may have stopped it racing with the firing. */
+	if (m0_timer_is_started(&pstob->sp_timer))
+		m0_timer_stop(&pstob->sp_timer);
 
+	stob_perf_ios_tlist_init(&done);
 	m0_mutex_lock(&pstob->sp_lock);
-	pio = stob_perf_ios_tlist_pop(&pstob->sp_ios);
-	M0_ASSERT(pio != NULL);
-	if (!stob_perf_ios_tlist_is_empty(&pstob->sp_ios)) {
-		pio2 = stob_perf_ios_tlist_head(&pstob->sp_ios);
-		M0_ASSERT(pio2 != NULL);
-		stob_perf_timer_start(pstob, pio2);
-	}
+	M0_ASSERT(pstob->sp_fired);
+	pstob->sp_fired = false;
+	pstob->sp_armed = 0;
+	while ((pio = stob_perf_ios_tlist_head(&pstob->sp_ios)) != NULL &&
+	       pio->spi_done <= now)
+		stob_perf_ios_tlist_move_tail(&done, pio);
+	stob_perf_timer_start(pstob);
 	m0_mutex_unlock(&pstob->sp_lock);
-	stob_perf_io_completed(pio);
+
+	while ((pio = stob_perf_ios_tlist_pop(&done)) != NULL)
+		stob_perf_io_completed(pio);
+	stob_perf_ios_tlist_fini(&done);
 }
 
 static unsigned long stob_perf_timer_cb(unsigned long data)
@@ -638,6 +866,7 @@ static unsigned long stob_perf_timer_cb(unsigned long data)
 
 	M0_PRE(pstob->sp_magic == M0_STOB_PERF_MAGIC);
 
+	pstob->sp_fired = true;
 	loc = m0_locality_get(data);
 	M0_ASSERT(loc != NULL);
 	pstob->sp_ast.sa_cb = &stob_perf_ast_cb;
@@ -672,6 +901,8 @@ static int stob_perf_init(struct m0_stob        *stob,
 		pstob->sp_backstore = lstob;
 		stob_perf_ios_tlist_init(&pstob->sp_ios);
 		m0_mutex_init(&pstob->sp_lock);
+		pstob->sp_armed = 0;
+		pstob->sp_fired = false;
 		M0_SET0(&pstob->sp_ast);
 		/* XXX TODO init stats */
 	}
@@ -798,12 +1029,41 @@ static int stob_perf_fd(struct m0_stob *stob)
 
 static void stob_perf_consume_io(struct stob_perf_io *pio)
 {
-	struct stob_perf *pstob = pio->spi_pstob;
+	struct stob_perf        *pstob = pio->spi_pstob;
+	struct stob_perf_domain *pdom  = pstob->sp_pdom;
+	struct m0_stob_io       *io    = pio->spi_io;
+	struct stob_perf_io     *next;
+	m0_bindex_t              off;
+	uint32_t                 shift;
+
+	shift = m0_stob_block_shift(pstob->sp_backstore);
+	m0_mutex_lock(&pdom->spd_lock);
+	off = io->si_stob.iv_vec.v_nr > 0 ? io->si_stob.iv_index[0] << shift :
+					    pdom->spd_model.spm_last_end;
+	pio->spi_done = stob_perf_model_done(pdom, io->si_opcode == SIO_WRITE,
+				off, m0_vec_count(&io->si_stob.iv_vec) << shift,
+				m0_time_now());
+	m0_mutex_unlock(&pdom->spd_lock);
 
 	m0_mutex_lock(&pstob->sp_lock);
-	if (stob_perf_ios_tlist_is_empty(&pstob->sp_ios))
-		stob_perf_timer_start(pstob, pio);
-	stob_perf_ios_tlist_add_tail(&pstob->sp_ios, pio);
+	next = m0_tl_find(stob_perf_ios, p, &pstob->sp_ios,
+			  p->spi_done > pio->spi_done);
+	if (next != NULL)
+		stob_perf_ios_tlist_add_before(next, pio);
+	else
+		stob_perf_ios_tlist_add_tail(&pstob->sp_ios, pio);
+	/*
+	 * Re-arm the timer if the new I/O completes first. When the timer has
+	 * already fired, the pending AST re-arms it.
+	 */
+	if (!pstob->sp_fired &&
+	    (pstob->sp_armed == 0 || pio->spi_done < pstob->sp_armed)) {
+		if (pstob->sp_armed != 0)
+			/* Waits for a concurrent timer callback. */
+			m0_timer_stop(&pstob->sp_timer);
+		if (!pstob->sp_fired)
+			stob_perf_timer_start(pstob);
+	}
 	m0_mutex_unlock(&pstob->sp_lock);
 }
 
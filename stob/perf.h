@@ -25,6 +25,11 @@
 #ifndef __MOTR_STOB_PERF_H__
 #define __MOTR_STOB_PERF_H__
 
+#include "lib/types.h"  /* m0_bindex_t */
+#include "lib/time.h"   /* m0_time_t */
+
+struct m0_stob_domain;
+
 /**
  * @defgroup stobperf Storage object implementation for performance tests.
  *
@@ -33,6 +38,17 @@
 
 extern const struct m0_stob_type m0_stob_perf_type;
 
+/**
+ * Passes an I/O of @bytes at byte offset @off arriving at @now through the
+ * device model of perfstob domain @dom and returns its completion time. The
+ * model state is advanced as for a real I/O. Used by UT.
+ */
+M0_INTERNAL m0_time_t m0_stob_perf_model_io(struct m0_stob_domain *dom,
+					    bool                   write,
+					    m0_bindex_t            off,
+					    m0_bcount_t            bytes,
+					    m0_time_t              now);
+
 /** @} end of stobperf group */
 #endif /* __MOTR_STOB_PERF_H__ */
 
@@ -37,6 +37,7 @@
 #include "stob/domain.h"
 #include "stob/io.h"
 #include "stob/stob.h"
+#include "stob/perf.h"     /* m0_stob_perf_model_io */
 #include "fol/fol.h"
 #include "balloc/balloc.h" /* M0_BALLOC_NON_SPARE_ZONE */
 
@@ -313,6 +314,90 @@ void m0_stob_ut_adieu_perf(void)
 	test_adieu_fini();
 }
 
+#define MODEL_CFG "qdepth=4 rlat_us=1000 wlat_us=200 jitter_pct=20 "      \
+		  "tail_permille=10 tail_x=10 seek_us=50 bw_mbps=500 "	      \
+		  "gc_every_mb=1 gc_us=500 "
+
+enum {
+	MODEL_IO_NR   = 32,
+	MODEL_IO_SIZE = 1 << 16,
+};
+
+/**
+ * Passes MODEL_IO_NR sequential reads through the device model of a new
+ * domain. Reads are issued in batches of @depth arriving at once, the next
+ * batch arrives when the previous one is done. Fills @lat with the latency
+ * of every read.
+ */
+static void model_latencies(const char *cfg, int depth, m0_time_t *lat)
+{
+	m0_time_t arrival = M0_TIME_ONE_SECOND;
+	m0_time_t done = arrival;
+	m0_time_t t;
+	int       rc;
+	int       i;
+
+	rc = test_adieu_init(perf_location, cfg, NULL);
+	M0_ASSERT(rc == 0);
+	for (i = 0; i < MODEL_IO_NR; ++i) {
+		if (i % depth == 0)
+			arrival = done;
+		t = m0_stob_perf_model_io(dom, false,
+					  (m0_bindex_t)i * MODEL_IO_SIZE,
+					  MODEL_IO_SIZE, arrival);
+		M0_ASSERT(t > arrival);
+		lat[i] = t - arrival;
+		done = max_check(done, t);
+	}
+	test_adieu_fini();
+}
+
+static m0_time_t model_latency_sum(const m0_time_t *lat)
+{
+	return m0_reduce(i, MODEL_IO_NR, 0, + lat[i]);
+}
+
+void m0_stob_ut_adieu_perf_model(void)
+{
+	m0_time_t lat0[MODEL_IO_NR];
+	m0_time_t lat1[MODEL_IO_NR];
+	m0_time_t start;
+	int       rc;
+
+	rc = test_adieu_init(perf_location, MODEL_CFG "seed=42", NULL);
+	M0_ASSERT(rc == 0);
+	test_adieu(perf_path);
+	/* Read latency is 1ms - 20% jitter at least. */
+	start = m0_time_now();
+	test_read(1);
+	M0_ASSERT(m0_time_sub(m0_time_now(), start) >=
+		  M0_TIME_ONE_MSEC * 8 / 10);
+	test_adieu_fini();
+
+	/* The same seed gives the same latencies. */
+	model_latencies(MODEL_CFG "seed=42", 1, lat0);
+	model_latencies(MODEL_CFG "seed=42", 1, lat1);
+	M0_ASSERT(memcmp(lat0, lat1, sizeof lat0) == 0);
+	/* A different seed gives different ones. */
+	model_latencies(MODEL_CFG "seed=43", 1, lat1);
+	M0_ASSERT(memcmp(lat0, lat1, sizeof lat0) != 0);
+
+	/*
+	 * Up to qdepth I/Os are served concurrently, so latency doesn't change
+	 * till the queue depth exceeds it. Then I/Os wait for a free slot:
+	 * with twice qdepth half of them wait for one service time, with four
+	 * times qdepth they wait for 1.5 service times on average.
+	 */
+	model_latencies(MODEL_CFG "seed=42", 4, lat1);
+	M0_ASSERT(memcmp(lat0, lat1, sizeof lat0) == 0);
+	model_latencies(MODEL_CFG "seed=42", 8, lat0);
+	M0_ASSERT(model_latency_sum(lat0) > model_latency_sum(lat1) * 5 / 4);
+	model_latencies(MODEL_CFG "seed=42", 16, lat1);
+	M0_ASSERT(model_latency_sum(lat1) > model_latency_sum(lat0) * 5 / 4);
+}
+
+#undef MODEL_CFG
+
 /*
    Adieu unit-benchmark
  */
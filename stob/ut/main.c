@@ -39,6 +39,7 @@ extern void m0_stob_ut_stob_domain_perf_null(void);
 extern void m0_stob_ut_stob_perf(void);
 extern void m0_stob_ut_stob_perf_null(void);
 extern void m0_stob_ut_adieu_perf(void);
+extern void m0_stob_ut_adieu_perf_model(void);
 extern void m0_stob_ut_stobio_perf(void);
 extern void m0_stob_ut_stob_domain_ad(void);
 extern void m0_stob_ut_stob_ad(void);
@@ -63,6 +64,7 @@ struct m0_ut_suite stob_ut = {
 		{ "perf-stob",		m0_stob_ut_stob_perf		},
 		{ "perf-stob-null",	m0_stob_ut_stob_perf_null	},
 		{ "perf-adieu",		m0_stob_ut_adieu_perf		},
+		{ "perf-adieu-model",	m0_stob_ut_adieu_perf_model	},
 		{ "perf-stobio",	m0_stob_ut_stobio_perf		},
 		{ "ad-stob-domain",	m0_stob_ut_stob_domain_ad	},
 		{ "ad-stob",		m0_stob_ut_stob_ad		},
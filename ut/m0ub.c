@@ -33,8 +33,11 @@ extern struct m0_ub_set m0_ad_ub;
 extern struct m0_ub_set m0_adieu_ub;
 extern struct m0_ub_set m0_atomic_ub;
 extern struct m0_ub_set m0_bitmap_ub;
+extern struct m0_ub_set m0_conf_cache_ub;
+extern struct m0_ub_set m0_fdmi_filter_eval_ub;
 extern struct m0_ub_set m0_fol_ub;
 extern struct m0_ub_set m0_fom_ub;
+extern struct m0_ub_set m0_layout_ub;
 extern struct m0_ub_set m0_list_ub;
 extern struct m0_ub_set m0_memory_ub;
 extern struct m0_ub_set m0_parity_math_ub;
@@ -46,6 +49,7 @@ extern struct m0_ub_set m0_timer_ub;
 extern struct m0_ub_set m0_tlist_ub;
 extern struct m0_ub_set m0_trace_ub;
 extern struct m0_ub_set m0_varr_ub;
+extern struct m0_ub_set m0_xcode_ub;
 
 #define UB_SANDBOX "./ub-sandbox"
 
@@ -99,6 +103,7 @@ static void ub_add(const struct ub_args *args)
 	 * These benchmarks are executed in reverse order from the way
 	 * they are listed here.
 	 */
+	m0_ub_set_add(&m0_xcode_ub);
 	m0_ub_set_add(&m0_varr_ub);
 	m0_ub_set_add(&m0_trace_ub);
 	m0_ub_set_add(&m0_tlist_ub);
@@ -110,8 +115,11 @@ static void ub_add(const struct ub_args *args)
 	m0_ub_set_add(&m0_parity_math_ub);
 	m0_ub_set_add(&m0_memory_ub);
 	m0_ub_set_add(&m0_list_ub);
+	m0_ub_set_add(&m0_layout_ub);
 	m0_ub_set_add(&m0_fom_ub);
 	m0_ub_set_add(&m0_fol_ub);
+	m0_ub_set_add(&m0_fdmi_filter_eval_ub);
+	m0_ub_set_add(&m0_conf_cache_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_bitmap_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_atomic_ub);
 	m0_ub_set_add(&m0_adieu_ub);
@@ -65,6 +65,7 @@ extern struct m0_ut_suite cas_client_ut;
 extern struct m0_ut_suite cas_service_ut;
 extern struct m0_ut_suite ut_suite;
 extern struct m0_ut_suite ut_suite_obj;
+extern struct m0_ut_suite ut_suite_obj_lock;
 extern struct m0_ut_suite ut_suite_io;
 extern struct m0_ut_suite ut_suite_io_nw_xfer;
 extern struct m0_ut_suite ut_suite_io_pargrp;
@@ -220,6 +221,7 @@ static void tests_add(struct m0_ut_module *m)
 	m0_ut_add(m, &cas_service_ut, true);
 	m0_ut_add(m, &ut_suite, true);
 	m0_ut_add(m, &ut_suite_obj, true);
+	m0_ut_add(m, &ut_suite_obj_lock, true);
 	m0_ut_add(m, &ut_suite_io, true);
 	m0_ut_add(m, &ut_suite_io_nw_xfer, true);
 	m0_ut_add(m, &ut_suite_io_pargrp, true);
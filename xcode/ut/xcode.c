@@ -32,6 +32,9 @@
 #include "lib/errno.h"                      /* ENOENT */
 #include "lib/string.h"                     /* m0_streq */
 #include "ut/ut.h"
+#ifndef __KERNEL__
+#include "lib/ub.h"                         /* m0_ub_set */
+#endif
 
 #include "xcode/xcode.h"
 
@@ -1162,6 +1165,224 @@ static void xcode_enum_field(void)
 	M0_UT_ASSERT(memcmp(&buf, &ef, sizeof ef) == 0);
 }
 
+/*
+ * Functions for struct foo, as m0gccxml2xcode --fast would generate them.
+ */
+static int foo_gen_length(struct m0_xcode_ctx *ctx, const void *obj)
+{
+	return 16;
+}
+
+static int foo_gen_encode(struct m0_xcode_ctx *ctx, const void *obj)
+{
+	const char *o = obj;
+
+	return
+		m0_xcode_gen_encode(ctx, o + offsetof(struct foo, f_x), 16) ?:
+		0;
+}
+
+static int foo_gen_decode(struct m0_xcode_ctx *ctx, void *obj)
+{
+	char *o = obj;
+
+	return
+		m0_xcode_gen_decode(ctx, o + offsetof(struct foo, f_x), 16) ?:
+		0;
+}
+
+static const struct m0_xcode_type_ops foo_gen_ops = {
+	.xto_length = &foo_gen_length,
+	.xto_encode = &foo_gen_encode,
+	.xto_decode = &foo_gen_decode
+};
+
+static void generated_check(const struct m0_xcode_obj *obj, bool generic)
+{
+	int result;
+
+	M0_SET_ARR0(ebuf);
+	m0_xcode_ctx_init(&ctx, obj);
+	ctx.xcx_generic = generic;
+	result = m0_xcode_length(&ctx);
+	M0_UT_ASSERT(result == sizeof TD);
+
+	m0_xcode_ctx_init(&ctx, obj);
+	ctx.xcx_generic = generic;
+	m0_bufvec_cursor_init(&ctx.xcx_buf, &bvec);
+	result = m0_xcode_encode(&ctx);
+	M0_UT_ASSERT(result == 0);
+	M0_UT_ASSERT(memcmp(&TD, ebuf, sizeof TD) == 0);
+	xcode_decode_test();
+}
+
+static void xcode_generated(void)
+{
+	struct m0_xcode_obj top = { &xut_top.xt, &T };
+	struct enumfield    ef  = {
+		.ef_0    = 1,
+		.ef_enum = TE_5,
+		.ef_bitm = BM_ZERO|BM_NINE,
+		.ef_1    = 2
+	};
+	struct enumfield    buf[2];
+	void               *addr[2] = { &buf[0], &buf[1] };
+	m0_bcount_t         nob[2]  = { sizeof buf[0], sizeof buf[1] };
+	struct m0_xcode_obj obj     = { enumfield_xc, &ef };
+	struct m0_xcode_ctx ectx;
+	struct foo          f       = { .f_x = 1, .f_y = 2 };
+	char                small[8];
+	void               *saddr   = small;
+	m0_bcount_t         snob    = sizeof small;
+	struct m0_bufvec    sbvec   = M0_BUFVEC_INIT_BUF(&saddr, &snob);
+	int                 result;
+	int                 i;
+
+	/* Generated functions replace the walk over foo's fields. */
+	M0_UT_ASSERT(!m0_xcode_gen_ok(&xut_foo.xt));
+	m0_xcode_gen_install(&xut_foo.xt, &foo_gen_ops);
+	M0_UT_ASSERT(m0_xcode_gen_ok(&xut_foo.xt));
+	generated_check(&top, false);
+	generated_check(&top, true);
+
+	/* Short buffer. */
+	m0_xcode_ctx_init(&ctx, &(struct m0_xcode_obj){ &xut_foo.xt, &f });
+	m0_bufvec_cursor_init(&ctx.xcx_buf, &sbvec);
+	result = m0_xcode_encode(&ctx);
+	M0_UT_ASSERT(result == -EPROTO);
+
+	/* Custom xcoding takes precedence. */
+	xut_foo.xt.xct_ops = &foo_ops;
+	M0_UT_ASSERT(!m0_xcode_gen_ok(&xut_foo.xt));
+	m0_xcode_ctx_init(&ctx, &(struct m0_xcode_obj){ &xut_foo.xt, &f });
+	m0_bufvec_cursor_init(&ctx.xcx_buf, &bvec);
+	result = m0_xcode_encode(&ctx);
+	M0_UT_ASSERT(result == 0);
+	foo_xor(ebuf);
+	M0_UT_ASSERT(memcmp(ebuf, &f, sizeof f) == 0);
+	xut_foo.xt.xct_ops = NULL;
+	xut_foo.xt.xct_gen_ops = NULL;
+
+	/*
+	 * Types generated by m0gccxml2xcode, with or without --fast: both ways
+	 * of xcoding have to produce the same representation.
+	 */
+	m0_xc_xcode_ut_test_gccxml_simple_init();
+#ifdef ENABLE_XCODE_FAST
+	M0_UT_ASSERT(enumfield_xc->xct_gen_ops != NULL);
+	M0_UT_ASSERT(m0_fid_xc->xct_gen_ops != NULL);
+#endif
+	/* Unions and records with pointers are left to the generic walk. */
+	M0_UT_ASSERT(optfid_xc->xct_gen_ops == NULL);
+	M0_UT_ASSERT(testtypes_xc->xct_gen_ops == NULL);
+	M0_SET_ARR0(buf);
+	for (i = 0; i < ARRAY_SIZE(buf); ++i) {
+		m0_xcode_ctx_init(&ectx, &obj);
+		ectx.xcx_generic = i == 0;
+		result = m0_xcode_length(&ectx);
+		M0_UT_ASSERT(result == sizeof ef);
+		m0_xcode_ctx_init(&ectx, &obj);
+		ectx.xcx_generic = i == 0;
+		m0_bufvec_cursor_init(&ectx.xcx_buf,
+				      &M0_BUFVEC_INIT_BUF(&addr[i], &nob[i]));
+		result = m0_xcode_encode(&ectx);
+		M0_UT_ASSERT(result == 0);
+	}
+	M0_UT_ASSERT(memcmp(&buf[0], &buf[1], sizeof ef) == 0);
+	M0_UT_ASSERT(memcmp(&buf[0], &ef, sizeof ef) == 0);
+}
+
+#ifndef __KERNEL__
+enum { XCODE_UB_ITER = 200000 };
+
+static bool xcode_ub_generic;
+
+static int xcode_ub_init(const char *opts M0_UNUSED)
+{
+	int result = xcode_init();
+
+	if (result == 0)
+		m0_xcode_gen_install(&xut_foo.xt, &foo_gen_ops);
+	return result;
+}
+
+static void xcode_ub_fini(void)
+{
+	xut_foo.xt.xct_gen_ops = NULL;
+}
+
+static void xcode_ub_fast(void)
+{
+	xcode_ub_generic = false;
+}
+
+static void xcode_ub_slow(void)
+{
+	xcode_ub_generic = true;
+}
+
+static void xcode_ub_length(int i M0_UNUSED)
+{
+	m0_xcode_ctx_init(&ctx, &(struct m0_xcode_obj){ &xut_top.xt, &T });
+	ctx.xcx_generic = xcode_ub_generic;
+	M0_UB_ASSERT(m0_xcode_length(&ctx) == sizeof TD);
+}
+
+static void xcode_ub_encode(int i M0_UNUSED)
+{
+	m0_xcode_ctx_init(&ctx, &(struct m0_xcode_obj){ &xut_top.xt, &T });
+	ctx.xcx_generic = xcode_ub_generic;
+	m0_bufvec_cursor_init(&ctx.xcx_buf, &bvec);
+	M0_UB_ASSERT(m0_xcode_encode(&ctx) == 0);
+}
+
+static void xcode_ub_decode(int i M0_UNUSED)
+{
+	struct m0_xcode_obj decoded;
+
+	m0_xcode_ctx_init(&ctx, &(struct m0_xcode_obj){ &xut_top.xt, NULL });
+	ctx.xcx_generic = xcode_ub_generic;
+	ctx.xcx_alloc = m0_xcode_alloc;
+	m0_bufvec_cursor_init(&ctx.xcx_buf, &bvec);
+	M0_UB_ASSERT(m0_xcode_decode(&ctx) == 0);
+	decoded = ctx.xcx_it.xcu_stack[0].s_obj;
+	m0_xcode_free_obj(&decoded);
+}
+
+struct m0_ub_set m0_xcode_ub = {
+	.us_name = "xcode-ub",
+	.us_init = xcode_ub_init,
+	.us_fini = xcode_ub_fini,
+	.us_run  = {
+		{ .ub_name  = "length-generic",
+		  .ub_iter  = XCODE_UB_ITER,
+		  .ub_init  = xcode_ub_slow,
+		  .ub_round = xcode_ub_length },
+		{ .ub_name  = "length",
+		  .ub_iter  = XCODE_UB_ITER,
+		  .ub_init  = xcode_ub_fast,
+		  .ub_round = xcode_ub_length },
+		{ .ub_name  = "encode-generic",
+		  .ub_iter  = XCODE_UB_ITER,
+		  .ub_init  = xcode_ub_slow,
+		  .ub_round = xcode_ub_encode },
+		{ .ub_name  = "encode",
+		  .ub_iter  = XCODE_UB_ITER,
+		  .ub_init  = xcode_ub_fast,
+		  .ub_round = xcode_ub_encode },
+		{ .ub_name  = "decode-generic",
+		  .ub_iter  = XCODE_UB_ITER,
+		  .ub_init  = xcode_ub_slow,
+		  .ub_round = xcode_ub_decode },
+		{ .ub_name  = "decode",
+		  .ub_iter  = XCODE_UB_ITER,
+		  .ub_init  = xcode_ub_fast,
+		  .ub_round = xcode_ub_decode },
+		{ .ub_name = NULL }
+	}
+};
+#endif
+
 static int ecount;
 static void t_count(struct m0_xcode_type *xt, void *data)
 {
@@ -1291,6 +1512,7 @@ struct m0_ut_suite xcode_ut = {
 		{ "xcode-print",  xcode_print_test },
 #endif
 		{ "xcode-find",   xcode_find_test },
+		{ "xcode-generated", xcode_generated },
 
 		{ "xcode-enum-gccxml",    xcode_enum_gccxml,       "Nikita" },
 		{ "xcode-enum-print",     xcode_enum_print,        "Nikita" },
@@ -254,6 +254,61 @@ M0_INTERNAL void m0_xcode_free_obj(struct m0_xcode_obj *obj)
 	m0_xcode_free(&ctx);
 }
 
+static bool ops_has(const struct m0_xcode_type_ops *ops, enum xcode_op op)
+{
+	return ops != NULL &&
+		((op == XO_ENC && ops->xto_encode != NULL) ||
+		 (op == XO_DEC && ops->xto_decode != NULL) ||
+		 (op == XO_LEN && ops->xto_length != NULL));
+}
+
+/**
+   Returns operations to xcode an object of the given type as a whole, or NULL
+   if the generic walk has to descend into it.
+ */
+static const struct m0_xcode_type_ops *ops_get(const struct m0_xcode_ctx  *ctx,
+					       const struct m0_xcode_type *xt,
+					       enum xcode_op               op)
+{
+	if (ops_has(xt->xct_ops, op))
+		return xt->xct_ops;
+	if (!ctx->xcx_generic && ctx->xcx_iter == NULL &&
+	    ops_has(xt->xct_gen_ops, op))
+		return xt->xct_gen_ops;
+	return NULL;
+}
+
+M0_INTERNAL int m0_xcode_gen_encode(struct m0_xcode_ctx *ctx,
+				    const void *src, m0_bcount_t nob)
+{
+	return m0_bufvec_cursor_copyto(&ctx->xcx_buf, (void *)src, nob) == nob ?
+		0 : -EPROTO;
+}
+
+M0_INTERNAL int m0_xcode_gen_decode(struct m0_xcode_ctx *ctx,
+				    void *dst, m0_bcount_t nob)
+{
+	return m0_bufvec_cursor_copyfrom(&ctx->xcx_buf, dst, nob) == nob ?
+		0 : -EPROTO;
+}
+
+M0_INTERNAL bool m0_xcode_gen_ok(const struct m0_xcode_type *xt)
+{
+	return xt->xct_gen_ops != NULL &&
+		!ops_has(xt->xct_ops, XO_ENC) &&
+		!ops_has(xt->xct_ops, XO_DEC) &&
+		!ops_has(xt->xct_ops, XO_LEN);
+}
+
+M0_INTERNAL void m0_xcode_gen_install(struct m0_xcode_type *xt,
+				      const struct m0_xcode_type_ops *ops)
+{
+	M0_PRE(xt->xct_aggr == M0_XA_RECORD);
+	M0_PRE(ops->xto_length != NULL && ops->xto_encode != NULL &&
+	       ops->xto_decode != NULL);
+	xt->xct_gen_ops = ops;
+}
+
 /**
    Common xcoding function, implementing encoding, decoding and sizing.
  */
@@ -296,12 +351,9 @@ static int ctx_walk(struct m0_xcode_ctx *ctx, enum xcode_op op)
 
 		xt  = cur->xo_type;
 		ptr = cur->xo_ptr;
-		ops = xt->xct_ops;
+		ops = ops_get(ctx, xt, op);
 
-		if (ops != NULL &&
-		    ((op == XO_ENC && ops->xto_encode != NULL) ||
-		     (op == XO_DEC && ops->xto_decode != NULL) ||
-		     (op == XO_LEN && ops->xto_length != NULL))) {
+		if (ops != NULL) {
 			switch (op) {
 			case XO_ENC:
 				result = ops->xto_encode(ctx, ptr);
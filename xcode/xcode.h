@@ -319,6 +319,18 @@ struct m0_xcode_type {
 	const char                     *xct_name;
 	/** Custom operations. */
 	const struct m0_xcode_type_ops *xct_ops;
+	/**
+	    Straight-line length, encode and decode functions, emitted by
+	    m0gccxml2xcode --fast for fixed-size records.
+
+	    Used instead of the generic walk over the type's fields, unless
+	    xct_ops provides the operation or m0_xcode_ctx::xcx_generic is set.
+	    The generated functions produce exactly the same representation as
+	    the generic walk.
+
+	    @see m0_xcode_gen_install()
+	 */
+	const struct m0_xcode_type_ops *xct_gen_ops;
 	/**
 	    Which atomic type this is?
 
@@ -611,6 +623,12 @@ struct m0_xcode_ctx {
 	   processing of given xcode context and xcode object embeded into it.
 	 */
 	void                  (*xcx_iter_end)(const struct m0_xcode_cursor *it);
+	/**
+	   If true, m0_xcode_type::xct_gen_ops are ignored and every object is
+	   xcoded by the generic walk. Generated functions are never used when
+	   xcx_iter is set, because they do not visit sub-objects.
+	 */
+	bool                     xcx_generic;
 };
 
 /**
@@ -690,6 +708,35 @@ M0_INTERNAL bool m0_xcode_is_byte_array(const struct m0_xcode_type *xt);
 M0_INTERNAL ssize_t
 m0_xcode_alloc_obj(struct m0_xcode_cursor *it,
 		   void *(*alloc)(struct m0_xcode_cursor *, size_t));
+
+/**
+   Helpers used by the functions generated by m0gccxml2xcode --fast.
+
+   m0_xcode_gen_encode() and m0_xcode_gen_decode() copy @nob bytes of atoms,
+   which are contiguous in memory, between the object and the serialized
+   representation and return -EPROTO if the buffer is too short.
+ */
+M0_INTERNAL int m0_xcode_gen_encode(struct m0_xcode_ctx *ctx,
+				    const void *src, m0_bcount_t nob);
+M0_INTERNAL int m0_xcode_gen_decode(struct m0_xcode_ctx *ctx,
+				    void *dst, m0_bcount_t nob);
+
+/**
+   Returns true iff "xt" has generated functions which can be called directly
+   from the generated functions of an enclosing record, i.e., no custom
+   xcoding is installed for "xt".
+ */
+M0_INTERNAL bool m0_xcode_gen_ok(const struct m0_xcode_type *xt);
+
+/**
+   Installs generated functions on "xt".
+
+   Called from the generated struct init function, after all field types are
+   initialised, and only if m0_xcode_gen_ok() holds for all record fields.
+   Custom xcoding of field types has to be installed before m0_xcode_init().
+ */
+M0_INTERNAL void m0_xcode_gen_install(struct m0_xcode_type *xt,
+				      const struct m0_xcode_type_ops *ops);
 /** @} xcoding. */
 
 /**